@@ -0,0 +1,72 @@
+#pragma once
+
+#include "stdafx.h"
+#include "BenchmarkReport.h"
+
+//////////////////////////////////////////////////////////////////////////
+// The headless benchmark: the engine on the null backend, no window. Each
+// Benchmark*() prints what it measures and records it in gBenchmarkReport,
+// which main() saves and compares with the baseline.
+
+// What the benchmarks measure
+extern BenchmarkReport gBenchmarkReport;
+
+// A failed check counts 1: over its baseline of 0 whatever the tolerance
+void RecordCheck(const char* name, BOOL bOk);
+
+//------ SceneBenchmarks.cpp
+// Every scene of data/scenes for frameCount frames, traced to traceFile when not null
+void BenchmarkScenes(u32 frameCount, FILE* traceFile);
+// 1 mm at 100 km from the world origin, and the per object render space conversion
+void BenchmarkRenderOrigin();
+
+//------ RenderBenchmarks.cpp
+void BenchmarkRenderQueueSort(u32 packetCount);
+void BenchmarkFramePipeline(double updateMs, double renderMs);
+
+//------ ShadowBenchmarks.cpp
+void BenchmarkShadowCasterCuller();
+void BenchmarkShadowMapCache();
+void BenchmarkPartitionReadback();
+
+//------ LightingBenchmarks.cpp
+void BenchmarkLightClusters();
+void BenchmarkTiledLightCulling();
+void BenchmarkPointLights();
+
+//------ ProfilerBenchmarks.cpp
+void BenchmarkProfiler();
+void BenchmarkProfilerCapture(const string& path);
+void BenchmarkHardwareCounters();
+void BenchmarkProfileHistory(const string& spikePath, const string& csvPath);
+
+//------ MemoryBenchmarks.cpp
+void BenchmarkMemoryTracker();
+void BenchmarkFrameArena();
+void BenchmarkObjectPool();
+void BenchmarkMemoryBudget();
+
+//------ ClockBenchmarks.cpp
+void BenchmarkClock();
+void BenchmarkFrameScheduler();
+
+//------ MathBenchmarks.cpp
+void BenchmarkMath();
+
+//------ BoundsBenchmarks.cpp
+// The frustum batch tests and the OBB separating axis test against brute force
+void BenchmarkBounds();
+
+//------ PackingBenchmarks.cpp
+// Halves and norms exhaustively, octahedral normals on 1M directions, and
+// speed. Every float to half with bExhaustive, 1/16 of them otherwise.
+void BenchmarkPacking(BOOL bExhaustive);
+
+//------ FastMathBenchmarks.cpp
+// Errors against libm, checked against the bounds FastMath.h documents, and speed
+void BenchmarkFastMath();
+
+//------ AssetBenchmarks.cpp
+void BenchmarkModels(const string& dataPath);
+void BenchmarkTextures(const string& dataPath);
+void BenchmarkMaterialFiles(const string& dataPath);
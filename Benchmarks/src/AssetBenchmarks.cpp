@@ -0,0 +1,155 @@
+#include "Benchmarks.h"
+#include "FileSystem.h"
+#include "NullMesh.h"
+
+#if PLATFORM == PLATFORM_WIN32
+#	include "../../DirectXTex/DirectXTex.h"
+#endif
+
+//////////////////////////////////////////////////////////////////////////
+// Every model of data/models through the null backend's loader: the best of
+// 3 loads, so that the file cache and the first touch of the heap stay out
+void BenchmarkModels(const string& dataPath)
+{
+	std::vector<string> models;
+	FileSystem::FindFiles(dataPath + "models\\", ".mesh", models);
+
+	u64 start, end;
+
+	// The scenes' device is gone, the buffers get created on this one
+	NullDevice device;
+	NullMesh::SetDevice(&device);
+
+	// Leave the scene's counts as they were
+	u32 vertexCount    = NullMesh::sTotalVertexCount;
+	u32 primitiveCount = NullMesh::sTotalPrimitiveCount;
+
+	printf("\nmodels, %u files:\n", (u32)models.size());
+	double totalMs = 0.0;
+	for (const string& path : models)
+	{
+		double bestMs = 1e9;
+		u32 vertices = 0;
+		for (u32 load = 0; load < 3; ++load)
+		{
+			NullMesh mesh;
+			start = Clock::Ticks();
+			mesh.LoadModelFromFile(path);
+			end = Clock::Ticks();
+			vertices = mesh.mVertexTotalCount;
+			mesh.Destroy();
+
+			double loadMs = Clock::Ms(end - start);
+			bestMs = loadMs < bestMs ? loadMs : bestMs;
+		}
+		totalMs += bestMs;
+
+		string stem = FileSystem::FileStem(path);
+		printf("  %-16s %8.2f ms, %u vertices\n", stem.c_str(), bestMs, vertices);
+		gBenchmarkReport.Record(("models." + stem + ".load").c_str(), bestMs, "ms");
+	}
+	gBenchmarkReport.Record("models.total", totalMs, "ms");
+
+	// The .mesh files are AssetImporter's output: the sources it reads are
+	// not in the data folder, and only that tool links assimp
+	printf("  assimp import: not available, no source model in the data folder\n");
+
+	NullMesh::sTotalVertexCount    = vertexCount;
+	NullMesh::sTotalPrimitiveCount = primitiveCount;
+	NullMesh::SetDevice(nullptr);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Every DDS and TGA texture of data/textures decoded by DirectXTex the way
+// DX11TextureManager loads it, the best of 3 loads per file. DirectXTex is
+// Windows only.
+void BenchmarkTextures(const string& dataPath)
+{
+#if PLATFORM == PLATFORM_WIN32
+	const char* extensions[2]  = { ".dds", ".tga" };
+	const char* resultNames[2] = { "textures.dds.decode", "textures.tga.decode" };
+	u64 start, end;
+
+	printf("\ntexture decode:\n");
+	for (u32 format = 0; format < 2; ++format)
+	{
+		std::vector<string> textures;
+		FileSystem::FindFiles(dataPath + "textures\\", extensions[format], textures);
+
+		double totalMs = 0.0;
+		u64 bytes  = 0;
+		u32 failed = 0;
+		for (const string& path : textures)
+		{
+			std::wstring pathW = StringToWString(path);
+			double bestMs = 1e9;
+			for (u32 load = 0; load < 3; ++load)
+			{
+				DirectX::TexMetadata metadata;
+				DirectX::ScratchImage image;
+				start = Clock::Ticks();
+				HRESULT hr = format == 0 ? DirectX::LoadFromDDSFile(pathW.c_str(), DirectX::DDS_FLAGS_NONE, &metadata, image)
+										 : DirectX::LoadFromTGAFile(pathW.c_str(), &metadata, image);
+				end = Clock::Ticks();
+				if (FAILED(hr))
+				{
+					++failed;
+					break;
+				}
+				if (load == 0)
+					bytes += image.GetPixelsSize();
+
+				double loadMs = Clock::Ms(end - start);
+				bestMs = loadMs < bestMs ? loadMs : bestMs;
+			}
+			totalMs += bestMs < 1e9 ? bestMs : 0.0;
+		}
+
+		printf("  %s %3u files: %8.2f ms, %.1f MB decoded%s\n", extensions[format] + 1, (u32)textures.size(), totalMs, bytes / 1048576.0, failed ? ", FAILED TO LOAD" : "");
+		gBenchmarkReport.Record(resultNames[format], totalMs, "ms");
+		RecordCheck((string(resultNames[format]) + ".load").c_str(), failed == 0);
+	}
+#else
+	UNREFERENCED_PARAMETER(dataPath);
+	printf("\ntexture decode: not available, DirectXTex is Windows only\n");
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Every material of data/materials parsed the way the loader reads it: the
+// file opened once, then the shader, the properties of the basic shader and
+// the textures looked up by key
+void BenchmarkMaterialFiles(const string& dataPath)
+{
+	std::vector<string> materials;
+	FileSystem::FindFiles(dataPath + "materials\\", ".mat", materials);
+
+	const u32 passes = 5;
+	u64 start, end;
+
+	u32 values = 0;
+	start = Clock::Ticks();
+	for (u32 pass = 0; pass < passes; ++pass)
+	{
+		for (const string& path : materials)
+		{
+			CIniFile::OpenFile(path);
+			values += CIniFile::GetValue("Name", "shader").empty() ? 0 : 1;
+			values += CIniFile::GetValueBool("Transparency", "properties") ? 1 : 0;
+			values += CIniFile::GetValueVector4("Albedo", "properties").w != 0.0f ? 1 : 0;
+			values += CIniFile::GetValueFloat("SpecularAmount", "properties") != 0.0f ? 1 : 0;
+			values += CIniFile::GetValueFloat("SpecularPower",  "properties") != 0.0f ? 1 : 0;
+			values += CIniFile::GetValue("Texture_Diffuse", "textures").empty() ? 0 : 1;
+			values += CIniFile::GetValue("Normal_Map",      "textures").empty() ? 0 : 1;
+			CIniFile::GetValueVector2("Tiling", "textures");
+			CIniFile::GetValueFloat("Rotation", "textures");
+			CIniFile::CloseFile();
+		}
+	}
+	end = Clock::Ticks();
+
+	u32 parsed = passes * (u32)materials.size();
+	double fileUs = parsed ? 1e6 * Clock::Seconds(end - start) / parsed : 0.0;
+	printf("\nmaterial files, %u files: %.1f us per file, %u values\n", (u32)materials.size(), fileUs, values / passes);
+	gBenchmarkReport.Record("materials.parse", fileUs, "us");
+}
@@ -0,0 +1,294 @@
+#include "Benchmarks.h"
+#include "Bounds.h"
+
+//////////////////////////////////////////////////////////////////////////
+// The culling paths of Bounds against brute force:
+//  - the SSE2 batch frustum tests must return what the scalar ones do, for
+//    every volume and every batch length, and those must match the plane
+//    test worked out corner by corner in double
+//  - the 15-axis separating test of OBB against an exact one: two convex
+//    boxes overlap iff an edge of one crosses the other, so 24 segment
+//    clippings in double decide it
+// Cases within a thousandth of touching may go either way, the SAT pads
+// near-parallel axes and floats round: they're counted, not failed.
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+	u32 gSeed = 77;
+	f32 Random(f32 low, f32 high)
+	{
+		gSeed = gSeed * 1664525u + 1013904223u;
+		return low + (high - low) * ((gSeed >> 8) / 16777216.0f);
+	}
+	//------------------------------------------------------------------------
+	Vector3 RandomVector(f32 low, f32 high)
+	{ return Vector3(Random(low, high), Random(low, high), Random(low, high)); }
+	//------------------------------------------------------------------------
+	Quaternion RandomRotation()
+	{ return Quaternion(RandomVector(-1.0f, 1.0f) + Vector3(0.0f, 1e-3f, 0.0f), Random(0.0f, 360.0f)); }
+
+	//------------------------------------------------------------------------
+	// Signed distance of the volume's farthest point along the plane normal,
+	// in double: < 0 means all of it is behind the plane
+	double FarthestDistance(const Plane& plane, const Sphere& sphere)
+	{
+		return	(double)plane.normal.x*sphere.center.x + (double)plane.normal.y*sphere.center.y +
+				(double)plane.normal.z*sphere.center.z + plane.d + sphere.radius;
+	}
+	//------------------------------------------------------------------------
+	double FarthestDistance(const Plane& plane, const AABB& box)
+	{
+		Vector3 corners[8];
+		box.Corners(corners);
+		double farthest = -DBL_MAX;
+		for (u32 i = 0; i < 8; ++i)
+		{
+			double distance =	(double)plane.normal.x*corners[i].x + (double)plane.normal.y*corners[i].y +
+								(double)plane.normal.z*corners[i].z + plane.d;
+			farthest = distance > farthest ? distance : farthest;
+		}
+		return farthest;
+	}
+
+	//------------------------------------------------------------------------
+	// Brute force against the frustum planes: 1 visible, 0 culled, -1 too
+	// close to one of the planes to tell
+	template <typename Volume>
+	i32 BruteForceVisible(const Frustum& frustum, const Volume& volume, double tolerance)
+	{
+		i32 visible = 1;
+		for (u32 i = 0; i < Frustum::PlaneCount; ++i)
+		{
+			double distance = FarthestDistance(frustum.planes[i], volume);
+			if (distance < -tolerance)
+				return 0;
+			if (distance <= tolerance)
+				visible = -1;
+		}
+		return visible;
+	}
+
+	//------------------------------------------------------------------------
+	// Batch against scalar on every volume and batch against brute force,
+	// then batch against scalar on the first 0..11 volumes for the tails
+	struct FrustumCheck
+	{
+		u32	mBatchMismatches;
+		u32	mWrong;
+		u32	mUndecided;
+		FrustumCheck() : mBatchMismatches(0), mWrong(0), mUndecided(0) {}
+	};
+
+	template <typename Volume>
+	void CheckFrustum(const Frustum& frustum, const std::vector<Volume>& volumes, std::vector<BOOL>& batch, FrustumCheck& check)
+	{
+		u32 count = (u32)volumes.size();
+		frustum.Intersects(&volumes[0], count, &batch[0]);
+		for (u32 i = 0; i < count; ++i)
+		{
+			BOOL scalar = frustum.Intersects(volumes[i]);
+			check.mBatchMismatches += (scalar != 0) != (batch[i] != 0) ? 1 : 0;
+
+			i32 expected = BruteForceVisible(frustum, volumes[i], 1e-3);
+			if (expected < 0)
+				++check.mUndecided;
+			else if ((expected == 1) != (scalar != 0))
+				++check.mWrong;
+		}
+
+		for (u32 length = 0; length < 12; ++length)
+		{
+			frustum.Intersects(&volumes[0], length, &batch[0]);
+			for (u32 i = 0; i < length; ++i)
+				check.mBatchMismatches += (frustum.Intersects(volumes[i]) != 0) != (batch[i] != 0) ? 1 : 0;
+		}
+	}
+
+	//------------------------------------------------------------------------
+	// Does segment [a, b] cross the box (inside included)? Slabs, in double.
+	BOOL SegmentHitsBox(const double a[3], const double b[3], const OBB& box, double scale, double pad)
+	{
+		double t0 = 0.0, t1 = 1.0;
+		for (u32 i = 0; i < 3; ++i)
+		{
+			const Vector3& axis = box.axes[i];
+			double extent = (i == 0 ? box.extents.x : (i == 1 ? box.extents.y : box.extents.z)) * scale + pad;
+			double p = (a[0] - box.center.x)*axis.x + (a[1] - box.center.y)*axis.y + (a[2] - box.center.z)*axis.z;
+			double d = (b[0] - a[0])*axis.x + (b[1] - a[1])*axis.y + (b[2] - a[2])*axis.z;
+			if (fabs(d) < 1e-300)
+			{
+				if (fabs(p) > extent)
+					return false;
+				continue;
+			}
+			double tNear = (-extent - p) / d;
+			double tFar  = ( extent - p) / d;
+			if (tNear > tFar)	{ double t = tNear; tNear = tFar; tFar = t; }
+			t0 = tNear > t0 ? tNear : t0;
+			t1 = tFar  < t1 ? tFar  : t1;
+			if (t0 > t1)
+				return false;
+		}
+		return true;
+	}
+	//------------------------------------------------------------------------
+	// The boxes scaled by scale and padded by pad
+	BOOL BruteForceOverlap(const OBB& a, const OBB& b, double scale, double pad)
+	{
+		const OBB* boxes[2] = { &a, &b };
+		for (u32 iBox = 0; iBox < 2; ++iBox)
+		{
+			const OBB& from  = *boxes[iBox];
+			const OBB& other = *boxes[1 - iBox];
+
+			double corners[8][3];
+			for (u32 i = 0; i < 8; ++i)
+			{
+				double sx = ((i & 1) ? 1.0 : -1.0) * (from.extents.x * scale + pad);
+				double sy = ((i & 2) ? 1.0 : -1.0) * (from.extents.y * scale + pad);
+				double sz = ((i & 4) ? 1.0 : -1.0) * (from.extents.z * scale + pad);
+				corners[i][0] = from.center.x + from.axes[0].x*sx + from.axes[1].x*sy + from.axes[2].x*sz;
+				corners[i][1] = from.center.y + from.axes[0].y*sx + from.axes[1].y*sy + from.axes[2].y*sz;
+				corners[i][2] = from.center.z + from.axes[0].z*sx + from.axes[1].z*sy + from.axes[2].z*sz;
+			}
+			// The 12 edges join the corners one bit apart
+			for (u32 i = 0; i < 8; ++i)
+				for (u32 bit = 1; bit < 8; bit <<= 1)
+					if (!(i & bit) && SegmentHitsBox(corners[i], corners[i | bit], other, scale, pad))
+						return true;
+		}
+		return false;
+	}
+
+	//------------------------------------------------------------------------
+	OBB RandomOBB(const Vector3& center, const Quaternion& rotation)
+	{
+		Quaternion q = rotation;
+		Matrix44 m = Matrix44::Scaling(RandomVector(0.1f, 2.0f)) * q.ToMatrix() * Matrix44::Translation(center);
+		return OBB::FromAABB(AABB(Vector3::zero, Vector3::one), m);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+void BenchmarkBounds()
+{
+	const u32 frustumCount = 16;
+	const u32 volumeCount  = 100003;		// not a multiple of 4: the scalar tail runs too
+	const u32 pairCount    = 200000;
+
+	printf("\nbounds against brute force:\n");
+
+	//---------- Frustum batch tests
+	std::vector<Sphere>	spheres(volumeCount);
+	std::vector<AABB>	boxes(volumeCount);
+	std::vector<BOOL>	batch(volumeCount);
+	FrustumCheck sphereCheck, boxCheck;
+	u64 batchTicks = 0, scalarTicks = 0;
+	u32 visibleSum = 0;
+
+	for (u32 iFrustum = 0; iFrustum < frustumCount; ++iFrustum)
+	{
+		Vector3 position = RandomVector(-20.0f, 20.0f);
+		Vector3 dir      = RandomVector(-1.0f, 1.0f) + Vector3(0.0f, 0.0f, 0.01f);
+		Matrix44 view = Matrix44::LookAt(position, dir.Normalize(), Vector3::up);
+		Matrix44 proj = Matrix44::PerspectiveFov(RJE::Math::Deg2Rad_f * Random(30.0f, 100.0f), Random(0.5f, 2.0f), Random(0.1f, 1.0f), Random(50.0f, 200.0f));
+		Frustum frustum = Frustum::FromViewProj(view * proj);
+
+		// Some of them with no size, and some exactly on the frustum planes
+		for (u32 i = 0; i < volumeCount; ++i)
+		{
+			f32 size = (i % 16 == 0) ? 0.0f : Random(0.0f, 5.0f);
+			Vector3 center = position + RandomVector(-120.0f, 120.0f);
+			if (i % 16 == 1)
+			{
+				const Plane& plane = frustum.planes[i % Frustum::PlaneCount];
+				center = center - plane.normal * (plane.Distance(center) / Vector3::Dot(plane.normal, plane.normal) + size);
+			}
+			spheres[i] = Sphere(center, size);
+			boxes[i]   = AABB(center, Vector3(size, Random(0.0f, 5.0f), Random(0.0f, 5.0f)));
+		}
+
+		CheckFrustum(frustum, spheres, batch, sphereCheck);
+		CheckFrustum(frustum, boxes,   batch, boxCheck);
+
+		u64 start = Clock::Ticks();
+		frustum.Intersects(&boxes[0], volumeCount, &batch[0]);
+		u64 end = Clock::Ticks();
+		batchTicks += end - start;
+		for (u32 i = 0; i < volumeCount; i += 97)
+			visibleSum += batch[i] ? 1 : 0;
+
+		start = Clock::Ticks();
+		for (u32 i = 0; i < volumeCount; ++i)
+			batch[i] = frustum.Intersects(boxes[i]);
+		end = Clock::Ticks();
+		scalarTicks += end - start;
+		for (u32 i = 0; i < volumeCount; i += 89)
+			visibleSum += batch[i] ? 1 : 0;
+	}
+
+	u32 tested = frustumCount * volumeCount;
+	printf("  frustum/sphere: %u tested, %u batch mismatches, %u wrong, %u within 1e-3 of a plane\n", tested, sphereCheck.mBatchMismatches, sphereCheck.mWrong, sphereCheck.mUndecided);
+	printf("  frustum/aabb:   %u tested, %u batch mismatches, %u wrong, %u within 1e-3 of a plane\n", tested, boxCheck.mBatchMismatches, boxCheck.mWrong, boxCheck.mUndecided);
+	RecordCheck("bounds.frustum_sphere_batch", sphereCheck.mBatchMismatches == 0);
+	RecordCheck("bounds.frustum_sphere",       sphereCheck.mWrong == 0);
+	RecordCheck("bounds.frustum_aabb_batch",   boxCheck.mBatchMismatches == 0);
+	RecordCheck("bounds.frustum_aabb",         boxCheck.mWrong == 0);
+
+	double batchNs  = 1e9 * Clock::Seconds(batchTicks)  / tested;
+	double scalarNs = 1e9 * Clock::Seconds(scalarTicks) / tested;
+	printf("  frustum/aabb:   batch %.2f ns, scalar %.2f ns per box (%u)\n", batchNs, scalarNs, visibleSum);
+	gBenchmarkReport.Record("bounds.frustum_aabb_batch",  batchNs,  "ns");
+	gBenchmarkReport.Record("bounds.frustum_aabb_scalar", scalarNs, "ns");
+
+	//---------- OBB/OBB separating axis test
+	// A quarter of the pairs share their orientation, or are a quarter turn
+	// apart: the edge cross products are then zero and only the padding
+	// keeps them from deciding
+	std::vector<OBB> first(pairCount), second(pairCount);
+	for (u32 i = 0; i < pairCount; ++i)
+	{
+		Quaternion rotation = RandomRotation();
+		first[i] = RandomOBB(Vector3::zero, rotation);
+
+		Quaternion other = RandomRotation();
+		if (i % 8 == 0)			other = rotation;
+		else if (i % 8 == 1)	other = rotation * Quaternion(Vector3::up, 90.0f);
+
+		Vector3 direction = RandomVector(-1.0f, 1.0f) + Vector3(1e-3f, 0.0f, 0.0f);
+		second[i] = RandomOBB(direction.Normalize() * Random(0.0f, 6.0f), other);
+	}
+
+	u32 wrong = 0, undecided = 0, overlaps = 0;
+	for (u32 i = 0; i < pairCount; ++i)
+	{
+		BOOL bSat = first[i].Intersects(second[i]);
+		overlaps += bSat ? 1 : 0;
+
+		// Overlapping even shrunk must be found, apart even grown must not be,
+		// whichever box tests the other
+		i32 expected = -1;
+		if (BruteForceOverlap(first[i], second[i], 0.999, -1e-4))
+			expected = 1;
+		else if (!BruteForceOverlap(first[i], second[i], 1.001, 1e-4))
+			expected = 0;
+
+		if (expected < 0)
+			++undecided;
+		else
+			wrong += ((expected == 1) != (bSat != 0) ? 1 : 0) + ((expected == 1) != (second[i].Intersects(first[i]) != 0) ? 1 : 0);
+	}
+
+	u64 start = Clock::Ticks();
+	u32 satSum = 0;
+	for (u32 i = 0; i < pairCount; ++i)
+		satSum += first[i].Intersects(second[i]) ? 1 : 0;
+	u64 end = Clock::Ticks();
+	double satNs = 1e9 * Clock::Seconds(end - start) / pairCount;
+
+	printf("  obb/obb:        %u pairs, %u overlapping, %u wrong, %u within 1e-3 of touching\n", pairCount, overlaps, wrong, undecided);
+	printf("  obb/obb:        %.2f ns per pair (%u)\n", satNs, satSum);
+	RecordCheck("bounds.obb_sat", wrong == 0);
+	gBenchmarkReport.Record("bounds.obb_sat", satNs, "ns");
+}
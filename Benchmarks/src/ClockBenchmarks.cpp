@@ -0,0 +1,204 @@
+#include "Benchmarks.h"
+
+#include <chrono>
+
+//////////////////////////////////////////////////////////////////////////
+// The engine clock: cost of a read against the OS clock and the standard
+// one, its calibration against the OS clock, then 24 hours of 60 Hz frames
+// (and an hour of pause) through a Timer on a ManualClock: the time must
+// come out exact, where summed float deltas drift and a float time is only
+// good to a few ms.
+void BenchmarkClock()
+{
+	printf("\nClock (%s, %.3f MHz)\n", Clock::GetSource() == Clock::Source_CycleCounter ? "rdtsc" : "OS clock", Clock::Frequency() / 1e6);
+
+	const u32 reads = 10000000;
+	HighResolutionClock highResolutionClock;
+	FrameClock* frameClock = &highResolutionClock;
+	for (u32 method = 0; method < 4; ++method)
+	{
+		u64 sum   = 0;
+		u64 start = Clock::Ticks();
+		switch (method)
+		{
+		case 0:	for (u32 i = 0; i < reads; ++i)	sum += Clock::Ticks();		break;
+		case 1:	for (u32 i = 0; i < reads; ++i)	sum += Clock::OsTicks();	break;
+		case 2:	for (u32 i = 0; i < reads; ++i)	sum += frameClock->Now();	break;
+		case 3:	for (u32 i = 0; i < reads; ++i)	sum += std::chrono::steady_clock::now().time_since_epoch().count();	break;
+		}
+		u64 end = Clock::Ticks();
+
+		const char* names[]       = { "Clock::Ticks", "Clock::OsTicks", "FrameClock::Now", "steady_clock::now" };
+		const char* resultNames[] = { "clock.ticks", "clock.os_ticks", "clock.frame_clock", "clock.steady_clock" };
+		printf("  %-18s %6.1f ns per read%s\n", names[method], Clock::Ms(end - start) * 1e6 / reads, sum ? "" : ", WRONG");
+		gBenchmarkReport.Record(resultNames[method], Clock::Ms(end - start) * 1e6 / reads, "ns");
+	}
+
+	// Against the OS clock over 200 ms
+	u64 ticksStart = Clock::Ticks();
+	u64 osStart    = Clock::OsTicks();
+	while (Clock::OsTicks() - osStart < Clock::OsFrequency() / 5) {}
+	f64 osSeconds    = (Clock::OsTicks() - osStart) / (f64)Clock::OsFrequency();
+	f64 clockSeconds = Clock::Seconds(Clock::Ticks() - ticksStart);
+	printf("  against the OS clock: %+.1f ppm\n", (clockSeconds / osSeconds - 1.0) * 1e6);
+
+	// 24 hours at 60 Hz, paused for an hour after 12
+	ManualClock manualClock(3000000000ull);
+	Timer timer(&manualClock);
+	timer.Reset(false);
+
+	const u32 frames = 24 * 3600 * 60;
+	f32 deltaSum = 0.0f;
+	for (u32 frame = 0; frame < frames; ++frame)
+	{
+		if (frame == frames / 2)
+		{
+			timer.Stop();
+			manualClock.Advance(3600.0);
+			timer.Start();
+		}
+		manualClock.Advance(1.0 / 60.0);
+		timer.Update();
+		deltaSum += timer.DeltaTime();
+	}
+	const f64 expected = frames / 60.0;
+	f64 timerError = timer.PreciseTime() - expected;
+	BOOL bExact    = fabs(timerError) < 1e-6 && timer.Time() == (f32)expected;
+
+	f32 floatStep = (f32)expected * FLT_EPSILON;
+	printf("  24 h of frames: timer %+.3f us off%s, summed float deltas %+.1f s off, float time in steps of up to %.1f ms\n",
+		timerError * 1e6, bExact ? "" : " WRONG", deltaSum - expected, floatStep * 1e3);
+	RecordCheck("clock.timer_24h", bExact);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// The FrameScheduler on a ManualClock, where every time is exact:
+//  - accumulator: 10000 frames of 5 to 40 ms (at time scales 1 and 0.5),
+//    the steps run plus Alpha() of a step is the scaled time, to 1 us
+//  - step cap: a 1 s frame runs mMaxSteps steps and drops the rest, the next
+//    frame doesn't make up for them
+//  - Alpha(): 1 in variable step, 0 while paused, and the pause owes nothing
+//  - limiter: at 100 fps a 3 ms frame waits 7 ms, a 15 ms one is over budget
+//    and doesn't wait, paused frames are held to mPausedFrameRate
+void BenchmarkFrameScheduler()
+{
+	printf("\nFrameScheduler on a ManualClock:\n");
+
+	ManualClock clock;
+	const f32 step = 1.0f / 60.0f;
+
+	//---------- Accumulator
+	f64 maxError = 0.0;
+	BOOL bAlphaInRange = true;
+	u32 maxSteps = 0;
+	for (u32 scaleIndex = 0; scaleIndex < 2; ++scaleIndex)
+	{
+		FrameScheduler scheduler(&clock);
+		scheduler.mbFixedStep = true;
+		scheduler.mFixedStep  = step;
+		scheduler.mTimeScale  = scaleIndex == 0 ? 1.0f : 0.5f;
+		scheduler.BeginFrame();
+
+		u64 startTicks = clock.Now();
+		u64 totalSteps = 0;
+		u32 seed = 1234;
+		for (u32 frame = 0; frame < 10000; ++frame)
+		{
+			seed = seed * 1664525u + 1013904223u;
+			clock.Advance(0.005 + 0.035 * (seed >> 8) / 16777216.0);
+			u32 steps = scheduler.BeginFrame();
+			totalSteps += steps;
+			maxSteps    = steps > maxSteps ? steps : maxSteps;
+
+			f64 simulated = (totalSteps + (f64)scheduler.Alpha()) * step;
+			f64 expected  = (clock.Now() - startTicks) / (f64)clock.Frequency() * scheduler.mTimeScale;
+			f64 error     = fabs(simulated - expected);
+			maxError      = error > maxError ? error : maxError;
+			bAlphaInRange = bAlphaInRange && scheduler.Alpha() >= 0.0f && scheduler.Alpha() < 1.0f && scheduler.mDroppedMs == 0.0f;
+		}
+	}
+	printf("  accumulator: 2 x 10000 frames of 5-40 ms, up to %u steps, steps + alpha %.3f us off the time%s\n",
+		maxSteps, maxError * 1e6, bAlphaInRange ? "" : ", ALPHA OUT OF [0, 1)");
+	RecordCheck("frame_scheduler.accumulator", maxError < 1e-6 && bAlphaInRange);
+
+	//---------- Step cap
+	{
+		FrameScheduler scheduler(&clock);
+		scheduler.mbFixedStep = true;
+		scheduler.mFixedStep  = step;
+		scheduler.BeginFrame();
+
+		// 60 steps and 0.6 of one owed
+		clock.Advance(61 * step - 0.4 * step);
+		u32 capSteps     = scheduler.BeginFrame();
+		f32 droppedMs    = scheduler.mDroppedMs;
+		f32 capAlpha     = scheduler.Alpha();
+		clock.Advance(step);
+		u32 nextSteps    = scheduler.BeginFrame();
+		f32 nextAlpha    = scheduler.Alpha();
+
+		BOOL bOk = capSteps == scheduler.mMaxSteps && fabs(droppedMs - 55 * step * 1000.0f) < 1e-3f
+				&& fabs(capAlpha - 0.6f) < 1e-4f && nextSteps == 1 && fabs(nextAlpha - 0.6f) < 1e-4f;
+		printf("  step cap: a 1 s frame runs %u steps, drops %.2f ms, alpha %.3f; the next one runs %u\n", capSteps, droppedMs, capAlpha, nextSteps);
+		RecordCheck("frame_scheduler.step_cap", bOk);
+	}
+
+	//---------- Alpha
+	{
+		FrameScheduler scheduler(&clock);
+		scheduler.mTimeScale = 2.0f;
+		scheduler.BeginFrame();
+		clock.Advance(0.025);
+		u32 variableSteps = scheduler.BeginFrame();
+		f32  variableAlpha = scheduler.Alpha();
+		BOOL bVariable = variableSteps == 1 && variableAlpha == 1.0f && fabs(scheduler.StepTime() - 0.05f) < 1e-6f;
+
+		scheduler.mbFixedStep = true;
+		scheduler.mFixedStep  = step;
+		scheduler.mTimeScale  = 1.0f;
+		clock.Advance(1.6 * step);
+		scheduler.BeginFrame();
+		clock.Advance(0.5);
+		u32 pausedSteps = scheduler.BeginFrame(true);
+		f32  pausedAlpha = scheduler.Alpha();
+		BOOL bPaused = pausedSteps == 0 && pausedAlpha == 0.0f && scheduler.StepTime() == 0.0f;
+
+		// Only the frame after the pause is owed: 0.6 of a step
+		clock.Advance(0.6 * step);
+		u32 resumedSteps = scheduler.BeginFrame();
+		BOOL bResumed = resumedSteps == 0 && fabs(scheduler.Alpha() - 0.6f) < 1e-4f;
+
+		printf("  alpha: variable step %.2f, paused %.2f, after the pause %.3f\n", variableAlpha, pausedAlpha, scheduler.Alpha());
+		RecordCheck("frame_scheduler.alpha", bVariable && bPaused && bResumed);
+	}
+
+	//---------- Limiter
+	{
+		FrameScheduler scheduler(&clock);
+		scheduler.mMaxFrameRate = 100.0f;
+		scheduler.BeginFrame();
+		clock.Advance(0.003);
+		scheduler.EndFrame();
+		f32 workMs = scheduler.mWorkMs;
+
+		scheduler.BeginFrame();
+		f32 waitMs  = scheduler.mWaitMs;
+		f32 frameMs = scheduler.mFrameMs;
+		BOOL bLimited = fabs(workMs - 3.0f) < 1e-3f && fabs(waitMs - 7.0f) < 1e-3f && fabs(frameMs - 10.0f) < 1e-3f
+					 && scheduler.mOverBudgetFrames == 0;
+
+		clock.Advance(0.015);
+		scheduler.EndFrame();
+		scheduler.BeginFrame();
+		BOOL bOverBudget = scheduler.mOverBudgetFrames == 1 && scheduler.mWaitMs == 0.0f && fabs(scheduler.mFrameMs - 15.0f) < 1e-3f;
+
+		clock.Advance(0.003);
+		scheduler.EndFrame();
+		scheduler.BeginFrame(true);
+		BOOL bPaused = fabs(scheduler.mWaitMs - 47.0f) < 1e-3f && fabs(scheduler.mFrameMs - 50.0f) < 1e-3f;
+
+		printf("  limiter at %.0f fps: 3 ms of work waits %.2f ms (%.2f ms frame), 15 ms is over budget (%u), paused frame %.2f ms\n",
+			scheduler.mMaxFrameRate, waitMs, frameMs, scheduler.mOverBudgetFrames, scheduler.mFrameMs);
+		RecordCheck("frame_scheduler.limiter", bLimited && bOverBudget && bPaused);
+	}
+}
@@ -0,0 +1,218 @@
+#include "Benchmarks.h"
+#include "FastMath.h"
+
+#include <cmath>
+
+//////////////////////////////////////////////////////////////////////////
+// FastMath against libm in double, over the input range each function
+// documents: max abs, rel and ULP errors of the scalar and batch versions,
+// which must return the same bits, then the ns per value of both and of
+// the float CRT function they stand in for.
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+	const u32 kSampleCount = 1 << 20;
+
+	//------------------------------------------------------------------------
+	struct FastMathError
+	{
+		double	mMaxAbs;
+		double	mMaxRel;
+		double	mMaxUlp;
+
+		FastMathError() : mMaxAbs(0.0), mMaxRel(0.0), mMaxUlp(0.0) {}
+
+		void Add(f32 value, double reference)
+		{
+			double error = fabs((double)value - reference);
+			double rel   = reference != 0.0 ? error / fabs(reference) : error;
+
+			// Spacing of the floats around the reference, denormals included
+			int exponent = -149 + 24;
+			if (reference != 0.0)
+				frexp(reference, &exponent);
+			double ulp = ldexp(1.0, exponent - 24 < -149 ? -149 : exponent - 24);
+
+			mMaxAbs = error > mMaxAbs ? error : mMaxAbs;
+			mMaxRel = rel > mMaxRel ? rel : mMaxRel;
+			mMaxUlp = error / ulp > mMaxUlp ? error / ulp : mMaxUlp;
+		}
+	};
+
+	//------------------------------------------------------------------------
+	u32 gSeed = 2024;
+	f64 Random01()
+	{
+		gSeed = gSeed * 1664525u + 1013904223u;
+		return (gSeed >> 8) / 16777216.0;
+	}
+
+	//------------------------------------------------------------------------
+	u32 BitMismatches(const std::vector<f32>& a, const std::vector<f32>& b)
+	{
+		u32 mismatches = 0;
+		for (u32 i = 0; i < a.size(); ++i)
+			mismatches += memcmp(&a[i], &b[i], sizeof(f32)) != 0 ? 1 : 0;
+		return mismatches;
+	}
+
+	//------------------------------------------------------------------------
+	// The error, then the bound as printed and checked
+	void Report(const char* name, const FastMathError& error, BOOL bRelative, double bound, u32 batchMismatches)
+	{
+		BOOL bOk = (bRelative ? error.mMaxRel : error.mMaxAbs) < bound;
+		printf("  %-8s abs %8.2e  rel %8.2e  %5.2f ulp   %s < %.0e%s%s\n", name, error.mMaxAbs, error.mMaxRel, error.mMaxUlp,
+				bRelative ? "rel" : "abs", bound, bOk ? "" : "  OVER", batchMismatches ? "  BATCH DIFFERS" : "");
+
+		string check = string("fastmath.") + name;
+		RecordCheck((check + ".accuracy").c_str(), bOk);
+		RecordCheck((check + ".batch").c_str(), batchMismatches == 0);
+	}
+
+	//------------------------------------------------------------------------
+	// ns per value of the scalar, batch and CRT versions
+	void ReportSpeed(const char* name, double scalarNs, double batchNs, double crtNs)
+	{
+		if (batchNs > 0.0)
+			printf("  %-8s scalar %6.2f ns  batch %6.2f ns  crt %6.2f ns\n", name, scalarNs, batchNs, crtNs);
+		else
+			printf("  %-8s scalar %6.2f ns  batch      -     crt %6.2f ns\n", name, scalarNs, crtNs);
+
+		string result = string("fastmath.") + name;
+		gBenchmarkReport.Record((result + ".scalar").c_str(), scalarNs, "ns");
+		if (batchNs > 0.0)
+			gBenchmarkReport.Record((result + ".batch").c_str(), batchNs, "ns");
+		gBenchmarkReport.Record((result + ".crt").c_str(), crtNs, "ns");
+	}
+
+	//------------------------------------------------------------------------
+	double NsPerValue(u64 start, u64 end)
+	{ return 1e9 * Clock::Seconds(end - start) / kSampleCount; }
+}
+
+//////////////////////////////////////////////////////////////////////////
+void BenchmarkFastMath()
+{
+	const u32 count = kSampleCount;
+	std::vector<f32> in(count), in2(count), scalar(count), batch(count), scalar2(count), batch2(count);
+	u64 start, end;
+	f32 sum = 0.0f;
+
+	printf("\nfastmath against libm, %u values each:\n", count);
+
+	//---------- RSqrt, Sqrt: every normal float exponent
+	for (u32 i = 0; i < count; ++i)
+	{
+		u32 bits = 0x00800000u + (u32)(Random01() * (0x7F7FFFFFu - 0x00800000u));
+		memcpy(&in[i], &bits, sizeof(f32));
+	}
+	FastMathError rsqrtError, sqrtError;
+	for (u32 i = 0; i < count; ++i)
+		scalar[i] = RJE::FastMath::RSqrt(in[i]);
+	RJE::FastMath::RSqrt(&in[0], &batch[0], count);
+	for (u32 i = 0; i < count; ++i)
+	{
+		rsqrtError.Add(scalar[i], 1.0 / sqrt((double)in[i]));
+		sqrtError .Add(RJE::FastMath::Sqrt(in[i]), sqrt((double)in[i]));
+	}
+	sqrtError.Add(RJE::FastMath::Sqrt(0.0f), 0.0);
+	Report("rsqrt", rsqrtError, true, 3e-7, BitMismatches(scalar, batch));
+	Report("sqrt",  sqrtError,  true, 3e-7, 0);
+
+	//---------- SinCos: |x| <= 8192, half of them within one turn
+	for (u32 i = 0; i < count; ++i)
+		in[i] = (f32)((Random01() * 2.0 - 1.0) * (i & 1 ? 8192.0 : RJE_TWO_PI));
+	in[0] = 8192.0f;	in[1] = -8192.0f;	in[2] = 0.0f;
+	FastMathError sinError, cosError;
+	for (u32 i = 0; i < count; ++i)
+		RJE::FastMath::SinCos(in[i], scalar[i], scalar2[i]);
+	RJE::FastMath::SinCos(&in[0], &batch[0], &batch2[0], count);
+	for (u32 i = 0; i < count; ++i)
+	{
+		sinError.Add(scalar[i],  sin((double)in[i]));
+		cosError.Add(scalar2[i], cos((double)in[i]));
+	}
+	Report("sin", sinError, false, 8e-8, BitMismatches(scalar, batch));
+	Report("cos", cosError, false, 8e-8, BitMismatches(scalar2, batch2));
+
+	//---------- Atan2: every direction, 2^-20 to 2^20 away, and the axes
+	for (u32 i = 0; i < count; ++i)
+	{
+		double angle  = (Random01() * 2.0 - 1.0) * RJE_PI;
+		double radius = ldexp(1.0, (int)(Random01() * 40.0) - 20);
+		in[i]  = (f32)(radius * sin(angle));
+		in2[i] = (f32)(radius * cos(angle));
+	}
+	const f32 axes[][2] = { {0.0f, 1.0f}, {1.0f, 0.0f}, {0.0f, -1.0f}, {-1.0f, 0.0f}, {1.0f, 1.0f}, {-1.0f, -1.0f}, {0.0f, 0.0f} };
+	for (u32 i = 0; i < sizeof(axes) / sizeof(axes[0]); ++i)
+	{
+		in[i]  = axes[i][0];
+		in2[i] = axes[i][1];
+	}
+	FastMathError atan2Error;
+	for (u32 i = 0; i < count; ++i)
+		scalar[i] = RJE::FastMath::Atan2(in[i], in2[i]);
+	RJE::FastMath::Atan2(&in[0], &in2[0], &batch[0], count);
+	for (u32 i = 0; i < count; ++i)
+		atan2Error.Add(scalar[i], atan2((double)in[i], (double)in2[i]));
+	Report("atan2", atan2Error, false, 3e-7, BitMismatches(scalar, batch));
+
+	//---------- Exp: [-87, 88]
+	for (u32 i = 0; i < count; ++i)
+		in2[i] = (f32)(-87.0 + 175.0 * Random01());
+	in2[0] = -87.0f;	in2[1] = 88.0f;		in2[2] = 0.0f;
+	FastMathError expError;
+	for (u32 i = 0; i < count; ++i)
+		scalar[i] = RJE::FastMath::Exp(in2[i]);
+	RJE::FastMath::Exp(&in2[0], &batch[0], count);
+	for (u32 i = 0; i < count; ++i)
+		expError.Add(scalar[i], exp((double)in2[i]));
+	Report("exp", expError, true, 1e-7, BitMismatches(scalar, batch));
+
+	//---------- Speed, on the sin/cos angles (in) and the exp inputs (in2)
+	for (u32 i = 0; i < count; ++i)
+		in[i] = (f32)((Random01() * 2.0 - 1.0) * RJE_TWO_PI);
+
+	start = Clock::Ticks();		for (u32 i = 0; i < count; ++i) scalar[i] = RJE::FastMath::RSqrt(in2[i] + 88.0f);	end = Clock::Ticks();
+	double scalarNs = NsPerValue(start, end);
+	for (u32 i = 0; i < count; ++i)	batch2[i] = in2[i] + 88.0f;
+	start = Clock::Ticks();		RJE::FastMath::RSqrt(&batch2[0], &batch[0], count);								end = Clock::Ticks();
+	double batchNs = NsPerValue(start, end);
+	start = Clock::Ticks();		for (u32 i = 0; i < count; ++i) scalar2[i] = 1.0f / sqrtf(in2[i] + 88.0f);			end = Clock::Ticks();
+	ReportSpeed("rsqrt", scalarNs, batchNs, NsPerValue(start, end));
+	sum += scalar[count / 2] + batch[count / 3] + scalar2[count / 4];
+
+	start = Clock::Ticks();		for (u32 i = 0; i < count; ++i) scalar[i] = RJE::FastMath::Sqrt(in2[i] + 88.0f);	end = Clock::Ticks();
+	scalarNs = NsPerValue(start, end);
+	start = Clock::Ticks();		for (u32 i = 0; i < count; ++i) scalar2[i] = sqrtf(in2[i] + 88.0f);					end = Clock::Ticks();
+	ReportSpeed("sqrt", scalarNs, 0.0, NsPerValue(start, end));
+	sum += scalar[count / 2] + scalar2[count / 4];
+
+	start = Clock::Ticks();		for (u32 i = 0; i < count; ++i) RJE::FastMath::SinCos(in[i], scalar[i], scalar2[i]);	end = Clock::Ticks();
+	scalarNs = NsPerValue(start, end);
+	start = Clock::Ticks();		RJE::FastMath::SinCos(&in[0], &batch[0], &batch2[0], count);							end = Clock::Ticks();
+	batchNs = NsPerValue(start, end);
+	start = Clock::Ticks();		for (u32 i = 0; i < count; ++i) { scalar[i] = sinf(in[i]); scalar2[i] = cosf(in[i]); }	end = Clock::Ticks();
+	ReportSpeed("sincos", scalarNs, batchNs, NsPerValue(start, end));
+	sum += scalar[count / 2] + batch[count / 3] + scalar2[count / 4] + batch2[count / 5];
+
+	start = Clock::Ticks();		for (u32 i = 0; i < count; ++i) scalar[i] = RJE::FastMath::Atan2(in[i], in2[i]);	end = Clock::Ticks();
+	scalarNs = NsPerValue(start, end);
+	start = Clock::Ticks();		RJE::FastMath::Atan2(&in[0], &in2[0], &batch[0], count);							end = Clock::Ticks();
+	batchNs = NsPerValue(start, end);
+	start = Clock::Ticks();		for (u32 i = 0; i < count; ++i) scalar2[i] = atan2f(in[i], in2[i]);				end = Clock::Ticks();
+	ReportSpeed("atan2", scalarNs, batchNs, NsPerValue(start, end));
+	sum += scalar[count / 2] + batch[count / 3] + scalar2[count / 4];
+
+	start = Clock::Ticks();		for (u32 i = 0; i < count; ++i) scalar[i] = RJE::FastMath::Exp(in2[i]);	end = Clock::Ticks();
+	scalarNs = NsPerValue(start, end);
+	start = Clock::Ticks();		RJE::FastMath::Exp(&in2[0], &batch[0], count);								end = Clock::Ticks();
+	batchNs = NsPerValue(start, end);
+	start = Clock::Ticks();		for (u32 i = 0; i < count; ++i) scalar2[i] = expf(in2[i]);					end = Clock::Ticks();
+	ReportSpeed("exp", scalarNs, batchNs, NsPerValue(start, end));
+	sum += scalar[count / 2] + batch[count / 3] + scalar2[count / 4];
+
+	if (sum != sum)
+		printf("  WRONG SUM\n");
+}
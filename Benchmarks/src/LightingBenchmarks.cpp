@@ -0,0 +1,312 @@
+#include "Benchmarks.h"
+#include "LightClusters.h"
+#include "TiledLightCulling.h"
+#include "PointLightSet.h"
+#include "FastMath.h"
+
+//////////////////////////////////////////////////////////////////////////
+// MAX_LIGHTS random point lights binned into a 1080p cluster grid, on every
+// core and on one, checked against the brute force reference
+void BenchmarkLightClusters()
+{
+	const u32 iterations = 20;
+	const u32 width = 1920, height = 1080;
+	const f32 nearZ = 0.1f, farZ = 1000.0f;
+
+	std::vector<PointLight> lights(MAX_LIGHTS);
+	u64 seed = 0x9E3779B97F4A7C15ull;
+	auto random01 = [&seed]() -> f32
+	{
+		seed ^= seed << 13;
+		seed ^= seed >> 7;
+		seed ^= seed << 17;
+		return (seed >> 40) / static_cast<f32>(1 << 24);
+	};
+	for (PointLight& light : lights)
+	{
+		// Same range as the scene lights, spread over a 100 x 10 x 100 floor in front of the camera
+		light.Position = Vector3(100.0f*random01() - 50.0f, 10.0f*random01(), 100.0f*random01());
+		light.Range    = 1.0f + 1.5f*random01();
+	}
+
+	Matrix44 proj = Matrix44::PerspectiveFov(RJE::Math::Deg2Rad_f*60.0f, (f32)width / height, nearZ, farZ);
+	Matrix44 view = Matrix44::LookAt(Vector3(0.0f, 5.0f, -10.0f), Vector3(0.0f, -0.1f, 1.0f), Vector3::up);
+
+	LightClusterGrid grid, reference;
+	grid.Setup(width, height, proj, nearZ, farZ);
+	reference.Setup(width, height, proj, nearZ, farZ);
+
+	u64 start, end;
+
+	u32    workerCounts[2] = { grid.mWorkerCount, 1 };
+	double buildMs[2]      = { 0.0, 0.0 };
+	BOOL   bSame = true;
+	for (u32 i = 0; i < 2; ++i)
+	{
+		grid.mWorkerCount = workerCounts[i];
+		start = Clock::Ticks();
+		for (u32 it = 0; it < iterations; ++it)
+			grid.Build(&lights[0], MAX_LIGHTS, view);
+		end = Clock::Ticks();
+		buildMs[i] = Clock::Ms(end - start) / iterations;
+		reference.BuildReference(&lights[0], MAX_LIGHTS, view);
+		bSame = bSame && grid.SameLists(reference);
+	}
+
+	// The worker threads stay up between builds: grow them, leave some idle, reuse them
+	const u32 poolCounts[] = { 4, 2, 8, 1, 3, 8 };
+	for (u32 n : poolCounts)
+	{
+		grid.mWorkerCount = n;
+		grid.Build(&lights[0], MAX_LIGHTS, view);
+		bSame = bSame && grid.SameLists(reference);
+	}
+
+	start = Clock::Ticks();
+	reference.BuildReference(&lights[0], MAX_LIGHTS, view);
+	end = Clock::Ticks();
+	double referenceMs = Clock::Ms(end - start);
+
+	f32 averageLights;
+	u32 maxLights, usedClusters;
+	grid.Occupancy(averageLights, maxLights, usedClusters);
+
+	printf("\nlight clusters, %u point lights, %ux%u, %ux%ux%u clusters:\n", MAX_LIGHTS, width, height, grid.mTilesX, grid.mTilesY, grid.mSlices);
+	printf("  build %.3f ms (%u threads), %.3f ms (1 thread), brute force %.3f ms, %s\n",
+		buildMs[0], workerCounts[0], buildMs[1], referenceMs, bSame ? "same lists" : "LISTS DIFFER");
+	gBenchmarkReport.Record("light_clusters.build", buildMs[0], "ms");
+	gBenchmarkReport.Record("light_clusters.build_1_thread", buildMs[1], "ms");
+	RecordCheck("light_clusters.lists", bSame);
+	printf("  %u indices, %u clusters used, %.1f lights per used cluster, max %u\n",
+		(u32)grid.mLightIndices.size(), usedClusters, averageLights, maxLights);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// The tiled deferred culling of deferred.fx, run on the CPU over a 1080p view
+// of a ground plane for every tile size, checked against the brute force
+// tile frusta. Missed lights are bugs; extra ones only cost shading time.
+void BenchmarkTiledLightCulling()
+{
+	const u32 width = 1920, height = 1080;
+	const f32 nearZ = 0.1f, farZ = 1000.0f;
+
+	std::vector<PointLight> lights(MAX_LIGHTS);
+	u64 seed = 0x9E3779B97F4A7C15ull;
+	auto random01 = [&seed]() -> f32
+	{
+		seed ^= seed << 13;
+		seed ^= seed >> 7;
+		seed ^= seed << 17;
+		return (seed >> 40) / static_cast<f32>(1 << 24);
+	};
+	for (PointLight& light : lights)
+	{
+		light.Position = Vector3(100.0f*random01() - 50.0f, 10.0f*random01(), 100.0f*random01());
+		light.Range    = 1.0f + 1.5f*random01();
+	}
+
+	Matrix44 proj = Matrix44::PerspectiveFov(RJE::Math::Deg2Rad_f*60.0f, (f32)width / height, nearZ, farZ);
+	Matrix44 view = Matrix44::LookAt(Vector3(0.0f, 5.0f, -10.0f), Vector3(0.0f, -0.1f, 1.0f), Vector3::up);
+
+	// View z of the y = 0 plane through each pixel center, the sky above the horizon
+	Vector3 groundNormal(view.m21, view.m22, view.m23);
+	f32     groundDistance = groundNormal.x*view.m41 + groundNormal.y*view.m42 + groundNormal.z*view.m43;
+	std::vector<f32> viewZ(width*height);
+	for (u32 y = 0; y < height; ++y)
+	{
+		for (u32 x = 0; x < width; ++x)
+		{
+			Vector3 ray((2.0f*(x + 0.5f) / width - 1.0f) / proj.m11, (1.0f - 2.0f*(y + 0.5f) / height) / proj.m22, 1.0f);
+			f32 rayDotNormal = ray.x*groundNormal.x + ray.y*groundNormal.y + ray.z*groundNormal.z;
+			f32 z = (rayDotNormal != 0.0f) ? groundDistance / rayDotNormal : -1.0f;
+			viewZ[y*width + x] = (z > 0.0f) ? z : RJE::Math::Infinity_f;
+		}
+	}
+
+	u64 start, end;
+
+	printf("\ntiled light culling, %u point lights, %ux%u:\n", MAX_LIGHTS, width, height);
+
+	const u32 tileDims[3] = { 8, 16, 32 };
+	for (u32 i = 0; i < 3; ++i)
+	{
+		TiledLightCulling culling, bruteForce;
+		start = Clock::Ticks();
+		culling.Cull(&viewZ[0], width, height, view, proj, nearZ, farZ, &lights[0], MAX_LIGHTS, tileDims[i]);
+		end = Clock::Ticks();
+		double cullMs = Clock::Ms(end - start);
+
+		bruteForce.CullBruteForce(&viewZ[0], width, height, view, proj, nearZ, farZ, &lights[0], MAX_LIGHTS, tileDims[i]);
+
+		u32 missed, extra;
+		TiledLightCulling::Compare(culling, bruteForce, missed, extra);
+		f32 averageLights;
+		u32 maxLights;
+		culling.Occupancy(averageLights, maxLights);
+
+		printf("  %2ux%-2u tiles (%ux%u): %.3f ms, %u missed, %u extra, %.2f lights per tile, max %u%s\n",
+			tileDims[i], tileDims[i], culling.mTilesX, culling.mTilesY, cullMs, missed, extra, averageLights, maxLights,
+			tileDims[i] == COMPUTE_SHADER_TILE_GROUP_DIM ? " (current)" : "");
+
+		char name[64];
+		sprintf_s(name, "tiled_culling.%ux%u", tileDims[i], tileDims[i]);
+		gBenchmarkReport.Record(name, cullMs, "ms");
+		sprintf_s(name, "tiled_culling.%ux%u.missed", tileDims[i], tileDims[i]);
+		RecordCheck(name, missed == 0);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// MAX_LIGHTS orbiting point lights for 1000 frames: the per frame rebuild of
+// the whole light buffer against PointLightSet, animated, paused, and paused
+// with one light edited per frame. "Uploads" are copies into a CPU array.
+// Then Interpolate(): between the step's start and end, exact at 0 and 1,
+// nothing to upload again for the same alpha, none at all while paused or
+// for a new layout; and its cost on frames with no step.
+void BenchmarkPointLights()
+{
+	const u32 frames = 1000;
+	const f32 dt = 1.0f / 60.0f;
+	const f32 radiusScale = 50.0f, heightScale = 10.0f;
+
+	PointLightSet* set = rje_new PointLightSet();
+	for (u32 i = 0; i < MAX_LIGHTS; ++i)
+	{
+		set->mOrbitRadius[i] = sqrt(RJE::Math::Rand(0.0f, 1.0f));
+		set->mOrbitHeight[i] = sqrt(RJE::Math::Rand(0.0f, 1.0f));
+		set->mOrbitAngle[i]  = RJE::Math::Rand(0.0f, RJE::Math::Pi_Two_f);
+		set->mOrbitSpeed[i]  = RJE::Math::Rand(0.1f, 2.0f);
+		set->SetLight(i, Color::GetRandomVector3RGBNorm(), 2.0f, 0.8f);
+	}
+	set->SetCount(MAX_LIGHTS);
+
+	std::vector<PointLight> gpuLights(MAX_LIGHTS);
+	std::vector<LightRange> ranges;
+
+	u64 start, end;
+
+	printf("\npoint lights, %u lights, %u frames:\n", MAX_LIGHTS, frames);
+
+	// Before: fmodf per light, batch SinCos, every light packed and written every frame
+	{
+		std::vector<f32> angles(MAX_LIGHTS), sinAngles(MAX_LIGHTS), cosAngles(MAX_LIGHTS);
+		std::vector<PointLight> workingLights(set->mLights, set->mLights + MAX_LIGHTS);
+		f32 timer = 0.0f;
+
+		start = Clock::Ticks();
+		for (u32 frame = 0; frame < frames; ++frame)
+		{
+			timer += 0.5f*dt;
+			for (u32 i = 0; i < MAX_LIGHTS; ++i)
+				angles[i] = fmodf(set->mOrbitAngle[i] + timer * set->mOrbitSpeed[i], RJE::Math::Pi_Two_f);
+			RJE::FastMath::SinCos(&angles[0], &sinAngles[0], &cosAngles[0], MAX_LIGHTS);
+			for (u32 i = 0; i < MAX_LIGHTS; ++i)
+			{
+				workingLights[i].Position.x = set->mOrbitRadius[i] * radiusScale * cosAngles[i];
+				workingLights[i].Position.y = set->mOrbitHeight[i] * heightScale;
+				workingLights[i].Position.z = set->mOrbitRadius[i] * radiusScale * sinAngles[i];
+				gpuLights[i] = workingLights[i];
+			}
+		}
+		end = Clock::Ticks();
+		double frameMs = Clock::Ms(end - start) / frames;
+		printf("  full rebuild     : %.4f ms/frame, %u bytes/frame\n", frameMs, (u32)(MAX_LIGHTS * sizeof(PointLight)));
+		gBenchmarkReport.Record("point_lights.full_rebuild", frameMs, "ms");
+	}
+
+	const char* modeNames[3]   = { "set, animated    ", "set, paused      ", "set, 1 light edit" };
+	const char* resultNames[3] = { "point_lights.animated", "point_lights.paused", "point_lights.one_edit" };
+	for (u32 mode = 0; mode < 3; ++mode)
+	{
+		u64 uploadedBytes = 0;
+		start = Clock::Ticks();
+		for (u32 frame = 0; frame < frames; ++frame)
+		{
+			if (mode == 2)
+			{
+				u32 light = (frame * 2654435761u) % MAX_LIGHTS;
+				set->SetLight(light, set->mLights[light].Color, 2.0f + 0.001f*frame, 0.8f);
+			}
+			set->Update(0.5f*dt, mode == 0, radiusScale, heightScale);
+
+			set->DirtyRanges(ranges);
+			for (u32 i = 0; i < ranges.size(); ++i)
+			{
+				memcpy(&gpuLights[ranges[i].mFirst], &set->mLights[ranges[i].mFirst], ranges[i].mCount * sizeof(PointLight));
+				uploadedBytes += ranges[i].mCount * sizeof(PointLight);
+			}
+			set->ClearDirty();
+		}
+		end = Clock::Ticks();
+		double frameMs = Clock::Ms(end - start) / frames;
+		printf("  %s: %.4f ms/frame, %u bytes/frame\n", modeNames[mode], frameMs, (u32)(uploadedBytes / frames));
+		gBenchmarkReport.Record(resultNames[mode], frameMs, "ms");
+		gBenchmarkReport.Record((string(resultNames[mode]) + ".upload").c_str(), (f64)(uploadedBytes / frames), "B");
+	}
+
+	//---------- Interpolate
+	{
+		std::vector<PointLight> before(set->mLights, set->mLights + MAX_LIGHTS);
+		set->Update(0.5f*dt, true, radiusScale, heightScale);
+		std::vector<PointLight> after(set->mLights, set->mLights + MAX_LIGHTS);
+		set->ClearDirty();
+
+		u32 wrong = 0;
+		set->Interpolate(0.0f);
+		for (u32 i = 0; i < MAX_LIGHTS; ++i)
+			wrong += set->mLights[i].Position != before[i].Position ? 1 : 0;
+		set->Interpolate(0.25f);
+		for (u32 i = 0; i < MAX_LIGHTS; ++i)
+		{
+			Vector3 expected = before[i].Position + (after[i].Position - before[i].Position) * 0.25f;
+			wrong += (set->mLights[i].Position - expected).SqrMagnitude() > 1e-8f ? 1 : 0;
+		}
+		u32 movedDirty = set->DirtyLightCount();
+		set->ClearDirty();
+		set->Interpolate(0.25f);
+		u32 sameAlphaDirty = set->DirtyLightCount();
+		set->Interpolate(1.0f);
+		for (u32 i = 0; i < MAX_LIGHTS; ++i)
+			wrong += set->mLights[i].Position != after[i].Position ? 1 : 0;
+		set->ClearDirty();
+
+		// Paused: shown where it is whatever the alpha
+		set->Update(0.5f*dt, false, radiusScale, heightScale);
+		set->Interpolate(0.5f);
+		u32 pausedDirty = set->DirtyLightCount();
+		// A new layout: no slide from the old one
+		set->Update(0.5f*dt, true, radiusScale * 2.0f, heightScale);
+		std::vector<PointLight> relaid(set->mLights, set->mLights + MAX_LIGHTS);
+		set->ClearDirty();
+		set->Interpolate(0.5f);
+		u32 layoutDirty = set->DirtyLightCount();
+		for (u32 i = 0; i < MAX_LIGHTS; ++i)
+			wrong += set->mLights[i].Position != relaid[i].Position ? 1 : 0;
+
+		BOOL bOk = wrong == 0 && movedDirty == MAX_LIGHTS && sameAlphaDirty == 0 && pausedDirty == 0 && layoutDirty == 0;
+		printf("  interpolate      : %u wrong, dirty: moved %u, same alpha %u, paused %u, new layout %u\n",
+			wrong, movedDirty, sameAlphaDirty, pausedDirty, layoutDirty);
+		RecordCheck("point_lights.interpolate", bOk);
+
+		// A step every other frame (120 fps on a 60 Hz step): Interpolate() and the upload
+		set->Update(0.5f*dt, true, radiusScale, heightScale);
+		set->ClearDirty();
+		start = Clock::Ticks();
+		for (u32 frame = 0; frame < frames; ++frame)
+		{
+			if (frame & 1)
+				set->Update(0.5f*dt, true, radiusScale, heightScale);
+			set->Interpolate(frame & 1 ? 0.0f : 0.5f);
+			set->DirtyRanges(ranges);
+			for (u32 i = 0; i < ranges.size(); ++i)
+				memcpy(&gpuLights[ranges[i].mFirst], &set->mLights[ranges[i].mFirst], ranges[i].mCount * sizeof(PointLight));
+			set->ClearDirty();
+		}
+		end = Clock::Ticks();
+		double frameMs = Clock::Ms(end - start) / frames;
+		printf("  set, interpolated: %.4f ms/frame, a step every other frame\n", frameMs);
+		gBenchmarkReport.Record("point_lights.interpolated", frameMs, "ms");
+	}
+
+	RJE_SAFE_DELETE(set);
+}
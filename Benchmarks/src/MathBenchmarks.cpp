@@ -0,0 +1,176 @@
+#include "Benchmarks.h"
+#include "FastMath.h"
+
+//////////////////////////////////////////////////////////////////////////
+// The values MathHelper.cpp asserts at compile time, checked at run time
+// for the toolsets without constexpr, where the builders are plain code.
+static BOOL NearlyEqual(f64 a, f64 b, f64 eps = 1e-6)	{ return fabs(a-b) <= eps; }
+
+static void BenchmarkConstantBuilders()
+{
+	u32 failures = 0;
+	const BOOL checks[] =
+	{
+		NearlyEqual(RJE::Math::ConstSin(0.0), 0.0),
+		NearlyEqual(RJE::Math::ConstSin(RJE_HALF_PI), 1.0, 1e-12),
+		NearlyEqual(RJE::Math::ConstSin(RJE_PI/6.0), 0.5, 1e-12),
+		NearlyEqual(RJE::Math::ConstSin(-7.0*RJE_PI/6.0), 0.5, 1e-12),
+		NearlyEqual(RJE::Math::ConstCos(RJE_PI), -1.0, 1e-12),
+		NearlyEqual(RJE::Math::ConstCos(100.0), 0.86231887228768389, 1e-9),
+		Vector3::Cross(Vector3(1,0,0), Vector3(0,1,0)) == Vector3(0,0,1),
+		Vector3::Dot(Vector3(1,2,3), Vector3(4,5,6)) == 32.0f,
+		(Vector3(1,2,3) - Vector3(1.0f)) * 2.0f == Vector3(0,2,4),
+		Matrix44().Trace() == 4.0f && Matrix44().Determinant() == 1.0f,
+		(Matrix44::Translation(1,2,3) * Matrix44::Scaling(2,2,2)).m43 == 6.0f,
+		Matrix44::Translation(1,2,3) * Matrix44::Scaling(2,2,2) * Vector3(1,1,1) == Vector3(2,2,2),
+		NearlyEqual(Matrix44::RotationZ(90.0f).m11, 0.0) && NearlyEqual(Matrix44::RotationZ(90.0f).m21, 1.0),
+		NearlyEqual(Matrix44::RotationX(30.0f).Determinant(), 1.0),
+		NearlyEqual(Matrix44::RotationY(-45.0f).m13, -0.70710678),
+		Matrix44::Orthographic(4.0f, 2.0f, 1.0f, 11.0f).m11 == 0.5f && Matrix44::Orthographic(4.0f, 2.0f, 1.0f, 11.0f).m22 == 1.0f,
+		NearlyEqual(Matrix44::Orthographic(4.0f, 2.0f, 1.0f, 11.0f).m43, -0.1),
+		NearlyEqual(RJE::Math::Deg2Rad * 180.0, RJE::Math::Pi, 1e-12),
+	};
+	for (u32 i = 0; i < sizeof(checks) / sizeof(checks[0]); ++i)
+		failures += checks[i] ? 0 : 1;
+
+	printf("  constant builders: %u/%u wrong\n", failures, (u32)(sizeof(checks) / sizeof(checks[0])));
+	RecordCheck("math.constant_builders", failures == 0);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// A table of the builders' results: with constexpr it is constant
+// initialized, in the binary's data, and RJE_C_ASSERT reads it at compile
+// time. Any builder that stops folding fails the build here, not a check.
+// On v110 it is built before main like any other static.
+#if RJE_HAS_CONSTEXPR
+static constexpr Matrix44 kFoldedTransforms[] =
+#else
+static const Matrix44 kFoldedTransforms[] =
+#endif
+{
+	Matrix44::Translation(1.0f, 2.0f, 3.0f),
+	Matrix44::Scaling(2.0f, 3.0f, 4.0f),
+	Matrix44::RotationX(30.0f),
+	Matrix44::RotationY(-45.0f),
+	Matrix44::RotationZ(90.0f),
+	Matrix44::Orthographic(4.0f, 2.0f, 1.0f, 11.0f),
+	Matrix44::Translation(1.0f, 2.0f, 3.0f) * Matrix44::RotationZ(90.0f) * Matrix44::Scaling(2.0f, 2.0f, 2.0f),
+};
+static const u32 kFoldedTransformCount = sizeof(kFoldedTransforms) / sizeof(kFoldedTransforms[0]);
+
+#if RJE_HAS_CONSTEXPR
+RJE_C_ASSERT(kFoldedTransforms[0].m43 == 3.0f && kFoldedTransforms[1].m33 == 4.0f,	"folded Translation, Scaling");
+RJE_C_ASSERT(kFoldedTransforms[5].m11 == 0.5f,										"folded Orthographic");
+#endif
+
+//------------------------------------------------------------------------
+// The table against the same builders fed values the compiler can't see
+static void BenchmarkFoldedTable()
+{
+	volatile f32 one = 1.0f;
+	const f32 two = 2.0f * one, three = 3.0f * one;
+	const Matrix44 built[] =
+	{
+		Matrix44::Translation(one, two, three),
+		Matrix44::Scaling(two, three, 4.0f * one),
+		Matrix44::RotationX(30.0f * one),
+		Matrix44::RotationY(-45.0f * one),
+		Matrix44::RotationZ(90.0f * one),
+		Matrix44::Orthographic(4.0f * one, two, one, 11.0f * one),
+		Matrix44::Translation(one, two, three) * Matrix44::RotationZ(90.0f * one) * Matrix44::Scaling(two, two, two),
+	};
+	RJE_C_ASSERT(sizeof(built) == sizeof(kFoldedTransforms), "a built matrix per folded one");
+
+	u32 failures = 0;
+	for (u32 i = 0; i < kFoldedTransformCount; ++i)
+	{
+		const f32* folded  = &kFoldedTransforms[i].m11;
+		const f32* runtime = &built[i].m11;
+		BOOL bSame = true;
+		for (u32 e = 0; e < 16; ++e)
+			bSame &= NearlyEqual(folded[e], runtime[e]);
+		failures += bSame ? 0 : 1;
+	}
+
+	printf("  folded table: %u/%u wrong, %s\n", failures, kFoldedTransformCount, RJE_HAS_CONSTEXPR ? "constant initialized" : "built before main, no constexpr");
+	RecordCheck("math.folded_table", failures == 0);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// The math library on 4096 random transforms: products, inverses, vectors
+// and quaternions, in ns per operation. M * M^-1 must come out as identity.
+void BenchmarkMath()
+{
+	const u32 count  = 4096;
+	const u32 passes = 100;
+
+	std::vector<Matrix44>	matrices(count);
+	std::vector<Matrix44>	results(count);
+	std::vector<Vector3>	vectors(count);
+	std::vector<Quaternion>	quaternions(count);
+	std::vector<f32>		angles(count), sines(count), cosines(count);
+	u32 seed = 12345;
+	for (u32 i = 0; i < count; ++i)
+	{
+		f32 random[7];
+		for (u32 r = 0; r < 7; ++r)
+		{
+			seed = seed * 1664525u + 1013904223u;
+			random[r] = (seed >> 8) / 16777216.0f;
+		}
+		matrices[i] = Matrix44::RotationY(360.0f * random[0]) * Matrix44::Translation(10.0f * random[1], 10.0f * random[2], 10.0f * random[3]);
+		matrices[i].m11 *= 1.0f + random[4];
+		vectors[i]     = Vector3(random[4] - 0.5f, random[5] - 0.5f, random[6] + 0.1f);
+		quaternions[i] = Quaternion(Vector3(random[1], random[2], random[3]), random[0]);
+		angles[i]      = RJE::Math::Pi_Two_f * (random[5] - 0.5f);
+	}
+
+	u64 start, end;
+	const char* names[] = { "math.matrix_multiply", "math.matrix_inverse", "math.transform_vector", "math.vector_normalize", "math.quaternion_to_matrix", "math.fast_sincos" };
+	f32 sum = 0.0f;
+
+	printf("\nmath, %u items:\n", count);
+	for (u32 test = 0; test < 6; ++test)
+	{
+		start = Clock::Ticks();
+		for (u32 pass = 0; pass < passes; ++pass)
+		{
+			switch (test)
+			{
+			case 0:	for (u32 i = 0; i < count; ++i)	results[i] = matrices[i] * matrices[(i + 1) % count];	break;
+			case 1:	for (u32 i = 0; i < count; ++i)	{ results[i] = matrices[i]; results[i].Inverse(); }		break;
+			case 2:	for (u32 i = 0; i < count; ++i)	sum += (matrices[i] * vectors[i]).x;					break;
+			case 3:	for (u32 i = 0; i < count; ++i)	{ Vector3 v = vectors[i]; sum += v.Normalize().z; }		break;
+			case 4:	for (u32 i = 0; i < count; ++i)	results[i] = (Matrix44)quaternions[i];					break;
+			case 5:	RJE::FastMath::SinCos(&angles[0], &sines[0], &cosines[0], count);						break;
+			}
+			sum += results[pass % count].m11 + sines[pass % count];
+		}
+		end = Clock::Ticks();
+
+		double opNs = 1e9 * Clock::Seconds(end - start) / (passes * count);
+		printf("  %-26s %6.2f ns\n", names[test] + 5, opNs);
+		gBenchmarkReport.Record(names[test], opNs, "ns");
+	}
+
+	// M * M^-1
+	f32 maxError = 0.0f;
+	for (u32 i = 0; i < count; ++i)
+	{
+		Matrix44 inverse = matrices[i];
+		inverse.Inverse();
+		Matrix44 product = matrices[i] * inverse;
+		const f32* p = &product.m11;
+		const f32* id = &Matrix44::identity.m11;
+		for (u32 e = 0; e < 16; ++e)
+		{
+			f32 error = fabsf(p[e] - id[e]);
+			maxError = error > maxError ? error : maxError;
+		}
+	}
+	printf("  M * M^-1: max error %.2g%s\n", maxError, sum == sum ? "" : ", WRONG SUM");
+	RecordCheck("math.inverse", maxError < 1e-4f && sum == sum);
+
+	BenchmarkConstantBuilders();
+	BenchmarkFoldedTable();
+}
@@ -0,0 +1,394 @@
+#include "Benchmarks.h"
+
+#include <thread>
+#include <list>
+
+//////////////////////////////////////////////////////////////////////////
+// rje_new's tracker: 10M alloc/free pairs over fake addresses, each thread
+// keeping 1024 allocations alive, against the list with a linear search it
+// replaced (on fewer pairs, it is quadratic)
+void BenchmarkMemoryTracker()
+{
+	const u32 totalPairs = 10000000;
+	const u32 liveCount  = 1024;
+	const u32 siteLine   = __LINE__;
+
+	printf("\nmemory tracker, %u alloc/free pairs, %u live per thread:\n", totalPairs, liveCount);
+	for (u32 threadCount = 1; threadCount <= 4; threadCount *= 2)
+	{
+		const u32 pairs = totalPairs / threadCount;
+
+		u64 start, end;
+		start = Clock::Ticks();
+		std::vector<std::thread> threads;
+		for (u32 t = 0; t < threadCount; ++t)
+		{
+			threads.push_back(std::thread([=]()
+			{
+				std::vector<uintptr_t> live(liveCount, 0);
+				uintptr_t base = (uintptr_t)(t + 1) << 40;
+				for (u32 i = 0; i < pairs; ++i)
+				{
+					uintptr_t& slot = live[i % liveCount];
+					RemoveTrack((void*)slot);
+					slot = base + (uintptr_t)i * 16;
+					AddTrack((void*)slot, 64, __FILE__, siteLine);
+				}
+				for (u32 i = 0; i < liveCount; ++i)
+					RemoveTrack((void*)live[i]);
+			}));
+		}
+		for (std::thread& thread : threads)
+		{
+			thread.join();
+		}
+		end = Clock::Ticks();
+		double pairNs = 1e9 * Clock::Seconds(end - start) / totalPairs;
+		printf("  %u thread(s): %.1f ns per pair\n", threadCount, pairNs);
+
+		char name[64];
+		sprintf_s(name, "memory_tracker.pair_%u_threads", threadCount);
+		gBenchmarkReport.Record(name, pairNs, "ns");
+	}
+
+	// Everything freed, every allocation counted once
+	std::vector<MemorySiteStats> sites;
+	MemorySites(sites);
+	BOOL bStats = false;
+	for (const MemorySiteStats& site : sites)
+	{
+		if (site.mLine == siteLine && strcmp(site.mFile, __FILE__) == 0)
+			bStats = site.mLiveCount == 0 && site.mLiveBytes == 0 && site.mAllocations == 3 * (u64)totalPairs && site.mPeakBytes >= 64 * liveCount;
+	}
+	printf("  call site stats: %s\n", bStats ? "ok" : "WRONG");
+	RecordCheck("memory_tracker.site_stats", bStats);
+
+	struct ListEntry { uintptr_t mAddress; size_t mSize; };
+	const u32 listPairs = totalPairs / 100;
+	std::list<ListEntry> list;
+	u64 start, end;
+	start = Clock::Ticks();
+	for (u32 i = 0; i < listPairs; ++i)
+	{
+		if (i >= liveCount)
+		{
+			uintptr_t address = (uintptr_t)(i - liveCount) * 16 + 16;
+			for (auto it = list.begin(); it != list.end(); ++it)
+			{
+				if (it->mAddress == address)
+				{
+					list.erase(it);
+					break;
+				}
+			}
+		}
+		ListEntry entry = { (uintptr_t)i * 16 + 16, 64 };
+		list.push_front(entry);
+	}
+	end = Clock::Ticks();
+	printf("  list tracker, %u pairs: %.1f ns per pair\n", listPairs, 1e9 * Clock::Seconds(end - start) / listPairs);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// What a frame typically allocates: text rebuilt for the overlays, a draw
+// list grown one item at a time, small per-object scratch arrays
+struct BenchmarkDrawItem { u64 mKey; u32 mObject; u32 mSubset; f32 mDepth; u32 mPadding[3]; };
+
+template<class String, class DrawList, class Scratch>
+static size_t FrameAllocations(u32 frame)
+{
+	size_t checksum = 0;
+	char number[32];
+	for (u32 line = 0; line < 64; ++line)
+	{
+		sprintf_s(number, "%u", frame * 64 + line);
+		String text = "Scope ";
+		text += number;
+		text += " : 0.00 ms / 0.00 ms\n";
+		checksum += text.size();
+	}
+
+	DrawList drawList;
+	for (u32 i = 0; i < 2000; ++i)
+	{
+		BenchmarkDrawItem item = { (u64)i * 2654435761u, i, i & 7, 0.0f };
+		drawList.push_back(item);
+	}
+	checksum += drawList.size();
+
+	for (u32 object = 0; object < 200; ++object)
+	{
+		Scratch scratch;
+		for (u32 i = 0; i < 8; ++i)
+			scratch.push_back(object + i);
+		checksum += scratch.back();
+	}
+	return checksum;
+}
+
+//------------------------------------------------------------------------
+void BenchmarkFrameArena()
+{
+	const u32 frames = 2000;
+
+	u64 start, end;
+
+	size_t heapChecksum = 0;
+	start = Clock::Ticks();
+	for (u32 frame = 0; frame < frames; ++frame)
+	{
+		heapChecksum += FrameAllocations<std::string, std::vector<BenchmarkDrawItem>, std::vector<u32> >(frame);
+	}
+	end = Clock::Ticks();
+	double heapUs = 1e6 * Clock::Seconds(end - start) / frames;
+
+	// From a new peak: the engine's own frames don't count
+	FrameArena::DeleteInstance();
+	FrameArena* arena = FrameArena::Instance();
+
+	size_t arenaChecksum = 0;
+	start = Clock::Ticks();
+	for (u32 frame = 0; frame < frames; ++frame)
+	{
+		arena->BeginFrame();
+		arenaChecksum += FrameAllocations<FrameString, FrameVector<BenchmarkDrawItem>::Type, FrameVector<u32>::Type>(frame);
+	}
+	end = Clock::Ticks();
+	double arenaUs = 1e6 * Clock::Seconds(end - start) / frames;
+	arena->BeginFrame();
+
+	printf("\nframe arena, %u frames of 64 strings, a 2000 item draw list, 200 scratch arrays:\n", frames);
+	printf("  heap: %.1f us/frame, arena: %.1f us/frame (x%.1f)%s\n", heapUs, arenaUs, heapUs / arenaUs, heapChecksum == arenaChecksum ? "" : ", RESULTS DIFFER");
+	printf("  arena: %.1f KB last frame, peak %.1f KB (frame %u), %u chunk overflow(s)\n",
+		arena->LastFrameBytes() / 1024.0, arena->PeakFrameBytes() / 1024.0, arena->PeakFrame(), arena->Overflows());
+	gBenchmarkReport.Record("frame_arena.heap", heapUs, "us");
+	gBenchmarkReport.Record("frame_arena.arena", arenaUs, "us");
+	gBenchmarkReport.Record("frame_arena.peak", (f64)arena->PeakFrameBytes(), "B");
+	RecordCheck("frame_arena.results", heapChecksum == arenaChecksum);
+
+	// Poisoned by both Reset() paths: one chunk, then chunks merged into one
+	LinearArena poisoned(256);
+	poisoned.mbPoison = true;
+	u32 poisonErrors = 0;
+	for (u32 pass = 0; pass < 2; ++pass)
+	{
+		u32 size = pass == 0 ? 128 : 1024;
+		memset(poisoned.Allocate(size), 0, size);
+		poisoned.Reset();
+		const u8* bytes = static_cast<const u8*>(poisoned.Allocate(size));
+		for (u32 i = 0; i < size; ++i)
+			poisonErrors += bytes[i] != LinearArena::PoisonByte ? 1 : 0;
+		poisoned.Reset();
+	}
+	printf("  poison: %u byte(s) handed out again unpoisoned, %u overflow(s)\n", poisonErrors, poisoned.Overflows());
+	RecordCheck("frame_arena.poison", poisonErrors == 0 && poisoned.Overflows() == 1);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// About the size of a game object without its name: a transform and bounds
+struct BenchmarkEntity
+{
+	RJE_POOLED(BenchmarkEntity)
+
+	f32		mWorld[16];
+	f32		mBounds[4];
+	u32		mId;
+	u32		mFlags;
+	u64		mPadding[3];
+};
+ObjectPool<BenchmarkEntity> BenchmarkEntity::sPool("BenchmarkEntity");
+
+//------------------------------------------------------------------------
+static f32 VisitEntity(const BenchmarkEntity& entity)	{ return entity.mWorld[12] + entity.mBounds[3]; }
+
+//------------------------------------------------------------------------
+// new/delete throughput, objects freed in a random order, then the cost of
+// visiting every object once the heap is fragmented: allocations of other
+// sizes in between, half of the objects replaced
+void BenchmarkObjectPool()
+{
+	const u32 count  = 100000;
+	const u32 rounds = 10;
+
+	u64 start, end;
+
+	std::vector<u32> order(count);
+	u64 seed = 0x9E3779B97F4A7C15ull;
+	for (u32 i = 0; i < count; ++i)
+		order[i] = i;
+	for (u32 i = count - 1; i > 0; --i)
+	{
+		seed ^= seed << 13;
+		seed ^= seed >> 7;
+		seed ^= seed << 17;
+		std::swap(order[i], order[seed % (i + 1)]);
+	}
+
+	printf("\nobject pool, %u objects of %u bytes:\n", count, (u32)sizeof(BenchmarkEntity));
+
+	std::vector<BenchmarkEntity*> entities(count);
+	for (u32 pass = 0; pass < 2; ++pass)
+	{
+		BOOL bPool = pass == 1;
+
+		start = Clock::Ticks();
+		for (u32 round = 0; round < rounds; ++round)
+		{
+			for (u32 i = 0; i < count; ++i)
+				entities[i] = bPool ? new BenchmarkEntity : ::new BenchmarkEntity;
+			for (u32 i = 0; i < count; ++i)
+			{
+				if (bPool)	delete entities[order[i]];
+				else		::delete entities[order[i]];
+			}
+		}
+		end = Clock::Ticks();
+		double allocNs = 1e9 * Clock::Seconds(end - start) / (rounds * count);
+
+		std::vector<char*> garbage;
+		for (u32 i = 0; i < count; ++i)
+		{
+			entities[i] = bPool ? new BenchmarkEntity : ::new BenchmarkEntity;
+			entities[i]->mId = i;
+			garbage.push_back(rje_new char[16 + order[i] % 240]);
+		}
+		for (u32 i = 0; i < count; i += 2)
+		{
+			u32 replaced = order[i];
+			if (bPool)	delete entities[replaced];
+			else		::delete entities[replaced];
+			garbage.push_back(rje_new char[16 + i % 240]);
+			entities[replaced] = bPool ? new BenchmarkEntity : ::new BenchmarkEntity;
+			entities[replaced]->mId = replaced;
+		}
+		for (BenchmarkEntity* entity : entities)
+		{
+			memset(entity->mWorld, 0, sizeof(entity->mWorld));
+			memset(entity->mBounds, 0, sizeof(entity->mBounds));
+		}
+
+		const u32 visits = 20;
+		f32 sum = 0.0f;
+		start = Clock::Ticks();
+		for (u32 visit = 0; visit < visits; ++visit)
+		{
+			for (BenchmarkEntity* entity : entities)
+				sum += VisitEntity(*entity);
+		}
+		end = Clock::Ticks();
+		double listNs = 1e9 * Clock::Seconds(end - start) / (visits * count);
+
+		if (bPool)
+		{
+			start = Clock::Ticks();
+			for (u32 visit = 0; visit < visits; ++visit)
+			{
+				BenchmarkEntity::sPool.ForEach([&sum](const BenchmarkEntity& entity) { sum += VisitEntity(entity); });
+			}
+			end = Clock::Ticks();
+			double forEachNs = 1e9 * Clock::Seconds(end - start) / (visits * count);
+
+			printf("  pool: %.1f ns per new/delete, visit %.2f ns per object (pointer list), %.2f ns (ForEach), %u chunks%s\n",
+				allocNs, listNs, forEachNs, BenchmarkEntity::sPool.ChunkCount(), sum == 0.0f ? "" : ", WRONG SUM");
+			gBenchmarkReport.Record("object_pool.new_delete", allocNs, "ns");
+			gBenchmarkReport.Record("object_pool.visit_list", listNs, "ns");
+			gBenchmarkReport.Record("object_pool.visit_for_each", forEachNs, "ns");
+		}
+		else
+		{
+			printf("  heap: %.1f ns per new/delete, visit %.2f ns per object (pointer list)%s\n", allocNs, listNs, sum == 0.0f ? "" : ", WRONG SUM");
+			gBenchmarkReport.Record("object_pool.heap_new_delete", allocNs, "ns");
+		}
+
+		for (BenchmarkEntity* entity : entities)
+		{
+			if (bPool)	delete entity;
+			else		::delete entity;
+		}
+		for (char* block : garbage)
+			delete[] block;
+	}
+
+	// A handle doesn't follow its slot to the next object
+	BenchmarkEntity* first = new BenchmarkEntity;
+	PoolHandle<BenchmarkEntity> firstHandle = BenchmarkEntity::sPool.HandleOf(first);
+	BOOL bHandles = BenchmarkEntity::sPool.Get(firstHandle) == first;
+	delete first;
+	BenchmarkEntity* second = new BenchmarkEntity;
+	PoolHandle<BenchmarkEntity> secondHandle = BenchmarkEntity::sPool.HandleOf(second);
+	bHandles &= second == first && BenchmarkEntity::sPool.Get(firstHandle) == nullptr && BenchmarkEntity::sPool.Get(secondHandle) == second;
+	delete second;
+	bHandles &= BenchmarkEntity::sPool.LiveCount() == 0 && BenchmarkEntity::sPool.Get(PoolHandle<BenchmarkEntity>()) == nullptr;
+	printf("  handles: %s\n", bHandles ? "ok" : "WRONG");
+	RecordCheck("object_pool.handles", bHandles);
+
+	printf("  engine pools: %u game objects, %u materials, %u material properties live\n",
+		GameObject::sPool.LiveCount(), Material::sPool.LiveCount(), MaterialProperty::sPool.LiveCount());
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Memory budgets: the accounting and the over budget warnings checked on a
+// standalone MemoryBudget, the cost of an Add()/Remove() pair, then what the
+// engine's one holds once every scene was loaded.
+static u32 sBudgetWarnings = 0;
+static void CountBudgetWarning(MemoryCategory, i64, i64, const char*)	{ ++sBudgetWarnings; }
+
+void BenchmarkMemoryBudget()
+{
+	printf("\nMemory budget\n");
+
+	MemoryBudget budget;
+	budget.SetWarningHandler(CountBudgetWarning);
+	budget.SetBudget(Memory_Textures, 1000);
+	sBudgetWarnings = 0;
+
+	budget.Add(Memory_Textures, "a", 400);
+	budget.Add(Memory_Textures, "b", 500);
+	BOOL bOk = sBudgetWarnings == 0 && !budget.IsOverBudget(Memory_Textures);
+	budget.Add(Memory_Textures, "a", 200);			// 1100: over
+	budget.Add(Memory_Textures, "c", 50);			// still over, no new warning
+	bOk &= sBudgetWarnings == 1 && budget.IsOverBudget(Memory_Textures);
+	budget.Remove(Memory_Textures, "a", 200);		// 950
+	budget.Add(Memory_Textures, "c", 300);			// 1250: over again
+	bOk &= sBudgetWarnings == 2;
+	bOk &= budget.Release(Memory_Textures, "a") == 400;
+	budget.Add(Memory_Meshes, "a", 64);				// another category, no budget
+
+	MemoryCategoryStats stats = budget.Stats(Memory_Textures);
+	bOk &= stats.mBytes == 850 && stats.mPeakBytes == 1250 && stats.mResources == 3 && stats.mWarnings == 2;
+	bOk &= budget.TotalBytes() == 850 + 64 && !budget.IsOverBudget(Memory_Meshes);
+
+	std::vector<MemoryConsumer> top;
+	budget.TopConsumers(Memory_Textures, 1, top);
+	bOk &= top.size() == 1 && top[0].mName == "b" && top[0].mBytes == 500;
+	budget.TopConsumers(Memory_Textures, 8, top);
+	bOk &= top.size() == 2 && top[1].mName == "c" && top[1].mBytes == 350 && top[1].mResources == 2;
+	printf("  accounting: %s\n", bOk ? "ok" : "WRONG");
+	RecordCheck("memory_budget.accounting", bOk);
+
+	// Resources of 64 owners coming and going
+	u64 start, end;
+
+	char owners[64][16];
+	for (u32 i = 0; i < 64; ++i)
+		sprintf_s(owners[i], "owner%u", i);
+
+	budget.Reset();
+	for (u32 i = 0; i < 64; ++i)
+		budget.Add(Memory_Meshes, owners[i], 1 << 20);
+
+	const u32 pairs = 1000000;
+	start = Clock::Ticks();
+	for (u32 i = 0; i < pairs; ++i)
+	{
+		budget.Add(Memory_Meshes, owners[(i * 7) & 63], 4096);
+		budget.Remove(Memory_Meshes, owners[(i * 7) & 63], 4096);
+	}
+	end = Clock::Ticks();
+	stats = budget.Stats(Memory_Meshes);
+	double pairNs = 1e9 * Clock::Seconds(end - start) / pairs;
+	printf("  %.1f ns per add/remove pair, 64 owners%s\n", pairNs, stats.mBytes == 64 << 20 && stats.mResources == 64 ? "" : ", WRONG TOTAL");
+	gBenchmarkReport.Record("memory_budget.add_remove", pairNs, "ns");
+
+	MemoryBudget::Instance()->Print(3);
+}
@@ -0,0 +1,191 @@
+#include "Benchmarks.h"
+#include "Packing.h"
+
+using RJE::Packing;
+
+//////////////////////////////////////////////////////////////////////////
+// Packing, exhaustively where the format is small enough:
+//  - every half to float and back, the scalar code against the bulk one,
+//    which is F16C when the CPU has it
+//  - every float to half, scalar against bulk; by default only one block
+//    of 64K consecutive floats in 16, which still covers every exponent and
+//    every rounding case, the 2^32 of them take ~20 s
+//  - every snorm/unorm 8 and 16 bit code to float and back
+//  - octahedral snorm16 on 1M directions, max angle to the original
+// then ns per element of each conversion on 1M elements.
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+	u32 Bits(f32 f)	{ u32 u; memcpy(&u, &f, sizeof(u)); return u; }
+
+	//------------------------------------------------------------------------
+	// Every code to float and back must come out the same, scalar and bulk
+	template <typename T>
+	u32 NormRoundTripErrors(f32 (*toFloat)(T), T (*fromFloat)(f32),
+							void (*toFloatBulk)(const T*, f32*, u32), void (*fromFloatBulk)(const f32*, T*, u32),
+							i32 first, i32 last, i32 lowest)
+	{
+		u32 count = (u32)(last - first + 1);
+		std::vector<T>		codes(count), bulkCodes(count);
+		std::vector<f32>	floats(count);
+		for (u32 i = 0; i < count; ++i)
+			codes[i] = static_cast<T>(first + (i32)i);
+		toFloatBulk(&codes[0], &floats[0], count);
+		fromFloatBulk(&floats[0], &bulkCodes[0], count);
+
+		u32 errors = 0;
+		for (u32 i = 0; i < count; ++i)
+		{
+			// The code below -1 decodes to -1, which encodes to the one above
+			T expected = static_cast<T>(first + (i32)i < lowest ? lowest : first + (i32)i);
+			f32 f = toFloat(codes[i]);
+			errors += Bits(f) != Bits(floats[i]) ? 1 : 0;
+			errors += fromFloat(f) != expected ? 1 : 0;
+			errors += bulkCodes[i] != expected ? 1 : 0;
+		}
+		return errors;
+	}
+
+	//------------------------------------------------------------------------
+	double NsPerElement(u64 start, u64 end, u32 count)
+	{ return 1e9 * Clock::Seconds(end - start) / count; }
+}
+
+//////////////////////////////////////////////////////////////////////////
+void BenchmarkPacking(BOOL bExhaustive)
+{
+	const BOOL bF16C = Packing::HasF16C();
+	printf("\npacking, %s:\n", bF16C ? "bulk halves on F16C" : "no F16C, bulk halves on the scalar code");
+
+	//---------- Every half to float and back
+	std::vector<u16> halves(65536), halvesBack(65536);
+	std::vector<f32> halfFloats(65536);
+	for (u32 h = 0; h < 65536; ++h)
+		halves[h] = static_cast<u16>(h);
+	Packing::HalfToFloat(&halves[0], &halfFloats[0], 65536);
+	Packing::FloatToHalf(&halfFloats[0], &halvesBack[0], 65536);
+
+	u32 halfErrors = 0;
+	for (u32 h = 0; h < 65536; ++h)
+	{
+		// NaNs come back quiet
+		BOOL bNaN = (h & 0x7c00) == 0x7c00 && (h & 0x03ff) != 0;
+		u16 expected = static_cast<u16>(bNaN ? h | 0x0200 : h);
+		f32 f = Packing::HalfToFloat(static_cast<u16>(h));
+		halfErrors += Bits(f) != Bits(halfFloats[h]) ? 1 : 0;
+		halfErrors += Packing::FloatToHalf(f) != expected ? 1 : 0;
+		halfErrors += halvesBack[h] != expected ? 1 : 0;
+	}
+	printf("  half -> float -> half: 65536 halves, %u wrong\n", halfErrors);
+	RecordCheck("packing.half_round_trip", halfErrors == 0);
+
+	//---------- Floats to half, 64K at a time
+	const u32 chunk  = 1 << 16;
+	const u64 stride = bExhaustive ? chunk : 16 * chunk;
+	std::vector<f32> floats(chunk);
+	std::vector<u16> bulkHalves(chunk);
+	u64 floatErrors = 0;
+	u64 start = Clock::Ticks();
+	for (u64 base = 0; base < (1ull << 32); base += stride)
+	{
+		for (u32 i = 0; i < chunk; ++i)
+		{
+			u32 bits = static_cast<u32>(base) + i;
+			memcpy(&floats[i], &bits, sizeof(f32));
+		}
+		Packing::FloatToHalf(&floats[0], &bulkHalves[0], chunk);
+		for (u32 i = 0; i < chunk; ++i)
+			floatErrors += Packing::FloatToHalf(floats[i]) != bulkHalves[i] ? 1 : 0;
+	}
+	u64 end = Clock::Ticks();
+	printf("  float -> half: %s floats, %llu differ from the bulk path (%.1f s)\n", bExhaustive ? "all 2^32" : "2^28", (unsigned long long)floatErrors, Clock::Seconds(end - start));
+	RecordCheck("packing.float_to_half", floatErrors == 0);
+
+	//---------- Every snorm/unorm code
+	u32 normErrors = 0;
+	normErrors += NormRoundTripErrors<i8> (Packing::Snorm8ToFloat,  Packing::FloatToSnorm8,  Packing::Snorm8ToFloat,  Packing::FloatToSnorm8,  -128,   127,   -127);
+	normErrors += NormRoundTripErrors<i16>(Packing::Snorm16ToFloat, Packing::FloatToSnorm16, Packing::Snorm16ToFloat, Packing::FloatToSnorm16, -32768, 32767, -32767);
+	normErrors += NormRoundTripErrors<u8> (Packing::Unorm8ToFloat,  Packing::FloatToUnorm8,  Packing::Unorm8ToFloat,  Packing::FloatToUnorm8,  0,      255,   0);
+	normErrors += NormRoundTripErrors<u16>(Packing::Unorm16ToFloat, Packing::FloatToUnorm16, Packing::Unorm16ToFloat, Packing::FloatToUnorm16, 0,      65535, 0);
+	printf("  snorm/unorm 8/16 -> float -> code: every code, %u wrong\n", normErrors);
+	RecordCheck("packing.norm_round_trip", normErrors == 0);
+
+	//---------- Octahedral snorm16: a Fibonacci sphere, then the axes and diagonals
+	const u32 count = 1 << 20;
+	std::vector<Vector3> normals(count), decoded(count);
+	std::vector<u32>     packed(count);
+	const double golden = RJE_PI * (3.0 - sqrt(5.0));
+	for (u32 i = 0; i < count; ++i)
+	{
+		double z = 1.0 - 2.0 * (i + 0.5) / count;
+		double r = sqrt(1.0 - z*z);
+		normals[i] = Vector3((f32)(r * cos(golden * i)), (f32)(r * sin(golden * i)), (f32)z);
+	}
+	for (u32 i = 0, k = 0; i < 27; ++i)
+	{
+		if (i == 13)
+			continue;		// (0,0,0)
+		Vector3 n((f32)(i % 3) - 1.0f, (f32)((i / 3) % 3) - 1.0f, (f32)(i / 9) - 1.0f);
+		normals[k++] = n.Normalize();
+	}
+
+	Packing::OctEncodeSnorm16(&normals[0], &packed[0], count);
+	Packing::OctDecodeSnorm16(&packed[0], &decoded[0], count);
+	double maxDegrees = 0.0;
+	u32 octMismatches = 0;
+	for (u32 i = 0; i < count; ++i)
+	{
+		const Vector3& n = normals[i];
+		const Vector3& d = decoded[i];
+		double dot = ((double)n.x*d.x + (double)n.y*d.y + (double)n.z*d.z) / sqrt(((double)n.x*n.x + (double)n.y*n.y + (double)n.z*n.z) * ((double)d.x*d.x + (double)d.y*d.y + (double)d.z*d.z));
+		double degrees = acos(dot > 1.0 ? 1.0 : dot) * 180.0 / RJE_PI;
+		maxDegrees = degrees > maxDegrees ? degrees : maxDegrees;
+		octMismatches += Packing::OctEncodeSnorm16(n) != packed[i] ? 1 : 0;
+	}
+	printf("  oct snorm16: %u directions, max %.4f deg (< 0.04)%s\n", count, maxDegrees, octMismatches ? ", BULK DIFFERS" : "");
+	RecordCheck("packing.oct_snorm16", maxDegrees <= 0.04 && octMismatches == 0);
+
+	//---------- Speed, 1M elements
+	std::vector<f32> values(count), valuesBack(count);
+	std::vector<u16> halfValues(count);
+	std::vector<i16> snormValues(count);
+	for (u32 i = 0; i < count; ++i)
+		values[i] = normals[i].x * 100.0f;
+
+	start = Clock::Ticks();		for (u32 i = 0; i < count; ++i) halfValues[i] = Packing::FloatToHalf(values[i]);	end = Clock::Ticks();
+	double scalarNs = NsPerElement(start, end, count);
+	start = Clock::Ticks();		Packing::FloatToHalf(&values[0], &halfValues[0], count);							end = Clock::Ticks();
+	double bulkNs = NsPerElement(start, end, count);
+	printf("  float -> half      scalar %5.2f ns  bulk %5.2f ns\n", scalarNs, bulkNs);
+	gBenchmarkReport.Record("packing.float_to_half.scalar", scalarNs, "ns");
+	gBenchmarkReport.Record("packing.float_to_half.bulk",   bulkNs,   "ns");
+
+	start = Clock::Ticks();		for (u32 i = 0; i < count; ++i) valuesBack[i] = Packing::HalfToFloat(halfValues[i]);	end = Clock::Ticks();
+	scalarNs = NsPerElement(start, end, count);
+	start = Clock::Ticks();		Packing::HalfToFloat(&halfValues[0], &valuesBack[0], count);							end = Clock::Ticks();
+	bulkNs = NsPerElement(start, end, count);
+	printf("  half -> float      scalar %5.2f ns  bulk %5.2f ns\n", scalarNs, bulkNs);
+	gBenchmarkReport.Record("packing.half_to_float.scalar", scalarNs, "ns");
+	gBenchmarkReport.Record("packing.half_to_float.bulk",   bulkNs,   "ns");
+
+	start = Clock::Ticks();		for (u32 i = 0; i < count; ++i) snormValues[i] = Packing::FloatToSnorm16(normals[i].y);	end = Clock::Ticks();
+	scalarNs = NsPerElement(start, end, count);
+	start = Clock::Ticks();		Packing::FloatToSnorm16(&values[0], &snormValues[0], count);							end = Clock::Ticks();
+	bulkNs = NsPerElement(start, end, count);
+	printf("  float -> snorm16   scalar %5.2f ns  bulk %5.2f ns\n", scalarNs, bulkNs);
+	gBenchmarkReport.Record("packing.float_to_snorm16.scalar", scalarNs, "ns");
+	gBenchmarkReport.Record("packing.float_to_snorm16.bulk",   bulkNs,   "ns");
+
+	start = Clock::Ticks();		Packing::OctEncodeSnorm16(&normals[0], &packed[0], count);	end = Clock::Ticks();
+	double encodeNs = NsPerElement(start, end, count);
+	start = Clock::Ticks();		Packing::OctDecodeSnorm16(&packed[0], &decoded[0], count);	end = Clock::Ticks();
+	double decodeNs = NsPerElement(start, end, count);
+	printf("  oct snorm16        encode %5.2f ns  decode %5.2f ns\n", encodeNs, decodeNs);
+	gBenchmarkReport.Record("packing.oct_encode", encodeNs, "ns");
+	gBenchmarkReport.Record("packing.oct_decode", decodeNs, "ns");
+
+	f32 sum = valuesBack[count / 2] + decoded[count / 3].x + snormValues[count / 4];
+	if (sum != sum)
+		printf("  WRONG SUM\n");
+}
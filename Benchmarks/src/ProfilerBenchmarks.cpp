@@ -0,0 +1,403 @@
+#include "Benchmarks.h"
+
+#include <thread>
+#include <atomic>
+
+//////////////////////////////////////////////////////////////////////////
+// Cost of a PROFILE_CPU scope, from 1 to 4 threads, collected concurrently
+static void ProfiledLeaf()				{ PROFILE_CPU("Benchmark Leaf"); }
+static void ProfiledBurst(u32 leaves)	{ PROFILE_CPU("Benchmark Burst"); for (u32 i = 0; i < leaves; ++i) ProfiledLeaf(); }
+
+void BenchmarkProfiler()
+{
+#if RJE_PROFILE_CPU
+	// A burst fits in a ring: each one starts once the collector drained the last
+	const u32 scopesPerBurst = ProfileThreadBuffer::Capacity / 4;
+	const u32 bursts         = 200;
+
+	printf("\nprofiler, %u scopes per thread:\n", scopesPerBurst * bursts);
+	for (u32 threadCount = 1; threadCount <= 4; threadCount *= 2)
+	{
+		std::vector<double>			nsPerScope(threadCount);
+		std::vector<u32>			dropped(threadCount);
+		std::vector<std::thread>	threads;
+		std::atomic<u32>			finished(0);
+		for (u32 t = 0; t < threadCount; ++t)
+		{
+			threads.push_back(std::thread([&, t]()
+			{
+				ProfileThreadBuffer* buffer = ProfileThreadBuffer::Current();
+				u32 droppedBefore = buffer->mDropped.load();
+				u64 ticks = 0;
+				for (u32 burst = 0; burst < bursts; ++burst)
+				{
+					while (buffer->mRead.load() != buffer->mWrite.load())
+						std::this_thread::yield();
+
+					u64 start, end;
+					start = Clock::Ticks();
+					ProfiledBurst(scopesPerBurst - 1);
+					end = Clock::Ticks();
+					ticks += end - start;
+				}
+				nsPerScope[t] = 1e9 * Clock::Seconds(ticks) / (scopesPerBurst * bursts);
+				dropped[t]    = buffer->mDropped.load() - droppedBefore;
+				++finished;
+			}));
+		}
+		while (finished.load() < threadCount)
+		{
+			Profiler::Instance()->CollectFrame();
+		}
+		for (std::thread& thread : threads)
+		{
+			thread.join();
+		}
+		Profiler::Instance()->CollectFrame();
+
+		double average = 0.0;
+		u32    totalDropped = 0;
+		for (u32 t = 0; t < threadCount; ++t)
+		{
+			average      += nsPerScope[t] / threadCount;
+			totalDropped += dropped[t];
+		}
+		printf("  %u thread(s): %.1f ns per scope, %u events dropped\n", threadCount, average, totalDropped);
+
+		char name[64];
+		sprintf_s(name, "profiler.scope_%u_threads", threadCount);
+		gBenchmarkReport.Record(name, average, "ns");
+	}
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Reads back a Profiler capture: one event per line, every track named,
+// events sorted by time, and those of a track nested or disjoint
+static BOOL ValidateChromeTrace(const char* path, OUT u32& eventCount, OUT u32& trackCount)
+{
+	eventCount = 0;
+	trackCount = 0;
+	FILE* file = fopen(path, "r");
+	if (!file)
+		return false;
+
+	char line[512];
+	BOOL bValid = fgets(line, sizeof(line), file) && strcmp(line, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n") == 0;
+	BOOL bClosed = false;
+	std::vector<BOOL>				namedTracks;
+	std::vector<std::vector<double>>	openEnds;	// per track
+	double lastTs = 0.0;
+	while (bValid && !bClosed && fgets(line, sizeof(line), file))
+	{
+		if (strcmp(line, "]}\n") == 0)
+		{
+			bClosed = true;
+			break;
+		}
+
+		char   name[128], category[8];
+		u32    tid;
+		double ts, dur;
+		if (sscanf(line, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%127[^\"]\"}}", &tid, name) == 2)
+		{
+			if (tid >= namedTracks.size())
+			{
+				namedTracks.resize(tid + 1, false);
+				openEnds.resize(tid + 1);
+			}
+			namedTracks[tid] = true;
+			++trackCount;
+		}
+		else if (sscanf(line, "{\"name\":\"%127[^\"]\",\"cat\":\"%7[^\"]\",\"ph\":\"X\",\"ts\":%lf,\"dur\":%lf,\"pid\":1,\"tid\":%u}", name, category, &ts, &dur, &tid) == 5)
+		{
+			bValid = (strcmp(category, "cpu") == 0 || strcmp(category, "gpu") == 0)
+				  && tid < namedTracks.size() && namedTracks[tid]
+				  && ts >= lastTs && dur >= 0.0;
+			if (!bValid)
+				break;
+
+			// A scope starting inside another one must end inside it too (1 ns of rounding)
+			std::vector<double>& ends = openEnds[tid];
+			while (!ends.empty() && ends.back() <= ts)
+				ends.pop_back();
+			bValid = ends.empty() || ts + dur <= ends.back() + 1e-3;
+			ends.push_back(ts + dur);
+			lastTs = ts;
+			++eventCount;
+		}
+		else
+		{
+			bValid = false;
+		}
+	}
+	fclose(file);
+	return bValid && bClosed;
+}
+
+//------------------------------------------------------------------------
+static void CaptureSpin(double us)
+{
+	u64 start = Clock::Ticks();
+	u64 now;
+	do { now = Clock::Ticks(); }
+	while (1e6 * Clock::Seconds(now - start) < us);
+}
+static void CaptureUpdate()	{ PROFILE_CPU("Capture Update"); CaptureSpin(200.0); }
+static void CaptureDraw()	{ PROFILE_CPU("Capture Draw");   CaptureSpin(300.0); }
+static void CaptureJob()	{ PROFILE_CPU("Capture Job");    CaptureSpin(100.0); }
+
+//------------------------------------------------------------------------
+// Captures frames of a CPU workload on two threads and checks the file
+void BenchmarkProfilerCapture(const string& path)
+{
+#if RJE_PROFILE_CPU
+	const u32 frames = 10;
+
+	std::atomic<BOOL> bStop(false);
+	std::thread worker([&bStop]()
+	{
+		Profiler::Instance()->SetThreadName("Capture Worker");
+		while (!bStop.load())
+			CaptureJob();
+	});
+
+	Profiler::Instance()->CollectFrame();
+	Profiler::Instance()->BeginCapture(frames, path.c_str());
+	for (u32 frame = 0; frame < frames; ++frame)
+	{
+		{
+			PROFILE_CPU("Capture Frame");
+			CaptureUpdate();
+			CaptureDraw();
+		}
+		Profiler::Instance()->CollectFrame();
+	}
+	bStop = true;
+	worker.join();
+
+	u32 eventCount, trackCount;
+	BOOL bValid = ValidateChromeTrace(path.c_str(), eventCount, trackCount);
+	printf("\nprofiler capture, %u frames: %s, %u events on %u tracks (%s)\n", frames, bValid ? "valid" : "INVALID", eventCount, trackCount, path.c_str());
+	RecordCheck("profiler.capture", bValid);
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////
+// The hardware counters of two profiled pointer chases, as many steps each:
+// one in 4 KB, resident in L1, one in 32 MB, a cache miss a step. The
+// misses must show in the second only, and cost it cycles. Both chases go
+// round their cycle a whole number of times, back to 0.
+// Without a PMU (most VMs and containers) the chases still run through the
+// profiler with the counters asked for: the scopes must come out timed and
+// uncounted, and the thrash must show in the time alone.
+#if RJE_PROFILE_CPU && RJE_PERF_COUNTERS
+static u32 ChaseSteps(const std::vector<u32>& next, u32 steps)
+{
+	u32 index = 0;
+	for (u32 i = 0; i < steps; ++i)
+		index = next[index];
+	return index;
+}
+
+//------------------------------------------------------------------------
+// One cycle through every element, in random order (Sattolo), a cache line apart
+static void MakeChase(OUT std::vector<u32>& next, u32 bytes)
+{
+	const u32 stride = 64 / sizeof(u32);
+	u32 lines = bytes / 64;
+	std::vector<u32> order(lines);
+	for (u32 i = 0; i < lines; ++i)
+		order[i] = i;
+	u32 seed = 0x2545F491u;
+	for (u32 i = lines - 1; i > 0; --i)
+	{
+		seed = seed * 1664525u + 1013904223u;
+		std::swap(order[i], order[(seed >> 8) % i]);
+	}
+	next.assign(lines * stride, 0);
+	for (u32 i = 0; i < lines; ++i)
+		next[order[i] * stride] = order[(i + 1) % lines] * stride;
+}
+#endif
+
+//------------------------------------------------------------------------
+void BenchmarkHardwareCounters()
+{
+#if RJE_PROFILE_CPU && RJE_PERF_COUNTERS
+	u32 available = PerfCounters::Available();
+	printf("\nhardware counters:");
+	for (u32 c = 0; c < PerfCounter_Count; ++c)
+	{
+		if (available & (1 << c))
+			printf(" %s", PerfCounterName((PerfCounter)c));
+	}
+	printf("%s\n", available ? "" : " none (no PMU, or perf_event_paranoid), timing only");
+	BOOL bAvailable = Profiler::Instance()->SetHardwareCounters(true);
+
+	const u32 steps = 1 << 22;
+	std::vector<u32> resident, thrash;
+	MakeChase(resident, 4 * 1024);
+	MakeChase(thrash, 32 * 1024 * 1024);
+	ChaseSteps(thrash, steps);
+
+	ProfileScope scopes[2] = { { "Counters Resident", ATOMIC_VAR_INIT(0) }, { "Counters Thrash", ATOMIC_VAR_INIT(0) } };
+	PerfCounterValues counters[2];
+	u32 counted[2];
+	f64 nsPerStep[2];
+	u32 sum = 0;
+	Profiler::Instance()->CollectFrame();
+	for (u32 i = 0; i < 2; ++i)
+	{
+		u64 start = Clock::Ticks();
+		{
+			AutoProfile profile(scopes[i]);
+			sum += ChaseSteps(i == 0 ? resident : thrash, steps);
+		}
+		nsPerStep[i] = Clock::Ms(Clock::Ticks() - start) * 1e6 / steps;
+		Profiler::Instance()->CollectFrame();
+		counted[i] = Profiler::Instance()->FrameCounters(scopes[i].mId, counters[i]);
+	}
+	Profiler::Instance()->SetHardwareCounters(false);
+
+	// Opened, but the PMU never ran the group: as good as none
+	BOOL bCounted = counted[0] == 1 && counted[1] == 1;
+	const char* sizeNames[2]   = { "4 KB", "32 MB" };
+	const char* resultNames[2] = { "hardware_counters.resident", "hardware_counters.thrash" };
+	for (u32 i = 0; i < 2; ++i)
+	{
+		const u64* values = counters[i].mValues;
+		if (bCounted)
+		{
+			printf("  %-8s %.2f ns, %.2f cycles, %.2f instructions, %.3f L1D misses, %.3f LLC misses, %.3f branch misses per step\n",
+				sizeNames[i], nsPerStep[i], (f64)values[PerfCounter_Cycles] / steps, (f64)values[PerfCounter_Instructions] / steps,
+				(f64)values[PerfCounter_L1DMisses] / steps, (f64)values[PerfCounter_LLCMisses] / steps, (f64)values[PerfCounter_BranchMisses] / steps);
+			for (u32 c = 0; c < PerfCounter_Count; ++c)
+			{
+				if (available & (1 << c))
+					gBenchmarkReport.Record((string(resultNames[i]) + "." + PerfCounterName((PerfCounter)c)).c_str(), (f64)values[c] / steps, "per step");
+			}
+		}
+		else
+		{
+			printf("  %-8s %.2f ns per step\n", sizeNames[i], nsPerStep[i]);
+		}
+		gBenchmarkReport.Record(resultNames[i], nsPerStep[i], "ns");
+	}
+
+	// The time always, then what the CPU counts; no counts without counters
+	BOOL bOk = sum == 0 && nsPerStep[1] > 4.0 * nsPerStep[0];
+	if (bCounted)
+	{
+		bOk &= available != 0;
+		if (available & (1 << PerfCounter_Instructions))
+			bOk &= counters[0].mValues[PerfCounter_Instructions] >= steps && counters[1].mValues[PerfCounter_Instructions] >= steps;
+		if (available & (1 << PerfCounter_Cycles))
+			bOk &= counters[1].mValues[PerfCounter_Cycles] > 4 * counters[0].mValues[PerfCounter_Cycles];
+		if (available & (1 << PerfCounter_L1DMisses))
+			bOk &= counters[1].mValues[PerfCounter_L1DMisses] > steps / 2 && counters[0].mValues[PerfCounter_L1DMisses] < steps / 20;
+		if (available & (1 << PerfCounter_LLCMisses))
+			bOk &= counters[1].mValues[PerfCounter_LLCMisses] > 10 * (counters[0].mValues[PerfCounter_LLCMisses] + 1);
+	}
+	else
+	{
+		bOk &= counted[0] == 0 && counted[1] == 0 && !Profiler::HardwareCounters();
+	}
+	if (bCounted)
+		printf("  cache thrash: %s\n", bOk ? "ok" : "WRONG");
+	else
+		printf("  cache thrash: %s on timing alone, %s: the misses themselves were not checked\n",
+				bOk ? "ok" : "WRONG", bAvailable ? "the counters never ran" : "no counters");
+	RecordCheck("hardware_counters.cache_thrash", bOk);
+#else
+	printf("\nhardware counters: not available on this platform\n");
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////
+static const char* CsvScopeName(u32 id)
+{
+	return id == 1 ? "Draw, Shadows" : id == 2 ? "Say \"hi\"" : "unused";
+}
+
+//------------------------------------------------------------------------
+// Percentiles against known answers, the CSV export of awkward scope names,
+// then one slow frame among steady ones
+void BenchmarkProfileHistory(const string& spikePath, const string& csvPath)
+{
+	// 1..100 shuffled: the nearest rank is the percentile itself
+	f32 samples[100];
+	for (u32 i = 0; i < 100; ++i)
+		samples[i] = (f32)(1 + (i * 37) % 100);
+	ProfilePercentiles p = ProfileHistory::Percentiles(samples, 100);
+	BOOL bPercentiles = p.mP50 == 50.0f && p.mP95 == 95.0f && p.mP99 == 99.0f && p.mMax == 100.0f;
+
+	f32 single = 7.0f;
+	p = ProfileHistory::Percentiles(&single, 1);
+	bPercentiles &= p.mP50 == 7.0f && p.mP99 == 7.0f && p.mMax == 7.0f;
+
+	// Past FrameCount frames the oldest ones leave: frames 44..299 remain
+	ProfileHistory history;
+	std::vector<f32> noScope;
+	for (u32 frame = 0; frame < ProfileHistory::FrameCount + 44; ++frame)
+		history.AddFrame((f32)frame, noScope);
+	p = history.FramePercentiles();
+	bPercentiles &= history.FramesRecorded() == ProfileHistory::FrameCount && p.mP50 == 171.0f && p.mMax == 299.0f;
+
+	printf("\nprofile history percentiles: %s\n", bPercentiles ? "ok" : "WRONG");
+	RecordCheck("profile_history.percentiles", bPercentiles);
+
+	// Scope names are free text: a comma or a quote must not shift the columns
+	ProfileHistory csvHistory;
+	std::vector<f32> scopeMs(3, 0.0f);
+	scopeMs[1] = 1.5f;
+	scopeMs[2] = 2.5f;
+	csvHistory.AddFrame(4.0f, scopeMs);
+	csvHistory.AddFrame(5.0f, scopeMs);
+
+	char header[256] = "";
+	u32  rows = 0;
+	if (csvHistory.WriteCsv(csvPath.c_str(), &CsvScopeName))
+	{
+		FILE* csv = fopen(csvPath.c_str(), "r");
+		if (csv)
+		{
+			char line[256];
+			if (fgets(header, sizeof(header), csv))
+				while (fgets(line, sizeof(line), csv))
+					++rows;
+			fclose(csv);
+		}
+	}
+	BOOL bCsv = strcmp(header, "frame,frame_ms,\"Draw, Shadows\",\"Say \"\"hi\"\"\"\n") == 0 && rows == 2;
+	printf("profile history csv: header %s, %u row(s) (expected 2)\n", bCsv ? "quoted" : "WRONG", rows);
+	RecordCheck("profile_history.csv", bCsv);
+
+#if RJE_PROFILE_CPU
+	// 20 frames of 1 ms, the 11th of 12 ms, over a 6 ms threshold
+	Profiler::Instance()->CollectFrame();
+	Profiler::Instance()->SetSpikeCapture(6.0f, spikePath.c_str());
+	for (u32 frame = 0; frame < 20; ++frame)
+	{
+		{
+			PROFILE_CPU("Spike Frame");
+			CaptureSpin(frame == 10 ? 12000.0 : 1000.0);
+		}
+		Profiler::Instance()->CollectFrame();
+	}
+	u32 spikes = Profiler::Instance()->SpikeCount();
+	Profiler::Instance()->SetSpikeCapture(0.0f, spikePath.c_str());
+
+	BOOL bDumped = false;
+	FILE* file = fopen(spikePath.c_str(), "r");
+	if (file)
+	{
+		char line[256];
+		while (!bDumped && fgets(line, sizeof(line), file))
+			bDumped = strstr(line, "Spike Frame") != nullptr;
+		fclose(file);
+	}
+	p = Profiler::Instance()->History().FramePercentiles();
+	printf("profile history spike: %u frame(s) over 6 ms (expected 1), tree %s, last frames p50 %.2f / max %.2f ms\n", spikes, bDumped ? "dumped" : "MISSING", p.mP50, p.mMax);
+#endif
+}
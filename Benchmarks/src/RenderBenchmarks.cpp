@@ -0,0 +1,146 @@
+#include "Benchmarks.h"
+#include "RenderQueue.h"
+#include "FramePipeline.h"
+#include "PointLightSet.h"
+
+//////////////////////////////////////////////////////////////////////////
+// Sort cost of the render queue on random keys, against std::sort, and
+// the order it leaves them in
+void BenchmarkRenderQueueSort(u32 packetCount)
+{
+	const u32 iterations = 20;
+
+	std::vector<RenderPacket> source(packetCount);
+	u64 seed = 0x9E3779B97F4A7C15ull;
+	for (u32 i = 0; i < packetCount; ++i)
+	{
+		// xorshift64: the same keys on every run
+		seed ^= seed << 13;
+		seed ^= seed >> 7;
+		seed ^= seed << 17;
+		RenderPacket packet = { seed, i, 0 };
+		source[i] = packet;
+	}
+
+	u64 start, end;
+
+	RenderQueue queue;
+	double radixMs = 0.0;
+	for (u32 it = 0; it < iterations; ++it)
+	{
+		queue.mPackets = source;
+		start = Clock::Ticks();
+		queue.Sort();
+		end = Clock::Ticks();
+		radixMs += Clock::Ms(end - start);
+	}
+
+	double stdMs = 0.0;
+	std::vector<RenderPacket> packets;
+	for (u32 it = 0; it < iterations; ++it)
+	{
+		packets = source;
+		start = Clock::Ticks();
+		std::stable_sort(packets.begin(), packets.end(), [](const RenderPacket& a, const RenderPacket& b) { return a.mKey < b.mKey; });
+		end = Clock::Ticks();
+		stdMs += Clock::Ms(end - start);
+	}
+
+	// Same order as a stable sort, and nothing read from an empty queue
+	u32 orderErrors = 0;
+	for (u32 i = 0; i < packetCount; ++i)
+		orderErrors += queue.mPackets[i].mKey != packets[i].mKey || queue.mPackets[i].mObject != packets[i].mObject ? 1 : 0;
+	RenderQueue::RadixSort(nullptr, nullptr, 0);
+
+	printf("\nrender queue sort, %u packets: radix %.3f ms, std::stable_sort %.3f ms, %u out of order\n",
+			packetCount, radixMs / iterations, stdMs / iterations, orderErrors);
+	gBenchmarkReport.Record("render_queue.sort", radixMs / iterations, "ms");
+	RecordCheck("render_queue.order", orderErrors == 0);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Update and render threads handing snapshots over, at every latency. The
+// update fills a snapshot (2000 objects, MAX_LIGHTS animated lights) then
+// busy-waits to updateMs, the render reads it then busy-waits to renderMs:
+// sequential frames cost the sum, pipelined ones the max, given 2 cores.
+void BenchmarkFramePipeline(double updateMs, double renderMs)
+{
+	const u32 frames = 200;
+	const u32 objectCount = 2000;
+
+	u64 start, end;
+	auto busyWait = [](u64 from, double ms)
+	{
+		u64 now;
+		do { now = Clock::Ticks(); }
+		while (Clock::Ms(now - from) < ms);
+	};
+
+	PointLightSet* lights = rje_new PointLightSet();
+	for (u32 i = 0; i < MAX_LIGHTS; ++i)
+	{
+		lights->mOrbitRadius[i] = sqrt(RJE::Math::Rand(0.0f, 1.0f));
+		lights->mOrbitHeight[i] = sqrt(RJE::Math::Rand(0.0f, 1.0f));
+		lights->mOrbitSpeed[i]  = RJE::Math::Rand(0.1f, 2.0f);
+	}
+	lights->SetCount(MAX_LIGHTS);
+
+	FramePipeline::UpdateFunction update = [&](RenderSnapshot& snapshot, u32 frame)
+	{
+		u64 updateStart = Clock::Ticks();
+
+		lights->Update(1.0f / 120.0f, true, 50.0f, 10.0f);
+		lights->ClearDirty();
+
+		snapshot.mFrame     = frame;
+		snapshot.mDeltaTime = 1.0f / 60.0f;
+		snapshot.mView      = Matrix44::LookAt(Vector3(0.0f, 5.0f, -10.0f + 0.01f*frame), Vector3(0.0f, -0.1f, 1.0f), Vector3::up);
+		snapshot.mProj      = Matrix44::PerspectiveFov(RJE::Math::Deg2Rad_f*60.0f, 16.0f / 9.0f, 0.1f, 1000.0f);
+		snapshot.mWorlds.resize(objectCount);
+		snapshot.mVisible.resize(objectCount);
+		for (u32 i = 0; i < objectCount; ++i)
+		{
+			snapshot.mWorlds[i]  = Matrix44::Translation(Vector3((f32)(i % 50), 0.0f, (f32)(i / 50) + 0.01f*frame));
+			snapshot.mVisible[i] = 1;
+		}
+		snapshot.mPointLights.assign(lights->mLights, lights->mLights + MAX_LIGHTS);
+
+		busyWait(updateStart, updateMs);
+	};
+
+	f32 checksum = 0.0f;
+	FramePipeline::RenderFunction render = [&](const RenderSnapshot& snapshot)
+	{
+		u64 renderStart = Clock::Ticks();
+
+		for (u32 i = 0; i < snapshot.mWorlds.size(); ++i)
+			checksum += snapshot.mVisible[i] ? snapshot.mWorlds[i].m43 : 0.0f;
+		checksum += snapshot.mPointLights[snapshot.mFrame % MAX_LIGHTS].Position.x;
+
+		busyWait(renderStart, renderMs);
+	};
+
+	printf("\nframe pipeline, update %.1f ms + render %.1f ms, %u frames:\n", updateMs, renderMs, frames);
+
+	FramePipeline* pipeline = rje_new FramePipeline();
+	double sequentialMs = 0.0;
+	for (u32 latency = 0; latency <= FramePipeline::MaxLatency; ++latency)
+	{
+		pipeline->SetLatency(latency);
+		start = Clock::Ticks();
+		pipeline->Run(frames, update, render);
+		end = Clock::Ticks();
+
+		double frameMs = Clock::Ms(end - start) / frames;
+		if (latency == 0)
+			sequentialMs = frameMs;
+		printf("  latency %u: %.3f ms/frame, x%.2f\n", latency, frameMs, sequentialMs / frameMs);
+
+		char name[64];
+		sprintf_s(name, "frame_pipeline.latency_%u", latency);
+		gBenchmarkReport.Record(name, frameMs, "ms");
+	}
+
+	RJE_SAFE_DELETE(pipeline);
+	RJE_SAFE_DELETE(lights);
+}
@@ -0,0 +1,261 @@
+#include "Benchmarks.h"
+#include "FileSystem.h"
+#include "FramePipeline.h"
+
+//////////////////////////////////////////////////////////////////////////
+// What System::UpdateScene() and System::DrawScene() do, without the console
+static void UpdateScene(Scene& scene, NullRenderingAPI* nullAPI, float dt)
+{
+	PROFILE_CPU("Update Scene");
+#if RJE_DOUBLE_PRECISION
+	Transform::sRenderOrigin = nullAPI->mCamera->mTrf.Position;
+#endif
+	scene.Update();
+	nullAPI->mCamera->Update();
+	nullAPI->UpdateScene(dt);
+	nullAPI->UpdateFrame(1.0f);
+}
+
+//------------------------------------------------------------------------
+static void DrawScene(NullRenderingAPI* nullAPI)
+{
+	PROFILE_CPU("Draw Scene");
+	nullAPI->DrawScene();
+}
+//------------------------------------------------------------------------
+static void DrawScene(NullRenderingAPI* nullAPI, const RenderSnapshot& snapshot)
+{
+	PROFILE_CPU("Draw Scene");
+	nullAPI->DrawScene(snapshot);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Every scene of data/scenes is loaded in turn and run for frameCount
+// frames, then the CPU time per frame and the commands the null backend
+// recorded are printed, once in scene order and once through the render
+// queue, the update and the render in turn. Then through the render queue
+// again with the update a frame (latency 1) and two frames ahead on its
+// own thread. With a traceFile, the first frame of each scene is dumped
+// to it.
+void BenchmarkScenes(u32 frameCount, FILE* traceFile)
+{
+	const int   width  = RJE_GLOBALS::gScreenWidth;
+	const int   height = RJE_GLOBALS::gScreenHeight;
+	const float dt     = 1.0f / 60.0f;
+
+	// What System owns, but the window
+	Scene* sceneOwner = rje_new Scene();
+	Scene& scene      = *sceneOwner;
+	NullRenderingAPI* nullAPI = rje_new NullRenderingAPI(scene);
+	nullAPI->mCamera       = rje_new Camera();
+	nullAPI->mShadowCamera = rje_new Camera();
+	nullAPI->Initialize(width, height);
+
+	// System::OnResize()
+	nullAPI->ResizeWindow(width, height);
+	nullAPI->mCamera->mSettings.AspectRatio = (float)width / (float)height;
+	nullAPI->mCamera->UpdateProjMatrix((float)width, (float)height);
+
+	NullDevice* device = nullAPI->mNullDevice;
+
+	// The frame loop: the update writes a snapshot, the render draws it. The
+	// render is the side using frame memory (the render space light copies
+	// of double precision builds)
+	FramePipeline* pipeline = rje_new FramePipeline();
+	u64 shadowReused = 0, shadowStaticReused = 0;
+	FramePipeline::UpdateFunction update = [&](RenderSnapshot& snapshot, u32 frame)
+	{
+		UpdateScene(scene, nullAPI, dt);
+		nullAPI->WriteSnapshot(snapshot);
+		snapshot.mFrame     = frame;
+		snapshot.mDeltaTime = dt;
+	};
+	FramePipeline::RenderFunction render = [&](const RenderSnapshot& snapshot)
+	{
+		FrameArena::Instance()->BeginFrame();
+		DrawScene(nullAPI, snapshot);
+		shadowReused       += nullAPI->mShadowCache.mReused;
+		shadowStaticReused += nullAPI->mShadowCache.mStaticReused;
+	};
+
+	// Sorted, so that runs are comparable
+	std::vector<string> scenes;
+	FileSystem::FindFiles(RJE_GLOBALS::gDataPath + "scenes\\", ".xml", scenes);
+
+	u64 start, end;
+	printf("%u scene(s), %u frames each\n", (u32)scenes.size(), frameCount);
+
+	for (const string& scenePath : scenes)
+	{
+		string sceneName = FileSystem::FileStem(scenePath);
+		device->ResetTotals();
+		start = Clock::Ticks();
+		scene.Unload();
+		scene.LoadFromFile(scenePath.c_str());
+		scene.Init();
+		nullAPI->LoadSkybox(scene.mSkyboxName);
+		end = Clock::Ticks();
+		double loadMs = Clock::Ms(end - start);
+
+		string resultName = "scene." + sceneName;
+		printf("\n%s: load %.1f ms\n", sceneName.c_str(), loadMs);
+		gBenchmarkReport.Record((resultName + ".load").c_str(), loadMs, "ms");
+		NullDevice::PrintStats(stdout, device->mLoadStats, 1);
+
+		// Same frames drawn in scene order, then through the sorted render queue
+		double sequentialMs = 0.0;
+		for (u32 mode = 0; mode < 2; ++mode)
+		{
+			nullAPI->mbUseRenderQueue = (mode == 1);
+			const char* modeName = nullAPI->mbUseRenderQueue ? "render queue" : "scene order";
+
+			// One warm-up frame, outside of the timing: it is the traced one
+			device->mbTrace = (traceFile != nullptr);
+			UpdateScene(scene, nullAPI, dt);
+			DrawScene(nullAPI);
+			device->mbTrace = false;
+			if (traceFile)
+			{
+				fprintf(traceFile, "==== %s (%s)\n", sceneName.c_str(), modeName);
+				device->DumpTrace(traceFile);
+			}
+			device->ResetTotals();
+
+			shadowReused       = 0;
+			shadowStaticReused = 0;
+			pipeline->SetLatency(0);
+			start = Clock::Ticks();
+			pipeline->Run(frameCount, update, render);
+			end = Clock::Ticks();
+			double frameMs = Clock::Ms(end - start) / (frameCount ? frameCount : 1);
+			sequentialMs = frameMs;
+
+			printf("  %s: %.3f ms/frame, %u/%u subsets rendered\n", modeName, frameMs, nullAPI->mRenderedSubsets, nullAPI->mTotalSubsets);
+			gBenchmarkReport.Record((resultName + (mode == 1 ? ".render_queue" : ".scene_order")).c_str(), frameMs, "ms");
+			NullDevice::PrintStats(stdout, device->mTotalStats, device->mFrameCount);
+			if (scene.mbDeferredRendering && scene.mbDisplayShadows && nullAPI->mDirLightCount > 0)
+			{
+				double frames = frameCount ? frameCount : 1;
+				printf("  shadow partitions per frame: %.2f reused, %.2f static layer only, of %u\n", shadowReused / frames, shadowStaticReused / frames, PARTITIONS);
+			}
+		}
+
+		// Through the render queue again, the update running ahead on its own thread
+		for (u32 latency = 1; latency <= FramePipeline::MaxLatency; ++latency)
+		{
+			pipeline->SetLatency(latency);
+			start = Clock::Ticks();
+			pipeline->Run(frameCount, update, render);
+			end = Clock::Ticks();
+			double frameMs = Clock::Ms(end - start) / (frameCount ? frameCount : 1);
+
+			printf("  pipelined, latency %u: %.3f ms/frame, x%.2f\n", latency, frameMs, sequentialMs / frameMs);
+			char name[32];
+			sprintf_s(name, ".pipeline_latency_%u", latency);
+			gBenchmarkReport.Record((resultName + name).c_str(), frameMs, "ms");
+		}
+
+		// Shadow casters drawn per partition, the trackball camera orbiting the origin
+		if (scene.mbDeferredRendering && scene.mbDisplayShadows && nullAPI->mDirLightCount > 0)
+		{
+			Camera  cameraBackup = *nullAPI->mCamera;
+			Camera* camera       = nullAPI->mCamera;
+			camera->mMode           = Camera_TrackBall;
+			camera->mLookAt         = WorldPosition(0.0f, 0.0f, 0.0f);
+			camera->mCameraAnimated = false;
+			camera->mCameraRadius   = RJE::Math::Clamp(0.5f*scene.mSceneRadius, 0.5f, 100.0f);
+
+			u64 casters[PARTITIONS] = {0};
+			u64 candidates = 0;
+			for (u32 frame = 0; frame < frameCount; ++frame)
+			{
+				camera->mCameraTheta = RJE::Math::Pi_Two_f * frame / frameCount;
+				UpdateScene(scene, nullAPI, dt);
+				DrawScene(nullAPI);
+				for (u32 p = 0; p < PARTITIONS; ++p)
+					casters[p] += nullAPI->mShadowCasterCuller.mCasters[p];
+				candidates += nullAPI->mShadowCasterCuller.mCandidates;
+			}
+			*camera = cameraBackup;
+
+			double frames = frameCount ? frameCount : 1;
+			printf("  shadow casters per partition (orbit):");
+			for (u32 p = 0; p < PARTITIONS; ++p)
+				printf(" %.1f", casters[p] / frames);
+			printf(" of %.1f subsets\n", candidates / frames);
+		}
+	}
+
+	RJE_SAFE_DELETE(pipeline);
+	scene.Unload();
+	RJE_SAFE_DELETE(nullAPI->mCamera);
+	RJE_SAFE_DELETE(nullAPI->mShadowCamera);
+	nullAPI->Shutdown();
+	RJE_SAFE_DELETE(nullAPI);
+	RJE_SAFE_DELETE(sceneOwner);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Precision 100 km away from the world origin, and the cost of bringing
+// every object to render space as Scene::Update() does once per frame.
+// With RJE_DOUBLE_PRECISION a 1 mm offset to the render origin must come
+// out at 1 mm, in float world the step there is ~7.8 mm and it is lost.
+void BenchmarkRenderOrigin()
+{
+	const u32    count    = 100000;
+	const double distance = 100000.0;
+	const double offset   = 0.001;
+
+	WorldPosition originBackup = Transform::sRenderOrigin;
+	Transform::sRenderOrigin = WorldPosition(Vector3d(distance, 0.0, distance));
+
+	Transform far;
+	far.Position = WorldPosition(Vector3d(distance + offset, 0.0, distance - offset));
+	Vector3  local = Transform::ToRenderSpace(far.Position);
+	Matrix44 world = far.WorldMatrix();
+#if RJE_DOUBLE_PRECISION
+	double error = fabs(local.x - offset) + fabs(local.z + offset);
+	error += fabs(world.m41 - offset) + fabs(world.m43 + offset);
+	printf("\nrender origin at %.0f km: 1 mm offset off by %.3g mm\n", distance / 1000.0, 1000.0 * error);
+	RecordCheck("scene.render_origin_precision", error < 1e-6);
+#else
+	double error = fabs((local.x - distance) - offset) + fabs((local.z - distance) + offset);
+	printf("\nrender origin at %.0f km: float world, 1 mm offset off by %.3g mm (RJE_DOUBLE_PRECISION off)\n", distance / 1000.0, 1000.0 * error);
+	RecordCheck("scene.render_origin_precision", local == Vector3(far.Position) && world.m41 == local.x);
+#endif
+
+	// Objects scattered over 1 km around the origin
+	std::vector<Transform> transforms(count);
+	u32 seed = 4321;
+	for (Transform& transform : transforms)
+	{
+		f64 random[3];
+		for (u32 r = 0; r < 3; ++r)
+		{
+			seed = seed * 1664525u + 1013904223u;
+			random[r] = (seed >> 8) / 16777216.0 - 0.5;
+		}
+		transform.Position = WorldPosition(Vector3d(distance + 1000.0 * random[0], 100.0 * random[1], distance + 1000.0 * random[2]));
+		transform.Rotation = Quaternion(0.0f, (f32)(360.0 * random[1]), 0.0f);
+	}
+
+	f32 sum = 0.0f;
+	u64 start = Clock::Ticks();
+	for (const Transform& transform : transforms)
+		sum += Transform::ToRenderSpace(transform.Position).x;
+	u64 end = Clock::Ticks();
+	double convertNs = 1e9 * Clock::Seconds(end - start) / count;
+
+	start = Clock::Ticks();
+	for (Transform& transform : transforms)
+		transform.WorldMat = transform.WorldMatrix();
+	end = Clock::Ticks();
+	double worldNs = 1e9 * Clock::Seconds(end - start) / count;
+	sum += transforms[count / 2].WorldMat.m41;
+
+	printf("  %u objects: to render space %.2f ns, world matrix %.2f ns per object%s\n", count, convertNs, worldNs, sum == sum ? "" : ", WRONG SUM");
+	gBenchmarkReport.Record("scene.to_render_space", convertNs, "ns");
+	gBenchmarkReport.Record("scene.world_matrix",    worldNs,   "ns");
+
+	Transform::sRenderOrigin = originBackup;
+}
@@ -0,0 +1,421 @@
+#include "Benchmarks.h"
+#include "ShadowCasterCulling.h"
+#include "ShadowCache.h"
+
+//////////////////////////////////////////////////////////////////////////
+// The CPU side of the shadow maps on made up partitions and casters, where
+// the right answer is known by construction.
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+	u32 gSeed = 1234;
+	f32 Random(f32 low, f32 high)
+	{
+		gSeed = gSeed * 1664525u + 1013904223u;
+		return low + (high - low) * ((gSeed >> 8) / 16777216.0f);
+	}
+	//------------------------------------------------------------------------
+	Vector3 RandomVector(f32 low, f32 high)
+	{ return Vector3(Random(low, high), Random(low, high), Random(low, high)); }
+
+	//------------------------------------------------------------------------
+	// Light texture coordinate t is kept by the partition when t*scale + bias is in [0,1]
+	BOOL PartitionKeeps(const ShadowPartition& partition, const Vector3& t, f32 epsilon)
+	{
+		Vector3 p(	t.x*partition.mScale.x + partition.mBias.x,
+					t.y*partition.mScale.y + partition.mBias.y,
+					t.z*partition.mScale.z + partition.mBias.z);
+		return	p.x >= -epsilon && p.x <= 1.0f + epsilon &&
+				p.y >= -epsilon && p.y <= 1.0f + epsilon &&
+				p.z >= -epsilon && p.z <= 1.0f + epsilon;
+	}
+	//------------------------------------------------------------------------
+	Vector3 TexCoordToClip(const Vector3& t)	{ return Vector3(2.0f*t.x - 1.0f, 1.0f - 2.0f*t.y, t.z); }
+	Vector3 ClipToTexCoord(const Vector3& c)	{ return Vector3(0.5f*c.x + 0.5f, -0.5f*c.y + 0.5f, c.z); }
+	//------------------------------------------------------------------------
+	Vector3 TransformPoint(const Vector3& p, const Matrix44& m)
+	{
+		return Vector3(	p.x*m.m11 + p.y*m.m21 + p.z*m.m31 + m.m41,
+						p.x*m.m12 + p.y*m.m22 + p.z*m.m32 + m.m42,
+						p.x*m.m13 + p.y*m.m23 + p.z*m.m33 + m.m43);
+	}
+
+	//------------------------------------------------------------------------
+	// PARTITIONS random partitions, texture coordinate bounds inside [0,1]
+	void RandomPartitions(ShadowPartition* partitions, Vector3* minTexCoord, Vector3* maxTexCoord, f32 border, f32 maxScale, f32 dilation)
+	{
+		for (u32 p = 0; p < PARTITIONS; ++p)
+		{
+			Vector3 a = RandomVector(0.05f, 0.95f), b = RandomVector(0.05f, 0.95f);
+			minTexCoord[p] = Vector3::Min(a, b);
+			maxTexCoord[p] = Vector3::Max(a, b) + Vector3(1e-3f);
+			partitions[p]  = ShadowCasterCuller::PartitionFromBounds(minTexCoord[p], maxTexCoord[p], Vector3(border), Vector3(maxScale), dilation);
+		}
+	}
+
+	//------------------------------------------------------------------------
+	// One frame of the shadow map cache the way the renderer drives it, two
+	// subsets per caster; the partition keys don't change
+	void CacheFrame(ShadowMapCache& cache, const std::vector<Matrix44>& worlds, const std::vector<u32>& masks, ShadowCacheAction* actions)
+	{
+		u32 casterCount = (u32)worlds.size();
+		cache.BeginFrame(casterCount);
+		for (u32 c = 0; c < casterCount; ++c)
+			cache.UpdateCaster(c, worlds[c]);
+		for (u32 c = 0; c < casterCount; ++c)
+		{
+			cache.AddCaster(c, 0, masks[c]);
+			cache.AddCaster(c, 1, masks[c]);
+		}
+		for (u32 p = 0; p < PARTITIONS; ++p)
+			actions[p] = cache.Update(p, 1000 + p);
+	}
+
+	//------------------------------------------------------------------------
+	// Partitions in the mask must not be reused, the others must
+	u32 ReuseErrors(const ShadowCacheAction* actions, u32 mask)
+	{
+		u32 errors = 0;
+		for (u32 p = 0; p < PARTITIONS; ++p)
+			errors += (actions[p] == ShadowCache_Reuse) == ((mask & (1u << p)) != 0) ? 1 : 0;
+		return errors;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Partition volumes, the box left open toward the light, and which casters
+// get rejected
+void BenchmarkShadowCasterCuller()
+{
+	const u32 trials = 2000;
+	ShadowPartition	partitions[PARTITIONS];
+	Vector3			minTexCoord[PARTITIONS], maxTexCoord[PARTITIONS];
+
+	printf("\nshadow caster culling, %u random partition sets:\n", trials);
+
+	//---------- Partition volumes: exactly the bounds without border, dilation
+	// or scale clamp, containing them with; the margin grows them
+	u32 volumeErrors = 0;
+	for (u32 trial = 0; trial < trials; ++trial)
+	{
+		ShadowCasterCuller culler;
+		RandomPartitions(partitions, minTexCoord, maxTexCoord, 0.0f, 1e6f, 0.0f);
+		culler.SetPartitions(partitions, 0.0f);
+		volumeErrors += culler.mActiveMask != (1u << PARTITIONS) - 1 ? 1 : 0;
+		for (u32 p = 0; p < PARTITIONS; ++p)
+		{
+			Vector3 clipA = TexCoordToClip(minTexCoord[p]), clipB = TexCoordToClip(maxTexCoord[p]);
+			Vector3 expectedMin = Vector3::Min(clipA, clipB), expectedMax = Vector3::Max(clipA, clipB);
+			volumeErrors += (culler.mMin[p] - expectedMin).Magnitude() > 1e-4f || (culler.mMax[p] - expectedMax).Magnitude() > 1e-4f ? 1 : 0;
+		}
+
+		Vector3 exactMin[PARTITIONS], exactMax[PARTITIONS];
+		for (u32 p = 0; p < PARTITIONS; ++p)
+		{
+			exactMin[p] = culler.mMin[p];
+			exactMax[p] = culler.mMax[p];
+		}
+		const f32 margin = 0.1f;
+		culler.SetPartitions(partitions, margin);
+		for (u32 p = 0; p < PARTITIONS; ++p)
+		{
+			Vector3 grow = (exactMax[p] - exactMin[p]) * margin;
+			volumeErrors += (culler.mMin[p] - (exactMin[p] - grow)).Magnitude() > 1e-4f || (culler.mMax[p] - (exactMax[p] + grow)).Magnitude() > 1e-4f ? 1 : 0;
+		}
+
+		// Border, dilation and a scale clamp only ever keep more
+		RandomPartitions(partitions, minTexCoord, maxTexCoord, Random(0.0f, 0.05f), Random(1.0f, 20.0f), Random(0.0f, 0.05f));
+		culler.SetPartitions(partitions, 0.0f);
+		for (u32 p = 0; p < PARTITIONS; ++p)
+		{
+			Vector3 clipA = TexCoordToClip(minTexCoord[p]), clipB = TexCoordToClip(maxTexCoord[p]);
+			Vector3 boundsMin = Vector3::Min(clipA, clipB), boundsMax = Vector3::Max(clipA, clipB);
+			volumeErrors += (	culler.mMin[p].x > boundsMin.x + 1e-5f || culler.mMin[p].y > boundsMin.y + 1e-5f || culler.mMin[p].z > boundsMin.z + 1e-5f ||
+								culler.mMax[p].x < boundsMax.x - 1e-5f || culler.mMax[p].y < boundsMax.y - 1e-5f || culler.mMax[p].z < boundsMax.z - 1e-5f) ? 1 : 0;
+		}
+
+		// An empty partition is left out
+		u32 empty = trial % PARTITIONS;
+		partitions[empty] = ShadowCasterCuller::PartitionFromBounds(Vector3(0.6f), Vector3(0.4f), Vector3::zero, Vector3(1e6f), 0.0f);
+		culler.SetPartitions(partitions, 0.0f);
+		volumeErrors += (culler.mActiveMask & (1u << empty)) || culler.PartitionMask(AABB(Vector3::zero, Vector3(10.0f))) & (1u << empty) ? 1 : 0;
+	}
+
+	// The camera estimate must hold every point of its depth slice
+	u32 estimateMisses = 0, estimatePoints = 0;
+	for (u32 trial = 0; trial < trials / 10; ++trial)
+	{
+		Vector3 cameraPosition = RandomVector(-50.0f, 50.0f);
+		Vector3 cameraDir      = RandomVector(-1.0f, 1.0f) + Vector3(0.0f, 0.0f, 0.01f);
+		Matrix44 cameraView    = Matrix44::LookAt(cameraPosition, cameraDir.Normalize(), Vector3::up);
+		Vector3 lightDir       = RandomVector(-1.0f, 1.0f) + Vector3(0.0f, -0.5f, 0.0f);
+		lightDir.Normalize();
+		Matrix44 lightViewProj = Matrix44::LookAt(-lightDir * 300.0f, lightDir, Vector3(0.01f, 0.0f, 1.0f)) * Matrix44::Orthographic(600.0f, 600.0f, 0.0f, 600.0f);
+
+		f32 fovY = RJE::Math::Deg2Rad_f * Random(30.0f, 90.0f), aspectRatio = Random(1.0f, 2.0f);
+		f32 minZ = Random(0.1f, 5.0f), maxZ = minZ + Random(1.0f, 200.0f);
+		ShadowCasterCuller::EstimatePartitions(cameraView, fovY, aspectRatio, minZ, maxZ, lightViewProj, Vector3::zero, Vector3(1e6f), 0.0f, partitions);
+
+		Matrix44 cameraWorld = cameraView;
+		cameraWorld.Inverse();
+		f32 tanY = tanf(0.5f * fovY), tanX = tanY * aspectRatio;
+		for (u32 p = 0; p < PARTITIONS; ++p)
+		{
+			f32 sliceNear = minZ * powf(maxZ / minZ, (f32)p / PARTITIONS);
+			f32 sliceFar  = minZ * powf(maxZ / minZ, (f32)(p + 1) / PARTITIONS);
+			for (u32 i = 0; i < 64; ++i)
+			{
+				f32 z = Random(sliceNear, sliceFar);
+				Vector3 view(z * tanX * Random(-1.0f, 1.0f), z * tanY * Random(-1.0f, 1.0f), z);
+				Vector3 texCoord = ClipToTexCoord(TransformPoint(TransformPoint(view, cameraWorld), lightViewProj));
+				estimateMisses += PartitionKeeps(partitions[p], texCoord, 1e-4f) ? 0 : 1;
+				++estimatePoints;
+			}
+		}
+	}
+
+	printf("  partition volumes: %u wrong, camera estimates miss %u of %u slice points\n", volumeErrors, estimateMisses, estimatePoints);
+	RecordCheck("shadow.partition_volumes", volumeErrors == 0 && estimateMisses == 0);
+
+	//---------- Open toward the light: a caster before the near side still
+	// shadows, one past the far side or off to a side doesn't
+	u32 openErrors = 0;
+	for (u32 trial = 0; trial < trials; ++trial)
+	{
+		ShadowCasterCuller culler;
+		RandomPartitions(partitions, minTexCoord, maxTexCoord, 0.0f, 1e6f, 0.0f);
+		culler.SetPartitions(partitions, 0.0f);
+
+		u32 p = trial % PARTITIONS;
+		Vector3 size   = culler.mMax[p] - culler.mMin[p];
+		Vector3 inside = culler.mMin[p] + Vector3::Scale(size, RandomVector(0.1f, 0.9f));
+		Vector3 small  = size * 0.05f;
+
+		AABB towardLight(Vector3(inside.x, inside.y, culler.mMin[p].z - Random(1.0f, 10.0f)), small);
+		AABB pastFar    (Vector3(inside.x, inside.y, culler.mMax[p].z + size.z + small.z), small);
+		AABB beside     (Vector3(culler.mMax[p].x + size.x + small.x, inside.y, inside.z), small);
+		AABB above      (Vector3(inside.x, culler.mMin[p].y - size.y - small.y, inside.z), small);
+		AABB straddling (Vector3(culler.mMax[p].x, culler.mMin[p].y, culler.mMax[p].z), small);
+
+		openErrors += (culler.PartitionMask(towardLight) & (1u << p)) ? 0 : 1;
+		openErrors += (culler.PartitionMask(straddling)  & (1u << p)) ? 0 : 1;
+		openErrors += (culler.PartitionMask(pastFar)     & (1u << p)) ? 1 : 0;
+		openErrors += (culler.PartitionMask(beside)      & (1u << p)) ? 1 : 0;
+		openErrors += (culler.PartitionMask(above)       & (1u << p)) ? 1 : 0;
+
+		// Until SetPartitions(), everything goes everywhere
+		culler.Invalidate();
+		openErrors += culler.PartitionMask(pastFar) != (1u << PARTITIONS) - 1 ? 1 : 0;
+	}
+	printf("  open toward the light: %u wrong\n", openErrors);
+	RecordCheck("shadow.open_toward_light", openErrors == 0);
+
+	//---------- Rejection: world boxes through CasterBounds, the mask against
+	// points sampled in them. A point shadows a partition when it lands in its
+	// x/y range anywhere up to its far side.
+	u32 boundsErrors = 0, wrongRejections = 0, rejections = 0, tested = 0;
+	u64 cullTicks = 0;
+	for (u32 trial = 0; trial < trials; ++trial)
+	{
+		ShadowCasterCuller culler;
+		RandomPartitions(partitions, minTexCoord, maxTexCoord, 0.0f, 1e6f, 0.0f);
+		culler.SetPartitions(partitions, 0.0f);
+
+		Vector3 lightDir = RandomVector(-1.0f, 1.0f) + Vector3(0.0f, -0.5f, 0.0f);
+		lightDir.Normalize();
+		Matrix44 lightViewProj = Matrix44::LookAt(-lightDir * 100.0f, lightDir, Vector3(0.01f, 0.0f, 1.0f)) * Matrix44::Orthographic(200.0f, 200.0f, 0.0f, 200.0f);
+
+		for (u32 i = 0; i < 32; ++i)
+		{
+			Vector3 center = RandomVector(-1.0f, 1.0f), extents = RandomVector(0.1f, 10.0f);
+			Matrix44 world = Matrix44::Scaling(RandomVector(0.5f, 2.0f)) * Matrix44::RotationY(Random(0.0f, 360.0f)) * Matrix44::RotationX(Random(0.0f, 360.0f)) * Matrix44::Translation(RandomVector(-100.0f, 100.0f));
+			Matrix44 worldLightViewProj = world * lightViewProj;
+
+			u64 start = Clock::Ticks();
+			AABB casterLightClip = ShadowCasterCuller::CasterBounds(center, extents, worldLightViewProj);
+			u32 mask = culler.AddCaster(casterLightClip);
+			cullTicks += Clock::Ticks() - start;
+			++tested;
+
+			for (u32 p = 0; p < PARTITIONS; ++p)
+				rejections += (mask >> p) & 1 ? 0 : 1;
+
+			for (u32 s = 0; s < 64; ++s)
+			{
+				Vector3 local = center + Vector3::Scale(extents, s < 8 ? Vector3((s & 1) ? 1.0f : -1.0f, (s & 2) ? 1.0f : -1.0f, (s & 4) ? 1.0f : -1.0f) : RandomVector(-1.0f, 1.0f));
+				Vector3 clip  = TransformPoint(local, worldLightViewProj);
+				// The corners land on the bounds, give them the rounding
+				boundsErrors += AABB(casterLightClip.center, casterLightClip.extents * 1.0001f + Vector3(1e-5f)).Contains(clip) ? 0 : 1;
+
+				for (u32 p = 0; p < PARTITIONS; ++p)
+				{
+					const f32 e = 1e-4f;
+					BOOL bShadows = clip.x >= culler.mMin[p].x + e && clip.x <= culler.mMax[p].x - e && clip.y >= culler.mMin[p].y + e && clip.y <= culler.mMax[p].y - e && clip.z <= culler.mMax[p].z - e;
+					wrongRejections += bShadows && !((mask >> p) & 1) ? 1 : 0;
+				}
+			}
+		}
+	}
+	printf("  rejection: %u casters, %.1f%% of the partition tests rejected, %u wrong, %u points outside their bounds\n",
+			tested, 100.0 * rejections / (tested * PARTITIONS), wrongRejections, boundsErrors);
+	RecordCheck("shadow.caster_rejection", wrongRejections == 0 && boundsErrors == 0 && rejections > 0);
+
+	double cullNs = 1e9 * Clock::Seconds(cullTicks) / tested;
+	printf("  %.1f ns per caster (bounds + mask)\n", cullNs);
+	gBenchmarkReport.Record("shadow.cull_caster", cullNs, "ns");
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Which partitions the shadow map cache keeps: all of them on an unchanged
+// frame, all but the moved caster's, and the static layer's promotion and
+// demotion
+void BenchmarkShadowMapCache()
+{
+	const u32 casterCount = 48;
+	const u32 allMask     = (1u << PARTITIONS) - 1;
+	std::vector<Matrix44> worlds(casterCount);
+	std::vector<u32>      masks(casterCount);
+	for (u32 c = 0; c < casterCount; ++c)
+	{
+		worlds[c] = Matrix44::Translation(RandomVector(-100.0f, 100.0f));
+		masks[c]  = 1 + (u32)Random(0.0f, (f32)allMask - 0.01f);
+	}
+	ShadowCacheAction actions[PARTITIONS];
+
+	printf("\nshadow map cache, %u casters:\n", casterCount);
+
+	//---------- Unchanged frame: everything reused; without layers so no caster turns static
+	ShadowMapCache cache;
+	cache.mbUseLayers = false;
+	CacheFrame(cache, worlds, masks, actions);
+	u32 unchangedErrors = ReuseErrors(actions, allMask);
+	CacheFrame(cache, worlds, masks, actions);
+	unchangedErrors += ReuseErrors(actions, 0) + (cache.mReused == PARTITIONS ? 0 : 1);
+	printf("  unchanged frame: %u of %u partitions reused, %u wrong\n", cache.mReused, PARTITIONS, unchangedErrors);
+	RecordCheck("shadow.cache_unchanged", unchangedErrors == 0);
+
+	//---------- Moving one caster: only its partitions render, and the frame after reuses everything again
+	u32 moveErrors = 0;
+	for (u32 c = 0; c < casterCount; ++c)
+	{
+		worlds[c].m42 += 0.001f;
+		CacheFrame(cache, worlds, masks, actions);
+		moveErrors += ReuseErrors(actions, masks[c]);
+		CacheFrame(cache, worlds, masks, actions);
+		moveErrors += ReuseErrors(actions, 0);
+	}
+	printf("  one caster moved: %u casters, %u wrong partitions\n", casterCount, moveErrors);
+	RecordCheck("shadow.cache_moved_caster", moveErrors == 0);
+
+	//---------- Static layer: every caster turns static after StaticFrames frames without moving,
+	// the moved one is demoted and renders its partitions in full, then only its own on top of
+	// the static layer, and is promoted again StaticFrames frames later
+	ShadowMapCache layered;
+	u32 layerErrors = 0;
+	for (u32 frame = 0; frame <= ShadowMapCache::StaticFrames + 1; ++frame)
+	{
+		CacheFrame(layered, worlds, masks, actions);
+		BOOL bStatic = frame >= ShadowMapCache::StaticFrames;
+		for (u32 c = 0; c < casterCount; ++c)
+			layerErrors += layered.IsStatic(c) != bStatic ? 1 : 0;
+
+		// Every caster changing layer on the same frame changes every partition
+		if (frame > 0)
+			layerErrors += ReuseErrors(actions, frame == ShadowMapCache::StaticFrames ? allMask : 0);
+	}
+
+	const u32 moved = 7;
+	worlds[moved].m41 += 1.0f;
+	CacheFrame(layered, worlds, masks, actions);
+	layerErrors += layered.IsStatic(moved) ? 1 : 0;
+	layerErrors += ReuseErrors(actions, masks[moved]);
+	for (u32 p = 0; p < PARTITIONS; ++p)
+		layerErrors += (masks[moved] & (1u << p)) && actions[p] != ShadowCache_RenderAll ? 1 : 0;
+	for (u32 c = 0; c < casterCount; ++c)
+		layerErrors += c != moved && !layered.IsStatic(c) ? 1 : 0;
+
+	worlds[moved].m41 += 1.0f;
+	CacheFrame(layered, worlds, masks, actions);
+	layerErrors += ReuseErrors(actions, masks[moved]);
+	for (u32 p = 0; p < PARTITIONS; ++p)
+		layerErrors += (masks[moved] & (1u << p)) && actions[p] != ShadowCache_DynamicOnly ? 1 : 0;
+	u32 dynamicOnly = layered.mStaticReused;
+
+	for (u32 frame = 1; frame <= ShadowMapCache::StaticFrames; ++frame)
+	{
+		CacheFrame(layered, worlds, masks, actions);
+		layerErrors += layered.IsStatic(moved) != (frame == ShadowMapCache::StaticFrames) ? 1 : 0;
+		layerErrors += ReuseErrors(actions, frame == ShadowMapCache::StaticFrames ? masks[moved] : 0);
+	}
+	printf("  static layer after %u frames: demoted caster drew %u partitions on the static layer, %u wrong\n",
+			(u32)ShadowMapCache::StaticFrames, dynamicOnly, layerErrors);
+	RecordCheck("shadow.cache_static_layer", layerErrors == 0 && dynamicOnly > 0);
+
+	//---------- Layers turned on over a reused frame: no static layer was stored yet, so a caster
+	// moving next must render its partitions in full, not on top of the static layer
+	ShadowMapCache toggled;
+	toggled.mbUseLayers = false;
+	CacheFrame(toggled, worlds, masks, actions);
+	toggled.mbUseLayers = true;
+	CacheFrame(toggled, worlds, masks, actions);
+	u32 toggleErrors = ReuseErrors(actions, 0);
+	worlds[moved].m41 += 1.0f;
+	CacheFrame(toggled, worlds, masks, actions);
+	toggleErrors += ReuseErrors(actions, masks[moved]);
+	for (u32 p = 0; p < PARTITIONS; ++p)
+		toggleErrors += (masks[moved] & (1u << p)) && actions[p] != ShadowCache_RenderAll ? 1 : 0;
+	printf("  layers turned on: %u wrong partitions\n", toggleErrors);
+	RecordCheck("shadow.cache_layers_toggled", toggleErrors == 0);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// The partition readback queue against a GPU that lands each copy one to
+// three frames after it was queued, and a Map() that still fails one time
+// in four once it has: reads must keep coming, each newer than the last.
+void BenchmarkPartitionReadback()
+{
+	const u32 frames = 100000;
+	const u32 slots  = PartitionReadbackQueue::Slots;
+
+	PartitionReadbackQueue queue;
+	u32 copiedFrame[slots], landingFrame[slots];
+	u32 lastRead = 0, reads = 0, gap = 0, maxGap = 0, orderErrors = 0;
+	for (u32 frame = 1; frame <= frames; ++frame)
+	{
+		BOOL bRead = false;
+		u32  pending[slots];
+		u32  pendingCount = queue.Pending(pending);
+		for (u32 i = 0; i < pendingCount; ++i)
+		{
+			u32 slot = pending[i];
+			if (frame < landingFrame[slot] || Random(0.0f, 1.0f) < 0.25f)
+				continue;
+			orderErrors += copiedFrame[slot] <= lastRead ? 1 : 0;
+			lastRead = copiedFrame[slot];
+			queue.Landed(slot);
+			bRead = true;
+		}
+
+		u32 slot = queue.FreeSlot();
+		if (slot < slots)
+		{
+			copiedFrame[slot]  = frame;
+			landingFrame[slot] = frame + 1 + (u32)Random(0.0f, 2.99f);
+			queue.Queue(slot);
+		}
+
+		if (bRead)
+		{
+			++reads;
+			gap = 0;
+		}
+		else
+		{
+			maxGap = RJE::Math::Max(maxGap, ++gap);
+		}
+	}
+	printf("\nshadow partition readback, %u frames: %u read, at most %u frame(s) without one, %u out of order\n",
+			frames, reads, maxGap, orderErrors);
+	RecordCheck("shadow.partition_readback", orderErrors == 0 && maxGap < 16 && reads > frames / 2);
+}
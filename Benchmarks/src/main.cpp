@@ -0,0 +1,228 @@
+//////////////////////////////////////////////////////////////////////////
+// RamJamEngine headless benchmark: the engine on the null backend, no
+// window, on every platform the Tools and the Math build on.
+//
+//   Benchmarks [-frames N] [-data <dir>] [-trace] [-exhaustive] [-update-baseline] [-checks-only]
+//			  [-tolerance P]
+//
+// -frames N			frames run per scene, 1000 by default
+// -data <dir>			the data folder, ending with a separator; the datapath
+//						of the game's Resources.ini by default
+// -trace				the first frame of each scene goes to benchmark_trace.txt
+// -exhaustive			the checks that can go through every value do, every
+//						float to half included (~20 s)
+// -update-baseline		the results become the baseline, the tolerances
+//						written in the old one kept; refused while a check fails
+// -checks-only			the regressions are listed, only the failed checks
+//						make the exit code: the baseline's times are those of
+//						the machine that made it, ctest runs anywhere
+// -tolerance P			no result regresses under P% over its baseline,
+//						whatever its own tolerance: the gate of a machine
+//						like the baseline's, not the same one
+//
+// The results go to benchmark_results.json in the data folder, and are
+// compared with those of benchmark_baseline.json when there is one. The
+// exit code is 1 on a failed check or a regression, for the scripts.
+// Some results only one platform has: kPlatformResults lists them, a
+// baseline made on another platform shows them new or missing.
+//////////////////////////////////////////////////////////////////////////
+
+#include "Benchmarks.h"
+
+BenchmarkReport gBenchmarkReport;
+
+static const char* kCheckUnit = "failed";
+
+//////////////////////////////////////////////////////////////////////////
+void RecordCheck(const char* name, BOOL bOk)
+{
+	gBenchmarkReport.Record(name, bOk ? 0.0 : 1.0, kCheckUnit);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Lists the checks that failed, baseline or not, and returns their count
+static u32 ReportFailedChecks()
+{
+	u32 failed = 0;
+	for (const BenchmarkResult& result : gBenchmarkReport.Results())
+	{
+		if (result.mUnit != kCheckUnit || result.mValue == 0.0)
+			continue;
+		if (failed++ == 0)
+			printf("\nfailed checks:\n");
+		printf("  %s\n", result.mName.c_str());
+	}
+	return failed;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// The results a platform doesn't record, by name prefix. The committed
+// baseline is made on Linux: it has no texture decode, Windows has no
+// hardware counters. No platform records an assimp import: its sources are
+// not in the data folder.
+struct PlatformResults
+{
+	const char*	mPrefix;
+	const char*	mPlatforms;
+};
+
+static const PlatformResults kPlatformResults[] =
+{
+	{ "textures.",			"Windows only, DirectXTex" },
+	{ "hardware_counters.",	"Linux only, perf_event_open" },
+};
+
+//------------------------------------------------------------------------
+static void ReportPlatformResults(const BenchmarkReport& baseline)
+{
+	printf("\nplatform results, new or missing is no regression:\n");
+	for (const PlatformResults& platform : kPlatformResults)
+	{
+		size_t prefixLength = strlen(platform.mPrefix);
+		u32 here = 0, based = 0;
+		for (const BenchmarkResult& result : gBenchmarkReport.Results())
+			here += result.mName.compare(0, prefixLength, platform.mPrefix) == 0 ? 1 : 0;
+		for (const BenchmarkResult& result : baseline.Results())
+			based += result.mName.compare(0, prefixLength, platform.mPrefix) == 0 ? 1 : 0;
+		printf("  %-20s %u here, %u in the baseline: %s\n", platform.mPrefix, here, based, platform.mPlatforms);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Against the baseline, returns the regressions. A run with failed checks
+// doesn't become the baseline: it would make them the expected result.
+static u32 CompareWithBaseline(const string& dataPath, BOOL bUpdateBaseline, u32 failedChecks, f64 minTolerance)
+{
+	string resultsPath  = dataPath + "benchmark_results.json";
+	string baselinePath = dataPath + "benchmark_baseline.json";
+	if (RJE_GLOBALS::gBenchmarkTolerance > 0)
+		gBenchmarkReport.SetDefaultTolerance(RJE_GLOBALS::gBenchmarkTolerance);
+	gBenchmarkReport.SetMinimumTolerance(minTolerance);
+	gBenchmarkReport.Save(resultsPath.c_str());
+
+	BenchmarkReport baseline;
+	BOOL bBaseline = baseline.Load(baselinePath.c_str());
+	u32 regressions = 0;
+	if (bBaseline)
+	{
+		printf("\nAgainst %s, %g%% tolerance unless given, %g%% at least:\n", baselinePath.c_str(), gBenchmarkReport.DefaultTolerance(), gBenchmarkReport.MinimumTolerance());
+		regressions = gBenchmarkReport.Compare(baseline, stdout);
+		printf("%u regression(s)\n", regressions);
+		ReportPlatformResults(baseline);
+	}
+
+	if (bUpdateBaseline && failedChecks > 0)
+	{
+		printf("\nbaseline not updated: %u check(s) failed\n", failedChecks);
+	}
+	else if (bUpdateBaseline)
+	{
+		for (const BenchmarkResult& result : baseline.Results())
+		{
+			const BenchmarkResult* current = gBenchmarkReport.Find(result.mName.c_str());
+			if (current && result.mTolerance > 0.0)
+				gBenchmarkReport.Record(current->mName.c_str(), current->mValue, current->mUnit.c_str(), result.mTolerance);
+		}
+		gBenchmarkReport.Save(baselinePath.c_str());
+		printf("\nbaseline updated: %s\n", baselinePath.c_str());
+	}
+	else if (!bBaseline)
+	{
+		printf("\nno baseline, run with -update-baseline to make %s\n", baselinePath.c_str());
+	}
+	return regressions;
+}
+
+//////////////////////////////////////////////////////////////////////////
+int main(int argc, char* argv[])
+{
+	u32  frameCount      = 1000;
+	BOOL bTrace          = false;
+	BOOL bExhaustive     = false;
+	BOOL bUpdateBaseline = false;
+	BOOL bChecksOnly     = false;
+	f64  minTolerance    = 0.0;
+	const char* dataPath = nullptr;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (strcmp(argv[i], "-trace") == 0)									bTrace = true;
+		else if (strcmp(argv[i], "-exhaustive") == 0)						bExhaustive = true;
+		else if (strcmp(argv[i], "-update-baseline") == 0)					bUpdateBaseline = true;
+		else if (strcmp(argv[i], "-checks-only") == 0)						bChecksOnly = true;
+		else if (strcmp(argv[i], "-frames") == 0 && i + 1 < argc)			frameCount = (u32)atoi(argv[++i]);
+		else if (strcmp(argv[i], "-data") == 0 && i + 1 < argc)				dataPath = argv[++i];
+		else if (strcmp(argv[i], "-tolerance") == 0 && i + 1 < argc)		minTolerance = atof(argv[++i]);
+		else
+		{
+			printf("usage: %s [-frames N] [-data <dir>] [-trace] [-exhaustive] [-update-baseline] [-checks-only] [-tolerance P]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	// The game's files, run from Benchmarks/, unless given another data folder
+	RJE_GLOBALS::gResourcesPath = "../RamJamEngine/data/Resources.ini";
+	if (dataPath)
+	{
+		RJE_GLOBALS::gDataPath = dataPath;
+		RJE_GLOBALS::LoadConfigFile((RJE_GLOBALS::gDataPath + "Config.ini").c_str());
+	}
+	else
+	{
+		RJE_GLOBALS::gDataPath = CIniFile::GetValue("datapath", "repositories", RJE_GLOBALS::gResourcesPath);
+		RJE_GLOBALS::LoadConfigFile("../RamJamEngine/data/Config.ini");
+	}
+	const string& data = RJE_GLOBALS::gDataPath;
+
+	Profiler::Instance()->SetThreadName("Main");
+
+	printf("RamJamEngine null render benchmark - %s\n", data.c_str());
+
+	FILE* traceFile = bTrace ? fopen((data + "benchmark_trace.txt").c_str(), "w") : nullptr;
+	BenchmarkScenes(frameCount, traceFile);
+	if (traceFile)
+		fclose(traceFile);
+	BenchmarkRenderOrigin();
+
+	BenchmarkRenderQueueSort(100000);
+	BenchmarkLightClusters();
+	BenchmarkTiledLightCulling();
+	BenchmarkPointLights();
+	BenchmarkFramePipeline(4.0, 6.0);
+	BenchmarkShadowCasterCuller();
+	BenchmarkShadowMapCache();
+	BenchmarkPartitionReadback();
+	BenchmarkProfiler();
+	BenchmarkProfilerCapture(data + "benchmark_capture.json");
+	BenchmarkHardwareCounters();
+	BenchmarkProfileHistory(data + "benchmark_spikes.txt", data + "benchmark_history.csv");
+	BenchmarkMemoryTracker();
+	BenchmarkFrameArena();
+	BenchmarkObjectPool();
+	BenchmarkMemoryBudget();
+	BenchmarkClock();
+	BenchmarkFrameScheduler();
+	BenchmarkMath();
+	BenchmarkFastMath();
+	BenchmarkBounds();
+	BenchmarkPacking(bExhaustive);
+	BenchmarkModels(data);
+	BenchmarkTextures(data);
+	BenchmarkMaterialFiles(data);
+
+	u32 failedChecks = ReportFailedChecks();
+	u32 regressions  = CompareWithBaseline(data, bUpdateBaseline, failedChecks, minTolerance);
+	gBenchmarkReport.Clear();
+
+	MaterialFactory::DeleteInstance();
+	Timer::   DeleteInstance();
+	Input::   DeleteInstance();
+	Profiler::DeleteInstance();
+	FrameArena::DeleteInstance();
+	MemoryBudget::DeleteInstance();
+
+#ifdef RJE_MEMORY_PROFILE
+	MemoryReport();
+#endif
+
+	return failedChecks > 0 || (regressions > 0 && !bChecksOnly) ? 1 : 0;
+}
@@ -42,6 +42,11 @@ cbuffer cbPerFrame : register (b0)
 	//-----------
 	float gShadowStrength;
 	uint  gCurrentPartition;
+	//-----------
+	bool   gUseLightClusters;
+	uint3  gClusterGrid;			// tile size in pixels, tiles x, tiles y
+	float2 gClusterSliceParams;		// slice = log(viewZ)*x + y
+	uint   gClusterSlices;
 };
 
 #endif
\ No newline at end of file
@@ -29,6 +29,15 @@ VertexOut VS(VertexIn vin)
 	return vout;
 }
  
+//////////////////////////////////////////////////////////////////////////
+// Same indexing as LightClusterGrid::ClusterIndex() and Slice()
+uint LightClusterIndex(float2 screenPos, float viewZ)
+{
+	uint2 tile  = uint2(screenPos) / gClusterGrid.x;
+	uint  slice = uint(clamp(log(viewZ) * gClusterSliceParams.x + gClusterSliceParams.y, 0.0f, float(gClusterSlices - 1)));
+	return (slice * gClusterGrid.z + tile.y) * gClusterGrid.y + tile.x;
+}
+
 //////////////////////////////////////////////////////////////////////////
 float4 PS(VertexOut pin) : SV_Target
 {	
@@ -91,15 +100,31 @@ float4 PS(VertexOut pin) : SV_Target
 		spec    += S * float4(light.Color.xyz, 1.0);
 	}
 
-	// Point Lighting
-	gPointLights.GetDimensions(totalLights, dummy);
-	for (uint pointLightIdx = 0; pointLightIdx < totalLights; ++pointLightIdx)
+	// Point Lighting: only the lights of this pixel's cluster, or all of them
+	[branch] if (gUseLightClusters)
 	{
-		PointLight light = gPointLights[pointLightIdx];
-		ComputePointLight(mat, light, pin.PosW, pin.NormalW, toEye, D, S);
+		float  viewZ   = mul(float4(pin.PosW, 1.0f), gView).z;
+		uint2  cluster = gLightClusters[LightClusterIndex(pin.PosH.xy, viewZ)];
+		for (uint clusterLightIdx = 0; clusterLightIdx < cluster.y; ++clusterLightIdx)
+		{
+			PointLight light = gPointLights[gLightClusterIndices[cluster.x + clusterLightIdx]];
+			ComputePointLight(mat, light, pin.PosW, pin.NormalW, toEye, D, S);
 
-		diffuse += D;
-		spec    += S * float4(light.Color, 1.0);
+			diffuse += D;
+			spec    += S * float4(light.Color, 1.0);
+		}
+	}
+	else
+	{
+		gPointLights.GetDimensions(totalLights, dummy);
+		for (uint pointLightIdx = 0; pointLightIdx < totalLights; ++pointLightIdx)
+		{
+			PointLight light = gPointLights[pointLightIdx];
+			ComputePointLight(mat, light, pin.PosW, pin.NormalW, toEye, D, S);
+
+			diffuse += D;
+			spec    += S * float4(light.Color, 1.0);
+		}
 	}
 
 	// Spot Lighting
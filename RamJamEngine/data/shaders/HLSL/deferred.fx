@@ -113,9 +113,10 @@ void ComputeShaderTileCS(uint3 groupId          : SV_GroupID,
 	// The overhead of group synchronization/LDS or global memory lookup is probably as much as this
 	// little bit of math anyways, but worth testing.
 
-	// Work out scale/bias from [0, 1]
-	float2 tileScale = float2(gFramebufferSizeX, gFramebufferSizeY) * rcp(float(2 * COMPUTE_SHADER_TILE_GROUP_DIM));
-	float2 tileBias  = tileScale - float2(groupId.xy);
+	// Work out scale/bias so that this tile maps to [-1, 1]
+	// (a bias of tileScale - groupId with half the scale mapped the tile to [0, 1]: every frustum was 2x2 tiles)
+	float2 tileScale = float2(gFramebufferSizeX, gFramebufferSizeY) * rcp(float(COMPUTE_SHADER_TILE_GROUP_DIM));
+	float2 tileBias  = tileScale - 2.0f * float2(groupId.xy) - 1.0f;
 
 	// Now work out composite projection matrix
 	// Relevant matrix columns for this tile frusta
@@ -36,6 +36,11 @@ StructuredBuffer<DirectionalLight>	gDirLights;
 StructuredBuffer<PointLight>		gPointLights;
 StructuredBuffer<SpotLight>			gSpotLights;
 
+// Point lights binned on the CPU (LightClusterGrid): offset/count per cluster
+// into gLightClusterIndices, which holds indices into gPointLights
+StructuredBuffer<uint2>				gLightClusters;
+StructuredBuffer<uint>				gLightClusterIndices;
+
 struct Material
 {
 	float4 Albedo;
@@ -21,7 +21,7 @@ struct CameraSettings
 struct Camera
 {
 	Vector3 mUp;
-	Vector3 mLookAt;
+	WorldPosition mLookAt;
 	float mPitch;
 	float mYaw;
 	Transform mTrf;
@@ -35,6 +35,7 @@ struct Camera
 
 	CameraMode		mMode;
 	CameraSettings	mSettings;
+	Vector2			mViewSize;		// of the last UpdateProjMatrix()
 
 	// TrackBall Camera Settings
 	Vector2	mLastMousePos;
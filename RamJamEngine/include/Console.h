@@ -68,6 +68,7 @@ struct Console
 	void	ExitConsole();
 	//----------
 	void	AddCharacter(const char c);
+	static void	OnTextInput(const char c);		// Input's handler: the typed characters, while active
 	void	AddLine();
 	void	RemoveCharacter();
 	void	RemoveFirstLine();
@@ -121,3 +122,6 @@ void LoadScene           (char* command = nullptr);
 void LoadSkybox         (char* command = nullptr);
 // ------- Time -------
 void Time        (char* command = nullptr);
+// ----- Profiling -----
+void Capture     (char* command = nullptr);
+void History     (char* command = nullptr);
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "Types.h"
+#include "MathHelper.h"
+#include "Light.h"
+#include "Camera.h"
+#include "PointLightSet.h"
+#include <vector>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+
+//////////////////////////////////////////////////////////////////////////
+// Everything a frame needs to be drawn, as the update left it. Written by
+// the update thread only, then read-only until the render thread releases it.
+// The vectors keep their capacity from frame to frame: once warmed up,
+// filling a snapshot doesn't allocate.
+struct RenderSnapshot
+{
+	u32		mFrame;
+	f32		mDeltaTime;
+	//------
+	WorldPosition	mRenderOrigin;		// Transform::sRenderOrigin the matrices are relative to
+	Matrix44		mView;
+	Matrix44		mProj;				// the current one, perspective or ortho
+	Vector3			mEyePosition;		// render space
+	Vector3			mCameraRight;
+	CameraSettings	mCameraSettings;
+	BOOL			mbOrtho;
+	Vector4			mSunDirection;
+	//------
+	std::vector<Matrix44>	mWorlds;			// one per game object, render space
+	std::vector<Matrix44>	mWorldsNoScale;		// one per game object, for the bounds scaled by mScales
+	std::vector<Vector3>	mScales;
+	std::vector<u8>			mVisible;			// one per game object, when the update culls
+	//------
+	std::vector<DirectionalLight>	mDirLights;
+	std::vector<PointLight>			mPointLights;		// world space
+	std::vector<LightRange>			mPointLightRanges;	// the point lights changed since the last snapshot
+	std::vector<SpotLight>			mSpotLights;		// world space
+
+	RenderSnapshot() : mFrame(0), mDeltaTime(0.0f), mbOrtho(false) {}
+};
+
+//////////////////////////////////////////////////////////////////////////
+// Hands RenderSnapshots from an update thread to a render thread through a
+// ring of Latency() + 1 slots: the update can run up to Latency() frames
+// ahead of the render, then it waits for a slot to be released. Latency 1
+// is double buffering (update frame N+1 while frame N is drawn), 2 triple
+// buffering. Latency 0 runs the update and the render in turn on the calling
+// thread, through the same slot.
+//
+// Per frame, on the update side: BeginUpdate(), fill the snapshot,
+// EndUpdate(). On the render side: BeginRender(), draw, EndRender().
+// Run() does both for a given number of frames.
+class FramePipeline
+{
+public:
+	enum { MaxLatency = 2 };
+
+	typedef std::function<void (RenderSnapshot& snapshot, u32 frame)>	UpdateFunction;
+	typedef std::function<void (const RenderSnapshot& snapshot)>			RenderFunction;
+
+	FramePipeline();
+
+	// Only between runs: the ring is reset
+	void	SetLatency(u32 frames);
+	u32		Latency() const					{ return mLatency; }
+
+	// update() on a worker thread, render() on the calling thread (both on the
+	// calling thread with latency 0), frames in order. Returns once the last
+	// frame is drawn.
+	void	Run(u32 frameCount, const UpdateFunction& update, const RenderFunction& render);
+
+	//------
+	RenderSnapshot*			BeginUpdate();	// waits for a free slot, nullptr once stopped
+	void					EndUpdate();	// publishes the snapshot
+	const RenderSnapshot*	BeginRender();	// waits for the oldest published snapshot, nullptr once stopped and drained
+	void					EndRender();	// gives its slot back
+	// Wakes both sides: pending snapshots are still drawn, no new one is started
+	void					Stop();
+
+private:
+	// Not implemented
+	FramePipeline(const FramePipeline&);
+	FramePipeline& operator=(const FramePipeline&);
+
+	RenderSnapshot	mSlots[MaxLatency + 1];
+	u32				mLatency;
+	u32				mWriteSlot;		// next slot BeginUpdate() hands out
+	u32				mReadSlot;		// next slot BeginRender() hands out
+	u32				mPublished;		// snapshots waiting to be drawn or being drawn
+	BOOL			mbRendering;
+	BOOL			mbStopped;
+	//------
+	std::mutex				mMutex;
+	std::condition_variable	mCondition;
+};
@@ -1,17 +1,26 @@
 #pragma once
 
+#include "RjeConfig.h"
+#include "ObjectPool.h"
+
 #if (RJE_GRAPHIC_API == DIRECTX_11)
 	#include "DX11Drawable.h"
+#elif (RJE_GRAPHIC_API == NULL_RENDER)
+	#include "NullDrawable.h"
 #endif
 
 //////////////////////////////////////////////////////////////////////////
 struct GameObject
 {
+	RJE_POOLED(GameObject)
+
 	std::string		mName;
 	Transform		mTransform;
 
 #if (RJE_GRAPHIC_API == DIRECTX_11)
 	DX11Drawable	mDrawable;
+#elif (RJE_GRAPHIC_API == NULL_RENDER)
+	NullDrawable	mDrawable;
 #else
 	OglDrawable		mDrawable;
 #endif
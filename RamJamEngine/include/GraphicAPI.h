@@ -18,7 +18,12 @@ struct GraphicAPI
 	BOOL VSyncEnabled;
 
 	virtual void Initialize(int windowWidth, int windowHeight) = 0;
+	// One simulation step of dt: the animations
 	virtual void UpdateScene( float dt ) = 0;
+	// Once per frame, after its steps (none on some fixed step frames): the
+	// inputs, the UI settings, and the animations as drawn, alpha of the way
+	// from the last step's start to its end (FrameScheduler::Alpha())
+	virtual void UpdateFrame( float alpha ) = 0;
 	virtual void DrawScene() = 0;
 	virtual void Shutdown() = 0;
 	virtual void ResizeWindow(int newSizeWidth, int newSizeHeight) = 0;
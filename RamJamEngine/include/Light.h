@@ -7,8 +7,7 @@
 //   cannot straddle a 4D vector boundary.
 
 //////////////////////////////////////////////////////////////////////////
-RJE_ALIGNOF(16)
-struct DirectionalLight
+struct RJE_ALIGNOF(16) DirectionalLight
 {
 	DirectionalLight()
 	{ 
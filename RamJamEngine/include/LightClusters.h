@@ -0,0 +1,118 @@
+#pragma once
+
+#include "Types.h"
+#include "MathHelper.h"
+#include "Light.h"
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+
+//////////////////////////////////////////////////////////////////////////
+// Offset and count of one cluster's run in the index list. Same layout as
+// the uint2 of gLightClusters (lightHelper.fx).
+struct LightCluster
+{
+	u32 mOffset;
+	u32 mCount;
+};
+
+//////////////////////////////////////////////////////////////////////////
+// Point lights binned into the camera frustum, cut in screen tiles of
+// mTileSize pixels and in mSlices exponential depth slices ("froxels").
+//
+// The grid is built once per frame on the CPU and uploaded as two buffers:
+// mClusters (offset/count per cluster) and mLightIndices (every cluster's
+// lights, one run after the other). A pixel finds its cluster from its
+// screen position and view depth, see ClusterIndex() and LightClusterSlice
+// (lightHelper.fx).
+//
+// Each cluster is tested as the view space box around its frustum segment:
+// looser than the segment itself near the frustum edges, never tighter.
+// Build() bins the slices in parallel, 4 lights per SSE test; BuildReference()
+// tests every light against every cluster and must give the same lists.
+//
+// The worker threads are started by the first Build() that needs them and
+// sleep between builds, until the grid is destroyed.
+struct LightClusterGrid
+{
+	enum
+	{
+		DefaultTileSize = 64,
+		DefaultSlices   = 16,
+	};
+
+	u32		mWidth, mHeight;
+	u32		mTileSize;
+	u32		mTilesX, mTilesY, mSlices;
+	f32		mNearZ, mFarZ;
+	f32		mProjScaleX, mProjScaleY;
+	f32		mSliceScale;		// slice = log(viewZ)*mSliceScale + mSliceBias
+	f32		mSliceBias;
+	u32		mWorkerCount;		// threads used by Build(), the caller included, can change between builds
+	//------
+	std::vector<LightCluster>	mClusters;
+	std::vector<u32>			mLightIndices;
+
+	//------
+	LightClusterGrid();
+	~LightClusterGrid();
+
+	// proj: the camera perspective, only its x and y scales are read
+	void	Setup(u32 width, u32 height, const Matrix44& proj, f32 nearZ, f32 farZ, u32 tileSize = DefaultTileSize, u32 slices = DefaultSlices);
+	// Same screen and projection as the last Setup()
+	BOOL	IsSetup(u32 width, u32 height, const Matrix44& proj, f32 nearZ, f32 farZ) const;
+
+	void	Build(const PointLight* lights, u32 lightCount, const Matrix44& view);
+	void	BuildReference(const PointLight* lights, u32 lightCount, const Matrix44& view);
+
+	u32		ClusterCount() const						{ return mTilesX*mTilesY*mSlices; }
+	u32		ClusterIndex(u32 x, u32 y, u32 slice) const	{ return (slice*mTilesY + y)*mTilesX + x; }
+	u32		Slice(f32 viewZ) const;
+	BOOL	SameLists(const LightClusterGrid& other) const;
+	// Over the clusters holding at least one light
+	void	Occupancy(OUT f32& averageLights, OUT u32& maxLights, OUT u32& usedClusters) const;
+
+private:
+	// Not implemented
+	LightClusterGrid(const LightClusterGrid&);
+	LightClusterGrid& operator=(const LightClusterGrid&);
+
+	// One slice's lists, built by one worker and merged by Build()
+	struct SliceBins
+	{
+		std::vector<LightCluster>	mClusters;		// offsets into mIndices
+		std::vector<u32>			mIndices;
+		std::vector<u32>			mCandidates;	// scratch: lights touching the slice, then the current row
+		std::vector<u32>			mRowCandidates;
+		std::vector<f32>			mSoA;			// scratch: x, y, z, radius of the candidates, 4 by 4
+	};
+
+	std::vector<Vector3>	mClusterMin;	// view space box of each cluster
+	std::vector<Vector3>	mClusterMax;
+	std::vector<Vector3>	mRowMin;		// box of each (slice, tile row)
+	std::vector<Vector3>	mRowMax;
+	std::vector<Vector3>	mSliceMin;		// box of each slice
+	std::vector<Vector3>	mSliceMax;
+	//------
+	std::vector<Vector3>	mLightPositions;	// view space, this frame
+	std::vector<f32>		mLightRadii;
+	std::vector<SliceBins>	mBins;
+	//------
+	std::vector<std::thread>	mWorkers;
+	std::mutex					mWorkerMutex;
+	std::condition_variable		mWorkerWake;	// a build started, or the grid is going away
+	std::condition_variable		mWorkerDone;	// the last busy worker finished
+	u32							mBuildId;		// bumped by each Build() that wakes the workers
+	u32							mBuildWorkers;	// workers taking part in the current build
+	u32							mBusyWorkers;
+	BOOL						mbStopWorkers;
+	std::atomic<u32>			mNextSlice;
+
+	void	WorkerLoop(u32 worker, u32 lastBuild);
+	void	BinSlices();
+	void	TransformLights(const PointLight* lights, u32 lightCount, const Matrix44& view);
+	void	BinSlice(u32 slice, SliceBins& bins);
+	void	MergeSlices();
+};
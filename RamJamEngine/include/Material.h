@@ -3,6 +3,7 @@
 #include "MathHelper.h"
 #include "Texture.h"
 #include "Transform.h"
+#include "ObjectPool.h"
 
 enum MaterialPropertyType
 {
@@ -41,6 +42,11 @@ enum MaterialPropertyType
 //////////////////////////////////////////////////////////////////////////
 struct MaterialProperty
 {
+	RJE_POOLED(MaterialProperty)
+
+	// Up to a matrix, the data lives in the property itself
+	enum { InlineDataSize = sizeof(Matrix44) };
+
 	std::string				mName;
 	MaterialPropertyType	mType;
 
@@ -48,8 +54,9 @@ struct MaterialProperty
 // 	u32	mTextureUsageSemantic;
 // 	u32	mTextureIndex;
 
-	void*			mData;
+	void*			mData;			// mInlineData, or malloc'd past InlineDataSize
 	Texture			mShaderResource;
+	RJE_ALIGNOF(16) u8	mInlineData[InlineDataSize];
 
 	MaterialProperty()
 	{
@@ -60,23 +67,34 @@ struct MaterialProperty
 	~MaterialProperty()
 	{
 		// TODO: handle the case with several objects per material
-		if (mData != nullptr)
+		if (mData != nullptr && mData != mInlineData)
 		{
 			free(mData);
-			mData = nullptr;
 		}
+		mData = nullptr;
 	}
+
+private:
+	// Not implemented: mData can point into the property
+	MaterialProperty(const MaterialProperty&);
+	MaterialProperty& operator=(const MaterialProperty&);
 };
 
 //////////////////////////////////////////////////////////////////////////
 struct Material
 {
+	RJE_POOLED(Material)
+
 	Material();
 	~Material();
 
 	u32 mPropertiesCount;
 	std::vector<MaterialProperty*> mProperties;
 	BOOL mIsOpaque;
+	// Render queue ids: materials loaded from the same file share the same
+	// bindings and thus the same id. 0 is the default material.
+	u32 mSortId;
+	u32 mShaderSortId;
 
 	//----------------------------------
 
@@ -91,16 +109,16 @@ struct Material
 	void AddPropertyFloat  (std::string propertyName, float   propertyData);
 	void AddPropertyVector (std::string propertyName, Vector4 propertyData);
 	void AddPropertyMatrix (std::string propertyName);
-	void AddPropertyTexture(std::string propertyName, ShaderResource* shaderResource = nullptr, Vector2& tiling = Vector2(1,1), Vector2& offset = Vector2(0,0), float rotation = 0.0f);
+	void AddPropertyTexture(std::string propertyName, ShaderResource* shaderResource = nullptr, const Vector2& tiling = Vector2(1,1), const Vector2& offset = Vector2(0,0), float rotation = 0.0f);
 };
 
 //////////////////////////////////////////////////////////////////////////
 FORCEINLINE void Material::AddProperty( std::string propertyName, MaterialPropertyType propertyType, u64 propertyDataLength, void* propertyData )
 {
-	MaterialProperty* property = new MaterialProperty();
+	MaterialProperty* property = rje_new MaterialProperty();
 	property->mName            = propertyName;
 	property->mType            = propertyType;
-	property->mData            = malloc (propertyDataLength);
+	property->mData            = propertyDataLength <= MaterialProperty::InlineDataSize ? property->mInlineData : malloc((size_t)propertyDataLength);
 	if (propertyData)
 		memcpy(property->mData, propertyData, propertyDataLength);
 	++mPropertiesCount;
@@ -122,9 +140,9 @@ FORCEINLINE void Material::AddPropertyVector( std::string propertyName, Vector4
 FORCEINLINE void Material::AddPropertyMatrix( std::string propertyName )
 { AddProperty(propertyName, MaterialPropertyType::Type_Matrix, sizeof(Matrix44), nullptr); }
 //------------------------------------------------------------
-FORCEINLINE void Material::AddPropertyTexture( std::string propertyName, ShaderResource* shaderResource /*= nullptr*/, Vector2& tiling /*= Vector2(1,1)*/, Vector2& offset /*= Vector2(0,0)*/, float rotation /*= 0.0f*/ )
+FORCEINLINE void Material::AddPropertyTexture( std::string propertyName, ShaderResource* shaderResource /*= nullptr*/, const Vector2& tiling /*= Vector2(1,1)*/, const Vector2& offset /*= Vector2(0,0)*/, float rotation /*= 0.0f*/ )
 {
-	MaterialProperty* property                        = new MaterialProperty();
+	MaterialProperty* property                        = rje_new MaterialProperty();
 	property->mName                                   = propertyName;
 	property->mType                                   = MaterialPropertyType::Type_Texture;
 	property->mShaderResource.mTexture                = shaderResource;
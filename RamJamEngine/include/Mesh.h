@@ -27,6 +27,7 @@ struct Mesh
 		Vector3 mExtents;
 		float   mRadius;
 		BOOL    mbIsInFrustum;
+		u32     mShadowPartitions;	// one bit per SDSM partition the subset casts into
 	};
 
 	Subset*	mSubsets;
@@ -36,4 +37,9 @@ struct Mesh
 
 	MeshData::RJE_InputLayout			mInputLayout;
 	MeshData::RJE_PrimitiveTopology		mPrimitiveTopology;
+
+	std::string	mName;		// model file, empty for a generated primitive
+
+	// Owner of the buffers in the MemoryBudget
+	const char*	BudgetOwner() const		{ return mName.empty() ? "Primitives" : mName.c_str(); }
 };
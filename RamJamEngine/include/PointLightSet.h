@@ -0,0 +1,89 @@
+#pragma once
+
+#include "Types.h"
+#include "MathHelper.h"
+#include "Light.h"
+#include "ShaderDefines.h"
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////////
+// First light and light count of a run to upload
+struct LightRange
+{
+	u32 mFirst;
+	u32 mCount;
+};
+
+//////////////////////////////////////////////////////////////////////////
+// The scene's point lights, each orbiting the y axis.
+//
+// The orbits are kept SoA so Update() advances, wraps and projects 4 lights
+// per SSE op (sin/cos through FastMath's batch SinCos). mLights is the
+// packed copy the light buffer needs, world space: Update() and Interpolate()
+// only rewrite the lights whose position actually changed and mark their
+// block of DirtyBlockSize lights dirty.
+//
+// Per frame: Update() per simulation step, Interpolate() with the frame's
+// alpha, then upload the DirtyRanges() (none when nothing moved) and
+// ClearDirty().
+struct PointLightSet
+{
+	enum
+	{
+		DirtyBlockSize  = 64,
+		DirtyBlockCount = (MAX_LIGHTS + DirtyBlockSize - 1) / DirtyBlockSize,
+	};
+
+	f32			mOrbitRadius[MAX_LIGHTS];	// times the scene's mPointLightRadius
+	f32			mOrbitHeight[MAX_LIGHTS];	// times the scene's mPointLightHeight
+	f32			mOrbitAngle [MAX_LIGHTS];	// radians, wrapped to [0, 2pi)
+	f32			mOrbitSpeed [MAX_LIGHTS];	// radians per unit of animation time, 0 for a still light
+	//------
+	PointLight	mLights[MAX_LIGHTS];		// Color/Range/Intensity set by the owner, Position by Update()/Interpolate()
+	u32			mCount;
+
+	//------
+	PointLightSet();
+
+	// Every active light has to be uploaded again (new buffer), and placed by the next Update()
+	void	SetCount(u32 count);
+	void	SetLight(u32 light, const Vector3& color, f32 range, f32 intensity);
+	void	MarkDirty(u32 first, u32 count);
+	void	MarkAllDirty()					{ MarkDirty(0, mCount); }
+
+	// bAnimate: moves every light by mOrbitSpeed * animationTime. The layout is
+	// recomputed when the scales change; with neither, nothing is touched.
+	// Leaves the lights where the step ends.
+	void	Update(f32 animationTime, BOOL bAnimate, f32 radiusScale, f32 heightScale);
+	// Places the lights alpha of the way from where the last step started to
+	// where it ended. Only the steps that moved interpolate: a new layout or
+	// a paused animation is shown as it is.
+	void	Interpolate(f32 alpha);
+
+	// Runs of dirty blocks, clamped to mCount
+	void	DirtyRanges(OUT std::vector<LightRange>& ranges) const;
+	u32		DirtyLightCount() const;
+	void	ClearDirty();
+
+private:
+	f32		mRadiusScale;
+	f32		mHeightScale;
+	BOOL	mbLayoutValid;
+	BOOL	mbStepMoved;					// the last step moved the lights: there is something to interpolate
+	f32		mStoredAlpha;					// where mLights are between the two steps
+	u8		mDirtyBlocks[DirtyBlockCount];
+	//------
+	f32		mSin[MAX_LIGHTS];				// scratch for Update()
+	f32		mCos[MAX_LIGHTS];
+	f32		mPositionX[MAX_LIGHTS];			// where the last step ended
+	f32		mPositionY[MAX_LIGHTS];
+	f32		mPositionZ[MAX_LIGHTS];
+	f32		mPreviousX[MAX_LIGHTS];			// where it started
+	f32		mPreviousY[MAX_LIGHTS];
+	f32		mPreviousZ[MAX_LIGHTS];
+
+	void	AdvanceAngles(f32 animationTime);
+	void	ComputePositions(f32 radiusScale, f32 heightScale);
+	void	KeepPositions(OUT f32* x, OUT f32* y, OUT f32* z) const;
+	void	StorePositions(f32 alpha);
+};
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "Types.h"
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////////
+// One draw of one mesh subset. mObject and mSubset are only read back by
+// the backend that submits the queue (game object index, subset index).
+struct RenderPacket
+{
+	u64 mKey;
+	u32 mObject;
+	u32 mSubset;
+};
+
+//////////////////////////////////////////////////////////////////////////
+// 64-bit sort key, from the most significant bits:
+//
+//   63-60  pass          (4)
+//   59     translucent   (1)   opaque geometry first
+//   opaque      : shader (8) | material (16) | mesh (16) | depth (19) front to back
+//   translucent : depth (19) back to front | shader (8) | material (16) | mesh (16)
+//
+// Opaque draws are grouped by binding cost, depth only breaks the ties.
+// Translucent draws must stay ordered by depth, bindings come second.
+struct RenderKey
+{
+	enum
+	{
+		Pass_Scene   = 0,
+		Pass_Shadow  = 1,
+		//------
+		PassBits     = 4,
+		ShaderBits   = 8,
+		MaterialBits = 16,
+		MeshBits     = 16,
+		DepthBits    = 19,
+	};
+
+	// depth01 is the view depth divided by the far plane, clamped to [0,1]
+	static u64 Make(u32 pass, BOOL bTranslucent, u32 shader, u32 material, u32 mesh, float depth01);
+	//------
+	static u32  Pass(u64 key)          { return (u32)(key >> 60); }
+	static BOOL IsTranslucent(u64 key) { return (key >> 59) & 1; }
+};
+
+//////////////////////////////////////////////////////////////////////////
+// Per frame list of draw packets. Producers Push() in any order, Sort()
+// once, then the backend walks mPackets and only rebinds what changed.
+struct RenderQueue
+{
+	std::vector<RenderPacket> mPackets;
+
+	//------
+	void Clear() { mPackets.clear(); }
+	void Push(u64 key, u32 object, u32 subset);
+	void Sort();
+	//------
+	// Stable LSD radix sort on mKey, 8 bits per pass. The passes where every
+	// key shares the same byte (pass, shader, ... in a typical frame) are skipped.
+	static void RadixSort(RenderPacket* packets, RenderPacket* scratch, u32 count);
+
+private:
+	std::vector<RenderPacket> mScratch;
+};
+
+//////////////////////////////////////////////////////////////////////////
+FORCEINLINE u64 RenderKey::Make(u32 pass, BOOL bTranslucent, u32 shader, u32 material, u32 mesh, float depth01)
+{
+	const u32 depthMax = (1u << DepthBits) - 1;
+	depth01 = depth01 < 0.0f ? 0.0f : (depth01 > 1.0f ? 1.0f : depth01);
+	u64 depth = (u64)(depth01 * depthMax);
+
+	u64 key = ((u64)(pass & 0xF) << 60) | ((u64)(bTranslucent ? 1 : 0) << 59);
+	u64 bindings = ((u64)(shader & 0xFF) << 32) | ((u64)(material & 0xFFFF) << 16) | (u64)(mesh & 0xFFFF);
+	if (bTranslucent)
+		key |= ((depthMax - depth) << 40) | bindings;
+	else
+		key |= (bindings << DepthBits) | depth;
+	return key;
+}
+
+//------------------------------------------------------------
+FORCEINLINE void RenderQueue::Push(u64 key, u32 object, u32 subset)
+{
+	RenderPacket packet = { key, object, subset };
+	mPackets.push_back(packet);
+}
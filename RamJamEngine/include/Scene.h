@@ -70,9 +70,9 @@ struct Scene
 	float	mNegativeExponent;
 	//---------
 	// Scene Bounding Volume Info
-	Vector3 mSceneCenter;
-	Vector3 mSceneExtents;
-	float   mSceneRadius;
+	WorldPosition	mSceneCenter;
+	Vector3			mSceneExtents;
+	float			mSceneRadius;
 	//---------
 	// Point Light Editor values
 	float mPointLightRadius;
@@ -83,6 +83,7 @@ struct Scene
 	//---------
 	void Init();
 	void LoadFromFile(const char* pFile);
+	void Unload();
 	//---------
 	void ChangeCurrentEditorGO(u32& idx);
 	void ComputeSceneExtents();
@@ -69,6 +69,7 @@ private:
 	void ExtractParameters(rapidxml::xml_node<>* node, float& f1, float& f2, u32& u1, u32& u2);
 	void ExtractParameters(rapidxml::xml_node<>* node, float& f1, float& f2, float& f3, u32& u1, u32& u2);
 	void ExtractParameters(rapidxml::xml_node<>* node, Vector3& v);
+	void ExtractParameters(rapidxml::xml_node<>* node, Vector3d& v);
 	void ExtractParameters(rapidxml::xml_node<>* node, Vector3& v1, Vector3& v2);
 	void ExtractParameters(rapidxml::xml_node<>* node, Vector3& v1, Vector3& v2, Vector3& v3);
 	void ExtractParameters(rapidxml::xml_node<>* node, Vector3& v1, Vector3& v2, Vector3& v3, float& f1, float& f2, float& f3, float& f4);
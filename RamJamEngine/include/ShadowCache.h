@@ -0,0 +1,103 @@
+#pragma once
+
+#include "Types.h"
+#include "MathHelper.h"
+#include "ShaderDefines.h"
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////////
+// 64-bit FNV-1a. Floats are hashed bitwise: the caches only need to know
+// that nothing changed, not that two states are close.
+struct StateHash
+{
+	u64 mValue;
+
+	StateHash() : mValue(14695981039346656037ULL) {}
+
+	void Add(const void* data, u32 size)
+	{
+		const u8* bytes = static_cast<const u8*>(data);
+		for (u32 i = 0; i < size; ++i)
+		{
+			mValue ^= bytes[i];
+			mValue *= 1099511628211ULL;
+		}
+	}
+	template<class T>
+	void Add(const T& value) { Add(&value, sizeof(T)); }
+};
+
+//////////////////////////////////////////////////////////////////////////
+enum ShadowCacheAction
+{
+	ShadowCache_Reuse,			// last frame's shadow map is still right
+	ShadowCache_DynamicOnly,	// restore the static layer, draw the dynamic casters on top
+	ShadowCache_RenderAll,		// draw every caster (and store the static layer when layers are on)
+};
+
+enum ShadowCasterLayer
+{
+	ShadowLayer_Static  = 1 << 0,
+	ShadowLayer_Dynamic = 1 << 1,
+	ShadowLayer_All     = ShadowLayer_Static | ShadowLayer_Dynamic,
+};
+
+//////////////////////////////////////////////////////////////////////////
+// Decides, per SDSM partition, whether last frame's shadow map can be kept.
+//
+// A partition is keyed by everything its shadow map depends on: the caller's
+// partition key (light, partition bounds, EVSM settings) and the hashes of
+// the casters it holds (object, subset, world matrix). Same keys as last
+// frame: reuse.
+//
+// With layers on, casters that haven't moved for StaticFrames frames form
+// the static layer, kept in its own depth map. When only dynamic casters
+// changed, the static depth is restored and only they are drawn.
+//
+// Per frame: BeginFrame(), UpdateCaster() for every object, AddCaster() for
+// every subset with its partition mask, then Update() for each partition.
+struct ShadowMapCache
+{
+	enum { StaticFrames = 30 };	// frames without moving before a caster joins the static layer
+
+	BOOL	mbEnabled;
+	BOOL	mbUseLayers;
+	//------
+	u32		mReused;			// last frame, partitions whose shadow map was kept
+	u32		mStaticReused;		// last frame, partitions that only drew their dynamic casters
+
+	//------
+	ShadowMapCache();
+
+	// Every partition renders next frame (textures rebuilt, scene loaded...)
+	void				Invalidate();
+
+	void				BeginFrame(u32 casterCount);
+	void				UpdateCaster(u32 caster, const Matrix44& world);
+	BOOL				UsesLayers() const			{ return mbEnabled && mbUseLayers; }
+	BOOL				IsStatic(u32 caster) const	{ return UsesLayers() && mCasters[caster].mUnchangedFrames >= StaticFrames; }
+	u32					Layer(u32 caster) const		{ return IsStatic(caster) ? ShadowLayer_Static : ShadowLayer_Dynamic; }
+	void				AddCaster(u32 caster, u32 subset, u32 partitionMask);
+
+	ShadowCacheAction	Update(u32 partition, u64 partitionKey);
+
+private:
+	struct Entry
+	{
+		u64		mPartitionKey;
+		u64		mStaticKey;
+		u64		mDynamicKey;
+		BOOL	mbValid;			// the shadow map holds these keys
+		BOOL	mbStaticValid;		// the static layer holds mPartitionKey/mStaticKey
+	};
+	struct Caster
+	{
+		u64		mTransformHash;
+		u32		mUnchangedFrames;
+	};
+
+	Entry				mEntries[PARTITIONS];
+	StateHash			mStaticKeys[PARTITIONS];	// this frame, filled by AddCaster()
+	StateHash			mDynamicKeys[PARTITIONS];
+	std::vector<Caster>	mCasters;
+};
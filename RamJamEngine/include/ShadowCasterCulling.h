@@ -0,0 +1,92 @@
+#pragma once
+
+#include "Types.h"
+#include "MathHelper.h"
+#include "Bounds.h"
+#include "ShaderDefines.h"
+
+//////////////////////////////////////////////////////////////////////////
+// CPU side of one SDSM partition (see sdsm.fx): the partition maps a light
+// texture coordinate t to t*scale + bias and renders the part landing in [0,1].
+struct ShadowPartition
+{
+	Vector3 mScale;
+	Vector3 mBias;
+};
+
+//////////////////////////////////////////////////////////////////////////
+// Sorts the shadow casters out between the SDSM partitions.
+//
+// Each partition renders a box of light clip space, the part of the shadow
+// ortho its scale/bias keeps. Depth clipping is disabled in the shadow pass:
+// anything between the light and that box is clamped onto the near plane and
+// still shadows it, so the box is open toward the light and only its x, y and
+// far sides reject a caster.
+//
+// Casters are tested as light clip space boxes (CasterBounds()). The shadow
+// projection is orthographic, so a transformed box only needs re-bounding.
+struct ShadowCasterCuller
+{
+	Vector3	mMin[PARTITIONS];		// light clip space, z min unused
+	Vector3	mMax[PARTITIONS];
+	u32		mActiveMask;			// one bit per non empty partition
+	BOOL	mbValid;				// until SetPartitions(), every caster goes to every partition
+	//------
+	u32		mCasters[PARTITIONS];	// casters accepted per partition since ResetStats()
+	u32		mCandidates;			// casters tested since ResetStats()
+
+	//------
+	ShadowCasterCuller();
+
+	// margin grows each volume by that fraction of its size on x and y, for
+	// partitions that are a frame late (GPU readback)
+	void	SetPartitions(const ShadowPartition* partitions, f32 margin);
+	void	Invalidate() { mbValid = false; }
+	void	ResetStats();
+
+	// Bit p is set when the caster has to be drawn in partition p
+	u32		PartitionMask(const AABB& casterLightClip) const;
+	// PartitionMask(), counted in the stats
+	u32		AddCaster(const AABB& casterLightClip);
+
+	//------
+	static AABB				CasterBounds(const Vector3& center, const Vector3& extents, const Matrix44& worldLightViewProj);
+
+	// CPU mirror of ComputePartitionDataFromBounds (sdsm.fx), bounds in light texture coordinates
+	static ShadowPartition	PartitionFromBounds(const Vector3& minTexCoord, const Vector3& maxTexCoord,
+												const Vector3& lightSpaceBorder, const Vector3& maxScale, f32 dilation);
+
+	// Partitions from the camera frustum alone, for when no depth buffer can be
+	// reduced: log splits between minZ and maxZ (view depth), each slice bounded
+	// in light texture coordinates. Looser than the GPU ones, never tighter.
+	// minZ > maxZ (nothing visible) gives empty partitions.
+	static void				EstimatePartitions(	const Matrix44& cameraView, f32 fovY, f32 aspectRatio, f32 minZ, f32 maxZ,
+												const Matrix44& lightViewProj, const Vector3& lightSpaceBorder, const Vector3& maxScale,
+												f32 dilation, OUT ShadowPartition* outPartitions);
+};
+
+//////////////////////////////////////////////////////////////////////////
+// The staging copies of the GPU partitions a backend reads back, in order.
+// Each frame it maps every pending copy oldest first, without waiting, then
+// queues the new one in a free slot if there is one. A copy that maps makes
+// the older ones stale: the GPU finished them first anyway.
+struct PartitionReadbackQueue
+{
+	enum { Slots = 2 };
+
+	BOOL	mbPending[Slots];
+	u32		mQueuedFrame[Slots];	// order of the pending copies
+	u32		mFrame;
+
+	//------
+	PartitionReadbackQueue() { Reset(); }
+
+	void	Reset();
+	// The pending slots, oldest first, returns their count
+	u32		Pending(OUT u32* slots) const;
+	// The copy of slot was read
+	void	Landed(u32 slot);
+	// A slot to copy into, Slots when every copy is still in flight
+	u32		FreeSlot() const;
+	void	Queue(u32 slot);
+};
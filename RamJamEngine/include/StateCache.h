@@ -0,0 +1,327 @@
+#pragma once
+
+#include "Types.h"
+#include "Profiler.h"
+#include <string.h>
+
+//////////////////////////////////////////////////////////////////////////
+enum StateCacheSlot
+{
+	StateCache_VertexBuffer = 0,
+	StateCache_IndexBuffer,
+	StateCache_InputLayout,
+	StateCache_Topology,
+	StateCache_Rasterizer,
+	StateCache_Blend,
+	StateCache_ShaderResource,
+	StateCache_Material,
+	StateCache_Apply,
+	//------
+	StateCache_Count
+};
+
+//////////////////////////////////////////////////////////////////////////
+// Calls that reached the context (issued) and calls dropped because the
+// same value was already bound (filtered), per kind of state.
+struct StateCacheStats
+{
+	u32 mIssued  [StateCache_Count];
+	u32 mFiltered[StateCache_Count];
+
+	void Reset()
+	{
+		memset(mIssued,   0, sizeof(mIssued));
+		memset(mFiltered, 0, sizeof(mFiltered));
+	}
+
+	// Pipeline state only: buffers, layout, topology, rasterizer, blend, shader resources
+	u32 StateIssued()   const { u32 n = 0; for (u32 i = 0; i < StateCache_Material; ++i) n += mIssued[i];   return n; }
+	u32 StateFiltered() const { u32 n = 0; for (u32 i = 0; i < StateCache_Material; ++i) n += mFiltered[i]; return n; }
+
+	void FillProfilerInfos(ProfilerInfos* infos) const
+	{
+		infos->StateCallsIssued   = StateIssued();
+		infos->StateCallsFiltered = StateFiltered();
+		infos->MaterialsIssued    = mIssued  [StateCache_Material];
+		infos->MaterialsFiltered  = mFiltered[StateCache_Material];
+		infos->AppliesIssued      = mIssued  [StateCache_Apply];
+		infos->AppliesFiltered    = mFiltered[StateCache_Apply];
+	}
+};
+
+//////////////////////////////////////////////////////////////////////////
+// Sits between the renderer and the device context and drops the calls
+// that would bind what is already bound. Method signatures mirror the
+// context's, so a call site only changes its receiver.
+//
+// Traits gives the context, resource and effect pass types plus how to
+// apply a pass (see DX11StateTraits), which is also what lets the logic
+// run against a mock context.
+//
+// The cache only knows what went through it: anything binding behind its
+// back (sprite batch, GUI, compute passes) must be followed by Invalidate().
+// Effect passes can set rasterizer/blend state and shader resources, so
+// Apply() forgets those. Binding render targets or UAVs unbinds conflicting
+// shader resources, so OMSetRenderTargets/CSSetUnorderedAccessViews forget them too.
+template<class Traits>
+struct StateCache
+{
+	typedef typename Traits::Context			Context;
+	typedef typename Traits::Result				Result;
+	typedef typename Traits::Buffer				Buffer;
+	typedef typename Traits::Format				Format;
+	typedef typename Traits::InputLayout		InputLayout;
+	typedef typename Traits::Topology			Topology;
+	typedef typename Traits::RasterizerState	RasterizerState;
+	typedef typename Traits::BlendState			BlendState;
+	typedef typename Traits::ShaderResource		ShaderResource;
+	typedef typename Traits::RenderTarget		RenderTarget;
+	typedef typename Traits::DepthStencil		DepthStencil;
+	typedef typename Traits::UnorderedAccess	UnorderedAccess;
+	typedef typename Traits::Pass				Pass;
+
+	enum { MaxShaderResources = 16 };
+
+	Context*		mContext;
+	StateCacheStats	mStats;
+
+	//------
+	StateCache() : mContext(nullptr) { mStats.Reset(); Invalidate(); }
+
+	void SetContext(Context* context) { mContext = context; Invalidate(); }
+
+	//------
+	void Invalidate()
+	{
+		mbVertexBufferValid = false;
+		mbIndexBufferValid  = false;
+		mbInputLayoutValid  = false;
+		mbTopologyValid     = false;
+		mAppliedPass        = nullptr;
+		mbEffectDirty       = true;
+		mMaterialId         = 0;
+		InvalidatePassState();
+	}
+	//------
+	void InvalidatePassState()
+	{
+		mbRasterizerValid     = false;
+		mbBlendValid          = false;
+		mValidShaderResources = 0;
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	void IASetVertexBuffers(u32 startSlot, u32 numBuffers, Buffer* const* buffers, const u32* strides, const u32* offsets)
+	{
+		// Only slot 0 is tracked, the engine never binds more than one stream
+		BOOL bTracked = (startSlot == 0 && numBuffers == 1);
+		if (bTracked && mbVertexBufferValid && mVertexBuffer == buffers[0] && mVertexStride == strides[0] && mVertexOffset == offsets[0])
+		{
+			++mStats.mFiltered[StateCache_VertexBuffer];
+			return;
+		}
+		++mStats.mIssued[StateCache_VertexBuffer];
+		mContext->IASetVertexBuffers(startSlot, numBuffers, buffers, strides, offsets);
+
+		mbVertexBufferValid = bTracked;
+		if (bTracked)
+		{
+			mVertexBuffer = buffers[0];
+			mVertexStride = strides[0];
+			mVertexOffset = offsets[0];
+		}
+	}
+	//------
+	void IASetIndexBuffer(Buffer* buffer, Format format, u32 offset)
+	{
+		if (mbIndexBufferValid && mIndexBuffer == buffer && mIndexFormat == format && mIndexOffset == offset)
+		{
+			++mStats.mFiltered[StateCache_IndexBuffer];
+			return;
+		}
+		++mStats.mIssued[StateCache_IndexBuffer];
+		mContext->IASetIndexBuffer(buffer, format, offset);
+
+		mbIndexBufferValid = true;
+		mIndexBuffer       = buffer;
+		mIndexFormat       = format;
+		mIndexOffset       = offset;
+	}
+	//------
+	void IASetInputLayout(InputLayout* layout)
+	{
+		if (mbInputLayoutValid && mInputLayout == layout)
+		{
+			++mStats.mFiltered[StateCache_InputLayout];
+			return;
+		}
+		++mStats.mIssued[StateCache_InputLayout];
+		mContext->IASetInputLayout(layout);
+
+		mbInputLayoutValid = true;
+		mInputLayout       = layout;
+	}
+	//------
+	void IASetPrimitiveTopology(Topology topology)
+	{
+		if (mbTopologyValid && mTopology == topology)
+		{
+			++mStats.mFiltered[StateCache_Topology];
+			return;
+		}
+		++mStats.mIssued[StateCache_Topology];
+		mContext->IASetPrimitiveTopology(topology);
+
+		mbTopologyValid = true;
+		mTopology       = topology;
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	void RSSetState(RasterizerState* state)
+	{
+		if (mbRasterizerValid && mRasterizerState == state)
+		{
+			++mStats.mFiltered[StateCache_Rasterizer];
+			return;
+		}
+		++mStats.mIssued[StateCache_Rasterizer];
+		mContext->RSSetState(state);
+
+		mbRasterizerValid = true;
+		mRasterizerState  = state;
+	}
+	//------
+	void OMSetBlendState(BlendState* state, const float* blendFactor, u32 sampleMask)
+	{
+		// A null blend factor means (1,1,1,1)
+		float factor[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+		if (blendFactor)
+			memcpy(factor, blendFactor, sizeof(factor));
+
+		if (mbBlendValid && mBlendState == state && mSampleMask == sampleMask && memcmp(mBlendFactor, factor, sizeof(factor)) == 0)
+		{
+			++mStats.mFiltered[StateCache_Blend];
+			return;
+		}
+		++mStats.mIssued[StateCache_Blend];
+		mContext->OMSetBlendState(state, blendFactor, sampleMask);
+
+		mbBlendValid = true;
+		mBlendState  = state;
+		mSampleMask  = sampleMask;
+		memcpy(mBlendFactor, factor, sizeof(factor));
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	void PSSetShaderResources(u32 startSlot, u32 numViews, ShaderResource* const* views)
+	{
+		BOOL bTracked = (startSlot + numViews <= MaxShaderResources);
+		if (bTracked && numViews > 0)
+		{
+			u32  mask       = ((1u << numViews) - 1) << startSlot;
+			BOOL bSameViews = (mValidShaderResources & mask) == mask;
+			for (u32 i = 0; bSameViews && i < numViews; ++i)
+				bSameViews = (mShaderResources[startSlot + i] == views[i]);
+			if (bSameViews)
+			{
+				++mStats.mFiltered[StateCache_ShaderResource];
+				return;
+			}
+		}
+		++mStats.mIssued[StateCache_ShaderResource];
+		mContext->PSSetShaderResources(startSlot, numViews, views);
+
+		if (bTracked)
+		{
+			for (u32 i = 0; i < numViews; ++i)
+			{
+				mShaderResources[startSlot + i] = views[i];
+				mValidShaderResources |= 1u << (startSlot + i);
+			}
+		}
+	}
+	//------
+	// Not filtered, but whatever they make writable is unbound from the shader resource slots
+	void OMSetRenderTargets(u32 numViews, RenderTarget* const* renderTargets, DepthStencil* depthStencil)
+	{
+		mContext->OMSetRenderTargets(numViews, renderTargets, depthStencil);
+		mValidShaderResources = 0;
+	}
+	//------
+	void CSSetUnorderedAccessViews(u32 startSlot, u32 numViews, UnorderedAccess* const* views, const u32* initialCounts)
+	{
+		mContext->CSSetUnorderedAccessViews(startSlot, numViews, views, initialCounts);
+		mValidShaderResources = 0;
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// Effect side. The material constants are identified by Material::mSortId,
+	// 0 (no file behind the material) is never considered bound.
+	BOOL NeedsMaterial(u32 materialId)
+	{
+		if (materialId != 0 && materialId == mMaterialId)
+		{
+			++mStats.mFiltered[StateCache_Material];
+			return false;
+		}
+		++mStats.mIssued[StateCache_Material];
+		mMaterialId   = materialId;
+		mbEffectDirty = true;
+		return true;
+	}
+	//------
+	// To call after setting any other effect variable (world matrix, ...)
+	void MarkEffectDirty() { mbEffectDirty = true; }
+	//------
+	Result Apply(Pass* pass)
+	{
+		++mStats.mIssued[StateCache_Apply];
+		mAppliedPass  = pass;
+		mbEffectDirty = false;
+		InvalidatePassState();
+		return Traits::Apply(pass, mContext);
+	}
+	//------
+	// Skips the apply when this pass was the last one applied and no effect
+	// variable changed since. Only safe where every variable change goes
+	// through NeedsMaterial() or MarkEffectDirty().
+	Result ApplyIfDirty(Pass* pass)
+	{
+		if (mAppliedPass == pass && !mbEffectDirty)
+		{
+			++mStats.mFiltered[StateCache_Apply];
+			return Result();
+		}
+		return Apply(pass);
+	}
+
+private:
+	BOOL			mbVertexBufferValid;
+	Buffer*			mVertexBuffer;
+	u32				mVertexStride;
+	u32				mVertexOffset;
+	//------
+	BOOL			mbIndexBufferValid;
+	Buffer*			mIndexBuffer;
+	Format			mIndexFormat;
+	u32				mIndexOffset;
+	//------
+	BOOL			mbInputLayoutValid;
+	InputLayout*	mInputLayout;
+	BOOL			mbTopologyValid;
+	Topology		mTopology;
+	//------
+	BOOL				mbRasterizerValid;
+	RasterizerState*	mRasterizerState;
+	BOOL				mbBlendValid;
+	BlendState*			mBlendState;
+	float				mBlendFactor[4];
+	u32					mSampleMask;
+	//------
+	u32				mValidShaderResources;	// one bit per slot
+	ShaderResource*	mShaderResources[MaxShaderResources];
+	//------
+	const void*		mAppliedPass;
+	BOOL			mbEffectDirty;
+	u32				mMaterialId;
+};
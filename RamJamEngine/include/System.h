@@ -18,9 +18,6 @@ public:
 	int			mScreenWidth;
 	int			mScreenHeight;
 
-	string		mDataPath;
-	string		mResourcesPath;
-
 	// Application Statistics
 	float	fps;		// Frames Per Seconds
 	float	mspf;		// MilliSeconds Per Frame
@@ -42,6 +39,9 @@ public:
 	// Rendering Statistics
 	float mRenderingTime;
 
+	// Frame pacing, fixed step and budget of the main loop
+	FrameScheduler	mFrameScheduler;
+
 	GraphicAPI* mGraphicAPI;
 	Scene		mScene;
 	
@@ -92,14 +92,13 @@ private:
 
 	volatile LONG mRunCount;
 
-	BOOL UpdateScene(float dt);
+	BOOL UpdateScene(float dt, u32 steps = 1);
 	BOOL DrawScene();
 	BOOL InitializeWindows(int);
 	ATOM RegisterMyClass(HINSTANCE);
 	void ShutdownWindows();
 
 	void HandleInputs();
-	void LoadConfigFile();
 
 	void FeedProfilerInfo();
 
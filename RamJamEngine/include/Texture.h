@@ -1,10 +1,13 @@
 #pragma once
 
+#include "RjeConfig.h"
 #include "MathHelper.h"
 
 #if (RJE_GRAPHIC_API == DIRECTX_11)
 #	include <d3d11.h>
 typedef ID3D11ShaderResourceView ShaderResource;
+#elif (RJE_GRAPHIC_API == NULL_RENDER)
+typedef void ShaderResource;
 #else
 #	define ShaderResource
 #endif
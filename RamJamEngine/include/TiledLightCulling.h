@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Types.h"
+#include "MathHelper.h"
+#include "Bounds.h"
+#include "Light.h"
+#include "LightClusters.h"
+#include "ShaderDefines.h"
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////////
+// CPU mirror of the light culling in ComputeShaderTileCS (deferred.fx), to
+// check it and tune it without a GPU: same tile frustum planes, same depth
+// bounds reduction, same sphere test, for one sample per pixel.
+//
+// The depth buffer is given as view space z, one float per pixel, with
+// Infinity_f where the shader sees no geometry (zDepth >= 1, the skybox).
+//
+// CullBruteForce() is the independent check: planes built from the tile
+// corner rays instead of the projection columns, every light tested against
+// every tile. It only keeps lights clearly touching the tile, so a light
+// it keeps and Cull() doesn't is a real miss; the other way round is a light
+// grazing the tile within rounding.
+struct TiledLightCulling
+{
+	u32		mTileDim;				// pixels, COMPUTE_SHADER_TILE_GROUP_DIM on the GPU
+	u32		mTilesX, mTilesY;
+	//------
+	std::vector<f32>			mTileMinZ;		// FLT_MAX / 0 for tiles without geometry, as in the shader
+	std::vector<f32>			mTileMaxZ;
+	std::vector<LightCluster>	mTiles;			// offset/count into mLightIndices, row major
+	std::vector<u32>			mLightIndices;
+
+	//------
+	TiledLightCulling();
+
+	// nearZ/farZ: gNearFar, the camera planes the per pixel bounds start from
+	void	Cull(			const f32* viewZ, u32 width, u32 height, const Matrix44& view, const Matrix44& proj, f32 nearZ, f32 farZ,
+							const PointLight* lights, u32 lightCount, u32 tileDim = COMPUTE_SHADER_TILE_GROUP_DIM);
+	void	CullBruteForce(	const f32* viewZ, u32 width, u32 height, const Matrix44& view, const Matrix44& proj, f32 nearZ, f32 farZ,
+							const PointLight* lights, u32 lightCount, u32 tileDim = COMPUTE_SHADER_TILE_GROUP_DIM);
+
+	// The 6 planes of tile (x, y), pointing inward, the way the shader builds them
+	static void	TileFrustum(const Matrix44& proj, u32 width, u32 height, u32 tileDim, u32 tileX, u32 tileY,
+							f32 minTileZ, f32 maxTileZ, OUT Plane outPlanes[6]);
+
+	// (tile, light) pairs in one's lists and not in the other's
+	static void	Compare(const TiledLightCulling& culled, const TiledLightCulling& bruteForce, OUT u32& missed, OUT u32& extra);
+
+	// Over every tile, empty ones included (the shader runs them too)
+	void	Occupancy(OUT f32& averageLights, OUT u32& maxLights) const;
+
+private:
+	void	Resize(u32 width, u32 height, u32 tileDim);
+	void	ReduceDepthBounds(const f32* viewZ, u32 width, u32 height, f32 nearZ, f32 farZ);
+};
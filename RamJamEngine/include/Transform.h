@@ -1,12 +1,24 @@
 #pragma once
 
+#include "RjeConfig.h"
 #include "Types.h"
 #include "MathHelper.h"
 
+//////////////////////////////////////////////////////////////////////////
+// With RJE_DOUBLE_PRECISION, world positions are stored in doubles and
+// everything sent to the GPU is expressed relative to a render origin
+// that follows the camera, so the float matrices only ever hold small,
+// camera-relative translations.
+#if RJE_DOUBLE_PRECISION
+typedef Vector3d	WorldPosition;
+#else
+typedef Vector3		WorldPosition;
+#endif
+
 //////////////////////////////////////////////////////////////////////////
 struct Transform
 {
-	Vector3					Position;
+	WorldPosition			Position;
 	Vector3					LocalPosition;
 	//-----------
 	Vector3					Scale;
@@ -34,11 +46,18 @@ struct Transform
 	Vector3 Up();
 	Vector3 Forward();
 
+	// Both are relative to sRenderOrigin
 	Matrix44 WorldMatrix();
 	Matrix44 WorldMatrixNoScale();
 
 	//---------------------------
 
+	static WorldPosition	sRenderOrigin;
+	static Vector3			ToRenderSpace(const WorldPosition& position);
+	static Vector3			ToRenderSpace(const WorldPosition& position, const WorldPosition& renderOrigin);
+
+	//---------------------------
+
 	static Matrix44 MatrixFromTextureProperties(Vector2 tiling, Vector2 offset, f32 rotationAngle);
 
 	// TODO: add transform "everything" !
@@ -16,7 +16,7 @@
 #	include <windowsx.h>
 #endif
 
-#if defined(DEBUG) || defined(_DEBUG)
+#if (defined(DEBUG) || defined(_DEBUG)) && (COMPILER == COMPILER_MSVC)
 #define _CRTDBG_MAP_ALLOC
 #include <crtdbg.h>
 #endif
@@ -26,7 +26,9 @@
 #include <stdlib.h>
 #include <malloc.h>
 #include <memory.h>
-#include <tchar.h>
+#if PLATFORM == PLATFORM_WIN32
+#	include <tchar.h>
+#endif
 #include <cassert>
 #include <ctime>
 #include <algorithm>
@@ -35,18 +37,26 @@
 #include <fstream>
 #include <vector>
 
-#include "Resource.h"
+#if PLATFORM == PLATFORM_WIN32		// the window's resources, saved in UTF-16
+#	include "Resource.h"
+#endif
 
 //////////////////////////////////////////////////////////////////////////
 // Core
 #include "Globals.h"
 #include "Memory.h"
 #include "IniFile.h"
+#include "FileSystem.h"
 #include "Types.h"
 #include "Singleton.h"
 #include "Debug.h"
 #include "Profiler.h"
+#include "Clock.h"
 #include "Timer.h"
+#include "FrameScheduler.h"
+#include "FrameArena.h"
+#include "MemoryBudget.h"
+#include "ObjectPool.h"
 #include "Input.h"
 #include "Color.h"
 //////////////////////////////////////////////////////////////////////////
@@ -57,7 +67,9 @@
 #include "rapidxml_utils.hpp"
 //////////////////////////////////////////////////////////////////////////
 // AntTweakBar
-#include "AntTweakBar.h"
+#if (RJE_GRAPHIC_API != NULL_RENDER)
+#	include "AntTweakBar.h"
+#endif
 //////////////////////////////////////////////////////////////////////////
 // Math
 #include "MathHelper.h"
@@ -66,13 +78,17 @@
 #include "GraphicAPI.h"
 #if (RJE_GRAPHIC_API == DIRECTX_11)
 #	include "DX11RenderingAPI.h"
+#elif (RJE_GRAPHIC_API == NULL_RENDER)
+#	include "NullRenderingAPI.h"
 #else
 #	include "OglWrapper.h"
 #endif
 //////////////////////////////////////////////////////////////////////////
 // RamJam Engine SubCores
 #include "Scene.h"
-#include "System.h"
-#include "Console.h"
+#if (RJE_GRAPHIC_API != NULL_RENDER)		// the headless benchmark has no window nor console
+#	include "System.h"
+#	include "Console.h"
+#endif
 #include "Transform.h"
 #include "MaterialFactory.h"
@@ -1,14 +1,13 @@
 #include "Camera.h"
 #include "Input.h"
 #include "Timer.h"
-#include "System.h"
 
 //////////////////////////////////////////////////////////////////////////
 Camera::Camera()
 {
-	mTrf.Position = Vector3(0.0f, 1.0f, -5.0f);
+	mTrf.Position = WorldPosition(0.0f, 1.0f, -5.0f);
 	mUp     = Vector3(0.0f, 1.0f, 0.0f);
-	mLookAt = Vector3::zero;
+	mLookAt = WorldPosition();
 	mPitch  = 0.0f;
 	mYaw    = 0.0f;
 
@@ -29,6 +28,7 @@ Camera::Camera()
 	mSettings.FarZ        = 300.0f;
 	mSettings.AspectRatio = 1.77777777777777777f;	// Default 16/9
 
+	mViewSize        = Vector2(1.0f, 1.0f);
 	mLastMousePos.x  = 0;
 	mLastMousePos.y  = 0;
 	mCameraTheta	 = 1.5f*RJE::Math::Pi_f;
@@ -60,9 +60,6 @@ void Camera::SetCameraOrtho(BOOL orthographic = true)
 //////////////////////////////////////////////////////////////////////////
 void Camera::Update()
 {
-	if (Console::Instance()->IsActive())
-		return;
-
 	int mouseX = Input::Instance()->GetMousePosX();
 	int mouseY = Input::Instance()->GetMousePosY();
 
@@ -77,7 +74,7 @@ void Camera::Update()
 
 				mSettings.OrthoZoom += dx;
 				mSettings.OrthoZoom = RJE::Math::Clamp(mSettings.OrthoZoom, 0.0001f, 10000.0f);
-				UpdateProjMatrix((float)System::Instance()->mScreenWidth, (float)System::Instance()->mScreenHeight);
+				UpdateProjMatrix(mViewSize.x, mViewSize.y);
 			}
 			else
 			{
@@ -86,7 +83,7 @@ void Camera::Update()
 
 				mSettings.FOV += dx;
 				mSettings.FOV = RJE::Math::Clamp(mSettings.FOV, 1.0f, 179.0f);
-				UpdateProjMatrix((float)System::Instance()->mScreenWidth, (float)System::Instance()->mScreenHeight);
+				UpdateProjMatrix(mViewSize.x, mViewSize.y);
 			}
 		}
 		if (Input::Instance()->GetKeyboardDown(Return))
@@ -95,7 +92,7 @@ void Camera::Update()
 			else
 			{
 				mMode = Camera_TrackBall;
-				mLookAt = Vector3::zero;
+				mLookAt = WorldPosition();
 			}
 		}
 	}
@@ -104,7 +101,7 @@ void Camera::Update()
 		if (Input::Instance()->GetKeyboardDown(Return))
 		{
 			SetCameraOrtho(!IsOrtho());
-			UpdateProjMatrix((float)System::Instance()->mScreenWidth, (float)System::Instance()->mScreenHeight);
+			UpdateProjMatrix(mViewSize.x, mViewSize.y);
 		}
 	}
 
@@ -144,7 +141,7 @@ void Camera::Update()
 
 					mSettings.OrthoZoom += dx;
 					mSettings.OrthoZoom = RJE::Math::Clamp(mSettings.OrthoZoom, 0.0001f, 10000.0f);
-					UpdateProjMatrix((float)System::Instance()->mScreenWidth, (float)System::Instance()->mScreenHeight);
+					UpdateProjMatrix(mViewSize.x, mViewSize.y);
 				}
 				else
 				{
@@ -153,7 +150,7 @@ void Camera::Update()
 
 					mSettings.FOV += dx;
 					mSettings.FOV = RJE::Math::Clamp(mSettings.FOV, 1.0f, 179.0f);
-					UpdateProjMatrix((float)System::Instance()->mScreenWidth, (float)System::Instance()->mScreenHeight);
+					UpdateProjMatrix(mViewSize.x, mViewSize.y);
 				}
 			}
 		}
@@ -190,7 +187,7 @@ void Camera::Update()
 		float z = mCameraRadius*sinf(mCameraPhi)*sinf(mCameraTheta);
 		float y = mCameraRadius*cosf(mCameraPhi);
 
-		mTrf.Position = Vector3(x, y, z);
+		mTrf.Position = WorldPosition(x, y, z);
 		mUp = Vector3::up;
 	}
 	else	// FPS Camera Mode
@@ -205,14 +202,14 @@ void Camera::Update()
 		}
 		if( Input::Instance()->GetKeyboardDown(LeftShift) )		mSpeedMultiplier = 5.0f;
 		if( Input::Instance()->GetKeyboardUp(LeftShift) )		mSpeedMultiplier = 1.0f;
-		if( Input::Instance()->GetKeyboard(Z) )					mTrf.Position += mTrf.Forward() * Timer::Instance()->DeltaTime() * mSpeed * mSpeedMultiplier;
-		if( Input::Instance()->GetKeyboard(S) )					mTrf.Position -= mTrf.Forward() * Timer::Instance()->DeltaTime() * mSpeed * mSpeedMultiplier;
-		if( Input::Instance()->GetKeyboard(D) )					mTrf.Position += mTrf.Right()   * Timer::Instance()->DeltaTime() * mSpeed * mSpeedMultiplier;
-		if( Input::Instance()->GetKeyboard(Q) )					mTrf.Position -= mTrf.Right()   * Timer::Instance()->DeltaTime() * mSpeed * mSpeedMultiplier;
-		if( Input::Instance()->GetKeyboard(E) )					mTrf.Position += Vector3(0,1,0) * Timer::Instance()->DeltaTime() * mSpeed * mSpeedMultiplier;
-		if( Input::Instance()->GetKeyboard(A) )					mTrf.Position -= Vector3(0,1,0) * Timer::Instance()->DeltaTime() * mSpeed * mSpeedMultiplier;
+		if( Input::Instance()->GetKeyboard(Z) )					mTrf.Position += WorldPosition(mTrf.Forward() * Timer::Instance()->DeltaTime() * mSpeed * mSpeedMultiplier);
+		if( Input::Instance()->GetKeyboard(S) )					mTrf.Position -= WorldPosition(mTrf.Forward() * Timer::Instance()->DeltaTime() * mSpeed * mSpeedMultiplier);
+		if( Input::Instance()->GetKeyboard(D) )					mTrf.Position += WorldPosition(mTrf.Right()   * Timer::Instance()->DeltaTime() * mSpeed * mSpeedMultiplier);
+		if( Input::Instance()->GetKeyboard(Q) )					mTrf.Position -= WorldPosition(mTrf.Right()   * Timer::Instance()->DeltaTime() * mSpeed * mSpeedMultiplier);
+		if( Input::Instance()->GetKeyboard(E) )					mTrf.Position += WorldPosition(Vector3(0,1,0) * Timer::Instance()->DeltaTime() * mSpeed * mSpeedMultiplier);
+		if( Input::Instance()->GetKeyboard(A) )					mTrf.Position -= WorldPosition(Vector3(0,1,0) * Timer::Instance()->DeltaTime() * mSpeed * mSpeedMultiplier);
 		mTrf.Rotation = Quaternion(mPitch, mYaw, 0.0f);
-		mLookAt = mTrf.Position + mTrf.Forward();
+		mLookAt = mTrf.Position + WorldPosition(mTrf.Forward());
 		mUp = Vector3::up;
 		
 	}
@@ -225,14 +222,15 @@ void Camera::Update()
 //////////////////////////////////////////////////////////////////////////
 void Camera::UpdateViewMatrix()
 {
-	Vector3 eyeDir = mLookAt-mTrf.Position;
-	mView = Matrix44::LookAt(mTrf.Position, eyeDir, mUp);
+	Vector3 eyeDir = Vector3(mLookAt-mTrf.Position);
+	mView = Matrix44::LookAt(Transform::ToRenderSpace(mTrf.Position), eyeDir, mUp);
 }
 
 //////////////////////////////////////////////////////////////////////////
 // Updates the current projection matrix
 void Camera::UpdateProjMatrix(float sizeWidth, float sizeHeight)
 {
+	mViewSize = Vector2(sizeWidth, sizeHeight);
 	if (bIsOrtho)	UpdateOrthoMatrix(sizeWidth, sizeHeight);
 	else			UpdatePerspMatrix();
 }
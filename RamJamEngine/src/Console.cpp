@@ -41,6 +41,9 @@ Console::Console()
 	CommandList["loadSkybox"] = LoadSkybox;
 	// ------- Time -------
 	CommandList["time"] = Time;
+	// ----- Profiling -----
+	CommandList["capture"] = Capture;
+	CommandList["history"] = History;
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -223,6 +226,17 @@ void Console::AddCharacter( const char c )
 	mCurrentCmd.Cmd[mCurrentCmdLength]   = nullchar;
 }
 
+//------------------------------------------------------------------------
+void Console::OnTextInput(const char c)
+{
+	if (!Instance()->IsActive())
+		return;
+	if (c == VK_ESCAPE || c == VK_BACK || c == VK_RETURN)
+		return;
+
+	Instance()->AddCharacter(c);
+}
+
 //////////////////////////////////////////////////////////////////////////
 void Console::AddLine()
 {
@@ -449,7 +463,7 @@ void LoadScene(char* command /* = nullptr */)
 	}
 
 	string name(command);
-	string scene = System::Instance()->mDataPath + "scenes\\" + name + ".xml";
+	string scene = RJE_GLOBALS::gDataPath + "scenes\\" + name + ".xml";
 	System::Instance()->mScene.LoadFromFile(scene.c_str());
 	System::Instance()->mGraphicAPI->LoadSkybox(System::Instance()->mScene.mSkyboxName);
 }
@@ -522,3 +536,42 @@ void Time(char* command /* = nullptr */)
 	}
 	Console::Instance()->ConcatText(" -> Bad Parameter : time [-s 0-100|-r|-p]");
 }
+
+
+// ===== Profiling =====
+void Capture(char* command /* = nullptr */)
+{
+	u32 frames = 60;
+	if (command != nullptr)
+	{
+		int count = atoi(command);
+		if (count <= 0)
+		{
+			Console::Instance()->ConcatText(" -> Bad Parameter. Command usage : capture [frames]");
+			return;
+		}
+		frames = (u32)count;
+	}
+
+	string path = RJE_GLOBALS::gDataPath + "profiler_capture.json";
+	Profiler::Instance()->BeginCapture(frames, path.c_str());
+	Console::Instance()->ConcatText(" -> Capturing to ");
+	Console::Instance()->ConcatText(path.c_str());
+}
+//-----------------------------
+void History(char* command /* = nullptr */)
+{
+	const ProfileHistory& history = Profiler::Instance()->History();
+	ProfilePercentiles frame = history.FramePercentiles();
+
+	char buf[128];
+	sprintf_s(buf, " -> last %u frames, p50 %.2f / p95 %.2f / p99 %.2f / max %.2f ms", history.FramesRecorded(), frame.mP50, frame.mP95, frame.mP99, frame.mMax);
+	Console::Instance()->ConcatText(buf);
+
+	string path = RJE_GLOBALS::gDataPath + "profiler_history.csv";
+	if (Profiler::Instance()->WriteHistoryCsv(path.c_str()))
+	{
+		Console::Instance()->ConcatText(", written to ");
+		Console::Instance()->ConcatText(path.c_str());
+	}
+}
@@ -0,0 +1,130 @@
+#include "FramePipeline.h"
+
+#include <thread>
+
+//////////////////////////////////////////////////////////////////////////
+FramePipeline::FramePipeline()
+	: mLatency(1)
+	, mWriteSlot(0), mReadSlot(0)
+	, mPublished(0)
+	, mbRendering(false)
+	, mbStopped(false)
+{
+}
+
+//////////////////////////////////////////////////////////////////////////
+void FramePipeline::SetLatency(u32 frames)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	RJE_ASSERT(!mbRendering || mbStopped);
+
+	mLatency     = RJE::Math::Min(frames, (u32)MaxLatency);
+	mWriteSlot   = 0;
+	mReadSlot    = 0;
+	mPublished   = 0;
+	mbRendering  = false;
+	mbStopped    = false;
+}
+
+//////////////////////////////////////////////////////////////////////////
+RenderSnapshot* FramePipeline::BeginUpdate()
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+
+	// The published slots are in use until drawn, the one being drawn included
+	while (!mbStopped && mPublished >= mLatency + 1)
+	{
+		mCondition.wait(lock);
+	}
+	return mbStopped ? nullptr : &mSlots[mWriteSlot];
+}
+
+//////////////////////////////////////////////////////////////////////////
+void FramePipeline::EndUpdate()
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mWriteSlot = (mWriteSlot + 1) % (mLatency + 1);
+		++mPublished;
+	}
+	mCondition.notify_all();
+}
+
+//////////////////////////////////////////////////////////////////////////
+const RenderSnapshot* FramePipeline::BeginRender()
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	while (!mbStopped && mPublished == 0)
+	{
+		mCondition.wait(lock);
+	}
+	if (mPublished == 0)
+		return nullptr;
+
+	mbRendering = true;
+	return &mSlots[mReadSlot];
+}
+
+//////////////////////////////////////////////////////////////////////////
+void FramePipeline::EndRender()
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		RJE_ASSERT(mbRendering && mPublished > 0);
+		mReadSlot = (mReadSlot + 1) % (mLatency + 1);
+		--mPublished;
+		mbRendering = false;
+	}
+	mCondition.notify_all();
+}
+
+//////////////////////////////////////////////////////////////////////////
+void FramePipeline::Stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mbStopped = true;
+	}
+	mCondition.notify_all();
+}
+
+//////////////////////////////////////////////////////////////////////////
+void FramePipeline::Run(u32 frameCount, const UpdateFunction& update, const RenderFunction& render)
+{
+	SetLatency(mLatency);
+
+	if (mLatency == 0)
+	{
+		for (u32 frame = 0; frame < frameCount; ++frame)
+		{
+			update(*BeginUpdate(), frame);
+			EndUpdate();
+			render(*BeginRender());
+			EndRender();
+		}
+		return;
+	}
+
+	std::thread updateThread([this, frameCount, &update]()
+	{
+		for (u32 frame = 0; frame < frameCount; ++frame)
+		{
+			RenderSnapshot* snapshot = BeginUpdate();
+			if (!snapshot)
+				break;
+			update(*snapshot, frame);
+			EndUpdate();
+		}
+	});
+
+	for (u32 frame = 0; frame < frameCount; ++frame)
+	{
+		const RenderSnapshot* snapshot = BeginRender();
+		if (!snapshot)
+			break;
+		render(*snapshot);
+		EndRender();
+	}
+
+	updateThread.join();
+}
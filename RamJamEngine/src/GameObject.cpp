@@ -1,5 +1,7 @@
 #include "GameObject.h"
 
+ObjectPool<GameObject> GameObject::sPool("GameObject", Memory_Scene);
+
 //////////////////////////////////////////////////////////////////////////
 GameObject::GameObject()
 {
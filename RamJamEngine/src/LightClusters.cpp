@@ -0,0 +1,384 @@
+#include "LightClusters.h"
+
+#include <math.h>
+#include <string.h>
+#include <emmintrin.h>
+
+namespace
+{
+	//----------------------------------------------------------------------
+	FORCEINLINE Vector3 TransformPoint(const Vector3& p, const Matrix44& m)
+	{
+		return Vector3(	p.x*m.m11 + p.y*m.m21 + p.z*m.m31 + m.m41,
+						p.x*m.m12 + p.y*m.m22 + p.z*m.m32 + m.m42,
+						p.x*m.m13 + p.y*m.m23 + p.z*m.m33 + m.m43);
+	}
+	//----------------------------------------------------------------------
+	// Squared distance from c to the box, 0 inside. BinSlice() runs the same
+	// operations in the same order on 4 lights at a time: both agree bit for bit.
+	FORCEINLINE BOOL SphereTouchesBox(const Vector3& c, f32 radius, const Vector3& boxMin, const Vector3& boxMax)
+	{
+		f32 dx = RJE::Math::Max(RJE::Math::Max(boxMin.x - c.x, c.x - boxMax.x), 0.0f);
+		f32 dy = RJE::Math::Max(RJE::Math::Max(boxMin.y - c.y, c.y - boxMax.y), 0.0f);
+		f32 dz = RJE::Math::Max(RJE::Math::Max(boxMin.z - c.z, c.z - boxMax.z), 0.0f);
+		return dx*dx + dy*dy + dz*dz <= radius*radius;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+LightClusterGrid::LightClusterGrid()
+	: mWidth(0), mHeight(0)
+	, mTileSize(DefaultTileSize)
+	, mTilesX(0), mTilesY(0), mSlices(0)
+	, mNearZ(0.0f), mFarZ(0.0f)
+	, mProjScaleX(0.0f), mProjScaleY(0.0f)
+	, mSliceScale(0.0f), mSliceBias(0.0f)
+	, mBuildId(0), mBuildWorkers(0), mBusyWorkers(0)
+	, mbStopWorkers(false)
+	, mNextSlice(0)
+{
+	mWorkerCount = RJE::Math::Max(std::thread::hardware_concurrency(), 1u);
+}
+
+//////////////////////////////////////////////////////////////////////////
+LightClusterGrid::~LightClusterGrid()
+{
+	{
+		std::lock_guard<std::mutex> lock(mWorkerMutex);
+		mbStopWorkers = true;
+	}
+	mWorkerWake.notify_all();
+	for (std::thread& thread : mWorkers)
+		thread.join();
+}
+
+//////////////////////////////////////////////////////////////////////////
+void LightClusterGrid::Setup(u32 width, u32 height, const Matrix44& proj, f32 nearZ, f32 farZ, u32 tileSize, u32 slices)
+{
+	RJE_ASSERT(width > 0 && height > 0 && tileSize > 0 && slices > 0);
+	RJE_ASSERT(nearZ > 0.0f && farZ > nearZ);
+
+	mWidth    = width;
+	mHeight   = height;
+	mTileSize = tileSize;
+	mTilesX   = (width  + tileSize - 1) / tileSize;
+	mTilesY   = (height + tileSize - 1) / tileSize;
+	mSlices   = slices;
+	mNearZ    = nearZ;
+	mFarZ     = farZ;
+	mProjScaleX = proj.m11;
+	mProjScaleY = proj.m22;
+
+	f32 logRatio = logf(farZ / nearZ);
+	mSliceScale  = slices / logRatio;
+	mSliceBias   = -(slices * logf(nearZ)) / logRatio;
+
+	u32 tiles = mTilesX*mTilesY;
+	mClusterMin.resize(tiles*slices);
+	mClusterMax.resize(tiles*slices);
+	mRowMin.resize(mTilesY*slices);
+	mRowMax.resize(mTilesY*slices);
+	mSliceMin.resize(slices);
+	mSliceMax.resize(slices);
+
+	for (u32 s = 0; s < slices; ++s)
+	{
+		f32 sliceZ[2] = {	nearZ * powf(farZ / nearZ, static_cast<f32>(s)     / slices),
+							nearZ * powf(farZ / nearZ, static_cast<f32>(s + 1) / slices) };
+		mSliceMin[s] = Vector3( RJE::Math::Infinity_f,  RJE::Math::Infinity_f,  RJE::Math::Infinity_f);
+		mSliceMax[s] = Vector3(-RJE::Math::Infinity_f, -RJE::Math::Infinity_f, -RJE::Math::Infinity_f);
+
+		for (u32 y = 0; y < mTilesY; ++y)
+		{
+			u32 row = s*mTilesY + y;
+			mRowMin[row] = mSliceMin[s];
+			mRowMax[row] = mSliceMax[s];
+
+			// Pixel rows go down, NDC y goes up
+			f32 ndcY[2] = {	1.0f - 2.0f * (y * tileSize) / height,
+							1.0f - 2.0f * RJE::Math::Min((y + 1) * tileSize, height) / height };
+
+			for (u32 x = 0; x < mTilesX; ++x)
+			{
+				f32 ndcX[2] = {	2.0f * (x * tileSize) / width - 1.0f,
+								2.0f * RJE::Math::Min((x + 1) * tileSize, width) / width - 1.0f };
+
+				// Box around the 8 corners of the tile frustum between the slice planes
+				Vector3 boxMin( RJE::Math::Infinity_f,  RJE::Math::Infinity_f,  RJE::Math::Infinity_f);
+				Vector3 boxMax(-RJE::Math::Infinity_f, -RJE::Math::Infinity_f, -RJE::Math::Infinity_f);
+				for (u32 corner = 0; corner < 8; ++corner)
+				{
+					f32 z = sliceZ[corner >> 2];
+					Vector3 p(ndcX[corner & 1] * z / proj.m11, ndcY[(corner >> 1) & 1] * z / proj.m22, z);
+					boxMin = Vector3::Min(boxMin, p);
+					boxMax = Vector3::Max(boxMax, p);
+				}
+
+				u32 cluster = ClusterIndex(x, y, s);
+				mClusterMin[cluster] = boxMin;
+				mClusterMax[cluster] = boxMax;
+				mRowMin[row] = Vector3::Min(mRowMin[row], boxMin);
+				mRowMax[row] = Vector3::Max(mRowMax[row], boxMax);
+			}
+			mSliceMin[s] = Vector3::Min(mSliceMin[s], mRowMin[row]);
+			mSliceMax[s] = Vector3::Max(mSliceMax[s], mRowMax[row]);
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+BOOL LightClusterGrid::IsSetup(u32 width, u32 height, const Matrix44& proj, f32 nearZ, f32 farZ) const
+{
+	return	mSlices > 0 && mWidth == width && mHeight == height &&
+			mProjScaleX == proj.m11 && mProjScaleY == proj.m22 && mNearZ == nearZ && mFarZ == farZ;
+}
+
+//////////////////////////////////////////////////////////////////////////
+u32 LightClusterGrid::Slice(f32 viewZ) const
+{
+	if (viewZ <= mNearZ)
+		return 0;
+	f32 slice = logf(viewZ) * mSliceScale + mSliceBias;
+	return RJE::Math::Min(static_cast<u32>(slice), mSlices - 1);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void LightClusterGrid::TransformLights(const PointLight* lights, u32 lightCount, const Matrix44& view)
+{
+	mLightPositions.resize(lightCount);
+	mLightRadii.resize(lightCount);
+	for (u32 i = 0; i < lightCount; ++i)
+	{
+		mLightPositions[i] = TransformPoint(lights[i].Position, view);
+		mLightRadii[i]     = lights[i].Range;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Slice, then tile row, then tile: each level only tests the lights that
+// touch the box of the level above. A light touching a box touches every
+// box containing it, so the narrowing never loses one.
+void LightClusterGrid::BinSlice(u32 slice, SliceBins& bins)
+{
+	u32 lightCount = static_cast<u32>(mLightPositions.size());
+
+	bins.mClusters.resize(mTilesX*mTilesY);
+	bins.mIndices.clear();
+	bins.mCandidates.clear();
+	for (u32 i = 0; i < lightCount; ++i)
+	{
+		if (SphereTouchesBox(mLightPositions[i], mLightRadii[i], mSliceMin[slice], mSliceMax[slice]))
+			bins.mCandidates.push_back(i);
+	}
+
+	const __m128 zero = _mm_setzero_ps();
+	for (u32 y = 0; y < mTilesY; ++y)
+	{
+		u32 row = slice*mTilesY + y;
+		bins.mRowCandidates.clear();
+		for (u32 i : bins.mCandidates)
+		{
+			if (SphereTouchesBox(mLightPositions[i], mLightRadii[i], mRowMin[row], mRowMax[row]))
+				bins.mRowCandidates.push_back(i);
+		}
+
+		// x, y, z, radius of 4 lights per block, the last block zero padded
+		u32 candidateCount = static_cast<u32>(bins.mRowCandidates.size());
+		u32 blockCount     = (candidateCount + 3) / 4;
+		bins.mSoA.assign(blockCount*16, 0.0f);
+		for (u32 i = 0; i < candidateCount; ++i)
+		{
+			f32* block = &bins.mSoA[(i / 4) * 16];
+			const Vector3& p = mLightPositions[bins.mRowCandidates[i]];
+			block[ 0 + (i & 3)] = p.x;
+			block[ 4 + (i & 3)] = p.y;
+			block[ 8 + (i & 3)] = p.z;
+			block[12 + (i & 3)] = mLightRadii[bins.mRowCandidates[i]];
+		}
+
+		for (u32 x = 0; x < mTilesX; ++x)
+		{
+			u32 cluster = ClusterIndex(x, y, slice);
+			const Vector3& boxMin = mClusterMin[cluster];
+			const Vector3& boxMax = mClusterMax[cluster];
+			__m128 minX = _mm_set1_ps(boxMin.x), minY = _mm_set1_ps(boxMin.y), minZ = _mm_set1_ps(boxMin.z);
+			__m128 maxX = _mm_set1_ps(boxMax.x), maxY = _mm_set1_ps(boxMax.y), maxZ = _mm_set1_ps(boxMax.z);
+
+			LightCluster& bin = bins.mClusters[y*mTilesX + x];
+			bin.mOffset = static_cast<u32>(bins.mIndices.size());
+
+			for (u32 b = 0; b < blockCount; ++b)
+			{
+				const f32* block = &bins.mSoA[b*16];
+				__m128 cx = _mm_loadu_ps(block + 0);
+				__m128 cy = _mm_loadu_ps(block + 4);
+				__m128 cz = _mm_loadu_ps(block + 8);
+				__m128 r  = _mm_loadu_ps(block + 12);
+
+				__m128 dx = _mm_max_ps(_mm_max_ps(_mm_sub_ps(minX, cx), _mm_sub_ps(cx, maxX)), zero);
+				__m128 dy = _mm_max_ps(_mm_max_ps(_mm_sub_ps(minY, cy), _mm_sub_ps(cy, maxY)), zero);
+				__m128 dz = _mm_max_ps(_mm_max_ps(_mm_sub_ps(minZ, cz), _mm_sub_ps(cz, maxZ)), zero);
+				__m128 distSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+
+				i32 mask = _mm_movemask_ps(_mm_cmple_ps(distSq, _mm_mul_ps(r, r)));
+				u32 valid = RJE::Math::Min(candidateCount - b*4, 4u);
+				mask &= (1 << valid) - 1;
+				for (u32 lane = 0; mask; ++lane, mask >>= 1)
+				{
+					if (mask & 1)
+						bins.mIndices.push_back(bins.mRowCandidates[b*4 + lane]);
+				}
+			}
+			bin.mCount = static_cast<u32>(bins.mIndices.size()) - bin.mOffset;
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+void LightClusterGrid::MergeSlices()
+{
+	u32 tiles = mTilesX*mTilesY;
+	u32 total = 0;
+	for (u32 s = 0; s < mSlices; ++s)
+		total += static_cast<u32>(mBins[s].mIndices.size());
+
+	mClusters.resize(ClusterCount());
+	mLightIndices.resize(total);
+
+	u32 base = 0;
+	for (u32 s = 0; s < mSlices; ++s)
+	{
+		const SliceBins& bins = mBins[s];
+		for (u32 t = 0; t < tiles; ++t)
+		{
+			LightCluster& cluster = mClusters[s*tiles + t];
+			cluster.mOffset = base + bins.mClusters[t].mOffset;
+			cluster.mCount  = bins.mClusters[t].mCount;
+		}
+		if (!bins.mIndices.empty())
+			memcpy(&mLightIndices[base], &bins.mIndices[0], bins.mIndices.size() * sizeof(u32));
+		base += static_cast<u32>(bins.mIndices.size());
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Workers past mBuildWorkers skip the build they were woken for. lastBuild
+// is the build before the one a new worker is started for.
+void LightClusterGrid::WorkerLoop(u32 worker, u32 lastBuild)
+{
+	std::unique_lock<std::mutex> lock(mWorkerMutex);
+	for (;;)
+	{
+		mWorkerWake.wait(lock, [&]() { return mbStopWorkers || mBuildId != lastBuild; });
+		if (mbStopWorkers)
+			return;
+		lastBuild = mBuildId;
+		if (worker >= mBuildWorkers)
+			continue;
+
+		lock.unlock();
+		BinSlices();
+		lock.lock();
+		if (--mBusyWorkers == 0)
+			mWorkerDone.notify_one();
+	}
+}
+
+//------------------------------------------------------------------------
+void LightClusterGrid::BinSlices()
+{
+	for (u32 s = mNextSlice++; s < mSlices; s = mNextSlice++)
+		BinSlice(s, mBins[s]);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Slices are handed out one at a time to the workers, each one writes its
+// own SliceBins. The lists are then concatenated in slice order, so the
+// result doesn't depend on the number of workers.
+void LightClusterGrid::Build(const PointLight* lights, u32 lightCount, const Matrix44& view)
+{
+	RJE_ASSERT(mSlices > 0);
+	TransformLights(lights, lightCount, view);
+	mBins.resize(mSlices);
+	mNextSlice = 0;
+
+	// The caller bins too
+	u32 helpers = RJE::Math::Clamp(mWorkerCount, 1u, mSlices) - 1;
+	if (helpers == 0)
+	{
+		BinSlices();
+		MergeSlices();
+		return;
+	}
+
+	for (u32 i = static_cast<u32>(mWorkers.size()); i < helpers; ++i)
+		mWorkers.push_back(std::thread(&LightClusterGrid::WorkerLoop, this, i, mBuildId));
+	{
+		std::lock_guard<std::mutex> lock(mWorkerMutex);
+		mBuildWorkers = helpers;
+		mBusyWorkers  = helpers;
+		++mBuildId;
+	}
+	mWorkerWake.notify_all();
+
+	BinSlices();
+	{
+		std::unique_lock<std::mutex> lock(mWorkerMutex);
+		mWorkerDone.wait(lock, [&]() { return mBusyWorkers == 0; });
+	}
+
+	MergeSlices();
+}
+
+//////////////////////////////////////////////////////////////////////////
+void LightClusterGrid::BuildReference(const PointLight* lights, u32 lightCount, const Matrix44& view)
+{
+	RJE_ASSERT(mSlices > 0);
+	TransformLights(lights, lightCount, view);
+
+	mClusters.resize(ClusterCount());
+	mLightIndices.clear();
+	for (u32 c = 0; c < ClusterCount(); ++c)
+	{
+		mClusters[c].mOffset = static_cast<u32>(mLightIndices.size());
+		for (u32 i = 0; i < lightCount; ++i)
+		{
+			if (SphereTouchesBox(mLightPositions[i], mLightRadii[i], mClusterMin[c], mClusterMax[c]))
+				mLightIndices.push_back(i);
+		}
+		mClusters[c].mCount = static_cast<u32>(mLightIndices.size()) - mClusters[c].mOffset;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+BOOL LightClusterGrid::SameLists(const LightClusterGrid& other) const
+{
+	if (mClusters.size() != other.mClusters.size() || mLightIndices.size() != other.mLightIndices.size())
+		return false;
+
+	for (u32 c = 0; c < mClusters.size(); ++c)
+	{
+		const LightCluster& a = mClusters[c];
+		const LightCluster& b = other.mClusters[c];
+		if (a.mCount != b.mCount)
+			return false;
+		if (a.mCount && memcmp(&mLightIndices[a.mOffset], &other.mLightIndices[b.mOffset], a.mCount * sizeof(u32)) != 0)
+			return false;
+	}
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void LightClusterGrid::Occupancy(OUT f32& averageLights, OUT u32& maxLights, OUT u32& usedClusters) const
+{
+	maxLights    = 0;
+	usedClusters = 0;
+	for (const LightCluster& cluster : mClusters)
+	{
+		if (cluster.mCount == 0)
+			continue;
+		++usedClusters;
+		maxLights = RJE::Math::Max(maxLights, cluster.mCount);
+	}
+	averageLights = usedClusters ? static_cast<f32>(mLightIndices.size()) / usedClusters : 0.0f;
+}
@@ -1,9 +1,37 @@
 #include "Material.h"
 #include "Memory.h"
-#include "System.h"
+#include "stdafx.h"
+
+#if (RJE_GRAPHIC_API == NULL_RENDER)
+typedef NullTextureManager TextureManager;
+#else
+typedef DX11TextureManager TextureManager;
+#endif
+
+ObjectPool<Material>			Material::sPool("Material", Memory_Materials);
+ObjectPool<MaterialProperty>	MaterialProperty::sPool("MaterialProperty", Memory_Materials);
+
+// Material file and shader names -> render queue sort ids
+static std::unordered_map<std::string, u32> sMaterialSortIds;
+static std::unordered_map<std::string, u32> sShaderSortIds;
+//-------------
+static u32 GetSortId(std::unordered_map<std::string, u32>& ids, const std::string& name)
+{
+	std::unordered_map<std::string, u32>::iterator it = ids.find(name);
+	if (it != ids.end())
+		return it->second;
+	u32 id = (u32)ids.size() + 1;
+	ids[name] = id;
+	return id;
+}
 
 //-------------
-Material::Material() { ZeroMemory(this, sizeof(this)); }
+Material::Material()
+{
+	ZeroMemory(this, sizeof(this));
+	mSortId       = 0;
+	mShaderSortId = 0;
+}
 //-------------
 Material::~Material()
 {
@@ -25,7 +53,7 @@ void Material::DefaultMaterial()
 	Vector2 tiling = Vector2(1.0f, 1.0);
 	Vector2 offset = Vector2(0.0f, 0.0);
 	float rotation = 0.0f;
-	AddPropertyTexture("Texture_Diffuse", DX11TextureManager::Instance()->mTextures["_default"], tiling, offset, rotation);
+	AddPropertyTexture("Texture_Diffuse", TextureManager::Instance()->mTextures["_default"], tiling, offset, rotation);
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -33,6 +61,8 @@ void Material::LoadPropertiesFromFile( std::string filename )
 {
 	std::string shaderName = CIniFile::GetValue("Name", "shader");
 	mIsOpaque = !CIniFile::GetValueBool("Transparency", "properties");
+	mSortId       = GetSortId(sMaterialSortIds, filename);
+	mShaderSortId = GetSortId(sShaderSortIds,   shaderName);
 	
 	RJE_ASSERT(MaterialFactory::Instance()->IsShaderLoaded(shaderName));
 	SetPropertiesFromFactory(shaderName);
@@ -56,7 +86,7 @@ void Material::SetPropertiesFromFactory( std::string shaderName )
 			else if ( type == "Texture2D")
 			{
 				std::string texturePathRel = CIniFile::GetValue(it->mSemantic, "textures");
-				std::string texturePathAbs = System::Instance()->mDataPath + texturePathRel;
+				std::string texturePathAbs = RJE_GLOBALS::gDataPath + texturePathRel;
 				int slash = (int)texturePathRel.rfind('\\')+1;
 				int point = (int)texturePathRel.find('.');
 				std::string textureName = texturePathRel.substr(slash, point-slash);
@@ -64,15 +94,15 @@ void Material::SetPropertiesFromFactory( std::string shaderName )
 				if (textureName != "NONE")
 				{
 					// we prevent loading if we're already using this texture
-					if (!DX11TextureManager::Instance()->IsTextureLoaded(textureName))
-						DX11TextureManager::Instance()->LoadTexture(texturePathAbs, textureName);
+					if (!TextureManager::Instance()->IsTextureLoaded(textureName))
+						TextureManager::Instance()->LoadTexture(texturePathAbs, textureName);
 
 					// we load the texture properties
 					Vector2 tiling = CIniFile::GetValueVector2("Tiling", "textures");
 					Vector2 offset = CIniFile::GetValueVector2("Offset", "textures");
 					float rotation = CIniFile::GetValueFloat("Rotation", "textures");
 
-					AddPropertyTexture(it->mSemantic, DX11TextureManager::Instance()->mTextures[textureName], tiling, offset, rotation);
+					AddPropertyTexture(it->mSemantic, TextureManager::Instance()->mTextures[textureName], tiling, offset, rotation);
 				}
 			}
 		}
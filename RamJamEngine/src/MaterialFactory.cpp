@@ -26,8 +26,7 @@ void MaterialFactory::RegisterShader( std::string shaderName )
 	{
 		// Adding shader in the factory
 		mCurrentShader = file;
-		std::vector<MaterialProperty> default;
-		mFactories[file] = default;
+		mFactories[file] = std::vector<MaterialProperty>();
 	}
 	else
 	{
@@ -0,0 +1,234 @@
+#include "PointLightSet.h"
+#include "FastMath.h"
+
+#include <string.h>
+#include <emmintrin.h>
+
+//////////////////////////////////////////////////////////////////////////
+PointLightSet::PointLightSet()
+	: mCount(0)
+	, mRadiusScale(0.0f)
+	, mHeightScale(0.0f)
+	, mbLayoutValid(false)
+	, mbStepMoved(false)
+	, mStoredAlpha(1.0f)
+{
+	memset(mOrbitRadius, 0, sizeof(mOrbitRadius));
+	memset(mOrbitHeight, 0, sizeof(mOrbitHeight));
+	memset(mOrbitAngle,  0, sizeof(mOrbitAngle));
+	memset(mOrbitSpeed,  0, sizeof(mOrbitSpeed));
+	memset(mDirtyBlocks, 0, sizeof(mDirtyBlocks));
+}
+
+//////////////////////////////////////////////////////////////////////////
+void PointLightSet::SetCount(u32 count)
+{
+	RJE_ASSERT(count <= MAX_LIGHTS);
+
+	mCount        = count;
+	mbLayoutValid = false;
+	ClearDirty();
+	MarkAllDirty();
+}
+
+//////////////////////////////////////////////////////////////////////////
+void PointLightSet::SetLight(u32 light, const Vector3& color, f32 range, f32 intensity)
+{
+	RJE_ASSERT(light < MAX_LIGHTS);
+
+	mLights[light].Color     = color;
+	mLights[light].Range     = range;
+	mLights[light].Intensity = intensity;
+	MarkDirty(light, 1);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void PointLightSet::MarkDirty(u32 first, u32 count)
+{
+	if (count == 0)
+		return;
+
+	RJE_ASSERT(first + count <= MAX_LIGHTS);
+	u32 lastBlock = (first + count - 1) / DirtyBlockSize;
+	for (u32 block = first / DirtyBlockSize; block <= lastBlock; ++block)
+	{
+		mDirtyBlocks[block] = 1;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+void PointLightSet::Update(f32 animationTime, BOOL bAnimate, f32 radiusScale, f32 heightScale)
+{
+	if (mCount == 0)
+		return;
+
+	BOOL bLayoutChanged = !mbLayoutValid || radiusScale != mRadiusScale || heightScale != mHeightScale;
+	if (!bAnimate && !bLayoutChanged)
+	{
+		mbStepMoved = false;
+		return;
+	}
+
+	if (bAnimate)
+	{
+		KeepPositions(mPreviousX, mPreviousY, mPreviousZ);
+		AdvanceAngles(animationTime);
+	}
+	RJE::FastMath::SinCos(mOrbitAngle, mSin, mCos, mCount);
+	ComputePositions(radiusScale, heightScale);
+	if (bLayoutChanged)
+	{
+		// The new layout doesn't slide in
+		KeepPositions(mPreviousX, mPreviousY, mPreviousZ);
+	}
+	StorePositions(1.0f);
+
+	mbStepMoved   = !bLayoutChanged;
+	mStoredAlpha  = 1.0f;
+	mRadiusScale  = radiusScale;
+	mHeightScale  = heightScale;
+	mbLayoutValid = true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void PointLightSet::Interpolate(f32 alpha)
+{
+	if (mCount == 0 || !mbLayoutValid)
+		return;
+
+	alpha = mbStepMoved && alpha < 1.0f ? (alpha > 0.0f ? alpha : 0.0f) : 1.0f;
+	if (alpha == mStoredAlpha)
+		return;
+
+	StorePositions(alpha);
+	mStoredAlpha = alpha;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void PointLightSet::AdvanceAngles(f32 animationTime)
+{
+	// angle - 2pi*trunc(angle/2pi): keeps FastMath within its error bound however
+	// long the app runs, and doesn't care how long the frame was
+	const __m128 time     = _mm_set1_ps(animationTime);
+	const __m128 twoPi    = _mm_set1_ps(RJE::Math::Pi_Two_f);
+	const __m128 rcpTwoPi = _mm_set1_ps(1.0f / RJE::Math::Pi_Two_f);
+
+	u32 i = 0;
+	for (; i + 4 <= mCount; i += 4)
+	{
+		__m128 angle = _mm_add_ps(_mm_loadu_ps(mOrbitAngle + i), _mm_mul_ps(_mm_loadu_ps(mOrbitSpeed + i), time));
+		__m128 turns = _mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_mul_ps(angle, rcpTwoPi)));
+		_mm_storeu_ps(mOrbitAngle + i, _mm_sub_ps(angle, _mm_mul_ps(turns, twoPi)));
+	}
+	for (; i < mCount; ++i)
+	{
+		f32 angle = mOrbitAngle[i] + mOrbitSpeed[i] * animationTime;
+		f32 turns = static_cast<f32>(static_cast<i32>(angle * (1.0f / RJE::Math::Pi_Two_f)));
+		mOrbitAngle[i] = angle - turns * RJE::Math::Pi_Two_f;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+void PointLightSet::ComputePositions(f32 radiusScale, f32 heightScale)
+{
+	const __m128 radius = _mm_set1_ps(radiusScale);
+	const __m128 height = _mm_set1_ps(heightScale);
+
+	u32 i = 0;
+	for (; i + 4 <= mCount; i += 4)
+	{
+		__m128 orbit = _mm_mul_ps(_mm_loadu_ps(mOrbitRadius + i), radius);
+		_mm_storeu_ps(mPositionX + i, _mm_mul_ps(orbit, _mm_loadu_ps(mCos + i)));
+		_mm_storeu_ps(mPositionY + i, _mm_mul_ps(_mm_loadu_ps(mOrbitHeight + i), height));
+		_mm_storeu_ps(mPositionZ + i, _mm_mul_ps(orbit, _mm_loadu_ps(mSin + i)));
+	}
+	for (; i < mCount; ++i)
+	{
+		f32 orbit = mOrbitRadius[i] * radiusScale;
+		mPositionX[i] = orbit * mCos[i];
+		mPositionY[i] = mOrbitHeight[i] * heightScale;
+		mPositionZ[i] = orbit * mSin[i];
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+void PointLightSet::KeepPositions(OUT f32* x, OUT f32* y, OUT f32* z) const
+{
+	memcpy(x, mPositionX, mCount * sizeof(f32));
+	memcpy(y, mPositionY, mCount * sizeof(f32));
+	memcpy(z, mPositionZ, mCount * sizeof(f32));
+}
+
+//////////////////////////////////////////////////////////////////////////
+void PointLightSet::StorePositions(f32 alpha)
+{
+	// Still lights keep the same bits: their block stays clean. Alpha 1 is
+	// the step's own positions, not previous + (current - previous).
+	for (u32 block = 0; block * DirtyBlockSize < mCount; ++block)
+	{
+		u32  first  = block * DirtyBlockSize;
+		u32  last   = RJE::Math::Min(first + DirtyBlockSize, mCount);
+		BOOL bMoved = false;
+		for (u32 i = first; i < last; ++i)
+		{
+			f32 x = mPositionX[i], y = mPositionY[i], z = mPositionZ[i];
+			if (alpha < 1.0f)
+			{
+				x = mPreviousX[i] + (x - mPreviousX[i]) * alpha;
+				y = mPreviousY[i] + (y - mPreviousY[i]) * alpha;
+				z = mPreviousZ[i] + (z - mPreviousZ[i]) * alpha;
+			}
+			Vector3& position = mLights[i].Position;
+			if (position.x != x || position.y != y || position.z != z)
+			{
+				position = Vector3(x, y, z);
+				bMoved   = true;
+			}
+		}
+		if (bMoved)
+		{
+			mDirtyBlocks[block] = 1;
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+void PointLightSet::DirtyRanges(OUT std::vector<LightRange>& ranges) const
+{
+	ranges.clear();
+	for (u32 block = 0; block * DirtyBlockSize < mCount; ++block)
+	{
+		if (!mDirtyBlocks[block])
+			continue;
+
+		u32 first = block * DirtyBlockSize;
+		u32 count = RJE::Math::Min(first + DirtyBlockSize, mCount) - first;
+		if (!ranges.empty() && ranges.back().mFirst + ranges.back().mCount == first)
+		{
+			ranges.back().mCount += count;
+		}
+		else
+		{
+			LightRange range = { first, count };
+			ranges.push_back(range);
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+u32 PointLightSet::DirtyLightCount() const
+{
+	u32 count = 0;
+	for (u32 block = 0; block * DirtyBlockSize < mCount; ++block)
+	{
+		if (mDirtyBlocks[block])
+			count += RJE::Math::Min((block + 1) * DirtyBlockSize, mCount) - block * DirtyBlockSize;
+	}
+	return count;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void PointLightSet::ClearDirty()
+{
+	memset(mDirtyBlocks, 0, sizeof(mDirtyBlocks));
+}
@@ -0,0 +1,60 @@
+#include "RenderQueue.h"
+
+#include <string.h>
+
+//////////////////////////////////////////////////////////////////////////
+void RenderQueue::Sort()
+{
+	if (mPackets.size() < 2)
+		return;
+
+	mScratch.resize(mPackets.size());
+	RadixSort(&mPackets.front(), &mScratch.front(), (u32)mPackets.size());
+}
+
+//////////////////////////////////////////////////////////////////////////
+void RenderQueue::RadixSort(RenderPacket* packets, RenderPacket* scratch, u32 count)
+{
+	if (count < 2)
+		return;
+
+	// All the histograms in a single read of the keys
+	u32 histograms[8][256];
+	memset(histograms, 0, sizeof(histograms));
+	for (u32 i = 0; i < count; ++i)
+	{
+		u64 key = packets[i].mKey;
+		for (u32 b = 0; b < 8; ++b)
+			++histograms[b][(key >> (b*8)) & 0xFF];
+	}
+
+	RenderPacket* src = packets;
+	RenderPacket* dst = scratch;
+	for (u32 b = 0; b < 8; ++b)
+	{
+		u32* histogram = histograms[b];
+
+		// Every key has the same byte here: this pass would be a plain copy
+		if (histogram[(src[0].mKey >> (b*8)) & 0xFF] == count)
+			continue;
+
+		u32 offset = 0;
+		for (u32 d = 0; d < 256; ++d)
+		{
+			u32 n = histogram[d];
+			histogram[d] = offset;
+			offset += n;
+		}
+
+		for (u32 i = 0; i < count; ++i)
+			dst[histogram[(src[i].mKey >> (b*8)) & 0xFF]++] = src[i];
+
+		RenderPacket* tmp = src;
+		src = dst;
+		dst = tmp;
+	}
+
+	// Odd number of scattering passes: the result sits in the scratch buffer
+	if (src != packets)
+		memcpy(packets, src, count * sizeof(RenderPacket));
+}
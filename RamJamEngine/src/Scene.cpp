@@ -1,9 +1,11 @@
 #include "Scene.h"
-#include "System.h"
+#include "stdafx.h"
 
 //////////////////////////////////////////////////////////////////////////
 Scene::Scene()
 {
+	mEditorGameobject = nullptr;
+	//-----------
 	mFogColor          = Color(Color::Silver).GetVector4RGBANorm();
 	mAmbientLightColor = Color(Color::Black).GetVector4RGBANorm();
 	mFogStart = 15.0f;
@@ -58,9 +60,22 @@ Scene::Scene()
 //////////////////////////////////////////////////////////////////////////
 Scene::~Scene()
 {
-	mEditorGameobject->mDrawable.mGizmo->Destroy();
-	RJE_SAFE_DELETE(mEditorGameobject->mDrawable.mGizmo);
-	RJE_SAFE_DELETE(mEditorGameobject);
+	Unload();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Releases everything LoadFromFile and Init created, so another scene can be loaded
+void Scene::Unload()
+{
+	if (mEditorGameobject)
+	{
+		mEditorGameobject->mDrawable.mGizmo->Destroy();
+		RJE_SAFE_DELETE(mEditorGameobject->mDrawable.mGizmo);
+		RJE_SAFE_DELETE(mEditorGameobject);
+	}
+	mGameObjects.clear();
+	mCurrentEditorGOIdx   = 0;
+	mCurrentEditorGOIdxUI = 0;
 }
 
 
@@ -72,7 +87,7 @@ void Scene::LoadFromFile(const char* pFile)
 	mGameObjectEditorTransform	= &mGameObjects[mCurrentEditorGOIdx]->mTransform;
 	mGameObjectEditorName		= mGameObjects[mCurrentEditorGOIdx]->mName;
 	mGameObjectEditorRot		= TwQuaternion(mGameObjectEditorTransform->Rotation);
-	mGameObjectEditorPos		= mGameObjectEditorTransform->Position;
+	mGameObjectEditorPos		= Vector3(mGameObjectEditorTransform->Position);
 	mGameObjectEditorScale		= mGameObjectEditorTransform->Scale;
 	mGameObjectEditorColor		= mGameObjects[mCurrentEditorGOIdx]->mDrawable.mGizmoColor;
 }
@@ -83,6 +98,8 @@ void Scene::Init()
 	mEditorGameobject = rje_new GameObject();
 #if (RJE_GRAPHIC_API == DIRECTX_11)
 	mEditorGameobject->mDrawable.mGizmo = rje_new DX11Mesh;
+#elif (RJE_GRAPHIC_API == NULL_RENDER)
+	mEditorGameobject->mDrawable.mGizmo = rje_new NullMesh;
 #else
 	mEditorGameobject->mDrawable.mGizmo = rje_new OglMesh;
 #endif
@@ -104,12 +121,14 @@ void Scene::ChangeCurrentEditorGO(u32& idx)
 	mGameObjectEditorTransform	= &mGameObjects[mCurrentEditorGOIdx]->mTransform;
 	mGameObjectEditorName		= mGameObjects[mCurrentEditorGOIdx]->mName;
 	mGameObjectEditorRot		= TwQuaternion(mGameObjectEditorTransform->Rotation);
-	mGameObjectEditorPos		= mGameObjectEditorTransform->Position;
+	mGameObjectEditorPos		= Vector3(mGameObjectEditorTransform->Position);
 	mGameObjectEditorScale		= mGameObjectEditorTransform->Scale;
 	mGameObjectEditorColor		= mGameObjects[mCurrentEditorGOIdx]->mDrawable.mGizmoColor;
 }
 
 //////////////////////////////////////////////////////////////////////////
+// The bounds are gathered relative to the render origin, in floats that
+// stay small near the camera, only the center goes back to world precision.
 void Scene::ComputeSceneExtents()
 {
 	Vector3 mSceneMin = Vector3(RJE::Math::Infinity_f, RJE::Math::Infinity_f, RJE::Math::Infinity_f);
@@ -125,15 +144,15 @@ void Scene::ComputeSceneExtents()
 				Vector3 maxAABB = gameobject->mDrawable.mMesh->mSubsets[iSubset].mCenter + gameobject->mDrawable.mMesh->mSubsets[iSubset].mExtents;
 				minAABB = Vector3::Scale(minAABB, gameobject->mTransform.Scale);
 				maxAABB = Vector3::Scale(maxAABB, gameobject->mTransform.Scale);
-				minAABB += gameobject->mTransform.Position;
-				maxAABB += gameobject->mTransform.Position;
+				minAABB += Transform::ToRenderSpace(gameobject->mTransform.Position);
+				maxAABB += Transform::ToRenderSpace(gameobject->mTransform.Position);
 				mSceneMin = Vector3::Min(mSceneMin, minAABB);
 				mSceneMax = Vector3::Max(mSceneMax, maxAABB);
 			}
 		}
 	}
 
-	mSceneCenter  = 0.5f*(mSceneMin+mSceneMax);
+	mSceneCenter  = Transform::sRenderOrigin + WorldPosition(0.5f*(mSceneMin+mSceneMax));
 	mSceneExtents = 0.5f*(mSceneMax-mSceneMin);
 	mSceneRadius  = mSceneExtents.Magnitude();
 }
@@ -144,10 +163,24 @@ void Scene::Update()
 	if (mCurrentEditorGOIdx != mCurrentEditorGOIdxUI)
 		ChangeCurrentEditorGO(mCurrentEditorGOIdxUI);
 
-	mGameObjectEditorTransform->Position			= mGameObjectEditorPos;
+	// The UI works in floats: only write back an actual edit so a far away
+	// double position doesn't get truncated every frame.
+	if (mGameObjectEditorPos != Vector3(mGameObjectEditorTransform->Position))
+		mGameObjectEditorTransform->Position		= WorldPosition(mGameObjectEditorPos);
 	mGameObjectEditorTransform->Rotation			= mGameObjectEditorRot;
 	mGameObjectEditorTransform->Scale				= mGameObjectEditorScale;
+	mGameObjects[mCurrentEditorGOIdx]->mDrawable.mGizmoColor = mGameObjectEditorColor;
+
+#if RJE_DOUBLE_PRECISION
+	// The render origin moves with the camera: rebuild every camera-relative
+	// world matrix (float math once the double subtraction is done).
+	for(const unique_ptr<GameObject>& gameobject : mGameObjects)
+	{
+		gameobject->mTransform.WorldMat			= gameobject->mTransform.WorldMatrix();
+		gameobject->mTransform.WorldMatNoScale	= gameobject->mTransform.WorldMatrixNoScale();
+	}
+#else
 	mGameObjectEditorTransform->WorldMat			= mGameObjectEditorTransform->WorldMatrix();
 	mGameObjectEditorTransform->WorldMatNoScale		= mGameObjectEditorTransform->WorldMatrixNoScale();
-	mGameObjects[mCurrentEditorGOIdx]->mDrawable.mGizmoColor = mGameObjectEditorColor;
+#endif
 }
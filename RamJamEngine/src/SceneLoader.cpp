@@ -1,5 +1,5 @@
 #include "SceneLoader.h"
-#include "System.h"
+#include "stdafx.h"
 
 using namespace rapidxml;
 
@@ -8,7 +8,7 @@ void SceneLoader::LoadFromFile( const char* pFilename, std::vector<unique_ptr<Ga
 {
 	gameobjects.resize(0);
 
-	file<>			xmlFile(pFilename);
+	file<>			xmlFile(FileSystem::NativePath(pFilename).c_str());
 	xml_document<>	xmlDoc;
 	
 	xmlDoc.parse<0>(xmlFile.data());    // 0 means default parse flags
@@ -48,13 +48,15 @@ void SceneLoader::ExtractGameObjects(xml_node<>* gameobjectNode, std::vector<uni
 		{
 #if (RJE_GRAPHIC_API == DIRECTX_11)
 			gameobject->mDrawable.mMesh = rje_new DX11Mesh;
+#elif (RJE_GRAPHIC_API == NULL_RENDER)
+			gameobject->mDrawable.mMesh = rje_new NullMesh;
 #else
 			gameobject->mDrawable.mMesh = rje_new OglMesh;
 #endif
 			//===== FILE ===
 			if (strcmp(node->first_node()->name(), "file") == 0)
 			{
-				string meshPath     = System::Instance()->mDataPath + "models\\" + string(node->first_node()->value());
+				string meshPath     = RJE_GLOBALS::gDataPath + "models\\" + string(node->first_node()->value());
 				string materialFile = string(node->first_node()->next_sibling()->value());
 				gameobject->mDrawable.mMesh->LoadModelFromFile(meshPath);
 				gameobject->mDrawable.mMesh->LoadMaterialLibraryFromFile(materialFile);
@@ -78,6 +80,8 @@ void SceneLoader::ExtractGameObjects(xml_node<>* gameobjectNode, std::vector<uni
 		{
 #if (RJE_GRAPHIC_API == DIRECTX_11)
 			gameobject->mDrawable.mGizmo = rje_new DX11Mesh;
+#elif (RJE_GRAPHIC_API == NULL_RENDER)
+			gameobject->mDrawable.mGizmo = rje_new NullMesh;
 #else
 			gameobject->mDrawable.mGizmo = rje_new OglMesh;
 #endif
@@ -323,6 +327,16 @@ void SceneLoader::ExtractParameters(xml_node<>* node, float& f1, float& f2, floa
 void SceneLoader::ExtractParameters(xml_node<>* node, Vector3& v)
 { ExtractParameters(node, v.x, v.y, v.z); }
 
+//////////////////////////////////////////////////////////////////////////
+// Full precision read for double world positions
+void SceneLoader::ExtractParameters(xml_node<>* node, Vector3d& v)
+{
+	xml_attribute<> *attr = node->first_attribute();
+	v.x = atof(attr->value());		attr = attr->next_attribute();
+	v.y = atof(attr->value());		attr = attr->next_attribute();
+	v.z = atof(attr->value());
+}
+
 //////////////////////////////////////////////////////////////////////////
 void SceneLoader::ExtractParameters(xml_node<>* node, Vector3& v1, Vector3& v2)
 {
@@ -0,0 +1,113 @@
+#include "ShadowCache.h"
+
+//////////////////////////////////////////////////////////////////////////
+ShadowMapCache::ShadowMapCache()
+	: mbEnabled(true)
+	, mbUseLayers(true)
+	, mReused(0)
+	, mStaticReused(0)
+{
+	Invalidate();
+}
+
+//////////////////////////////////////////////////////////////////////////
+void ShadowMapCache::Invalidate()
+{
+	for (u32 p = 0; p < PARTITIONS; ++p)
+	{
+		mEntries[p].mbValid       = false;
+		mEntries[p].mbStaticValid = false;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+void ShadowMapCache::BeginFrame(u32 casterCount)
+{
+	// Objects added or removed: the indices in the keys don't mean the same thing anymore
+	if (mCasters.size() != casterCount)
+	{
+		Caster moved = { 0, 0 };
+		mCasters.assign(casterCount, moved);
+		Invalidate();
+	}
+
+	for (u32 p = 0; p < PARTITIONS; ++p)
+	{
+		mStaticKeys[p]  = StateHash();
+		mDynamicKeys[p] = StateHash();
+	}
+	mReused       = 0;
+	mStaticReused = 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void ShadowMapCache::UpdateCaster(u32 caster, const Matrix44& world)
+{
+	StateHash hash;
+	hash.Add(world);
+
+	Caster& state = mCasters[caster];
+	if (state.mTransformHash == hash.mValue)
+	{
+		if (state.mUnchangedFrames < StaticFrames)
+			++state.mUnchangedFrames;
+	}
+	else
+	{
+		state.mTransformHash   = hash.mValue;
+		state.mUnchangedFrames = 0;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+void ShadowMapCache::AddCaster(u32 caster, u32 subset, u32 partitionMask)
+{
+	// A caster moving to the other layer changes both layers' keys
+	StateHash* keys = IsStatic(caster) ? mStaticKeys : mDynamicKeys;
+	for (u32 p = 0; p < PARTITIONS; ++p)
+	{
+		if (!(partitionMask & (1u << p)))
+			continue;
+
+		keys[p].Add(caster);
+		keys[p].Add(subset);
+		keys[p].Add(mCasters[caster].mTransformHash);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+ShadowCacheAction ShadowMapCache::Update(u32 partition, u64 partitionKey)
+{
+	Entry& entry = mEntries[partition];
+	if (!mbEnabled)
+	{
+		entry.mbValid       = false;
+		entry.mbStaticValid = false;
+		return ShadowCache_RenderAll;
+	}
+
+	u64  staticKey   = mStaticKeys[partition].mValue;
+	u64  dynamicKey  = mDynamicKeys[partition].mValue;
+	BOOL bSameStatic = (entry.mPartitionKey == partitionKey && entry.mStaticKey == staticKey);
+
+	ShadowCacheAction action = ShadowCache_RenderAll;
+	if (entry.mbValid && bSameStatic && entry.mDynamicKey == dynamicKey)
+	{
+		action = ShadowCache_Reuse;
+		++mReused;
+	}
+	else if (UsesLayers() && entry.mbStaticValid && bSameStatic)
+	{
+		action = ShadowCache_DynamicOnly;
+		++mStaticReused;
+	}
+
+	entry.mPartitionKey = partitionKey;
+	entry.mStaticKey    = staticKey;
+	entry.mDynamicKey   = dynamicKey;
+	entry.mbValid       = true;
+	// Only a full render stores the static layer, the other paths keep it as it was
+	if (action == ShadowCache_RenderAll)
+		entry.mbStaticValid = UsesLayers();
+	return action;
+}
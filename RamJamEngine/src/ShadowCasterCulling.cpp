@@ -0,0 +1,247 @@
+#include "ShadowCasterCulling.h"
+
+#include <math.h>
+
+namespace
+{
+	const u32 kAllPartitions = (1u << PARTITIONS) - 1;
+
+	//----------------------------------------------------------------------
+	FORCEINLINE Vector3 TransformPoint(const Vector3& p, const Matrix44& m)
+	{
+		return Vector3(	p.x*m.m11 + p.y*m.m21 + p.z*m.m31 + m.m41,
+						p.x*m.m12 + p.y*m.m22 + p.z*m.m32 + m.m42,
+						p.x*m.m13 + p.y*m.m23 + p.z*m.m33 + m.m43);
+	}
+	//----------------------------------------------------------------------
+	// One axis of ComputePartitionDataFromBounds, before the empty partition test
+	FORCEINLINE void PartitionAxis(f32 minTexCoord, f32 maxTexCoord, f32 border, f32 maxScale, f32 dilation, f32& scale, f32& bias)
+	{
+		minTexCoord -= border;
+		maxTexCoord += border;
+
+		scale = 1.0f / (maxTexCoord - minTexCoord);
+		bias  = -minTexCoord * scale;
+
+		f32 oneMinusTwoFactor = 1.0f - 2.0f * dilation;
+		scale *= oneMinusTwoFactor;
+		bias   = dilation + oneMinusTwoFactor * bias;
+
+		// Clamp scale, but remain centered
+		f32 clampedScale = scale < maxScale ? scale : maxScale;
+		bias  = (clampedScale / scale) * (bias - 0.5f) + 0.5f;
+		scale = clampedScale;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+ShadowCasterCuller::ShadowCasterCuller()
+	: mActiveMask(kAllPartitions)
+	, mbValid(false)
+{
+	ResetStats();
+}
+
+//////////////////////////////////////////////////////////////////////////
+void ShadowCasterCuller::ResetStats()
+{
+	for (u32 p = 0; p < PARTITIONS; ++p)
+		mCasters[p] = 0;
+	mCandidates = 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void ShadowCasterCuller::SetPartitions(const ShadowPartition* partitions, f32 margin)
+{
+	mActiveMask = 0;
+	for (u32 p = 0; p < PARTITIONS; ++p)
+	{
+		const Vector3& scale = partitions[p].mScale;
+		const Vector3& bias  = partitions[p].mBias;
+
+		// Empty partitions get a huge scale (asfloat(0x7F7FFFFF) in sdsm.fx)
+		if (!(scale.x > 0.0f && scale.y > 0.0f && scale.z > 0.0f) || scale.x >= RJE::Math::Infinity_f)
+			continue;
+		mActiveMask |= 1u << p;
+
+		// Texture coordinates the partition keeps: t*scale + bias in [0,1]
+		Vector3 tMin = (Vector3::zero - bias) / scale;
+		Vector3 tMax = (Vector3::one  - bias) / scale;
+
+		// To light clip space: x = 2t-1, y = 1-2t (flipped), z = t
+		Vector3 clipMin(2.0f*tMin.x - 1.0f, 1.0f - 2.0f*tMax.y, tMin.z);
+		Vector3 clipMax(2.0f*tMax.x - 1.0f, 1.0f - 2.0f*tMin.y, tMax.z);
+
+		Vector3 grow = (clipMax - clipMin) * margin;
+		mMin[p] = clipMin - grow;
+		mMax[p] = clipMax + grow;
+	}
+	mbValid = true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+u32 ShadowCasterCuller::PartitionMask(const AABB& casterLightClip) const
+{
+	if (!mbValid)
+		return kAllPartitions;
+
+	Vector3 casterMin = casterLightClip.Min();
+	Vector3 casterMax = casterLightClip.Max();
+
+	u32 mask = 0;
+	for (u32 p = 0; p < PARTITIONS; ++p)
+	{
+		if (!(mActiveMask & (1u << p)))
+			continue;
+
+		// No test against mMin[p].z: casters toward the light still shadow the volume
+		if (casterMax.x >= mMin[p].x && casterMin.x <= mMax[p].x &&
+			casterMax.y >= mMin[p].y && casterMin.y <= mMax[p].y &&
+			casterMin.z <= mMax[p].z)
+			mask |= 1u << p;
+	}
+	return mask;
+}
+
+//////////////////////////////////////////////////////////////////////////
+u32 ShadowCasterCuller::AddCaster(const AABB& casterLightClip)
+{
+	u32 mask = PartitionMask(casterLightClip);
+
+	++mCandidates;
+	for (u32 p = 0; p < PARTITIONS; ++p)
+		mCasters[p] += (mask >> p) & 1;
+
+	return mask;
+}
+
+//////////////////////////////////////////////////////////////////////////
+AABB ShadowCasterCuller::CasterBounds(const Vector3& center, const Vector3& extents, const Matrix44& worldLightViewProj)
+{
+	return AABB(center, extents).Transform(worldLightViewProj);
+}
+
+//////////////////////////////////////////////////////////////////////////
+ShadowPartition ShadowCasterCuller::PartitionFromBounds(const Vector3& minTexCoord, const Vector3& maxTexCoord,
+														const Vector3& lightSpaceBorder, const Vector3& maxScale, f32 dilation)
+{
+	ShadowPartition partition;
+	PartitionAxis(minTexCoord.x, maxTexCoord.x, lightSpaceBorder.x, maxScale.x, dilation, partition.mScale.x, partition.mBias.x);
+	PartitionAxis(minTexCoord.y, maxTexCoord.y, lightSpaceBorder.y, maxScale.y, dilation, partition.mScale.y, partition.mBias.y);
+	PartitionAxis(minTexCoord.z, maxTexCoord.z, lightSpaceBorder.z, maxScale.z, dilation, partition.mScale.z, partition.mBias.z);
+
+	// Empty bounds (min > max): a tiny region that no geometry overlaps
+	if (partition.mScale.x < 0.0f)
+	{
+		const f32 maxFloat = RJE::Math::Infinity_f;
+		partition.mScale = Vector3(maxFloat, maxFloat, maxFloat);
+		partition.mBias  = partition.mScale;
+	}
+	return partition;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void ShadowCasterCuller::EstimatePartitions(const Matrix44& cameraView, f32 fovY, f32 aspectRatio, f32 minZ, f32 maxZ,
+											const Matrix44& lightViewProj, const Vector3& lightSpaceBorder, const Vector3& maxScale,
+											f32 dilation, OUT ShadowPartition* outPartitions)
+{
+	Matrix44 cameraWorld = cameraView;
+	cameraWorld.Inverse();
+	Matrix44 viewToLightProj = cameraWorld * lightViewProj;
+
+	// Nothing to shadow
+	if (minZ > maxZ)
+	{
+		const f32 maxFloat = RJE::Math::Infinity_f;
+		for (u32 p = 0; p < PARTITIONS; ++p)
+		{
+			outPartitions[p].mScale = Vector3(maxFloat, maxFloat, maxFloat);
+			outPartitions[p].mBias  = outPartitions[p].mScale;
+		}
+		return;
+	}
+	minZ = RJE::Math::Max(minZ, 1e-3f);
+
+	f32 tanY  = tanf(0.5f * fovY);
+	f32 tanX  = tanY * aspectRatio;
+	f32 ratio = maxZ / minZ;
+
+	for (u32 p = 0; p < PARTITIONS; ++p)
+	{
+		// Same logarithmic split as LogPartitionFromRange (sdsm.fx)
+		f32 sliceZ[2] = {	minZ * powf(ratio, static_cast<f32>(p)     / PARTITIONS),
+							minZ * powf(ratio, static_cast<f32>(p + 1) / PARTITIONS) };
+
+		Vector3 minTexCoord( RJE::Math::Infinity_f,  RJE::Math::Infinity_f,  RJE::Math::Infinity_f);
+		Vector3 maxTexCoord(-RJE::Math::Infinity_f, -RJE::Math::Infinity_f, -RJE::Math::Infinity_f);
+		for (u32 corner = 0; corner < 8; ++corner)
+		{
+			f32 z = sliceZ[corner >> 2];
+			Vector3 positionView((corner & 1) ? z*tanX : -z*tanX, (corner & 2) ? z*tanY : -z*tanY, z);
+
+			// ProjectIntoLightTexCoord (Rendering.hlsl)
+			Vector3 clip = TransformPoint(positionView, viewToLightProj);
+			Vector3 texCoord(0.5f*clip.x + 0.5f, -0.5f*clip.y + 0.5f, clip.z);
+
+			minTexCoord = Vector3::Min(minTexCoord, texCoord);
+			maxTexCoord = Vector3::Max(maxTexCoord, texCoord);
+		}
+
+		outPartitions[p] = PartitionFromBounds(minTexCoord, maxTexCoord, lightSpaceBorder, maxScale, dilation);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+void PartitionReadbackQueue::Reset()
+{
+	for (u32 i = 0; i < Slots; ++i)
+	{
+		mbPending[i]    = false;
+		mQueuedFrame[i] = 0;
+	}
+	mFrame = 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+u32 PartitionReadbackQueue::Pending(OUT u32* slots) const
+{
+	u32 count = 0;
+	for (u32 i = 0; i < Slots; ++i)
+	{
+		if (!mbPending[i])
+			continue;
+		u32 j = count++;
+		for (; j > 0 && mQueuedFrame[slots[j - 1]] > mQueuedFrame[i]; --j)
+			slots[j] = slots[j - 1];
+		slots[j] = i;
+	}
+	return count;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void PartitionReadbackQueue::Landed(u32 slot)
+{
+	for (u32 i = 0; i < Slots; ++i)
+	{
+		if (mbPending[i] && mQueuedFrame[i] <= mQueuedFrame[slot])
+			mbPending[i] = false;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+u32 PartitionReadbackQueue::FreeSlot() const
+{
+	for (u32 i = 0; i < Slots; ++i)
+	{
+		if (!mbPending[i])
+			return i;
+	}
+	return Slots;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void PartitionReadbackQueue::Queue(u32 slot)
+{
+	mbPending[slot]    = true;
+	mQueuedFrame[slot] = ++mFrame;
+}
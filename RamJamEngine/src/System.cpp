@@ -64,11 +64,14 @@ BOOL System::Initialize(int nCmdShow)
 {
 	HACCEL hAccelTable;
 
-	mResourcesPath = "../data/Resources.ini";
-	mDataPath = CIniFile::GetValue("datapath", "repositories", mResourcesPath);
+	RJE_GLOBALS::gResourcesPath = "../data/Resources.ini";
+	RJE_GLOBALS::gDataPath      = CIniFile::GetValue("datapath", "repositories", RJE_GLOBALS::gResourcesPath);
 
 	// Initialize all the globals defined in the .ini files
-	LoadConfigFile();
+	RJE_GLOBALS::LoadConfigFile("../data/Config.ini");
+
+	// Typed characters go to the console while it is open
+	Input::Instance()->SetTextInputHandler(Console::OnTextInput);
 
 	// Initialize global strings
 	LoadString(mHInst, IDS_APP_TITLE, mSzTitle, 100);
@@ -82,7 +85,7 @@ BOOL System::Initialize(int nCmdShow)
 	mGraphicAPI->Initialize(mScreenWidth, mScreenHeight);
 
 	// Load the Scene file
-	string scenePath = mDataPath + CIniFile::GetValue("scene", "scenes", mResourcesPath);
+	string scenePath = RJE_GLOBALS::gDataPath + CIniFile::GetValue("scene", "scenes", RJE_GLOBALS::gResourcesPath);
 	mScene.LoadFromFile(scenePath.c_str());
 	mScene.Init();
 	mGraphicAPI->LoadSkybox(mScene.mSkyboxName);
@@ -106,6 +109,8 @@ void System::Shutdown()
 	Input::   DeleteInstance();
 	Console:: DeleteInstance();
 	Profiler::DeleteInstance();
+	FrameArena::DeleteInstance();
+	MemoryBudget::DeleteInstance();
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -115,6 +120,15 @@ void System::Run()
 	ZeroMemory(&msg, sizeof(MSG));
 
 	Timer::Instance()->Start();
+	Profiler::Instance()->SetThreadName("Main");
+	Profiler::Instance()->SetSpikeCapture((float)RJE_GLOBALS::gSpikeThresholdMs, "profiler_spikes.txt");
+	if (RJE_GLOBALS::gHardwareCounters && !Profiler::Instance()->SetHardwareCounters(true))
+		RJE_PRINT("Hardware counters not available\n");
+
+	mFrameScheduler.mbFixedStep   = RJE_GLOBALS::gFixedStep;
+	mFrameScheduler.mFixedStep    = 1.0f / (RJE_GLOBALS::gFixedStepRate > 0 ? RJE_GLOBALS::gFixedStepRate : 60);
+	mFrameScheduler.mMaxFrameRate = (float)RJE_GLOBALS::gMaxFrameRate;
+	mFrameScheduler.Reset();
 
 	float processRefreshRate = 0.0f;	// the refresh rate in seconds for measurements only
 
@@ -137,20 +151,24 @@ void System::Run()
 				processRefreshRate = 0.0f;
 			}
 
+			Profiler::Instance()->CollectFrame();
 			FeedProfilerInfo();
 
+			// Waits for the frame rate limit (the paused one too), out of the frame's profile
+			mFrameScheduler.mTimeScale = Timer::Instance()->TimeScale();
+			u32 steps = mFrameScheduler.BeginFrame(mAppPaused);
+			FrameArena::Instance()->BeginFrame();
+
 			PROFILE_CPU("Frame");
 			Timer::Instance()->Update();
 
 			if (!Console::Instance()->IsActive())
 				HandleInputs();
 
-			if(mAppPaused)
-				Sleep(50);
-			else
+			if(!mAppPaused)
 			{
 				CalculateFrameStats();
-				UpdateScene(Timer::Instance()->DeltaTime());
+				UpdateScene(mFrameScheduler.StepTime(), steps);
 				DrawScene();
 
 				Console::Instance()->Update();
@@ -158,6 +176,7 @@ void System::Run()
 				
 				Input::Instance()->ResetInputStates();
 			}
+			mFrameScheduler.EndFrame();
 		}
 	}
 }
@@ -295,12 +314,26 @@ LRESULT CALLBACK System::MessageHandler(HWND hwnd, UINT umsg, WPARAM wparam, LPA
 }
 
 //////////////////////////////////////////////////////////////////////////
-BOOL System::UpdateScene(float dt)
+// The scene and the camera follow the inputs once per frame, the rendering
+// API's animations advance by steps of dt (none when the fixed step
+// accumulator is short of a step), then are placed between the last two
+// steps for the frame.
+BOOL System::UpdateScene(float dt, u32 steps)
 {
 	PROFILE_CPU("Update Scene");
+#if RJE_DOUBLE_PRECISION
+	// Re-center on last frame's camera position: the camera itself then only
+	// sits one frame of movement away from the origin.
+	Transform::sRenderOrigin = mGraphicAPI->mCamera->mTrf.Position;
+#endif
 	mScene.Update();
-	mGraphicAPI->mCamera->Update();
-	mGraphicAPI->UpdateScene(dt);
+	if (!Console::Instance()->IsActive())
+		mGraphicAPI->mCamera->Update();
+	for (u32 step = 0; step < steps; ++step)
+	{
+		mGraphicAPI->UpdateScene(dt);
+	}
+	mGraphicAPI->UpdateFrame(mFrameScheduler.Alpha());
 	return true;
 }
 
@@ -466,34 +499,6 @@ void System::HandleInputs()
 	if (Input::Instance()->GetMouseButtonAnyUp())		ReleaseCapture();
 }
 
-//////////////////////////////////////////////////////////////////////////
-void System::LoadConfigFile()
-{
-	const char* filename = "../data/Config.ini";
-	std::ifstream iFile(filename);
-	if (!iFile)
-	{
-		CIniFile::Create(filename);
-
-		CIniFile::SetValue("fullscreen",   "false", "rendering", filename);
-		CIniFile::SetValue("screenwidth",  "1280",  "rendering", filename);
-		CIniFile::SetValue("screenheight", "720",   "rendering", filename);
-		//---------------
-		CIniFile::SetValue("runinbackground", "true", "misc", filename);
-		//---------------
-		CIniFile::SetValue("debugverbosity", "0",    "debug", filename);
-		CIniFile::SetValue("showcursor",     "true", "debug", filename);
-	}
-	RJE_GLOBALS::gFullScreen			= CIniFile::GetValueBool("fullscreen",  "rendering", filename);
-	RJE_GLOBALS::gScreenWidth			= CIniFile::GetValueInt("screenwidth",  "rendering", filename);
-	RJE_GLOBALS::gScreenHeight			= CIniFile::GetValueInt("screenheight", "rendering", filename);
-	//---------------
-	RJE_GLOBALS::gRunInBackground		= CIniFile::GetValueBool("runinbackground", "misc", filename);
-	//---------------
-	RJE_GLOBALS::gDebugVerbosity		= CIniFile::GetValueInt("debugverbosity", "debug", filename);
-	RJE_GLOBALS::gShowCursor			= CIniFile::GetValueBool("showcursor",    "debug", filename);
-}
-
 //////////////////////////////////////////////////////////////////////////
 i16 System::GetProcessCpuUsage()
 {
@@ -591,6 +596,18 @@ void System::FeedProfilerInfo()
 	Profiler::Instance()->mProfilerInfos->ProcessCpuUsage       = mProcessCpuUsage;
 	Profiler::Instance()->mProfilerInfos->ProcessPeakWorkingSet = (i16)(mProcessMemoryCounters.PeakWorkingSetSize/ 1048576);
 	Profiler::Instance()->mProfilerInfos->ProcessWorkingSet     = (i16)(mProcessMemoryCounters.WorkingSetSize/ 1048576);
+	//---------------
+	Profiler::Instance()->mProfilerInfos->FrameWorkMs           = mFrameScheduler.mWorkMs;
+	Profiler::Instance()->mProfilerInfos->FrameWaitMs           = mFrameScheduler.mWaitMs;
+	Profiler::Instance()->mProfilerInfos->FrameBudgetMs         = mFrameScheduler.BudgetMs();
+	Profiler::Instance()->mProfilerInfos->FrameOverBudget       = mFrameScheduler.mOverBudgetFrames;
+	Profiler::Instance()->mProfilerInfos->FixedSteps            = mFrameScheduler.mSteps;
+	Profiler::Instance()->mProfilerInfos->FixedStepAlpha        = mFrameScheduler.Alpha();
+	Profiler::Instance()->mProfilerInfos->FixedStepDroppedMs    = mFrameScheduler.mDroppedMs;
+	//---------------
+	Profiler::Instance()->mProfilerInfos->FrameArenaBytes       = (u32)FrameArena::Instance()->LastFrameBytes();
+	Profiler::Instance()->mProfilerInfos->FrameArenaPeakBytes   = (u32)FrameArena::Instance()->PeakFrameBytes();
+	Profiler::Instance()->mProfilerInfos->FrameArenaOverflows   = FrameArena::Instance()->Overflows();
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,264 @@
+#include "TiledLightCulling.h"
+
+#include <math.h>
+#include <float.h>
+
+namespace
+{
+	//----------------------------------------------------------------------
+	FORCEINLINE Vector3 TransformPoint(const Vector3& p, const Matrix44& m)
+	{
+		return Vector3(	p.x*m.m11 + p.y*m.m21 + p.z*m.m31 + m.m41,
+						p.x*m.m12 + p.y*m.m22 + p.z*m.m32 + m.m42,
+						p.x*m.m13 + p.y*m.m23 + p.z*m.m33 + m.m43);
+	}
+	//----------------------------------------------------------------------
+	// View space direction through pixel (px, py), at z = 1. Pixel rows go down, NDC y goes up.
+	FORCEINLINE Vector3 PixelRay(f32 px, f32 py, u32 width, u32 height, const Matrix44& proj)
+	{
+		return Vector3(	(2.0f * px / width - 1.0f) / proj.m11,
+						(1.0f - 2.0f * py / height) / proj.m22,
+						1.0f);
+	}
+	//----------------------------------------------------------------------
+	// Plane through the eye and two corner rays, facing inside
+	Plane SidePlane(const Vector3& a, const Vector3& b, const Vector3& inside)
+	{
+		Plane plane(Vector3::Cross(a, b), 0.0f);
+		plane.Normalize();
+		if (plane.Distance(inside) < 0.0f)
+		{
+			plane.normal = -plane.normal;
+		}
+		return plane;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+TiledLightCulling::TiledLightCulling()
+	: mTileDim(COMPUTE_SHADER_TILE_GROUP_DIM)
+	, mTilesX(0), mTilesY(0)
+{
+}
+
+//////////////////////////////////////////////////////////////////////////
+void TiledLightCulling::Resize(u32 width, u32 height, u32 tileDim)
+{
+	RJE_ASSERT(width > 0 && height > 0 && tileDim > 0);
+
+	// Same dispatch as ComputeShaderTileCS: tiles can span the screen edges
+	mTileDim = tileDim;
+	mTilesX  = (width  + tileDim - 1) / tileDim;
+	mTilesY  = (height + tileDim - 1) / tileDim;
+
+	u32 tiles = mTilesX*mTilesY;
+	mTileMinZ.assign(tiles, FLT_MAX);
+	mTileMaxZ.assign(tiles, 0.0f);
+	mTiles.resize(tiles);
+	mLightIndices.clear();
+}
+
+//////////////////////////////////////////////////////////////////////////
+void TiledLightCulling::ReduceDepthBounds(const f32* viewZ, u32 width, u32 height, f32 nearZ, f32 farZ)
+{
+	// Per pixel, then scattered to the tile like the InterlockedMin/Max on sMinZ/sMaxZ.
+	// The per pixel bounds start at (far, near): a sample past the far plane
+	// gives (far, z), and only pixels with a valid sample are scattered.
+	for (u32 y = 0; y < height; ++y)
+	{
+		const f32* row  = viewZ + y*width;
+		u32        tile = (y / mTileDim) * mTilesX;
+		for (u32 x = 0; x < width; ++x)
+		{
+			f32 z = row[x];
+			if (z == RJE::Math::Infinity_f)
+				continue;
+
+			u32 t = tile + x / mTileDim;
+			mTileMinZ[t] = RJE::Math::Min(mTileMinZ[t], RJE::Math::Min(farZ,  z));
+			mTileMaxZ[t] = RJE::Math::Max(mTileMaxZ[t], RJE::Math::Max(nearZ, z));
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+void TiledLightCulling::TileFrustum(const Matrix44& proj, u32 width, u32 height, u32 tileDim, u32 tileX, u32 tileY,
+									f32 minTileZ, f32 maxTileZ, OUT Plane outPlanes[6])
+{
+	// Work out scale/bias so that this tile maps to [-1, 1]
+	f32 tileScaleX = width  / static_cast<f32>(tileDim);
+	f32 tileScaleY = height / static_cast<f32>(tileDim);
+	f32 tileBiasX  = tileScaleX - 2.0f * tileX - 1.0f;
+	f32 tileBiasY  = tileScaleY - 2.0f * tileY - 1.0f;
+
+	// Relevant columns of the tile's projection: c1 = (x, 0, z), c2 = (0, y, z), c4 = (0, 0, 1)
+	f32 c1x = proj.m11 * tileScaleX;
+	f32 c2y = -proj.m22 * tileScaleY;
+
+	outPlanes[0] = Plane(-c1x, 0.0f, 1.0f - tileBiasX, 0.0f);
+	outPlanes[1] = Plane( c1x, 0.0f, 1.0f + tileBiasX, 0.0f);
+	outPlanes[2] = Plane(0.0f, -c2y, 1.0f - tileBiasY, 0.0f);
+	outPlanes[3] = Plane(0.0f,  c2y, 1.0f + tileBiasY, 0.0f);
+	outPlanes[4] = Plane(0.0f, 0.0f,  1.0f, -minTileZ);
+	outPlanes[5] = Plane(0.0f, 0.0f, -1.0f,  maxTileZ);
+
+	// The shader multiplies by rcp(length): not Plane::Normalize(), but close enough to the bit
+	for (u32 i = 0; i < 4; ++i)
+	{
+		f32 rcpLength = 1.0f / sqrtf(outPlanes[i].normal.x*outPlanes[i].normal.x + outPlanes[i].normal.y*outPlanes[i].normal.y + outPlanes[i].normal.z*outPlanes[i].normal.z);
+		outPlanes[i].normal = outPlanes[i].normal * rcpLength;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+void TiledLightCulling::Cull(	const f32* viewZ, u32 width, u32 height, const Matrix44& view, const Matrix44& proj, f32 nearZ, f32 farZ,
+								const PointLight* lights, u32 lightCount, u32 tileDim)
+{
+	Resize(width, height, tileDim);
+	ReduceDepthBounds(viewZ, width, height, nearZ, farZ);
+
+	std::vector<Vector3> lightPositions(lightCount);
+	for (u32 i = 0; i < lightCount; ++i)
+	{
+		lightPositions[i] = TransformPoint(lights[i].Position, view);
+	}
+
+	// Same result as the shader's 6 tests in a row, near/far first: they reject the most
+	static const u32 planeOrder[6] = { 4, 5, 0, 1, 2, 3 };
+
+	Plane planes[6];
+	for (u32 y = 0; y < mTilesY; ++y)
+	{
+		for (u32 x = 0; x < mTilesX; ++x)
+		{
+			u32 tile = y*mTilesX + x;
+			mTiles[tile].mOffset = static_cast<u32>(mLightIndices.size());
+			mTiles[tile].mCount  = 0;
+
+			// No geometry: the near plane at FLT_MAX rejects every light
+			if (mTileMinZ[tile] > mTileMaxZ[tile])
+				continue;
+
+			TileFrustum(proj, width, height, tileDim, x, y, mTileMinZ[tile], mTileMaxZ[tile], planes);
+			for (u32 light = 0; light < lightCount; ++light)
+			{
+				BOOL inFrustum = true;
+				for (u32 i = 0; i < 6 && inFrustum; ++i)
+				{
+					inFrustum = planes[planeOrder[i]].Distance(lightPositions[light]) >= -lights[light].Range;
+				}
+				if (inFrustum)
+				{
+					mLightIndices.push_back(light);
+				}
+			}
+			mTiles[tile].mCount = static_cast<u32>(mLightIndices.size()) - mTiles[tile].mOffset;
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+void TiledLightCulling::CullBruteForce(	const f32* viewZ, u32 width, u32 height, const Matrix44& view, const Matrix44& proj, f32 nearZ, f32 farZ,
+										const PointLight* lights, u32 lightCount, u32 tileDim)
+{
+	Resize(width, height, tileDim);
+
+	for (u32 y = 0; y < mTilesY; ++y)
+	{
+		for (u32 x = 0; x < mTilesX; ++x)
+		{
+			u32 tile = y*mTilesX + x;
+
+			// Depth bounds, gathered per tile this time
+			u32 px0 = x*tileDim, px1 = RJE::Math::Min(px0 + tileDim, width);
+			u32 py0 = y*tileDim, py1 = RJE::Math::Min(py0 + tileDim, height);
+			for (u32 py = py0; py < py1; ++py)
+			{
+				for (u32 px = px0; px < px1; ++px)
+				{
+					f32 z = viewZ[py*width + px];
+					if (z != RJE::Math::Infinity_f)
+					{
+						mTileMinZ[tile] = RJE::Math::Min(mTileMinZ[tile], RJE::Math::Min(farZ,  z));
+						mTileMaxZ[tile] = RJE::Math::Max(mTileMaxZ[tile], RJE::Math::Max(nearZ, z));
+					}
+				}
+			}
+
+			// Side planes through the eye and the corners of the whole tile, off screen part included
+			f32 left   = static_cast<f32>(x*tileDim);
+			f32 right  = static_cast<f32>((x + 1)*tileDim);
+			f32 top    = static_cast<f32>(y*tileDim);
+			f32 bottom = static_cast<f32>((y + 1)*tileDim);
+
+			Vector3 topLeft     = PixelRay(left,  top,    width, height, proj);
+			Vector3 topRight    = PixelRay(right, top,    width, height, proj);
+			Vector3 bottomLeft  = PixelRay(left,  bottom, width, height, proj);
+			Vector3 bottomRight = PixelRay(right, bottom, width, height, proj);
+			Vector3 center      = PixelRay(0.5f*(left + right), 0.5f*(top + bottom), width, height, proj);
+
+			Plane planes[6];
+			planes[0] = SidePlane(topLeft,     bottomLeft,  center);
+			planes[1] = SidePlane(topRight,    bottomRight, center);
+			planes[2] = SidePlane(topLeft,     topRight,    center);
+			planes[3] = SidePlane(bottomLeft,  bottomRight, center);
+			planes[4] = Plane(0.0f, 0.0f,  1.0f, -mTileMinZ[tile]);
+			planes[5] = Plane(0.0f, 0.0f, -1.0f,  mTileMaxZ[tile]);
+
+			mTiles[tile].mOffset = static_cast<u32>(mLightIndices.size());
+			for (u32 light = 0; light < lightCount; ++light)
+			{
+				Vector3 p = TransformPoint(lights[light].Position, view);
+
+				// Only lights clearly in: rounding of both plane sets grows with the distances involved
+				f32 tolerance = 1e-4f * (fabsf(p.x) + fabsf(p.y) + fabsf(p.z) + lights[light].Range);
+
+				BOOL inFrustum = true;
+				for (u32 i = 0; i < 6; ++i)
+				{
+					inFrustum = inFrustum && planes[i].Distance(p) >= -lights[light].Range + tolerance;
+				}
+				if (inFrustum)
+				{
+					mLightIndices.push_back(light);
+				}
+			}
+			mTiles[tile].mCount = static_cast<u32>(mLightIndices.size()) - mTiles[tile].mOffset;
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+void TiledLightCulling::Compare(const TiledLightCulling& culled, const TiledLightCulling& bruteForce, OUT u32& missed, OUT u32& extra)
+{
+	RJE_ASSERT(culled.mTiles.size() == bruteForce.mTiles.size());
+
+	missed = 0;
+	extra  = 0;
+	for (u32 tile = 0; tile < culled.mTiles.size(); ++tile)
+	{
+		// Both lists are in light order
+		const u32* a    = culled.mLightIndices.data()     + culled.mTiles[tile].mOffset;
+		const u32* aEnd = a + culled.mTiles[tile].mCount;
+		const u32* b    = bruteForce.mLightIndices.data() + bruteForce.mTiles[tile].mOffset;
+		const u32* bEnd = b + bruteForce.mTiles[tile].mCount;
+
+		while (a != aEnd || b != bEnd)
+		{
+			if (b == bEnd || (a != aEnd && *a < *b))	{ ++extra;  ++a; }
+			else if (a == aEnd || *b < *a)				{ ++missed; ++b; }
+			else										{ ++a; ++b; }
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+void TiledLightCulling::Occupancy(OUT f32& averageLights, OUT u32& maxLights) const
+{
+	maxLights = 0;
+	for (u32 tile = 0; tile < mTiles.size(); ++tile)
+	{
+		maxLights = RJE::Math::Max(maxLights, mTiles[tile].mCount);
+	}
+	averageLights = mTiles.empty() ? 0.0f : static_cast<f32>(mLightIndices.size()) / mTiles.size();
+}
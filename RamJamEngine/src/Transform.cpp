@@ -1,5 +1,8 @@
 #include "Transform.h"
 
+//////////////////////////////////////////////////////////////////////////
+WorldPosition Transform::sRenderOrigin = WorldPosition();
+
 //////////////////////////////////////////////////////////////////////////
 Transform::Transform()
 {
@@ -9,7 +12,7 @@ Transform::Transform()
 //////////////////////////////////////////////////////////////////////////
 Matrix44 Transform::WorldMatrix()
 {
-	Matrix44 position  = Matrix44::Translation(Position);
+	Matrix44 position  = Matrix44::Translation(ToRenderSpace(Position));
 	Matrix44 scale     = Matrix44::Scaling(Scale);
 	Matrix44 rotation  = Rotation.ToMatrix();
 	Matrix44 world = scale * rotation * position;
@@ -20,13 +23,32 @@ Matrix44 Transform::WorldMatrix()
 //////////////////////////////////////////////////////////////////////////
 Matrix44 Transform::WorldMatrixNoScale()
 {
-	Matrix44 position  = Matrix44::Translation(Position);
+	Matrix44 position  = Matrix44::Translation(ToRenderSpace(Position));
 	Matrix44 rotation  = Rotation.ToMatrix();
 	Matrix44 world = rotation * position;
 
 	return world;
 }
 
+//////////////////////////////////////////////////////////////////////////
+// The subtraction is done in world precision, only the (small) result is
+// narrowed to float.
+Vector3 Transform::ToRenderSpace(const WorldPosition& position)
+{
+	return ToRenderSpace(position, sRenderOrigin);
+}
+//----------------------------------------
+// Against a render origin of the past, as a RenderSnapshot keeps it
+Vector3 Transform::ToRenderSpace(const WorldPosition& position, const WorldPosition& renderOrigin)
+{
+#if RJE_DOUBLE_PRECISION
+	return Vector3(position - renderOrigin);
+#else
+	UNREFERENCED_PARAMETER(renderOrigin);
+	return position;
+#endif
+}
+
 //////////////////////////////////////////////////////////////////////////
 Vector3 Transform::Right()
 { return Rotation.GetRightVector(); }
@@ -41,10 +63,9 @@ Vector3 Transform::Forward()
 //////////////////////////////////////////////////////////////////////////
 Matrix44 Transform::MatrixFromTextureProperties( Vector2 tiling, Vector2 offset, f32 rotationAngle )
 {
-	Transform t;
-	t.Position = Vector3(offset.x, offset.y, 0.0f);
-	t.Scale    = Vector3(tiling.x, tiling.y, 1.0f);
-	t.Rotation = Quaternion(0,0,rotationAngle);
-	t.WorldMat = t.WorldMatrix();
-	return t.WorldMat;
+	// Texture space, must not go through the render origin
+	Matrix44 position = Matrix44::Translation(offset.x, offset.y, 0.0f);
+	Matrix44 scale    = Matrix44::Scaling(tiling.x, tiling.y, 1.0f);
+	Matrix44 rotation = Quaternion(0,0,rotationAngle).ToMatrix();
+	return scale * rotation * position;
 }
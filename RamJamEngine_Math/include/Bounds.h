@@ -0,0 +1,140 @@
+#pragma once
+
+#include "Types.h"
+#include "MathHelper.h"
+
+//////////////////////////////////////////////////////////////////////////
+// Bounding volumes and intersection tests, native to the RJE math types so
+// culling doesn't have to round-trip through DirectX::Bounding*.
+// Matrices follow the engine convention: row vectors, p' = p * M, with the
+// translation in m41..m43. Planes point inward: Distance(p) >= 0 is inside.
+//////////////////////////////////////////////////////////////////////////
+
+struct Sphere;
+struct AABB;
+struct OBB;
+
+//----------------------------------------------------------------------
+// Ax + By + Cz + D = 0, with (A,B,C) = normal
+struct Plane
+{
+	Vector3	normal;
+	f32		d;
+
+	Plane() : normal(), d(0.0f) {}
+	Plane(const Vector3& normal, f32 d) : normal(normal), d(d) {}
+	Plane(f32 a, f32 b, f32 c, f32 d) : normal(a, b, c), d(d) {}
+
+	static Plane	FromPointNormal(const Vector3& point, const Vector3& normal);
+	static Plane	FromPoints(const Vector3& a, const Vector3& b, const Vector3& c);	// counter-clockwise seen from the front
+
+	f32		Distance(const Vector3& p) const;			// signed, in normal units
+	Plane&	Normalize();
+};
+
+//----------------------------------------------------------------------
+struct Sphere
+{
+	Vector3	center;
+	f32		radius;
+
+	Sphere() : center(), radius(0.0f) {}
+	Sphere(const Vector3& center, f32 radius) : center(center), radius(radius) {}
+
+	static Sphere	FromAABB(const AABB& box);
+	static Sphere	Merge(const Sphere& a, const Sphere& b);
+
+	Sphere	Transform(const Matrix44& m) const;		// radius scaled by the largest axis scale
+	BOOL	Contains(const Vector3& p) const;
+	BOOL	Intersects(const Sphere& s) const;
+	BOOL	Intersects(const AABB& box) const;
+	BOOL	Intersects(const Plane& p) const;
+};
+
+//----------------------------------------------------------------------
+// Same layout as Mesh::Subset's mCenter/mExtents and DirectX::BoundingBox
+struct AABB
+{
+	Vector3	center;
+	Vector3	extents;	// half size, >= 0
+
+	AABB() : center(), extents() {}
+	AABB(const Vector3& center, const Vector3& extents) : center(center), extents(extents) {}
+
+	static AABB		FromMinMax(const Vector3& vMin, const Vector3& vMax);
+	static AABB		FromPoints(const Vector3* points, u32 count);
+	static AABB		Merge(const AABB& a, const AABB& b);
+
+	Vector3	Min() const	{ return center - extents; }
+	Vector3	Max() const	{ return center + extents; }
+	void	Corners(Vector3 outCorners[8]) const;
+
+	AABB	Transform(const Matrix44& m) const;		// tight box around the transformed box (Arvo)
+	BOOL	Contains(const Vector3& p) const;
+	BOOL	Intersects(const AABB& box) const;
+	BOOL	Intersects(const Sphere& s) const;
+	BOOL	Intersects(const Plane& p) const;
+};
+
+//----------------------------------------------------------------------
+struct OBB
+{
+	Vector3	center;
+	Vector3	extents;	// half size along each axis
+	Vector3	axes[3];	// orthonormal
+
+	OBB() : center(), extents()		{ axes[0] = Vector3::right; axes[1] = Vector3::up; axes[2] = Vector3::forward; }
+
+	static OBB		FromAABB(const AABB& box, const Matrix44& m);	// m: rotation, translation and scale (no shear)
+
+	void	Corners(Vector3 outCorners[8]) const;
+	BOOL	Contains(const Vector3& p) const;
+	BOOL	Intersects(const OBB& box) const;			// separating axis, 15 axes
+	BOOL	Intersects(const Sphere& s) const;
+	BOOL	Intersects(const Plane& p) const;
+};
+
+//----------------------------------------------------------------------
+struct Ray
+{
+	Vector3	origin;
+	Vector3	direction;	// normalized
+
+	Ray() : origin(), direction(Vector3::forward) {}
+	Ray(const Vector3& origin, const Vector3& direction) : origin(origin), direction(direction) {}
+
+	Vector3	At(f32 t) const	{ return origin + direction*t; }
+
+	// On hit, outT is the distance to the first hit in front of the origin (0 if the origin is inside)
+	BOOL	Intersects(const Plane&  p,   OUT f32& outT) const;
+	BOOL	Intersects(const Sphere& s,   OUT f32& outT) const;
+	BOOL	Intersects(const AABB&   box, OUT f32& outT) const;
+	BOOL	Intersects(const OBB&    box, OUT f32& outT) const;
+};
+
+//----------------------------------------------------------------------
+struct Frustum
+{
+	enum PlaneIndex { Left, Right, Bottom, Top, Near, Far, PlaneCount };
+	enum Containment { Outside, Intersecting, Inside };
+
+	Plane	planes[PlaneCount];
+
+	// Planes of the volume viewProj maps to D3D clip space (0 <= z <= w).
+	// Pass world*view*proj to get them in that object's local space.
+	static Frustum	FromViewProj(const Matrix44& viewProj);
+
+	BOOL	Contains(const Vector3& p) const;
+	// Plane tests only: conservative, a volume just outside a frustum corner can still be reported as intersecting
+	BOOL	Intersects(const Sphere& s) const;
+	BOOL	Intersects(const AABB&   box) const;
+	BOOL	Intersects(const OBB&    box) const;
+	Containment	Classify(const Sphere& s) const;
+	Containment	Classify(const AABB& box) const;
+
+	// SSE2 batch versions: 4 volumes per iteration, same results as the scalar tests
+	void	Intersects(const Sphere* spheres, u32 count, OUT BOOL* outVisible) const;
+	void	Intersects(const AABB*   boxes,   u32 count, OUT BOOL* outVisible) const;
+};
+
+#include "Bounds.inl"
@@ -0,0 +1,83 @@
+//////////////////////////////////////////////////////////////////////////
+
+//----------------------------------------------------------------------
+FORCEINLINE Plane Plane::FromPointNormal(const Vector3& point, const Vector3& normal)
+{ return Plane(normal, -Vector3::Dot(normal, point)); }
+//----------------------------------------------------------------------
+FORCEINLINE f32 Plane::Distance(const Vector3& p) const
+{ return normal.x*p.x + normal.y*p.y + normal.z*p.z + d; }
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+FORCEINLINE BOOL Sphere::Contains(const Vector3& p) const
+{ return (p - center).SqrMagnitude() <= radius*radius; }
+//----------------------------------------------------------------------
+FORCEINLINE BOOL Sphere::Intersects(const Sphere& s) const
+{ f32 r = radius + s.radius; return (s.center - center).SqrMagnitude() <= r*r; }
+//----------------------------------------------------------------------
+FORCEINLINE BOOL Sphere::Intersects(const AABB& box) const
+{ return box.Intersects(*this); }
+//----------------------------------------------------------------------
+FORCEINLINE BOOL Sphere::Intersects(const Plane& p) const
+{ f32 dist = p.Distance(center); return dist <= radius && dist >= -radius; }
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+FORCEINLINE AABB AABB::FromMinMax(const Vector3& vMin, const Vector3& vMax)
+{ return AABB(0.5f*(vMin + vMax), 0.5f*(vMax - vMin)); }
+//----------------------------------------------------------------------
+FORCEINLINE AABB AABB::Merge(const AABB& a, const AABB& b)
+{ return FromMinMax(Vector3::Min(a.Min(), b.Min()), Vector3::Max(a.Max(), b.Max())); }
+//----------------------------------------------------------------------
+FORCEINLINE BOOL AABB::Contains(const Vector3& p) const
+{
+	return	fabsf(p.x - center.x) <= extents.x &&
+			fabsf(p.y - center.y) <= extents.y &&
+			fabsf(p.z - center.z) <= extents.z;
+}
+//----------------------------------------------------------------------
+FORCEINLINE BOOL AABB::Intersects(const AABB& box) const
+{
+	return	fabsf(box.center.x - center.x) <= extents.x + box.extents.x &&
+			fabsf(box.center.y - center.y) <= extents.y + box.extents.y &&
+			fabsf(box.center.z - center.z) <= extents.z + box.extents.z;
+}
+//----------------------------------------------------------------------
+FORCEINLINE BOOL AABB::Intersects(const Plane& p) const
+{
+	// Projection radius of the box onto the plane normal
+	f32 r = fabsf(p.normal.x)*extents.x + fabsf(p.normal.y)*extents.y + fabsf(p.normal.z)*extents.z;
+	f32 dist = p.Distance(center);
+	return dist <= r && dist >= -r;
+}
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+FORCEINLINE BOOL Frustum::Contains(const Vector3& p) const
+{
+	for (u32 i = 0; i < PlaneCount; ++i)
+		if (planes[i].Distance(p) < 0.0f)
+			return false;
+	return true;
+}
+//----------------------------------------------------------------------
+FORCEINLINE BOOL Frustum::Intersects(const Sphere& s) const
+{
+	for (u32 i = 0; i < PlaneCount; ++i)
+		if (planes[i].Distance(s.center) < -s.radius)
+			return false;
+	return true;
+}
+//----------------------------------------------------------------------
+FORCEINLINE BOOL Frustum::Intersects(const AABB& box) const
+{
+	for (u32 i = 0; i < PlaneCount; ++i)
+	{
+		const Plane& p = planes[i];
+		f32 r = fabsf(p.normal.x)*box.extents.x + fabsf(p.normal.y)*box.extents.y + fabsf(p.normal.z)*box.extents.z;
+		if (p.Distance(box.center) < -r)
+			return false;
+	}
+	return true;
+}
+//----------------------------------------------------------------------
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "Types.h"
+
+namespace RJE
+{
+	//////////////////////////////////////////////////////////////////////////
+	// Polynomial approximations for hot loops, opt-in per call site: RJE::Math
+	// and the CRT stay the reference. Max errors measured against libm (double)
+	// over the given input range, checked by the benchmark's BenchmarkFastMath:
+	//  - RSqrt  : SSE estimate + 1 Newton step,  x > 0         rel. err < 3e-7
+	//  - Sqrt   : x * RSqrt(x),                  x >= 0        rel. err < 3e-7
+	//  - SinCos : Cody-Waite + minimax (Cephes), |x| <= 8192   abs. err < 8e-8
+	//  - Atan2  : 3-way reduction + minimax,     any           abs. err < 3e-7 rad
+	//  - Exp    : 2^n * minimax,                 [-87, 88]     rel. err < 1e-7 (clamped outside)
+	// The batch versions process 4 floats at a time with SSE2 and return the
+	// exact same bits as the scalar ones (as long as the compiler doesn't
+	// contract mul+add into FMA).
+	struct FastMath
+	{
+		static f32	RSqrt(f32 x);
+		static f32	Sqrt(f32 x);
+		static f32	Sin(f32 x);
+		static f32	Cos(f32 x);
+		static void	SinCos(f32 x, f32& outSin, f32& outCos);
+		static f32	Atan(f32 x);
+		static f32	Atan2(f32 y, f32 x);
+		static f32	Exp(f32 x);
+		//------------------------
+		// in/out don't need to be aligned, out may alias in
+		static void	RSqrt (const f32* in, f32* out, u32 count);
+		static void	SinCos(const f32* in, f32* outSin, f32* outCos, u32 count);
+		static void	Atan2 (const f32* y, const f32* x, f32* out, u32 count);
+		static void	Exp   (const f32* in, f32* out, u32 count);
+	};
+}
+
+#include "FastMath.inl"
@@ -0,0 +1,93 @@
+//////////////////////////////////////////////////////////////////////////
+
+#include <xmmintrin.h>
+
+namespace RJE
+{
+	//----------------------------------------------------------------------
+	FORCEINLINE f32 FastMath::RSqrt(f32 x)
+	{
+		f32 y = _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(x)));
+		return y * (1.5f - 0.5f*x*y*y);
+	}
+	//----------------------------------------------------------------------
+	FORCEINLINE f32 FastMath::Sqrt(f32 x)
+	{ return x > 0.0f ? x * RSqrt(x) : 0.0f; }
+	//----------------------------------------------------------------------
+
+	//----------------------------------------------------------------------
+	FORCEINLINE void FastMath::SinCos(f32 x, f32& outSin, f32& outCos)
+	{
+		// Reduce to r in [-pi/4, pi/4] with x = j*pi/4 + r, j even
+		f32 ax = x < 0.0f ? -x : x;
+		i32 j  = (static_cast<i32>(ax * 1.27323954473516f) + 1) & ~1;
+		f32 fj = static_cast<f32>(j);
+		f32 r  = ((ax - fj*0.78515625f) - fj*2.4187564849853515625e-4f) - fj*3.77489497744594108e-8f;
+		f32 z  = r*r;
+
+		f32 s = ((-1.9515295891e-4f*z + 8.3321608736e-3f)*z - 1.6666654611e-1f)*z*r + r;
+		f32 c = ((2.443315711809948e-5f*z - 1.388731625493765e-3f)*z + 4.166664568298827e-2f)*z*z - 0.5f*z + 1.0f;
+
+		// Quadrant j/2: (sin, cos) = (s, c), (c, -s), (-s, -c), (-c, s)
+		i32 q = j & 6;
+		f32 sinQ = (q & 2) ? c : s;
+		f32 cosQ = (q & 2) ? s : c;
+		if (q == 2 || q == 4)	cosQ = -cosQ;
+		if (q & 4)				sinQ = -sinQ;
+
+		outSin = x < 0.0f ? -sinQ : sinQ;
+		outCos = cosQ;
+	}
+	//----------------------------------------------------------------------
+	FORCEINLINE f32 FastMath::Sin(f32 x)
+	{ f32 s, c; SinCos(x, s, c); return s; }
+	//----------------------------------------------------------------------
+	FORCEINLINE f32 FastMath::Cos(f32 x)
+	{ f32 s, c; SinCos(x, s, c); return c; }
+	//----------------------------------------------------------------------
+
+	//----------------------------------------------------------------------
+	FORCEINLINE f32 FastMath::Atan(f32 x)
+	{
+		f32 ax = x < 0.0f ? -x : x;
+		f32 offset = 0.0f;
+		if (ax > 2.414213562373095f)		{ offset = 1.570796326794897f;	ax = -1.0f/ax; }			// tan(3pi/8)
+		else if (ax > 0.4142135623730950f)	{ offset = 0.785398163397448f;	ax = (ax-1.0f)/(ax+1.0f); }	// tan(pi/8)
+		f32 z = ax*ax;
+		f32 y = offset + (((8.05374449538e-2f*z - 1.38776856032e-1f)*z + 1.99777106478e-1f)*z - 3.33329491539e-1f)*z*ax + ax;
+		return x < 0.0f ? -y : y;
+	}
+	//----------------------------------------------------------------------
+	FORCEINLINE f32 FastMath::Atan2(f32 y, f32 x)
+	{
+		if (x == 0.0f)
+			return y > 0.0f ? 1.570796326794897f : (y < 0.0f ? -1.570796326794897f : 0.0f);
+
+		f32 a = Atan(y/x);
+		if (x < 0.0f)
+			a += (y < 0.0f ? -3.141592653589793f : 3.141592653589793f);
+		return a;
+	}
+	//----------------------------------------------------------------------
+
+	//----------------------------------------------------------------------
+	FORCEINLINE f32 FastMath::Exp(f32 x)
+	{
+		x = x > 88.0f ? 88.0f : (x < -87.0f ? -87.0f : x);
+
+		// x = n*ln2 + r, |r| <= ln2/2
+		f32 fn = x*1.44269504088896341f + 0.5f;
+		i32 n  = static_cast<i32>(fn);
+		n -= (static_cast<f32>(n) > fn) ? 1 : 0;		// floor
+		f32 f  = static_cast<f32>(n);
+		f32 r  = (x - f*0.693359375f) - f*(-2.12194440e-4f);
+		f32 z  = r*r;
+
+		f32 p = (((((1.9875691500e-4f*r + 1.3981999507e-3f)*r + 8.3334519073e-3f)*r + 4.1665795894e-2f)*r + 1.6666665459e-1f)*r + 5.0000001201e-1f)*z + r + 1.0f;
+
+		union { i32 i; f32 f; } pow2n;
+		pow2n.i = (n + 127) << 23;
+		return p * pow2n.f;
+	}
+	//----------------------------------------------------------------------
+}
@@ -1,14 +1,12 @@
 #pragma once
 
-#include <windows.h>
 #include <float.h>
+#include <cmath>
 
-#include "Vector2.h"
-#include "Vector3.h"
-#include "Vector4.h"
-#include "Quaternion.h"
-#include "Matrix44.h"
+#include "Types.h"
 
+// Math is declared before the vector/matrix headers so their constexpr
+// builders can call into it.
 namespace RJE
 {
 #define RJE_PI			3.141592653589793238462643383279
@@ -34,7 +32,7 @@ namespace RJE
 
 		//--------------------------------------------------
 		template<typename T>
-		FORCEINLINE static T Abs(T number)
+		RJE_CONSTEXPR static T Abs(T number)
 		{ return (number > 0 ? number : -number); }
 		//--------------------------------------------------
 
@@ -50,40 +48,87 @@ namespace RJE
 
 		//--------------------------------------------------
 		template<typename T>
-		FORCEINLINE static BOOL IsZero(T number)
+		RJE_CONSTEXPR static BOOL IsZero(T number)
 		{ return (Abs(number) < std::numeric_limits<T>::epsilon()); }
 		//------------------------
 		template<typename T>
-		FORCEINLINE static BOOL IsOne(T number)
+		RJE_CONSTEXPR static BOOL IsOne(T number)
 		{ return ( number < 0 ? false : IsZero(number-1)); }
 		//--------------------------------------------------
 
 		//--------------------------------------------------
 		template<typename T>
-		FORCEINLINE static T Min(const T& a, const T& b)
+		RJE_CONSTEXPR static T Min(const T& a, const T& b)
 		{ return a < b ? a : b; }
 		//------------------------
 		template<typename T>
-		FORCEINLINE static T Max(const T& a, const T& b)
+		RJE_CONSTEXPR static T Max(const T& a, const T& b)
 		{ return a > b ? a : b; }
 		//--------------------------------------------------
 
 		//--------------------------------------------------
 		template<typename T>
-		FORCEINLINE static T Clamp(const T& x, const T& low, const T& high)
+		RJE_CONSTEXPR static T Clamp(const T& x, const T& low, const T& high)
 		{ return x < low ? low : (x > high ? high : x); }
 		//------------------------
 		template<typename T>
-		FORCEINLINE static T Clamp01(const T& x)
+		RJE_CONSTEXPR static T Clamp01(const T& x)
 		{ return x < 0 ? 0 : (x > 1 ? 1 : x); }
 		//--------------------------------------------------
 
 		//--------------------------------------------------
 		template<typename T>
-		FORCEINLINE static T Lerp(const T& a, const T& b, float t)
+		RJE_CONSTEXPR static T Lerp(const T& a, const T& b, float t)
 		{ return t <= 0 ? a : (t >= 1 ? b : (a + (b-a)*t)); }
 		//--------------------------------------------------
 
+		//--------------------------------------------------
+		// Sine/cosine usable in constant expressions (radians). The argument is
+		// wrapped to [-pi/2, pi/2] and fed to a degree 19 Taylor polynomial,
+		// accurate to ~1e-14 over the whole range.
+#if RJE_HAS_CONSTEXPR
+		template<typename T>
+		static constexpr T ConstSin(T x)
+		{ return ConstSinFolded(ConstWrapPi(x)); }
+		//------------------------
+		template<typename T>
+		static constexpr T ConstCos(T x)
+		{ return ConstSin(x + static_cast<T>(RJE_HALF_PI)); }
+		//------------------------
+	private:
+		template<typename T>
+		static constexpr i64 ConstRound(T x)
+		{ return x >= 0 ? static_cast<i64>(x + static_cast<T>(0.5)) : -static_cast<i64>(static_cast<T>(0.5) - x); }
+		//------------------------
+		template<typename T>
+		static constexpr T ConstWrapPi(T x)		// [-pi, pi]
+		{ return x - static_cast<T>(RJE_TWO_PI) * static_cast<T>(ConstRound(x / static_cast<T>(RJE_TWO_PI))); }
+		//------------------------
+		template<typename T>
+		static constexpr T ConstSinFolded(T x)	// sin(x) = sin(pi-x)
+		{	return	x >  static_cast<T>(RJE_HALF_PI) ? ConstSinPoly( static_cast<T>(RJE_PI) - x) :
+					x < -static_cast<T>(RJE_HALF_PI) ? ConstSinPoly(-static_cast<T>(RJE_PI) - x) : ConstSinPoly(x); }
+		//------------------------
+		template<typename T>
+		static constexpr T ConstSinPoly(T x)
+		{ return ConstSinPoly(x, x*x); }
+		//------------------------
+		template<typename T>
+		static constexpr T ConstSinPoly(T x, T x2)
+		{	return x*(1 - x2/6*(1 - x2/20*(1 - x2/42*(1 - x2/72*(1 - x2/110*
+						(1 - x2/156*(1 - x2/210*(1 - x2/272*(1 - x2/342))))))))); }
+	public:
+#else
+		template<typename T>
+		FORCEINLINE static T ConstSin(T x)
+		{ return sin(x); }
+		//------------------------
+		template<typename T>
+		FORCEINLINE static T ConstCos(T x)
+		{ return cos(x); }
+#endif
+		//--------------------------------------------------
+
 		//--------------------------------------------------
 		// Returns the polar angle of the point (x,y) in [0, 2*PI[.
 		template <typename Real>
@@ -107,6 +152,20 @@ namespace RJE
 		//--------------------------------------------------
 
 		//--------------------------------------------------
+#if RJE_HAS_CONSTEXPR
+		static constexpr double Infinity   = DBL_MAX;
+		static constexpr float  Infinity_f = FLT_MAX;
+		static constexpr double Pi         = RJE_PI;
+		static constexpr float  Pi_f       = RJE_PI_F;
+		static constexpr double Pi_Half    = RJE_HALF_PI;
+		static constexpr float  Pi_Half_f  = RJE_HALF_PI_F;
+		static constexpr double Pi_Two     = RJE_TWO_PI;
+		static constexpr float  Pi_Two_f   = RJE_TWO_PI_F;
+		static constexpr double Deg2Rad    = RJE_PI / 180.0;
+		static constexpr float  Deg2Rad_f  = RJE_PI_F / 180.0f;
+		static constexpr double Rad2Deg    = 180.0 / RJE_PI;
+		static constexpr float  Rad2Deg_f  = 180.0f / RJE_PI_F;
+#else
 		static const double Infinity;
 		static const float  Infinity_f;
 		static const double Pi;
@@ -119,5 +178,12 @@ namespace RJE
 		static const float  Deg2Rad_f;
 		static const double Rad2Deg;
 		static const float  Rad2Deg_f;
+#endif
 	};
-}
\ No newline at end of file
+}
+
+#include "Vector2.h"
+#include "Vector3.h"
+#include "Vector4.h"
+#include "Quaternion.h"
+#include "Matrix44.h"
\ No newline at end of file
@@ -3,7 +3,9 @@
 #include "Types.h"
 #include "Quaternion.h"
 #include "Vector3.h"
-#include <DirectXMath.h>
+#if PLATFORM == PLATFORM_WIN32
+#	include <DirectXMath.h>
+#endif
 
 template <typename Real>
 struct Quaternion_T;
@@ -16,31 +18,37 @@ struct Matrix44_T
 	Real m31, m32, m33, m34;
 	Real m41, m42, m43, m44;
 
-	Matrix44_T();
-	Matrix44_T(	Real m11, Real m12, Real m13, Real m14,
-				Real m21, Real m22, Real m23, Real m24,
-				Real m31, Real m32, Real m33, Real m34,
-				Real m41, Real m42, Real m43, Real m44);
-	Matrix44_T(const Matrix44_T&);
+	RJE_CONSTEXPR Matrix44_T();
+	RJE_CONSTEXPR Matrix44_T(	Real m11, Real m12, Real m13, Real m14,
+								Real m21, Real m22, Real m23, Real m24,
+								Real m31, Real m32, Real m33, Real m34,
+								Real m41, Real m42, Real m43, Real m44);
+	RJE_CONSTEXPR Matrix44_T(const Matrix44_T&);
+#if PLATFORM == PLATFORM_WIN32
 	Matrix44_T(const DirectX::XMMATRIX&);
+#endif
 	//------------
 	static const Matrix44_T identity;
 	//------------
-	Matrix44_T		operator +  (const Matrix44_T&);
-	Matrix44_T		operator -  (const Matrix44_T&);
-	Matrix44_T		operator *  (const Matrix44_T&);
-	Vector3_T<Real>	operator *  (const Vector3_T<Real>&);
-	Vector4_T<Real>	operator *  (const Vector4_T<Real>&);
+	RJE_CONSTEXPR Matrix44_T		operator +  (const Matrix44_T&) const;
+	RJE_CONSTEXPR Matrix44_T		operator -  (const Matrix44_T&) const;
+	RJE_CONSTEXPR Matrix44_T		operator *  (const Matrix44_T&) const;
+	RJE_CONSTEXPR Vector3_T<Real>	operator *  (const Vector3_T<Real>&) const;
+	RJE_CONSTEXPR Vector4_T<Real>	operator *  (const Vector4_T<Real>&) const;
 	Matrix44_T&		operator *= (const Matrix44_T&);
 	Matrix44_T&		operator =  (const Matrix44_T&);
+#if PLATFORM == PLATFORM_WIN32
 	Matrix44_T&		operator =  (const DirectX::XMMATRIX&);
+#endif
 	BOOL			operator == (const Matrix44_T&);
 	BOOL			operator != (const Matrix44_T&);
 	//---------------------------
+#if PLATFORM == PLATFORM_WIN32
 	operator DirectX::XMMATRIX();
+#endif
 	//---------------------------
-	Real			Trace();
-	Real			Determinant();
+	RJE_CONSTEXPR Real	Trace() const;
+	RJE_CONSTEXPR Real	Determinant() const;
 	Matrix44_T&		Transpose();
 	Matrix44_T&		Inverse();
 	Matrix44_T&		InverseTranspose();
@@ -54,20 +62,24 @@ struct Matrix44_T
 	static Matrix44_T&	FromEulerAngles(Matrix44_T<Real>& m, Real x, Real y, Real z);
 	static Matrix44_T&	FromEulerAngles(Matrix44_T<Real>& m, Vector3_T<Real> euler);
 	//---------------------------
-	static Matrix44_T	Translation(Vector3_T<Real>);
-	static Matrix44_T	Translation(Real x, Real y, Real z);
-	static Matrix44_T	Scaling(Vector3_T<Real>);
-	static Matrix44_T	Scaling(Real x, Real y, Real z);
-	static Matrix44_T	RotationX(Real degrees);
-	static Matrix44_T	RotationY(Real degrees);
-	static Matrix44_T	RotationZ(Real degrees);
+	// Constant builders: evaluated at compile time when fed constant arguments.
+	static RJE_CONSTEXPR Matrix44_T	Translation(Vector3_T<Real>);
+	static RJE_CONSTEXPR Matrix44_T	Translation(Real x, Real y, Real z);
+	static RJE_CONSTEXPR Matrix44_T	Scaling(Vector3_T<Real>);
+	static RJE_CONSTEXPR Matrix44_T	Scaling(Real x, Real y, Real z);
+	static RJE_CONSTEXPR Matrix44_T	RotationX(Real degrees);
+	static RJE_CONSTEXPR Matrix44_T	RotationY(Real degrees);
+	static RJE_CONSTEXPR Matrix44_T	RotationZ(Real degrees);
+	static RJE_CONSTEXPR Matrix44_T	RotationX(Real sinA, Real cosA);
+	static RJE_CONSTEXPR Matrix44_T	RotationY(Real sinA, Real cosA);
+	static RJE_CONSTEXPR Matrix44_T	RotationZ(Real sinA, Real cosA);
 	//---------------------------
 	static Matrix44_T	LookAt(Vector3_T<Real> pos, Vector3_T<Real> dir, Vector3_T<Real> up);
 	static Matrix44_T	LookAt(Vector3_T<Real> pos, Vector3_T<Real> dir);
 	static void			LookAt(Matrix44_T& mOut, Vector3_T<Real> pos, Vector3_T<Real> dir);
 	//---------------------------
 	static Matrix44_T	PerspectiveFov(Real Fov, Real AspectRatio, Real NearZ, Real FarZ);
-	static Matrix44_T	Orthographic(Real ViewWidth, Real ViewHeight, Real NearZ, Real FarZ);
+	static RJE_CONSTEXPR Matrix44_T	Orthographic(Real ViewWidth, Real ViewHeight, Real NearZ, Real FarZ);
 	static void			Orthographic(Matrix44_T& mOut, Real ViewWidth, Real ViewHeight, Real NearZ, Real FarZ);
 	//---------------------------
 	// Transformation Matrix for the reflection with the plane equation Ax+By+Cz+D=0.
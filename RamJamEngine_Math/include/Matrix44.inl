@@ -10,25 +10,26 @@ const Matrix44_T<Real> Matrix44_T<Real>::identity = Matrix44_T<Real>();
 
 //----------------------------------------------------------------------
 template <typename Real>
-Matrix44_T<Real>::Matrix44_T()
-{
-	m12=m13=m14=m21=m23=m24=m31=m32=m34=m41=m42=m43 = 0.0f;
-	m11=m22=m33=m44 = 1.0f;
-}
+RJE_CONSTEXPR Matrix44_T<Real>::Matrix44_T()
+	:	m11(1), m12(0), m13(0), m14(0),
+		m21(0), m22(1), m23(0), m24(0),
+		m31(0), m32(0), m33(1), m34(0),
+		m41(0), m42(0), m43(0), m44(1)
+{}
 //----------------------------------------------------------------------
 
 //----------------------------------------------------------------------
 template <typename Real>
-Matrix44_T<Real>::Matrix44_T( const Matrix44_T& matIn )
-{
-	m11 = matIn.m11;	m12 = matIn.m12;	m13 = matIn.m13;	m14 = matIn.m14;
-	m21 = matIn.m21;	m22 = matIn.m22;	m23 = matIn.m23;	m24 = matIn.m24;
-	m31 = matIn.m31;	m32 = matIn.m32;	m33 = matIn.m33;	m34 = matIn.m34;
-	m41 = matIn.m41;	m42 = matIn.m42;	m43 = matIn.m43;	m44 = matIn.m44;
-}
+RJE_CONSTEXPR Matrix44_T<Real>::Matrix44_T( const Matrix44_T& matIn )
+	:	m11(matIn.m11), m12(matIn.m12), m13(matIn.m13), m14(matIn.m14),
+		m21(matIn.m21), m22(matIn.m22), m23(matIn.m23), m24(matIn.m24),
+		m31(matIn.m31), m32(matIn.m32), m33(matIn.m33), m34(matIn.m34),
+		m41(matIn.m41), m42(matIn.m42), m43(matIn.m43), m44(matIn.m44)
+{}
 //----------------------------------------------------------------------
 
 //----------------------------------------------------------------------
+#if PLATFORM == PLATFORM_WIN32		// DirectXMath interop, the DX11 backend's
 template <typename Real>
 Matrix44_T<Real>::Matrix44_T( const DirectX::XMMATRIX& matIn )
 {
@@ -37,23 +38,23 @@ Matrix44_T<Real>::Matrix44_T( const DirectX::XMMATRIX& matIn )
 	m31 = matIn.r[2].m128_f32[0];	m32 = matIn.r[2].m128_f32[1];	m33 = matIn.r[2].m128_f32[2];	m34 = matIn.r[2].m128_f32[3];
 	m41 = matIn.r[3].m128_f32[0];	m42 = matIn.r[3].m128_f32[1];	m43 = matIn.r[3].m128_f32[2];	m44 = matIn.r[3].m128_f32[3];
 }
+#endif
 //----------------------------------------------------------------------
 
 //----------------------------------------------------------------------
 template <typename Real>
-Matrix44_T<Real>::Matrix44_T( Real _m11, Real _m12, Real _m13, Real _m14, Real _m21, Real _m22, Real _m23, Real _m24, Real _m31, Real _m32, Real _m33, Real _m34, Real _m41, Real _m42, Real _m43, Real _m44 )
-{
-	m11 = _m11;		m12 = _m12;		m13 = _m13;		m14 = _m14;
-	m21 = _m21;		m22 = _m22;		m23 = _m23;		m24 = _m24;
-	m31 = _m31;		m32 = _m32;		m33 = _m33;		m34 = _m34;
-	m41 = _m41;		m42 = _m42;		m43 = _m43;		m44 = _m44;
-}
+RJE_CONSTEXPR Matrix44_T<Real>::Matrix44_T( Real _m11, Real _m12, Real _m13, Real _m14, Real _m21, Real _m22, Real _m23, Real _m24, Real _m31, Real _m32, Real _m33, Real _m34, Real _m41, Real _m42, Real _m43, Real _m44 )
+	:	m11(_m11), m12(_m12), m13(_m13), m14(_m14),
+		m21(_m21), m22(_m22), m23(_m23), m24(_m24),
+		m31(_m31), m32(_m32), m33(_m33), m34(_m34),
+		m41(_m41), m42(_m42), m43(_m43), m44(_m44)
+{}
 //----------------------------------------------------------------------
 
 
 //----------------------------------------------------------------------
 template <typename Real>
-FORCEINLINE Matrix44_T<Real> Matrix44_T<Real>::operator+( const Matrix44_T<Real>& matIn )
+RJE_CONSTEXPR Matrix44_T<Real> Matrix44_T<Real>::operator+( const Matrix44_T<Real>& matIn ) const
 {
 	return Matrix44_T<Real>(
 		this->m11+matIn.m11, this->m12+matIn.m12, this->m13+matIn.m13, this->m14+matIn.m14,
@@ -65,7 +66,7 @@ FORCEINLINE Matrix44_T<Real> Matrix44_T<Real>::operator+( const Matrix44_T<Real>
 
 //----------------------------------------------------------------------
 template <typename Real>
-FORCEINLINE Matrix44_T<Real> Matrix44_T<Real>::operator-( const Matrix44_T<Real>& matIn )
+RJE_CONSTEXPR Matrix44_T<Real> Matrix44_T<Real>::operator-( const Matrix44_T<Real>& matIn ) const
 {
 	return Matrix44_T<Real>(
 		this->m11-matIn.m11, this->m12-matIn.m12, this->m13-matIn.m13, this->m14-matIn.m14,
@@ -77,7 +78,7 @@ FORCEINLINE Matrix44_T<Real> Matrix44_T<Real>::operator-( const Matrix44_T<Real>
 
 //----------------------------------------------------------------------
 template <typename Real>
-FORCEINLINE Matrix44_T<Real> Matrix44_T<Real>::operator*( const Matrix44_T<Real>& matIn )
+RJE_CONSTEXPR Matrix44_T<Real> Matrix44_T<Real>::operator*( const Matrix44_T<Real>& matIn ) const
 {
 	return Matrix44_T<Real> (	matIn.m11 * m11 + matIn.m21 * m12 + matIn.m31 * m13 + matIn.m41 * m14,
 								matIn.m12 * m11 + matIn.m22 * m12 + matIn.m32 * m13 + matIn.m42 * m14,
@@ -100,7 +101,7 @@ FORCEINLINE Matrix44_T<Real> Matrix44_T<Real>::operator*( const Matrix44_T<Real>
 
 //----------------------------------------------------------------------
 template <typename Real>
-FORCEINLINE Vector3_T<Real> Matrix44_T<Real>::operator * ( const Vector3_T<Real>& pVector )
+RJE_CONSTEXPR Vector3_T<Real> Matrix44_T<Real>::operator * ( const Vector3_T<Real>& pVector ) const
 {
 	return Vector3_T<Real> (	m11 * pVector.x + m12 * pVector.y + m13 * pVector.z + m14,
 								m21 * pVector.x + m22 * pVector.y + m23 * pVector.z + m24,
@@ -110,7 +111,7 @@ FORCEINLINE Vector3_T<Real> Matrix44_T<Real>::operator * ( const Vector3_T<Real>
 
 //----------------------------------------------------------------------
 template <typename Real>
-FORCEINLINE Vector4_T<Real> Matrix44_T<Real>::operator * ( const Vector4_T<Real>& pVector )
+RJE_CONSTEXPR Vector4_T<Real> Matrix44_T<Real>::operator * ( const Vector4_T<Real>& pVector ) const
 {
 	return Vector4_T<Real> (	m11 * pVector.w + m12 * pVector.x + m13 * pVector.y + m14 * pVector.z,
 								m21 * pVector.w + m22 * pVector.x + m23 * pVector.y + m24 * pVector.z,
@@ -138,6 +139,7 @@ FORCEINLINE Matrix44_T<Real>& Matrix44_T<Real>::operator=( const Matrix44_T<Real
 //----------------------------------------------------------------------
 
 //----------------------------------------------------------------------
+#if PLATFORM == PLATFORM_WIN32
 template <typename Real>
 FORCEINLINE Matrix44_T<Real>& Matrix44_T<Real>::operator=( const DirectX::XMMATRIX& matIn)
 {
@@ -147,9 +149,11 @@ FORCEINLINE Matrix44_T<Real>& Matrix44_T<Real>::operator=( const DirectX::XMMATR
 	m41 = matIn.r[3].m128_f32[0];	m42 = matIn.r[3].m128_f32[1];	m43 = matIn.r[3].m128_f32[2];	m44 = matIn.r[3].m128_f32[3];
 	return *this;
 }
+#endif
 //----------------------------------------------------------------------
 
 //----------------------------------------------------------------------
+#if PLATFORM == PLATFORM_WIN32
 template <typename Real>
 FORCEINLINE Matrix44_T<Real>::operator DirectX::XMMATRIX ()
 {
@@ -159,6 +163,7 @@ FORCEINLINE Matrix44_T<Real>::operator DirectX::XMMATRIX ()
 							m41, m42, m43, m44);
 	return M;
 }
+#endif
 //----------------------------------------------------------------------
 
 //----------------------------------------------------------------------
@@ -168,7 +173,7 @@ FORCEINLINE BOOL Matrix44_T<Real>::operator == (const Matrix44_T<Real>& m)
 	return (m11 == m.m11 &&	m12 == m.m12 &&	m13 == m.m13 &&	m14 == m.m14 &&
 			m21 == m.m21 &&	m22 == m.m22 &&	m23 == m.m23 &&	m24 == m.m24 &&
 			m31 == m.m31 &&	m32 == m.m32 &&	m33 == m.m33 &&	m34 == m.m34 &&
-			m41 == m.m41 &&	m42 == m.m42 &&	m43 == m.m43 &&	m44 == m.m44 &&);
+			m41 == m.m41 &&	m42 == m.m42 &&	m43 == m.m43 &&	m44 == m.m44);
 }
 //----------------------------------------------------------------------
 template<typename Real>
@@ -177,20 +182,20 @@ FORCEINLINE BOOL Matrix44_T<Real>::operator != (const Matrix44_T<Real>& m)
 	return (m11 != m.m11 ||	m12 != m.m12 ||	m13 != m.m13 ||	m14 != m.m14 ||
 			m21 != m.m21 ||	m22 != m.m22 ||	m23 != m.m23 ||	m24 != m.m24 ||
 			m31 != m.m31 ||	m32 != m.m32 ||	m33 != m.m33 ||	m34 != m.m34 ||
-			m41 != m.m41 ||	m42 != m.m42 ||	m43 != m.m43 ||	m44 != m.m44 ||);
+			m41 != m.m41 ||	m42 != m.m42 ||	m43 != m.m43 ||	m44 != m.m44);
 }
 //----------------------------------------------------------------------
 
 
 //----------------------------------------------------------------------
 template <typename Real>
-FORCEINLINE Real Matrix44_T<Real>::Trace()
+RJE_CONSTEXPR Real Matrix44_T<Real>::Trace() const
 {  return m11+m22+m33+m44; }
 //----------------------------------------------------------------------
 
 //----------------------------------------------------------------------
 template <typename Real>
-FORCEINLINE Real Matrix44_T<Real>::Determinant()
+RJE_CONSTEXPR Real Matrix44_T<Real>::Determinant() const
 {
 	return	  m11*m22*m33*m44 - m11*m22*m34*m43 + m11*m23*m34*m42 - m11*m23*m32*m44 
 			+ m11*m24*m32*m43 - m11*m24*m33*m42 - m12*m23*m34*m41 + m12*m23*m31*m44 
@@ -288,22 +293,22 @@ FORCEINLINE BOOL Matrix44_T<Real>::IsIdentity() const
 	// Use a small epsilon to solve floating-point inaccuracies
 	const static Real epsilon = 10e-3f;
 
-	return (a2 <= epsilon && a2 >= -epsilon &&
-			a3 <= epsilon && a3 >= -epsilon &&
-			a4 <= epsilon && a4 >= -epsilon &&
-			b1 <= epsilon && b1 >= -epsilon &&
-			b3 <= epsilon && b3 >= -epsilon &&
-			b4 <= epsilon && b4 >= -epsilon &&
-			c1 <= epsilon && c1 >= -epsilon &&
-			c2 <= epsilon && c2 >= -epsilon &&
-			c4 <= epsilon && c4 >= -epsilon &&
-			d1 <= epsilon && d1 >= -epsilon &&
-			d2 <= epsilon && d2 >= -epsilon &&
-			d3 <= epsilon && d3 >= -epsilon &&
-			a1 <= 1.f+epsilon && a1 >= 1.f-epsilon &&
-			b2 <= 1.f+epsilon && b2 >= 1.f-epsilon &&
-			c3 <= 1.f+epsilon && c3 >= 1.f-epsilon &&
-			d4 <= 1.f+epsilon && d4 >= 1.f-epsilon);
+	return (m12 <= epsilon && m12 >= -epsilon &&
+			m13 <= epsilon && m13 >= -epsilon &&
+			m14 <= epsilon && m14 >= -epsilon &&
+			m21 <= epsilon && m21 >= -epsilon &&
+			m23 <= epsilon && m23 >= -epsilon &&
+			m24 <= epsilon && m24 >= -epsilon &&
+			m31 <= epsilon && m31 >= -epsilon &&
+			m32 <= epsilon && m32 >= -epsilon &&
+			m34 <= epsilon && m34 >= -epsilon &&
+			m41 <= epsilon && m41 >= -epsilon &&
+			m42 <= epsilon && m42 >= -epsilon &&
+			m43 <= epsilon && m43 >= -epsilon &&
+			m11 <= 1.f+epsilon && m11 >= 1.f-epsilon &&
+			m22 <= 1.f+epsilon && m22 >= 1.f-epsilon &&
+			m33 <= 1.f+epsilon && m33 >= 1.f-epsilon &&
+			m44 <= 1.f+epsilon && m44 >= 1.f-epsilon);
 }
 //----------------------------------------------------------------------
 
@@ -406,51 +411,44 @@ FORCEINLINE Matrix44_T<Real>& Matrix44_T<Real>::FromEulerAngles(Matrix44_T<Real>
 
 //----------------------------------------------------------------------
 template <typename Real>
-FORCEINLINE Matrix44_T<Real> Matrix44_T<Real>::Translation(Vector3_T<Real> position)
-{
-	Matrix44_T<Real> out;
-	out.m41 = position.x;
-	out.m42 = position.y;
-	out.m43 = position.z;
-	return out;
-}
+RJE_CONSTEXPR Matrix44_T<Real> Matrix44_T<Real>::Translation(Vector3_T<Real> position)
+{ return Translation(position.x, position.y, position.z); }
 //-------------
 template <typename Real>
-FORCEINLINE Matrix44_T<Real> Matrix44_T<Real>::Translation(Real x, Real y, Real z)
+RJE_CONSTEXPR Matrix44_T<Real> Matrix44_T<Real>::Translation(Real x, Real y, Real z)
 {
-	Matrix44_T<Real> out;
-	out.m41 = x;
-	out.m42 = y;
-	out.m43 = z;
-	return out;
+	return Matrix44_T<Real>(	1, 0, 0, 0,
+								0, 1, 0, 0,
+								0, 0, 1, 0,
+								x, y, z, 1);
 }
 //----------------------------------------------------------------------
 
 //----------------------------------------------------------------------
 template <typename Real>
-FORCEINLINE Matrix44_T<Real> Matrix44_T<Real>::Scaling(Vector3_T<Real> scale)
-{
-	Matrix44_T<Real> out;
-	out.m11 = scale.x;
-	out.m22 = scale.y;
-	out.m33 = scale.z;
-	return out;
-}
+RJE_CONSTEXPR Matrix44_T<Real> Matrix44_T<Real>::Scaling(Vector3_T<Real> scale)
+{ return Scaling(scale.x, scale.y, scale.z); }
 //-------------
 template <typename Real>
-FORCEINLINE Matrix44_T<Real> Matrix44_T<Real>::Scaling(Real x, Real y, Real z)
+RJE_CONSTEXPR Matrix44_T<Real> Matrix44_T<Real>::Scaling(Real x, Real y, Real z)
 {
-	Matrix44_T<Real> out;
-	out.m11 = x;
-	out.m22 = y;
-	out.m33 = z;
-	return out;
+	return Matrix44_T<Real>(	x, 0, 0, 0,
+								0, y, 0, 0,
+								0, 0, z, 0,
+								0, 0, 0, 1);
 }
 //----------------------------------------------------------------------
 
 //----------------------------------------------------------------------
 template <typename Real>
-FORCEINLINE Matrix44_T<Real> Matrix44_T<Real>::RotationX(Real degrees)
+RJE_CONSTEXPR Matrix44_T<Real> Matrix44_T<Real>::RotationX(Real degrees)
+{
+	return RotationX(	RJE::Math::ConstSin(degrees * static_cast<Real>(RJE_PI / 180.0)),
+						RJE::Math::ConstCos(degrees * static_cast<Real>(RJE_PI / 180.0)));
+}
+//-------------
+template <typename Real>
+RJE_CONSTEXPR Matrix44_T<Real> Matrix44_T<Real>::RotationX(Real sinA, Real cosA)
 {
 	//---------------------------------
 	//      |  1  0       0       0 |
@@ -458,17 +456,23 @@ FORCEINLINE Matrix44_T<Real> Matrix44_T<Real>::RotationX(Real degrees)
 	//      |  0  sin(A)  cos(A)  0 |
 	//      |  0  0       0       1 |
 	//---------------------------------
-	Real rad = degrees * static_cast<Real>(3.1415926535f / 180.0f);
-	Matrix44_T<Real> out;
-	out.m22 = out.m33 = cos(rad);
-	out.m23 = -(out.m32 = sin(rad));
-	return out;
+	return Matrix44_T<Real>(	1, 0,     0,     0,
+								0, cosA, -sinA,  0,
+								0, sinA,  cosA,  0,
+								0, 0,     0,     1);
 }
 //----------------------------------------------------------------------
 
 //----------------------------------------------------------------------
 template <typename Real>
-FORCEINLINE Matrix44_T<Real> Matrix44_T<Real>::RotationY(Real degrees)
+RJE_CONSTEXPR Matrix44_T<Real> Matrix44_T<Real>::RotationY(Real degrees)
+{
+	return RotationY(	RJE::Math::ConstSin(degrees * static_cast<Real>(RJE_PI / 180.0)),
+						RJE::Math::ConstCos(degrees * static_cast<Real>(RJE_PI / 180.0)));
+}
+//-------------
+template <typename Real>
+RJE_CONSTEXPR Matrix44_T<Real> Matrix44_T<Real>::RotationY(Real sinA, Real cosA)
 {
 	//---------------------------------
 	//     |  cos(A)  0   sin(A)  0 |
@@ -476,17 +480,23 @@ FORCEINLINE Matrix44_T<Real> Matrix44_T<Real>::RotationY(Real degrees)
 	//     | -sin(A)  0   cos(A)  0 |
 	//     |  0       0   0       1 |
 	//---------------------------------
-	Real rad = degrees * static_cast<Real>(3.1415926535f / 180.0f);
-	Matrix44_T<Real> out;
-	out.m11 = out.m33 = cos(rad);
-	out.m31 = -(out.m13 = sin(rad));
-	return out;
+	return Matrix44_T<Real>(	 cosA, 0, sinA, 0,
+								 0,    1, 0,    0,
+								-sinA, 0, cosA, 0,
+								 0,    0, 0,    1);
 }
 //----------------------------------------------------------------------
 
 //----------------------------------------------------------------------
 template <typename Real>
-FORCEINLINE Matrix44_T<Real> Matrix44_T<Real>::RotationZ(Real degrees)
+RJE_CONSTEXPR Matrix44_T<Real> Matrix44_T<Real>::RotationZ(Real degrees)
+{
+	return RotationZ(	RJE::Math::ConstSin(degrees * static_cast<Real>(RJE_PI / 180.0)),
+						RJE::Math::ConstCos(degrees * static_cast<Real>(RJE_PI / 180.0)));
+}
+//-------------
+template <typename Real>
+RJE_CONSTEXPR Matrix44_T<Real> Matrix44_T<Real>::RotationZ(Real sinA, Real cosA)
 {
 	//---------------------------------
 	//     |  cos(A)  -sin(A)   0   0 |
@@ -494,11 +504,10 @@ FORCEINLINE Matrix44_T<Real> Matrix44_T<Real>::RotationZ(Real degrees)
 	//     |  0        0        1   0 |
 	//     |  0        0        0   1 |
 	//---------------------------------
-	Real rad = degrees * static_cast<Real>(3.1415926535f / 180.0f);
-	Matrix44_T<Real> out;
-	out.m11 = out.m22 = cos(rad);
-	out.m12 = -(out.m21 = sin(rad));
-	return out;
+	return Matrix44_T<Real>(	cosA, -sinA, 0, 0,
+								sinA,  cosA, 0, 0,
+								0,     0,    1, 0,
+								0,     0,    0, 1);
 }
 //----------------------------------------------------------------------
 
@@ -563,22 +572,15 @@ FORCEINLINE Matrix44_T<Real> Matrix44_T<Real>::PerspectiveFov(Real Fov, Real Asp
 //----------------------------------------------------------------------
 
 //----------------------------------------------------------------------
+// No assert here so the builder stays usable in constant expressions; the
+// out-parameter overload below keeps the runtime checks.
 template <typename Real>
-FORCEINLINE Matrix44_T<Real> Matrix44_T<Real>::Orthographic(Real ViewWidth, Real ViewHeight, Real NearZ, Real FarZ)
+RJE_CONSTEXPR Matrix44_T<Real> Matrix44_T<Real>::Orthographic(Real ViewWidth, Real ViewHeight, Real NearZ, Real FarZ)
 {
-	RJE_ASSERT(!RJE::Math::IsZero(ViewWidth));
-	RJE_ASSERT(!RJE::Math::IsZero(ViewHeight));
-
-	Real One    = static_cast<Real>(1.0);
-	Real Zero   = static_cast<Real>(0.0);
-	Real fRange = One / (FarZ-NearZ);
-
-	Matrix44_T<Real> out;
-	out.m11 = 2/ViewWidth;	out.m12 = Zero;				out.m13 = Zero;				out.m14 = Zero;
-	out.m21 = Zero;			out.m22 = 2/ViewHeight;		out.m23 = Zero;				out.m24 = Zero;
-	out.m31 = Zero;			out.m32 = Zero;				out.m33 = fRange;			out.m34 = Zero;
-	out.m41 = Zero;			out.m42 = Zero;				out.m43 = -fRange * NearZ;	out.m44 = One;
-	return out;
+	return Matrix44_T<Real>(	2/ViewWidth,	0,				0,							0,
+								0,				2/ViewHeight,	0,							0,
+								0,				0,				1/(FarZ-NearZ),				0,
+								0,				0,				-NearZ/(FarZ-NearZ),		1);
 }
 //----------------------------------------------------------------------
 
@@ -589,14 +591,7 @@ FORCEINLINE void Matrix44_T<Real>::Orthographic(Matrix44_T<Real>& mOut, Real Vie
 	RJE_ASSERT(!RJE::Math::IsZero(ViewWidth));
 	RJE_ASSERT(!RJE::Math::IsZero(ViewHeight));
 
-	Real One    = static_cast<Real>(1.0);
-	Real Zero   = static_cast<Real>(0.0);
-	Real fRange = One / (FarZ-NearZ);
-
-	mOut.m11 = 2/ViewWidth;		mOut.m12 = Zero;				mOut.m13 = Zero;				mOut.m14 = Zero;
-	mOut.m21 = Zero;			mOut.m22 = 2/ViewHeight;		mOut.m23 = Zero;				mOut.m24 = Zero;
-	mOut.m31 = Zero;			mOut.m32 = Zero;				mOut.m33 = fRange;				mOut.m34 = Zero;
-	mOut.m41 = Zero;			mOut.m42 = Zero;				mOut.m43 = -fRange * NearZ;		mOut.m44 = One;
+	mOut = Orthographic(ViewWidth, ViewHeight, NearZ, FarZ);
 }
 //----------------------------------------------------------------------
 
@@ -125,11 +125,11 @@ FORCEINLINE Quaternion_T<Real>& Quaternion_T<Real>::operator=( const Quaternion_
 //----------------------------------------------------------------------
 template <typename Real>
 FORCEINLINE Quaternion_T<Real>& Quaternion_T<Real>::operator += (const Quaternion_T<Real>& q)
-{ w += qIn.w; x += qIn.x; y += qIn.y; z += qIn.z; return *this; }
+{ w += q.w; x += q.x; y += q.y; z += q.z; return *this; }
 //----------------------------------------------------------------------
 template <typename Real>
 FORCEINLINE Quaternion_T<Real>& Quaternion_T<Real>::operator -= (const Quaternion_T<Real>& q)
-{ w -= qIn.w; x -= qIn.x; y -= qIn.y; z -= qIn.z; return *this; }
+{ w -= q.w; x -= q.x; y -= q.y; z -= q.z; return *this; }
 //----------------------------------------------------------------------
 template<typename Real>
 FORCEINLINE BOOL Quaternion_T<Real>::operator == (const Quaternion_T<Real>& v)
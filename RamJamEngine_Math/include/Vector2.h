@@ -1,7 +1,9 @@
 #pragma once
 
 #include "Types.h"
-#include <DirectXMath.h>
+#if PLATFORM == PLATFORM_WIN32
+#	include <DirectXMath.h>
+#endif
 
 template <typename Real>
 struct Vector2_T
@@ -9,34 +11,38 @@ struct Vector2_T
 	Real x;
 	Real y;
 
-	Vector2_T()                   : x(), y()       {}
-	Vector2_T(Real x)             : x(x), y(x)     {}
-	Vector2_T(Real x, Real y)     : x(x), y(y)     {}
-	Vector2_T(const Vector2_T& v) : x(v.x), y(v.y) {}
+	RJE_CONSTEXPR Vector2_T()                   : x(), y()       {}
+	RJE_CONSTEXPR Vector2_T(Real x)             : x(x), y(x)     {}
+	RJE_CONSTEXPR Vector2_T(Real x, Real y)     : x(x), y(y)     {}
+	RJE_CONSTEXPR Vector2_T(const Vector2_T& v) : x(v.x), y(v.y) {}
 
 	static const Vector2_T zero;
 	static const Vector2_T one;
 
-	Vector2_T	operator +  (const Vector2_T&);
-	Vector2_T	operator -  (const Vector2_T&);
-	Vector2_T	operator -  ();
-	Vector2_T	operator /  (const Vector2_T&);
+	RJE_CONSTEXPR Vector2_T	operator +  (const Vector2_T&) const;
+	RJE_CONSTEXPR Vector2_T	operator -  (const Vector2_T&) const;
+	RJE_CONSTEXPR Vector2_T	operator -  () const;
+	RJE_CONSTEXPR Vector2_T	operator /  (const Vector2_T&) const;
 	Vector2_T	operator /  (const Real&);
-	Vector2_T	operator *  (const Real&);
+	RJE_CONSTEXPR Vector2_T	operator *  (const Real&) const;
 	Vector2_T&	operator =  (const Vector2_T&);
+#if PLATFORM == PLATFORM_WIN32
 	Vector2_T&	operator =  (const DirectX::XMFLOAT2&);
+#endif
 	Vector2_T&	operator += (const Vector2_T&);
 	Vector2_T&	operator -= (const Vector2_T&);
 	Vector2_T&	operator /= (const Vector2_T&);
 	Vector2_T&	operator /= (const Real& f);
 	Vector2_T&	operator *= (const Real& f);
-	BOOL		operator == (const Vector2_T&);
-	BOOL		operator != (const Vector2_T&);
+	RJE_CONSTEXPR BOOL		operator == (const Vector2_T&) const;
+	RJE_CONSTEXPR BOOL		operator != (const Vector2_T&) const;
 	//---------------
+#if PLATFORM == PLATFORM_WIN32
 	operator DirectX::XMFLOAT2();
+#endif
 	//---------------
 	void		Set (Real x, Real y);
-	Real		SqrMagnitude();
+	RJE_CONSTEXPR Real	SqrMagnitude() const;
 	Real		Magnitude();
 	//---------------
 	Vector2_T&	Normalize();
@@ -8,25 +8,25 @@ const Vector2_T<Real> Vector2_T<Real>::one	= Vector2_T<Real>(1.0f);
 
 //----------------------------------------------------------------------
 template <typename Real>
-FORCEINLINE Vector2_T<Real> Vector2_T<Real>::operator + (const Vector2_T<Real>& v)
+RJE_CONSTEXPR Vector2_T<Real> Vector2_T<Real>::operator + (const Vector2_T<Real>& v) const
 { return Vector2_T<Real>(this->x+v.x, this->y+v.y); }
 //----------------------------------------------------------------------
 
 //----------------------------------------------------------------------
 template <typename Real>
-FORCEINLINE Vector2_T<Real> Vector2_T<Real>::operator - (const Vector2_T<Real>& v)
+RJE_CONSTEXPR Vector2_T<Real> Vector2_T<Real>::operator - (const Vector2_T<Real>& v) const
 { return Vector2_T<Real>(this->x-v.x, this->y-v.y); }
 //----------------------------------------------------------------------
 
 //----------------------------------------------------------------------
 template <typename Real>
-FORCEINLINE Vector2_T<Real> Vector2_T<Real>::operator - ()
+RJE_CONSTEXPR Vector2_T<Real> Vector2_T<Real>::operator - () const
 { return Vector2_T<Real>(-this->x, -this->y); }
 //---------------------------------------------------------------------
 
 //----------------------------------------------------------------------
 template <typename Real>
-FORCEINLINE Vector2_T<Real> Vector2_T<Real>::operator / (const Vector2_T<Real>& v)
+RJE_CONSTEXPR Vector2_T<Real> Vector2_T<Real>::operator / (const Vector2_T<Real>& v) const
 { return Vector2_T<Real>(this->x/v.x, this->y/v.y); }
 //----------------------------------------------------------------------
 
@@ -38,19 +38,19 @@ FORCEINLINE Vector2_T<Real> Vector2_T<Real>::operator / (const Real& f)
 
 //----------------------------------------------------------------------
 template <typename Real>
-FORCEINLINE Vector2_T<Real> Vector2_T<Real>::operator * (const Real& f)
+RJE_CONSTEXPR Vector2_T<Real> Vector2_T<Real>::operator * (const Real& f) const
 { return Vector2_T<Real>(this->x*f, this->y*f); }
 //----------------------------------------------------------------------
 
 //----------------------------------------------------------------------
 template <typename Real>
-FORCEINLINE Vector2_T<Real> operator * (const Real& f, const Vector2_T<Real>&v)
+RJE_CONSTEXPR Vector2_T<Real> operator * (const Real& f, const Vector2_T<Real>&v)
 { return Vector2_T<Real>(v.x*f, v.y*f); }
 //----------------------------------------------------------------------
 
 //----------------------------------------------------------------------
 template <typename Real>
-FORCEINLINE Vector2_T<Real> operator * (const int& f, const Vector2_T<Real>&v)
+RJE_CONSTEXPR Vector2_T<Real> operator * (const int& f, const Vector2_T<Real>&v)
 { return Vector2_T<Real>(v.x*f, v.y*f); }
 //----------------------------------------------------------------------
 
@@ -61,9 +61,11 @@ FORCEINLINE Vector2_T<Real>& Vector2_T<Real>::operator = (const Vector2_T<Real>&
 //----------------------------------------------------------------------
 
 //----------------------------------------------------------------------
+#if PLATFORM == PLATFORM_WIN32		// DirectXMath interop, the DX11 backend's
 template <typename Real>
 FORCEINLINE Vector2_T<Real>& Vector2_T<Real>::operator = (const DirectX::XMFLOAT2& vIn)
 { x = vIn.x; y = vIn.y; return *this; }
+#endif
 //----------------------------------------------------------------------
 
 //----------------------------------------------------------------------
@@ -98,20 +100,22 @@ FORCEINLINE Vector2_T<Real>& Vector2_T<Real>::operator *= (const Real& f)
 
 //----------------------------------------------------------------------
 template <typename Real>
-FORCEINLINE BOOL Vector2_T<Real>::operator == (const Vector2_T<Real>& v)
+RJE_CONSTEXPR BOOL Vector2_T<Real>::operator == (const Vector2_T<Real>& v) const
 { return (x == v.x && y == v.y); }
 //----------------------------------------------------------------------
 
 //----------------------------------------------------------------------
 template <typename Real>
-FORCEINLINE BOOL Vector2_T<Real>::operator != (const Vector2_T<Real>& v)
+RJE_CONSTEXPR BOOL Vector2_T<Real>::operator != (const Vector2_T<Real>& v) const
 { return (x != v.x || y != v.y); }
 //----------------------------------------------------------------------
 
 //----------------------------------------------------------------------
+#if PLATFORM == PLATFORM_WIN32
 template <typename Real>
 Vector2_T<Real>::operator DirectX::XMFLOAT2 ()
 { return DirectX::XMFLOAT2(x, y); }
+#endif
 
 //----------------------------------------------------------------------
 template <typename Real>
@@ -121,8 +125,8 @@ FORCEINLINE void Vector2_T<Real>::Set (Real fx, Real fy)
 
 //----------------------------------------------------------------------
 template <typename Real>
-FORCEINLINE Real Vector2_T<Real>::SqrMagnitude()
-{ return x*x + y*y }
+RJE_CONSTEXPR Real Vector2_T<Real>::SqrMagnitude() const
+{ return x*x + y*y; }
 //----------------------------------------------------------------------
 
 //----------------------------------------------------------------------
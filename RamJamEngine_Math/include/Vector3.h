@@ -1,7 +1,9 @@
 #pragma once
 
 #include "Types.h"
-#include <DirectXMath.h>
+#if PLATFORM == PLATFORM_WIN32
+#	include <DirectXMath.h>
+#endif
 
 template <typename Real>
 struct Vector3_T
@@ -10,10 +12,13 @@ struct Vector3_T
 	Real y;
 	Real z;
 
-	Vector3_T()                       : x(), y(), z()          {}
-	Vector3_T(Real val)               : x(val), y(val), z(val) {}
-	Vector3_T(Real x, Real y, Real z) : x(x), y(y), z(z)       {}
-	Vector3_T(const Vector3_T& v)     : x(v.x), y(v.y), z(v.z) {}
+	RJE_CONSTEXPR Vector3_T()                       : x(), y(), z()          {}
+	RJE_CONSTEXPR Vector3_T(Real val)               : x(val), y(val), z(val) {}
+	RJE_CONSTEXPR Vector3_T(Real x, Real y, Real z) : x(x), y(y), z(z)       {}
+	RJE_CONSTEXPR Vector3_T(const Vector3_T& v)     : x(v.x), y(v.y), z(v.z) {}
+	// Precision changes (f32 <-> f64) must be spelled out at the call site.
+	template <typename Other>
+	RJE_CONSTEXPR explicit Vector3_T(const Vector3_T<Other>& v) : x(static_cast<Real>(v.x)), y(static_cast<Real>(v.y)), z(static_cast<Real>(v.z)) {}
 
 	static const Vector3_T zero;
 	static const Vector3_T one;
@@ -21,43 +26,48 @@ struct Vector3_T
 	static const Vector3_T up;
 	static const Vector3_T forward;
 
-	Vector3_T	operator +  (const Vector3_T&);
-	Vector3_T	operator -  (const Vector3_T&);
-	Vector3_T	operator -  ();
-	Vector3_T	operator /  (const Vector3_T&);
-	Vector3_T	operator /  (const Real&);
-	Vector3_T	operator *  (const Real&);
+	RJE_CONSTEXPR Vector3_T	operator +  (const Vector3_T&) const;
+	RJE_CONSTEXPR Vector3_T	operator -  (const Vector3_T&) const;
+	RJE_CONSTEXPR Vector3_T	operator -  () const;
+	RJE_CONSTEXPR Vector3_T	operator /  (const Vector3_T&) const;
+	RJE_CONSTEXPR Vector3_T	operator /  (const Real&) const;
+	RJE_CONSTEXPR Vector3_T	operator *  (const Real&) const;
 	Vector3_T&	operator =  (const Vector3_T&);
+#if PLATFORM == PLATFORM_WIN32
 	Vector3_T&	operator =  (const DirectX::XMFLOAT3&);
+#endif
 	Vector3_T&	operator += (const Vector3_T&);
 	Vector3_T&	operator -= (const Vector3_T&);
 	Vector3_T&	operator /= (const Vector3_T&);
 	Vector3_T&	operator /= (const Real& f);
 	Vector3_T&	operator *= (const Real& f);
 	//Vector3_T	operator *= (const Matrix33_T&);
-	BOOL		operator == (const Vector3_T&);
-	BOOL		operator != (const Vector3_T&);
+	RJE_CONSTEXPR BOOL		operator == (const Vector3_T&) const;
+	RJE_CONSTEXPR BOOL		operator != (const Vector3_T&) const;
 	//---------------
+#if PLATFORM == PLATFORM_WIN32
 	operator DirectX::XMFLOAT3();
+#endif
 	//---------------
 	void		Set (Real x, Real y, Real z);
-	Real		SqrMagnitude();
+	RJE_CONSTEXPR Real	SqrMagnitude() const;
 	Real		Magnitude();
-	Real		Min();
-	Real		Max();
+	RJE_CONSTEXPR Real	Min() const;
+	RJE_CONSTEXPR Real	Max() const;
 	//---------------
 	Vector3_T&	Normalize();
+	Vector3_T&	NormalizeFast();		// FastMath::RSqrt, rel. err < 3e-7: for hot loops that don't need exact unit length
 	Vector3_T&	Scale(const Vector3_T& v);
 	Vector3_T	ProjectToNorm(const Vector3_T& direction) const;
 	//---------------
 	static void			OrthoNormalize(Vector3_T &v1, Vector3_T &v2);
-	static Vector3_T	Cross         (const Vector3_T& v1, const Vector3_T& v2);
-	static Vector3_T	Scale         (const Vector3_T& v1, const Vector3_T& v2);
-	static Real			Dot           (const Vector3_T& v1, const Vector3_T& v2);
+	static RJE_CONSTEXPR Vector3_T	Cross(const Vector3_T& v1, const Vector3_T& v2);
+	static RJE_CONSTEXPR Vector3_T	Scale(const Vector3_T& v1, const Vector3_T& v2);
+	static RJE_CONSTEXPR Real		Dot  (const Vector3_T& v1, const Vector3_T& v2);
 	static Real			AngleBetween  (const Vector3_T& v1, const Vector3_T& v2);
 	//--------------------------------------------------
-	static Vector3_T	Min(const Vector3_T& v1, const Vector3_T& v2);
-	static Vector3_T	Max(const Vector3_T& v1, const Vector3_T& v2);
+	static RJE_CONSTEXPR Vector3_T	Min(const Vector3_T& v1, const Vector3_T& v2);
+	static RJE_CONSTEXPR Vector3_T	Max(const Vector3_T& v1, const Vector3_T& v2);
 	//--------------------------------------------------
 	static Vector3_T	ReflectRay(const Vector3_T& incident, const Vector3_T& normal);
 	//--------------------------------------------------
@@ -67,5 +77,6 @@ struct Vector3_T
 };
 
 typedef Vector3_T<f32> Vector3;
+typedef Vector3_T<f64> Vector3d;
 
 #include "Vector3.inl"
@@ -1,6 +1,7 @@
 //////////////////////////////////////////////////////////////////////////
 
 #include "MathHelper.h"
+#include "FastMath.h"
 
 //-----------------------------
 template <typename Real>
@@ -22,49 +23,49 @@ const Vector3_T<Real> Vector3_T<Real>::forward	= Vector3_T<Real>(0.0f, 0.0f, 1.0
 
 //----------------------------------------------------------------------
 template <typename Real>
-FORCEINLINE Vector3_T<Real> Vector3_T<Real>::operator + (const Vector3_T<Real>& v)
+RJE_CONSTEXPR Vector3_T<Real> Vector3_T<Real>::operator + (const Vector3_T<Real>& v) const
 { return Vector3_T<Real>(this->x+v.x, this->y+v.y, this->z+v.z); }
 //----------------------------------------------------------------------
 
 //----------------------------------------------------------------------
 template <typename Real>
-FORCEINLINE Vector3_T<Real> Vector3_T<Real>::operator - (const Vector3_T<Real>& v)
+RJE_CONSTEXPR Vector3_T<Real> Vector3_T<Real>::operator - (const Vector3_T<Real>& v) const
 { return Vector3_T<Real>(this->x-v.x, this->y-v.y, this->z-v.z); }
 //----------------------------------------------------------------------
 
 //----------------------------------------------------------------------
 template <typename Real>
-FORCEINLINE Vector3_T<Real> Vector3_T<Real>::operator - ()
+RJE_CONSTEXPR Vector3_T<Real> Vector3_T<Real>::operator - () const
 { return Vector3_T<Real>(-this->x, -this->y, -this->z); }
 //---------------------------------------------------------------------
 
 //----------------------------------------------------------------------
 template <typename Real>
-FORCEINLINE Vector3_T<Real> Vector3_T<Real>::operator / (const Vector3_T<Real>& v)
+RJE_CONSTEXPR Vector3_T<Real> Vector3_T<Real>::operator / (const Vector3_T<Real>& v) const
 { return Vector3_T<Real>(this->x/v.x, this->y/v.y, this->z/v.z); }
 //----------------------------------------------------------------------
 
 //----------------------------------------------------------------------
 template <typename Real>
-FORCEINLINE Vector3_T<Real> Vector3_T<Real>::operator / (const Real& f)
+RJE_CONSTEXPR Vector3_T<Real> Vector3_T<Real>::operator / (const Real& f) const
 { return Vector3_T<Real>(this->x/f, this->y/f, this->z/f); }
 //----------------------------------------------------------------------
 
 //----------------------------------------------------------------------
 template <typename Real>
-FORCEINLINE Vector3_T<Real> Vector3_T<Real>::operator * (const Real& f)
+RJE_CONSTEXPR Vector3_T<Real> Vector3_T<Real>::operator * (const Real& f) const
 { return Vector3_T<Real>(this->x*f, this->y*f, this->z*f); }
 //----------------------------------------------------------------------
 
 //----------------------------------------------------------------------
 template <typename Real>
-FORCEINLINE Vector3_T<Real> operator * (const Real& f, const Vector3_T<Real>&v)
+RJE_CONSTEXPR Vector3_T<Real> operator * (const Real& f, const Vector3_T<Real>&v)
 { return Vector3_T<Real>(v.x*f, v.y*f, v.z*f); }
 //----------------------------------------------------------------------
 
 //----------------------------------------------------------------------
 template <typename Real>
-FORCEINLINE Vector3_T<Real> operator * (const int& f, const Vector3_T<Real>&v)
+RJE_CONSTEXPR Vector3_T<Real> operator * (const int& f, const Vector3_T<Real>&v)
 { return Vector3_T<Real>(v.x*f, v.y*f, v.z*f); }
 //----------------------------------------------------------------------
 
@@ -75,9 +76,11 @@ FORCEINLINE Vector3_T<Real>& Vector3_T<Real>::operator = (const Vector3_T<Real>&
 //----------------------------------------------------------------------
 
 //----------------------------------------------------------------------
+#if PLATFORM == PLATFORM_WIN32		// DirectXMath interop, the DX11 backend's
 template <typename Real>
 FORCEINLINE Vector3_T<Real>& Vector3_T<Real>::operator = (const DirectX::XMFLOAT3& vIn)
 { x = vIn.x; y = vIn.y; z = vIn.z; return *this; }
+#endif
 //----------------------------------------------------------------------
 
 //----------------------------------------------------------------------
@@ -112,20 +115,22 @@ FORCEINLINE Vector3_T<Real>& Vector3_T<Real>::operator *= (const Real& f)
 
 //----------------------------------------------------------------------
 template <typename Real>
-FORCEINLINE BOOL Vector3_T<Real>::operator == (const Vector3_T<Real>& v)
+RJE_CONSTEXPR BOOL Vector3_T<Real>::operator == (const Vector3_T<Real>& v) const
 { return (x == v.x && y == v.y && z == v.z); }
 //----------------------------------------------------------------------
 
 //----------------------------------------------------------------------
 template <typename Real>
-FORCEINLINE BOOL Vector3_T<Real>::operator != (const Vector3_T<Real>& v)
+RJE_CONSTEXPR BOOL Vector3_T<Real>::operator != (const Vector3_T<Real>& v) const
 { return (x != v.x || y != v.y || z != v.z); }
 //----------------------------------------------------------------------
 
 //----------------------------------------------------------------------
+#if PLATFORM == PLATFORM_WIN32
 template <typename Real>
 Vector3_T<Real>::operator DirectX::XMFLOAT3 ()
 { return DirectX::XMFLOAT3(x, y, z); }
+#endif
 
 //----------------------------------------------------------------------
 template <typename Real>
@@ -135,7 +140,7 @@ FORCEINLINE void Vector3_T<Real>::Set (Real fx, Real fy, Real fz)
 
 //----------------------------------------------------------------------
 template <typename Real>
-FORCEINLINE Real Vector3_T<Real>::SqrMagnitude()
+RJE_CONSTEXPR Real Vector3_T<Real>::SqrMagnitude() const
 { return x*x + y*y + z*z; }
 //----------------------------------------------------------------------
 
@@ -147,13 +152,13 @@ FORCEINLINE Real Vector3_T<Real>::Magnitude()
 
 //----------------------------------------------------------------------
 template <typename Real>
-FORCEINLINE Real Vector3_T<Real>::Min()
+RJE_CONSTEXPR Real Vector3_T<Real>::Min() const
 { return x>y ? (y>z ? z : y) : (x>z ? z : x); }
 //----------------------------------------------------------------------
 
 //----------------------------------------------------------------------
 template <typename Real>
-FORCEINLINE Real Vector3_T<Real>::Max()
+RJE_CONSTEXPR Real Vector3_T<Real>::Max() const
 { return x>y ? (x>z ? x : z) : (y>z ? y : z); }
 //----------------------------------------------------------------------
 
@@ -167,6 +172,15 @@ FORCEINLINE Vector3_T<Real>& Vector3_T<Real>::Normalize()
 	return *this;
 }
 //----------------------------------------------------------------------
+template <typename Real>
+FORCEINLINE Vector3_T<Real>& Vector3_T<Real>::NormalizeFast()
+{
+	Real sqrMag = SqrMagnitude();
+	if (!RJE::Math::IsZero(sqrMag))
+		*this *= static_cast<Real>(RJE::FastMath::RSqrt(static_cast<f32>(sqrMag)));
+	return *this;
+}
+//----------------------------------------------------------------------
 
 //----------------------------------------------------------------------
 template <typename Real>
@@ -199,19 +213,19 @@ FORCEINLINE void Vector3_T<Real>::OrthoNormalize(Vector3_T &v1, Vector3_T &v2)
 
 //----------------------------------------------------------------------
 template <typename Real>
-FORCEINLINE Vector3_T<Real> Vector3_T<Real>::Cross(const Vector3_T& v1, const Vector3_T& v2)
+RJE_CONSTEXPR Vector3_T<Real> Vector3_T<Real>::Cross(const Vector3_T& v1, const Vector3_T& v2)
 { return Vector3_T<Real>( v1.y*v2.z - v1.z*v2.y, v1.z*v2.x - v1.x*v2.z, v1.x*v2.y - v1.y*v2.x); }
 //----------------------------------------------------------------------
 
 //----------------------------------------------------------------------
 template <typename Real>
-FORCEINLINE Real Vector3_T<Real>::Dot(const Vector3_T& v1, const Vector3_T& v2)
+RJE_CONSTEXPR Real Vector3_T<Real>::Dot(const Vector3_T& v1, const Vector3_T& v2)
 { return v1.x*v2.x + v1.y*v2.y + v1.z*v2.z; }
 //----------------------------------------------------------------------
 
 //----------------------------------------------------------------------
 template <typename Real>
-FORCEINLINE Vector3_T<Real> Vector3_T<Real>::Scale(const Vector3_T& v1, const Vector3_T& v2)
+RJE_CONSTEXPR Vector3_T<Real> Vector3_T<Real>::Scale(const Vector3_T& v1, const Vector3_T& v2)
 { return Vector3_T<Real>(v1.x*v2.x, v1.y*v2.y, v1.z*v2.z); }
 //----------------------------------------------------------------------
 
@@ -229,29 +243,21 @@ FORCEINLINE Real Vector3_T<Real>::AngleBetween(const Vector3_T& v1, const Vector
 
 //----------------------------------------------------------------------
 template <typename Real>
-FORCEINLINE Vector3_T<Real> Vector3_T<Real>::Min(const Vector3_T<Real>& v1, const Vector3_T<Real>& v2)
+RJE_CONSTEXPR Vector3_T<Real> Vector3_T<Real>::Min(const Vector3_T<Real>& v1, const Vector3_T<Real>& v2)
 {
-	Vector3_T<Real> out;
-
-	out.x = v1.x < v2.x ? v1.x : v2.x;
-	out.y = v1.y < v2.y ? v1.y : v2.y;
-	out.z = v1.z < v2.z ? v1.z : v2.z;
-
-	return out;
+	return Vector3_T<Real>(	v1.x < v2.x ? v1.x : v2.x,
+							v1.y < v2.y ? v1.y : v2.y,
+							v1.z < v2.z ? v1.z : v2.z);
 }
 //----------------------------------------------------------------------
 
 //----------------------------------------------------------------------
 template <typename Real>
-FORCEINLINE Vector3_T<Real> Vector3_T<Real>::Max(const Vector3_T<Real>& v1, const Vector3_T<Real>& v2)
+RJE_CONSTEXPR Vector3_T<Real> Vector3_T<Real>::Max(const Vector3_T<Real>& v1, const Vector3_T<Real>& v2)
 {
-	Vector3_T<Real> out;
-
-	out.x = v1.x > v2.x ? v1.x : v2.x;
-	out.y = v1.y > v2.y ? v1.y : v2.y;
-	out.z = v1.z > v2.z ? v1.z : v2.z;
-
-	return out;
+	return Vector3_T<Real>(	v1.x > v2.x ? v1.x : v2.x,
+							v1.y > v2.y ? v1.y : v2.y,
+							v1.z > v2.z ? v1.z : v2.z);
 }
 //---------------------------------------------------------------------
 
@@ -298,8 +304,8 @@ FORCEINLINE Vector3_T<Real> Vector3_T<Real>::RandUnitSphere()
 template <typename Real>
 FORCEINLINE Vector3_T<Real> Vector3_T<Real>::RandUnitHemisphere(Vector3_T<Real> normal)
 {
-	Real One  = static_cast<1.0f>;
-	Real Zero = static_cast<0.0f>;
+	Real One  = static_cast<Real>(1.0f);
+	Real Zero = static_cast<Real>(0.0f);
 
 	// Keep trying until we get a point on/in the hemisphere.
 	while(true)
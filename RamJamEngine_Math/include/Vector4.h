@@ -1,8 +1,10 @@
 #pragma once
 
 #include "Types.h"
-#include <DirectXMath.h>
-#include <DirectXPackedVector.h>
+#if PLATFORM == PLATFORM_WIN32
+#	include <DirectXMath.h>
+#	include <DirectXPackedVector.h>
+#endif
 
 template <typename Real>
 struct Vector4_T
@@ -12,45 +14,49 @@ struct Vector4_T
 	Real y;
 	Real z;
 
-	Vector4_T()                                 : w()   , x(),    y(),    z()        {}
-	Vector4_T(Real val)                         : w(val), x(val), y(val), z(val)     {}
-	Vector4_T(Real w, Real x, Real y, Real z)   : w(w)  , x(x),   y(y),   z(z)       {}
-	Vector4_T(const Vector3_T<Real>& v, Real z) : w(v.x)  , x(v.y),   y(v.z),   z(z) {}
-	Vector4_T(const Vector4_T& v)               : w(v.w), x(v.x), y(v.y), z(v.z)     {}
+	RJE_CONSTEXPR Vector4_T()                                 : w()   , x(),    y(),    z()        {}
+	RJE_CONSTEXPR Vector4_T(Real val)                         : w(val), x(val), y(val), z(val)     {}
+	RJE_CONSTEXPR Vector4_T(Real w, Real x, Real y, Real z)   : w(w)  , x(x),   y(y),   z(z)       {}
+	RJE_CONSTEXPR Vector4_T(const Vector3_T<Real>& v, Real z) : w(v.x)  , x(v.y),   y(v.z),   z(z) {}
+	RJE_CONSTEXPR Vector4_T(const Vector4_T& v)               : w(v.w), x(v.x), y(v.y), z(v.z)     {}
 
 	static const Vector4_T zero;
 	static const Vector4_T one;
 
-	Vector4_T	operator +  (const Vector4_T&);
-	Vector4_T	operator -  (const Vector4_T&);
-	Vector4_T	operator -  ();
-	Vector4_T	operator /  (const Vector4_T&);
+	RJE_CONSTEXPR Vector4_T	operator +  (const Vector4_T&) const;
+	RJE_CONSTEXPR Vector4_T	operator -  (const Vector4_T&) const;
+	RJE_CONSTEXPR Vector4_T	operator -  () const;
+	RJE_CONSTEXPR Vector4_T	operator /  (const Vector4_T&) const;
 	Vector4_T	operator /  (const Real&);
-	Vector4_T	operator *  (const Real&);
-	Vector4_T	operator *  (const Vector4_T&);
+	RJE_CONSTEXPR Vector4_T	operator *  (const Real&) const;
+	RJE_CONSTEXPR Vector4_T	operator *  (const Vector4_T&) const;
 	Vector4_T&	operator =  (const Vector4_T&);
+#if PLATFORM == PLATFORM_WIN32
 	Vector4_T&	operator =  (const DirectX::XMFLOAT4&);
 	Vector4_T&	operator =  (const DirectX::PackedVector::XMCOLOR&);
+#endif
 	Vector4_T&	operator += (const Vector4_T&);
 	Vector4_T&	operator -= (const Vector4_T&);
 	Vector4_T&	operator /= (const Vector4_T&);
 	Vector4_T&	operator /= (const Real& f);
 	Vector4_T&	operator *= (const Real& f);
-	BOOL		operator == (const Vector4_T&);
-	BOOL		operator != (const Vector4_T&);
+	RJE_CONSTEXPR BOOL		operator == (const Vector4_T&) const;
+	RJE_CONSTEXPR BOOL		operator != (const Vector4_T&) const;
 	//---------------
+#if PLATFORM == PLATFORM_WIN32
 	operator DirectX::XMFLOAT4();
 	operator DirectX::PackedVector::XMCOLOR();
+#endif
 	//---------------
 	void		Set (Real w, Real x, Real y, Real z);
-	Real		SqrMagnitude();
+	RJE_CONSTEXPR Real	SqrMagnitude() const;
 	Real		Magnitude();
 	Real		Min();
 	Real		Max();
 	Vector4_T	Minimize(const Vector4_T& v1, const Vector4_T& v2);
 	Vector4_T	Maximize(const Vector4_T& v1, const Vector4_T& v2);
 	//---------------
-	static Real			Dot(const Vector4_T& v1, const Vector4_T& v2);
+	static RJE_CONSTEXPR Real	Dot(const Vector4_T& v1, const Vector4_T& v2);
 	static Vector4_T	Min(const Vector4_T& v1, const Vector4_T& v2);
 	static Vector4_T	Max(const Vector4_T& v1, const Vector4_T& v2);
 	//---------------
@@ -13,25 +13,25 @@ const Vector4_T<Real> Vector4_T<Real>::one	= Vector4_T<Real>(1.0f);
 
 //----------------------------------------------------------------------
 template <typename Real>
-FORCEINLINE Vector4_T<Real> Vector4_T<Real>::operator + (const Vector4_T<Real>& v)
+RJE_CONSTEXPR Vector4_T<Real> Vector4_T<Real>::operator + (const Vector4_T<Real>& v) const
 { return Vector4_T<Real>(this->w+v.w, this->x+v.x, this->y+v.y, this->z+v.z); }
 //----------------------------------------------------------------------
 
 //----------------------------------------------------------------------
 template <typename Real>
-FORCEINLINE Vector4_T<Real> Vector4_T<Real>::operator - (const Vector4_T<Real>& v)
+RJE_CONSTEXPR Vector4_T<Real> Vector4_T<Real>::operator - (const Vector4_T<Real>& v) const
 { return Vector4_T<Real>(this->w-v.w, this->x-v.x, this->y-v.y, this->z-v.z); }
 //----------------------------------------------------------------------
 
 //----------------------------------------------------------------------
 template <typename Real>
-FORCEINLINE Vector4_T<Real> Vector4_T<Real>::operator - ()
+RJE_CONSTEXPR Vector4_T<Real> Vector4_T<Real>::operator - () const
 { return Vector4_T<Real>(-this->w, -this->x, -this->y, -this->z); }
 //---------------------------------------------------------------------
 
 //----------------------------------------------------------------------
 template <typename Real>
-FORCEINLINE Vector4_T<Real> Vector4_T<Real>::operator / (const Vector4_T<Real>& v)
+RJE_CONSTEXPR Vector4_T<Real> Vector4_T<Real>::operator / (const Vector4_T<Real>& v) const
 { return Vector4_T<Real>(this->w/v.w, this->x/v.x, this->y/v.y, this->z/v.z); }
 //----------------------------------------------------------------------
 
@@ -43,25 +43,25 @@ FORCEINLINE Vector4_T<Real> Vector4_T<Real>::operator / (const Real& f)
 
 //----------------------------------------------------------------------
 template <typename Real>
-FORCEINLINE Vector4_T<Real> Vector4_T<Real>::operator * (const Real& f)
+RJE_CONSTEXPR Vector4_T<Real> Vector4_T<Real>::operator * (const Real& f) const
 { return Vector4_T<Real>(this->w*f, this->x*f, this->y*f, this->z*f); }
 //----------------------------------------------------------------------
 
 //----------------------------------------------------------------------
 template <typename Real>
-FORCEINLINE Vector4_T<Real> Vector4_T<Real>::operator * (const Vector4_T<Real>&v)
+RJE_CONSTEXPR Vector4_T<Real> Vector4_T<Real>::operator * (const Vector4_T<Real>&v) const
 { return Vector4_T<Real>(this->w*v.w, this->x*v.x, this->y*v.y, this->z*v.z); }
 //----------------------------------------------------------------------
 
 //----------------------------------------------------------------------
 template <typename Real>
-FORCEINLINE Vector4_T<Real> operator * (const Real& f, const Vector4_T<Real>&v)
+RJE_CONSTEXPR Vector4_T<Real> operator * (const Real& f, const Vector4_T<Real>&v)
 { return Vector4_T<Real>(v.w*f, v.x*f, v.y*f, v.z*f); }
 //----------------------------------------------------------------------
 
 //----------------------------------------------------------------------
 template <typename Real>
-FORCEINLINE Vector4_T<Real> operator * (const int& f, const Vector4_T<Real>&v)
+RJE_CONSTEXPR Vector4_T<Real> operator * (const int& f, const Vector4_T<Real>&v)
 { return Vector4_T<Real>(v.w*f, v.x*f, v.y*f, v.z*f); }
 //----------------------------------------------------------------------
 
@@ -72,15 +72,19 @@ FORCEINLINE Vector4_T<Real>& Vector4_T<Real>::operator = (const Vector4_T<Real>&
 //----------------------------------------------------------------------
 
 //----------------------------------------------------------------------
+#if PLATFORM == PLATFORM_WIN32		// DirectXMath interop, the DX11 backend's
 template <typename Real>
 FORCEINLINE Vector4_T<Real>& Vector4_T<Real>::operator = (const DirectX::XMFLOAT4& vIn)
 { w = vIn.x; x = vIn.y; y = vIn.z; z = vIn.w; return *this; }
+#endif
 //----------------------------------------------------------------------
 
 //----------------------------------------------------------------------
+#if PLATFORM == PLATFORM_WIN32
 template <typename Real>
 FORCEINLINE Vector4_T<Real>& Vector4_T<Real>::operator = (const DirectX::PackedVector::XMCOLOR& vIn)
 { w = vIn.a; x = vIn.r; y = vIn.g; z = vIn.b; return *this; }
+#endif
 //----------------------------------------------------------------------
 
 //----------------------------------------------------------------------
@@ -115,26 +119,30 @@ FORCEINLINE Vector4_T<Real>& Vector4_T<Real>::operator *= (const Real& f)
 
 //----------------------------------------------------------------------
 template <typename Real>
-FORCEINLINE BOOL Vector4_T<Real>::operator == (const Vector4_T<Real>& v)
+RJE_CONSTEXPR BOOL Vector4_T<Real>::operator == (const Vector4_T<Real>& v) const
 { return (w == v.w && x == v.x && y == v.y && z == v.z); }
 //----------------------------------------------------------------------
 
 //----------------------------------------------------------------------
 template <typename Real>
-FORCEINLINE BOOL Vector4_T<Real>::operator != (const Vector4_T<Real>& v)
+RJE_CONSTEXPR BOOL Vector4_T<Real>::operator != (const Vector4_T<Real>& v) const
 { return (w != v.w || x != v.x || y != v.y || z != v.z); }
 //----------------------------------------------------------------------
 
 //----------------------------------------------------------------------
+#if PLATFORM == PLATFORM_WIN32
 template <typename Real>
 Vector4_T<Real>::operator DirectX::XMFLOAT4 ()
 { return DirectX::XMFLOAT4(w, x, y, z); }
+#endif
 //----------------------------------------------------------------------
 
 //----------------------------------------------------------------------
+#if PLATFORM == PLATFORM_WIN32
 template <typename Real>
 Vector4_T<Real>::operator DirectX::PackedVector::XMCOLOR ()
 { return DirectX::PackedVector::XMCOLOR(w, x, y, z); }
+#endif
 //----------------------------------------------------------------------
 
 
@@ -146,8 +154,8 @@ FORCEINLINE void Vector4_T<Real>::Set (Real fw, Real fx, Real fy, Real fz)
 
 //----------------------------------------------------------------------
 template <typename Real>
-FORCEINLINE Real Vector4_T<Real>::SqrMagnitude()
-{ return w*w + x*x + y*y + z*z }
+RJE_CONSTEXPR Real Vector4_T<Real>::SqrMagnitude() const
+{ return w*w + x*x + y*y + z*z; }
 //----------------------------------------------------------------------
 
 //----------------------------------------------------------------------
@@ -170,7 +178,7 @@ FORCEINLINE Real Vector4_T<Real>::Max()
 
 //----------------------------------------------------------------------
 template <typename Real>
-FORCEINLINE Real Vector4_T<Real>::Dot(const Vector4_T& v1, const Vector4_T& v2)
+RJE_CONSTEXPR Real Vector4_T<Real>::Dot(const Vector4_T& v1, const Vector4_T& v2)
 { return v1.w*v2.w + v1.x*v2.x + v1.y*v2.y + v1.z*v2.z; }
 //----------------------------------------------------------------------
 
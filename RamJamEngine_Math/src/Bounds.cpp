@@ -0,0 +1,471 @@
+#include "Bounds.h"
+#include "Debug.h"
+
+#include <emmintrin.h>
+
+namespace
+{
+	//----------------------------------------------------------------------
+	FORCEINLINE Vector3 TransformPoint(const Vector3& p, const Matrix44& m)
+	{
+		return Vector3(	p.x*m.m11 + p.y*m.m21 + p.z*m.m31 + m.m41,
+						p.x*m.m12 + p.y*m.m22 + p.z*m.m32 + m.m42,
+						p.x*m.m13 + p.y*m.m23 + p.z*m.m33 + m.m43);
+	}
+	//----------------------------------------------------------------------
+	FORCEINLINE Vector3 Row(const Matrix44& m, u32 i)
+	{
+		switch (i)
+		{
+		case 0:		return Vector3(m.m11, m.m12, m.m13);
+		case 1:		return Vector3(m.m21, m.m22, m.m23);
+		default:	return Vector3(m.m31, m.m32, m.m33);
+		}
+	}
+	//----------------------------------------------------------------------
+	FORCEINLINE f32 Get(const Vector3& v, u32 i)
+	{ return i == 0 ? v.x : (i == 1 ? v.y : v.z); }
+	//----------------------------------------------------------------------
+
+	//----------------------------------------------------------------------
+	// Slab test on one axis; returns false when the ray misses
+	FORCEINLINE BOOL Slab(f32 origin, f32 dir, f32 slabMin, f32 slabMax, f32& tMin, f32& tMax)
+	{
+		if (fabsf(dir) < 1e-12f)
+			return origin >= slabMin && origin <= slabMax;
+
+		f32 invDir = 1.0f / dir;
+		f32 t0 = (slabMin - origin) * invDir;
+		f32 t1 = (slabMax - origin) * invDir;
+		if (t0 > t1) { f32 tmp = t0; t0 = t1; t1 = tmp; }
+		if (t0 > tMin) tMin = t0;
+		if (t1 < tMax) tMax = t1;
+		return tMin <= tMax;
+	}
+	//----------------------------------------------------------------------
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Plane
+//////////////////////////////////////////////////////////////////////////
+Plane Plane::FromPoints(const Vector3& a, const Vector3& b, const Vector3& c)
+{
+	Vector3 n = Vector3::Cross(b - a, c - a);
+	n.Normalize();
+	return FromPointNormal(a, n);
+}
+
+//----------------------------------------------------------------------
+Plane& Plane::Normalize()
+{
+	f32 mag = normal.Magnitude();
+	if (!RJE::Math::IsZero(mag))
+	{
+		f32 invMag = 1.0f / mag;
+		normal *= invMag;
+		d      *= invMag;
+	}
+	return *this;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Sphere
+//////////////////////////////////////////////////////////////////////////
+Sphere Sphere::FromAABB(const AABB& box)
+{
+	Vector3 extents = box.extents;
+	return Sphere(box.center, extents.Magnitude());
+}
+
+//----------------------------------------------------------------------
+Sphere Sphere::Merge(const Sphere& a, const Sphere& b)
+{
+	Vector3 delta = b.center - a.center;
+	f32 dist = delta.Magnitude();
+
+	if (dist + b.radius <= a.radius)	return a;
+	if (dist + a.radius <= b.radius)	return b;
+
+	f32 radius = 0.5f * (dist + a.radius + b.radius);
+	return Sphere(a.center + delta * ((radius - a.radius) / dist), radius);
+}
+
+//----------------------------------------------------------------------
+Sphere Sphere::Transform(const Matrix44& m) const
+{
+	f32 maxSqrScale = RJE::Math::Max(Row(m,0).SqrMagnitude(), RJE::Math::Max(Row(m,1).SqrMagnitude(), Row(m,2).SqrMagnitude()));
+	return Sphere(TransformPoint(center, m), radius * sqrtf(maxSqrScale));
+}
+
+//////////////////////////////////////////////////////////////////////////
+// AABB
+//////////////////////////////////////////////////////////////////////////
+AABB AABB::FromPoints(const Vector3* points, u32 count)
+{
+	RJE_ASSERT(count > 0);
+
+	Vector3 vMin = points[0];
+	Vector3 vMax = points[0];
+	for (u32 i = 1; i < count; ++i)
+	{
+		vMin = Vector3::Min(vMin, points[i]);
+		vMax = Vector3::Max(vMax, points[i]);
+	}
+	return FromMinMax(vMin, vMax);
+}
+
+//----------------------------------------------------------------------
+void AABB::Corners(Vector3 outCorners[8]) const
+{
+	for (u32 i = 0; i < 8; ++i)
+	{
+		outCorners[i] = Vector3(	center.x + ((i & 1) ? extents.x : -extents.x),
+									center.y + ((i & 2) ? extents.y : -extents.y),
+									center.z + ((i & 4) ? extents.z : -extents.z));
+	}
+}
+
+//----------------------------------------------------------------------
+AABB AABB::Transform(const Matrix44& m) const
+{
+	// new extents = |M3x3|^T * extents
+	Vector3 newExtents(	fabsf(m.m11)*extents.x + fabsf(m.m21)*extents.y + fabsf(m.m31)*extents.z,
+						fabsf(m.m12)*extents.x + fabsf(m.m22)*extents.y + fabsf(m.m32)*extents.z,
+						fabsf(m.m13)*extents.x + fabsf(m.m23)*extents.y + fabsf(m.m33)*extents.z);
+	return AABB(TransformPoint(center, m), newExtents);
+}
+
+//----------------------------------------------------------------------
+BOOL AABB::Intersects(const Sphere& s) const
+{
+	// Squared distance from the sphere center to the box
+	f32 sqrDist = 0.0f;
+	for (u32 i = 0; i < 3; ++i)
+	{
+		f32 delta = fabsf(Get(s.center, i) - Get(center, i)) - Get(extents, i);
+		if (delta > 0.0f)
+			sqrDist += delta*delta;
+	}
+	return sqrDist <= s.radius*s.radius;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// OBB
+//////////////////////////////////////////////////////////////////////////
+OBB OBB::FromAABB(const AABB& box, const Matrix44& m)
+{
+	OBB obb;
+	obb.center = TransformPoint(box.center, m);
+	for (u32 i = 0; i < 3; ++i)
+	{
+		Vector3 axis  = Row(m, i);
+		f32     scale = axis.Magnitude();
+		obb.axes[i] = RJE::Math::IsZero(scale) ? Vector3::zero : axis / scale;
+		switch (i)
+		{
+		case 0:		obb.extents.x = box.extents.x * scale;	break;
+		case 1:		obb.extents.y = box.extents.y * scale;	break;
+		default:	obb.extents.z = box.extents.z * scale;	break;
+		}
+	}
+	return obb;
+}
+
+//----------------------------------------------------------------------
+void OBB::Corners(Vector3 outCorners[8]) const
+{
+	for (u32 i = 0; i < 8; ++i)
+	{
+		outCorners[i] = center	+ axes[0] * ((i & 1) ? extents.x : -extents.x)
+								+ axes[1] * ((i & 2) ? extents.y : -extents.y)
+								+ axes[2] * ((i & 4) ? extents.z : -extents.z);
+	}
+}
+
+//----------------------------------------------------------------------
+BOOL OBB::Contains(const Vector3& p) const
+{
+	Vector3 delta = p - center;
+	for (u32 i = 0; i < 3; ++i)
+		if (fabsf(Vector3::Dot(delta, axes[i])) > Get(extents, i))
+			return false;
+	return true;
+}
+
+//----------------------------------------------------------------------
+BOOL OBB::Intersects(const OBB& box) const
+{
+	// Separating axis theorem (Gottschalk): 3 + 3 face axes and 9 edge cross products,
+	// everything expressed in this box's frame.
+	const f32 epsilon = 1e-6f;	// keeps near-parallel edges from producing garbage axes
+
+	f32 R[3][3], absR[3][3];
+	for (u32 i = 0; i < 3; ++i)
+	{
+		for (u32 j = 0; j < 3; ++j)
+		{
+			R[i][j]    = Vector3::Dot(axes[i], box.axes[j]);
+			absR[i][j] = fabsf(R[i][j]) + epsilon;
+		}
+	}
+
+	Vector3 delta = box.center - center;
+	f32 t[3] = { Vector3::Dot(delta, axes[0]), Vector3::Dot(delta, axes[1]), Vector3::Dot(delta, axes[2]) };
+	f32 a[3] = { extents.x, extents.y, extents.z };
+	f32 b[3] = { box.extents.x, box.extents.y, box.extents.z };
+
+	for (u32 i = 0; i < 3; ++i)
+	{
+		if (fabsf(t[i]) > a[i] + b[0]*absR[i][0] + b[1]*absR[i][1] + b[2]*absR[i][2])
+			return false;
+	}
+	for (u32 j = 0; j < 3; ++j)
+	{
+		if (fabsf(t[0]*R[0][j] + t[1]*R[1][j] + t[2]*R[2][j]) > a[0]*absR[0][j] + a[1]*absR[1][j] + a[2]*absR[2][j] + b[j])
+			return false;
+	}
+	for (u32 i = 0; i < 3; ++i)
+	{
+		u32 i1 = (i+1) % 3, i2 = (i+2) % 3;
+		for (u32 j = 0; j < 3; ++j)
+		{
+			u32 j1 = (j+1) % 3, j2 = (j+2) % 3;
+			f32 ra = a[i1]*absR[i2][j] + a[i2]*absR[i1][j];
+			f32 rb = b[j1]*absR[i][j2] + b[j2]*absR[i][j1];
+			if (fabsf(t[i2]*R[i1][j] - t[i1]*R[i2][j]) > ra + rb)
+				return false;
+		}
+	}
+	return true;
+}
+
+//----------------------------------------------------------------------
+BOOL OBB::Intersects(const Sphere& s) const
+{
+	Vector3 delta = s.center - center;
+	f32 sqrDist = 0.0f;
+	for (u32 i = 0; i < 3; ++i)
+	{
+		f32 excess = fabsf(Vector3::Dot(delta, axes[i])) - Get(extents, i);
+		if (excess > 0.0f)
+			sqrDist += excess*excess;
+	}
+	return sqrDist <= s.radius*s.radius;
+}
+
+//----------------------------------------------------------------------
+BOOL OBB::Intersects(const Plane& p) const
+{
+	f32 r =	extents.x * fabsf(Vector3::Dot(p.normal, axes[0])) +
+			extents.y * fabsf(Vector3::Dot(p.normal, axes[1])) +
+			extents.z * fabsf(Vector3::Dot(p.normal, axes[2]));
+	f32 dist = p.Distance(center);
+	return dist <= r && dist >= -r;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Ray
+//////////////////////////////////////////////////////////////////////////
+BOOL Ray::Intersects(const Plane& p, OUT f32& outT) const
+{
+	f32 denom = Vector3::Dot(p.normal, direction);
+	f32 dist  = p.Distance(origin);
+	if (fabsf(denom) < 1e-12f)
+	{
+		outT = 0.0f;
+		return dist == 0.0f;
+	}
+
+	f32 t = -dist / denom;
+	if (t < 0.0f)
+		return false;
+	outT = t;
+	return true;
+}
+
+//----------------------------------------------------------------------
+BOOL Ray::Intersects(const Sphere& s, OUT f32& outT) const
+{
+	Vector3 m = origin - s.center;
+	f32 b = Vector3::Dot(m, direction);
+	f32 c = m.SqrMagnitude() - s.radius*s.radius;
+
+	if (c > 0.0f && b > 0.0f)			// outside and pointing away
+		return false;
+	f32 discr = b*b - c;
+	if (discr < 0.0f)
+		return false;
+
+	f32 t = -b - sqrtf(discr);
+	outT = t < 0.0f ? 0.0f : t;
+	return true;
+}
+
+//----------------------------------------------------------------------
+BOOL Ray::Intersects(const AABB& box, OUT f32& outT) const
+{
+	Vector3 vMin = box.Min();
+	Vector3 vMax = box.Max();
+	f32 tMin = 0.0f;
+	f32 tMax = FLT_MAX;
+	if (!Slab(origin.x, direction.x, vMin.x, vMax.x, tMin, tMax) ||
+		!Slab(origin.y, direction.y, vMin.y, vMax.y, tMin, tMax) ||
+		!Slab(origin.z, direction.z, vMin.z, vMax.z, tMin, tMax))
+		return false;
+	outT = tMin;
+	return true;
+}
+
+//----------------------------------------------------------------------
+BOOL Ray::Intersects(const OBB& box, OUT f32& outT) const
+{
+	// Same slab test in the box frame
+	Vector3 delta = origin - box.center;
+	f32 tMin = 0.0f;
+	f32 tMax = FLT_MAX;
+	for (u32 i = 0; i < 3; ++i)
+	{
+		f32 e = Get(box.extents, i);
+		if (!Slab(Vector3::Dot(delta, box.axes[i]), Vector3::Dot(direction, box.axes[i]), -e, e, tMin, tMax))
+			return false;
+	}
+	outT = tMin;
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Frustum
+//////////////////////////////////////////////////////////////////////////
+Frustum Frustum::FromViewProj(const Matrix44& m)
+{
+	// Gribb/Hartmann: with p * M = (x,y,z,w), each clip inequality is a plane
+	// made of a combination of M's columns.
+	Frustum f;
+	f.planes[Left]   = Plane(m.m14 + m.m11, m.m24 + m.m21, m.m34 + m.m31, m.m44 + m.m41);	// -w <= x
+	f.planes[Right]  = Plane(m.m14 - m.m11, m.m24 - m.m21, m.m34 - m.m31, m.m44 - m.m41);	//  x <= w
+	f.planes[Bottom] = Plane(m.m14 + m.m12, m.m24 + m.m22, m.m34 + m.m32, m.m44 + m.m42);	// -w <= y
+	f.planes[Top]    = Plane(m.m14 - m.m12, m.m24 - m.m22, m.m34 - m.m32, m.m44 - m.m42);	//  y <= w
+	f.planes[Near]   = Plane(m.m13,         m.m23,         m.m33,         m.m43);			//  0 <= z
+	f.planes[Far]    = Plane(m.m14 - m.m13, m.m24 - m.m23, m.m34 - m.m33, m.m44 - m.m43);	//  z <= w
+	for (u32 i = 0; i < PlaneCount; ++i)
+		f.planes[i].Normalize();
+	return f;
+}
+
+//----------------------------------------------------------------------
+BOOL Frustum::Intersects(const OBB& box) const
+{
+	for (u32 i = 0; i < PlaneCount; ++i)
+	{
+		const Plane& p = planes[i];
+		f32 r =	box.extents.x * fabsf(Vector3::Dot(p.normal, box.axes[0])) +
+				box.extents.y * fabsf(Vector3::Dot(p.normal, box.axes[1])) +
+				box.extents.z * fabsf(Vector3::Dot(p.normal, box.axes[2]));
+		if (p.Distance(box.center) < -r)
+			return false;
+	}
+	return true;
+}
+
+//----------------------------------------------------------------------
+Frustum::Containment Frustum::Classify(const Sphere& s) const
+{
+	Containment result = Inside;
+	for (u32 i = 0; i < PlaneCount; ++i)
+	{
+		f32 dist = planes[i].Distance(s.center);
+		if (dist < -s.radius)
+			return Outside;
+		if (dist < s.radius)
+			result = Intersecting;
+	}
+	return result;
+}
+
+//----------------------------------------------------------------------
+Frustum::Containment Frustum::Classify(const AABB& box) const
+{
+	Containment result = Inside;
+	for (u32 i = 0; i < PlaneCount; ++i)
+	{
+		const Plane& p = planes[i];
+		f32 r = fabsf(p.normal.x)*box.extents.x + fabsf(p.normal.y)*box.extents.y + fabsf(p.normal.z)*box.extents.z;
+		f32 dist = p.Distance(box.center);
+		if (dist < -r)
+			return Outside;
+		if (dist < r)
+			result = Intersecting;
+	}
+	return result;
+}
+
+//----------------------------------------------------------------------
+// Batch tests: 4 volumes are transposed into SoA registers and tested
+// against one plane at a time, with the same operation order as the scalar
+// versions so both paths agree bit for bit.
+void Frustum::Intersects(const Sphere* spheres, u32 count, OUT BOOL* outVisible) const
+{
+	u32 i = 0;
+	for (; i+4 <= count; i+=4)
+	{
+		const Sphere* s = spheres + i;
+		__m128 cx = _mm_setr_ps(s[0].center.x, s[1].center.x, s[2].center.x, s[3].center.x);
+		__m128 cy = _mm_setr_ps(s[0].center.y, s[1].center.y, s[2].center.y, s[3].center.y);
+		__m128 cz = _mm_setr_ps(s[0].center.z, s[1].center.z, s[2].center.z, s[3].center.z);
+		__m128 negRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_setr_ps(s[0].radius, s[1].radius, s[2].radius, s[3].radius));
+
+		__m128 outside = _mm_setzero_ps();
+		for (u32 iPlane = 0; iPlane < PlaneCount; ++iPlane)
+		{
+			const Plane& p = planes[iPlane];
+			__m128 dist = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(p.normal.x), cx), _mm_mul_ps(_mm_set1_ps(p.normal.y), cy)), _mm_mul_ps(_mm_set1_ps(p.normal.z), cz)), _mm_set1_ps(p.d));
+			outside = _mm_or_ps(outside, _mm_cmplt_ps(dist, negRadius));
+		}
+
+		i32 mask = _mm_movemask_ps(outside);
+		outVisible[i+0] = (mask & 1) == 0;
+		outVisible[i+1] = (mask & 2) == 0;
+		outVisible[i+2] = (mask & 4) == 0;
+		outVisible[i+3] = (mask & 8) == 0;
+	}
+	for (; i < count; ++i)
+		outVisible[i] = Intersects(spheres[i]);
+}
+
+//----------------------------------------------------------------------
+void Frustum::Intersects(const AABB* boxes, u32 count, OUT BOOL* outVisible) const
+{
+	const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+
+	u32 i = 0;
+	for (; i+4 <= count; i+=4)
+	{
+		const AABB* b = boxes + i;
+		__m128 cx = _mm_setr_ps(b[0].center.x,  b[1].center.x,  b[2].center.x,  b[3].center.x);
+		__m128 cy = _mm_setr_ps(b[0].center.y,  b[1].center.y,  b[2].center.y,  b[3].center.y);
+		__m128 cz = _mm_setr_ps(b[0].center.z,  b[1].center.z,  b[2].center.z,  b[3].center.z);
+		__m128 ex = _mm_setr_ps(b[0].extents.x, b[1].extents.x, b[2].extents.x, b[3].extents.x);
+		__m128 ey = _mm_setr_ps(b[0].extents.y, b[1].extents.y, b[2].extents.y, b[3].extents.y);
+		__m128 ez = _mm_setr_ps(b[0].extents.z, b[1].extents.z, b[2].extents.z, b[3].extents.z);
+
+		__m128 outside = _mm_setzero_ps();
+		for (u32 iPlane = 0; iPlane < PlaneCount; ++iPlane)
+		{
+			const Plane& p = planes[iPlane];
+			__m128 nx = _mm_set1_ps(p.normal.x);
+			__m128 ny = _mm_set1_ps(p.normal.y);
+			__m128 nz = _mm_set1_ps(p.normal.z);
+			__m128 r    = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_and_ps(nx, absMask), ex), _mm_mul_ps(_mm_and_ps(ny, absMask), ey)), _mm_mul_ps(_mm_and_ps(nz, absMask), ez));
+			__m128 dist = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, cx), _mm_mul_ps(ny, cy)), _mm_mul_ps(nz, cz)), _mm_set1_ps(p.d));
+			outside = _mm_or_ps(outside, _mm_cmplt_ps(dist, _mm_sub_ps(_mm_setzero_ps(), r)));
+		}
+
+		i32 mask = _mm_movemask_ps(outside);
+		outVisible[i+0] = (mask & 1) == 0;
+		outVisible[i+1] = (mask & 2) == 0;
+		outVisible[i+2] = (mask & 4) == 0;
+		outVisible[i+3] = (mask & 8) == 0;
+	}
+	for (; i < count; ++i)
+		outVisible[i] = Intersects(boxes[i]);
+}
@@ -0,0 +1,153 @@
+#include "FastMath.h"
+
+#include <emmintrin.h>
+
+//////////////////////////////////////////////////////////////////////////
+// SSE2 versions of FastMath.inl: same reductions, same coefficients, same
+// operation order. The scalar path handles the (count % 4) tail.
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+	FORCEINLINE __m128 Select(__m128 mask, __m128 a, __m128 b)		// mask ? a : b
+	{ return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+	//----------------------------------------------------------------------
+	FORCEINLINE __m128 Madd(__m128 a, __m128 b, __m128 c)			// a*b + c
+	{ return _mm_add_ps(_mm_mul_ps(a, b), c); }
+	//----------------------------------------------------------------------
+	FORCEINLINE __m128 SignMask()
+	{ return _mm_castsi128_ps(_mm_set1_epi32(0x80000000)); }
+	//----------------------------------------------------------------------
+
+	//----------------------------------------------------------------------
+	FORCEINLINE __m128 RSqrt4(__m128 x)
+	{
+		__m128 y = _mm_rsqrt_ps(x);
+		return _mm_mul_ps(y, _mm_sub_ps(_mm_set1_ps(1.5f), _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(_mm_set1_ps(0.5f), x), y), y)));
+	}
+	//----------------------------------------------------------------------
+	FORCEINLINE void SinCos4(__m128 x, __m128& outSin, __m128& outCos)
+	{
+		__m128 signX = _mm_and_ps(x, SignMask());
+		__m128 ax    = _mm_andnot_ps(SignMask(), x);
+
+		__m128i j  = _mm_and_si128(_mm_add_epi32(_mm_cvttps_epi32(_mm_mul_ps(ax, _mm_set1_ps(1.27323954473516f))), _mm_set1_epi32(1)), _mm_set1_epi32(~1));
+		__m128  fj = _mm_cvtepi32_ps(j);
+		__m128  r  = _mm_sub_ps(_mm_sub_ps(_mm_sub_ps(ax, _mm_mul_ps(fj, _mm_set1_ps(0.78515625f))), _mm_mul_ps(fj, _mm_set1_ps(2.4187564849853515625e-4f))), _mm_mul_ps(fj, _mm_set1_ps(3.77489497744594108e-8f)));
+		__m128  z  = _mm_mul_ps(r, r);
+
+		__m128 s = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(_mm_sub_ps(_mm_mul_ps(Madd(_mm_set1_ps(-1.9515295891e-4f), z, _mm_set1_ps(8.3321608736e-3f)), z), _mm_set1_ps(1.6666654611e-1f)), z), r), r);
+		__m128 c = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(_mm_mul_ps(Madd(_mm_sub_ps(_mm_mul_ps(_mm_set1_ps(2.443315711809948e-5f), z), _mm_set1_ps(1.388731625493765e-3f)), z, _mm_set1_ps(4.166664568298827e-2f)), z), z), _mm_mul_ps(_mm_set1_ps(0.5f), z)), _mm_set1_ps(1.0f));
+
+		__m128i q        = _mm_and_si128(j, _mm_set1_epi32(6));
+		__m128  swap     = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(q, _mm_set1_epi32(2)), _mm_set1_epi32(2)));
+		__m128  negSin   = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(q, _mm_set1_epi32(4)), 29));					// (q & 4) -> sign bit
+		__m128  negCos   = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(q, _mm_set1_epi32(2)), _mm_set1_epi32(4)), 29));	// q == 2 || q == 4
+
+		__m128 sinQ = Select(swap, c, s);
+		__m128 cosQ = Select(swap, s, c);
+		outSin = _mm_xor_ps(_mm_xor_ps(sinQ, negSin), signX);
+		outCos = _mm_xor_ps(cosQ, negCos);
+	}
+	//----------------------------------------------------------------------
+	FORCEINLINE __m128 Atan4(__m128 x)
+	{
+		__m128 signX = _mm_and_ps(x, SignMask());
+		__m128 ax    = _mm_andnot_ps(SignMask(), x);
+
+		__m128 big    = _mm_cmpgt_ps(ax, _mm_set1_ps(2.414213562373095f));
+		__m128 mid    = _mm_andnot_ps(big, _mm_cmpgt_ps(ax, _mm_set1_ps(0.4142135623730950f)));
+		__m128 offset = _mm_or_ps(_mm_and_ps(big, _mm_set1_ps(1.570796326794897f)), _mm_and_ps(mid, _mm_set1_ps(0.785398163397448f)));
+		ax = Select(big, _mm_div_ps(_mm_set1_ps(-1.0f), ax), Select(mid, _mm_div_ps(_mm_sub_ps(ax, _mm_set1_ps(1.0f)), _mm_add_ps(ax, _mm_set1_ps(1.0f))), ax));
+
+		__m128 z = _mm_mul_ps(ax, ax);
+		__m128 p = _mm_sub_ps(_mm_mul_ps(Madd(_mm_sub_ps(_mm_mul_ps(_mm_set1_ps(8.05374449538e-2f), z), _mm_set1_ps(1.38776856032e-1f)), z, _mm_set1_ps(1.99777106478e-1f)), z), _mm_set1_ps(3.33329491539e-1f));
+		__m128 y = _mm_add_ps(_mm_add_ps(offset, _mm_mul_ps(_mm_mul_ps(p, z), ax)), ax);
+		return _mm_xor_ps(y, signX);
+	}
+	//----------------------------------------------------------------------
+	FORCEINLINE __m128 Atan24(__m128 y, __m128 x)
+	{
+		__m128 zero  = _mm_setzero_ps();
+		__m128 xZero = _mm_cmpeq_ps(x, zero);
+		__m128 a     = Atan4(_mm_div_ps(y, Select(xZero, _mm_set1_ps(1.0f), x)));
+
+		__m128 yNeg   = _mm_cmplt_ps(y, zero);
+		__m128 pi     = _mm_or_ps(_mm_set1_ps(3.141592653589793f), _mm_and_ps(yNeg, SignMask()));
+		a = _mm_add_ps(a, _mm_and_ps(_mm_cmplt_ps(x, zero), pi));
+
+		__m128 halfPi = _mm_or_ps(_mm_set1_ps(1.570796326794897f), _mm_and_ps(yNeg, SignMask()));
+		__m128 onAxis = _mm_and_ps(_mm_cmpneq_ps(y, zero), halfPi);
+		return Select(xZero, onAxis, a);
+	}
+	//----------------------------------------------------------------------
+	FORCEINLINE __m128 Exp4(__m128 x)
+	{
+		x = _mm_min_ps(_mm_max_ps(x, _mm_set1_ps(-87.0f)), _mm_set1_ps(88.0f));
+
+		__m128  fn = Madd(x, _mm_set1_ps(1.44269504088896341f), _mm_set1_ps(0.5f));
+		__m128i n  = _mm_cvttps_epi32(fn);
+		n = _mm_add_epi32(n, _mm_castps_si128(_mm_cmpgt_ps(_mm_cvtepi32_ps(n), fn)));		// floor: -1 where truncation went up
+		__m128  f  = _mm_cvtepi32_ps(n);
+		__m128  r  = _mm_sub_ps(_mm_sub_ps(x, _mm_mul_ps(f, _mm_set1_ps(0.693359375f))), _mm_mul_ps(f, _mm_set1_ps(-2.12194440e-4f)));
+		__m128  z  = _mm_mul_ps(r, r);
+
+		__m128 p = Madd(_mm_set1_ps(1.9875691500e-4f), r, _mm_set1_ps(1.3981999507e-3f));
+		p = Madd(p, r, _mm_set1_ps(8.3334519073e-3f));
+		p = Madd(p, r, _mm_set1_ps(4.1665795894e-2f));
+		p = Madd(p, r, _mm_set1_ps(1.6666665459e-1f));
+		p = Madd(p, r, _mm_set1_ps(5.0000001201e-1f));
+		p = _mm_add_ps(_mm_add_ps(_mm_mul_ps(p, z), r), _mm_set1_ps(1.0f));
+
+		__m128 pow2n = _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(n, _mm_set1_epi32(127)), 23));
+		return _mm_mul_ps(p, pow2n);
+	}
+}
+
+namespace RJE
+{
+	//////////////////////////////////////////////////////////////////////////
+	void FastMath::RSqrt(const f32* in, f32* out, u32 count)
+	{
+		u32 i = 0;
+		for (; i+4 <= count; i+=4)
+			_mm_storeu_ps(out+i, RSqrt4(_mm_loadu_ps(in+i)));
+		for (; i < count; ++i)
+			out[i] = RSqrt(in[i]);
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	void FastMath::SinCos(const f32* in, f32* outSin, f32* outCos, u32 count)
+	{
+		u32 i = 0;
+		for (; i+4 <= count; i+=4)
+		{
+			__m128 s, c;
+			SinCos4(_mm_loadu_ps(in+i), s, c);
+			_mm_storeu_ps(outSin+i, s);
+			_mm_storeu_ps(outCos+i, c);
+		}
+		for (; i < count; ++i)
+			SinCos(in[i], outSin[i], outCos[i]);
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	void FastMath::Atan2(const f32* y, const f32* x, f32* out, u32 count)
+	{
+		u32 i = 0;
+		for (; i+4 <= count; i+=4)
+			_mm_storeu_ps(out+i, Atan24(_mm_loadu_ps(y+i), _mm_loadu_ps(x+i)));
+		for (; i < count; ++i)
+			out[i] = Atan2(y[i], x[i]);
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	void FastMath::Exp(const f32* in, f32* out, u32 count)
+	{
+		u32 i = 0;
+		for (; i+4 <= count; i+=4)
+			_mm_storeu_ps(out+i, Exp4(_mm_loadu_ps(in+i)));
+		for (; i < count; ++i)
+			out[i] = Exp(in[i]);
+	}
+}
@@ -1,11 +1,28 @@
 #include "MathHelper.h"
+#include "Debug.h"
 
-#include <windows.h>
 #include <float.h>
 #include <cmath>
+#include <stddef.h>
 
 namespace RJE
 {
+#if RJE_HAS_CONSTEXPR
+	// Initialized in the class body, only the storage lives here.
+	constexpr double Math::Infinity;
+	constexpr double Math::Pi;
+	constexpr double Math::Pi_Half;
+	constexpr double Math::Pi_Two;
+	constexpr double Math::Deg2Rad;
+	constexpr double Math::Rad2Deg;
+	//-----------------
+	constexpr float  Math::Infinity_f;
+	constexpr float  Math::Pi_f;
+	constexpr float  Math::Pi_Half_f;
+	constexpr float  Math::Pi_Two_f;
+	constexpr float  Math::Deg2Rad_f;
+	constexpr float  Math::Rad2Deg_f;
+#else
 	const double Math::Infinity   = DBL_MAX;
 	const double Math::Pi         = RJE_PI;
 	const double Math::Pi_Half    = RJE_HALF_PI;
@@ -19,4 +36,60 @@ namespace RJE
 	const float  Math::Pi_Two_f   = RJE_TWO_PI_F;
 	const float  Math::Deg2Rad_f  = Math::Pi_f / 180.0f;
 	const float  Math::Rad2Deg_f  = 180.0f / Math::Pi_f;
-}
\ No newline at end of file
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////
+//------------------------- Layout checks -----------------------------//
+// On every toolset, v110 included: the vectors and matrices are handed
+// to the GPU and to the SSE paths as tightly packed floats.
+RJE_C_ASSERT(sizeof(Vector2)  ==  8,											"Vector2 is 2 packed floats");
+RJE_C_ASSERT(sizeof(Vector3)  == 12,											"Vector3 is 3 packed floats");
+RJE_C_ASSERT(sizeof(Vector4)  == 16,											"Vector4 is 4 packed floats");
+RJE_C_ASSERT(sizeof(Vector3d) == 24,											"Vector3d is 3 packed doubles");
+RJE_C_ASSERT(sizeof(Matrix44) == 64,											"Matrix44 is 16 packed floats");
+RJE_C_ASSERT(offsetof(Vector3, z) == 8 && offsetof(Vector4, z) == 12,			"vector members in order");
+RJE_C_ASSERT(offsetof(Matrix44, m21) == 16 && offsetof(Matrix44, m44) == 60,	"Matrix44 is row major");
+RJE_C_ASSERT(sizeof(Quaternion) == 16,											"Quaternion is 4 packed floats");
+
+//////////////////////////////////////////////////////////////////////////
+//--------------------- Compile-time sanity checks ---------------------//
+// Without constexpr (v110) the builders run at load time, BenchmarkMath
+// checks the same values there. Everything below must fold at compile time, a failure here means one of
+// the builders silently fell back to runtime code.
+#if RJE_HAS_CONSTEXPR
+namespace
+{
+	constexpr BOOL NearlyEqual(f64 a, f64 b, f64 eps = 1e-6)	{ return RJE::Math::Abs(a-b) <= eps; }
+
+	RJE_C_ASSERT(NearlyEqual(RJE::Math::ConstSin(0.0), 0.0),						"ConstSin(0)");
+	RJE_C_ASSERT(NearlyEqual(RJE::Math::ConstSin(RJE_HALF_PI), 1.0, 1e-12),			"ConstSin(pi/2)");
+	RJE_C_ASSERT(NearlyEqual(RJE::Math::ConstSin(RJE_PI/6.0), 0.5, 1e-12),			"ConstSin(pi/6)");
+	RJE_C_ASSERT(NearlyEqual(RJE::Math::ConstSin(-7.0*RJE_PI/6.0), 0.5, 1e-12),		"ConstSin wraps negative angles");
+	RJE_C_ASSERT(NearlyEqual(RJE::Math::ConstCos(RJE_PI), -1.0, 1e-12),				"ConstCos(pi)");
+	RJE_C_ASSERT(NearlyEqual(RJE::Math::ConstCos(100.0), 0.86231887228768389, 1e-9),	"ConstCos wraps large angles");
+
+	constexpr Vector3 kV = Vector3::Cross(Vector3(1,0,0), Vector3(0,1,0));
+	RJE_C_ASSERT(kV == Vector3(0,0,1),												"Vector3::Cross");
+	RJE_C_ASSERT(Vector3::Dot(Vector3(1,2,3), Vector3(4,5,6)) == 32.0f,				"Vector3::Dot");
+	RJE_C_ASSERT((Vector3(1,2,3) - Vector3(1.0f)) * 2.0f == Vector3(0,2,4),			"Vector3 operators");
+
+	constexpr Matrix44 kIdentity;
+	RJE_C_ASSERT(kIdentity.Trace() == 4.0f && kIdentity.Determinant() == 1.0f,		"Matrix44 default is identity");
+
+	constexpr Matrix44 kTS = Matrix44::Translation(1,2,3) * Matrix44::Scaling(2,2,2);
+	RJE_C_ASSERT(kTS.m41 == 2.0f && kTS.m42 == 4.0f && kTS.m43 == 6.0f,				"Translation * Scaling");
+	RJE_C_ASSERT(kTS * Vector3(1,1,1) == Vector3(2,2,2),							"Matrix44 * Vector3");
+
+	constexpr Matrix44 kRz = Matrix44::RotationZ(90.0f);
+	RJE_C_ASSERT(NearlyEqual(kRz.m11, 0.0) && NearlyEqual(kRz.m21, 1.0),			"RotationZ(90)");
+	RJE_C_ASSERT(NearlyEqual(Matrix44::RotationX(30.0f).Determinant(), 1.0),		"RotationX is orthonormal");
+	RJE_C_ASSERT(NearlyEqual(Matrix44::RotationY(-45.0f).m13, -0.70710678),		"RotationY(-45)");
+
+	constexpr Matrix44 kOrtho = Matrix44::Orthographic(4.0f, 2.0f, 1.0f, 11.0f);
+	RJE_C_ASSERT(kOrtho.m11 == 0.5f && kOrtho.m22 == 1.0f,							"Orthographic extents");
+	RJE_C_ASSERT(NearlyEqual(kOrtho.m33, 0.1) && NearlyEqual(kOrtho.m43, -0.1),		"Orthographic depth range");
+
+	RJE_C_ASSERT(NearlyEqual(RJE::Math::Deg2Rad * 180.0, RJE::Math::Pi, 1e-12),		"Deg2Rad");
+}
+#endif
@@ -0,0 +1,308 @@
+#include "Packing.h"
+
+#include <emmintrin.h>
+
+#if defined(_MSC_VER)
+#	include <intrin.h>
+#	include <immintrin.h>
+#	define RJE_F16C_AVAILABLE	1
+#	define RJE_F16C_TARGET
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#	include <cpuid.h>
+#	include <immintrin.h>
+#	define RJE_F16C_AVAILABLE	1
+#	define RJE_F16C_TARGET		__attribute__((target("f16c")))
+#else
+#	define RJE_F16C_AVAILABLE	0
+#endif
+
+namespace
+{
+	union FloatBits { u32 u; f32 f; };
+
+	//----------------------------------------------------------------------
+	// NaN -> 0, then clamp to [lo, hi] (D3D float -> norm rules)
+	FORCEINLINE __m128 SanitizeClamp(__m128 x, f32 lo, f32 hi)
+	{
+		x = _mm_and_ps(x, _mm_cmpeq_ps(x, x));
+		return _mm_min_ps(_mm_max_ps(x, _mm_set1_ps(lo)), _mm_set1_ps(hi));
+	}
+	//----------------------------------------------------------------------
+	// Scales and rounds to nearest even (the default MXCSR mode)
+	FORCEINLINE i32 ToNorm(f32 f, f32 lo, f32 scale)
+	{ return _mm_cvtss_si32(_mm_mul_ss(SanitizeClamp(_mm_set_ss(f), lo, 1.0f), _mm_set_ss(scale))); }
+	//----------------------------------------------------------------------
+
+	//----------------------------------------------------------------------
+	template <typename T>
+	void ToNormBulk(const f32* in, T* out, u32 count, f32 lo, f32 scale)
+	{
+		i32 tmp[4];
+
+		u32 i = 0;
+		for (; i+4 <= count; i+=4)
+		{
+			__m128 x = SanitizeClamp(_mm_loadu_ps(in+i), lo, 1.0f);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(tmp), _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(scale))));
+			out[i+0] = static_cast<T>(tmp[0]);
+			out[i+1] = static_cast<T>(tmp[1]);
+			out[i+2] = static_cast<T>(tmp[2]);
+			out[i+3] = static_cast<T>(tmp[3]);
+		}
+		for (; i < count; ++i)
+			out[i] = static_cast<T>(ToNorm(in[i], lo, scale));
+	}
+	//----------------------------------------------------------------------
+	template <typename T>
+	void FromNormBulk(const T* in, f32* out, u32 count, f32 lo, f32 scale)
+	{
+		u32 i = 0;
+		for (; i+4 <= count; i+=4)
+		{
+			__m128 x = _mm_cvtepi32_ps(_mm_setr_epi32(in[i+0], in[i+1], in[i+2], in[i+3]));
+			_mm_storeu_ps(out+i, _mm_max_ps(_mm_div_ps(x, _mm_set1_ps(scale)), _mm_set1_ps(lo)));
+		}
+		for (; i < count; ++i)
+		{
+			f32 f = static_cast<f32>(in[i]) / scale;
+			out[i] = f < lo ? lo : f;
+		}
+	}
+	//----------------------------------------------------------------------
+
+#if RJE_F16C_AVAILABLE
+	//----------------------------------------------------------------------
+	BOOL DetectF16C()
+	{
+		// F16C is VEX encoded: the OS must also save the YMM state
+		u32 ecx;
+#	if defined(_MSC_VER)
+		int info[4];
+		__cpuid(info, 1);
+		ecx = static_cast<u32>(info[2]);
+#	else
+		u32 eax, ebx, edx;
+		if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+			return false;
+#	endif
+		const u32 osxsave = 1u << 27, avx = 1u << 28, f16c = 1u << 29;
+		if ((ecx & (osxsave | avx | f16c)) != (osxsave | avx | f16c))
+			return false;
+
+#	if defined(_MSC_VER)
+		u64 xcr0 = _xgetbv(0);
+#	else
+		u32 xcr0Lo, xcr0Hi;
+		__asm__ ("xgetbv" : "=a"(xcr0Lo), "=d"(xcr0Hi) : "c"(0));
+		u64 xcr0 = (static_cast<u64>(xcr0Hi) << 32) | xcr0Lo;
+#	endif
+		return (xcr0 & 6) == 6;
+	}
+	//----------------------------------------------------------------------
+	RJE_F16C_TARGET void FloatToHalfF16C(const f32* in, u16* out, u32 count)
+	{
+		u32 i = 0;
+		for (; i+4 <= count; i+=4)
+			_mm_storel_epi64(reinterpret_cast<__m128i*>(out+i), _mm_cvtps_ph(_mm_loadu_ps(in+i), 0));	// 0: round to nearest even
+		for (; i < count; ++i)
+			out[i] = RJE::Packing::FloatToHalf(in[i]);
+	}
+	//----------------------------------------------------------------------
+	RJE_F16C_TARGET void HalfToFloatF16C(const u16* in, f32* out, u32 count)
+	{
+		u32 i = 0;
+		for (; i+4 <= count; i+=4)
+			_mm_storeu_ps(out+i, _mm_cvtph_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(in+i))));
+		for (; i < count; ++i)
+			out[i] = RJE::Packing::HalfToFloat(in[i]);
+	}
+	//----------------------------------------------------------------------
+#endif
+}
+
+namespace RJE
+{
+	//////////////////////////////////////////////////////////////////////////
+	// Half
+	//////////////////////////////////////////////////////////////////////////
+	u16 Packing::FloatToHalf(f32 f)
+	{
+		// Bit exact with F16C in round-to-nearest-even mode (after F. Giesen)
+		const u32 f32Infinity = 255u << 23;
+		const u32 f16Overflow = (127u + 16u) << 23;		// 2^16: rounds to infinity
+		FloatBits denormMagic;
+		denormMagic.u = ((127u - 15u) + (23u - 10u) + 1u) << 23;
+
+		FloatBits bits;
+		bits.f = f;
+		u32 sign = bits.u & 0x80000000u;
+		bits.u ^= sign;
+
+		u16 out;
+		if (bits.u >= f16Overflow)
+		{
+			// Inf stays Inf, NaN keeps the top of its payload and becomes quiet
+			out = bits.u > f32Infinity ? static_cast<u16>(0x7e00 | ((bits.u >> 13) & 0x3ff)) : 0x7c00;
+		}
+		else if (bits.u < (113u << 23))
+		{
+			// Result is a half denormal: let the FPU round the mantissa by adding a magic number
+			bits.f += denormMagic.f;
+			out = static_cast<u16>(bits.u - denormMagic.u);
+		}
+		else
+		{
+			u32 mantissaOdd = (bits.u >> 13) & 1;
+			bits.u += ((15u - 127u) << 23) + 0xfff;		// rebias exponent, round
+			bits.u += mantissaOdd;						// ... to even
+			out = static_cast<u16>(bits.u >> 13);
+		}
+		return out | static_cast<u16>(sign >> 16);
+	}
+
+	//----------------------------------------------------------------------
+	f32 Packing::HalfToFloat(u16 h)
+	{
+		const u32 shiftedExp = 0x7c00u << 13;
+		FloatBits magic;
+		magic.u = 113u << 23;
+
+		FloatBits out;
+		out.u = (h & 0x7fffu) << 13;
+		u32 exp = shiftedExp & out.u;
+		out.u += (127u - 15u) << 23;
+
+		if (exp == shiftedExp)								// Inf/NaN
+		{
+			out.u += (128u - 16u) << 23;
+			if (out.u & 0x007fffffu)
+				out.u |= 0x00400000u;						// quiet, like F16C
+		}
+		else if (exp == 0)									// zero/denormal
+		{
+			out.u += 1u << 23;
+			out.f -= magic.f;
+		}
+		out.u |= (h & 0x8000u) << 16;
+		return out.f;
+	}
+
+	//----------------------------------------------------------------------
+	BOOL Packing::HasF16C()
+	{
+#if RJE_F16C_AVAILABLE
+		static const BOOL sbHasF16C = DetectF16C();
+		return sbHasF16C;
+#else
+		return false;
+#endif
+	}
+
+	//----------------------------------------------------------------------
+	void Packing::FloatToHalf(const f32* in, u16* out, u32 count)
+	{
+#if RJE_F16C_AVAILABLE
+		if (HasF16C())
+		{
+			FloatToHalfF16C(in, out, count);
+			return;
+		}
+#endif
+		for (u32 i = 0; i < count; ++i)
+			out[i] = FloatToHalf(in[i]);
+	}
+
+	//----------------------------------------------------------------------
+	void Packing::HalfToFloat(const u16* in, f32* out, u32 count)
+	{
+#if RJE_F16C_AVAILABLE
+		if (HasF16C())
+		{
+			HalfToFloatF16C(in, out, count);
+			return;
+		}
+#endif
+		for (u32 i = 0; i < count; ++i)
+			out[i] = HalfToFloat(in[i]);
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// Snorm / Unorm
+	//////////////////////////////////////////////////////////////////////////
+	i8  Packing::FloatToSnorm8 (f32 f)	{ return static_cast<i8> (ToNorm(f, -1.0f, 127.0f));   }
+	i16 Packing::FloatToSnorm16(f32 f)	{ return static_cast<i16>(ToNorm(f, -1.0f, 32767.0f)); }
+	u8  Packing::FloatToUnorm8 (f32 f)	{ return static_cast<u8> (ToNorm(f,  0.0f, 255.0f));   }
+	u16 Packing::FloatToUnorm16(f32 f)	{ return static_cast<u16>(ToNorm(f,  0.0f, 65535.0f)); }
+	//----------------------------------------------------------------------
+	f32 Packing::Snorm8ToFloat (i8  v)	{ return RJE::Math::Max(static_cast<f32>(v) / 127.0f,   -1.0f); }
+	f32 Packing::Snorm16ToFloat(i16 v)	{ return RJE::Math::Max(static_cast<f32>(v) / 32767.0f, -1.0f); }
+	f32 Packing::Unorm8ToFloat (u8  v)	{ return static_cast<f32>(v) / 255.0f;   }
+	f32 Packing::Unorm16ToFloat(u16 v)	{ return static_cast<f32>(v) / 65535.0f; }
+	//----------------------------------------------------------------------
+	void Packing::FloatToSnorm8 (const f32* in, i8*  out, u32 count)	{ ToNormBulk(in, out, count, -1.0f, 127.0f);   }
+	void Packing::FloatToSnorm16(const f32* in, i16* out, u32 count)	{ ToNormBulk(in, out, count, -1.0f, 32767.0f); }
+	void Packing::FloatToUnorm8 (const f32* in, u8*  out, u32 count)	{ ToNormBulk(in, out, count,  0.0f, 255.0f);   }
+	void Packing::FloatToUnorm16(const f32* in, u16* out, u32 count)	{ ToNormBulk(in, out, count,  0.0f, 65535.0f); }
+	//----------------------------------------------------------------------
+	void Packing::Snorm8ToFloat (const i8*  in, f32* out, u32 count)	{ FromNormBulk(in, out, count, -1.0f, 127.0f);   }
+	void Packing::Snorm16ToFloat(const i16* in, f32* out, u32 count)	{ FromNormBulk(in, out, count, -1.0f, 32767.0f); }
+	void Packing::Unorm8ToFloat (const u8*  in, f32* out, u32 count)	{ FromNormBulk(in, out, count,  0.0f, 255.0f);   }
+	void Packing::Unorm16ToFloat(const u16* in, f32* out, u32 count)	{ FromNormBulk(in, out, count,  0.0f, 65535.0f); }
+
+	//////////////////////////////////////////////////////////////////////////
+	// Octahedral
+	//////////////////////////////////////////////////////////////////////////
+	Vector2 Packing::OctEncode(const Vector3& n)
+	{
+		f32 invL1 = 1.0f / (fabsf(n.x) + fabsf(n.y) + fabsf(n.z));
+		f32 x = n.x * invL1;
+		f32 y = n.y * invL1;
+		if (n.z < 0.0f)
+		{
+			// Fold the lower hemisphere over the diagonals
+			f32 foldX = (1.0f - fabsf(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+			f32 foldY = (1.0f - fabsf(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+			x = foldX;
+			y = foldY;
+		}
+		return Vector2(x, y);
+	}
+
+	//----------------------------------------------------------------------
+	Vector3 Packing::OctDecode(const Vector2& e)
+	{
+		Vector3 n(e.x, e.y, 1.0f - fabsf(e.x) - fabsf(e.y));
+		f32 t = RJE::Math::Max(-n.z, 0.0f);
+		n.x += n.x >= 0.0f ? -t : t;
+		n.y += n.y >= 0.0f ? -t : t;
+		return n.Normalize();
+	}
+
+	//----------------------------------------------------------------------
+	u32 Packing::OctEncodeSnorm16(const Vector3& n)
+	{
+		Vector2 e = OctEncode(n);
+		return static_cast<u16>(FloatToSnorm16(e.x)) | (static_cast<u32>(static_cast<u16>(FloatToSnorm16(e.y))) << 16);
+	}
+
+	//----------------------------------------------------------------------
+	Vector3 Packing::OctDecodeSnorm16(u32 packed)
+	{
+		return OctDecode(Vector2(	Snorm16ToFloat(static_cast<i16>(packed & 0xffff)),
+									Snorm16ToFloat(static_cast<i16>(packed >> 16))));
+	}
+
+	//----------------------------------------------------------------------
+	void Packing::OctEncodeSnorm16(const Vector3* in, u32* out, u32 count)
+	{
+		for (u32 i = 0; i < count; ++i)
+			out[i] = OctEncodeSnorm16(in[i]);
+	}
+
+	//----------------------------------------------------------------------
+	void Packing::OctDecodeSnorm16(const u32* in, Vector3* out, u32 count)
+	{
+		for (u32 i = 0; i < count; ++i)
+			out[i] = OctDecodeSnorm16(in[i]);
+	}
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "Types.h"
+
+#include <vector>
+#include <string>
+#include <stdio.h>
+
+//////////////////////////////////////////////////////////////////////////
+struct BenchmarkResult
+{
+	std::string	mName;			// "group.what", unique in a report
+	f64			mValue;			// lower is better: a time, a count of bytes...
+	std::string	mUnit;
+	f64			mTolerance;		// percent over the baseline before it regresses, 0: the default
+};
+
+//////////////////////////////////////////////////////////////////////////
+// The results of a benchmark run, saved as JSON and compared against those of
+// a baseline run: a result over its baseline by more than its tolerance is a
+// regression. The tolerance is the baseline's when it has one (hand edited
+// for the noisy results), else the result's, else the default.
+// The JSON is the one Save() writes, an object per result on a line: Load()
+// reads it back and finds the fields in any order, but is no JSON parser.
+class BenchmarkReport
+{
+public:
+	BenchmarkReport();
+
+	// Replaces the result of the same name; quotes and backslashes in name
+	// and unit become '_'
+	void	Record(const char* name, f64 value, const char* unit, f64 tolerance = 0.0);
+	void	Clear()									{ mResults.clear(); }
+
+	const BenchmarkResult*	Find(const char* name) const;
+	const std::vector<BenchmarkResult>&	Results() const	{ return mResults; }
+
+	f64		DefaultTolerance() const				{ return mDefaultTolerance; }
+	void	SetDefaultTolerance(f64 percent)		{ mDefaultTolerance = percent > 0.0 ? percent : 0.0; }
+	// No result regresses under it, whatever its tolerance: the margin of a
+	// machine other than the baseline's. 0 by default
+	f64		MinimumTolerance() const				{ return mMinimumTolerance; }
+	void	SetMinimumTolerance(f64 percent)		{ mMinimumTolerance = percent > 0.0 ? percent : 0.0; }
+
+	BOOL	Save(const char* path) const;
+	// Replaces the results, false when the file can't be read
+	BOOL	Load(const char* path);
+
+	// A line per result against the one of the same name in baseline, on out;
+	// returns the count of regressions. Results only one side has are listed,
+	// they don't regress.
+	u32		Compare(const BenchmarkReport& baseline, FILE* out = stdout) const;
+
+private:
+	std::vector<BenchmarkResult>	mResults;		// in Record() order
+	f64								mDefaultTolerance;
+	f64								mMinimumTolerance;
+};
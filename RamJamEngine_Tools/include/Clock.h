@@ -0,0 +1,87 @@
+#pragma once
+
+#include "Types.h"
+#include <atomic>
+
+#if defined(_MSC_VER)
+#	include <intrin.h>
+#	define RJE_CLOCK_TSC	1
+#elif defined(__x86_64__) || defined(__i386__)
+#	include <x86intrin.h>
+#	define RJE_CLOCK_TSC	1
+#else
+#	define RJE_CLOCK_TSC	0
+#endif
+
+#if PLATFORM != PLATFORM_WIN32
+#	include <time.h>
+#endif
+
+//////////////////////////////////////////////////////////////////////////
+// Monotonic time of the engine, shared by the Timer, the FrameScheduler and
+// the profiler: one timeline, one conversion to seconds.
+// Ticks() is rdtsc when the CPU has an invariant TSC (constant rate across
+// power states and cores): a few ns and no call. Its Frequency() is then
+// calibrated once against the OS clock. Otherwise, or without rdtsc, it is
+// the OS clock itself: QueryPerformanceCounter, clock_gettime(MONOTONIC).
+// Keep durations in ticks and convert once: u64 ticks don't drift, a float
+// accumulated frame after frame does.
+// Any thread may make the first call: the source and the OS frequency come
+// out the same whoever picks them, the calibration runs once and the other
+// callers wait for it.
+struct Clock
+{
+	enum Source
+	{
+		Source_Unknown,			// not decided yet: first Ticks() call
+		Source_CycleCounter,	// rdtsc
+		Source_OsClock,
+	};
+
+	static u64		Ticks();
+	static u64		Frequency();		// ticks per second, calibrated on the first call
+	static Source	GetSource();
+
+	static f64		Seconds(u64 ticks)		{ return ticks / static_cast<f64>(Frequency()); }
+	static f64		Ms(u64 ticks)			{ return ticks * 1000.0 / Frequency(); }
+
+	//------ The OS clock, whatever Ticks() uses
+	static u64		OsTicks();
+	static u64		OsFrequency();
+
+private:
+	static Source	ChooseSource();
+	static u64		Calibrate();
+
+	static std::atomic<Source>	sSource;
+	static std::atomic<u64>		sFrequency;			// 0 until calibrated
+	static std::atomic<u64>		sOsFrequency;
+	static std::atomic<u32>		sbCalibrating;		// a thread claimed the calibration
+};
+
+//////////////////////////////////////////////////////////////////////////
+inline u64 Clock::OsTicks()
+{
+#if PLATFORM == PLATFORM_WIN32
+	LARGE_INTEGER now;
+	QueryPerformanceCounter(&now);
+	return now.QuadPart;
+#else
+	timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec * 1000000000ull + now.tv_nsec;
+#endif
+}
+
+//------------------------------------------------------------------------
+inline u64 Clock::Ticks()
+{
+#if RJE_CLOCK_TSC
+	Source source = sSource.load(std::memory_order_relaxed);
+	if (source == Source_Unknown)
+		source = ChooseSource();
+	if (source == Source_CycleCounter)
+		return __rdtsc();
+#endif
+	return OsTicks();
+}
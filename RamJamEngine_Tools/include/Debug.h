@@ -2,20 +2,30 @@
 
 #include "Types.h"
 
+#include <cassert>
+
 namespace RJE
 {
 #	if defined(DEBUG) | defined(_DEBUG)
 #	define RJE_DEBUG
 #	endif
 
-#	ifdef RJE_DEBUG
+#	if defined(RJE_DEBUG) && (COMPILER == COMPILER_MSVC)
 #		define RJE_ASSERT(x) _ASSERTE(x)
+#	elif defined(RJE_DEBUG)
+#		define RJE_ASSERT(x) assert(x)
 #	else
 #		define RJE_ASSERT(x) (x)
 #	endif
 #	define RJE_C_ASSERT(condition, message)	static_assert(condition, message)
 
-#	define RJE_ALIGNOF( X )		__declspec( align( X ) )
+#	ifdef _MSC_VER
+#		define RJE_ALIGNOF( X )		__declspec( align( X ) )
+#		define RJE_THREAD_LOCAL		__declspec( thread )
+#	else
+#		define RJE_ALIGNOF( X )		__attribute__(( aligned( X ) ))
+#		define RJE_THREAD_LOCAL		__thread
+#	endif
 
 #	define RJE_PROFILE_SAMPLE		0
 #	define RJE_PROFILE_SAMPLERATE	10
@@ -43,8 +53,13 @@ namespace RJE
 #	define RJE_PRINT						DebugPrintf
 #	define RJE_PRINT_VERBOSE				DebugPrintVerbose
 #	define RJE_PRINT_RAW( X )				OutputDebugStringA( X )
-#	define RJE_MESSAGE_BOX( X, Y, Z, W )	MessageBox( X, Y, Z, W )
-#	define RJE_MESSAGE_BEEP( X )			MessageBeep( X )
+#	if PLATFORM == PLATFORM_WIN32
+#		define RJE_MESSAGE_BOX( X, Y, Z, W )	MessageBox( X, Y, Z, W )
+#		define RJE_MESSAGE_BEEP( X )			MessageBeep( X )
+#	else
+#		define RJE_MESSAGE_BOX( X, Y, Z, W )	RJE_PRINT_RAW( (WStringToString(Z) + ": " + WStringToString(Y) + "\n").c_str() )
+#		define RJE_MESSAGE_BEEP( X )
+#	endif
 
 #	define RJE_QUOTE_INPLACE(x)		# x
 #	define RJE_QUOTE(x)				RJE_QUOTE_INPLACE(x)
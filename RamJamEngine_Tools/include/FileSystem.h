@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Types.h"
+
+#include <string>
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////////
+// The few file system queries of the engine, on Win32 and POSIX. Paths
+// are the engine's: a directory ends with a separator, '\\' or '/'.
+struct FileSystem
+{
+	// Files of dir and its subfolders whose name ends with extension
+	// (".mesh"), sorted so that runs list them in the same order
+	static void			FindFiles(const std::string& dir, const char* extension, OUT std::vector<std::string>& files);
+	// "models\\dragon.mesh" -> "dragon"
+	static std::string	FileStem(const std::string& path);
+	// The path with the platform's separators: the data files write '\\'
+	static std::string	NativePath(const std::string& path);
+
+private:
+	static void			FindFilesUnsorted(const std::string& dir, const char* extension, OUT std::vector<std::string>& files);
+};
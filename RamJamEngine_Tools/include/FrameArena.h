@@ -0,0 +1,163 @@
+#pragma once
+
+#include "Types.h"
+#include "Debug.h"
+#include "Memory.h"
+
+#include <vector>
+#include <string>
+#include <mutex>
+#include <atomic>
+
+//////////////////////////////////////////////////////////////////////////
+// Bump allocator: Allocate() moves a cursor, nothing is freed but by Reset().
+// Memory comes in chunks: when one is full the next allocations go to a new
+// one, and the next Reset() merges them into a single chunk of their total
+// size, so a steady workload settles on one chunk and no heap call.
+// With mbPoison (the default in debug), Reset() fills the memory handed out
+// with PoisonByte, the merged chunks too before they are freed, and the new
+// one: reading something freed with the frame shows.
+class LinearArena
+{
+public:
+	enum { DefaultChunkSize = 64 * 1024, DefaultAlignment = 16, PoisonByte = 0xDD };
+
+	explicit LinearArena(size_t chunkSize = DefaultChunkSize);
+	~LinearArena();
+
+	void*	Allocate(size_t size, size_t alignment = DefaultAlignment);
+	template<class T>
+	T*		AllocateArray(size_t count)		{ return static_cast<T*>(Allocate(count * sizeof(T), __alignof(T))); }
+	void	Reset();
+
+	size_t	Used() const					{ return mUsed; }		// since Reset(), alignment padding included
+	size_t	Capacity() const;
+	u32		Overflows() const				{ return mOverflows; }	// chunks added because one was full
+
+	BOOL	mbPoison;
+
+private:
+	// Not implemented
+	LinearArena(const LinearArena&);
+	LinearArena& operator=(const LinearArena&);
+
+	struct Chunk
+	{
+		Chunk*	mNext;
+		size_t	mSize;				// data bytes, right after the header
+		u8*		Data()				{ return reinterpret_cast<u8*>(this + 1); }
+	};
+
+	void	AddChunk(size_t minSize);
+
+	Chunk*		mChunks;			// the current one first
+	uintptr_t	mCursor;
+	uintptr_t	mEnd;
+	size_t		mChunkSize;
+	size_t		mUsed;
+	u32			mOverflows;
+};
+
+//////////////////////////////////////////////////////////////////////////
+// Transient memory of a frame. Each thread gets its own pair of arenas on
+// first use: Current() is the calling thread's one of this frame, the other
+// one still holds the last frame's data, for a render thread one frame
+// behind. BeginFrame() swaps them and resets the new current ones, so the
+// allocations of frame N are valid until BeginFrame() of frame N+2.
+// Worker threads must be done with a frame's jobs when BeginFrame() runs:
+// it resets every thread's arena, so no other thread may allocate
+// meanwhile. With a FramePipeline, call it on the side that allocates.
+class FrameArena
+{
+public:
+	struct ThreadArenas
+	{
+		LinearArena	mArenas[2];
+	};
+
+	static FrameArena* Instance()
+	{
+		if (!sInstance)
+			sInstance = rje_new FrameArena();
+
+		return sInstance;
+	}
+
+	static void DeleteInstance()
+	{
+		RJE_SAFE_DELETE(sInstance);
+	}
+
+	LinearArena&	Current();
+	void			BeginFrame();
+
+	//------ Bytes allocated in a frame by all the threads
+	size_t	LastFrameBytes() const		{ return mLastFrameBytes; }
+	size_t	PeakFrameBytes() const		{ return mPeakFrameBytes; }
+	u32		PeakFrame() const			{ return mPeakFrame; }
+	u32		Frames() const				{ return mFrames; }
+	u32		Overflows() const;
+	u32		ThreadCount() const;
+
+private:
+	FrameArena();
+	~FrameArena();
+	// Not implemented
+	FrameArena(const FrameArena&);
+	FrameArena& operator=(const FrameArena&);
+
+	ThreadArenas*	AddThread();
+
+	static FrameArena*			sInstance;
+
+	std::vector<ThreadArenas*>	mThreads;
+	mutable std::mutex			mThreadsMutex;
+	u32							mGeneration;
+	std::atomic<u32>			mCurrent;			// index in ThreadArenas::mArenas, released by BeginFrame()
+	size_t						mLastFrameBytes;
+	size_t						mPeakFrameBytes;
+	u32							mPeakFrame;
+	u32							mFrames;
+};
+
+//////////////////////////////////////////////////////////////////////////
+// STL allocator over a LinearArena: deallocate() does nothing, the memory
+// comes back with the arena's Reset(). Default constructed, it uses the
+// calling thread's frame arena: a container of it must not outlive the
+// frame after the one it was filled in.
+template<class T>
+class ArenaAllocator : public std::allocator<T>
+{
+public:
+	typedef typename std::allocator<T>::pointer		pointer;
+	typedef typename std::allocator<T>::size_type	size_type;
+
+	template<class U>
+	struct rebind { typedef ArenaAllocator<U> other; };
+
+	ArenaAllocator() : mArena(&FrameArena::Instance()->Current()) {}
+	explicit ArenaAllocator(LinearArena& arena) : mArena(&arena) {}
+	template<class U>
+	ArenaAllocator(const ArenaAllocator<U>& other) : mArena(other.mArena) {}
+
+	pointer	allocate(size_type count, const void* = nullptr)	{ return mArena->AllocateArray<T>(count); }
+	void	deallocate(pointer, size_type)						{}
+
+	LinearArena*	mArena;
+};
+
+template<class T, class U>
+inline bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b)	{ return a.mArena == b.mArena; }
+template<class T, class U>
+inline bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b)	{ return a.mArena != b.mArena; }
+
+//------------------------------------------------------------------------
+typedef std::basic_string<char,    std::char_traits<char>,    ArenaAllocator<char> >		FrameString;
+typedef std::basic_string<wchar_t, std::char_traits<wchar_t>, ArenaAllocator<wchar_t> >	FrameWString;
+
+// FrameVector<T>::Type
+template<class T>
+struct FrameVector
+{
+	typedef std::vector<T, ArenaAllocator<T> >	Type;
+};
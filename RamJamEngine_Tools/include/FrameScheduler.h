@@ -0,0 +1,111 @@
+#pragma once
+
+#include "Types.h"
+#include "Clock.h"
+
+//////////////////////////////////////////////////////////////////////////
+// Time source of the FrameScheduler, in ticks of Frequency() per second
+struct FrameClock
+{
+	virtual u64		Now() = 0;
+	virtual u64		Frequency() = 0;
+	virtual void	WaitUntil(u64 ticks) = 0;
+
+	virtual ~FrameClock() {}
+};
+
+//------------------------------------------------------------------------
+// The engine's Clock. Waits sleep with a 1 ms timer period, then spin
+// through the last SpinMs: Sleep() alone overshoots by up to a period.
+struct HighResolutionClock : FrameClock
+{
+	enum { SpinMs = 2 };
+
+	HighResolutionClock();
+	~HighResolutionClock();
+
+	u64		Now()					{ return Clock::Ticks(); }
+	u64		Frequency()				{ return mFrequency; }
+	void	WaitUntil(u64 ticks);
+
+private:
+	u64		mFrequency;
+};
+
+//------------------------------------------------------------------------
+// Only moves when told to: WaitUntil() jumps to the target
+struct ManualClock : FrameClock
+{
+	u64		mTicks;
+	u64		mFrequency;
+
+	ManualClock(u64 frequency = 1000000) : mTicks(0), mFrequency(frequency) {}
+
+	u64		Now()					{ return mTicks; }
+	u64		Frequency()				{ return mFrequency; }
+	void	WaitUntil(u64 ticks)	{ if (ticks > mTicks) mTicks = ticks; }
+	void	Advance(f64 seconds)	{ mTicks += static_cast<u64>(seconds * mFrequency + 0.5); }
+};
+
+//////////////////////////////////////////////////////////////////////////
+// Paces the frame loop and decides how much simulation each frame runs.
+//
+// BeginFrame() first waits for the frame rate limit, then measures the
+// frame and returns how many updates to run, each of StepTime():
+//  - fixed step: the frame time (times mTimeScale) goes into an accumulator
+//    drained by mFixedStep steps, at most mMaxSteps per frame, the rest is
+//    dropped. Alpha() is what is left, as a fraction of a step: render
+//    Interpolate(previous, current, Alpha()).
+//  - variable step: 1 step of the whole frame time, Alpha() is 1.
+// EndFrame() closes the work part of the frame, for the budget accounting.
+struct FrameScheduler
+{
+	BOOL	mbFixedStep;
+	f32		mFixedStep;			// seconds
+	u32		mMaxSteps;			// per frame, so a slow frame doesn't snowball into slower ones
+	f32		mMaxFrameRate;		// frames per second, 0: no limit
+	f32		mPausedFrameRate;	// limit while paused
+	f32		mTimeScale;
+	//------ Last frame
+	u32		mSteps;
+	f32		mStepTime;
+	f32		mAlpha;
+	f32		mFrameMs;			// from BeginFrame() to BeginFrame()
+	f32		mWorkMs;			// from BeginFrame() to EndFrame()
+	f32		mWaitMs;			// waited for the limit in BeginFrame()
+	f32		mDroppedMs;			// simulation time dropped by mMaxSteps
+	//------ Since Reset()
+	u32		mFrames;
+	u32		mOverBudgetFrames;	// mWorkMs over BudgetMs()
+
+	//------
+	// clock: nullptr for a HighResolutionClock, owned by the scheduler
+	explicit FrameScheduler(FrameClock* clock = nullptr);
+	~FrameScheduler();
+
+	// The next BeginFrame() starts from scratch: no frame time, no backlog
+	void	Reset();
+
+	u32		BeginFrame(BOOL bPaused = false);
+	void	EndFrame();
+
+	f32		StepTime() const		{ return mStepTime; }
+	f32		Alpha() const			{ return mAlpha; }
+	f32		BudgetMs() const		{ return mMaxFrameRate > 0.0f ? 1000.0f / mMaxFrameRate : 0.0f; }
+	FrameClock*	Clock() const		{ return mClock; }
+
+	template<class T>
+	static T Interpolate(const T& previous, const T& current, f32 alpha)	{ return previous + (current - previous) * alpha; }
+
+private:
+	// Not implemented
+	FrameScheduler(const FrameScheduler&);
+	FrameScheduler& operator=(const FrameScheduler&);
+
+	FrameClock*	mClock;
+	BOOL		mbOwnsClock;
+	BOOL		mbStarted;
+	u64			mFrameStart;		// ticks, when the last frame started
+	u64			mWorkStart;			// ticks, when BeginFrame() returned
+	f64			mAccumulator;		// seconds of simulation owed
+};
@@ -2,6 +2,8 @@
 
 #include "Types.h"
 
+#include <string>
+
 namespace RJE_GLOBALS
 {
 #	define MAX_STRING_DBG			4096
@@ -37,6 +39,12 @@ namespace RJE_GLOBALS
 	
 	// -----------------------------------------------------------------------
 
+	//************************************************************************
+	//	Paths
+	//************************************************************************
+	extern std::string	gResourcesPath;		// the Resources.ini
+	extern std::string	gDataPath;			// its datapath, ends with a separator
+
 	//************************************************************************
 	//	Rendering
 	//************************************************************************
@@ -49,9 +57,32 @@ namespace RJE_GLOBALS
 	//************************************************************************
 	extern int		gDebugVerbosity;
 	extern BOOL		gShowCursor;
+	extern int		gSpikeThresholdMs;	// frames over it dump their profile, 0: off
+	extern BOOL		gHardwareCounters;	// profiled scopes read the CPU's counters, where available
+
+	//************************************************************************
+	//	Memory budgets, in MB, 0: none
+	//************************************************************************
+	extern int		gMeshesBudgetMb;
+	extern int		gTexturesBudgetMb;
+	extern int		gRenderTargetsBudgetMb;
+	extern int		gMaterialsBudgetMb;
+	extern int		gSceneBudgetMb;
+
+	//************************************************************************
+	//	Benchmark
+	//************************************************************************
+	extern int		gBenchmarkTolerance;	// % over the baseline before a result regresses, 0: the default
 
 	//************************************************************************
 	//	Misc
 	//************************************************************************
 	extern BOOL		gRunInBackground;
+	extern BOOL		gFixedStep;			// simulation at gFixedStepRate Hz, rendering interpolated
+	extern int		gFixedStepRate;
+	extern int		gMaxFrameRate;		// 0: no limit
+
+	// Reads them from the .ini, a default one is written when it is missing,
+	// and sets the memory budgets
+	void	LoadConfigFile(const char* filename);
 }
@@ -7,8 +7,7 @@
 #include <algorithm>
 #include <functional>
 
-#include "../../RamJamEngine_Math/include/Vector2.h"
-#include "../../RamJamEngine_Math/include/Vector3.h"
+#include "../../RamJamEngine_Math/include/MathHelper.h"		// Vector2, Vector3
 
 using namespace std;
 
@@ -91,6 +91,9 @@ enum MultipleKeyboardKeys
 	ALPHA_KEYS			= 8
 };
 
+// Receives the characters typed (WM_CHAR), e.g. the console's
+typedef void (*TextInputHandler)(char c);
+
 struct Input
 {
 	static Input* Instance()
@@ -111,6 +114,7 @@ struct Input
 	}
 
 	void HandleInputEvent(UINT umsg, WPARAM wparam, LPARAM lparam);
+	void SetTextInputHandler(TextInputHandler handler)	{ mTextInputHandler = handler; }
 
 	BOOL IsMouseMoving();
 	int  GetMousePosX();
@@ -144,6 +148,7 @@ private:
 	static Input* sInstance;
 
 	BOOL bUpdated;
+	TextInputHandler mTextInputHandler;
 
 	int  mMousePosX;
 	int  mMousePosY;
@@ -4,6 +4,7 @@
 #include "Debug.h"
 
 #include <memory>
+#include <vector>
 
 #ifdef RJE_DEBUG
 #	define RJE_MEMORY_PROFILE
@@ -11,8 +12,25 @@
 #endif
 
 //////////////////////////////////////////////////////////////////////////
-void AddTrack(DWORD addr,  DWORD asize, const char *fname, DWORD lnum);
-void RemoveTrack(DWORD addr);
+// Allocation tracker behind rje_new. Live allocations sit in a hash map
+// keyed by address, split into lock-striped buckets: AddTrack()/RemoveTrack()
+// are O(1) and can be called from any thread. Stats are kept per call site.
+struct MemorySiteStats
+{
+	const char*	mFile;
+	u32			mLine;
+	u32			mLiveCount;
+	i64			mLiveBytes;
+	i64			mPeakBytes;			// of mLiveBytes
+	u64			mAllocations;		// since startup
+};
+
+void AddTrack(const void* addr, size_t size, const char* file, u32 line);
+// Untracked addresses are ignored
+void RemoveTrack(const void* addr);
+// One entry per file:line that allocated, sorted by live bytes
+void MemorySites(OUT std::vector<MemorySiteStats>& sites);
+// Leaks grouped by file:line
 void MemoryReport();
 
 #ifdef RJE_MEMORY_PROFILE
@@ -22,7 +40,7 @@ FORCEINLINE void* operator new(size_t size, const char* szFileName, int nLine)
 	void *ptr = (void *)malloc(size);
 	if (!ptr)
 		throw "operator new() error : Bad Alloc";
-	AddTrack((DWORD)ptr, (DWORD)size, szFileName, nLine);
+	AddTrack(ptr, size, szFileName, nLine);
 	return(ptr);
 }
 //-------------
@@ -32,7 +50,7 @@ FORCEINLINE void* operator new[](size_t size, const char* szFileName, int nLine)
 	if (!ptr)
 		throw "operator new[]() error : Bad Alloc";
 
-	AddTrack((DWORD)ptr, (DWORD)size, szFileName, nLine);
+	AddTrack(ptr, size, szFileName, nLine);
 	return(ptr);
 }
 //-------------
@@ -41,10 +59,10 @@ FORCEINLINE void* operator new(size_t size, void * where, const char* szFileName
 
 //////////////////////////////////////////////////////////////////////////
 FORCEINLINE void operator delete(void* pMem)
-{ RemoveTrack((DWORD)pMem); free(pMem); }
+{ RemoveTrack(pMem); free(pMem); }
 //-------------
 FORCEINLINE void operator delete[](void* pMem)
-{ RemoveTrack((DWORD)pMem); free(pMem); }
+{ RemoveTrack(pMem); free(pMem); }
 //-------------
 FORCEINLINE void operator delete(void* pMem, void * where, const char* szFileName, int nLine)  {/* if the operator new fails */}
 //-------------
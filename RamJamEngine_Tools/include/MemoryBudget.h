@@ -0,0 +1,114 @@
+#pragma once
+
+#include "Types.h"
+#include "Debug.h"
+#include "Memory.h"
+
+#include <vector>
+#include <string>
+#include <mutex>
+
+//////////////////////////////////////////////////////////////////////////
+enum MemoryCategory
+{
+	Memory_Meshes,			// vertex and index buffers
+	Memory_Textures,		// loaded or generated textures
+	Memory_RenderTargets,	// render targets and depth buffers
+	Memory_Materials,
+	Memory_Scene,			// game objects and scene data
+	Memory_Other,
+	Memory_CategoryCount
+};
+
+const char* MemoryCategoryName(MemoryCategory category);
+
+//------------------------------------------------------------------------
+struct MemoryCategoryStats
+{
+	i64		mBytes;
+	i64		mPeakBytes;
+	i64		mBudget;			// 0: none
+	u32		mResources;			// Add() not matched by a Remove() yet
+	u32		mWarnings;			// times mBytes went over mBudget
+};
+
+//------------------------------------------------------------------------
+struct MemoryConsumer
+{
+	std::string	mName;
+	i64			mBytes;
+	u32			mResources;
+};
+
+//////////////////////////////////////////////////////////////////////////
+// Bytes held per category, for what the allocation tracker can't see or
+// can't sort: GPU resources, pools, caches. The code that creates a resource
+// declares it with Add() under a category and an owner (a file, a pool, a
+// texture name...), and takes it back with Remove() or Release().
+// A category can have a budget: the Add() that takes it over calls the
+// warning handler, once until it goes back under.
+// Plain bookkeeping, no platform or API call: an instance of its own can be
+// fed and checked anywhere. Thread-safe.
+class MemoryBudget
+{
+public:
+	typedef void (*WarningHandler)(MemoryCategory category, i64 bytes, i64 budget, const char* owner);
+
+	static MemoryBudget* Instance()
+	{
+		if (!sInstance)
+			sInstance = rje_new MemoryBudget();
+
+		return sInstance;
+	}
+
+	static void DeleteInstance()
+	{
+		RJE_SAFE_DELETE(sInstance);
+	}
+
+	// nullptr before the first Instance() and after DeleteInstance()
+	static MemoryBudget* Existing()		{ return sInstance; }
+
+	MemoryBudget();
+
+	void	Add(MemoryCategory category, const char* owner, i64 bytes);
+	void	Remove(MemoryCategory category, const char* owner, i64 bytes);
+	// Everything owner holds in category, returns the bytes
+	i64		Release(MemoryCategory category, const char* owner);
+	// Stats and budgets back to zero, the handler stays
+	void	Reset();
+
+	void	SetBudget(MemoryCategory category, i64 bytes);
+	// nullptr: the default one, a debug print
+	void	SetWarningHandler(WarningHandler handler);
+
+	MemoryCategoryStats	Stats(MemoryCategory category) const;
+	i64		TotalBytes() const;
+	BOOL	IsOverBudget(MemoryCategory category) const;
+	// The count biggest owners of category, biggest first
+	void	TopConsumers(MemoryCategory category, u32 count, OUT std::vector<MemoryConsumer>& consumers) const;
+	// Every category and its top consumers, on the console
+	void	Print(u32 topCount = 3) const;
+
+private:
+	// Not implemented
+	MemoryBudget(const MemoryBudget&);
+	MemoryBudget& operator=(const MemoryBudget&);
+
+	struct Category
+	{
+		MemoryCategoryStats			mStats;
+		std::vector<MemoryConsumer>	mConsumers;
+		std::vector<u32>			mHashes;		// of the names, one per consumer
+	};
+
+	MemoryConsumer*	FindConsumer(Category& category, const char* owner, u32 hash);
+	void			RemoveLocked(Category& category, MemoryConsumer* consumer, i64 bytes, u32 resources);
+
+	static MemoryBudget* sInstance;
+
+	Category			mCategories[Memory_CategoryCount];
+	WarningHandler		mWarningHandler;
+	mutable std::mutex	mMutex;
+};
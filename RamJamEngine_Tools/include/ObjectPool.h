@@ -0,0 +1,271 @@
+#pragma once
+
+#include "Types.h"
+#include "Debug.h"
+#include "Memory.h"
+#include "MemoryBudget.h"
+
+#include <vector>
+
+#if PLATFORM == PLATFORM_WIN32
+#	include <malloc.h>
+#else
+#	include <stdlib.h>
+#endif
+
+//////////////////////////////////////////////////////////////////////////
+// Weak reference to an object of an ObjectPool: ObjectPool::Get() returns
+// nullptr once the object is freed, even if its slot was reused since.
+template<class T>
+struct PoolHandle
+{
+	u32		mIndex;
+	u32		mGeneration;		// odd: the slot's generation when the handle was made, 0: null handle
+
+	PoolHandle() : mIndex(0), mGeneration(0) {}
+
+	BOOL IsNull() const							{ return mGeneration == 0; }
+	bool operator==(const PoolHandle& other) const	{ return mIndex == other.mIndex && mGeneration == other.mGeneration; }
+	bool operator!=(const PoolHandle& other) const	{ return !(*this == other); }
+};
+
+//////////////////////////////////////////////////////////////////////////
+// Objects of one type, in chunks of ChunkBytes aligned on ChunkBytes: the
+// chunk of an object is its address rounded down, Free() is O(1) without a
+// header per object. Within a chunk the objects are packed after a cache
+// line of header, their generation counters and the free list links after
+// them, out of the way of an iteration.
+// Free slots are handed out again most recently freed first. Each slot has
+// a generation, odd while an object lives in it, for the PoolHandles.
+// Not thread-safe: one pool per type, created and destroyed on the main thread.
+//
+// With the memory profile, objects allocated with a file and line (rje_new
+// through RJE_POOLED) are tracked like heap ones, under their call site.
+// The chunks count in the MemoryBudget, under the pool's category and name.
+template<class T, u32 ChunkBytes = 64 * 1024>
+class ObjectPool
+{
+public:
+	enum
+	{
+		CacheLine = 64,
+		PerChunk  = (ChunkBytes - CacheLine) / (sizeof(T) + 2 * sizeof(u32)),
+	};
+
+	explicit ObjectPool(const char* name, MemoryCategory category = Memory_Other)
+		: mName(name), mCategory(category), mFreeHead(0), mLiveCount(0)
+	{
+		RJE_C_ASSERT((ChunkBytes & (ChunkBytes - 1)) == 0, "ChunkBytes must be a power of two");
+		RJE_C_ASSERT(PerChunk >= 4, "T is too big for the pool's chunks");
+		RJE_C_ASSERT(__alignof(T) <= CacheLine, "T is aligned on more than a cache line");
+	}
+
+	// Objects still alive are leaked, their destructor isn't called
+	~ObjectPool()
+	{
+		FreeChunks();
+	}
+
+	//------ Raw slots, for the class operator new/delete of RJE_POOLED
+	void*	Allocate(const char* file = nullptr, u32 line = 0);
+	void	Free(void* object);
+	//------
+	T*		New()						{ return new (Allocate()) T(); }
+	void	Delete(T* object)			{ if (object) { object->~T(); Free(object); } }
+
+	PoolHandle<T>	HandleOf(const T* object) const;
+	T*				Get(PoolHandle<T> handle) const;
+
+	// function(T&) on every live object, in memory order
+	template<class Function>
+	void	ForEach(Function function);
+
+	const char*	Name() const			{ return mName; }
+	MemoryCategory	Category() const	{ return mCategory; }
+	u32		LiveCount() const			{ return mLiveCount; }
+	u32		Capacity() const			{ return (u32)mChunks.size() * PerChunk; }
+	u32		ChunkCount() const			{ return (u32)mChunks.size(); }
+
+private:
+	// Not implemented
+	ObjectPool(const ObjectPool&);
+	ObjectPool& operator=(const ObjectPool&);
+
+	struct ChunkHeader
+	{
+		u32		mIndex;				// in mChunks
+	};
+
+	T*		Object(u8* chunk, u32 slot) const		{ return reinterpret_cast<T*>(chunk + CacheLine + slot * sizeof(T)); }
+	u32*	Generations(u8* chunk) const			{ return reinterpret_cast<u32*>(chunk + CacheLine + PerChunk * sizeof(T)); }
+	u32*	NextFree(u8* chunk) const				{ return Generations(chunk) + PerChunk; }
+	u8*		ChunkOf(const void* object) const		{ return reinterpret_cast<u8*>(reinterpret_cast<uintptr_t>(object) & ~(uintptr_t)(ChunkBytes - 1)); }
+	u32		SlotOf(u8* chunk, const void* object) const	{ return (u32)((static_cast<const u8*>(object) - chunk - CacheLine) / sizeof(T)); }
+
+	void	AddChunk();
+	void	FreeChunks();
+
+	const char*			mName;
+	MemoryCategory		mCategory;
+	std::vector<u8*>	mChunks;
+	u32					mFreeHead;			// index + 1 of the first free slot, 0: none
+	u32					mLiveCount;
+};
+
+//////////////////////////////////////////////////////////////////////////
+// Class operator new/delete drawing T from T::sPool: new, rje_new and delete
+// don't change. Define the pool in a .cpp:
+//	ObjectPool<T> T::sPool("T", Memory_Scene);
+// Only for T itself: a derived class has another size.
+#define RJE_POOLED(T)																						\
+	static ObjectPool<T>	sPool;																			\
+	static void* operator new(size_t size)								{ RJE_ASSERT(size == sizeof(T)); return sPool.Allocate(); }				\
+	static void* operator new(size_t size, const char* file, int line)	{ RJE_ASSERT(size == sizeof(T)); return sPool.Allocate(file, line); }	\
+	static void* operator new(size_t, void* where)						{ return where; }						\
+	static void  operator delete(void* object)							{ sPool.Free(object); }					\
+	static void  operator delete(void* object, const char*, int)		{ sPool.Free(object); }					\
+	static void  operator delete(void*, void*)							{}
+
+//////////////////////////////////////////////////////////////////////////
+template<class T, u32 ChunkBytes>
+void ObjectPool<T, ChunkBytes>::AddChunk()
+{
+#if PLATFORM == PLATFORM_WIN32
+	u8* chunk = static_cast<u8*>(_aligned_malloc(ChunkBytes, ChunkBytes));
+#else
+	void* memory = nullptr;
+	u8* chunk = posix_memalign(&memory, ChunkBytes, ChunkBytes) == 0 ? static_cast<u8*>(memory) : nullptr;
+#endif
+	if (!chunk)
+		throw "ObjectPool::Allocate() error : Bad Alloc";
+
+	u32 chunkIndex = (u32)mChunks.size();
+	reinterpret_cast<ChunkHeader*>(chunk)->mIndex = chunkIndex;
+	mChunks.push_back(chunk);
+	MemoryBudget::Instance()->Add(mCategory, mName, ChunkBytes);
+
+	// Linked in slot order: the first objects come out in memory order
+	u32* generations = Generations(chunk);
+	u32* nextFree    = NextFree(chunk);
+	for (u32 slot = PerChunk; slot-- > 0; )
+	{
+		generations[slot] = 0;
+		nextFree[slot]    = mFreeHead;
+		mFreeHead         = chunkIndex * PerChunk + slot + 1;
+	}
+}
+
+//------------------------------------------------------------------------
+template<class T, u32 ChunkBytes>
+void ObjectPool<T, ChunkBytes>::FreeChunks()
+{
+	// A static pool can outlive the MemoryBudget
+	MemoryBudget* budget = MemoryBudget::Existing();
+	for (u8* chunk : mChunks)
+	{
+		if (budget)
+			budget->Remove(mCategory, mName, ChunkBytes);
+#if PLATFORM == PLATFORM_WIN32
+		_aligned_free(chunk);
+#else
+		free(chunk);
+#endif
+	}
+	mChunks.clear();
+	mFreeHead  = 0;
+	mLiveCount = 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+template<class T, u32 ChunkBytes>
+void* ObjectPool<T, ChunkBytes>::Allocate(const char* file, u32 line)
+{
+	if (mFreeHead == 0)
+	{
+		AddChunk();
+	}
+
+	u32 index = mFreeHead - 1;
+	u8* chunk = mChunks[index / PerChunk];
+	u32 slot  = index % PerChunk;
+
+	mFreeHead = NextFree(chunk)[slot];
+	++Generations(chunk)[slot];
+	++mLiveCount;
+
+	T* object = Object(chunk, slot);
+#ifdef RJE_MEMORY_PROFILE
+	if (file)
+		AddTrack(object, sizeof(T), file, line);
+#else
+	UNREFERENCED_PARAMETER(file);
+	UNREFERENCED_PARAMETER(line);
+#endif
+	return object;
+}
+
+//------------------------------------------------------------------------
+template<class T, u32 ChunkBytes>
+void ObjectPool<T, ChunkBytes>::Free(void* object)
+{
+	if (!object)
+		return;
+
+	u8* chunk = ChunkOf(object);
+	u32 slot  = SlotOf(chunk, object);
+	u32 chunkIndex = reinterpret_cast<ChunkHeader*>(chunk)->mIndex;
+	RJE_ASSERT(chunkIndex < mChunks.size() && mChunks[chunkIndex] == chunk);
+	RJE_ASSERT(Generations(chunk)[slot] & 1);	// freed twice
+
+#ifdef RJE_MEMORY_PROFILE
+	RemoveTrack(object);
+#endif
+	++Generations(chunk)[slot];
+	NextFree(chunk)[slot] = mFreeHead;
+	mFreeHead = chunkIndex * PerChunk + slot + 1;
+	--mLiveCount;
+}
+
+//////////////////////////////////////////////////////////////////////////
+template<class T, u32 ChunkBytes>
+PoolHandle<T> ObjectPool<T, ChunkBytes>::HandleOf(const T* object) const
+{
+	PoolHandle<T> handle;
+	if (object)
+	{
+		u8* chunk = ChunkOf(object);
+		u32 slot  = SlotOf(chunk, object);
+		handle.mIndex      = reinterpret_cast<ChunkHeader*>(chunk)->mIndex * PerChunk + slot;
+		handle.mGeneration = Generations(chunk)[slot];
+		RJE_ASSERT(handle.mGeneration & 1);
+	}
+	return handle;
+}
+
+//------------------------------------------------------------------------
+template<class T, u32 ChunkBytes>
+T* ObjectPool<T, ChunkBytes>::Get(PoolHandle<T> handle) const
+{
+	if (handle.mGeneration == 0 || handle.mIndex >= Capacity())
+		return nullptr;
+
+	u8* chunk = mChunks[handle.mIndex / PerChunk];
+	u32 slot  = handle.mIndex % PerChunk;
+	return Generations(chunk)[slot] == handle.mGeneration ? Object(chunk, slot) : nullptr;
+}
+
+//////////////////////////////////////////////////////////////////////////
+template<class T, u32 ChunkBytes>
+template<class Function>
+void ObjectPool<T, ChunkBytes>::ForEach(Function function)
+{
+	for (u8* chunk : mChunks)
+	{
+		const u32* generations = Generations(chunk);
+		for (u32 slot = 0; slot < PerChunk; ++slot)
+		{
+			if (generations[slot] & 1)
+				function(*Object(chunk, slot));
+		}
+	}
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Types.h"
+
+// Linux only: perf_event_open
+#if defined(__linux__) && !defined(RJE_NO_PERF_COUNTERS)
+#	define RJE_PERF_COUNTERS	1
+#else
+#	define RJE_PERF_COUNTERS	0
+#endif
+
+//////////////////////////////////////////////////////////////////////////
+enum PerfCounter
+{
+	PerfCounter_Cycles,
+	PerfCounter_Instructions,
+	PerfCounter_L1DMisses,			// L1 data cache read misses
+	PerfCounter_LLCMisses,			// last level cache misses
+	PerfCounter_BranchMisses,
+	PerfCounter_Count
+};
+
+// "cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses"
+const char* PerfCounterName(PerfCounter counter);
+
+//------------------------------------------------------------------------
+struct PerfCounterValues
+{
+	u64		mValues[PerfCounter_Count];
+};
+
+//////////////////////////////////////////////////////////////////////////
+// Hardware performance counters of the calling thread, user mode only.
+// On Linux, a perf_event_open group per thread: one read() returns every
+// counter, all counted over the same instructions. A counter the CPU (or
+// the VM) doesn't have reads 0 and isn't in Available(). No PMU, a
+// perf_event_paranoid over 2, a group the PMU never ran or another OS:
+// Read() returns false. A group that shared the PMU is scaled to its time.
+// A read is a system call, about a microsecond: the profiler only takes
+// them when asked to.
+struct PerfCounters
+{
+	// Opens the calling thread's counters on its first call
+	static BOOL		Read(OUT PerfCounterValues& values);
+	// A bit per PerfCounter the calling thread counts, 0: none
+	static u32		Available();
+	// Closes the calling thread's counters now, rather than when it exits
+	static void		CloseThread();
+};
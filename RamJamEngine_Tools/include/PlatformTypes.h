@@ -0,0 +1,88 @@
+#pragma once
+
+//////////////////////////////////////////////////////////////////////////
+// The few Win32 types and calls the engine's portable code relies on, for
+// the platforms without <Windows.h>: the Tools, the Math and the null
+// backend build on them, the window, the console and DX11 do not.
+
+#include <stdint.h>
+#include <limits.h>		// UINT_MAX
+#undef LINE_MAX			// POSIX's, the console has its own
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <stdio.h>
+#include <wchar.h>
+#include <stdarg.h>
+
+//////////////////////////////////////////////////////////////////////////
+//----------------------------- Types ---------------------------------//
+typedef				int					BOOL;
+typedef unsigned	char				BYTE;
+typedef unsigned	short				WORD;
+typedef				uint32_t			DWORD;
+typedef				int32_t				LONG;
+typedef				uint32_t			ULONG;
+typedef				unsigned int		UINT;
+typedef				int32_t				HRESULT;
+typedef				int64_t				LONGLONG;
+typedef				wchar_t				WCHAR;
+typedef				char				CHAR;
+typedef				char				TCHAR;
+typedef				float				FLOAT;
+typedef				const char*			LPCSTR;
+typedef				char*				LPSTR;
+typedef				const wchar_t*		LPCWSTR;
+typedef				wchar_t*			LPWSTR;
+typedef				void*				LPVOID;
+typedef				void*				HANDLE;
+typedef				void*				HWND;
+typedef				void*				HINSTANCE;
+
+typedef				intptr_t			INT_PTR;
+typedef				uintptr_t			UINT_PTR;
+typedef				intptr_t			LONG_PTR;
+typedef				uintptr_t			ULONG_PTR;
+typedef				uintptr_t			DWORD_PTR;
+
+#ifndef TRUE
+#	define TRUE		1
+#	define FALSE	0
+#endif
+
+#define S_OK			((HRESULT)0)
+#define E_FAIL			((HRESULT)0x80004005)
+#define SUCCEEDED(hr)	(((HRESULT)(hr)) >= 0)
+#define FAILED(hr)		(((HRESULT)(hr)) < 0)
+
+#define MAX_PATH		260
+
+#define IN
+#define OUT
+
+//////////////////////////////////////////////////////////////////////////
+//----------------------------- Calls ---------------------------------//
+#define OutputDebugStringA(s)	fputs(s, stderr)
+#define DebugBreak()			__builtin_trap()
+#define ZeroMemory(p, size)		memset(p, 0, size)
+#define UNREFERENCED_PARAMETER(P)	(void)(P)
+
+// The secure CRT's, sized or on an array
+#define vsprintf_s				vsnprintf
+#define sprintf_s				snprintf
+template <size_t N>
+inline int snprintf(char (&buffer)[N], const char* format, ...)
+{
+	va_list args;
+	va_start(args, format);
+	int length = vsnprintf(buffer, N, format, args);
+	va_end(args);
+	return length;
+}
+#define _snprintf_s(b, n, c, ...)	snprintf(b, n, __VA_ARGS__)
+#define strcpy_s(d, n, s)		(strncpy(d, s, n), (d)[(n) - 1] = '\0')
+#define _stricmp				strcasecmp
+#define fopen_s(f, name, mode)	((*(f) = fopen(name, mode)) ? 0 : 1)
+#define _itoa_s(value, buffer, size, radix)		snprintf(buffer, size, "%d", (int)(value))		// radix 10 only
+#define _gcvt_s(buffer, size, value, digits)	snprintf(buffer, size, "%.*g", (int)(digits), (double)(value))
+#define _CVTBUFSIZE				349
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "Types.h"
+
+//////////////////////////////////////////////////////////////////////////
+struct ProfilePercentiles
+{
+	f32		mP50;
+	f32		mP95;
+	f32		mP99;
+	f32		mMax;
+};
+
+//////////////////////////////////////////////////////////////////////////
+// The last FrameCount collected frames: the frame time, and the time of each
+// profile scope (all threads, all call paths) in ms. A scope that didn't
+// run in a frame counts 0 for it.
+class ProfileHistory
+{
+public:
+	enum { FrameCount = 256 };
+
+	ProfileHistory();
+
+	void	Reset();
+	// scopeMs: indexed by scope ID
+	void	AddFrame(f32 frameMs, const std::vector<f32>& scopeMs);
+
+	u32		FramesRecorded() const				{ return mCount; }
+	u64		FramesTotal() const					{ return mTotal; }
+	// Over the recorded frames
+	ProfilePercentiles	FramePercentiles() const;
+	ProfilePercentiles	ScopePercentiles(u32 scope) const;
+
+	// A row per recorded frame, oldest first: frame number, frame ms, then a
+	// column per scope that ran, named by scopeName(ID), quoted when the name
+	// holds a comma, a quote or a line break
+	BOOL	WriteCsv(const char* path, const char* (*scopeName)(u32)) const;
+
+	// Nearest rank on count samples, sorted in place
+	static ProfilePercentiles Percentiles(f32* samples, u32 count);
+
+private:
+	ProfilePercentiles	Percentiles(const std::vector<f32>& ring) const;
+
+	std::vector<f32>				mFrameMs;		// ring of FrameCount
+	std::vector<std::vector<f32>>	mScopeMs;		// by scope ID, a ring once the scope has run
+	u32		mNext;
+	u32		mCount;
+	u64		mTotal;
+};
@@ -4,6 +4,11 @@
 #include "Debug.h"
 #include "Globals.h"
 #include "Memory.h"
+#include "ProfileHistory.h"
+#include "Clock.h"
+#include "PerfCounters.h"
+#include <atomic>
+#include <mutex>
 
 //////////////////////////////////////////////////////////////////////////
 typedef enum PROFILER_STATES
@@ -22,15 +27,142 @@ typedef enum PROFILER_STATES
 } PROFILER_STATES;
 
 //////////////////////////////////////////////////////////////////////////
-struct Profile
+// One PROFILE_CPU site. Constant-initialized (ATOMIC_VAR_INIT), so no static
+// init race: the first run registers it, every later one reuses mId as is.
+// RegisterScope() stores mId with release, readers load it with acquire.
+struct ProfileScope
 {
-	const char* name;
-	int Id;
-	int parentId;
-	int totalCalls;
-	u64 totalTime;
+	const char*			mName;
+	std::atomic<u32>	mId;		// 0 until registered
+};
+
+//------------------------------------------------------------------------
+struct ProfileEvent
+{
+	u64		mTicks;
+	u32		mScope;
+	u32		mbBegin;
+};
+
+#if RJE_PERF_COUNTERS
+//------------------------------------------------------------------------
+// Hardware counters read with the event of the same sequence number
+struct ProfileCounterSample
+{
+	PerfCounterValues	mCounters;
+	u32					mSequence;		// the event's write index
+};
+#endif
+
+//------------------------------------------------------------------------
+// Begin/end events of one thread. The thread is the only writer and
+// Profiler::CollectFrame() the only reader, so neither takes a lock: the
+// writer only publishes mWrite, the reader only mRead. A full ring drops
+// events until the next collection.
+// The hardware counters of an event, when it has some, go in a second ring
+// of the same size, made by the first of them.
+struct ProfileThreadBuffer
+{
+	enum { Capacity = 1 << 15, Mask = Capacity - 1 };
+
+	ProfileEvent		mEvents[Capacity];
+	std::atomic<u32>	mWrite;
+	std::atomic<u32>	mRead;
+	std::atomic<u32>	mDropped;
+	char				mName[32];
+#if RJE_PERF_COUNTERS
+	std::atomic<ProfileCounterSample*>	mCounterSamples;
+#endif
+
+	ProfileThreadBuffer(const char* name);
+	~ProfileThreadBuffer();
 
-	BOOL operator<(const Profile& rhs) {return (this->totalTime < rhs.totalTime);}
+	void Push(u64 ticks, u32 scope, u32 bBegin, const PerfCounterValues* counters = nullptr)
+	{
+		u32 write = mWrite.load(std::memory_order_relaxed);
+		if (write - mRead.load(std::memory_order_acquire) >= Capacity)
+		{
+			mDropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+		ProfileEvent& e = mEvents[write & Mask];
+		e.mTicks  = ticks;
+		e.mScope  = scope;
+		e.mbBegin = bBegin;
+#if RJE_PERF_COUNTERS
+		if (counters)
+			PushCounters(write, *counters);
+#else
+		(void)counters;
+#endif
+		mWrite.store(write + 1, std::memory_order_release);
+	}
+
+#if RJE_PERF_COUNTERS
+	void PushCounters(u32 sequence, const PerfCounterValues& counters);
+	// The counters of the event sequence, nullptr if it has none
+	const ProfileCounterSample* CounterSample(u32 sequence) const
+	{
+		const ProfileCounterSample* samples = mCounterSamples.load(std::memory_order_relaxed);
+		if (!samples || samples[sequence & Mask].mSequence != sequence)
+			return nullptr;
+		return &samples[sequence & Mask];
+	}
+#endif
+
+	// The calling thread's buffer, created on its first scope
+	static ProfileThreadBuffer* Current();
+};
+
+//------------------------------------------------------------------------
+// A node per call path of a thread (same scope, other parent: other node)
+struct ProfileNode
+{
+	u32		mScope;
+	i32		mParent;
+	i32		mFirstChild;
+	i32		mNextSibling;
+	//------
+	u32		mFrameCalls;		// last collected frame
+	u64		mFrameTicks;
+	u32		mTotalCalls;		// since startup
+	u64		mTotalTicks;
+#if RJE_PERF_COUNTERS
+	//------ Hardware counters, of the calls that read them
+	u32		mFrameCounted;
+	u64		mFrameCounters[PerfCounter_Count];
+	u32		mTotalCounted;
+	u64		mTotalCounters[PerfCounter_Count];
+#endif
+};
+
+//------------------------------------------------------------------------
+// Collector side of a ProfileThreadBuffer: its call tree, node 0 the root,
+// and the scopes still open when the last collection stopped
+struct ProfileThread
+{
+	ProfileThreadBuffer*		mBuffer;
+	std::vector<ProfileNode>	mNodes;
+	std::vector<i32>			mOpenNodes;
+	std::vector<u64>			mOpenTicks;
+#if RJE_PERF_COUNTERS
+	std::vector<PerfCounterValues>	mOpenCounters;
+	std::vector<u32>				mOpenCounted;		// the begin read the counters
+#endif
+};
+
+//------------------------------------------------------------------------
+// A closed scope of a capture, in Ticks()
+struct ProfileCaptureEvent
+{
+	u64		mStart;
+	u64		mEnd;
+	u32		mScope;			// scope ID, or index in the capture's GPU names on the GPU track
+	u32		mTrack;			// thread index, or PROFILE_GPU_TRACK
+#if RJE_PERF_COUNTERS
+	u32		mbCounted;
+	u64		mCounters[PerfCounter_Count];
+#endif
 };
 
 struct ProfilerInfos
@@ -38,9 +170,37 @@ struct ProfilerInfos
 	i16		ProcessCpuUsage;
 	i16		ProcessPeakWorkingSet;
 	i16		ProcessWorkingSet;
+	//-----------
+	// Last frame, filled by the rendering API from its state cache
+	u32		StateCallsIssued;
+	u32		StateCallsFiltered;
+	u32		MaterialsIssued;
+	u32		MaterialsFiltered;
+	u32		AppliesIssued;
+	u32		AppliesFiltered;
+	//-----------
+	// Last frame, shadow partitions kept whole / only redrawing their dynamic casters
+	u32		ShadowPartitionsReused;
+	u32		ShadowStaticLayersReused;
+	//-----------
+	// Last frame, from the FrameScheduler: work against the frame rate limit's budget
+	f32		FrameWorkMs;
+	f32		FrameWaitMs;
+	f32		FrameBudgetMs;			// 0: no limit
+	u32		FrameOverBudget;		// frames since startup
+	u32		FixedSteps;
+	f32		FixedStepAlpha;
+	f32		FixedStepDroppedMs;
+	//-----------
+	// Last frame, FrameArena allocations of every thread
+	u32		FrameArenaBytes;
+	u32		FrameArenaPeakBytes;	// worst frame since startup
+	u32		FrameArenaOverflows;	// chunks added since startup
 };
 
 #define PROFILE_INFO_MAX_LENGTH 4096
+#define PROFILE_MAX_SCOPES		1024
+#define PROFILE_GPU_TRACK		0xFFFFFFFF
 
 //////////////////////////////////////////////////////////////////////////
 struct Profiler
@@ -58,6 +218,7 @@ struct Profiler
 		if(sInstance)
 		{
 #if RJE_PROFILE_CPU
+			sInstance->CollectFrame();
 			sInstance->PrintToFile();
 #endif
 			delete sInstance;
@@ -71,9 +232,39 @@ struct Profiler
 	float			mProfilerRefreshRate;
 
 	//-----------
-	void PrintChildren(std::ofstream &fout, int parent, int depth);
-	void ProfileStart(const char* name);
-	void ProfileEnd(u64 elapsedTime);
+	static u32			RegisterScope(ProfileScope& scope);
+	static const char*	ScopeName(u32 id);
+	// Clock::Ticks(): rdtsc where available, a few ns and no call, scaled by TicksPerMs()
+	static u64			Ticks()						{ return Clock::Ticks(); }
+	f64					TicksPerMs() const			{ return countsPerMs; }
+	// Names the calling thread's buffer (and creates it)
+	void				SetThreadName(const char* name);
+	// Drains every thread's events into its call tree: once per frame, on one thread
+	void				CollectFrame();
+	// Records the scopes closed during the next frameCount collections, then
+	// writes them to path as Chrome Trace Event JSON (chrome://tracing, ui.perfetto.dev)
+	void				BeginCapture(u32 frameCount, const char* path);
+	BOOL				IsCapturing() const			{ return captureFramesLeft > 0; }
+	// Recorded while capturing only: the GPU track of the timeline
+	void				AddGpuRange(const char* name, u64 startTicks, u64 endTicks);
+	// Frame time (the main thread's top scopes) and scope times of the last collections
+	const ProfileHistory& History() const			{ return history; }
+	BOOL				WriteHistoryCsv(const char* path);
+	// A collected frame over thresholdMs (0: never) appends its call trees to path
+	void				SetSpikeCapture(f32 thresholdMs, const char* path);
+	u32					SpikeCount() const			{ return spikeCount; }
+	// Every scope also reads the hardware counters of its thread (PerfCounters):
+	// a system call at each end, the scopes' times stay out of them.
+	// Returns false when the calling thread has none, they stay off.
+	BOOL				SetHardwareCounters(BOOL bEnable);
+	static BOOL			HardwareCounters()			{ return sHardwareCounters.load(std::memory_order_relaxed) != 0; }
+#if RJE_PERF_COUNTERS
+	// The calls of scope (every thread, every call path) that read the
+	// counters in the last collected frame, and their sums
+	u32					FrameCounters(u32 scope, OUT PerfCounterValues& counters);
+#endif
+	//-----------
+	void PrintChildren(std::ofstream &fout, const ProfileThread& thread, int parent, int depth);
 	void PrintToFile();
 	//-----------
 	BOOL IsActive();
@@ -89,6 +280,7 @@ struct Profiler
 	void DisplaySimpleState();
 	void DisplayAdvancedState();
 	void DisplayCpuState();
+	void DisplayChildren(const ProfileThread& thread, int parent, int depth);
 	void DisplayMemoryState();
 	void DisplayPhysicsState();
 	void DisplayAnimationState();
@@ -104,41 +296,79 @@ private:
 	Profiler();
 	~Profiler();
 	static Profiler* sInstance;
+	static std::atomic<u32> sHardwareCounters;
 
 	BOOL mIsActive;
 	PROFILER_STATES mCurrentState;
 
-	std::vector<Profile> profiles;
-	int numProfiles;
-	int currentParent;
+	friend struct ProfileThreadBuffer;
+	ProfileThreadBuffer* AddThread(const char* name);
+	void CollectThread(ProfileThread& thread, u32 threadIndex);
+	BOOL WriteCapture(const char* path);
+	void RecordHistory();
+	void WriteSpike(f32 frameMs);
+	void PrintFrameChildren(FILE* file, const ProfileThread& thread, int parent, int depth);
+
+	std::vector<ProfileThread> threads;		// in creation order, the main thread first
+	std::mutex threadsMutex;
 	int totalFrames;
 	double countsPerMs;
+	//-----------
+	std::vector<ProfileCaptureEvent>	captureEvents;
+	std::vector<std::string>			captureGpuNames;
+	std::string							capturePath;
+	u32									captureFramesLeft;
+	//-----------
+	ProfileHistory						history;
+	std::vector<f32>					frameScopeMs;
+	f32									spikeThresholdMs;
+	std::string							spikePath;
+	u32									spikeCount;
 };
 
 //////////////////////////////////////////////////////////////////////////
 struct AutoProfile
 {
-	AutoProfile(const char* name)
+	AutoProfile(ProfileScope& scope)
 	{
-		name = name;
-		Profiler::Instance()->ProfileStart(name);
-		QueryPerformanceCounter(&startTime);
+		u32 id  = scope.mId.load(std::memory_order_acquire);
+		mScope  = id ? id : Profiler::RegisterScope(scope);
+		mBuffer = ProfileThreadBuffer::Current();
+#if RJE_PERF_COUNTERS
+		// Counters before the ticks here, after them at the end: the reads
+		// stay out of the scope's time
+		if (Profiler::HardwareCounters())
+		{
+			PerfCounterValues counters;
+			BOOL bRead = PerfCounters::Read(counters);
+			mBuffer->Push(Profiler::Ticks(), mScope, true, bRead ? &counters : nullptr);
+			return;
+		}
+#endif
+		mBuffer->Push(Profiler::Ticks(), mScope, true);
 	}
 
 	~AutoProfile()
 	{
-		LARGE_INTEGER endTime;
-		QueryPerformanceCounter(&endTime);
-		u64 elapsedTime = endTime.QuadPart - startTime.QuadPart;
-		Profiler::Instance()->ProfileEnd(elapsedTime);
+#if RJE_PERF_COUNTERS
+		if (Profiler::HardwareCounters())
+		{
+			u64 ticks = Profiler::Ticks();
+			PerfCounterValues counters;
+			BOOL bRead = PerfCounters::Read(counters);
+			mBuffer->Push(ticks, mScope, false, bRead ? &counters : nullptr);
+			return;
+		}
+#endif
+		mBuffer->Push(Profiler::Ticks(), mScope, false);
 	}
 
-	const char* name;
-	LARGE_INTEGER startTime;
+	ProfileThreadBuffer*	mBuffer;
+	u32						mScope;
 };
 
 #if RJE_PROFILE_CPU
-#	define PROFILE_CPU(name)	AutoProfile profile(name)
+#	define PROFILE_CPU(name)	static ProfileScope sProfileScope = { name, ATOMIC_VAR_INIT(0) }; AutoProfile profile(sProfileScope)
 #else
 #	define PROFILE_CPU(name)	(void)0
 #endif
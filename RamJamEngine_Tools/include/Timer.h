@@ -9,10 +9,19 @@
 
 #include "Types.h"
 #include "Memory.h"
+#include "FrameScheduler.h"
 
+// Counts in u64 ticks of its FrameClock (the engine's Clock by default) and
+// converts in double: the time since Reset() doesn't drift however long the
+// session, floats only come out of the accessors.
 struct Timer
 {
+	// nullptr: the engine's Clock. A clock passed in stays the caller's.
+	explicit Timer(FrameClock* clock = nullptr);
+	~Timer();
+
 	float	Time() const;			// Return the Elapsed time the Game has been active in seconds since Reset
+	f64		PreciseTime() const;	// Time() before the cast to float: a float of hours is only accurate to the ms
 	void	Time(float time);		// Set the Elapsed playing time -- used for restarting in the middle of a game
 	float	DeltaTime() const;		// Return the Delta time between the last two updates
 	float	RealDeltaTime() const;	// Return the real delta time (without the timescale) between the last two updates
@@ -23,6 +32,7 @@ struct Timer
 	void Update();
 	bool IsActive() { return mActive; };
 	void SetTimeScale( float timeScale );
+	float TimeScale() const { return mTimeScale; }
 
 	static Timer* Instance()
 	{
@@ -42,10 +52,16 @@ struct Timer
 	}
 
 private:
-	Timer();
+	// Not implemented
+	Timer(const Timer&);
+	Timer& operator=(const Timer&);
+
 	static Timer* sInstance;
 
-	float mSecondsPerCount;		// 1.0 / Frequency
+	FrameClock*	mClock;
+	bool		mbOwnsClock;
+
+	f64   mSecondsPerCount;		// 1.0 / Frequency
 	float mRealDeltaTime;		// delta time without the timescale
 	float mDeltaTime;
 
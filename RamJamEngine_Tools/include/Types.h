@@ -4,6 +4,7 @@
 #include <cstdio>
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include <string>
 #include <algorithm>
 #include <vector>
@@ -14,10 +15,15 @@
 #include <memory>
 #include <limits>
 
+#include "Platform.h"
+
 #if PLATFORM == PLATFORM_WIN32
 #	include <Windows.h>
+#else
+#	include "PlatformTypes.h"
 #endif
 
+#if COMPILER == COMPILER_MSVC
 typedef				__int8				i8;
 typedef				__int16				i16;
 typedef				__int32				i32;
@@ -26,10 +32,17 @@ typedef unsigned	__int8				u8;
 typedef unsigned	__int16				u16;
 typedef unsigned	__int32				u32;
 
-#if COMPILER == COMPILER_MSVC
 typedef				__int64				i64;
 typedef unsigned	__int64				u64;
 #else
+typedef				int8_t				i8;
+typedef				int16_t				i16;
+typedef				int32_t				i32;
+
+typedef				uint8_t				u8;
+typedef				uint16_t			u16;
+typedef				uint32_t			u32;
+
 typedef				long long			i64;
 typedef unsigned	long long			u64;
 #endif
@@ -50,6 +63,19 @@ typedef				double				f64;
 typedef				long double			f80;
 
 
+//////////////////////////////////////////////////////////////////////////
+//------------------------ Compiler Features --------------------------//
+// constexpr only exists from the v140 toolset on: older compilers get
+// plain inline functions and runtime-initialized constants instead.
+#if defined(_MSC_VER) && (_MSC_VER < 1900)
+#	define RJE_HAS_CONSTEXPR	0
+#	define RJE_CONSTEXPR		FORCEINLINE
+#else
+#	define RJE_HAS_CONSTEXPR	1
+#	define RJE_CONSTEXPR		constexpr
+#endif
+
+
 //////////////////////////////////////////////////////////////////////////
 //---------------------- Conversion Utilities -------------------------//
 #define dtoa _gcvt_s
@@ -59,7 +85,11 @@ typedef				long double			f80;
 FORCEINLINE std::wstring AnsiToWString(const char* ansiString)
 {
 	WCHAR buffer[512];
+#if PLATFORM == PLATFORM_WIN32
 	if (MultiByteToWideChar(CP_ACP, 0, ansiString, -1, buffer, 512))
+#else
+	if (mbstowcs(buffer, ansiString, 512) != (size_t)-1)
+#endif
 		return std::wstring(buffer);
 	
 	return std::wstring();
@@ -107,8 +137,10 @@ FORCEINLINE std::string ToAnsiString(const T& val)
 // the unsigned variation.
 //
 // __int3264 is intrinsic to 64b MIDL but not to old MIDL or to C compiler.
+// Elsewhere than on Win32, PlatformTypes.h has them.
 //
-#if ( defined(__midl) && (501 < __midl) )
+#if PLATFORM != PLATFORM_WIN32
+#elif ( defined(__midl) && (501 < __midl) )
 
 typedef [public] __int3264 INT_PTR, *PINT_PTR;
 typedef [public] unsigned __int3264 UINT_PTR, *PUINT_PTR;
@@ -0,0 +1,199 @@
+#include "BenchmarkReport.h"
+
+#include <string.h>
+
+//////////////////////////////////////////////////////////////////////////
+// Nothing to escape in the JSON strings
+static std::string CleanName(const char* name)
+{
+	std::string clean = name ? name : "";
+	for (u32 i = 0; i < clean.size(); ++i)
+	{
+		if (clean[i] == '"' || clean[i] == '\\' || (u8)clean[i] < ' ')
+			clean[i] = '_';
+	}
+	return clean;
+}
+
+//------------------------------------------------------------------------
+// Just after the ':' of "key" in object, npos if it isn't there
+static size_t FindField(const std::string& object, const char* key)
+{
+	std::string quoted = std::string("\"") + key + "\"";
+	size_t pos = object.find(quoted);
+	if (pos == std::string::npos)
+		return std::string::npos;
+	pos = object.find(':', pos + quoted.size());
+	return pos == std::string::npos ? pos : pos + 1;
+}
+
+//------------------------------------------------------------------------
+static BOOL ReadString(const std::string& object, const char* key, OUT std::string& value)
+{
+	size_t pos = FindField(object, key);
+	if (pos == std::string::npos)
+		return false;
+	size_t begin = object.find('"', pos);
+	size_t end   = begin == std::string::npos ? begin : object.find('"', begin + 1);
+	if (end == std::string::npos)
+		return false;
+	value = object.substr(begin + 1, end - begin - 1);
+	return true;
+}
+
+//------------------------------------------------------------------------
+static BOOL ReadNumber(const std::string& object, const char* key, OUT f64& value)
+{
+	size_t pos = FindField(object, key);
+	return pos != std::string::npos && sscanf(object.c_str() + pos, "%lf", &value) == 1;
+}
+
+//------------------------------------------------------------------------
+static const char* FormatValue(const BenchmarkResult& result, OUT char (&buf)[48])
+{
+	sprintf_s(buf, "%.4g %s", result.mValue, result.mUnit.c_str());
+	return buf;
+}
+
+//////////////////////////////////////////////////////////////////////////
+BenchmarkReport::BenchmarkReport()
+	: mDefaultTolerance(10.0)
+	, mMinimumTolerance(0.0)
+{
+}
+
+//////////////////////////////////////////////////////////////////////////
+void BenchmarkReport::Record(const char* name, f64 value, const char* unit, f64 tolerance)
+{
+	BenchmarkResult result;
+	result.mName      = CleanName(name);
+	result.mValue     = value;
+	result.mUnit      = CleanName(unit);
+	result.mTolerance = tolerance > 0.0 ? tolerance : 0.0;
+
+	for (u32 i = 0; i < mResults.size(); ++i)
+	{
+		if (mResults[i].mName == result.mName)
+		{
+			mResults[i] = result;
+			return;
+		}
+	}
+	mResults.push_back(result);
+}
+
+//------------------------------------------------------------------------
+const BenchmarkResult* BenchmarkReport::Find(const char* name) const
+{
+	for (u32 i = 0; i < mResults.size(); ++i)
+	{
+		if (mResults[i].mName == name)
+			return &mResults[i];
+	}
+	return nullptr;
+}
+
+//////////////////////////////////////////////////////////////////////////
+BOOL BenchmarkReport::Save(const char* path) const
+{
+	FILE* file = fopen(path, "w");
+	if (!file)
+		return false;
+
+	fprintf(file, "{\n\t\"results\": [\n");
+	for (u32 i = 0; i < mResults.size(); ++i)
+	{
+		const BenchmarkResult& result = mResults[i];
+		fprintf(file, "\t\t{ \"name\": \"%s\", \"value\": %.9g, \"unit\": \"%s\"", result.mName.c_str(), result.mValue, result.mUnit.c_str());
+		if (result.mTolerance > 0.0)
+			fprintf(file, ", \"tolerance\": %g", result.mTolerance);
+		fprintf(file, " }%s\n", i + 1 < mResults.size() ? "," : "");
+	}
+	fprintf(file, "\t]\n}\n");
+	fclose(file);
+	return true;
+}
+
+//------------------------------------------------------------------------
+BOOL BenchmarkReport::Load(const char* path)
+{
+	FILE* file = fopen(path, "r");
+	if (!file)
+		return false;
+
+	std::string text;
+	char buf[4096];
+	size_t read;
+	while ((read = fread(buf, 1, sizeof(buf), file)) > 0)
+		text.append(buf, read);
+	fclose(file);
+
+	mResults.clear();
+
+	// Each {...} after "results" is a result, without nested objects
+	size_t pos = text.find("\"results\"");
+	while (pos != std::string::npos)
+	{
+		size_t begin = text.find('{', pos);
+		size_t end   = begin == std::string::npos ? begin : text.find('}', begin);
+		if (end == std::string::npos)
+			break;
+
+		std::string object = text.substr(begin, end - begin + 1);
+		BenchmarkResult result;
+		result.mTolerance = 0.0;
+		if (ReadString(object, "name", result.mName) && ReadNumber(object, "value", result.mValue))
+		{
+			ReadString(object, "unit", result.mUnit);
+			ReadNumber(object, "tolerance", result.mTolerance);
+			Record(result.mName.c_str(), result.mValue, result.mUnit.c_str(), result.mTolerance);
+		}
+		pos = end + 1;
+	}
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+u32 BenchmarkReport::Compare(const BenchmarkReport& baseline, FILE* out) const
+{
+	u32 regressions = 0;
+	char baseValue[48], value[48];
+	fprintf(out, "%-44s %18s %18s %9s\n", "benchmark", "baseline", "current", "change");
+
+	for (u32 i = 0; i < mResults.size(); ++i)
+	{
+		const BenchmarkResult& result = mResults[i];
+		const BenchmarkResult* base   = baseline.Find(result.mName.c_str());
+		if (!base)
+		{
+			fprintf(out, "%-44s %18s %18s %9s\n", result.mName.c_str(), "-", FormatValue(result, value), "new");
+			continue;
+		}
+
+		f64 tolerance = base->mTolerance > 0.0 ? base->mTolerance : (result.mTolerance > 0.0 ? result.mTolerance : mDefaultTolerance);
+		tolerance     = tolerance > mMinimumTolerance ? tolerance : mMinimumTolerance;
+		f64 limit     = base->mValue + (base->mValue > 0.0 ? base->mValue : -base->mValue) * tolerance / 100.0;
+		BOOL bRegressed = result.mValue > limit;
+		regressions += bRegressed ? 1 : 0;
+
+		char change[16];
+		if (base->mValue != 0.0)
+			sprintf_s(change, "%+.1f%%", 100.0 * (result.mValue - base->mValue) / (base->mValue > 0.0 ? base->mValue : -base->mValue));
+		else
+			sprintf_s(change, "%s", result.mValue == 0.0 ? "+0.0%" : "n/a");
+
+		fprintf(out, "%-44s %18s %18s %9s", result.mName.c_str(), FormatValue(*base, baseValue), FormatValue(result, value), change);
+		if (bRegressed && base->mValue != 0.0)
+			fprintf(out, "  REGRESSION, over %g%%", tolerance);
+		else if (bRegressed)
+			fprintf(out, "  REGRESSION");
+		fprintf(out, "\n");
+	}
+
+	for (u32 i = 0; i < baseline.mResults.size(); ++i)
+	{
+		if (!Find(baseline.mResults[i].mName.c_str()))
+			fprintf(out, "%-44s %18s %18s %9s\n", baseline.mResults[i].mName.c_str(), FormatValue(baseline.mResults[i], baseValue), "-", "missing");
+	}
+	return regressions;
+}
@@ -0,0 +1,142 @@
+#include "Clock.h"
+#include "Debug.h"
+
+#include <thread>
+
+#if RJE_CLOCK_TSC && !defined(_MSC_VER)
+#	include <cpuid.h>
+#endif
+
+// No initializer: zero-initialized and no constructor to run, so usable
+// before the static constructors. Zero is Source_Unknown.
+RJE_C_ASSERT(Clock::Source_Unknown == 0, "the clock source is zero-initialized");
+std::atomic<Clock::Source>	Clock::sSource;
+std::atomic<u64>			Clock::sFrequency;
+std::atomic<u64>			Clock::sOsFrequency;
+std::atomic<u32>			Clock::sbCalibrating;
+
+//////////////////////////////////////////////////////////////////////////
+// CPUID 0x80000007, EDX bit 8: the TSC runs at a constant rate in every
+// P-, C- and T-state, and is synchronized across cores
+static BOOL HasInvariantTsc()
+{
+#if RJE_CLOCK_TSC && defined(_MSC_VER)
+	int registers[4];
+	__cpuid(registers, 0x80000000);
+	if (static_cast<u32>(registers[0]) < 0x80000007)
+		return false;
+	__cpuid(registers, 0x80000007);
+	return (registers[3] & (1 << 8)) != 0;
+#elif RJE_CLOCK_TSC
+	if (__get_cpuid_max(0x80000000, nullptr) < 0x80000007)
+		return false;
+	unsigned int eax, ebx, ecx, edx;
+	if (!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx))
+		return false;
+	return (edx & (1 << 8)) != 0;
+#else
+	return false;
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////
+Clock::Source Clock::ChooseSource()
+{
+	Source source = HasInvariantTsc() ? Source_CycleCounter : Source_OsClock;
+	sSource.store(source, std::memory_order_relaxed);
+	return source;
+}
+
+//------------------------------------------------------------------------
+Clock::Source Clock::GetSource()
+{
+	Source source = sSource.load(std::memory_order_relaxed);
+	return source != Source_Unknown ? source : ChooseSource();
+}
+
+//////////////////////////////////////////////////////////////////////////
+u64 Clock::OsFrequency()
+{
+	u64 frequency = sOsFrequency.load(std::memory_order_relaxed);
+	if (!frequency)
+	{
+#if PLATFORM == PLATFORM_WIN32
+		LARGE_INTEGER osFrequency;
+		QueryPerformanceFrequency(&osFrequency);
+		frequency = osFrequency.QuadPart;
+#else
+		frequency = 1000000000ull;
+#endif
+		sOsFrequency.store(frequency, std::memory_order_relaxed);
+	}
+	return frequency;
+}
+
+//////////////////////////////////////////////////////////////////////////
+#if RJE_CLOCK_TSC
+// Both clocks read at once: the OS clock between two rdtsc, the tightest of
+// a few tries, so that a preemption doesn't end up in the calibration
+static void ReadBothClocks(OUT u64& tsc, OUT u64& os)
+{
+	tsc = 0;
+	os  = 0;
+	u64 bestSpread = ~0ull;
+	for (u32 i = 0; i < 8; ++i)
+	{
+		u64 before  = __rdtsc();
+		u64 osTicks = Clock::OsTicks();
+		u64 after   = __rdtsc();
+		if (after - before < bestSpread)
+		{
+			bestSpread = after - before;
+			tsc = before + (after - before) / 2;
+			os  = osTicks;
+		}
+	}
+}
+#endif
+
+//------------------------------------------------------------------------
+// The first call, from the main thread at startup (the Profiler makes it),
+// spins CalibrationMs when the source is the TSC. A thread coming in the
+// meantime waits for that result rather than calibrating its own.
+u64 Clock::Frequency()
+{
+	u64 frequency = sFrequency.load(std::memory_order_acquire);
+	if (frequency)
+		return frequency;
+
+	u32 unclaimed = 0;
+	if (sbCalibrating.compare_exchange_strong(unclaimed, 1))
+	{
+		frequency = Calibrate();
+		sFrequency.store(frequency, std::memory_order_release);
+		return frequency;
+	}
+
+	while (!(frequency = sFrequency.load(std::memory_order_acquire)))
+		std::this_thread::yield();
+	return frequency;
+}
+
+//------------------------------------------------------------------------
+u64 Clock::Calibrate()
+{
+#if RJE_CLOCK_TSC
+	if (GetSource() == Source_CycleCounter)
+	{
+		const u64 CalibrationMs = 20;
+
+		u64 tscStart, osStart;
+		ReadBothClocks(tscStart, osStart);
+		u64 osEnd = osStart + OsFrequency() * CalibrationMs / 1000;
+		while (OsTicks() < osEnd) {}
+		u64 tscEnd;
+		ReadBothClocks(tscEnd, osEnd);
+
+		return static_cast<u64>(static_cast<f64>(tscEnd - tscStart) * OsFrequency() / (osEnd - osStart) + 0.5);
+	}
+#endif
+
+	return OsFrequency();
+}
@@ -0,0 +1,90 @@
+#include "FileSystem.h"
+
+#if PLATFORM != PLATFORM_WIN32
+#	include <dirent.h>
+#	include <sys/stat.h>
+#endif
+
+#include <string.h>
+
+//////////////////////////////////////////////////////////////////////////
+void FileSystem::FindFiles(const std::string& dir, const char* extension, OUT std::vector<std::string>& files)
+{
+	files.clear();
+	FindFilesUnsorted(NativePath(dir), extension, files);
+	std::sort(files.begin(), files.end());
+}
+
+//------------------------------------------------------------------------
+std::string FileSystem::FileStem(const std::string& path)
+{
+	size_t slash = path.find_last_of("\\/");
+	size_t begin = slash == std::string::npos ? 0 : slash + 1;
+	size_t point = path.rfind('.');
+	return path.substr(begin, point == std::string::npos || point < begin ? std::string::npos : point - begin);
+}
+
+//------------------------------------------------------------------------
+std::string FileSystem::NativePath(const std::string& path)
+{
+#if PLATFORM == PLATFORM_WIN32
+	return path;
+#else
+	std::string native = path;
+	std::replace(native.begin(), native.end(), '\\', '/');
+	return native;
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////
+void FileSystem::FindFilesUnsorted(const std::string& dir, const char* extension, OUT std::vector<std::string>& files)
+{
+	size_t extensionLength = strlen(extension);
+#if PLATFORM == PLATFORM_WIN32
+	WIN32_FIND_DATAA findData;
+	HANDLE hFind = FindFirstFileA((dir + "*").c_str(), &findData);
+	if (hFind == INVALID_HANDLE_VALUE)
+		return;
+
+	do
+	{
+		std::string name = findData.cFileName;
+		if (findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+		{
+			if (name != "." && name != "..")
+				FindFilesUnsorted(dir + name + "\\", extension, files);
+		}
+		else if (name.size() > extensionLength && name.compare(name.size() - extensionLength, extensionLength, extension) == 0)
+		{
+			files.push_back(dir + name);
+		}
+	} while (FindNextFileA(hFind, &findData));
+	FindClose(hFind);
+#else
+	DIR* directory = opendir(dir.c_str());
+	if (!directory)
+		return;
+
+	while (dirent* entry = readdir(directory))
+	{
+		std::string name = entry->d_name;
+		if (name == "." || name == "..")
+			continue;
+
+		// d_type is DT_UNKNOWN on some file systems: stat() then
+		struct stat status;
+		if (stat((dir + name).c_str(), &status) != 0)
+			continue;
+
+		if (S_ISDIR(status.st_mode))
+		{
+			FindFilesUnsorted(dir + name + "/", extension, files);
+		}
+		else if (name.size() > extensionLength && name.compare(name.size() - extensionLength, extensionLength, extension) == 0)
+		{
+			files.push_back(dir + name);
+		}
+	}
+	closedir(directory);
+#endif
+}
@@ -0,0 +1,205 @@
+#include "FrameArena.h"
+#include "Memory.h"
+
+FrameArena* FrameArena::sInstance = nullptr;
+
+// A new FrameArena has new arenas: the threads' cached ones are stale
+static u32										sGeneration = 0;
+static RJE_THREAD_LOCAL FrameArena::ThreadArenas*	tThreadArenas     = nullptr;
+static RJE_THREAD_LOCAL u32						tThreadGeneration = 0;
+
+//////////////////////////////////////////////////////////////////////////
+LinearArena::LinearArena(size_t chunkSize)
+	: mChunks(nullptr)
+	, mCursor(0), mEnd(0)
+	, mChunkSize(chunkSize)
+	, mUsed(0)
+	, mOverflows(0)
+{
+#ifdef RJE_DEBUG
+	mbPoison = true;
+#else
+	mbPoison = false;
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////
+LinearArena::~LinearArena()
+{
+	while (mChunks)
+	{
+		Chunk* next = mChunks->mNext;
+		free(mChunks);
+		mChunks = next;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+size_t LinearArena::Capacity() const
+{
+	size_t capacity = 0;
+	for (Chunk* chunk = mChunks; chunk; chunk = chunk->mNext)
+	{
+		capacity += chunk->mSize;
+	}
+	return capacity;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void LinearArena::AddChunk(size_t minSize)
+{
+	if (mChunks)
+	{
+		++mOverflows;
+	}
+
+	size_t size  = minSize > mChunkSize ? minSize : mChunkSize;
+	Chunk* chunk = static_cast<Chunk*>(malloc(sizeof(Chunk) + size));
+	RJE_ASSERT(chunk);
+
+	chunk->mNext  = mChunks;
+	chunk->mSize  = size;
+	mChunks = chunk;
+	mCursor = reinterpret_cast<uintptr_t>(chunk->Data());
+	mEnd    = mCursor + size;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void* LinearArena::Allocate(size_t size, size_t alignment)
+{
+	RJE_ASSERT(alignment && (alignment & (alignment - 1)) == 0);
+
+	uintptr_t start = (mCursor + alignment - 1) & ~(uintptr_t)(alignment - 1);
+	if (!mChunks || start + size > mEnd)
+	{
+		AddChunk(size + alignment - 1);
+		start = (mCursor + alignment - 1) & ~(uintptr_t)(alignment - 1);
+	}
+
+	mUsed  += start + size - mCursor;
+	mCursor = start + size;
+	return reinterpret_cast<void*>(start);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void LinearArena::Reset()
+{
+	if (mChunks && mChunks->mNext)
+	{
+		// Outgrown: one chunk big enough for all of them from now on
+		size_t capacity = Capacity();
+		while (mChunks)
+		{
+			Chunk* next = mChunks->mNext;
+			if (mbPoison)
+			{
+				memset(mChunks->Data(), PoisonByte, mChunks->mSize);
+			}
+			free(mChunks);
+			mChunks = next;
+		}
+		mChunkSize = capacity;
+		AddChunk(0);
+		if (mbPoison)
+		{
+			memset(mChunks->Data(), PoisonByte, mChunks->mSize);
+		}
+	}
+	else if (mChunks)
+	{
+		if (mbPoison)
+		{
+			memset(mChunks->Data(), PoisonByte, mCursor - reinterpret_cast<uintptr_t>(mChunks->Data()));
+		}
+		mCursor = reinterpret_cast<uintptr_t>(mChunks->Data());
+	}
+	mUsed = 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+FrameArena::FrameArena()
+	: mGeneration(++sGeneration)
+	, mCurrent(0)
+	, mLastFrameBytes(0)
+	, mPeakFrameBytes(0)
+	, mPeakFrame(0)
+	, mFrames(0)
+{
+}
+
+//////////////////////////////////////////////////////////////////////////
+FrameArena::~FrameArena()
+{
+	for (ThreadArenas* thread : mThreads)
+	{
+		RJE_SAFE_DELETE(thread);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+FrameArena::ThreadArenas* FrameArena::AddThread()
+{
+	std::lock_guard<std::mutex> lock(mThreadsMutex);
+	mThreads.push_back(rje_new ThreadArenas());
+	return mThreads.back();
+}
+
+//////////////////////////////////////////////////////////////////////////
+LinearArena& FrameArena::Current()
+{
+	if (tThreadGeneration != mGeneration)
+	{
+		tThreadArenas     = AddThread();
+		tThreadGeneration = mGeneration;
+	}
+	return tThreadArenas->mArenas[mCurrent.load(std::memory_order_acquire)];
+}
+
+//////////////////////////////////////////////////////////////////////////
+void FrameArena::BeginFrame()
+{
+	std::lock_guard<std::mutex> lock(mThreadsMutex);
+
+	u32 current = mCurrent.load(std::memory_order_relaxed);
+
+	size_t frameBytes = 0;
+	for (ThreadArenas* thread : mThreads)
+	{
+		frameBytes += thread->mArenas[current].Used();
+	}
+	mLastFrameBytes = frameBytes;
+	if (frameBytes > mPeakFrameBytes)
+	{
+		mPeakFrameBytes = frameBytes;
+		mPeakFrame      = mFrames;
+	}
+	++mFrames;
+
+	// The frame before last is over
+	current ^= 1;
+	for (ThreadArenas* thread : mThreads)
+	{
+		thread->mArenas[current].Reset();
+	}
+	mCurrent.store(current, std::memory_order_release);
+}
+
+//////////////////////////////////////////////////////////////////////////
+u32 FrameArena::Overflows() const
+{
+	std::lock_guard<std::mutex> lock(mThreadsMutex);
+
+	u32 overflows = 0;
+	for (ThreadArenas* thread : mThreads)
+	{
+		overflows += thread->mArenas[0].Overflows() + thread->mArenas[1].Overflows();
+	}
+	return overflows;
+}
+
+//////////////////////////////////////////////////////////////////////////
+u32 FrameArena::ThreadCount() const
+{
+	std::lock_guard<std::mutex> lock(mThreadsMutex);
+	return (u32)mThreads.size();
+}
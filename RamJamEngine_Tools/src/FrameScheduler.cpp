@@ -0,0 +1,179 @@
+#include "FrameScheduler.h"
+#include "Memory.h"
+#include "Debug.h"
+
+#if PLATFORM == PLATFORM_WIN32
+#	include <Mmsystem.h>
+#	pragma comment(lib, "winmm.lib")
+#else
+#	include <chrono>
+#	include <thread>
+#endif
+
+//////////////////////////////////////////////////////////////////////////
+HighResolutionClock::HighResolutionClock()
+	: mFrequency(Clock::Frequency())
+{
+#if PLATFORM == PLATFORM_WIN32
+	timeBeginPeriod(1);
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////
+HighResolutionClock::~HighResolutionClock()
+{
+#if PLATFORM == PLATFORM_WIN32
+	timeEndPeriod(1);
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////
+void HighResolutionClock::WaitUntil(u64 ticks)
+{
+	const u64 spinTicks = mFrequency * SpinMs / 1000;
+
+	for (u64 now = Now(); now < ticks; now = Now())
+	{
+		u64 remaining = ticks - now;
+		if (remaining > spinTicks)
+		{
+			u32 sleepMs = static_cast<u32>((remaining - spinTicks) * 1000 / mFrequency);
+#if PLATFORM == PLATFORM_WIN32
+			Sleep(sleepMs > 0 ? sleepMs : 1);
+#else
+			std::this_thread::sleep_for(std::chrono::milliseconds(sleepMs > 0 ? sleepMs : 1));
+#endif
+		}
+		else
+		{
+#if PLATFORM == PLATFORM_WIN32
+			YieldProcessor();
+#else
+			std::this_thread::yield();
+#endif
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+FrameScheduler::FrameScheduler(FrameClock* clock)
+	: mbFixedStep(false)
+	, mFixedStep(1.0f / 60.0f)
+	, mMaxSteps(5)
+	, mMaxFrameRate(0.0f)
+	, mPausedFrameRate(20.0f)
+	, mTimeScale(1.0f)
+	, mClock(clock)
+	, mbOwnsClock(clock == nullptr)
+{
+	if (mbOwnsClock)
+	{
+		mClock = rje_new HighResolutionClock();
+	}
+	Reset();
+}
+
+//////////////////////////////////////////////////////////////////////////
+FrameScheduler::~FrameScheduler()
+{
+	if (mbOwnsClock)
+	{
+		RJE_SAFE_DELETE(mClock);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+void FrameScheduler::Reset()
+{
+	mSteps      = 0;
+	mStepTime   = 0.0f;
+	mAlpha      = 0.0f;
+	mFrameMs    = 0.0f;
+	mWorkMs     = 0.0f;
+	mWaitMs     = 0.0f;
+	mDroppedMs  = 0.0f;
+	mFrames           = 0;
+	mOverBudgetFrames = 0;
+	//------
+	mbStarted    = false;
+	mFrameStart  = 0;
+	mWorkStart   = 0;
+	mAccumulator = 0.0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+u32 FrameScheduler::BeginFrame(BOOL bPaused)
+{
+	const f64 secondsPerTick = 1.0 / mClock->Frequency();
+
+	u64 now = mClock->Now();
+
+	// Frame rate limit: hold the frame until its slot
+	mWaitMs = 0.0f;
+	f32 frameRate = bPaused ? mPausedFrameRate : mMaxFrameRate;
+	if (mbStarted && frameRate > 0.0f)
+	{
+		u64 target = mFrameStart + static_cast<u64>(mClock->Frequency() / frameRate);
+		if (now < target)
+		{
+			mClock->WaitUntil(target);
+			u64 waited = mClock->Now();
+			mWaitMs = static_cast<f32>((waited - now) * secondsPerTick * 1000.0);
+			now = waited;
+		}
+	}
+
+	f64 frameTime = mbStarted ? (now - mFrameStart) * secondsPerTick : 0.0;
+	mFrameMs    = static_cast<f32>(frameTime * 1000.0);
+	mFrameStart = now;
+	mWorkStart  = now;
+	mbStarted   = true;
+	mDroppedMs  = 0.0f;
+
+	if (bPaused)
+	{
+		// Nothing owed when the app comes back
+		mAccumulator = 0.0;
+		mSteps    = 0;
+		mStepTime = 0.0f;
+		mAlpha    = 0.0f;
+		return 0;
+	}
+
+	if (!mbFixedStep)
+	{
+		mSteps    = 1;
+		mStepTime = static_cast<f32>(frameTime * mTimeScale);
+		mAlpha    = 1.0f;
+		return 1;
+	}
+
+	RJE_ASSERT(mFixedStep > 0.0f);
+	mAccumulator += frameTime * mTimeScale;
+	u32 steps = static_cast<u32>(mAccumulator / mFixedStep);
+	if (steps > mMaxSteps)
+	{
+		mDroppedMs    = static_cast<f32>((steps - mMaxSteps) * mFixedStep * 1000.0);
+		mAccumulator -= (steps - mMaxSteps) * static_cast<f64>(mFixedStep);
+		steps = mMaxSteps;
+	}
+	mAccumulator -= steps * static_cast<f64>(mFixedStep);
+
+	mSteps    = steps;
+	mStepTime = mFixedStep;
+	mAlpha    = static_cast<f32>(mAccumulator / mFixedStep);
+	return steps;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void FrameScheduler::EndFrame()
+{
+	mWorkMs = static_cast<f32>((mClock->Now() - mWorkStart) * 1000.0 / mClock->Frequency());
+	++mFrames;
+
+	f32 budgetMs = BudgetMs();
+	if (budgetMs > 0.0f && mWorkMs > budgetMs)
+	{
+		++mOverBudgetFrames;
+	}
+}
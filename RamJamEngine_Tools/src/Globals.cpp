@@ -1,4 +1,12 @@
 #include "Globals.h"
+#include "IniFile.h"
+#include "MemoryBudget.h"
+
+//************************************************************************
+//	Paths
+//************************************************************************
+std::string	RJE_GLOBALS::gResourcesPath;
+std::string	RJE_GLOBALS::gDataPath;
 
 //************************************************************************
 //	Rendering
@@ -12,8 +20,87 @@ int		RJE_GLOBALS::gScreenHeight;
 //************************************************************************
 int		RJE_GLOBALS::gDebugVerbosity;
 BOOL	RJE_GLOBALS::gShowCursor;
+int		RJE_GLOBALS::gSpikeThresholdMs;
+BOOL	RJE_GLOBALS::gHardwareCounters;
+
+//************************************************************************
+//	Memory budgets
+//************************************************************************
+int		RJE_GLOBALS::gMeshesBudgetMb;
+int		RJE_GLOBALS::gTexturesBudgetMb;
+int		RJE_GLOBALS::gRenderTargetsBudgetMb;
+int		RJE_GLOBALS::gMaterialsBudgetMb;
+int		RJE_GLOBALS::gSceneBudgetMb;
+
+//************************************************************************
+//	Benchmark
+//************************************************************************
+int		RJE_GLOBALS::gBenchmarkTolerance;
 
 //************************************************************************
 //	Misc
 //************************************************************************
 BOOL	RJE_GLOBALS::gRunInBackground;
+BOOL	RJE_GLOBALS::gFixedStep;
+int		RJE_GLOBALS::gFixedStepRate;
+int		RJE_GLOBALS::gMaxFrameRate;
+
+//////////////////////////////////////////////////////////////////////////
+void RJE_GLOBALS::LoadConfigFile(const char* filename)
+{
+	std::ifstream iFile(filename);
+	if (!iFile)
+	{
+		CIniFile::Create(filename);
+
+		CIniFile::SetValue("fullscreen",   "false", "rendering", filename);
+		CIniFile::SetValue("screenwidth",  "1280",  "rendering", filename);
+		CIniFile::SetValue("screenheight", "720",   "rendering", filename);
+		//---------------
+		CIniFile::SetValue("runinbackground", "true",  "misc", filename);
+		CIniFile::SetValue("fixedstep",       "false", "misc", filename);
+		CIniFile::SetValue("fixedstephz",     "60",    "misc", filename);
+		CIniFile::SetValue("maxfps",          "0",     "misc", filename);
+		//---------------
+		CIniFile::SetValue("debugverbosity", "0",    "debug", filename);
+		CIniFile::SetValue("showcursor",     "true", "debug", filename);
+		CIniFile::SetValue("spikems",        "50",   "debug", filename);
+		CIniFile::SetValue("hwcounters",     "false", "debug", filename);
+		//---------------
+		CIniFile::SetValue("meshesmb",        "256", "memory", filename);
+		CIniFile::SetValue("texturesmb",      "512", "memory", filename);
+		CIniFile::SetValue("rendertargetsmb", "256", "memory", filename);
+		CIniFile::SetValue("materialsmb",     "16",  "memory", filename);
+		CIniFile::SetValue("scenemb",         "32",  "memory", filename);
+		//---------------
+		CIniFile::SetValue("tolerance", "10", "benchmark", filename);
+	}
+	RJE_GLOBALS::gFullScreen			= CIniFile::GetValueBool("fullscreen",  "rendering", filename);
+	RJE_GLOBALS::gScreenWidth			= CIniFile::GetValueInt("screenwidth",  "rendering", filename);
+	RJE_GLOBALS::gScreenHeight			= CIniFile::GetValueInt("screenheight", "rendering", filename);
+	//---------------
+	RJE_GLOBALS::gRunInBackground		= CIniFile::GetValueBool("runinbackground", "misc", filename);
+	RJE_GLOBALS::gFixedStep			= CIniFile::GetValueBool("fixedstep",       "misc", filename);
+	RJE_GLOBALS::gFixedStepRate		= CIniFile::GetValueInt("fixedstephz",      "misc", filename);
+	RJE_GLOBALS::gMaxFrameRate			= CIniFile::GetValueInt("maxfps",           "misc", filename);
+	//---------------
+	RJE_GLOBALS::gDebugVerbosity		= CIniFile::GetValueInt("debugverbosity", "debug", filename);
+	RJE_GLOBALS::gShowCursor			= CIniFile::GetValueBool("showcursor",    "debug", filename);
+	RJE_GLOBALS::gSpikeThresholdMs		= CIniFile::GetValueInt("spikems",         "debug", filename);
+	RJE_GLOBALS::gHardwareCounters		= CIniFile::GetValueBool("hwcounters",    "debug", filename);
+	//---------------
+	RJE_GLOBALS::gMeshesBudgetMb			= CIniFile::GetValueInt("meshesmb",        "memory", filename);
+	RJE_GLOBALS::gTexturesBudgetMb			= CIniFile::GetValueInt("texturesmb",      "memory", filename);
+	RJE_GLOBALS::gRenderTargetsBudgetMb	= CIniFile::GetValueInt("rendertargetsmb", "memory", filename);
+	RJE_GLOBALS::gMaterialsBudgetMb		= CIniFile::GetValueInt("materialsmb",     "memory", filename);
+	RJE_GLOBALS::gSceneBudgetMb			= CIniFile::GetValueInt("scenemb",         "memory", filename);
+	//---------------
+	RJE_GLOBALS::gBenchmarkTolerance		= CIniFile::GetValueInt("tolerance", "benchmark", filename);
+
+	MemoryBudget* budget = MemoryBudget::Instance();
+	budget->SetBudget(Memory_Meshes,        (i64)RJE_GLOBALS::gMeshesBudgetMb        << 20);
+	budget->SetBudget(Memory_Textures,      (i64)RJE_GLOBALS::gTexturesBudgetMb      << 20);
+	budget->SetBudget(Memory_RenderTargets, (i64)RJE_GLOBALS::gRenderTargetsBudgetMb << 20);
+	budget->SetBudget(Memory_Materials,     (i64)RJE_GLOBALS::gMaterialsBudgetMb     << 20);
+	budget->SetBudget(Memory_Scene,         (i64)RJE_GLOBALS::gSceneBudgetMb         << 20);
+}
@@ -1,5 +1,4 @@
 #include "Input.h"
-#include "../../RamJamEngine/include/Console.h"
 
 Input* Input::sInstance = nullptr;
 
@@ -8,6 +7,7 @@ Input::Input()
 {
 	mMousePosX = 0;
 	mMousePosY = 0;
+	mTextInputHandler = nullptr;
 
 	ResetInputStates();
 	for(int iKey=0; iKey<KEYBOARD_INPUTS; ++iKey)		mKeyboardState[iKey]   = false;
@@ -19,17 +19,13 @@ void Input::HandleInputEvent(UINT umsg, WPARAM wparam, LPARAM lparam)
 {
 	bUpdated = true;
 
+#if PLATFORM == PLATFORM_WIN32		// the window's messages, there is no window elsewhere
 	switch (umsg)
 	{
 	case WM_CHAR:
 		{
-			if (Console::Instance()->IsActive())
-			{
-				if (wparam == VK_ESCAPE || wparam == VK_BACK || wparam == VK_RETURN)
-					return;
-
-				Console::Instance()->AddCharacter((const char) wparam);
-			}
+			if (mTextInputHandler)
+				mTextInputHandler((const char) wparam);
 			return;
 		}
 	case WM_KEYDOWN:
@@ -231,6 +227,9 @@ void Input::HandleInputEvent(UINT umsg, WPARAM wparam, LPARAM lparam)
 		mMousePosY   = GET_Y_LPARAM(lparam);
 		return;
 	}
+#else
+	(void)umsg; (void)wparam; (void)lparam;
+#endif
 }
 
 //////////////////////////////////////////////////////////////////////////
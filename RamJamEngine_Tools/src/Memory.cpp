@@ -1,82 +1,380 @@
 #include "Memory.h"
 
+#include <atomic>
+#include <thread>
+#include <string.h>
+#include <stdlib.h>
+
+#if PLATFORM != PLATFORM_WIN32
+// The leak report's console colors: none
+#	define SetConsoleTextAttribute(hstdout, color)
+#endif
+
+// Everything below is plain static data, zero-initialized before any code
+// runs: operator new can come in before the static constructors.
+namespace
+{
+	//////////////////////////////////////////////////////////////////////////
+	struct SpinLock
+	{
+		std::atomic<u32>	mLocked;
+
+		void Lock()
+		{
+			while (mLocked.exchange(1, std::memory_order_acquire))
+			{
+				while (mLocked.load(std::memory_order_relaxed))
+				{
+					std::this_thread::yield();
+				}
+			}
+		}
+		void Unlock()		{ mLocked.store(0, std::memory_order_release); }
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+	// Call sites: open addressing on (file, line), never removed. The file is
+	// published last, lookups don't lock.
+	struct AllocSite
+	{
+		std::atomic<const char*>	mFile;		// nullptr: free slot
+		u32							mLine;
+		std::atomic<u32>			mLiveCount;
+		std::atomic<i64>			mLiveBytes;
+		std::atomic<i64>			mPeakBytes;
+		std::atomic<u64>			mAllocations;
+	};
+
+	enum { MaxSites = 4096 };
+
+	AllocSite	sSites[MaxSites];
+	SpinLock	sSitesLock;
+
+	//------------------------------------------------------------------------
+	// Live allocations: open addressing with linear probing, one table per
+	// stripe so threads hitting different stripes don't contend. The tables
+	// come from malloc, the tracker can't go through operator new.
+	struct AllocEntry
+	{
+		uintptr_t	mAddress;		// 0: free slot
+		size_t		mSize;
+		u32			mSite;
+	};
+
+	struct AllocStripe
+	{
+		AllocEntry*	mEntries;
+		SpinLock	mLock;
+		u32			mCapacity;		// power of two
+		u32			mCount;
+		u8			mPadding[64 - sizeof(AllocEntry*) - sizeof(SpinLock) - 2 * sizeof(u32)];	// a cache line each
+	};
+
+	enum { StripeCount = 64, MinStripeCapacity = 256 };
+
+	AllocStripe	sStripes[StripeCount];
+
+	//////////////////////////////////////////////////////////////////////////
+	inline u64 HashPointer(uintptr_t address)
+	{
+		// Finalizer of MurmurHash3: allocations are aligned and close together
+		u64 h = address;
+		h ^= h >> 33;
+		h *= 0xff51afd7ed558ccdull;
+		h ^= h >> 33;
+		h *= 0xc4ceb9fe1a85ec53ull;
+		h ^= h >> 33;
+		return h;
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	u32 FindSite(const char* file, u32 line)
+	{
+		const u32 mask = MaxSites - 1;
+		const u32 home = static_cast<u32>(HashPointer(reinterpret_cast<uintptr_t>(file) ^ (static_cast<uintptr_t>(line) << 20))) & mask;
+
+		u32 slot = home;
+		do
+		{
+			AllocSite& site = sSites[slot];
+			const char* siteFile = site.mFile.load(std::memory_order_acquire);
+			if (siteFile == nullptr)
+			{
+				sSitesLock.Lock();
+				siteFile = site.mFile.load(std::memory_order_relaxed);
+				if (siteFile == nullptr)
+				{
+					site.mLine = line;
+					site.mFile.store(file, std::memory_order_release);
+					siteFile = file;
+				}
+				sSitesLock.Unlock();
+			}
+			if (siteFile == file && site.mLine == line)
+				return slot;
+
+			slot = (slot + 1) & mask;
+		}
+		while (slot != home);
+
+		// Full: the stats of the new sites end up mixed with another one
+		RJE_ASSERT(false);
+		return home;
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	void Insert(AllocStripe& stripe, const AllocEntry& entry, AllocEntry* previous)
+	{
+		const u32 mask = stripe.mCapacity - 1;
+		for (u32 slot = static_cast<u32>(HashPointer(entry.mAddress) >> 8) & mask; ; slot = (slot + 1) & mask)
+		{
+			AllocEntry& current = stripe.mEntries[slot];
+			if (current.mAddress == 0)
+			{
+				current = entry;
+				++stripe.mCount;
+				return;
+			}
+			if (current.mAddress == entry.mAddress)
+			{
+				// Freed behind the tracker's back (free(), placement new...) and reused
+				*previous = current;
+				current   = entry;
+				return;
+			}
+		}
+	}
+
+	//------------------------------------------------------------------------
+	void Grow(AllocStripe& stripe)
+	{
+		AllocEntry*	oldEntries  = stripe.mEntries;
+		u32			oldCapacity = stripe.mCapacity;
+
+		stripe.mCapacity = oldCapacity ? oldCapacity * 2 : (u32)MinStripeCapacity;
+		stripe.mCount    = 0;
+		stripe.mEntries  = static_cast<AllocEntry*>(calloc(stripe.mCapacity, sizeof(AllocEntry)));
+		RJE_ASSERT(stripe.mEntries);
+
+		AllocEntry unused;
+		for (u32 slot = 0; slot < oldCapacity; ++slot)
+		{
+			if (oldEntries[slot].mAddress)
+				Insert(stripe, oldEntries[slot], &unused);
+		}
+		free(oldEntries);
+	}
+
+	//------------------------------------------------------------------------
+	BOOL Remove(AllocStripe& stripe, uintptr_t address, OUT AllocEntry& removed)
+	{
+		if (stripe.mCount == 0)
+			return false;
+
+		const u32 mask = stripe.mCapacity - 1;
+		u32 hole = static_cast<u32>(HashPointer(address) >> 8) & mask;
+		for (; stripe.mEntries[hole].mAddress != address; hole = (hole + 1) & mask)
+		{
+			if (stripe.mEntries[hole].mAddress == 0)
+				return false;
+		}
+		removed = stripe.mEntries[hole];
+		--stripe.mCount;
+
+		// Backward shift: pull back the entries of the run that can't be reached
+		// any more across the hole, no tombstones
+		for (u32 slot = (hole + 1) & mask; stripe.mEntries[slot].mAddress; slot = (slot + 1) & mask)
+		{
+			u32 home = static_cast<u32>(HashPointer(stripe.mEntries[slot].mAddress) >> 8) & mask;
+			if (((slot - home) & mask) >= ((slot - hole) & mask))
+			{
+				stripe.mEntries[hole] = stripe.mEntries[slot];
+				hole = slot;
+			}
+		}
+		stripe.mEntries[hole].mAddress = 0;
+		return true;
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	void AddToSite(u32 siteIndex, size_t size)
+	{
+		AllocSite& site = sSites[siteIndex];
+		site.mAllocations.fetch_add(1, std::memory_order_relaxed);
+		site.mLiveCount.fetch_add(1, std::memory_order_relaxed);
+
+		i64 live = site.mLiveBytes.fetch_add(static_cast<i64>(size), std::memory_order_relaxed) + static_cast<i64>(size);
+		i64 peak = site.mPeakBytes.load(std::memory_order_relaxed);
+		while (live > peak && !site.mPeakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+		{
+		}
+	}
+
+	//------------------------------------------------------------------------
+	void RemoveFromSite(const AllocEntry& entry)
+	{
+		AllocSite& site = sSites[entry.mSite];
+		site.mLiveCount.fetch_sub(1, std::memory_order_relaxed);
+		site.mLiveBytes.fetch_sub(static_cast<i64>(entry.mSize), std::memory_order_relaxed);
+	}
+
+	//------------------------------------------------------------------------
+	inline AllocStripe& StripeOf(uintptr_t address)
+	{
+		return sStripes[HashPointer(address) & (StripeCount - 1)];
+	}
+}
+
 //////////////////////////////////////////////////////////////////////////
-typedef struct {
-	DWORD	address;
-	DWORD	size;
-	char	file[128];
-	DWORD	line;
-} ALLOC_INFO;
-
-struct free_delete
+void AddTrack(const void* addr, size_t size, const char* file, u32 line)
 {
-	void operator()(void* x) { free(x); }
-};
+	if (!addr)
+		return;
 
-typedef std::list<std::shared_ptr<ALLOC_INFO>> AllocList;
+	AllocEntry entry;
+	entry.mAddress = reinterpret_cast<uintptr_t>(addr);
+	entry.mSize    = size;
+	entry.mSite    = FindSite(file, line);
+	AddToSite(entry.mSite, size);
 
-AllocList	allocList;
+	AllocEntry previous;
+	previous.mAddress = 0;
+
+	AllocStripe& stripe = StripeOf(entry.mAddress);
+	stripe.mLock.Lock();
+	if ((stripe.mCount + 1) * 2 > stripe.mCapacity)
+	{
+		Grow(stripe);
+	}
+	Insert(stripe, entry, &previous);
+	stripe.mLock.Unlock();
+
+	if (previous.mAddress)
+	{
+		RemoveFromSite(previous);
+	}
+}
 
 //////////////////////////////////////////////////////////////////////////
-void AddTrack(DWORD addr, DWORD asize, const char *fname, DWORD lnum)
+void RemoveTrack(const void* addr)
 {
-	std::shared_ptr<ALLOC_INFO> pInfo((ALLOC_INFO*) malloc(sizeof(ALLOC_INFO)), free_delete());
+	if (!addr)
+		return;
 
-	pInfo->address = addr;
-	strncpy_s(pInfo->file, fname, 127);
-	pInfo->line = lnum;
-	pInfo->size = asize;
-	allocList.push_front(pInfo);
-};
+	uintptr_t address = reinterpret_cast<uintptr_t>(addr);
+	AllocEntry removed;
+
+	AllocStripe& stripe = StripeOf(address);
+	stripe.mLock.Lock();
+	BOOL bFound = Remove(stripe, address, removed);
+	stripe.mLock.Unlock();
+
+	if (bFound)
+	{
+		RemoveFromSite(removed);
+	}
+}
 
 //////////////////////////////////////////////////////////////////////////
-void RemoveTrack(DWORD addr)
+void MemorySites(OUT std::vector<MemorySiteStats>& sites)
 {
-	AllocList::iterator i;
+	sites.clear();
+	for (u32 i = 0; i < MaxSites; ++i)
+	{
+		const AllocSite& site = sSites[i];
+		const char* file = site.mFile.load(std::memory_order_acquire);
+		if (!file)
+			continue;
 
-	if(allocList.size() == 0)
-		return;
-	for(i = allocList.begin(); i != allocList.end(); i++)
+		MemorySiteStats stats;
+		stats.mFile        = file;
+		stats.mLine        = site.mLine;
+		stats.mLiveCount   = site.mLiveCount.load(std::memory_order_relaxed);
+		stats.mLiveBytes   = site.mLiveBytes.load(std::memory_order_relaxed);
+		stats.mPeakBytes   = site.mPeakBytes.load(std::memory_order_relaxed);
+		stats.mAllocations = site.mAllocations.load(std::memory_order_relaxed);
+		sites.push_back(stats);
+	}
+
+	// __FILE__ can be the same string at different addresses (one per translation
+	// unit including a header): merge the sites by name
+	std::sort(sites.begin(), sites.end(), [](const MemorySiteStats& a, const MemorySiteStats& b)
 	{
-		if((*i)->address == addr)
+		int order = strcmp(a.mFile, b.mFile);
+		return order != 0 ? order < 0 : a.mLine < b.mLine;
+	});
+	u32 merged = 0;
+	for (u32 i = 0; i < sites.size(); ++i)
+	{
+		if (merged > 0 && sites[merged - 1].mLine == sites[i].mLine && strcmp(sites[merged - 1].mFile, sites[i].mFile) == 0)
+		{
+			MemorySiteStats& site = sites[merged - 1];
+			site.mLiveCount   += sites[i].mLiveCount;
+			site.mLiveBytes   += sites[i].mLiveBytes;
+			site.mPeakBytes   += sites[i].mPeakBytes;
+			site.mAllocations += sites[i].mAllocations;
+		}
+		else
 		{
-			allocList.remove((*i));
-			break;
+			sites[merged++] = sites[i];
 		}
 	}
-};
+	sites.resize(merged);
+
+	std::stable_sort(sites.begin(), sites.end(), [](const MemorySiteStats& a, const MemorySiteStats& b)
+	{
+		return a.mLiveBytes > b.mLiveBytes;
+	});
+}
 
 //////////////////////////////////////////////////////////////////////////
 void MemoryReport()
 {
-	AllocList::iterator i;
-	DWORD totalSize = 0;
+	std::vector<MemorySiteStats> sites;
+	MemorySites(sites);
 
-	if(allocList.empty())
+	u64 totalSize  = 0;
+	u64 totalCount = 0;
+	for (u32 i = 0; i < sites.size(); ++i)
+	{
+		totalSize  += sites[i].mLiveBytes;
+		totalCount += sites[i].mLiveCount;
+	}
+
+	if(totalCount == 0)
 	{
 		std::cout << " No Memory Leaks !" << std::endl;
 		return;
 	}
 
+#if PLATFORM == PLATFORM_WIN32
 	HANDLE hstdout = GetStdHandle( STD_OUTPUT_HANDLE );
 	int White     = 0x07;
 	int LightRed  = 0x0C;
 	int LightBlue = 0x09;
+#endif
 
 	std::cout << "----------------------------------------------------------" << std::endl;
 	SetConsoleTextAttribute(hstdout, LightRed);
 	std::cout << "  Detected Memory Leaks !!" << std::endl;
 	SetConsoleTextAttribute(hstdout, White);
 	std::cout << "----------------------------------------------------------" << std::endl;
-	for(i = allocList.begin(); i != allocList.end(); i++) {
-		std::cout << "FILE :\t\t" <<(*i)->file << "\nLINE :\t\t" << (*i)->line << "\nADDRESS :\t" << (*i)->address << "\n" << (*i)->size << " bytes unfreed" << std::endl;
+	for (u32 i = 0; i < sites.size(); ++i)
+	{
+		const MemorySiteStats& site = sites[i];
+		if (site.mLiveCount == 0)
+			continue;
+
+		std::cout << site.mFile << "(" << site.mLine << ") :\n\t" << site.mLiveBytes << " bytes unfreed in " << site.mLiveCount << " allocation(s)"
+			<< "\n\tpeak " << site.mPeakBytes << " bytes, " << site.mAllocations << " allocation(s) in total" << std::endl;
 		std::cout << "-----------" << std::endl;
-		totalSize += (*i)->size;
 	}
 	std::cout << "----------------------------------------------------------" << std::endl;
 	SetConsoleTextAttribute(hstdout, LightBlue);
-	std::cout << "Total Unfreed: " << totalSize << " bytes" << std::endl;
+	std::cout << "Total Unfreed: " << totalSize << " bytes in " << totalCount << " allocation(s)" << std::endl;
 	SetConsoleTextAttribute(hstdout, White);
+#if PLATFORM == PLATFORM_WIN32
 	RJE_MESSAGE_BOX(NULL, L"Memory Leaks Found !\nCheck the console for details", L"Memory Manager", MB_ICONWARNING | MB_OK);
 	getchar();
+#endif
 };
@@ -0,0 +1,272 @@
+#include "MemoryBudget.h"
+
+#include <algorithm>
+#include <iostream>
+#include <string.h>
+
+MemoryBudget* MemoryBudget::sInstance = nullptr;
+
+//////////////////////////////////////////////////////////////////////////
+const char* MemoryCategoryName(MemoryCategory category)
+{
+	switch (category)
+	{
+	case Memory_Meshes:			return "Meshes";
+	case Memory_Textures:		return "Textures";
+	case Memory_RenderTargets:	return "Render Targets";
+	case Memory_Materials:		return "Materials";
+	case Memory_Scene:			return "Scene";
+	case Memory_Other:			return "Other";
+	default:					return "?";
+	}
+}
+
+//------------------------------------------------------------------------
+static void DefaultWarningHandler(MemoryCategory category, i64 bytes, i64 budget, const char* owner)
+{
+	RJE_PRINT("Memory budget exceeded: %s at %.2f MB of %.2f MB, by %s\n",
+		MemoryCategoryName(category), bytes / (1024.0 * 1024.0), budget / (1024.0 * 1024.0), owner);
+}
+
+//------------------------------------------------------------------------
+static const char* OwnerName(const char* owner)
+{
+	return (owner && owner[0]) ? owner : "(unnamed)";
+}
+
+//------------------------------------------------------------------------
+// FNV-1a
+static u32 HashName(const char* name)
+{
+	u32 hash = 2166136261u;
+	for (; *name; ++name)
+	{
+		hash = (hash ^ (u8)*name) * 16777619u;
+	}
+	return hash;
+}
+
+//////////////////////////////////////////////////////////////////////////
+MemoryBudget::MemoryBudget()
+	: mWarningHandler(DefaultWarningHandler)
+{
+	Reset();
+}
+
+//////////////////////////////////////////////////////////////////////////
+void MemoryBudget::Reset()
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	for (u32 i = 0; i < Memory_CategoryCount; ++i)
+	{
+		memset(&mCategories[i].mStats, 0, sizeof(MemoryCategoryStats));
+		mCategories[i].mConsumers.clear();
+		mCategories[i].mHashes.clear();
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+void MemoryBudget::SetBudget(MemoryCategory category, i64 bytes)
+{
+	RJE_ASSERT(category < Memory_CategoryCount);
+	std::lock_guard<std::mutex> lock(mMutex);
+	mCategories[category].mStats.mBudget = bytes > 0 ? bytes : 0;
+}
+
+//------------------------------------------------------------------------
+void MemoryBudget::SetWarningHandler(WarningHandler handler)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	mWarningHandler = handler ? handler : DefaultWarningHandler;
+}
+
+//////////////////////////////////////////////////////////////////////////
+MemoryConsumer* MemoryBudget::FindConsumer(Category& category, const char* owner, u32 hash)
+{
+	// Resources come and go at load time, a linear search on the hashes is enough
+	for (u32 i = 0; i < category.mHashes.size(); ++i)
+	{
+		if (category.mHashes[i] == hash && category.mConsumers[i].mName == owner)
+			return &category.mConsumers[i];
+	}
+	return nullptr;
+}
+
+//------------------------------------------------------------------------
+void MemoryBudget::RemoveLocked(Category& category, MemoryConsumer* consumer, i64 bytes, u32 resources)
+{
+	MemoryCategoryStats& stats = category.mStats;
+	stats.mBytes     -= bytes;
+	stats.mResources -= resources < stats.mResources ? resources : stats.mResources;
+	RJE_ASSERT(stats.mBytes >= 0);
+
+	consumer->mBytes     -= bytes;
+	consumer->mResources -= resources < consumer->mResources ? resources : consumer->mResources;
+	if (consumer->mBytes <= 0 && consumer->mResources == 0)
+	{
+		size_t index = consumer - &category.mConsumers[0];
+		category.mConsumers.erase(category.mConsumers.begin() + index);
+		category.mHashes.erase(category.mHashes.begin() + index);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+void MemoryBudget::Add(MemoryCategory category, const char* owner, i64 bytes)
+{
+	RJE_ASSERT(category < Memory_CategoryCount && bytes >= 0);
+	owner = OwnerName(owner);
+	u32 hash = HashName(owner);
+
+	WarningHandler handler = nullptr;
+	i64 total  = 0;
+	i64 budget = 0;
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		Category& cat = mCategories[category];
+
+		MemoryConsumer* consumer = FindConsumer(cat, owner, hash);
+		if (!consumer)
+		{
+			MemoryConsumer newConsumer;
+			newConsumer.mName      = owner;
+			newConsumer.mBytes     = 0;
+			newConsumer.mResources = 0;
+			cat.mConsumers.push_back(newConsumer);
+			cat.mHashes.push_back(hash);
+			consumer = &cat.mConsumers.back();
+		}
+		consumer->mBytes += bytes;
+		++consumer->mResources;
+
+		MemoryCategoryStats& stats = cat.mStats;
+		i64 before = stats.mBytes;
+		stats.mBytes += bytes;
+		++stats.mResources;
+		if (stats.mBytes > stats.mPeakBytes)
+			stats.mPeakBytes = stats.mBytes;
+
+		// Warns on the way over only, not on every resource above the line
+		if (stats.mBudget > 0 && before <= stats.mBudget && stats.mBytes > stats.mBudget)
+		{
+			++stats.mWarnings;
+			handler = mWarningHandler;
+			total   = stats.mBytes;
+			budget  = stats.mBudget;
+		}
+	}
+
+	// Out of the lock: the handler may ask for the stats
+	if (handler)
+		handler(category, total, budget, owner);
+}
+
+//------------------------------------------------------------------------
+void MemoryBudget::Remove(MemoryCategory category, const char* owner, i64 bytes)
+{
+	RJE_ASSERT(category < Memory_CategoryCount && bytes >= 0);
+	owner = OwnerName(owner);
+	u32 hash = HashName(owner);
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	Category& cat = mCategories[category];
+
+	MemoryConsumer* consumer = FindConsumer(cat, owner, hash);
+	RJE_ASSERT(consumer && consumer->mBytes >= bytes);	// removed more than was added
+	if (consumer)
+	{
+		RemoveLocked(cat, consumer, bytes < consumer->mBytes ? bytes : consumer->mBytes, 1);
+	}
+}
+
+//------------------------------------------------------------------------
+i64 MemoryBudget::Release(MemoryCategory category, const char* owner)
+{
+	RJE_ASSERT(category < Memory_CategoryCount);
+	owner = OwnerName(owner);
+	u32 hash = HashName(owner);
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	Category& cat = mCategories[category];
+
+	MemoryConsumer* consumer = FindConsumer(cat, owner, hash);
+	if (!consumer)
+		return 0;
+
+	i64 bytes = consumer->mBytes;
+	RemoveLocked(cat, consumer, bytes, consumer->mResources);
+	return bytes;
+}
+
+//////////////////////////////////////////////////////////////////////////
+MemoryCategoryStats MemoryBudget::Stats(MemoryCategory category) const
+{
+	RJE_ASSERT(category < Memory_CategoryCount);
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mCategories[category].mStats;
+}
+
+//------------------------------------------------------------------------
+i64 MemoryBudget::TotalBytes() const
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	i64 total = 0;
+	for (u32 i = 0; i < Memory_CategoryCount; ++i)
+	{
+		total += mCategories[i].mStats.mBytes;
+	}
+	return total;
+}
+
+//------------------------------------------------------------------------
+BOOL MemoryBudget::IsOverBudget(MemoryCategory category) const
+{
+	MemoryCategoryStats stats = Stats(category);
+	return stats.mBudget > 0 && stats.mBytes > stats.mBudget;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void MemoryBudget::TopConsumers(MemoryCategory category, u32 count, OUT std::vector<MemoryConsumer>& consumers) const
+{
+	RJE_ASSERT(category < Memory_CategoryCount);
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		consumers = mCategories[category].mConsumers;
+	}
+
+	std::sort(consumers.begin(), consumers.end(),
+		[](const MemoryConsumer& a, const MemoryConsumer& b) { return a.mBytes > b.mBytes; });
+	if (consumers.size() > count)
+		consumers.resize(count);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void MemoryBudget::Print(u32 topCount) const
+{
+	std::vector<MemoryConsumer> consumers;
+	char buf[256];
+
+	std::cout << "----------------------------------------------------------" << std::endl;
+	std::cout << "  Memory by category, current / peak / budget" << std::endl;
+	std::cout << "----------------------------------------------------------" << std::endl;
+	for (u32 i = 0; i < Memory_CategoryCount; ++i)
+	{
+		MemoryCategory category = (MemoryCategory)i;
+		MemoryCategoryStats stats = Stats(category);
+		if (stats.mBudget > 0)
+			sprintf_s(buf, "%-16s %9.2f / %9.2f / %9.2f MB%s", MemoryCategoryName(category),
+				stats.mBytes / (1024.0 * 1024.0), stats.mPeakBytes / (1024.0 * 1024.0), stats.mBudget / (1024.0 * 1024.0),
+				stats.mBytes > stats.mBudget ? "  OVER" : "");
+		else
+			sprintf_s(buf, "%-16s %9.2f / %9.2f MB, no budget", MemoryCategoryName(category),
+				stats.mBytes / (1024.0 * 1024.0), stats.mPeakBytes / (1024.0 * 1024.0));
+		std::cout << buf << std::endl;
+
+		TopConsumers(category, topCount, consumers);
+		for (u32 c = 0; c < consumers.size(); ++c)
+		{
+			sprintf_s(buf, "\t%9.2f MB in %u: %s", consumers[c].mBytes / (1024.0 * 1024.0), consumers[c].mResources, consumers[c].mName.c_str());
+			std::cout << buf << std::endl;
+		}
+	}
+	std::cout << "----------------------------------------------------------" << std::endl;
+}
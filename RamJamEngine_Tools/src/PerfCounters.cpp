@@ -0,0 +1,159 @@
+#include "PerfCounters.h"
+#include "Debug.h"
+
+#if RJE_PERF_COUNTERS
+#	include <linux/perf_event.h>
+#	include <sys/ioctl.h>
+#	include <sys/syscall.h>
+#	include <unistd.h>
+#	include <string.h>
+#endif
+
+//////////////////////////////////////////////////////////////////////////
+const char* PerfCounterName(PerfCounter counter)
+{
+	switch (counter)
+	{
+	case PerfCounter_Cycles:		return "cycles";
+	case PerfCounter_Instructions:	return "instructions";
+	case PerfCounter_L1DMisses:		return "l1d_misses";
+	case PerfCounter_LLCMisses:		return "llc_misses";
+	case PerfCounter_BranchMisses:	return "branch_misses";
+	default:						return "?";
+	}
+}
+
+#if RJE_PERF_COUNTERS
+// The calling thread's group: its leader, -1 not opened yet, -2 none
+static RJE_THREAD_LOCAL int	tLeader = -1;
+static RJE_THREAD_LOCAL int	tFds[PerfCounter_Count];
+static RJE_THREAD_LOCAL u32	tSlots[PerfCounter_Count];		// in the group's read
+static RJE_THREAD_LOCAL u32	tAvailable = 0;
+
+// Closes the group when its thread exits. Only OpenThread() touches it, so
+// the threads that never read a counter don't register a destructor, and
+// Read() stays on the plain thread locals above.
+struct ThreadGroupCloser
+{
+	BOOL	mbArmed;
+	~ThreadGroupCloser()	{ if (mbArmed) PerfCounters::CloseThread(); }
+};
+static thread_local ThreadGroupCloser	tCloser;
+
+//////////////////////////////////////////////////////////////////////////
+static void Describe(PerfCounter counter, OUT perf_event_attr& attr)
+{
+	memset(&attr, 0, sizeof(attr));
+	attr.size           = sizeof(attr);
+	attr.type           = PERF_TYPE_HARDWARE;
+	attr.read_format    = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+	attr.exclude_kernel = 1;
+	attr.exclude_hv     = 1;
+
+	switch (counter)
+	{
+	case PerfCounter_Cycles:		attr.config = PERF_COUNT_HW_CPU_CYCLES;		break;
+	case PerfCounter_Instructions:	attr.config = PERF_COUNT_HW_INSTRUCTIONS;	break;
+	case PerfCounter_LLCMisses:		attr.config = PERF_COUNT_HW_CACHE_MISSES;	break;
+	case PerfCounter_BranchMisses:	attr.config = PERF_COUNT_HW_BRANCH_MISSES;	break;
+	case PerfCounter_L1DMisses:
+		attr.type   = PERF_TYPE_HW_CACHE;
+		attr.config = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+		break;
+	default:
+		break;
+	}
+}
+
+//------------------------------------------------------------------------
+// The first counter that opens leads the group, the group starts once whole
+static void OpenThread()
+{
+	tLeader    = -2;
+	tAvailable = 0;
+	u32 slot   = 0;
+	for (u32 i = 0; i < PerfCounter_Count; ++i)
+	{
+		perf_event_attr attr;
+		Describe((PerfCounter)i, attr);
+		attr.disabled = tLeader < 0 ? 1 : 0;
+
+		tFds[i] = (int)syscall(SYS_perf_event_open, &attr, 0, -1, tLeader < 0 ? -1 : tLeader, 0);
+		if (tFds[i] < 0)
+			continue;
+
+		if (tLeader < 0)
+			tLeader = tFds[i];
+		tSlots[i]   = slot++;
+		tAvailable |= 1 << i;
+	}
+
+	if (tLeader >= 0)
+	{
+		ioctl(tLeader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+		tCloser.mbArmed = true;
+	}
+}
+#endif
+
+//////////////////////////////////////////////////////////////////////////
+BOOL PerfCounters::Read(OUT PerfCounterValues& values)
+{
+#if RJE_PERF_COUNTERS
+	if (tLeader == -1)
+		OpenThread();
+	if (tLeader < 0)
+		return false;
+
+	// The count of counters, the times the group was enabled and on the PMU,
+	// then the values
+	u64 group[3 + PerfCounter_Count];
+	if (read(tLeader, group, sizeof(group)) < (ssize_t)(3 * sizeof(u64)))
+		return false;
+
+	// Never scheduled: a PMU with fewer counters than the group (some VMs),
+	// or taken by another group. Scaled up when it had to share the PMU.
+	u64 enabled = group[1], running = group[2];
+	if (running == 0)
+		return false;
+
+	for (u32 i = 0; i < PerfCounter_Count; ++i)
+	{
+		u64 value = (tAvailable & (1 << i)) && tSlots[i] < group[0] ? group[3 + tSlots[i]] : 0;
+		values.mValues[i] = running < enabled ? (u64)((f64)value * enabled / running) : value;
+	}
+	return true;
+#else
+	(void)values;
+	return false;
+#endif
+}
+
+//------------------------------------------------------------------------
+u32 PerfCounters::Available()
+{
+#if RJE_PERF_COUNTERS
+	if (tLeader == -1)
+		OpenThread();
+	return tAvailable;
+#else
+	return 0;
+#endif
+}
+
+//------------------------------------------------------------------------
+void PerfCounters::CloseThread()
+{
+#if RJE_PERF_COUNTERS
+	if (tLeader >= 0)
+	{
+		for (u32 i = 0; i < PerfCounter_Count; ++i)
+		{
+			if (tAvailable & (1 << i))
+				close(tFds[i]);
+		}
+	}
+	tLeader    = -1;
+	tAvailable = 0;
+#endif
+}
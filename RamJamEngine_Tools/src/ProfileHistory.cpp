@@ -0,0 +1,139 @@
+#include "ProfileHistory.h"
+#include "Debug.h"
+
+//////////////////////////////////////////////////////////////////////////
+ProfileHistory::ProfileHistory()
+	: mFrameMs(FrameCount, 0.0f)
+{
+	Reset();
+}
+
+//////////////////////////////////////////////////////////////////////////
+void ProfileHistory::Reset()
+{
+	std::fill(mFrameMs.begin(), mFrameMs.end(), 0.0f);
+	mScopeMs.clear();
+	mNext  = 0;
+	mCount = 0;
+	mTotal = 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void ProfileHistory::AddFrame(f32 frameMs, const std::vector<f32>& scopeMs)
+{
+	if (mScopeMs.size() < scopeMs.size())
+		mScopeMs.resize(scopeMs.size());
+
+	mFrameMs[mNext] = frameMs;
+	for (u32 scope = 0; scope < mScopeMs.size(); ++scope)
+	{
+		f32 ms = scope < scopeMs.size() ? scopeMs[scope] : 0.0f;
+		std::vector<f32>& ring = mScopeMs[scope];
+		if (ring.empty())
+		{
+			if (ms == 0.0f)
+				continue;
+			ring.resize(FrameCount, 0.0f);
+		}
+		ring[mNext] = ms;
+	}
+
+	mNext  = (mNext + 1) % FrameCount;
+	mCount = mCount < FrameCount ? mCount + 1 : (u32)FrameCount;
+	++mTotal;
+}
+
+//////////////////////////////////////////////////////////////////////////
+ProfilePercentiles ProfileHistory::Percentiles(f32* samples, u32 count)
+{
+	ProfilePercentiles result = { 0.0f, 0.0f, 0.0f, 0.0f };
+	if (count == 0)
+		return result;
+
+	// Rank ceil(p*count), from 1
+	std::sort(samples, samples + count);
+	result.mP50 = samples[(count * 50 + 99) / 100 - 1];
+	result.mP95 = samples[(count * 95 + 99) / 100 - 1];
+	result.mP99 = samples[(count * 99 + 99) / 100 - 1];
+	result.mMax = samples[count - 1];
+	return result;
+}
+
+//////////////////////////////////////////////////////////////////////////
+ProfilePercentiles ProfileHistory::Percentiles(const std::vector<f32>& ring) const
+{
+	// The recorded part of the ring, in any order
+	f32 samples[FrameCount];
+	u32 first = (mNext + FrameCount - mCount) % FrameCount;
+	for (u32 i = 0; i < mCount; ++i)
+		samples[i] = ring.empty() ? 0.0f : ring[(first + i) % FrameCount];
+	return Percentiles(samples, mCount);
+}
+
+//////////////////////////////////////////////////////////////////////////
+ProfilePercentiles ProfileHistory::FramePercentiles() const
+{
+	return Percentiles(mFrameMs);
+}
+
+//////////////////////////////////////////////////////////////////////////
+ProfilePercentiles ProfileHistory::ScopePercentiles(u32 scope) const
+{
+	static const std::vector<f32> sNeverRan;
+	return Percentiles(scope < mScopeMs.size() ? mScopeMs[scope] : sNeverRan);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// RFC 4180: a field holding a comma, a quote or a line break is quoted, its
+// quotes doubled
+static void WriteCsvField(FILE* file, const char* text)
+{
+	if (!strpbrk(text, ",\"\r\n"))
+	{
+		fputs(text, file);
+		return;
+	}
+
+	fputc('"', file);
+	for (; *text; ++text)
+	{
+		if (*text == '"')
+			fputc('"', file);
+		fputc(*text, file);
+	}
+	fputc('"', file);
+}
+
+//------------------------------------------------------------------------
+BOOL ProfileHistory::WriteCsv(const char* path, const char* (*scopeName)(u32)) const
+{
+	FILE* file = fopen(path, "w");
+	if (!file)
+		return false;
+
+	fprintf(file, "frame,frame_ms");
+	for (u32 scope = 0; scope < mScopeMs.size(); ++scope)
+	{
+		if (!mScopeMs[scope].empty())
+		{
+			fputc(',', file);
+			WriteCsvField(file, scopeName(scope));
+		}
+	}
+	fprintf(file, "\n");
+
+	u32 first = (mNext + FrameCount - mCount) % FrameCount;
+	for (u32 i = 0; i < mCount; ++i)
+	{
+		u32 slot = (first + i) % FrameCount;
+		fprintf(file, "%llu,%.4f", mTotal - mCount + i, mFrameMs[slot]);
+		for (u32 scope = 0; scope < mScopeMs.size(); ++scope)
+		{
+			if (!mScopeMs[scope].empty())
+				fprintf(file, ",%.4f", mScopeMs[scope][slot]);
+		}
+		fprintf(file, "\n");
+	}
+	fclose(file);
+	return true;
+}
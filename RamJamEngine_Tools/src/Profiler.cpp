@@ -3,42 +3,143 @@
 #include "Debug.h"
 #include "Input.h"
 #include "Timer.h"
+#include "MemoryBudget.h"
 
 Profiler* Profiler::sInstance = nullptr;
+std::atomic<u32> Profiler::sHardwareCounters(0);
+
+// Scope IDs outlive the profiler: they are cached in the PROFILE_CPU statics
+static std::mutex	sScopesMutex;
+static const char*	sScopeNames[PROFILE_MAX_SCOPES] = { "Thread" };	// 0: a thread's root
+static u32			sScopeCount = 1;
+
+//------------------------------------------------------------------------
+// Everything else zeroed, counters included
+static ProfileNode NewNode(u32 scope, i32 parent)
+{
+	ProfileNode node;
+	ZeroMemory(&node, sizeof(node));
+	node.mScope       = scope;
+	node.mParent      = parent;
+	node.mFirstChild  = -1;
+	node.mNextSibling = -1;
+	return node;
+}
+
+static ProfileCaptureEvent NewCaptureEvent(u64 start, u64 end, u32 scope, u32 track)
+{
+	ProfileCaptureEvent e;
+	ZeroMemory(&e, sizeof(e));
+	e.mStart = start;
+	e.mEnd   = end;
+	e.mScope = scope;
+	e.mTrack = track;
+	return e;
+}
+
+// A new profiler gets new buffers: the threads' cached ones are stale
+static u32									sGeneration = 0;
+static RJE_THREAD_LOCAL ProfileThreadBuffer*	tThreadBuffer     = nullptr;
+static RJE_THREAD_LOCAL u32					tThreadGeneration = 0;
+
+//////////////////////////////////////////////////////////////////////////
+ProfileThreadBuffer::ProfileThreadBuffer(const char* name)
+	: mWrite(0), mRead(0), mDropped(0)
+{
+	size_t length = strlen(name);
+	if (length >= sizeof(mName))
+		length = sizeof(mName) - 1;
+	memcpy(mName, name, length);
+	mName[length] = nullchar;
+#if RJE_PERF_COUNTERS
+	mCounterSamples.store(nullptr, std::memory_order_relaxed);
+#endif
+}
+
+//------------------------------------------------------------------------
+ProfileThreadBuffer::~ProfileThreadBuffer()
+{
+#if RJE_PERF_COUNTERS
+	ProfileCounterSample* samples = mCounterSamples.load(std::memory_order_relaxed);
+	RJE_SAFE_DELETE_PTR(samples);
+#endif
+}
+
+#if RJE_PERF_COUNTERS
+//////////////////////////////////////////////////////////////////////////
+// On the buffer's thread, before mWrite publishes the event
+void ProfileThreadBuffer::PushCounters(u32 sequence, const PerfCounterValues& counters)
+{
+	ProfileCounterSample* samples = mCounterSamples.load(std::memory_order_relaxed);
+	if (!samples)
+	{
+		samples = rje_new ProfileCounterSample[Capacity];
+		// Slot i never sees the sequence i + 1: no sample yet
+		for (u32 i = 0; i < Capacity; ++i)
+			samples[i].mSequence = i + 1;
+		mCounterSamples.store(samples, std::memory_order_release);
+	}
+
+	ProfileCounterSample& sample = samples[sequence & Mask];
+	sample.mCounters = counters;
+	sample.mSequence = sequence;
+}
+
+//------------------------------------------------------------------------
+// Per call averages of the calls that read the counters
+static void FormatCounters(OUT char (&buf)[192], const u64* counters, u32 calls)
+{
+	f64 perCall = calls > 0 ? 1.0 / calls : 0.0;
+	sprintf_s(buf, "IPC %.2f, per call: %.0f cycles, %.0f instructions, %.1f L1D misses, %.1f LLC misses, %.1f branch misses",
+		counters[PerfCounter_Cycles] ? (f64)counters[PerfCounter_Instructions] / counters[PerfCounter_Cycles] : 0.0,
+		counters[PerfCounter_Cycles] * perCall, counters[PerfCounter_Instructions] * perCall,
+		counters[PerfCounter_L1DMisses] * perCall, counters[PerfCounter_LLCMisses] * perCall, counters[PerfCounter_BranchMisses] * perCall);
+}
+#endif
+
+//////////////////////////////////////////////////////////////////////////
+ProfileThreadBuffer* ProfileThreadBuffer::Current()
+{
+	if (tThreadGeneration != sGeneration)
+	{
+		tThreadBuffer     = Profiler::Instance()->AddThread(nullptr);
+		tThreadGeneration = sGeneration;
+	}
+	return tThreadBuffer;
+}
 
 //////////////////////////////////////////////////////////////////////////
 Profiler::~Profiler()
 { 
-	RJE_SAFE_DELETE(mProfileInfoString);
+	RJE_SAFE_DELETE_PTR(mProfileInfoString);
 	RJE_SAFE_DELETE(mProfilerInfos);
+	for (ProfileThread& thread : threads)
+	{
+		RJE_SAFE_DELETE(thread.mBuffer);
+	}
 }
 
 //////////////////////////////////////////////////////////////////////////
 Profiler::Profiler()
 {
-	numProfiles   = 1;
-	currentParent = 0;
 	totalFrames   = 0;
+	captureFramesLeft = 0;
+	spikeThresholdMs  = 0.0f;
+	spikeCount        = 0;
 
 	mIsActive     = false;
 	mCurrentState = E_NONE;
 
-	LARGE_INTEGER frequencyCount;
-	QueryPerformanceFrequency(&frequencyCount);
-	countsPerMs = double(frequencyCount.QuadPart)/1000;
+	// Calibrates the clock on the first call
+	countsPerMs = Clock::Frequency() / 1000.0;
 
 	mProfileInfoString	 = rje_new char[PROFILE_INFO_MAX_LENGTH];
 	mProfilerInfos		 = rje_new ProfilerInfos;
+	ZeroMemory(mProfilerInfos, sizeof(ProfilerInfos));
 	mProfilerRefreshRate = -1.0f;
 	ResetProfilerInfo();
 
-	Profile fs;
-	fs.totalCalls = 0;
-	fs.name       = "Frame";
-	fs.Id         = 0;
-	fs.parentId   = -1;
-	fs.totalTime  = 0;
-	profiles.push_back(fs);
+	++sGeneration;
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -100,90 +201,462 @@ void Profiler::ChangeState()
 }
 
 //////////////////////////////////////////////////////////////////////////
-void Profiler::PrintChildren(std::ofstream &fout, int parent, int depth)
+void Profiler::PrintChildren(std::ofstream &fout, const ProfileThread& thread, int parent, int depth)
 {
-	for(int i = 1; i < numProfiles; ++i)
+	const std::vector<ProfileNode>& nodes = thread.mNodes;
+	for(int i = nodes[parent].mFirstChild; i >= 0; i = nodes[i].mNextSibling)
 	{
-		if(profiles[i].parentId == parent)
+		if (nodes[i].mTotalCalls == 0)
+			continue;
+
+		// Name and ID
+		for(int tabs = 0; tabs < depth; ++tabs)	{fout << "    ";}
+		fout << "|-" << ScopeName(nodes[i].mScope) << " (ID: " << nodes[i].mScope << ")\n    ";
+
+		// Parent's ID
+		for(int tabs = 0; tabs < depth; ++tabs)	{fout << "    ";}
+		fout << "Parent: " << ScopeName(nodes[parent].mScope) << " (ID : " << nodes[parent].mScope << ")\n    ";
+
+		// Total Time in Counts
+		for(int tabs = 0; tabs < depth; ++tabs)	{fout << "    ";}
+		fout << "Raw Time (Counts): " << nodes[i].mTotalTicks << "\n    ";
+
+		// Total Calls
+		for(int tabs = 0; tabs < depth; ++tabs)	{fout << "    ";}
+		fout << "Total Calls: " << nodes[i].mTotalCalls << "\n    ";
+
+		// Average Calls Per Parent
+		if (parent != 0)
 		{
-			// Name and ID
 			for(int tabs = 0; tabs < depth; ++tabs)	{fout << "    ";}
-			fout << "|-" << profiles[i].name << " (ID: " << profiles[i].Id << ")\n    ";
+			fout << "Avg. Calls/Parent: " << (float)nodes[i].mTotalCalls/nodes[parent].mTotalCalls << "\n    ";
+		}
 
-			// Parent's ID
-			for(int tabs = 0; tabs < depth; ++tabs)	{fout << "    ";}
-			fout << "Parent: " << profiles[profiles[i].parentId].name << " (ID : " << profiles[i].parentId << ")\n    ";
+		// Average Time Per Call
+		for(int tabs = 0; tabs < depth; ++tabs)	{fout << "    ";}
+		fout << "Avg. Time/Call (Ms): " << (nodes[i].mTotalTicks/nodes[i].mTotalCalls)/countsPerMs << "\n    ";
 
-			// Total Time in Counts
+#if RJE_PERF_COUNTERS
+		// Hardware counters
+		if (nodes[i].mTotalCounted > 0)
+		{
+			char counters[192];
+			FormatCounters(counters, nodes[i].mTotalCounters, nodes[i].mTotalCounted);
 			for(int tabs = 0; tabs < depth; ++tabs)	{fout << "    ";}
-			fout << "Raw Time (Counts): " << profiles[i].totalTime << "\n    ";
+			fout << "Counters (" << nodes[i].mTotalCounted << " calls): " << counters << "\n    ";
+		}
+#endif
 
-			// Total Calls
+		// Percent of Parent's Total Time
+		if (parent != 0)
+		{
 			for(int tabs = 0; tabs < depth; ++tabs)	{fout << "    ";}
-			fout << "Total Calls: " << profiles[i].totalCalls << "\n    ";
+			fout << "% of Parent Time: %" << (float)nodes[i].mTotalTicks/nodes[parent].mTotalTicks*100.0f << "\n    ";
+		}
 
-			// Average Calls Per Parent
-			for(int tabs = 0; tabs < depth; ++tabs)	{fout << "    ";}
-			fout << "Avg. Calls/Parent: " << (float)profiles[i].totalCalls/profiles[profiles[i].parentId].totalCalls << "\n    ";
+		fout << "\n\n";
 
-			// Average Time Per Call
-			for(int tabs = 0; tabs < depth; ++tabs)	{fout << "    ";}
-			fout << "Avg. Time/Call (Ms): " << (profiles[i].totalTime/profiles[i].totalCalls)/countsPerMs << "\n    ";
+		PrintChildren(fout, thread, i, depth+1);
+	}
+}
 
-			// Percent of Parent's Total Time
-			for(int tabs = 0; tabs < depth; ++tabs)	{fout << "    ";}
-			fout << "% of Parent Time: %" << (float)profiles[i].totalTime/profiles[profiles[i].parentId].totalTime*100.0f << "\n    ";
+//////////////////////////////////////////////////////////////////////////
+u32 Profiler::RegisterScope(ProfileScope& scope)
+{
+	std::lock_guard<std::mutex> lock(sScopesMutex);
 
-			fout << "\n\n";
+	// Another thread may have been first, and sites sharing a name share an ID
+	u32 registered = scope.mId.load(std::memory_order_relaxed);
+	if (registered == 0)
+	{
+		u32 id = 1;
+		while (id < sScopeCount && strcmp(sScopeNames[id], scope.mName) != 0)
+			++id;
 
-			PrintChildren(fout, i, depth);
+		if (id == sScopeCount)
+		{
+			RJE_ASSERT(sScopeCount < PROFILE_MAX_SCOPES);
+			if (sScopeCount < PROFILE_MAX_SCOPES)
+				sScopeNames[sScopeCount++] = scope.mName;
+			else
+				id = PROFILE_MAX_SCOPES - 1;
 		}
+		scope.mId.store(id, std::memory_order_release);
+		registered = id;
 	}
+	return registered;
+}
+
+//////////////////////////////////////////////////////////////////////////
+const char* Profiler::ScopeName(u32 id)
+{
+	// Registered names are never moved nor removed
+	return id < PROFILE_MAX_SCOPES && sScopeNames[id] ? sScopeNames[id] : "?";
 }
 
 //////////////////////////////////////////////////////////////////////////
-void Profiler::ProfileStart(const char* name)
+ProfileThreadBuffer* Profiler::AddThread(const char* name)
 {
-	if(strcmp(name, "Frame") == 0)
+	std::lock_guard<std::mutex> lock(threadsMutex);
+
+	char defaultName[32];
+	sprintf_s(defaultName, "Thread %u", (u32)threads.size());
+
+	ProfileThread thread;
+	thread.mBuffer = rje_new ProfileThreadBuffer(name ? name : defaultName);
+	thread.mNodes.push_back(NewNode(0, -1));
+	threads.push_back(thread);
+	return thread.mBuffer;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void Profiler::SetThreadName(const char* name)
+{
+	ProfileThreadBuffer* buffer = ProfileThreadBuffer::Current();
+
+	std::lock_guard<std::mutex> lock(threadsMutex);
+	strncpy(buffer->mName, name, sizeof(buffer->mName) - 1);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void Profiler::CollectFrame()
+{
+	std::lock_guard<std::mutex> lock(threadsMutex);
+
+	++totalFrames;
+	for (u32 i = 0; i < threads.size(); ++i)
 	{
-		totalFrames++;
-		profiles[0].Id       = 0;
-		profiles[0].parentId = currentParent;
-		currentParent        = 0;
+		CollectThread(threads[i], i);
 	}
-	else
+	RecordHistory();
+
+	if (captureFramesLeft > 0 && --captureFramesLeft == 0)
+	{
+		WriteCapture(capturePath.c_str());
+		captureEvents.clear();
+		captureGpuNames.clear();
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// threadsMutex held
+void Profiler::RecordHistory()
+{
+	u64 frameTicks = 0;
+	if (!threads.empty())
 	{
-		bool profileExists = false;
-		for(int i = 0; i < numProfiles; ++i)
+		const std::vector<ProfileNode>& nodes = threads[0].mNodes;
+		for (i32 i = nodes[0].mFirstChild; i >= 0; i = nodes[i].mNextSibling)
+			frameTicks += nodes[i].mFrameTicks;
+	}
+	f32 frameMs = (f32)(frameTicks / countsPerMs);
+
+	frameScopeMs.assign(sScopeCount, 0.0f);
+	for (const ProfileThread& thread : threads)
+	{
+		for (u32 i = 1; i < thread.mNodes.size(); ++i)
 		{
-			if(profiles[i].name == name)
-			{
-				profiles[i].Id       = i;
-				profiles[i].parentId = currentParent;
-				currentParent        = i;
-				profileExists        = true;
-			}
+			const ProfileNode& node = thread.mNodes[i];
+			if (node.mFrameCalls > 0 && node.mScope < frameScopeMs.size())
+				frameScopeMs[node.mScope] += (f32)(node.mFrameTicks / countsPerMs);
+		}
+	}
+	history.AddFrame(frameMs, frameScopeMs);
+
+	if (spikeThresholdMs > 0.0f && frameMs > spikeThresholdMs)
+	{
+		++spikeCount;
+		WriteSpike(frameMs);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+void Profiler::SetSpikeCapture(f32 thresholdMs, const char* path)
+{
+	std::lock_guard<std::mutex> lock(threadsMutex);
+
+	if (thresholdMs > 0.0f)
+		std::remove(path);
+	spikeThresholdMs = thresholdMs;
+	spikePath        = path;
+	spikeCount       = 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// The call trees of the frame just collected. threadsMutex held.
+void Profiler::WriteSpike(f32 frameMs)
+{
+	FILE* file = fopen(spikePath.c_str(), "a");
+	if (!file)
+		return;
+
+	fprintf(file, "== Frame %llu: %.3f ms, over %.3f ms\n", history.FramesTotal() - 1, frameMs, spikeThresholdMs);
+	for (const ProfileThread& thread : threads)
+	{
+		fprintf(file, "%s\n", thread.mBuffer->mName);
+		PrintFrameChildren(file, thread, 0, 1);
+	}
+	fprintf(file, "\n");
+	fclose(file);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void Profiler::PrintFrameChildren(FILE* file, const ProfileThread& thread, int parent, int depth)
+{
+	const std::vector<ProfileNode>& nodes = thread.mNodes;
+	for (int i = nodes[parent].mFirstChild; i >= 0; i = nodes[i].mNextSibling)
+	{
+		if (nodes[i].mFrameCalls == 0)
+			continue;
+
+		fprintf(file, "%*s%s: %.3f ms (%u calls)\n", depth*4, "", ScopeName(nodes[i].mScope), nodes[i].mFrameTicks / countsPerMs, nodes[i].mFrameCalls);
+#if RJE_PERF_COUNTERS
+		if (nodes[i].mFrameCounted > 0)
+		{
+			char counters[192];
+			FormatCounters(counters, nodes[i].mFrameCounters, nodes[i].mFrameCounted);
+			fprintf(file, "%*s  %s\n", depth*4, "", counters);
 		}
-		if(!profileExists)
+#endif
+		PrintFrameChildren(file, thread, i, depth+1);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+BOOL Profiler::SetHardwareCounters(BOOL bEnable)
+{
+	BOOL bAvailable = PerfCounters::Available() != 0;
+	sHardwareCounters.store(bEnable && bAvailable ? 1 : 0, std::memory_order_relaxed);
+	return bAvailable;
+}
+
+#if RJE_PERF_COUNTERS
+//------------------------------------------------------------------------
+u32 Profiler::FrameCounters(u32 scope, OUT PerfCounterValues& counters)
+{
+	std::lock_guard<std::mutex> lock(threadsMutex);
+
+	u32 calls = 0;
+	memset(&counters, 0, sizeof(counters));
+	for (const ProfileThread& thread : threads)
+	{
+		for (const ProfileNode& node : thread.mNodes)
+		{
+			if (node.mScope != scope || node.mFrameCounted == 0)
+				continue;
+			calls += node.mFrameCounted;
+			for (u32 c = 0; c < PerfCounter_Count; ++c)
+				counters.mValues[c] += node.mFrameCounters[c];
+		}
+	}
+	return calls;
+}
+#endif
+
+//////////////////////////////////////////////////////////////////////////
+BOOL Profiler::WriteHistoryCsv(const char* path)
+{
+	std::lock_guard<std::mutex> lock(threadsMutex);
+	return history.WriteCsv(path, ScopeName);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void Profiler::BeginCapture(u32 frameCount, const char* path)
+{
+	std::lock_guard<std::mutex> lock(threadsMutex);
+
+	captureEvents.clear();
+	captureGpuNames.clear();
+	capturePath       = path;
+	captureFramesLeft = frameCount;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void Profiler::AddGpuRange(const char* name, u64 startTicks, u64 endTicks)
+{
+	std::lock_guard<std::mutex> lock(threadsMutex);
+	if (captureFramesLeft == 0)
+		return;
+
+	u32 index = 0;
+	while (index < captureGpuNames.size() && captureGpuNames[index] != name)
+		++index;
+	if (index == captureGpuNames.size())
+		captureGpuNames.push_back(name);
+
+	captureEvents.push_back(NewCaptureEvent(startTicks, endTicks, index, PROFILE_GPU_TRACK));
+}
+
+//////////////////////////////////////////////////////////////////////////
+static void WriteJsonString(FILE* file, const char* text)
+{
+	fputc('"', file);
+	for (; *text; ++text)
+	{
+		if (*text == '"' || *text == '\\')		fprintf(file, "\\%c", *text);
+		else if ((u8)*text < 0x20)				fprintf(file, "\\u%04x", (u8)*text);
+		else									fputc(*text, file);
+	}
+	fputc('"', file);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// One complete ("X") event per scope, times in microseconds from the first
+// one, a track per thread and one for the GPU. threadsMutex held.
+BOOL Profiler::WriteCapture(const char* path)
+{
+	FILE* file = fopen(path, "w");
+	if (!file)
+		return false;
+
+	std::stable_sort(captureEvents.begin(), captureEvents.end(),
+		[](const ProfileCaptureEvent& a, const ProfileCaptureEvent& b) { return a.mStart < b.mStart; });
+	u64    origin        = captureEvents.empty() ? 0 : captureEvents.front().mStart;
+	double microsPerTick = 1000.0 / countsPerMs;
+	u32    gpuTrack      = (u32)threads.size();
+
+	fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+	const char* separator = "\n";
+	for (u32 i = 0; i <= gpuTrack; ++i)
+	{
+		fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":", separator, i);
+		WriteJsonString(file, i < gpuTrack ? threads[i].mBuffer->mName : "GPU");
+		fprintf(file, "}}");
+		separator = ",\n";
+	}
+	for (const ProfileCaptureEvent& e : captureEvents)
+	{
+		BOOL bGpu = (e.mTrack == PROFILE_GPU_TRACK);
+		fprintf(file, "%s{\"name\":", separator);
+		WriteJsonString(file, bGpu ? captureGpuNames[e.mScope].c_str() : ScopeName(e.mScope));
+		fprintf(file, ",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u",
+			bGpu ? "gpu" : "cpu",
+			e.mStart > origin ? (e.mStart - origin) * microsPerTick : 0.0,
+			e.mEnd > e.mStart ? (e.mEnd - e.mStart) * microsPerTick : 0.0,
+			bGpu ? gpuTrack : e.mTrack);
+#if RJE_PERF_COUNTERS
+		// The hardware counters as the event's args
+		if (!bGpu && e.mbCounted)
 		{
-			Profile p;
-			p.totalCalls = 0;
-			p.totalTime  = 0;
-			p.name       = name;
-			p.parentId   = currentParent;
-			profiles.push_back(p);
-			currentParent = numProfiles++;
+			const char* argSeparator = "";
+			fprintf(file, ",\"args\":{");
+			for (u32 c = 0; c < PerfCounter_Count; ++c)
+			{
+				fprintf(file, "%s\"%s\":%llu", argSeparator, PerfCounterName((PerfCounter)c), (unsigned long long)e.mCounters[c]);
+				argSeparator = ",";
+			}
+			fprintf(file, "}");
 		}
+#endif
+		fprintf(file, "}");
 	}
+	fprintf(file, "\n]}\n");
+	fclose(file);
+	return true;
 }
 
 //////////////////////////////////////////////////////////////////////////
-void Profiler::ProfileEnd(u64 elapsedTime)
-{   
-	profiles[currentParent].totalCalls++;
-	profiles[currentParent].totalTime += elapsedTime;
+static i32 FindOrAddChild(std::vector<ProfileNode>& nodes, i32 parent, u32 scope)
+{
+	i32 last = -1;
+	for (i32 child = nodes[parent].mFirstChild; child >= 0; child = nodes[child].mNextSibling)
+	{
+		if (nodes[child].mScope == scope)
+			return child;
+		last = child;
+	}
 
-	currentParent = profiles[currentParent].parentId;
+	i32 index = (i32)nodes.size();
+	nodes.push_back(NewNode(scope, parent));
+	if (last < 0)	nodes[parent].mFirstChild = index;
+	else			nodes[last].mNextSibling  = index;
+	return index;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void Profiler::CollectThread(ProfileThread& thread, u32 threadIndex)
+{
+	std::vector<ProfileNode>& nodes = thread.mNodes;
+	for (ProfileNode& node : nodes)
+	{
+		node.mFrameCalls = 0;
+		node.mFrameTicks = 0;
+#if RJE_PERF_COUNTERS
+		node.mFrameCounted = 0;
+		memset(node.mFrameCounters, 0, sizeof(node.mFrameCounters));
+#endif
+	}
+
+	ProfileThreadBuffer* buffer = thread.mBuffer;
+	u32 read  = buffer->mRead.load(std::memory_order_relaxed);
+	u32 write = buffer->mWrite.load(std::memory_order_acquire);
+	for (; read != write; ++read)
+	{
+		const ProfileEvent& e = buffer->mEvents[read & ProfileThreadBuffer::Mask];
+		if (e.mbBegin)
+		{
+			i32 parent = thread.mOpenNodes.empty() ? 0 : thread.mOpenNodes.back();
+			thread.mOpenNodes.push_back(FindOrAddChild(nodes, parent, e.mScope));
+			thread.mOpenTicks.push_back(e.mTicks);
+#if RJE_PERF_COUNTERS
+			const ProfileCounterSample* sample = buffer->CounterSample(read);
+			thread.mOpenCounters.push_back(sample ? sample->mCounters : PerfCounterValues());
+			thread.mOpenCounted.push_back(sample ? 1 : 0);
+#endif
+			continue;
+		}
+
+		// Dropped events: an end without its begin is ignored, a begin
+		// without its end is closed by its parent's end, uncounted
+		size_t open = thread.mOpenNodes.size();
+		while (open > 0 && nodes[thread.mOpenNodes[open-1]].mScope != e.mScope)
+			--open;
+		if (open == 0)
+			continue;
+
+		ProfileNode& node = nodes[thread.mOpenNodes[open-1]];
+		u64 ticks = e.mTicks - thread.mOpenTicks[open-1];
+		node.mFrameCalls++;
+		node.mFrameTicks += ticks;
+		node.mTotalCalls++;
+		node.mTotalTicks += ticks;
+
+#if RJE_PERF_COUNTERS
+		// Counted when both ends read the counters
+		u64 counters[PerfCounter_Count] = {0};
+		const ProfileCounterSample* sample = buffer->CounterSample(read);
+		BOOL bCounted = sample && thread.mOpenCounted[open-1];
+		if (bCounted)
+		{
+			const PerfCounterValues& begin = thread.mOpenCounters[open-1];
+			for (u32 c = 0; c < PerfCounter_Count; ++c)
+			{
+				counters[c] = sample->mCounters.mValues[c] - begin.mValues[c];
+				node.mFrameCounters[c] += counters[c];
+				node.mTotalCounters[c] += counters[c];
+			}
+			node.mFrameCounted++;
+			node.mTotalCounted++;
+		}
+#endif
+
+		if (captureFramesLeft > 0)
+		{
+			ProfileCaptureEvent capture = NewCaptureEvent(thread.mOpenTicks[open-1], e.mTicks, e.mScope, threadIndex);
+#if RJE_PERF_COUNTERS
+			capture.mbCounted = bCounted;
+			memcpy(capture.mCounters, counters, sizeof(counters));
+#endif
+			captureEvents.push_back(capture);
+		}
+		thread.mOpenNodes.resize(open-1);
+		thread.mOpenTicks.resize(open-1);
+#if RJE_PERF_COUNTERS
+		thread.mOpenCounters.resize(open-1);
+		thread.mOpenCounted.resize(open-1);
+#endif
+	}
+	buffer->mRead.store(write, std::memory_order_release);
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -198,13 +671,31 @@ void Profiler::PrintToFile()
 	std::ofstream fout;
 	fout.open ("profiler_release.txt");
 #endif
-	double avgTPC = (profiles[0].totalTime/totalFrames)/countsPerMs;
+	std::lock_guard<std::mutex> lock(threadsMutex);
+
+	// The main thread's top level scopes make the frame
+	u64 frameTicks = 0;
+	if (!threads.empty())
+	{
+		const std::vector<ProfileNode>& nodes = threads[0].mNodes;
+		for (i32 i = nodes[0].mFirstChild; i >= 0; i = nodes[i].mNextSibling)
+			frameTicks += nodes[i].mTotalTicks;
+	}
+	double avgTPC = (frameTicks/(totalFrames > 0 ? totalFrames : 1))/countsPerMs;
 	fout	<< "RamJam Engine Profiler Report\n"
 			<< "Total Frames: "				<< totalFrames
 			<< "\nAvg. Time/Frame (Ms): "	<< avgTPC
-			<< "\nAvg. FPS: "				<< 1.0f/(avgTPC/1000.0f) << "\n\n";
+			<< "\nAvg. FPS: "				<< 1.0f/(avgTPC/1000.0f) << "\n";
+#if RJE_PERF_COUNTERS
+	fout << "Hardware Counters: " << (HardwareCounters() ? "on" : "off") << "\n";
+#endif
+	fout << "\n";
 
-	PrintChildren(fout, 0, 0);
+	for (const ProfileThread& thread : threads)
+	{
+		fout << "== " << thread.mBuffer->mName << " (" << thread.mBuffer->mDropped.load() << " events dropped)\n\n";
+		PrintChildren(fout, thread, 0, 0);
+	}
 
 	fout.close();
 }
@@ -264,7 +755,48 @@ void Profiler::DisplaySimpleState()
 //////////////////////////////////////////////////////////////////////////
 void Profiler::DisplayAdvancedState()
 {
-	ConcatText("Advanced Mode Not Yet Supported", SCREEN_RED);
+	ConcatText("  - Profiler Advanced Mode - \n", SCREEN_ROSE);
+	//-------------
+	ConcatText("Last frame, issued / filtered by the state cache\n\n", SCREEN_GRAY);
+	char buf[64];
+	ConcatTextAndAlign("States");
+	sprintf_s(buf, ": %u / %u\n", mProfilerInfos->StateCallsIssued, mProfilerInfos->StateCallsFiltered);
+	ConcatText(buf);
+	ConcatTextAndAlign("Materials");
+	sprintf_s(buf, ": %u / %u\n", mProfilerInfos->MaterialsIssued, mProfilerInfos->MaterialsFiltered);
+	ConcatText(buf);
+	ConcatTextAndAlign("Effect Applies");
+	sprintf_s(buf, ": %u / %u\n", mProfilerInfos->AppliesIssued, mProfilerInfos->AppliesFiltered);
+	ConcatText(buf);
+	//-------------
+	ConcatText("\nLast frame, shadow partitions reused / static layer only\n\n", SCREEN_GRAY);
+	ConcatTextAndAlign("Shadow Partitions");
+	sprintf_s(buf, ": %u / %u\n", mProfilerInfos->ShadowPartitionsReused, mProfilerInfos->ShadowStaticLayersReused);
+	ConcatText(buf);
+	//-------------
+	ProfilePercentiles frame = history.FramePercentiles();
+	sprintf_s(buf, "\nLast %u frames, p50 / p95 / p99 / max\n\n", history.FramesRecorded());
+	ConcatText(buf, SCREEN_GRAY);
+	ConcatTextAndAlign("Frame");
+	sprintf_s(buf, ": %.2f / %.2f / %.2f / %.2f ms\n", frame.mP50, frame.mP95, frame.mP99, frame.mMax);
+	ConcatText(buf);
+	ConcatTextAndAlign("Spikes");
+	sprintf_s(buf, ": %u over %.1f ms\n", spikeCount, spikeThresholdMs);
+	ConcatText(buf);
+	//-------------
+	ConcatText("\nLast frame, work / limiter wait / budget\n\n", SCREEN_GRAY);
+	ConcatTextAndAlign("Frame");
+	if (mProfilerInfos->FrameBudgetMs > 0.0f)
+		sprintf_s(buf, ": %.2f / %.2f / %.2f ms (%u over)\n", mProfilerInfos->FrameWorkMs, mProfilerInfos->FrameWaitMs, mProfilerInfos->FrameBudgetMs, mProfilerInfos->FrameOverBudget);
+	else
+		sprintf_s(buf, ": %.2f ms, no limit\n", mProfilerInfos->FrameWorkMs);
+	ConcatText(buf);
+	ConcatTextAndAlign("Fixed Steps");
+	sprintf_s(buf, ": %u, alpha %.2f, %.1f ms dropped\n", mProfilerInfos->FixedSteps, mProfilerInfos->FixedStepAlpha, mProfilerInfos->FixedStepDroppedMs);
+	ConcatText(buf);
+	ConcatTextAndAlign("Frame Arena");
+	sprintf_s(buf, ": %.1f KB, peak %.1f KB (%u overflows)\n", mProfilerInfos->FrameArenaBytes / 1024.0f, mProfilerInfos->FrameArenaPeakBytes / 1024.0f, mProfilerInfos->FrameArenaOverflows);
+	ConcatText(buf);
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -278,32 +810,92 @@ void Profiler::DisplayCpuState()
 	ConcatText(buf); 
 	ConcatText("%\n");
 	//-------------
-	std::sort(profiles.rbegin(), profiles.rend());	// reverse sort the profiles (using totalTimes)
-	for (std::vector<Profile>::iterator it=profiles.begin()+1 ; it<profiles.end(); ++it)
+	std::lock_guard<std::mutex> lock(threadsMutex);
+	for (const ProfileThread& thread : threads)
+	{
+		ConcatText("\n");
+		ConcatText(thread.mBuffer->mName, SCREEN_GRAY);
+		ConcatText("\n");
+		DisplayChildren(thread, 0, 0);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Per frame averages since startup, depth first
+void Profiler::DisplayChildren(const ProfileThread& thread, int parent, int depth)
+{
+	const std::vector<ProfileNode>& nodes = thread.mNodes;
+	for (int i = nodes[parent].mFirstChild; i >= 0; i = nodes[i].mNextSibling)
 	{
-		sprintf_s(buf, "%d - ", it->Id);
+		// Keeps room for a line
+		if (mProfileInfoStringSize + 128 > PROFILE_INFO_MAX_LENGTH)
+			return;
+
+		char buf[64];
+		sprintf_s(buf, "%d - ", nodes[i].mScope);
 		ConcatText(buf);
-		ConcatTextAndAlign(it->name, 6);
+		for (int d = 0; d < depth; ++d)	{ ConcatText("  "); }
+		ConcatTextAndAlign(ScopeName(nodes[i].mScope), 6);
 		//---------------
-		float ms      = ((float)((it->totalTime/totalFrames)/countsPerMs));
-		float percent = (float)(((float)it->totalTime/profiles[0].totalTime) * 100.0f);
+		float ms = (float)((nodes[i].mTotalTicks/(totalFrames > 0 ? totalFrames : 1))/countsPerMs);
 		//---------------
 		if (ms < 0.01f)
 			ConcatText("~0 ms\n");
+		else if (parent == 0)
+		{
+			sprintf_s(buf, "%.4f ms\n", ms);
+			ConcatText(buf);
+		}
 		else
 		{
+			float percent = (float)(((float)nodes[i].mTotalTicks/nodes[parent].mTotalTicks) * 100.0f);
 			sprintf_s(buf, "%.4f ms\t(", ms);
 			ConcatText(buf);
-			sprintf_s(buf, "%.1f percent of %d)\n", percent, it->parentId);
+			sprintf_s(buf, "%.1f percent of %d)\n", percent, nodes[parent].mScope);
 			ConcatText(buf);
 		}
+		DisplayChildren(thread, i, depth+1);
 	}
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
 void Profiler::DisplayMemoryState()
 {
-	ConcatText("Memory Mode Not Yet Supported", SCREEN_RED);
+	ConcatText("  - Profiler Memory Mode - \n", SCREEN_ROSE);
+	//-------------
+	char buf[128];
+	sprintf_s(buf, "RAM Usage : %d MB, %.1f MB accounted\n", mProfilerInfos->ProcessPeakWorkingSet, MemoryBudget::Instance()->TotalBytes() / (1024.0f * 1024.0f));
+	ConcatText(buf);
+	ConcatText("\nCurrent / peak / budget, top consumers\n", SCREEN_GRAY);
+	//-------------
+	std::vector<MemoryConsumer> consumers;
+	for (u32 i = 0; i < Memory_CategoryCount; ++i)
+	{
+		// Keeps room for a category
+		if (mProfileInfoStringSize + 512 > PROFILE_INFO_MAX_LENGTH)
+			return;
+
+		MemoryCategory category = (MemoryCategory)i;
+		MemoryCategoryStats stats = MemoryBudget::Instance()->Stats(category);
+		BOOL bOver = stats.mBudget > 0 && stats.mBytes > stats.mBudget;
+
+		ConcatText("\n");
+		ConcatTextAndAlign(MemoryCategoryName(category));
+		if (stats.mBudget > 0)
+			sprintf_s(buf, ": %.2f / %.2f / %.0f MB\n", stats.mBytes / (1024.0f * 1024.0f), stats.mPeakBytes / (1024.0f * 1024.0f), stats.mBudget / (1024.0f * 1024.0f));
+		else
+			sprintf_s(buf, ": %.2f / %.2f MB, no budget\n", stats.mBytes / (1024.0f * 1024.0f), stats.mPeakBytes / (1024.0f * 1024.0f));
+		ConcatText(buf, bOver ? SCREEN_RED : SCREEN_WHITE);
+
+		MemoryBudget::Instance()->TopConsumers(category, 3, consumers);
+		for (const MemoryConsumer& consumer : consumers)
+		{
+			sprintf_s(buf, "    %.2f MB in %u: ", consumer.mBytes / (1024.0f * 1024.0f), consumer.mResources);
+			ConcatText(buf, SCREEN_GRAY);
+			ConcatText(consumer.mName.c_str(), SCREEN_GRAY);
+			ConcatText("\n");
+		}
+	}
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -3,24 +3,44 @@
 Timer* Timer::sInstance = nullptr;
 
 //////////////////////////////////////////////////////////////////////////
-Timer::Timer()
+Timer::Timer(FrameClock* clock)
+	: mClock(clock)
+	, mbOwnsClock(clock == nullptr)
 {
+	if (mbOwnsClock)
+	{
+		mClock = rje_new HighResolutionClock();
+	}
+
 	mActive    = false;
 	mTimeScale = 1.0f;
 
 	mDeltaTime = 0.0f;
 	mRealDeltaTime = 0.0f;
 
-	u64 frequency;
-	QueryPerformanceFrequency((LARGE_INTEGER*)&frequency);
-	mSecondsPerCount = 1.0f / frequency;
+	mSecondsPerCount = 1.0 / mClock->Frequency();
 
 	Reset(true);
 }
 
+//////////////////////////////////////////////////////////////////////////
+Timer::~Timer()
+{
+	if (mbOwnsClock)
+	{
+		RJE_SAFE_DELETE(mClock);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+float Timer::Time() const
+{
+	return static_cast<float>(PreciseTime());
+}
+
 // Returns the total time elapsed since Reset() was called, NOT counting any
 // time when the clock is stopped.
-float Timer::Time() const
+f64 Timer::PreciseTime() const
 {
 	if (mActive)
 	{
@@ -33,7 +53,7 @@ float Timer::Time() const
 		//                     |<--paused time-->|
 		// ----*---------------*-----------------*------------*------> time
 		//  mBaseTime       mStopTime        startTime     mCurrTime
-		return static_cast<float>(((mCurrentTime-mPausedTime)-mBaseTime)*mSecondsPerCount);
+		return ((mCurrentTime-mPausedTime)-mBaseTime)*mSecondsPerCount;
 	}
 	else
 	{
@@ -46,7 +66,7 @@ float Timer::Time() const
 		//                     |<--paused time-->|
 		// ----*---------------*-----------------*------------*------------*------> time
 		//  mBaseTime       mStopTime        startTime     mStopTime    mCurrTime
-		return static_cast<float>(((mStopTime - mPausedTime)-mBaseTime)*mSecondsPerCount);
+		return ((mStopTime - mPausedTime)-mBaseTime)*mSecondsPerCount;
 	}
 }
 
@@ -59,7 +79,7 @@ void Timer::Time(float time)
 	mStopTime	= mCurrentTime;
 	mPausedTime	= 0;
 
-	mBaseTime = mStopTime - static_cast<u64>(time / mSecondsPerCount);
+	mBaseTime = mStopTime - static_cast<u64>(time / mSecondsPerCount + 0.5);
 }
 
 
@@ -75,8 +95,7 @@ float Timer::RealDeltaTime() const
 
 void Timer::Reset( BOOL pause )
 {
-	u64 currentTime;
-	QueryPerformanceCounter((LARGE_INTEGER*)&currentTime);
+	u64 currentTime = mClock->Now();
 
 	mBaseTime		= currentTime;
 	mPreviousTime	= currentTime;
@@ -89,8 +108,7 @@ void Timer::Reset( BOOL pause )
 
 void Timer::Start()
 {
-	u64 startTime;
-	QueryPerformanceCounter((LARGE_INTEGER*)&startTime);
+	u64 startTime = mClock->Now();
 
 	// Accumulate the time elapsed between stop and start pairs.
 	//
@@ -128,12 +146,10 @@ void Timer::Update()
 		return;
 	}
 
-	u64 currentTime;
-	QueryPerformanceCounter((LARGE_INTEGER*)&currentTime);
-	mCurrentTime = currentTime;
+	mCurrentTime = mClock->Now();
 
 	// Time difference between this frame and the previous.
-	mRealDeltaTime = (mCurrentTime - mPreviousTime)*mSecondsPerCount;
+	mRealDeltaTime = static_cast<float>((mCurrentTime - mPreviousTime)*mSecondsPerCount);
 	mDeltaTime     = mRealDeltaTime * mTimeScale;
 	
 	// Prepare for next frame.
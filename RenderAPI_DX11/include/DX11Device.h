@@ -8,6 +8,7 @@ struct DX11Device
 
 	ID3D11Device*			md3dDevice;
 	ID3D11DeviceContext*	md3dImmediateContext;
+	DX11StateCache			mStateCache;	// filters the redundant calls on md3dImmediateContext
 
 	void Release();
 };
\ No newline at end of file
@@ -49,6 +49,10 @@ struct BasicEffect : public Effect
 	HRESULT SetSpotLights(ID3D11ShaderResourceView* lights)  { return SpotLights->SetResource(lights); }
 	HRESULT SetSamplerState(ID3D11SamplerState* pSampler)    { return TextureSampler->SetSampler(0, pSampler); }
 	HRESULT SetMaterial(Material* mat);
+	//-------
+	HRESULT UseLightClusters(BOOL state)                     { return LightClustersEnabled->SetBool(state != 0); }
+	void    SetLightClusters(ID3D11ShaderResourceView* clusters, ID3D11ShaderResourceView* indices) { LightClusters->SetResource(clusters); LightClusterIndices->SetResource(indices); }
+	void    SetLightClusterGrid(u32 tileSize, u32 tilesX, u32 tilesY, u32 slices, float sliceScale, float sliceBias);
 	
 	//-------------------------------------------
 
@@ -78,6 +82,13 @@ struct BasicEffect : public Effect
 	ID3DX11EffectShaderResourceVariable*	DirLights;
 	ID3DX11EffectShaderResourceVariable*	PointLights;
 	ID3DX11EffectShaderResourceVariable*	SpotLights;
+	//-------
+	ID3DX11EffectScalarVariable*			LightClustersEnabled;
+	ID3DX11EffectShaderResourceVariable*	LightClusters;
+	ID3DX11EffectShaderResourceVariable*	LightClusterIndices;
+	ID3DX11EffectVectorVariable*			ClusterGrid;
+	ID3DX11EffectVectorVariable*			ClusterSliceParams;
+	ID3DX11EffectScalarVariable*			ClusterSlices;
 };
 
 //////////////////////////////////////////////////////////////////////////
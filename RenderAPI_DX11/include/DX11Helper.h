@@ -51,6 +51,7 @@ using namespace DirectX;
 
 //////////////////////////////////////////////////////////////////////////
 #include "DX11Profiler.h"
+#include "DX11StateCache.h"
 #include "DX11Device.h"
 #include "DX11CommonStates.h"
 #include "DX11Effect.h"
@@ -11,15 +11,18 @@ struct DX11Mesh : Mesh
 	//--------
 	static ID3D11Device*		sDevice;
 	static ID3D11DeviceContext*	sDeviceContext;
+	static DX11StateCache*		sStateCache;
 	//--------
 	ID3D11Buffer* mVertexBuffer;
 	ID3D11Buffer* mIndexBuffer;
 	//--------
 	DX11Mesh();
 	//--------
-	static void SetDevice(ID3D11Device* device, ID3D11DeviceContext* deviceContext);
+	static void SetDevice(ID3D11Device* device, ID3D11DeviceContext* deviceContext, DX11StateCache* stateCache);
 	//--------
 	void Render(u32 subset);
+	void Bind();				// vertex and index buffers only
+	void Draw(u32 subset);		// assumes Bind() was called for this mesh
 	void Destroy();
 	//--------
 	void LoadMaterialFromFile(       std::string materialFile);
@@ -87,6 +87,7 @@ struct DX11Profiler
 
 	ProfileMap		mProfiles;
 	u64				mCurrFrame;
+	u64				mFrameStartTicks;	// Profiler::Ticks() of the frame's first StartProfile, 0 until then
 
 	DeepProfileMap	mDeepProfiles;
 	u64				mCurrDeepFrame;
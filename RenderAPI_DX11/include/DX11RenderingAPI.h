@@ -5,6 +5,12 @@
 #include "../../RamJamEngine/include/Scene.h"
 #include "../../RamJamEngine/include/AntTweakBar.h"
 #include "../../RamJamEngine/include/GameObject.h"
+#include "../../RamJamEngine/include/RenderQueue.h"
+#include "../../RamJamEngine/include/ShadowCasterCulling.h"
+#include "../../RamJamEngine/include/ShadowCache.h"
+#include "../../RamJamEngine/include/LightClusters.h"
+#include "../../RamJamEngine/include/PointLightSet.h"
+#include "Bounds.h"
 
 
 //////////////////////////////////////////////////////////////////////////
@@ -37,18 +43,32 @@ struct DX11RenderingAPI : GraphicAPI
 	u32				mShadowTextureDim;
 	D3D11_VIEWPORT	mShadowViewport;
 	Depth2D*		mShadowDepthTexture;
-	Texture2D*		mShadowEVSMTexture;
+	Texture2D*		mShadowEVSMTexture[PARTITIONS];		// one per partition, kept across frames by mShadowCache
 	Texture2D*		mShadowEVSMBlurTexture;
+	Depth2D*		mShadowStaticDepth[PARTITIONS];		// static caster layer of each partition
+	//---------------
+	BOOL				mbCullShadowCasters;
+	ShadowCasterCuller	mShadowCasterCuller;	// against the partitions read back from the GPU
+	ShadowMapCache		mShadowCache;
 	//---------------
 	
 	//---------------
 	BOOL            mbUseFrustumCulling;
 	BOOL            mbUseAABB;	// if not, use Bounding Sphere
-	BoundingBox     mAABB;
-	BoundingFrustum mCameraFrustum;
+	Frustum         mCameraFrustum;	// world space, rebuilt by ComputeFrustumFlags
 	u32             mRenderedSubsets;
 	u32             mTotalSubsets;
 	//---------------
+	BOOL            mbUseRenderQueue;	// if not, draw in scene order
+	RenderQueue     mRenderQueue;		// visible subsets, sorted by RenderKey
+	RenderQueue     mShadowQueue;		// every subset, grouped by mesh
+	//---------------
+	BOOL							mbUseLightClusters;		// forward pass: point lights binned on the CPU
+	LightClusterGrid				mLightClusters;
+	StructuredBuffer<LightCluster>*	mLightClusterBuffer;
+	StructuredBuffer<u32>*			mLightIndexBuffer;
+	u32								mLightIndexCapacity;
+	//---------------
 
 #if defined(RJE_DEBUG)  
 	IDXGIDebug*			md3dDebug;
@@ -71,16 +91,15 @@ struct DX11RenderingAPI : GraphicAPI
 	StructuredBuffer<PointLight>*			mPointLights;
 	StructuredBuffer<SpotLight>*			mSpotLights;
 	//---------------
-	float							mPointLightsRadius   [MAX_LIGHTS];
-	float							mPointLightsHeight   [MAX_LIGHTS];
-	float							mPointLightsAngle    [MAX_LIGHTS];
-	float							mPointLightsAnimSpeed[MAX_LIGHTS];
+	PointLightSet					mPointLightSet;
+	std::vector<LightRange>			mPointLightRanges;		// scratch for UploadPointLights()
 	DirectionalLight				mWorkingDirLights  [MAX_LIGHTS];
-	PointLight						mWorkingPointLights[MAX_LIGHTS];
 	SpotLight						mWorkingSpotLights [MAX_LIGHTS];
 	u32 mDirLightCount,   mDirLightUICount;
 	u32 mPointLightCount, mPointLightUICount;
 	u32 mSpotLightCount,  mSpotLightUICount;
+	f32 mAnimationTime, mPreviousAnimationTime;		// where the last step ended, and started
+	f32 mSunAngle,      mPreviousSunAngle;
 	Material mLightSphereMat;
 	//---------------
 
@@ -105,7 +124,11 @@ struct DX11RenderingAPI : GraphicAPI
 	//////////////////////////////////////////////////////////////////////////
 
 	virtual void Initialize(int windowWidth, int windowHeight);
+	// One animation step: the sun and the lights
 	virtual void UpdateScene( float dt );
+	// Inputs, UI light counts, the light buffers (render space) and the shadow
+	// camera, with the lights between the last two steps
+	virtual void UpdateFrame( float alpha );
 	virtual void DrawScene();
 	virtual void Shutdown();
 	virtual void ResizeWindow(int newSizeWidth, int newSizeHeight);
@@ -141,9 +164,15 @@ struct DX11RenderingAPI : GraphicAPI
 	void ComputeFrustumFlags();
 	void ClearFrustumFlags();
 	//---------------
+	void BuildRenderQueues(BOOL bShadows);
+	void SubmitRenderQueue(ID3DX11EffectPass* shaderPass);
+	void SubmitShadowQueue(ID3DX11EffectPass* shaderPass, const Matrix44& viewProj, u32 currentPartition, u32 layers);
+	//---------------
 	void SetActiveDirLights(  int activeLights);
 	void SetActivePointLights(int activeLights);
 	void SetActiveSpotLights( int activeLights);
+	void UploadPointLights();
+	BOOL BuildLightClusters();
 
 	//////////////////////////////////////////////////////////////////////////
 
@@ -159,7 +188,10 @@ struct DX11RenderingAPI : GraphicAPI
 	//////////////////////////////////////////////////////////////////////////
 
 	ID3D11ShaderResourceView* ComputeSDSMPartitions();
-	void RenderShadowDepth(ID3D11ShaderResourceView* partitionSRV, u32 currentPartition);
+	void CullShadowCasters();
+	u64  ShadowPartitionKey();
+	void RenderShadowDepth(ID3D11ShaderResourceView* partitionSRV, u32 currentPartition, ShadowCacheAction action);
+	void DrawShadowCasters(ID3DX11EffectTechnique* tech, const Matrix44& viewProj, u32 currentPartition, u32 layers);
 	void ConvertToEVSM( ID3D11ShaderResourceView* depthInput, ID3D11RenderTargetView* evsmOutput, ID3D11ShaderResourceView* partitionSRV, u32 partitionIndex);
 	void AccumulateLighting( ID3D11RenderTargetView* backBuffer, ID3D11ShaderResourceView* shadowSRV, ID3D11ShaderResourceView* partitionSRV, u32 partitionIndex);
 	
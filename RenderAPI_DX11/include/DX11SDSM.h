@@ -2,6 +2,7 @@
 
 #include "DX11Helper.h"
 #include "..\..\RamJamEngine\include\ShaderDefines.h"
+#include "..\..\RamJamEngine\include\ShadowCasterCulling.h"
 
 RJE_ALIGNOF(16)
 struct SDSMPartitionsConstants
@@ -36,11 +37,22 @@ struct DX11SDSM
 	StructuredBuffer<Partition>*   mPartitionBuffer;
 	StructuredBuffer<BoundsFloat>* mPartitionBounds;
 	//---------------
+	// Staging copies of mPartitionBuffer for the CPU, mapped without waiting
+	// on the GPU
+	ID3D11Buffer*			mPartitionReadback[PartitionReadbackQueue::Slots];
+	PartitionReadbackQueue	mReadbackQueue;
+	//---------------
 	ID3D11ShaderResourceView* ComputePartitionsFromGBuffer(	ID3D11DeviceContext* dc,
 															u32 gbufferTexturesNum, ID3D11ShaderResourceView** gbufferTextures,
 															const Vector3& lightSpaceBorder, const Vector3& maxScale, u32 screenWidth, u32 screenHeight);
 	void UpdateShaderConstants();
 	void UnbindResources(ID3D11DeviceContext *d3dDeviceContext);
 	//---------------
+	void CreateReadbackBuffers(ID3D11Device* device);
+	void ReleaseReadbackBuffers();
+	// Queues a copy of this frame's partitions when a staging buffer is free,
+	// and returns true when an older copy could be read without stalling
+	BOOL ReadbackPartitions(ID3D11DeviceContext* dc, OUT ShadowPartition* outPartitions);
+	//---------------
 	DX11SDSM();
 };
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "DX11Helper.h"
+#include "../../RamJamEngine/include/StateCache.h"
+
+//////////////////////////////////////////////////////////////////////////
+struct DX11StateTraits
+{
+	typedef ID3D11DeviceContext				Context;
+	typedef HRESULT							Result;
+	typedef ID3D11Buffer					Buffer;
+	typedef DXGI_FORMAT						Format;
+	typedef ID3D11InputLayout				InputLayout;
+	typedef D3D11_PRIMITIVE_TOPOLOGY		Topology;
+	typedef ID3D11RasterizerState			RasterizerState;
+	typedef ID3D11BlendState				BlendState;
+	typedef ID3D11ShaderResourceView		ShaderResource;
+	typedef ID3D11RenderTargetView			RenderTarget;
+	typedef ID3D11DepthStencilView			DepthStencil;
+	typedef ID3D11UnorderedAccessView		UnorderedAccess;
+	typedef ID3DX11EffectPass				Pass;
+
+	static HRESULT Apply(ID3DX11EffectPass* pass, ID3D11DeviceContext* context) { return pass->Apply(0, context); }
+};
+
+typedef StateCache<DX11StateTraits> DX11StateCache;
@@ -37,6 +37,9 @@ public:
 	T* MapDiscard(ID3D11DeviceContext* d3dDeviceContext);
 	void Unmap(ID3D11DeviceContext* d3dDeviceContext);
 
+	// Only valid for default (non dynamic) buffers: rewrites elements [first, first + count)
+	void UpdateRange(ID3D11DeviceContext* d3dDeviceContext, const T* data, u32 first, u32 count);
+
 private:
 	// Not implemented
 	StructuredBuffer(const StructuredBuffer&);
@@ -102,4 +105,13 @@ void StructuredBuffer<T>::Unmap(ID3D11DeviceContext* d3dDeviceContext)
 }
 
 
+template <typename T>
+void StructuredBuffer<T>::UpdateRange(ID3D11DeviceContext* d3dDeviceContext, const T* data, u32 first, u32 count)
+{
+	RJE_ASSERT(first + count <= (u32)mElements);
+	D3D11_BOX box = { static_cast<UINT>(first * sizeof(T)), 0, 0, static_cast<UINT>((first + count) * sizeof(T)), 1, 1 };
+	d3dDeviceContext->UpdateSubresource(mBuffer, 0, &box, data, 0, 0);
+}
+
+
 // TODO: Constant buffers
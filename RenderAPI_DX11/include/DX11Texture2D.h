@@ -40,6 +40,10 @@ private:
 	std::vector<ID3D11RenderTargetView*>		mRenderTargetElements;
 	std::vector<ID3D11UnorderedAccessView*>		mUnorderedAccessElements;
 	std::vector<ID3D11ShaderResourceView*>		mShaderResourceElements;
+
+	// In the MemoryBudget, under the size
+	char	mBudgetOwner[32];
+	i64		mBudgetBytes;
 };
 
 
@@ -73,4 +77,8 @@ private:
 
 	// One per array element
 	std::vector<ID3D11DepthStencilView*> mDepthStencilElements;
+
+	// In the MemoryBudget, under the size
+	char	mBudgetOwner[32];
+	i64		mBudgetBytes;
 };
@@ -11,6 +11,7 @@ void DX11Device::Release()
 	if (md3dImmediateContext)
 		md3dImmediateContext->ClearState();
 
+	mStateCache.SetContext(nullptr);
 	RJE_SAFE_RELEASE(md3dImmediateContext);
 	RJE_SAFE_RELEASE(md3dDevice);
 }
\ No newline at end of file
@@ -42,14 +42,17 @@ void DX11Drawable::SetShaderGizmo(ColorEffect* shaderGizmo )
 void DX11Drawable::Render(ID3DX11EffectPass* shaderPass, BOOL bDrawOpaque /*= true*/)
 {
 	RJE_CHECK_FOR_SUCCESS(sShader->SetWorld(mTransform->WorldMat));
+	mMesh->sStateCache->MarkEffectDirty();
 	for (u32 iSubset=0 ; iSubset<mMesh->mSubsetCount; ++iSubset)
 	{
 		if (mMesh->mSubsets[iSubset].mbIsInFrustum)
 		{
 			if (mMesh->mMaterial[iSubset]->mIsOpaque == bDrawOpaque)
 			{
-				RJE_CHECK_FOR_SUCCESS(sShader->SetMaterial(mMesh->mMaterial[iSubset].get()));
-				RJE_CHECK_FOR_SUCCESS(shaderPass->Apply(NULL, mMesh->sDeviceContext));
+				Material* material = mMesh->mMaterial[iSubset].get();
+				if (mMesh->sStateCache->NeedsMaterial(material->mSortId))
+					RJE_CHECK_FOR_SUCCESS(sShader->SetMaterial(material));
+				RJE_CHECK_FOR_SUCCESS(mMesh->sStateCache->ApplyIfDirty(shaderPass));
 				mMesh->Render(iSubset);
 			}
 		}
@@ -62,6 +65,6 @@ void DX11Drawable::RenderGizmo(ID3DX11EffectPass* shaderPass)
 	RJE_CHECK_FOR_SUCCESS(sShader_Gizmo->SetColor(mGizmoColor.GetVector4RGBANorm()));
 	RJE_CHECK_FOR_SUCCESS(sShader_Gizmo->SetWorld(mTransform->WorldMatNoScale));
 
-	RJE_CHECK_FOR_SUCCESS(shaderPass->Apply(NULL, mGizmo->sDeviceContext));
+	RJE_CHECK_FOR_SUCCESS(mGizmo->sStateCache->Apply(shaderPass));
 	mGizmo->Render(-1);
 }
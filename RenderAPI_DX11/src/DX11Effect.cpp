@@ -40,10 +40,26 @@ BasicEffect::BasicEffect(ID3D11Device* device, const std::string& filename)
 	PointLights       = mFX->GetVariableByName("gPointLights")->AsShaderResource();
 	SpotLights        = mFX->GetVariableByName("gSpotLights")->AsShaderResource();
 	TextureSampler    = (ID3DX11EffectSamplerVariable*) mFX->GetVariableByName("gTextureSampler");
+	//-------
+	LightClustersEnabled = mFX->GetVariableByName("gUseLightClusters")->AsScalar();
+	LightClusters        = mFX->GetVariableByName("gLightClusters")->AsShaderResource();
+	LightClusterIndices  = mFX->GetVariableByName("gLightClusterIndices")->AsShaderResource();
+	ClusterGrid          = mFX->GetVariableByName("gClusterGrid")->AsVector();
+	ClusterSliceParams   = mFX->GetVariableByName("gClusterSliceParams")->AsVector();
+	ClusterSlices        = mFX->GetVariableByName("gClusterSlices")->AsScalar();
 }
 //-----------------------
 BasicEffect::~BasicEffect(){}
 //-----------------------
+void BasicEffect::SetLightClusterGrid(u32 tileSize, u32 tilesX, u32 tilesY, u32 slices, float sliceScale, float sliceBias)
+{
+	int   grid[4]        = { (int)tileSize, (int)tilesX, (int)tilesY, 0 };
+	float sliceParams[4] = { sliceScale, sliceBias, 0.0f, 0.0f };
+	ClusterGrid->SetIntVector(grid);
+	ClusterSliceParams->SetFloatVector(sliceParams);
+	ClusterSlices->SetInt(slices);
+}
+//-----------------------
 HRESULT BasicEffect::SetMaterial(Material* mat)
 {
 	HRESULT res = S_OK;
@@ -295,34 +311,34 @@ void DX11Effects::InitAll(ID3D11Device* device)
 {
 	string shaderPath;
 
-	shaderPath = System::Instance()->mDataPath + CIniFile::GetValue("basic",  "shaders", System::Instance()->mResourcesPath);
+	shaderPath = RJE_GLOBALS::gDataPath + CIniFile::GetValue("basic",  "shaders", RJE_GLOBALS::gResourcesPath);
 	BasicFX  = rje_new BasicEffect( device, shaderPath);
 	//-------------
-	shaderPath = System::Instance()->mDataPath + CIniFile::GetValue("postprocess", "shaders", System::Instance()->mResourcesPath);
+	shaderPath = RJE_GLOBALS::gDataPath + CIniFile::GetValue("postprocess", "shaders", RJE_GLOBALS::gResourcesPath);
 	PostProcessFX = rje_new PostProcessEffect(device, shaderPath);
 	//-------------
-	shaderPath = System::Instance()->mDataPath + CIniFile::GetValue("sprite", "shaders", System::Instance()->mResourcesPath);
+	shaderPath = RJE_GLOBALS::gDataPath + CIniFile::GetValue("sprite", "shaders", RJE_GLOBALS::gResourcesPath);
 	SpriteFX = rje_new SpriteEffect(device, shaderPath);
 	//-------------
-	shaderPath = System::Instance()->mDataPath + CIniFile::GetValue("color", "shaders", System::Instance()->mResourcesPath);
+	shaderPath = RJE_GLOBALS::gDataPath + CIniFile::GetValue("color", "shaders", RJE_GLOBALS::gResourcesPath);
 	ColorFX = rje_new ColorEffect(device, shaderPath);
 	//-------------
-	shaderPath = System::Instance()->mDataPath + CIniFile::GetValue("skybox", "shaders", System::Instance()->mResourcesPath);
+	shaderPath = RJE_GLOBALS::gDataPath + CIniFile::GetValue("skybox", "shaders", RJE_GLOBALS::gResourcesPath);
 	SkyboxFX = rje_new SkyboxEffect(device, shaderPath);
 	//-------------
-	shaderPath = System::Instance()->mDataPath + CIniFile::GetValue("tiled", "shaders", System::Instance()->mResourcesPath);
+	shaderPath = RJE_GLOBALS::gDataPath + CIniFile::GetValue("tiled", "shaders", RJE_GLOBALS::gResourcesPath);
 	TiledDeferredFX = rje_new TiledDeferredEffect(device, shaderPath);
 	//-------------
-	shaderPath = System::Instance()->mDataPath + CIniFile::GetValue("shadowmap", "shaders", System::Instance()->mResourcesPath);
+	shaderPath = RJE_GLOBALS::gDataPath + CIniFile::GetValue("shadowmap", "shaders", RJE_GLOBALS::gResourcesPath);
 	ShadowMapFX = rje_new ShadowMapEffect(device, shaderPath);
 	//-------------
-	shaderPath = System::Instance()->mDataPath + CIniFile::GetValue("sdsm", "shaders", System::Instance()->mResourcesPath);
+	shaderPath = RJE_GLOBALS::gDataPath + CIniFile::GetValue("sdsm", "shaders", RJE_GLOBALS::gResourcesPath);
 	SDSMFX = rje_new SDSMEffect(device, shaderPath);
 	//-------------
-	shaderPath = System::Instance()->mDataPath + CIniFile::GetValue("evsmblur", "shaders", System::Instance()->mResourcesPath);
+	shaderPath = RJE_GLOBALS::gDataPath + CIniFile::GetValue("evsmblur", "shaders", RJE_GLOBALS::gResourcesPath);
 	EVSMBlurFX = rje_new EVSMBlurEffect(device, shaderPath);
 	//-------------
-	shaderPath = System::Instance()->mDataPath + CIniFile::GetValue("evsmconvert", "shaders", System::Instance()->mResourcesPath);
+	shaderPath = RJE_GLOBALS::gDataPath + CIniFile::GetValue("evsmconvert", "shaders", RJE_GLOBALS::gResourcesPath);
 	EVSMConvertFX = rje_new EVSMConvertEffect(device, shaderPath);
 }
 
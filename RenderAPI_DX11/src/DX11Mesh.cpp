@@ -6,6 +6,7 @@
 DX11Mesh*				DX11Mesh::sInstance      = nullptr;
 ID3D11Device*			DX11Mesh::sDevice        = nullptr;
 ID3D11DeviceContext*	DX11Mesh::sDeviceContext = nullptr;
+DX11StateCache*			DX11Mesh::sStateCache    = nullptr;
 u32		DX11Mesh::sTotalVertexCount    = 0;
 u32		DX11Mesh::sTotalPrimitiveCount = 0;
 
@@ -20,10 +21,11 @@ DX11Mesh::DX11Mesh()
 }
 
 //////////////////////////////////////////////////////////////////////////
-void DX11Mesh::SetDevice(ID3D11Device* device, ID3D11DeviceContext* deviceContext)
+void DX11Mesh::SetDevice(ID3D11Device* device, ID3D11DeviceContext* deviceContext, DX11StateCache* stateCache)
 {
 	sDevice        = device;
 	sDeviceContext = deviceContext;
+	sStateCache    = stateCache;
 	//--------
 	sTotalVertexCount    = 0;
 	sTotalPrimitiveCount = 0;
@@ -37,6 +39,8 @@ void DX11Mesh::Destroy()
 	//-------
 	RJE_SAFE_DELETE_PTR(mSubsets);
 	//-------
+	if (mVertexBuffer)	MemoryBudget::Instance()->Remove(Memory_Meshes, BudgetOwner(), mByteWidth);
+	if (mIndexBuffer)	MemoryBudget::Instance()->Remove(Memory_Meshes, BudgetOwner(), sizeof(u32) * mIndexTotalCount);
 	RJE_SAFE_RELEASE(mVertexBuffer);
 	RJE_SAFE_RELEASE(mIndexBuffer);
 }
@@ -53,6 +57,8 @@ void DX11Mesh::CreateVertexBuffer(void* vertexData)
 	D3D11_SUBRESOURCE_DATA vinitData;
 	vinitData.pSysMem = vertexData;
 	RJE_CHECK_FOR_SUCCESS(sDevice->CreateBuffer(&vbd, &vinitData, &mVertexBuffer));
+	if (mVertexBuffer)
+		MemoryBudget::Instance()->Add(Memory_Meshes, BudgetOwner(), vbd.ByteWidth);
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -67,14 +73,13 @@ void DX11Mesh::CreateIndexBuffer(u32* indexData)
 	D3D11_SUBRESOURCE_DATA iinitData;
 	iinitData.pSysMem = &indexData[0];
 	RJE_CHECK_FOR_SUCCESS(sDevice->CreateBuffer(&ibd, &iinitData, &mIndexBuffer));
+	if (mIndexBuffer)
+		MemoryBudget::Instance()->Add(Memory_Meshes, BudgetOwner(), ibd.ByteWidth);
 }
 
 //////////////////////////////////////////////////////////////////////////
 void DX11Mesh::Render(u32 subset)
 {
-	u32 stride = mDataSize;
-	u32 offset = 0;
-
 	// This must be done before drawing every object concerned and NOT for every object
 // 	switch (mInputLayout)
 // 	{
@@ -84,18 +89,25 @@ void DX11Mesh::Render(u32 subset)
 // 	default:	break;
 // 	}
 	
+	Bind();
+	Draw(subset);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void DX11Mesh::Bind()
+{
+	u32 stride = mDataSize;
+	u32 offset = 0;
+	sStateCache->IASetVertexBuffers(0, 1, &mVertexBuffer, &stride, &offset);
+	sStateCache->IASetIndexBuffer(mIndexBuffer, DXGI_FORMAT_R32_UINT, 0);
+}
+//-----------
+void DX11Mesh::Draw(u32 subset)
+{
 	if(subset==-1)
-	{
-		sDeviceContext->IASetVertexBuffers(0, 1, &mVertexBuffer, &stride, &offset);
-		sDeviceContext->IASetIndexBuffer(mIndexBuffer, DXGI_FORMAT_R32_UINT, 0);
 		sDeviceContext->DrawIndexed(mIndexTotalCount, 0, 0);
-	}
 	else
-	{
-		sDeviceContext->IASetVertexBuffers(0, 1, &mVertexBuffer, &stride, &offset);
-		sDeviceContext->IASetIndexBuffer(mIndexBuffer, DXGI_FORMAT_R32_UINT, 0);
 		sDeviceContext->DrawIndexed(mSubsets[subset].mIndexCount, mSubsets[subset].mIndexStart, mSubsets[subset].mVertexStart);
-	}
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -104,7 +116,7 @@ void DX11Mesh::LoadMaterialFromFile(std::string materialFile )
 	unique_ptr<Material> material (new Material);
 
 	// first we set all the properties from the material file
-	CIniFile::OpenFile(System::Instance()->mDataPath + "materials\\" + materialFile);
+	CIniFile::OpenFile(RJE_GLOBALS::gDataPath + "materials\\" + materialFile);
 	material->LoadPropertiesFromFile(materialFile);
 
 	CIniFile::CloseFile();
@@ -117,7 +129,7 @@ void DX11Mesh::LoadMaterialLibraryFromFile(std::string materialLibraryFile)
 	string material;
 	int tokenPos     = (int)materialLibraryFile.rfind("\\");
 	string matFolder = materialLibraryFile.substr(0, tokenPos);
-	ifstream matLibFile (System::Instance()->mDataPath + "materials\\" + materialLibraryFile);
+	ifstream matLibFile (RJE_GLOBALS::gDataPath + "materials\\" + materialLibraryFile);
 	if (matLibFile.is_open())
 	{
 		while ( getline (matLibFile,material) )
@@ -138,10 +150,10 @@ void DX11Mesh::LoadMaterialLibraryFromFile(std::string materialLibraryFile)
 //////////////////////////////////////////////////////////////////////////
 void DX11Mesh::CheckMaterialFile(string materialFile)
 {
-	ifstream matFile (System::Instance()->mDataPath + "materials\\" + materialFile);
+	ifstream matFile (RJE_GLOBALS::gDataPath + "materials\\" + materialFile);
 	if (!matFile.is_open())
 	{
-		std::ofstream out (System::Instance()->mDataPath + "materials\\" + materialFile);
+		std::ofstream out (RJE_GLOBALS::gDataPath + "materials\\" + materialFile);
 		out << "[shader]\n";
 		out << "Name=basic\n";
 		out << "# ----------------------\n";
@@ -172,6 +184,7 @@ void DX11Mesh::LoadModelFromFile(std::string filePath)
 		RJE_MESSAGE_BOX(0, L"model file not found.", 0, 0);
 		return;
 	}
+	mName = filePath;
 	u32 modelTriangleCount = 0;
 	fread(&mSubsetCount, sizeof(u32), 1, fIn);
 	mSubsets = rje_new Subset[mSubsetCount];
@@ -241,8 +254,10 @@ void DX11Mesh::LoadModelFromFile(std::string filePath)
 			vMax = Vector3::Max(vMax, vTemp);
 		}
 
+		// The subset ends on the last element of its last vertex
 		currentVertex = i / layoutElementCount;
-		if (currentVertex+1 == mSubsets[currentSubset].mVertexStart + mSubsets[currentSubset].mVertexCount)
+		if (i % layoutElementCount == layoutElementCount-1 && currentSubset < mSubsetCount &&
+			currentVertex+1 == mSubsets[currentSubset].mVertexStart + mSubsets[currentSubset].mVertexCount)
 		{
 			mSubsets[currentSubset].mCenter  = 0.5f*(vMin+vMax);
 			mSubsets[currentSubset].mExtents = 0.5f*(vMax-vMin);
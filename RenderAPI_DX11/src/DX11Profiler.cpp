@@ -2,6 +2,7 @@
 #include "Timer.h"
 #include "Memory.h"
 #include "Profiler.h"
+#include "FrameArena.h"
 
 DX11Profiler DX11Profiler::sInstance;
 
@@ -9,6 +10,7 @@ DX11Profiler DX11Profiler::sInstance;
 void DX11Profiler::Initialize( ID3D11Device* device, ID3D11DeviceContext* immContext )
 {
 	mCurrFrame             = 0;
+	mFrameStartTicks       = 0;
 	mCurrDeepFrame         = 0;
 	mTimeWaitingForQueries = 0;
 
@@ -24,9 +26,12 @@ void DX11Profiler::Initialize( ID3D11Device* device, ID3D11DeviceContext* immCon
 //////////////////////////////////////////////////////////////////////////
 void DX11Profiler::StartProfile(const wstring& name)
 {
-	if (Profiler::Instance()->GetState() == PROFILER_STATES::E_NONE)
+	if (Profiler::Instance()->GetState() == PROFILER_STATES::E_NONE && !Profiler::Instance()->IsCapturing())
 		return;
 
+	if (mFrameStartTicks == 0)
+		mFrameStartTicks = Profiler::Ticks();
+
 	ProfileData& profileData = mProfiles[name];
 	RJE_ASSERT(profileData.mQueryStarted  == FALSE);
 	RJE_ASSERT(profileData.mQueryFinished == FALSE);
@@ -79,7 +84,7 @@ void DX11Profiler::StartDeepProfile(const wstring& name)
 //////////////////////////////////////////////////////////////////////////
 void DX11Profiler::EndProfile(const wstring& name)
 {
-	if (Profiler::Instance()->GetState() == PROFILER_STATES::E_NONE)
+	if (Profiler::Instance()->GetState() == PROFILER_STATES::E_NONE && !Profiler::Instance()->IsCapturing())
 		return;
 
 	ProfileData& profileData = mProfiles[name];
@@ -116,14 +121,19 @@ void DX11Profiler::EndDeepProfile(const wstring& name)
 //////////////////////////////////////////////////////////////////////////
 void DX11Profiler::EndFrame()
 {
-	if (Profiler::Instance()->GetState() == PROFILER_STATES::E_NONE)
+	if (Profiler::Instance()->GetState() == PROFILER_STATES::E_NONE && !Profiler::Instance()->IsCapturing())
 	{
 		mTimeWaitingForQueries = 0.0f;
+		mFrameStartTicks       = 0;
 		return;
 	}
 
 	float queryTime = 0.0f;
 
+	// Ranges for the capture's GPU track, in GPU ticks until the whole frame is read
+	struct GpuRange { const wstring* name; u64 start; u64 end; u64 frequency; };
+	FrameVector<GpuRange>::Type gpuRanges;
+
 	// Iterate over all of the profiles
 	ProfileMap::iterator it;
 	for(it = mProfiles.begin(); it != mProfiles.end(); it++)
@@ -158,10 +168,32 @@ void DX11Profiler::EndFrame()
 			u64 delta = endTime - startTime;
 			float frequency = static_cast<float>(disjointData.Frequency);
 			time = (delta / frequency) * 1000.0f;
+
+			GpuRange range = { &(*it).first, startTime, endTime, disjointData.Frequency };
+			gpuRanges.push_back(range);
 		}
 		profile.mElaspedTime = time;
 	}
 	//---------------------------------
+	// The GPU has its own clock: its first range of the frame is laid at the
+	// CPU time of the first StartProfile, the others keep their GPU offsets
+	if (Profiler::Instance()->IsCapturing() && !gpuRanges.empty())
+	{
+		u64 gpuBase = gpuRanges[0].start;
+		for (const GpuRange& range : gpuRanges)
+			gpuBase = RJE::Math::Min(gpuBase, range.start);
+
+		f64 ticksPerMs = Profiler::Instance()->TicksPerMs();
+		for (const GpuRange& range : gpuRanges)
+		{
+			f64 cpuPerGpuTick = ticksPerMs * 1000.0 / range.frequency;
+			u64 start = mFrameStartTicks + static_cast<u64>((range.start - gpuBase) * cpuPerGpuTick);
+			u64 end   = mFrameStartTicks + static_cast<u64>((range.end   - gpuBase) * cpuPerGpuTick);
+			Profiler::Instance()->AddGpuRange(WStringToString(*range.name).c_str(), start, end);
+		}
+	}
+	mFrameStartTicks = 0;
+	//---------------------------------
 	// We check the statistics query only if the profiler is on GPU mode
 	if (Profiler::Instance()->GetState() == PROFILER_STATES::E_GPU)
 	{
@@ -20,6 +20,18 @@ DX11RenderingAPI::DX11RenderingAPI(Scene& scene) : mScene(scene)
 	VSyncEnabled        = false;
 	mbUseFrustumCulling = true;
 	mbUseAABB           = true;
+	mbUseRenderQueue    = true;
+	mbCullShadowCasters = true;
+	mbUseLightClusters  = true;
+	//-----------
+	mLightClusterBuffer = nullptr;
+	mLightIndexBuffer   = nullptr;
+	mLightIndexCapacity = 0;
+	//-----------
+	mAnimationTime         = 0.0f;
+	mPreviousAnimationTime = 0.0f;
+	mSunAngle              = 0.0f;
+	mPreviousSunAngle      = 0.0f;
 	//-----------
 	mConsoleFont  = nullptr;
 	mProfilerFont = nullptr;
@@ -40,8 +52,12 @@ DX11RenderingAPI::DX11RenderingAPI(Scene& scene) : mScene(scene)
 	mBlendFactorA = 1.0f;
 	//-----------
 	mLitBuffer             = nullptr;
-	mShadowEVSMTexture     = nullptr;
 	mShadowEVSMBlurTexture = nullptr;
+	for (u32 p = 0; p < PARTITIONS; ++p)
+	{
+		mShadowEVSMTexture[p] = nullptr;
+		mShadowStaticDepth[p] = nullptr;
+	}
 	//-----------
 	mSDSMPartitions.mPartitionBuffer       = nullptr;
 	mSDSMPartitions.mPartitionBounds       = nullptr;
@@ -57,17 +73,16 @@ DX11RenderingAPI::DX11RenderingAPI(Scene& scene) : mScene(scene)
 	{
 		float radius = RJE::Math::Rand(0.0f, 1.0f);
 		float height = RJE::Math::Rand(0.0f, 1.0f);
-		mPointLightsRadius[i]    = sqrt(radius);
-		mPointLightsHeight[i]    = sqrt(height);
-		mPointLightsAngle[i]     = RJE::Math::Rand(0.0f,RJE::Math::Pi_Two_f);
-		mPointLightsAnimSpeed[i] = RJE::Math::Rand(0.1f,2.0f);
+		mPointLightSet.mOrbitRadius[i] = sqrt(radius);
+		mPointLightSet.mOrbitHeight[i] = sqrt(height);
+		mPointLightSet.mOrbitAngle[i]  = RJE::Math::Rand(0.0f,RJE::Math::Pi_Two_f);
+		mPointLightSet.mOrbitSpeed[i]  = RJE::Math::Rand(0.1f,2.0f);
 		//--------
 		mWorkingDirLights[i].Color     = Vector4(0.5f, 0.5f, 0.5f, 0.0f);
 		mWorkingDirLights[i].Direction = Vector4(0.57735f, -0.57735f, 0.57735f, 0.0f);
 		//--------
-		mWorkingPointLights[i].Color     = Color::GetRandomVector3RGBNorm();
-		mWorkingPointLights[i].Range     = RJE::Math::Rand(1.0f,2.5f);
-		mWorkingPointLights[i].Intensity = mWorkingPointLights[i].Range * 0.4f;
+		float range = RJE::Math::Rand(1.0f,2.5f);
+		mPointLightSet.SetLight(i, Color::GetRandomVector3RGBNorm(), range, range * 0.4f);
 		//--------
 		mWorkingSpotLights[i].Color     = Vector3(0.5f, 0.5f, 0.5f);
 		mWorkingSpotLights[i].Spot      = RJE::Math::Deg2Rad_f * 45.0f;
@@ -110,6 +125,8 @@ void DX11RenderingAPI::Initialize(int windowWidth, int windowHeight)
 		return;
 	}
 
+	mDX11Device->mStateCache.SetContext(mDX11Device->md3dImmediateContext);
+
 	//////////////////////////////////////////////////////////////////////////
 
 	PROFILE_GPU_INIT(mDX11Device->md3dDevice, mDX11Device->md3dImmediateContext);
@@ -187,7 +204,7 @@ void DX11RenderingAPI::Initialize(int windowWidth, int windowHeight)
 	DX11TextureManager::Instance()->Create2DTextureFixedColor(1, RJE_COLOR::Color::TransDarkGray, "_transparentGray");
 	DX11TextureManager::Instance()->Create2DTextureFixedColor(1, RJE_COLOR::Color::White,         "_default");
 	//----------
-	DX11Mesh::SetDevice(mDX11Device->md3dDevice, mDX11Device->md3dImmediateContext);
+	DX11Mesh::SetDevice(mDX11Device->md3dDevice, mDX11Device->md3dImmediateContext, &mDX11Device->mStateCache);
 	DX11Drawable::SetShader(DX11Effects::BasicFX);
 	DX11Drawable::SetShaderGizmo(DX11Effects::ColorFX);
 	//-----------
@@ -222,6 +239,11 @@ void DX11RenderingAPI::Initialize(int windowWidth, int windowHeight)
 	TwAddVarRW(bar, "Use Frustum Culling", TW_TYPE_BOOLCPP, &mbUseFrustumCulling, NULL);
 	TwAddVarRW(bar, "Use AABB",            TW_TYPE_BOOLCPP, &mbUseAABB, NULL);
 	TwAddButton(bar, "Clear Frustum Flags", TwClearFrustumFlags, this, NULL);
+	TwAddVarRW(bar, "Use Render Queue",    TW_TYPE_BOOLCPP, &mbUseRenderQueue, NULL);
+	TwAddVarRW(bar, "Light Clusters",      TW_TYPE_BOOLCPP, &mbUseLightClusters, NULL);
+	TwAddVarRW(bar, "Cull Shadow Casters", TW_TYPE_BOOLCPP, &mbCullShadowCasters, NULL);
+	TwAddVarRW(bar, "Cache Shadow Maps",   TW_TYPE_BOOLCPP, &mShadowCache.mbEnabled, NULL);
+	TwAddVarRW(bar, "Static Shadow Layer", TW_TYPE_BOOLCPP, &mShadowCache.mbUseLayers, NULL);
 	TwAddSeparator(bar, NULL, NULL); //===============================================
 	TwAddButton(bar, "Toggle Wireframe", TwSetWireframe, this, NULL);
 	TwAddSeparator(bar, NULL, NULL); //===============================================
@@ -344,6 +366,22 @@ void DX11RenderingAPI::InitSwapChain(u32 msaaSamples)
 
 //////////////////////////////////////////////////////////////////////////
 void DX11RenderingAPI::UpdateScene( float dt )
+{
+	// The step starts where the last one ended
+	mPreviousAnimationTime = mAnimationTime;
+	mPreviousSunAngle      = mSunAngle;
+
+	mAnimationTime += 0.5f*dt;
+	if (mScene.mbAnimateSun)
+		mSunAngle += 0.1f*dt;
+	if (mPointLightCount > 0)
+		mPointLightSet.Update(0.5f*dt, mScene.mbAnimateLights, mScene.mPointLightRadius, mScene.mPointLightHeight);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Every frame, steps or not: the buffers are in render space, which follows
+// the camera under RJE_DOUBLE_PRECISION
+void DX11RenderingAPI::UpdateFrame( float alpha )
 {
 	// Inputs modifiers : TODO: Get these out of DX11RenderingAPI !
 	if (!Console::Instance()->IsActive())
@@ -360,22 +398,19 @@ void DX11RenderingAPI::UpdateScene( float dt )
 	if (mPointLightUICount != mPointLightCount)			SetActivePointLights(mPointLightUICount);
 	if (mSpotLightUICount  != mSpotLightCount)			SetActiveSpotLights(mSpotLightUICount);
 
-	static float timer = 0.0f;
-	timer += 0.5f*dt;
+	// Alpha 1 is the step itself, to the bit
+	f32 timer    = alpha < 1.0f ? FrameScheduler::Interpolate(mPreviousAnimationTime, mAnimationTime, alpha) : mAnimationTime;
+	f32 sunAngle = alpha < 1.0f ? FrameScheduler::Interpolate(mPreviousSunAngle,      mSunAngle,      alpha) : mSunAngle;
+
+	// The first directional light is the sun used for shadows (i.e. the sun)
+	Vector4 sunDir = Vector4(-1.0f * cosf(sunAngle), -mScene.mSunHeight, -1.0f * sinf(sunAngle), 0.0f);
+	sunDir.Normalize();
+	mWorkingDirLights[0].Direction = sunDir;
 
 	// Copy light list into shader buffer
 	if (mDirLightCount > 0)
 	{
 		DirectionalLight* light = mDirLights->MapDiscard(mDX11Device->md3dImmediateContext);
-
-		// The first directional light is the sun used for shadows (i.e. the sun)
-		static float sunAnimationSpeed = 0.0f;
-		if (mScene.mbAnimateSun)
-			sunAnimationSpeed += 0.1f*dt;
-		
-		Vector4 sunDir = Vector4(-1.0f * cosf(sunAnimationSpeed), -mScene.mSunHeight, -1.0f * sinf(sunAnimationSpeed), 0.0f);
-		sunDir.Normalize();
-		mWorkingDirLights[0].Direction = sunDir;
 		light[0] = mWorkingDirLights[0];
 		for (u32 i = 1; i < mDirLightCount; ++i)
 		{
@@ -388,17 +423,8 @@ void DX11RenderingAPI::UpdateScene( float dt )
 	}
 	if (mPointLightCount > 0)
 	{
-		PointLight* light = mPointLights->MapDiscard(mDX11Device->md3dImmediateContext);
-		for (u32 i = 0; i < mPointLightCount; ++i)
-		{
-			float pointLightSpeed = mScene.mbAnimateLights ? mPointLightsAnimSpeed[i] : 0.0f;
-
-			mWorkingPointLights[i].Position.x = mPointLightsRadius[i] * mScene.mPointLightRadius * cosf(mPointLightsAngle[i] + timer * pointLightSpeed );
-			mWorkingPointLights[i].Position.y = mPointLightsHeight[i] * mScene.mPointLightHeight;
-			mWorkingPointLights[i].Position.z = mPointLightsRadius[i] * mScene.mPointLightRadius * sinf(mPointLightsAngle[i] + timer * pointLightSpeed );
-			light[i] = mWorkingPointLights[i];
-		}
-		mPointLights->Unmap(mDX11Device->md3dImmediateContext);
+		mPointLightSet.Interpolate(alpha);
+		UploadPointLights();
 	}
 	if (mSpotLightCount > 0)
 	{
@@ -409,6 +435,9 @@ void DX11RenderingAPI::UpdateScene( float dt )
 			mWorkingSpotLights[i].Position.y = 2.0f + cosf( timer );
 			mWorkingSpotLights[i].Position.z =(i+1)*sinf(2*i + RJE::Math::Pi_f + timer );
 			light[i] = mWorkingSpotLights[i];
+#if RJE_DOUBLE_PRECISION
+			light[i].Position = Transform::ToRenderSpace(WorldPosition(mWorkingSpotLights[i].Position));
+#endif
 		}
 		mSpotLights->Unmap(mDX11Device->md3dImmediateContext);
 	}
@@ -427,11 +456,17 @@ void DX11RenderingAPI::DrawScene()
 	PROFILE_GPU_START(L"Render Scene");
 	PROFILE_GPU_START_DEEP(L"DEEP Scene");
 
+	// The GUI and the sprite batch of the last frame bound their states behind the cache
+	mDX11Device->mStateCache.Invalidate();
+
 	if (mScene.mbViewLightSpace)
 		ClearFrustumFlags();
 	else if (mbUseFrustumCulling)
 		ComputeFrustumFlags();
 
+	if (mbUseRenderQueue)
+		BuildRenderQueues(mScene.mbDeferredRendering && mScene.mbDisplayShadows && mDirLightCount > 0);
+
 	if (mScene.mbDeferredRendering)
 	{
 		RenderGBuffer();
@@ -447,21 +482,33 @@ void DX11RenderingAPI::DrawScene()
 			PROFILE_GPU_START(L"Render Shadows");
 
 			ID3D11ShaderResourceView* partitionSRV = ComputeSDSMPartitions();
+			mDX11Device->mStateCache.Invalidate();	// the SDSM reductions use the context directly
+			CullShadowCasters();
+			u64 partitionKey = ShadowPartitionKey();
 			for (u32 partitionIndex = 0; partitionIndex < PARTITIONS; ++partitionIndex)
 			{
-				RenderShadowDepth(partitionSRV, partitionIndex);
-				//RenderScreenQuad(mShadowDepthTexture->GetShaderResource(), true, mShadowTextureDim, mShadowTextureDim);
-				ConvertToEVSM(mShadowDepthTexture->GetShaderResource(), mShadowEVSMTexture->GetRenderTarget(0), partitionSRV, partitionIndex);
-				if (mScene.mbEdgeSoftening)
+				Texture2D* evsmTexture = mShadowEVSMTexture[partitionIndex];
+
+				// Nothing it depends on changed: last frame's EVSM map is still right
+				ShadowCacheAction action = mShadowCache.Update(partitionIndex, partitionKey);
+				if (action != ShadowCache_Reuse)
 				{
-					Vector2 blurSizeLightSpace(0.0f, 0.0f);
-					blurSizeLightSpace.x = mScene.mEdgeSofteningAmount * 0.5f * mShadowCamera->mOrthoProj.m11;
-					blurSizeLightSpace.y = mScene.mEdgeSofteningAmount * 0.5f * mShadowCamera->mOrthoProj.m22;
-					BoxBlur(mShadowEVSMTexture, 0, mShadowEVSMBlurTexture, partitionIndex, partitionSRV, blurSizeLightSpace);
+					RenderShadowDepth(partitionSRV, partitionIndex, action);
+					//RenderScreenQuad(mShadowDepthTexture->GetShaderResource(), true, mShadowTextureDim, mShadowTextureDim);
+					ConvertToEVSM(mShadowDepthTexture->GetShaderResource(), evsmTexture->GetRenderTarget(0), partitionSRV, partitionIndex);
+					if (mScene.mbEdgeSoftening)
+					{
+						Vector2 blurSizeLightSpace(0.0f, 0.0f);
+						blurSizeLightSpace.x = mScene.mEdgeSofteningAmount * 0.5f * mShadowCamera->mOrthoProj.m11;
+						blurSizeLightSpace.y = mScene.mEdgeSofteningAmount * 0.5f * mShadowCamera->mOrthoProj.m22;
+						BoxBlur(evsmTexture, 0, mShadowEVSMBlurTexture, partitionIndex, partitionSRV, blurSizeLightSpace);
+					}
+					mDX11Device->md3dImmediateContext->GenerateMips(evsmTexture->GetShaderResource());
 				}
-				mDX11Device->md3dImmediateContext->GenerateMips(mShadowEVSMTexture->GetShaderResource());
-				AccumulateLighting(mBackbufferRTV, mShadowEVSMTexture->GetShaderResource(), partitionSRV, partitionIndex);
+				AccumulateLighting(mBackbufferRTV, evsmTexture->GetShaderResource(), partitionSRV, partitionIndex);
 			}
+			Profiler::Instance()->mProfilerInfos->ShadowPartitionsReused   = mShadowCache.mReused;
+			Profiler::Instance()->mProfilerInfos->ShadowStaticLayersReused = mShadowCache.mStaticReused;
 
 			PROFILE_GPU_END(L"Render Shadows");
 		}
@@ -473,8 +520,8 @@ void DX11RenderingAPI::DrawScene()
 	}
 
 	float blendFactor[4] = {mBlendFactorR, mBlendFactorG, mBlendFactorB, mBlendFactorA};
-	mDX11Device->md3dImmediateContext->RSSetState(DX11CommonStates::sRasterizerState_Solid);
-	mDX11Device->md3dImmediateContext->OMSetBlendState(DX11CommonStates::sBlendState_AlphaToCoverage, blendFactor, 0xffffffff);
+	mDX11Device->mStateCache.RSSetState(DX11CommonStates::sRasterizerState_Solid);
+	mDX11Device->mStateCache.OMSetBlendState(DX11CommonStates::sBlendState_AlphaToCoverage, blendFactor, 0xffffffff);
 
 	if (Console::Instance()->IsActive())
 		DrawConsole();
@@ -489,6 +536,9 @@ void DX11RenderingAPI::DrawScene()
 	PROFILE_GPU_END_DEEP(L"DEEP Scene");
 	PROFILE_GPU_END_FRAME();
 
+	mDX11Device->mStateCache.mStats.FillProfilerInfos(Profiler::Instance()->mProfilerInfos);
+	mDX11Device->mStateCache.mStats.Reset();
+
 	//-------------------------------------------------------------------------
 
 	// Draw the AntTweak GUI
@@ -513,19 +563,22 @@ void DX11RenderingAPI::RenderForward()
 	PROFILE_CPU("Render Forward");
 	PROFILE_GPU_START(L"Render Forward");
 
-	mDX11Device->md3dImmediateContext->OMSetRenderTargets(1, &mBackbufferRTV, mDepthBuffer->GetDepthStencil());
+	// New per pass constants: the first draw must apply
+	mDX11Device->mStateCache.Invalidate();
+
+	mDX11Device->mStateCache.OMSetRenderTargets(1, &mBackbufferRTV, mDepthBuffer->GetDepthStencil());
 	mDX11Device->md3dImmediateContext->ClearRenderTargetView(mBackbufferRTV, DirectX::Colors::Black);
 	mDX11Device->md3dImmediateContext->ClearDepthStencilView(mDepthBuffer->GetDepthStencil(), D3D11_CLEAR_DEPTH|D3D11_CLEAR_STENCIL, 1.0f, 0);
 
 	DrawGizmos();
 
 	//-------------------------------------------------------------------------
-	mDX11Device->md3dImmediateContext->IASetInputLayout(DX11InputLayouts::PosNormalTanTex);
-	mDX11Device->md3dImmediateContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	mDX11Device->mStateCache.IASetInputLayout(DX11InputLayouts::PosNormalTanTex);
+	mDX11Device->mStateCache.IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
 	float blendFactor[4] = {mBlendFactorR, mBlendFactorG, mBlendFactorB, mBlendFactorA};
 
-	mDX11Device->md3dImmediateContext->RSSetState(DX11CommonStates::sCurrentRasterizerState);
+	mDX11Device->mStateCache.RSSetState(DX11CommonStates::sCurrentRasterizerState);
 
 	// Set constants
 	Matrix44 view;
@@ -545,7 +598,7 @@ void DX11RenderingAPI::RenderForward()
 	DX11Effects::BasicFX->SetView(view);
 	DX11Effects::BasicFX->SetViewProj(view*proj);
 	DX11Effects::BasicFX->SetProj(proj);
-	DX11Effects::BasicFX->SetEyePosW(mCamera->mTrf.Position);
+	DX11Effects::BasicFX->SetEyePosW(Transform::ToRenderSpace(mCamera->mTrf.Position));
 	DX11Effects::BasicFX->UseFaceNormals(mScene.mbUseFaceNormals);
 	DX11Effects::BasicFX->SetAmbientLight(mScene.mAmbientLightColor);
 	DX11Effects::BasicFX->SetSamplerState(DX11CommonStates::sCurrentSamplerState);
@@ -559,6 +612,15 @@ void DX11RenderingAPI::RenderForward()
 	DX11Effects::BasicFX->SetPointLights(mPointLights->GetShaderResource());
 	DX11Effects::BasicFX->SetSpotLights(mSpotLights->GetShaderResource());
 
+	BOOL bLightClusters = BuildLightClusters();
+	DX11Effects::BasicFX->UseLightClusters(bLightClusters);
+	if (bLightClusters)
+	{
+		DX11Effects::BasicFX->SetLightClusters(mLightClusterBuffer->GetShaderResource(), mLightIndexBuffer->GetShaderResource());
+		DX11Effects::BasicFX->SetLightClusterGrid(	mLightClusters.mTileSize, mLightClusters.mTilesX, mLightClusters.mTilesY,
+													mLightClusters.mSlices, mLightClusters.mSliceScale, mLightClusters.mSliceBias);
+	}
+
 	ID3DX11EffectTechnique* activeTech = DX11Effects::BasicFX->BasicTech;
 
 	D3DX11_TECHNIQUE_DESC techDesc;
@@ -566,21 +628,26 @@ void DX11RenderingAPI::RenderForward()
 	activeTech->GetDesc( &techDesc );
 	for(u32 p = 0; p < techDesc.Passes; ++p)
 	{
-		// Draw the opaque geometry
-		for(const unique_ptr<GameObject>& gameobject : mScene.mGameObjects)
-		{
-			if (gameobject->mDrawable.mMesh)
-				gameobject->mDrawable.Render(activeTech->GetPassByIndex(p));
-		}
-		// Draw the transparent geometry
-		for(const unique_ptr<GameObject>& gameobject_transparent : mScene.mGameObjects)
+		if (mbUseRenderQueue)
+			SubmitRenderQueue(activeTech->GetPassByIndex(p));
+		else
 		{
-			if (mScene.mbUseBlending)
-				mDX11Device->md3dImmediateContext->RSSetState(DX11CommonStates::sRasterizerState_CullNone);
-			//mDX11Device->md3dImmediateContext->OMSetBlendState(DX11CommonStates::sCurrentBlendState, blendFactor, 0xffffffff);
+			// Draw the opaque geometry
+			for(const unique_ptr<GameObject>& gameobject : mScene.mGameObjects)
+			{
+				if (gameobject->mDrawable.mMesh)
+					gameobject->mDrawable.Render(activeTech->GetPassByIndex(p));
+			}
+			// Draw the transparent geometry
+			for(const unique_ptr<GameObject>& gameobject_transparent : mScene.mGameObjects)
+			{
+				if (mScene.mbUseBlending)
+					mDX11Device->mStateCache.RSSetState(DX11CommonStates::sRasterizerState_CullNone);
+				//mDX11Device->md3dImmediateContext->OMSetBlendState(DX11CommonStates::sCurrentBlendState, blendFactor, 0xffffffff);
 
-			if (gameobject_transparent->mDrawable.mMesh)
-				gameobject_transparent->mDrawable.Render(activeTech->GetPassByIndex(p), false);
+				if (gameobject_transparent->mDrawable.mMesh)
+					gameobject_transparent->mDrawable.Render(activeTech->GetPassByIndex(p), false);
+			}
 		}
 
 		// Render the light sphere if requested
@@ -588,8 +655,8 @@ void DX11RenderingAPI::RenderForward()
 		if (mScene.mbDrawSun)			DrawLightSpheres(activeTech, p, true);
 
 		// Restore default render states
-		mDX11Device->md3dImmediateContext->RSSetState(DX11CommonStates::sCurrentRasterizerState);
-		mDX11Device->md3dImmediateContext->OMSetBlendState(0, blendFactor, 0xffffffff);
+		mDX11Device->mStateCache.RSSetState(DX11CommonStates::sCurrentRasterizerState);
+		mDX11Device->mStateCache.OMSetBlendState(0, blendFactor, 0xffffffff);
 	}
 
 	PROFILE_GPU_END(L"Render Forward");
@@ -601,17 +668,20 @@ void DX11RenderingAPI::RenderGBuffer()
 	PROFILE_CPU("Render G Buffer");
 	PROFILE_GPU_START(L"Render G Buffer");
 
-	mDX11Device->md3dImmediateContext->OMSetRenderTargets(static_cast<u32>(mGBufferRTV.size()), &mGBufferRTV.front(), mDepthBuffer->GetDepthStencil());
+	// New per pass constants: the first draw must apply
+	mDX11Device->mStateCache.Invalidate();
+
+	mDX11Device->mStateCache.OMSetRenderTargets(static_cast<u32>(mGBufferRTV.size()), &mGBufferRTV.front(), mDepthBuffer->GetDepthStencil());
 	for (ID3D11RenderTargetView* rtv : mGBufferRTV)
 		mDX11Device->md3dImmediateContext->ClearRenderTargetView(rtv, DirectX::Colors::Black);
 	mDX11Device->md3dImmediateContext->ClearDepthStencilView(mDepthBuffer->GetDepthStencil(), D3D11_CLEAR_DEPTH|D3D11_CLEAR_STENCIL, 1.0f, 0);
 
-	mDX11Device->md3dImmediateContext->IASetInputLayout(DX11InputLayouts::PosNormalTanTex);
-	mDX11Device->md3dImmediateContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	mDX11Device->mStateCache.IASetInputLayout(DX11InputLayouts::PosNormalTanTex);
+	mDX11Device->mStateCache.IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
 	float blendFactor[4] = {mBlendFactorR, mBlendFactorG, mBlendFactorB, mBlendFactorA};
 
-	mDX11Device->md3dImmediateContext->RSSetState(DX11CommonStates::sCurrentRasterizerState);
+	mDX11Device->mStateCache.RSSetState(DX11CommonStates::sCurrentRasterizerState);
 
 	// Set constants
 	Matrix44 view;
@@ -632,7 +702,7 @@ void DX11RenderingAPI::RenderGBuffer()
 	DX11Effects::BasicFX->SetView(view);
 	DX11Effects::BasicFX->SetProj(proj);
 	DX11Effects::BasicFX->SetSamplerState(DX11CommonStates::sCurrentSamplerState);
-	DX11Effects::BasicFX->SetEyePosW(mCamera->mTrf.Position);
+	DX11Effects::BasicFX->SetEyePosW(Transform::ToRenderSpace(mCamera->mTrf.Position));
 	DX11Effects::BasicFX->SetFogColor(    mScene.mFogColor);
 	DX11Effects::BasicFX->SetFogStart(    mScene.mFogStart);
 	DX11Effects::BasicFX->SetFogRange(    mScene.mFogRange);
@@ -648,21 +718,26 @@ void DX11RenderingAPI::RenderGBuffer()
 	activeTech->GetDesc( &techDesc );
 	for(u32 p = 0; p < techDesc.Passes; ++p)
 	{
-		// Draw the opaque geometry
-		for(const unique_ptr<GameObject>& gameobject : mScene.mGameObjects)
-		{
-			if (gameobject->mDrawable.mMesh)
-				gameobject->mDrawable.Render(activeTech->GetPassByIndex(p));
-		}
-		// Draw the transparent geometry
-		for(const unique_ptr<GameObject>& gameobject_transparent : mScene.mGameObjects)
+		if (mbUseRenderQueue)
+			SubmitRenderQueue(activeTech->GetPassByIndex(p));
+		else
 		{
-			if (mScene.mbUseBlending)
-				mDX11Device->md3dImmediateContext->RSSetState(DX11CommonStates::sRasterizerState_CullNone);
-			//mDX11Device->md3dImmediateContext->OMSetBlendState(DX11CommonStates::sCurrentBlendState, blendFactor, 0xffffffff);
+			// Draw the opaque geometry
+			for(const unique_ptr<GameObject>& gameobject : mScene.mGameObjects)
+			{
+				if (gameobject->mDrawable.mMesh)
+					gameobject->mDrawable.Render(activeTech->GetPassByIndex(p));
+			}
+			// Draw the transparent geometry
+			for(const unique_ptr<GameObject>& gameobject_transparent : mScene.mGameObjects)
+			{
+				if (mScene.mbUseBlending)
+					mDX11Device->mStateCache.RSSetState(DX11CommonStates::sRasterizerState_CullNone);
+				//mDX11Device->md3dImmediateContext->OMSetBlendState(DX11CommonStates::sCurrentBlendState, blendFactor, 0xffffffff);
 
-			if (gameobject_transparent->mDrawable.mMesh)
-				gameobject_transparent->mDrawable.Render(activeTech->GetPassByIndex(p), false);
+				if (gameobject_transparent->mDrawable.mMesh)
+					gameobject_transparent->mDrawable.Render(activeTech->GetPassByIndex(p), false);
+			}
 		}
 
 		// Render the light spheres if requested
@@ -670,13 +745,13 @@ void DX11RenderingAPI::RenderGBuffer()
 		if (mScene.mbDrawSun)			DrawLightSpheres(activeTech, p, true);
 
 		// Restore default render states
-		mDX11Device->md3dImmediateContext->RSSetState(DX11CommonStates::sCurrentRasterizerState);
-		mDX11Device->md3dImmediateContext->OMSetBlendState(0, blendFactor, 0xffffffff);
+		mDX11Device->mStateCache.RSSetState(DX11CommonStates::sCurrentRasterizerState);
+		mDX11Device->mStateCache.OMSetBlendState(0, blendFactor, 0xffffffff);
 	}
 
-	mDX11Device->md3dImmediateContext->OMSetRenderTargets(1, &mBackbufferRTV, 0);
+	mDX11Device->mStateCache.OMSetRenderTargets(1, &mBackbufferRTV, 0);
 	mDX11Device->md3dImmediateContext->ClearRenderTargetView(mBackbufferRTV, DirectX::Colors::Black);
-	mDX11Device->md3dImmediateContext->RSSetState(DX11CommonStates::sRasterizerState_Solid);
+	mDX11Device->mStateCache.RSSetState(DX11CommonStates::sRasterizerState_Solid);
 
 	PROFILE_GPU_END(L"Render G Buffer");
 }
@@ -690,7 +765,7 @@ void DX11RenderingAPI::ComputeLighting()
 	Matrix44 view     = mCamera->mView;
 	Matrix44 proj     = *(mCamera->mCurrentProjectionMatrix);
 
-	DX11Effects::TiledDeferredFX->SetEyePosW(mCamera->mTrf.Position);
+	DX11Effects::TiledDeferredFX->SetEyePosW(Transform::ToRenderSpace(mCamera->mTrf.Position));
 	DX11Effects::TiledDeferredFX->SetNearFar(Vector2(mCamera->mSettings.NearZ, mCamera->mSettings.FarZ));
 	DX11Effects::TiledDeferredFX->SetView(view);
 	DX11Effects::TiledDeferredFX->SetProj(proj);
@@ -707,10 +782,10 @@ void DX11RenderingAPI::ComputeLighting()
 	DX11Effects::TiledDeferredFX->SetFrameBufferSize(mWindowWidth, mWindowHeight);
 	DX11Effects::TiledDeferredFX->SetGBuffer(mGBufferSRV);
 
-	DX11Effects::TiledDeferredFX->TiledDeferredTech->GetPassByIndex(0)->Apply(0, mDX11Device->md3dImmediateContext);
+	mDX11Device->mStateCache.Apply(DX11Effects::TiledDeferredFX->TiledDeferredTech->GetPassByIndex(0));
 
 	ID3D11UnorderedAccessView *litBufferUAV = mLitBuffer->GetUnorderedAccess();
-	mDX11Device->md3dImmediateContext->CSSetUnorderedAccessViews(0, 1, &litBufferUAV, 0);
+	mDX11Device->mStateCache.CSSetUnorderedAccessViews(0, 1, &litBufferUAV, 0);
 
 	u32 dispatchWidth  = (mWindowWidth  + COMPUTE_SHADER_TILE_GROUP_DIM - 1) / COMPUTE_SHADER_TILE_GROUP_DIM;
 	u32 dispatchHeight = (mWindowHeight + COMPUTE_SHADER_TILE_GROUP_DIM - 1) / COMPUTE_SHADER_TILE_GROUP_DIM;
@@ -723,7 +798,7 @@ void DX11RenderingAPI::ComputeLighting()
 	// Unbind output from compute shader (we are going to use this output as an input in the next pass, 
 	// and a resource cannot be both an output and input at the same time.
 	ID3D11UnorderedAccessView* nullUAV[1] = { 0 };
-	mDX11Device->md3dImmediateContext->CSSetUnorderedAccessViews( 0, 1, nullUAV, 0 );
+	mDX11Device->mStateCache.CSSetUnorderedAccessViews( 0, 1, nullUAV, 0 );
 
 	PROFILE_GPU_END(L"Compute Lighting");
 }
@@ -737,9 +812,9 @@ void DX11RenderingAPI::RenderScreenQuad(ID3D11ShaderResourceView* srv, BOOL bMul
 	UINT stride = sizeof(PosNormTanTex);
 	UINT offset = 0;
 
-	mDX11Device->md3dImmediateContext->OMSetRenderTargets(1, &mBackbufferRTV, 0);
+	mDX11Device->mStateCache.OMSetRenderTargets(1, &mBackbufferRTV, 0);
 	mDX11Device->md3dImmediateContext->ClearRenderTargetView(mBackbufferRTV, DirectX::Colors::Black);
-	mDX11Device->md3dImmediateContext->RSSetState(DX11CommonStates::sRasterizerState_Solid);
+	mDX11Device->mStateCache.RSSetState(DX11CommonStates::sRasterizerState_Solid);
 
 	ID3DX11EffectTechnique* PostProcessTech;
 	if (bMultiSampled)
@@ -759,15 +834,15 @@ void DX11RenderingAPI::RenderScreenQuad(ID3D11ShaderResourceView* srv, BOOL bMul
 	PostProcessTech->GetDesc( &techDesc );
 	for(UINT p = 0; p < techDesc.Passes; ++p)
 	{
-		mDX11Device->md3dImmediateContext->IASetVertexBuffers(0, 1, &mScreenQuadVB, &stride, &offset);
-		mDX11Device->md3dImmediateContext->IASetIndexBuffer(mScreenQuadIB, DXGI_FORMAT_R32_UINT, 0);
+		mDX11Device->mStateCache.IASetVertexBuffers(0, 1, &mScreenQuadVB, &stride, &offset);
+		mDX11Device->mStateCache.IASetIndexBuffer(mScreenQuadIB, DXGI_FORMAT_R32_UINT, 0);
 
-		PostProcessTech->GetPassByIndex(p)->Apply(0, mDX11Device->md3dImmediateContext);
+		mDX11Device->mStateCache.Apply(PostProcessTech->GetPassByIndex(p));
 		mDX11Device->md3dImmediateContext->DrawIndexed(6, 0, 0);
 	}
 
 	ID3D11ShaderResourceView* nullSRV[1] = { 0 };
-	mDX11Device->md3dImmediateContext->PSSetShaderResources( 0, 1, nullSRV);
+	mDX11Device->mStateCache.PSSetShaderResources( 0, 1, nullSRV);
 
 	PROFILE_GPU_END(L"Render Post Process");
 }
@@ -778,7 +853,7 @@ void DX11RenderingAPI::RenderSkybox(BOOL deferredRendering)
 	PROFILE_CPU("Render Skybox");
 	PROFILE_GPU_START(L"Render Skybox");
 
-	Vector3 eyePos = mCamera->mTrf.Position;
+	Vector3 eyePos = Transform::ToRenderSpace(mCamera->mTrf.Position);
 	Matrix44 T = Matrix44::Translation(eyePos);
 
 	Matrix44 view = mCamera->mView;
@@ -787,10 +862,10 @@ void DX11RenderingAPI::RenderSkybox(BOOL deferredRendering)
 
 	u32 stride = sizeof(PosNormTanTex);
 	u32 offset = 0;
-	mDX11Device->md3dImmediateContext->IASetVertexBuffers(0, 1, &mSkyboxVB, &stride, &offset);
-	mDX11Device->md3dImmediateContext->IASetIndexBuffer(mSkyboxIB, DXGI_FORMAT_R32_UINT, 0);
-	mDX11Device->md3dImmediateContext->IASetInputLayout(DX11InputLayouts::PosNormalTanTex);
-	mDX11Device->md3dImmediateContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	mDX11Device->mStateCache.IASetVertexBuffers(0, 1, &mSkyboxVB, &stride, &offset);
+	mDX11Device->mStateCache.IASetIndexBuffer(mSkyboxIB, DXGI_FORMAT_R32_UINT, 0);
+	mDX11Device->mStateCache.IASetInputLayout(DX11InputLayouts::PosNormalTanTex);
+	mDX11Device->mStateCache.IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
 	D3DX11_TECHNIQUE_DESC techDesc;
 	ID3DX11EffectTechnique* skyboxTech;
@@ -820,39 +895,45 @@ void DX11RenderingAPI::RenderSkybox(BOOL deferredRendering)
 	{
 		ID3DX11EffectPass* pass = skyboxTech->GetPassByIndex(p);
 
-		pass->Apply(0, mDX11Device->md3dImmediateContext);
+		mDX11Device->mStateCache.Apply(pass);
 
 		mDX11Device->md3dImmediateContext->DrawIndexed(36, 0, 0);
 	}
 
 	ID3D11ShaderResourceView* nullSRV[6] = { 0, 0, 0, 0, 0, 0 };
-	mDX11Device->md3dImmediateContext->PSSetShaderResources( 0, 6, nullSRV );
+	mDX11Device->mStateCache.PSSetShaderResources( 0, 6, nullSRV );
 	
 	PROFILE_GPU_END(L"Render Skybox");
 }
 
 //////////////////////////////////////////////////////////////////////////
-void DX11RenderingAPI::RenderShadowDepth(ID3D11ShaderResourceView* partitionSRV, u32 currentPartition)
+void DX11RenderingAPI::RenderShadowDepth(ID3D11ShaderResourceView* partitionSRV, u32 currentPartition, ShadowCacheAction action)
 {
-	// Clear shadow depth buffer
-	mDX11Device->md3dImmediateContext->ClearDepthStencilView(mShadowDepthTexture->GetDepthStencil(), D3D11_CLEAR_DEPTH, 1.0f, 0);
+	// New per partition constants: the first draw must apply
+	mDX11Device->mStateCache.Invalidate();
+
+	// Start from the cached static layer, or clear shadow depth buffer
+	if (action == ShadowCache_DynamicOnly)
+		mDX11Device->md3dImmediateContext->CopyResource(mShadowDepthTexture->GetTexture(), mShadowStaticDepth[currentPartition]->GetTexture());
+	else
+		mDX11Device->md3dImmediateContext->ClearDepthStencilView(mShadowDepthTexture->GetDepthStencil(), D3D11_CLEAR_DEPTH, 1.0f, 0);
 
-	mDX11Device->md3dImmediateContext->IASetInputLayout(DX11InputLayouts::PosNormalTanTex);
+	mDX11Device->mStateCache.IASetInputLayout(DX11InputLayouts::PosNormalTanTex);
 
 	//mDX11Device->md3dImmediateContext->RSSetState(DX11CommonStates::sRasterizerState_ShadowMap);		// directly set in the shader
 	mDX11Device->md3dImmediateContext->RSSetViewports(1, &mShadowViewport);
 
-	mDX11Device->md3dImmediateContext->OMSetRenderTargets(0, 0, mShadowDepthTexture->GetDepthStencil());
+	mDX11Device->mStateCache.OMSetRenderTargets(0, 0, mShadowDepthTexture->GetDepthStencil());
 	//mDX11Device->md3dImmediateContext->OMSetBlendState(DX11CommonStates::sBlendState_AlphaToCoverage, 0, 0xFFFFFFFF);
-	mDX11Device->md3dImmediateContext->OMSetBlendState(0, 0, 0xFFFFFFFF);
+	mDX11Device->mStateCache.OMSetBlendState(0, 0, 0xFFFFFFFF);
 
 	//-------------------------------------------------------------------------
-	mDX11Device->md3dImmediateContext->IASetInputLayout(DX11InputLayouts::PosNormalTanTex);
-	mDX11Device->md3dImmediateContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	mDX11Device->mStateCache.IASetInputLayout(DX11InputLayouts::PosNormalTanTex);
+	mDX11Device->mStateCache.IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
 	float blendFactor[4] = {mBlendFactorR, mBlendFactorG, mBlendFactorB, mBlendFactorA};
 
-	mDX11Device->md3dImmediateContext->RSSetState(DX11CommonStates::sCurrentRasterizerState);
+	mDX11Device->mStateCache.RSSetState(DX11CommonStates::sCurrentRasterizerState);
 
 	// Set constants
 	Matrix44 view= mShadowCamera->mView;
@@ -862,34 +943,61 @@ void DX11RenderingAPI::RenderShadowDepth(ID3D11ShaderResourceView* partitionSRV,
 	DX11Effects::ShadowMapFX->SetCurrentPartitions(currentPartition);
 	ID3DX11EffectTechnique* activeTech = DX11Effects::ShadowMapFX->ShadowMapTech;
 
+	if (!mShadowCache.UsesLayers())
+		DrawShadowCasters(activeTech, view*proj, currentPartition, ShadowLayer_All);
+	else
+	{
+		// The static casters are kept aside before the dynamic ones are drawn on top
+		if (action == ShadowCache_RenderAll)
+		{
+			DrawShadowCasters(activeTech, view*proj, currentPartition, ShadowLayer_Static);
+			mDX11Device->md3dImmediateContext->CopyResource(mShadowStaticDepth[currentPartition]->GetTexture(), mShadowDepthTexture->GetTexture());
+		}
+		DrawShadowCasters(activeTech, view*proj, currentPartition, ShadowLayer_Dynamic);
+	}
+
+	//-------------------------------------------------------------------------
+
+	mDX11Device->mStateCache.OMSetBlendState(0, blendFactor, 0xffffffff);
+	mDX11Device->mStateCache.OMSetRenderTargets(1, &mBackbufferRTV, 0);
+	mDX11Device->mStateCache.RSSetState(DX11CommonStates::sCurrentRasterizerState);
+	mDX11Device->md3dImmediateContext->RSSetViewports(1, &mScreenViewport);
+
+	ID3D11ShaderResourceView* dummySRV[1] = {0};
+	mDX11Device->md3dImmediateContext->VSSetShaderResources(0, 1, dummySRV);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// The subsets of the given layers that CullShadowCasters() kept for this partition
+void DX11RenderingAPI::DrawShadowCasters(ID3DX11EffectTechnique* tech, const Matrix44& viewProj, u32 currentPartition, u32 layers)
+{
 	D3DX11_TECHNIQUE_DESC techDesc;
 
-	activeTech->GetDesc( &techDesc );
+	tech->GetDesc( &techDesc );
 	for(u32 p = 0; p < techDesc.Passes; ++p)
 	{
-		for(const unique_ptr<GameObject>& gameobject : mScene.mGameObjects)
+		if (mbUseRenderQueue)
+		{
+			SubmitShadowQueue(tech->GetPassByIndex(p), viewProj, currentPartition, layers);
+			continue;
+		}
+
+		for (u32 iObject = 0; iObject < (u32)mScene.mGameObjects.size(); ++iObject)
 		{
-			if (gameobject->mDrawable.mMesh)
+			const unique_ptr<GameObject>& gameobject = mScene.mGameObjects[iObject];
+			if (gameobject->mDrawable.mMesh && (mShadowCache.Layer(iObject) & layers))
 			{
-				DX11Effects::ShadowMapFX->SetWorldViewProj(gameobject->mTransform.WorldMat*view*proj);
+				DX11Effects::ShadowMapFX->SetWorldViewProj(gameobject->mTransform.WorldMat*viewProj);
 				for (u32 iSubset=0 ; iSubset<gameobject->mDrawable.mMesh->mSubsetCount; ++iSubset)
 				{
-					RJE_CHECK_FOR_SUCCESS(activeTech->GetPassByIndex(p)->Apply(NULL, gameobject->mDrawable.mMesh->sDeviceContext));
+					if (!(gameobject->mDrawable.mMesh->mSubsets[iSubset].mShadowPartitions & (1u << currentPartition)))
+						continue;
+					RJE_CHECK_FOR_SUCCESS(mDX11Device->mStateCache.Apply(tech->GetPassByIndex(p)));
 					gameobject->mDrawable.mMesh->Render(iSubset);
 				}
 			}
 		}
 	}
-
-	//-------------------------------------------------------------------------
-
-	mDX11Device->md3dImmediateContext->OMSetBlendState(0, blendFactor, 0xffffffff);
-	mDX11Device->md3dImmediateContext->OMSetRenderTargets(1, &mBackbufferRTV, 0);
-	mDX11Device->md3dImmediateContext->RSSetState(DX11CommonStates::sCurrentRasterizerState);
-	mDX11Device->md3dImmediateContext->RSSetViewports(1, &mScreenViewport);
-
-	ID3D11ShaderResourceView* dummySRV[1] = {0};
-	mDX11Device->md3dImmediateContext->VSSetShaderResources(0, 1, dummySRV);
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -930,14 +1038,95 @@ ID3D11ShaderResourceView* DX11RenderingAPI::ComputeSDSMPartitions()
 	return partitions;
 }
 
+//////////////////////////////////////////////////////////////////////////
+// Sets each subset's mShadowPartitions. The partitions live on the GPU and
+// come back a frame or two late, so their volumes are grown by a margin and
+// kept until the next readback lands. Until the first one, nothing is culled.
+void DX11RenderingAPI::CullShadowCasters()
+{
+	PROFILE_CPU("Cull Shadow Casters");
+
+	ShadowPartition partitions[PARTITIONS];
+	if (!mbCullShadowCasters)
+		mShadowCasterCuller.Invalidate();
+	else if (mSDSMPartitions.ReadbackPartitions(mDX11Device->md3dImmediateContext, partitions))
+		mShadowCasterCuller.SetPartitions(partitions, 0.1f);
+
+	mShadowCasterCuller.ResetStats();
+	mShadowCache.BeginFrame((u32)mScene.mGameObjects.size());
+	Matrix44 lightViewProj = mShadowCamera->mView*mShadowCamera->mOrthoProj;
+
+	for (u32 iObject = 0; iObject < (u32)mScene.mGameObjects.size(); ++iObject)
+	{
+		const unique_ptr<GameObject>& gameobject = mScene.mGameObjects[iObject];
+		DX11Mesh* mesh = gameobject->mDrawable.mMesh;
+		if (mesh == nullptr)
+			continue;
+
+		mShadowCache.UpdateCaster(iObject, gameobject->mTransform.WorldMat);
+
+		Matrix44 worldLightViewProj = gameobject->mTransform.WorldMat*lightViewProj;
+		for (u32 iSubset=0 ; iSubset<mesh->mSubsetCount; ++iSubset)
+		{
+			Mesh::Subset& subset = mesh->mSubsets[iSubset];
+			subset.mShadowPartitions = mShadowCasterCuller.AddCaster(ShadowCasterCuller::CasterBounds(subset.mCenter, subset.mExtents, worldLightViewProj));
+			mShadowCache.AddCaster(iObject, iSubset, subset.mShadowPartitions);
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Everything the GPU partitions and the EVSM conversion depend on: the
+// cameras, the SDSM and EVSM settings, and the visible objects (they make
+// the depth buffer the partitions are reduced from). Shared by all partitions.
+u64 DX11RenderingAPI::ShadowPartitionKey()
+{
+	StateHash key;
+	key.Add(mShadowCamera->mView);
+	key.Add(mShadowCamera->mOrthoProj);
+	key.Add(mCamera->mView);
+	key.Add(*mCamera->mCurrentProjectionMatrix);
+	key.Add(mWindowWidth);
+	key.Add(mWindowHeight);
+	key.Add(mSDSMPartitions.mCurrentConstants.mLightSpaceBorder);
+	key.Add(mSDSMPartitions.mCurrentConstants.mMaxScale);
+	key.Add(mSDSMPartitions.mCurrentConstants.mDilationFactor);
+	key.Add(mScene.mbUsePositiveExponent);
+	key.Add(mScene.mbUseNegativeExponent);
+	key.Add(mScene.mPositiveExponent);
+	key.Add(mScene.mNegativeExponent);
+	key.Add(mScene.mbEdgeSoftening);
+	key.Add(mScene.mEdgeSofteningAmount);
+	key.Add(mScene.mMaxEdgeSofteningFilter);
+
+	for (u32 iObject = 0; iObject < (u32)mScene.mGameObjects.size(); ++iObject)
+	{
+		const unique_ptr<GameObject>& gameobject = mScene.mGameObjects[iObject];
+		DX11Mesh* mesh = gameobject->mDrawable.mMesh;
+		if (mesh == nullptr)
+			continue;
+
+		for (u32 iSubset=0 ; iSubset<mesh->mSubsetCount; ++iSubset)
+		{
+			if (mesh->mSubsets[iSubset].mbIsInFrustum)
+			{
+				key.Add(iObject);
+				key.Add(gameobject->mTransform.WorldMat);
+				break;
+			}
+		}
+	}
+	return key.mValue;
+}
+
 //////////////////////////////////////////////////////////////////////////
 void DX11RenderingAPI::ConvertToEVSM( ID3D11ShaderResourceView* depthInput, ID3D11RenderTargetView* evsmOutput, ID3D11ShaderResourceView* partitionSRV, u32 partitionIndex)
 {
 	UINT stride = sizeof(PosNormTanTex);
 	UINT offset = 0;
 
-	mDX11Device->md3dImmediateContext->OMSetRenderTargets(1, &evsmOutput, 0);
-	mDX11Device->md3dImmediateContext->RSSetState(DX11CommonStates::sRasterizerState_Solid);
+	mDX11Device->mStateCache.OMSetRenderTargets(1, &evsmOutput, 0);
+	mDX11Device->mStateCache.RSSetState(DX11CommonStates::sRasterizerState_Solid);
 	mDX11Device->md3dImmediateContext->RSSetViewports(1, &mShadowViewport);
 
 	DX11Effects::EVSMConvertFX->SetShadowMap(depthInput);
@@ -950,16 +1139,16 @@ void DX11RenderingAPI::ConvertToEVSM( ID3D11ShaderResourceView* depthInput, ID3D
 	DX11Effects::EVSMConvertFX->EVSMConvertTech->GetDesc( &techDesc );
 	for(UINT p = 0; p < techDesc.Passes; ++p)
 	{
-		mDX11Device->md3dImmediateContext->IASetVertexBuffers(0, 1, &mScreenQuadVB, &stride, &offset);
-		mDX11Device->md3dImmediateContext->IASetIndexBuffer(mScreenQuadIB, DXGI_FORMAT_R32_UINT, 0);
+		mDX11Device->mStateCache.IASetVertexBuffers(0, 1, &mScreenQuadVB, &stride, &offset);
+		mDX11Device->mStateCache.IASetIndexBuffer(mScreenQuadIB, DXGI_FORMAT_R32_UINT, 0);
 
-		DX11Effects::EVSMConvertFX->EVSMConvertTech->GetPassByIndex(p)->Apply(0, mDX11Device->md3dImmediateContext);
+		mDX11Device->mStateCache.Apply(DX11Effects::EVSMConvertFX->EVSMConvertTech->GetPassByIndex(p));
 		mDX11Device->md3dImmediateContext->DrawIndexed(6, 0, 0);
 	}
 
-	mDX11Device->md3dImmediateContext->OMSetRenderTargets(0, 0, 0);
+	mDX11Device->mStateCache.OMSetRenderTargets(0, 0, 0);
 	ID3D11ShaderResourceView* nullSRV[2] = { 0, 0 };
-	mDX11Device->md3dImmediateContext->PSSetShaderResources( 0, 2, nullSRV);
+	mDX11Device->mStateCache.PSSetShaderResources( 0, 2, nullSRV);
 	mDX11Device->md3dImmediateContext->VSSetShaderResources( 0, 2, nullSRV);
 	mDX11Device->md3dImmediateContext->RSSetViewports(1, &mScreenViewport);
 }
@@ -970,12 +1159,12 @@ void DX11RenderingAPI::AccumulateLighting( ID3D11RenderTargetView* backBuffer, I
 	UINT stride = sizeof(PosNormTanTex);
 	UINT offset = 0;
 
-	mDX11Device->md3dImmediateContext->IASetInputLayout(DX11InputLayouts::PosNormalTanTex);
-	mDX11Device->md3dImmediateContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	mDX11Device->mStateCache.IASetInputLayout(DX11InputLayouts::PosNormalTanTex);
+	mDX11Device->mStateCache.IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
-	mDX11Device->md3dImmediateContext->OMSetRenderTargets(1, &backBuffer, 0);
-	mDX11Device->md3dImmediateContext->OMSetBlendState(DX11CommonStates::sBlendState_LightingBlend, 0, 0xFFFFFFFF);
-	mDX11Device->md3dImmediateContext->RSSetState(DX11CommonStates::sRasterizerState_Solid);
+	mDX11Device->mStateCache.OMSetRenderTargets(1, &backBuffer, 0);
+	mDX11Device->mStateCache.OMSetBlendState(DX11CommonStates::sBlendState_LightingBlend, 0, 0xFFFFFFFF);
+	mDX11Device->mStateCache.RSSetState(DX11CommonStates::sRasterizerState_Solid);
 
 	Matrix44 camViewInv = mCamera->mView;
 	camViewInv.Inverse();
@@ -989,7 +1178,7 @@ void DX11RenderingAPI::AccumulateLighting( ID3D11RenderTargetView* backBuffer, I
 	DX11Effects::ShadowMapFX->SetGBuffer(mGBufferSRV);
 	DX11Effects::ShadowMapFX->SetDirLights(mDirLights->GetShaderResource());
 	DX11Effects::ShadowMapFX->SetShadowArray(shadowSRV);
-	DX11Effects::ShadowMapFX->SetEyePosW(mCamera->mTrf.Position);
+	DX11Effects::ShadowMapFX->SetEyePosW(Transform::ToRenderSpace(mCamera->mTrf.Position));
 	DX11Effects::ShadowMapFX->SetShadowStrength(mScene.mShadowStrength);
 	DX11Effects::ShadowMapFX->SetExponents(mScene.mPositiveExponent, mScene.mNegativeExponent);
 	DX11Effects::ShadowMapFX->SetExponentsState(mScene.mbUsePositiveExponent, mScene.mbUseNegativeExponent);
@@ -1000,15 +1189,15 @@ void DX11RenderingAPI::AccumulateLighting( ID3D11RenderTargetView* backBuffer, I
 	DX11Effects::ShadowMapFX->AccumShadowTech->GetDesc( &techDesc );
 	for(UINT p = 0; p < techDesc.Passes; ++p)
 	{
-		mDX11Device->md3dImmediateContext->IASetVertexBuffers(0, 1, &mScreenQuadVB, &stride, &offset);
-		mDX11Device->md3dImmediateContext->IASetIndexBuffer(mScreenQuadIB, DXGI_FORMAT_R32_UINT, 0);
+		mDX11Device->mStateCache.IASetVertexBuffers(0, 1, &mScreenQuadVB, &stride, &offset);
+		mDX11Device->mStateCache.IASetIndexBuffer(mScreenQuadIB, DXGI_FORMAT_R32_UINT, 0);
 
-		DX11Effects::ShadowMapFX->AccumShadowTech->GetPassByIndex(p)->Apply(0, mDX11Device->md3dImmediateContext);
+		mDX11Device->mStateCache.Apply(DX11Effects::ShadowMapFX->AccumShadowTech->GetPassByIndex(p));
 		mDX11Device->md3dImmediateContext->DrawIndexed(6, 0, 0);
 	}
 
 	ID3D11ShaderResourceView* nullSRV[10] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
-	mDX11Device->md3dImmediateContext->PSSetShaderResources( 0, 10, nullSRV);
+	mDX11Device->mStateCache.PSSetShaderResources( 0, 10, nullSRV);
 	//mDX11Device->md3dImmediateContext->OMSetRenderTargets(0, 0, 0);
 }
 
@@ -1029,29 +1218,29 @@ void DX11RenderingAPI::BoxBlur(Texture2D* texture, u32 textureElement, Texture2D
 void DX11RenderingAPI::BoxBlurPass(	ID3D11ShaderResourceView* input, ID3D11RenderTargetView* output, ID3D11ShaderResourceView* partitionSRV,
 									u32 partitionIndex, const Vector2& filterSize, u32 dimension)
 {
-	mDX11Device->md3dImmediateContext->IASetInputLayout(0);
-	mDX11Device->md3dImmediateContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
-	mDX11Device->md3dImmediateContext->IASetVertexBuffers(0, 0, 0, 0, 0);
+	mDX11Device->mStateCache.IASetInputLayout(0);
+	mDX11Device->mStateCache.IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
+	mDX11Device->mStateCache.IASetVertexBuffers(0, 0, 0, 0, 0);
 
 	DX11Effects::EVSMBlurFX->SetDimension(dimension);
 	DX11Effects::EVSMBlurFX->SetInputTexture(input);
 	DX11Effects::EVSMBlurFX->SetPartitions(partitionSRV);
-	DX11Effects::EVSMBlurFX->EVSMBlurTech->GetPassByIndex(0)->Apply(0, mDX11Device->md3dImmediateContext);
+	mDX11Device->mStateCache.Apply(DX11Effects::EVSMBlurFX->EVSMBlurTech->GetPassByIndex(0));
 
-	mDX11Device->md3dImmediateContext->RSSetState(DX11CommonStates::sRasterizerState_Solid);
+	mDX11Device->mStateCache.RSSetState(DX11CommonStates::sRasterizerState_Solid);
 	mDX11Device->md3dImmediateContext->RSSetViewports(1, &mShadowViewport);
 
-	mDX11Device->md3dImmediateContext->OMSetRenderTargets(1, &output, 0);
-	mDX11Device->md3dImmediateContext->OMSetBlendState(0, 0, 0xffffffff);
+	mDX11Device->mStateCache.OMSetRenderTargets(1, &output, 0);
+	mDX11Device->mStateCache.OMSetBlendState(0, 0, 0xffffffff);
 
 	// Full-screen triangle
 	mDX11Device->md3dImmediateContext->Draw(3, 0);
 
 	// Cleanup (aka make the runtime happy)
-	mDX11Device->md3dImmediateContext->OMSetRenderTargets(0, 0, 0);
+	mDX11Device->mStateCache.OMSetRenderTargets(0, 0, 0);
 	ID3D11ShaderResourceView* nullViews[2] = {0, 0};
 	mDX11Device->md3dImmediateContext->VSSetShaderResources(0, 2, nullViews);
-	mDX11Device->md3dImmediateContext->PSSetShaderResources(0, 2, nullViews);
+	mDX11Device->mStateCache.PSSetShaderResources(0, 2, nullViews);
 	mDX11Device->md3dImmediateContext->RSSetViewports(1, &mScreenViewport);
 }
 
@@ -1061,7 +1250,7 @@ void DX11RenderingAPI::UpdateShadowCamera()
 	Vector3 camUp = mScene.mbAlignLightToFrustum ? mCamera->mTrf.Right() : Vector3::up;
 	Vector3 lightDir = Vector3(mWorkingDirLights[0].Direction.w, mWorkingDirLights[0].Direction.x, mWorkingDirLights[0].Direction.y);
 	mShadowCamera->mLookAt       = mScene.mSceneCenter;
-	mShadowCamera->mTrf.Position = -mScene.mSceneRadius * lightDir + mScene.mSceneCenter;
+	mShadowCamera->mTrf.Position = mScene.mSceneCenter + WorldPosition(-mScene.mSceneRadius * lightDir);
 	mShadowCamera->mUp           = camUp;
 	mShadowCamera->UpdateViewMatrix();
 
@@ -1077,40 +1266,30 @@ void DX11RenderingAPI::ComputeFrustumFlags()
 	mTotalSubsets    = 0;
 	mRenderedSubsets = 0;
 
-	Matrix44 invView = mCamera->mView;
-	invView.Inverse();
+	mCameraFrustum = Frustum::FromViewProj(mCamera->mView * (*mCamera->mCurrentProjectionMatrix));
 
 	for(const unique_ptr<GameObject>& gameobject : mScene.mGameObjects)
 	{
 		if (gameobject->mDrawable.mMesh == nullptr)
 			continue;
 
-		Matrix44 invWorld = gameobject->mTransform.WorldMatrixNoScale();	// we scale the AABB
-		invWorld.Inverse();
-
-		// View space to the object's local space.
-		Matrix44 toLocal = invView*invWorld;
-
-		// Transform the camera frustum from view space to the object's local space.
-		BoundingFrustum localFrustum;
-		mCameraFrustum.Transform(localFrustum, toLocal);
+		Matrix44 world = gameobject->mTransform.WorldMatrixNoScale();	// we scale the AABB
 
 		for (u32 iSubset=0 ; iSubset<gameobject->mDrawable.mMesh->mSubsetCount; ++iSubset)
 		{
 			BOOL inFrustum = false;
 			if (mbUseAABB)
 			{
-				BoundingBox aabb;
-				aabb.Center  = Vector3::Scale(gameobject->mTransform.Scale, gameobject->mDrawable.mMesh->mSubsets[iSubset].mCenter);
-				aabb.Extents = Vector3::Scale(gameobject->mTransform.Scale, gameobject->mDrawable.mMesh->mSubsets[iSubset].mExtents);
-				inFrustum = localFrustum.Intersects(aabb);
+				// The scaled local box becomes a world-space OBB: no matrix inverse per object
+				AABB aabb(	Vector3::Scale(gameobject->mTransform.Scale, gameobject->mDrawable.mMesh->mSubsets[iSubset].mCenter),
+							Vector3::Scale(gameobject->mTransform.Scale, gameobject->mDrawable.mMesh->mSubsets[iSubset].mExtents));
+				inFrustum = mCameraFrustum.Intersects(OBB::FromAABB(aabb, world));
 			}
 			else
 			{
-				BoundingSphere bs;
-				bs.Center = Vector3::Scale(gameobject->mTransform.Scale, gameobject->mDrawable.mMesh->mSubsets[iSubset].mCenter);
-				bs.Radius = gameobject->mTransform.Scale.Max() * gameobject->mDrawable.mMesh->mSubsets[iSubset].mRadius;
-				inFrustum = localFrustum.Intersects(bs);
+				Sphere bs(	Vector3::Scale(gameobject->mTransform.Scale, gameobject->mDrawable.mMesh->mSubsets[iSubset].mCenter),
+							gameobject->mTransform.Scale.Max() * gameobject->mDrawable.mMesh->mSubsets[iSubset].mRadius);
+				inFrustum = mCameraFrustum.Intersects(bs.Transform(world));
 			}
 			
 			if (inFrustum)
@@ -1144,29 +1323,133 @@ void DX11RenderingAPI::ClearFrustumFlags()
 	}
 }
 
+//////////////////////////////////////////////////////////////////////////
+// Fills the render queues once culling is done. Depth is the view depth
+// of the subset center, good enough to order whole subsets.
+void DX11RenderingAPI::BuildRenderQueues(BOOL bShadows)
+{
+	PROFILE_CPU("Build Render Queues");
+
+	mRenderQueue.Clear();
+	mShadowQueue.Clear();
+
+	const Matrix44& view    = mScene.mbViewLightSpace ? mShadowCamera->mView : mCamera->mView;
+	float           invFarZ = 1.0f / mCamera->mSettings.FarZ;
+
+	for (u32 iObject = 0; iObject < (u32)mScene.mGameObjects.size(); ++iObject)
+	{
+		DX11Mesh* mesh = mScene.mGameObjects[iObject]->mDrawable.mMesh;
+		if (mesh == nullptr)
+			continue;
+
+		Matrix44 worldView = mScene.mGameObjects[iObject]->mTransform.WorldMat * view;
+		for (u32 iSubset=0 ; iSubset<mesh->mSubsetCount; ++iSubset)
+		{
+			if (bShadows)
+				mShadowQueue.Push(RenderKey::Make(RenderKey::Pass_Shadow, false, 0, 0, iObject, 0.0f), iObject, iSubset);
+
+			const Mesh::Subset& subset = mesh->mSubsets[iSubset];
+			if (!subset.mbIsInFrustum)
+				continue;
+
+			const Material* material = mesh->mMaterial[iSubset].get();
+			float depth = subset.mCenter.x*worldView.m13 + subset.mCenter.y*worldView.m23 + subset.mCenter.z*worldView.m33 + worldView.m43;
+			u64   key   = RenderKey::Make(RenderKey::Pass_Scene, !material->mIsOpaque, material->mShaderSortId, material->mSortId, iObject, depth * invFarZ);
+			mRenderQueue.Push(key, iObject, iSubset);
+		}
+	}
+
+	// The shadow queue is left in push order: grouped by object already, and
+	// the world matrix is the only thing SubmitShadowQueue() rebinds
+	mRenderQueue.Sort();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Draws the sorted scene queue. The world matrix is only set when the object
+// changes, the material and the pass go through the state cache.
+void DX11RenderingAPI::SubmitRenderQueue(ID3DX11EffectPass* shaderPass)
+{
+	DX11StateCache& stateCache = mDX11Device->mStateCache;
+
+	u32  lastObject   = UINT_MAX;
+	BOOL bTranslucent = false;
+
+	for (const RenderPacket& packet : mRenderQueue.mPackets)
+	{
+		if (!bTranslucent && RenderKey::IsTranslucent(packet.mKey))
+		{
+			bTranslucent = true;
+			if (mScene.mbUseBlending)
+				mDX11Device->mStateCache.RSSetState(DX11CommonStates::sRasterizerState_CullNone);
+		}
+
+		DX11Drawable& drawable = mScene.mGameObjects[packet.mObject]->mDrawable;
+		Material*     material = drawable.mMesh->mMaterial[packet.mSubset].get();
+
+		if (packet.mObject != lastObject)
+		{
+			RJE_CHECK_FOR_SUCCESS(DX11Drawable::sShader->SetWorld(drawable.mTransform->WorldMat));
+			stateCache.MarkEffectDirty();
+			drawable.mMesh->Bind();
+			lastObject = packet.mObject;
+		}
+		if (stateCache.NeedsMaterial(material->mSortId))
+			RJE_CHECK_FOR_SUCCESS(DX11Drawable::sShader->SetMaterial(material));
+		RJE_CHECK_FOR_SUCCESS(stateCache.ApplyIfDirty(shaderPass));
+
+		drawable.mMesh->Draw(packet.mSubset);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Only the subsets of the given layers that CullShadowCasters() kept for this partition
+void DX11RenderingAPI::SubmitShadowQueue(ID3DX11EffectPass* shaderPass, const Matrix44& viewProj, u32 currentPartition, u32 layers)
+{
+	u32 lastObject = UINT_MAX;
+
+	for (const RenderPacket& packet : mShadowQueue.mPackets)
+	{
+		const unique_ptr<GameObject>& gameobject = mScene.mGameObjects[packet.mObject];
+		if (!(gameobject->mDrawable.mMesh->mSubsets[packet.mSubset].mShadowPartitions & (1u << currentPartition)))
+			continue;
+		if (!(mShadowCache.Layer(packet.mObject) & layers))
+			continue;
+		if (packet.mObject != lastObject)
+		{
+			DX11Effects::ShadowMapFX->SetWorldViewProj(gameobject->mTransform.WorldMat*viewProj);
+			RJE_CHECK_FOR_SUCCESS(mDX11Device->mStateCache.Apply(shaderPass));
+			gameobject->mDrawable.mMesh->Bind();
+			lastObject = packet.mObject;
+		}
+		gameobject->mDrawable.mMesh->Draw(packet.mSubset);
+	}
+}
+
 //////////////////////////////////////////////////////////////////////////
 void DX11RenderingAPI::DrawLightSpheres(ID3DX11EffectTechnique* activeTech, u32 pass, BOOL bSun/*=false*/)
 {
 	UINT stride = sizeof(PosNormTanTex);
 	UINT offset = 0;
 
-	mDX11Device->md3dImmediateContext->IASetVertexBuffers(0, 1, &mLightSpheresVB, &stride, &offset);
-	mDX11Device->md3dImmediateContext->IASetIndexBuffer(mLightSpheresIB, DXGI_FORMAT_R32_UINT, 0);
+	mDX11Device->mStateCache.IASetVertexBuffers(0, 1, &mLightSpheresVB, &stride, &offset);
+	mDX11Device->mStateCache.IASetIndexBuffer(mLightSpheresIB, DXGI_FORMAT_R32_UINT, 0);
 
-	RJE_CHECK_FOR_SUCCESS(DX11Effects::BasicFX->SetMaterial(&mLightSphereMat));
+	// Not a file material (id 0): always set, and the cache forgets the bound one
+	if (mDX11Device->mStateCache.NeedsMaterial(0))
+		RJE_CHECK_FOR_SUCCESS(DX11Effects::BasicFX->SetMaterial(&mLightSphereMat));
 	
 	if (bSun)
 	{
 		Transform lightTrf;
 		Matrix44 lightWorld;
 		Vector3 lightDir = Vector3(mWorkingDirLights[0].Direction.w, mWorkingDirLights[0].Direction.x, mWorkingDirLights[0].Direction.y);
-		lightTrf.Position = -lightDir * 10.0f;
+		lightTrf.Position = WorldPosition(-lightDir * 10.0f);
 		lightTrf.Scale    = 4.0f*Vector3::one;
 		lightWorld = lightTrf.WorldMatrix();
 
 		RJE_CHECK_FOR_SUCCESS(DX11Effects::BasicFX->SetWorld(lightWorld));
 
-		activeTech->GetPassByIndex(pass)->Apply(0, mDX11Device->md3dImmediateContext);
+		mDX11Device->mStateCache.Apply(activeTech->GetPassByIndex(pass));
 		mDX11Device->md3dImmediateContext->DrawIndexed(mLightSphereIndexCount, 0, 0);
 	}
 	else
@@ -1175,12 +1458,12 @@ void DX11RenderingAPI::DrawLightSpheres(ID3DX11EffectTechnique* activeTech, u32
 		{
 			Transform lightTrf;
 			Matrix44 lightWorld;
-			lightTrf.Position = mWorkingPointLights[i].Position;
+			lightTrf.Position = WorldPosition(mPointLightSet.mLights[i].Position);
 			lightWorld = lightTrf.WorldMatrix();
 
 			RJE_CHECK_FOR_SUCCESS(DX11Effects::BasicFX->SetWorld(lightWorld));
 
-			activeTech->GetPassByIndex(pass)->Apply(0, mDX11Device->md3dImmediateContext);
+			mDX11Device->mStateCache.Apply(activeTech->GetPassByIndex(pass));
 			mDX11Device->md3dImmediateContext->DrawIndexed(mLightSphereIndexCount, 0, 0);
 		}
 	}
@@ -1193,8 +1476,8 @@ void DX11RenderingAPI::DrawGizmos()
 
 	PROFILE_GPU_START(L"Render Gizmos");
 
-	mDX11Device->md3dImmediateContext->IASetInputLayout(DX11InputLayouts::PosColor);
-	mDX11Device->md3dImmediateContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_LINELIST);
+	mDX11Device->mStateCache.IASetInputLayout(DX11InputLayouts::PosColor);
+	mDX11Device->mStateCache.IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_LINELIST);
 	
 	// Set constants
 	Matrix44 view     = mCamera->mView;
@@ -1320,7 +1603,33 @@ void DX11RenderingAPI::SetActivePointLights(int activeLights)
 {
 	mPointLightCount = (u32) RJE::Math::Clamp(activeLights, 0, MAX_LIGHTS);
 	RJE_SAFE_DELETE(mPointLights);
-	mPointLights = rje_new StructuredBuffer<PointLight>(mDX11Device->md3dDevice, mPointLightCount, D3D11_BIND_SHADER_RESOURCE, true);
+	// Default usage: UploadPointLights() only updates the lights that changed
+	mPointLights = rje_new StructuredBuffer<PointLight>(mDX11Device->md3dDevice, mPointLightCount, D3D11_BIND_SHADER_RESOURCE, false);
+	mPointLightSet.SetCount(mPointLightCount);
+	// Placed now, not at the next step: a frame may have none
+	mPointLightSet.Update(0.0f, false, mScene.mPointLightRadius, mScene.mPointLightHeight);
+}
+//-------------------------
+void DX11RenderingAPI::UploadPointLights()
+{
+#if RJE_DOUBLE_PRECISION
+	// The buffer is in render space, which follows the camera
+	mPointLightSet.MarkAllDirty();
+#endif
+	mPointLightSet.DirtyRanges(mPointLightRanges);
+	for (u32 i = 0; i < mPointLightRanges.size(); ++i)
+	{
+		const LightRange& range = mPointLightRanges[i];
+		const PointLight* lights = &mPointLightSet.mLights[range.mFirst];
+#if RJE_DOUBLE_PRECISION
+		FrameVector<PointLight>::Type renderSpaceLights(lights, lights + range.mCount);
+		for (u32 light = 0; light < range.mCount; ++light)
+			renderSpaceLights[light].Position = Transform::ToRenderSpace(WorldPosition(lights[light].Position));
+		lights = &renderSpaceLights[0];
+#endif
+		mPointLights->UpdateRange(mDX11Device->md3dImmediateContext, lights, range.mFirst, range.mCount);
+	}
+	mPointLightSet.ClearDirty();
 }
 //-------------------------
 void DX11RenderingAPI::SetActiveSpotLights(int activeLights)
@@ -1330,6 +1639,56 @@ void DX11RenderingAPI::SetActiveSpotLights(int activeLights)
 	mSpotLights = rje_new StructuredBuffer<SpotLight>(mDX11Device->md3dDevice, mSpotLightCount, D3D11_BIND_SHADER_RESOURCE, true);
 }
 
+//////////////////////////////////////////////////////////////////////////
+// Bins the point lights for the forward pass and uploads the grid, once per
+// frame. Returns false when the pass has to loop over every light: clusters
+// off, no point light, or a camera the grid doesn't describe (orthographic,
+// light space view).
+BOOL DX11RenderingAPI::BuildLightClusters()
+{
+	if (!mbUseLightClusters || mPointLightCount == 0 || mScene.mbViewLightSpace || mCamera->IsOrtho())
+		return false;
+
+	PROFILE_CPU("Build Light Clusters");
+
+	const Matrix44&       proj     = mCamera->mPerspProj;
+	const CameraSettings& settings = mCamera->mSettings;
+	if (!mLightClusters.IsSetup(mWindowWidth, mWindowHeight, proj, settings.NearZ, settings.FarZ))
+	{
+		mLightClusters.Setup(mWindowWidth, mWindowHeight, proj, settings.NearZ, settings.FarZ);
+		RJE_SAFE_DELETE(mLightClusterBuffer);
+		mLightClusterBuffer = rje_new StructuredBuffer<LightCluster>(mDX11Device->md3dDevice, mLightClusters.ClusterCount(), D3D11_BIND_SHADER_RESOURCE, true);
+	}
+
+	Matrix44 view = mCamera->mView;
+#if RJE_DOUBLE_PRECISION
+	// The working lights are in world space, the view matrix in render space
+	view = Matrix44::Translation(Transform::ToRenderSpace(WorldPosition())) * view;
+#endif
+	mLightClusters.Build(mPointLightSet.mLights, mPointLightCount, view);
+
+	// The index list only grows, by powers of two
+	u32 indexCount = (u32)mLightClusters.mLightIndices.size();
+	if (mLightIndexBuffer == nullptr || indexCount > mLightIndexCapacity)
+	{
+		mLightIndexCapacity = RJE::Math::Max(mLightIndexCapacity, 1024u);
+		while (mLightIndexCapacity < indexCount)
+			mLightIndexCapacity *= 2;
+		RJE_SAFE_DELETE(mLightIndexBuffer);
+		mLightIndexBuffer = rje_new StructuredBuffer<u32>(mDX11Device->md3dDevice, mLightIndexCapacity, D3D11_BIND_SHADER_RESOURCE, true);
+	}
+
+	ID3D11DeviceContext* context = mDX11Device->md3dImmediateContext;
+	memcpy(mLightClusterBuffer->MapDiscard(context), &mLightClusters.mClusters[0], mLightClusters.mClusters.size() * sizeof(LightCluster));
+	mLightClusterBuffer->Unmap(context);
+	if (indexCount > 0)
+	{
+		memcpy(mLightIndexBuffer->MapDiscard(context), &mLightClusters.mLightIndices[0], indexCount * sizeof(u32));
+		mLightIndexBuffer->Unmap(context);
+	}
+	return true;
+}
+
 //////////////////////////////////////////////////////////////////////////
 void DX11RenderingAPI::Shutdown()
 {
@@ -1350,10 +1709,13 @@ void DX11RenderingAPI::Shutdown()
 	RJE_SAFE_DELETE(mLitBuffer);
 	RJE_SAFE_DELETE(mSDSMPartitions.mPartitionBuffer);
 	RJE_SAFE_DELETE(mSDSMPartitions.mPartitionBounds);
+	mSDSMPartitions.ReleaseReadbackBuffers();
 
 	RJE_SAFE_DELETE(mDirLights);
 	RJE_SAFE_DELETE(mPointLights);
 	RJE_SAFE_DELETE(mSpotLights);
+	RJE_SAFE_DELETE(mLightClusterBuffer);
+	RJE_SAFE_DELETE(mLightIndexBuffer);
 
 	RJE_SAFE_RELEASE(mLightSpheresVB);
 	RJE_SAFE_RELEASE(mLightSpheresIB);
@@ -1383,7 +1745,11 @@ void DX11RenderingAPI::Shutdown()
 	for(Texture2D* tex2D : mGBuffer)
 		RJE_SAFE_DELETE(tex2D);
 
-	RJE_SAFE_DELETE(mShadowEVSMTexture);
+	for (u32 p = 0; p < PARTITIONS; ++p)
+	{
+		RJE_SAFE_DELETE(mShadowEVSMTexture[p]);
+		RJE_SAFE_DELETE(mShadowStaticDepth[p]);
+	}
 	RJE_SAFE_DELETE(mShadowEVSMBlurTexture);
 
 	RJE_SAFE_DELETE(mDepthBuffer);
@@ -1513,9 +1879,15 @@ void DX11RenderingAPI::BuildDepthBuffers(DXGI_SAMPLE_DESC sampleDesc)
 {
 	RJE_SAFE_DELETE(mDepthBuffer);
 	RJE_SAFE_DELETE(mShadowDepthTexture);
+	for (u32 p = 0; p < PARTITIONS; ++p)
+		RJE_SAFE_DELETE(mShadowStaticDepth[p]);
 	
 	mDepthBuffer        = rje_new Depth2D( mDX11Device->md3dDevice, mWindowWidth, mWindowHeight, D3D11_BIND_DEPTH_STENCIL, sampleDesc, MSAA_Samples > 1);
 	mShadowDepthTexture = rje_new Depth2D( mDX11Device->md3dDevice, mShadowTextureDim, mShadowTextureDim, D3D11_BIND_DEPTH_STENCIL | D3D11_BIND_SHADER_RESOURCE, sampleDesc);
+	// Same description as the shadow depth buffer, for CopyResource
+	for (u32 p = 0; p < PARTITIONS; ++p)
+		mShadowStaticDepth[p] = rje_new Depth2D( mDX11Device->md3dDevice, mShadowTextureDim, mShadowTextureDim, D3D11_BIND_DEPTH_STENCIL | D3D11_BIND_SHADER_RESOURCE, sampleDesc);
+	mShadowCache.Invalidate();
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -1559,18 +1931,23 @@ void DX11RenderingAPI::BuildGBuffer(DXGI_SAMPLE_DESC sampleDesc)
 //////////////////////////////////////////////////////////////////////////
 void DX11RenderingAPI::BuildShadowTextures(DXGI_SAMPLE_DESC sampleDesc)
 {
-	RJE_SAFE_DELETE(mShadowEVSMTexture);
+	for (u32 p = 0; p < PARTITIONS; ++p)
+		RJE_SAFE_DELETE(mShadowEVSMTexture[p]);
 	RJE_SAFE_DELETE(mShadowEVSMBlurTexture);
 	RJE_SAFE_DELETE(mSDSMPartitions.mPartitionBuffer);
 	RJE_SAFE_DELETE(mSDSMPartitions.mPartitionBounds);
 
 	// PartitionsPerPass EVSM textures (full mip chain each)   &   Temporary texture for blurring (no mip chain needed)
-	mShadowEVSMTexture     = rje_new Texture2D(mDX11Device->md3dDevice, mShadowTextureDim, mShadowTextureDim, DXGI_FORMAT_R32G32B32A32_FLOAT, D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE, 0, 1);
+	for (u32 p = 0; p < PARTITIONS; ++p)
+		mShadowEVSMTexture[p] = rje_new Texture2D(mDX11Device->md3dDevice, mShadowTextureDim, mShadowTextureDim, DXGI_FORMAT_R32G32B32A32_FLOAT, D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE, 0, 1);
 	mShadowEVSMBlurTexture = rje_new Texture2D(mDX11Device->md3dDevice, mShadowTextureDim, mShadowTextureDim, DXGI_FORMAT_R32G32B32A32_FLOAT, D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE, 1, 1);
 
 	// Build The partition StructuredBuffers
 	mSDSMPartitions.mPartitionBuffer = rje_new StructuredBuffer<Partition>(  mDX11Device->md3dDevice, PARTITIONS);
 	mSDSMPartitions.mPartitionBounds = rje_new StructuredBuffer<BoundsFloat>(mDX11Device->md3dDevice, PARTITIONS);
+	mSDSMPartitions.CreateReadbackBuffers(mDX11Device->md3dDevice);
+	mShadowCasterCuller.Invalidate();
+	mShadowCache.Invalidate();
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -1624,8 +2001,6 @@ void DX11RenderingAPI::ResizeWindow(int newSizeWidth, int newSizeHeight)
 	// The window resized, so update the aspect ratio and recompute the projection matrix.
 	mCamera->mSettings.AspectRatio = (float)newSizeWidth / (float)newSizeHeight;
 	mCamera->UpdateProjMatrix((float)newSizeWidth, (float)newSizeHeight);
-
-	BoundingFrustum::CreateFromMatrix(mCameraFrustum, *mCamera->mCurrentProjectionMatrix);
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -1656,7 +2031,7 @@ void DX11RenderingAPI::SetMSAA(u32 MSAASamples)
 void DX11RenderingAPI::InstantiateModel(string filename)
 {
 	unique_ptr<GameObject> gameobject (new GameObject);
-	string meshPath     = System::Instance()->mDataPath + "models\\" + filename + ".mesh";
+	string meshPath     = RJE_GLOBALS::gDataPath + "models\\" + filename + ".mesh";
 	string materialPath = filename + "\\" + filename + ".matlib";
 	//-----
 	gameobject->mName = filename;
@@ -1686,7 +2061,7 @@ void DX11RenderingAPI::InstantiatePrimitive(string name)
 void DX11RenderingAPI::LoadSkybox(string name)
 {
 	RJE_SAFE_RELEASE(mSkyboxSRV);
-	string path = System::Instance()->mDataPath + "textures\\skyboxes\\" + name;
+	string path = RJE_GLOBALS::gDataPath + "textures\\skyboxes\\" + name;
 	DX11TextureManager::Instance()->LoadTextureFromPath(path, &mSkyboxSRV);
 }
 
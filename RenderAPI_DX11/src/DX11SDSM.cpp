@@ -14,6 +14,9 @@ DX11SDSM::DX11SDSM()
 	// 1% dilation on partition borders to cover standard filtering (mipmapping/aniso).
 	// Blur kernels are handled separately so this should stay small or can even be removed in some scenes.
 	mCurrentConstants.mDilationFactor = 0.01f;
+
+	for (u32 i = 0; i < PartitionReadbackQueue::Slots; ++i)
+		mPartitionReadback[i] = nullptr;
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -96,4 +99,62 @@ void DX11SDSM::UnbindResources(ID3D11DeviceContext* dc)
 	ID3D11UnorderedAccessView* dummyUAV[8] = {0, 0, 0, 0, 0, 0, 0, 0};
 	dc->CSSetShaderResources(0, 8, dummySRV);
 	dc->CSSetUnorderedAccessViews(0, 8, dummyUAV, 0);
-}
\ No newline at end of file
+}
+
+//////////////////////////////////////////////////////////////////////////
+void DX11SDSM::CreateReadbackBuffers(ID3D11Device* device)
+{
+	ReleaseReadbackBuffers();
+
+	CD3D11_BUFFER_DESC desc(sizeof(Partition) * PARTITIONS, 0, D3D11_USAGE_STAGING, D3D11_CPU_ACCESS_READ,
+							D3D11_RESOURCE_MISC_BUFFER_STRUCTURED, sizeof(Partition));
+	for (u32 i = 0; i < PartitionReadbackQueue::Slots; ++i)
+		RJE_CHECK_FOR_SUCCESS(device->CreateBuffer(&desc, 0, &mPartitionReadback[i]));
+}
+
+//////////////////////////////////////////////////////////////////////////
+void DX11SDSM::ReleaseReadbackBuffers()
+{
+	for (u32 i = 0; i < PartitionReadbackQueue::Slots; ++i)
+		RJE_SAFE_RELEASE(mPartitionReadback[i]);
+	mReadbackQueue.Reset();
+}
+
+//////////////////////////////////////////////////////////////////////////
+BOOL DX11SDSM::ReadbackPartitions(ID3D11DeviceContext* dc, OUT ShadowPartition* outPartitions)
+{
+	if (mPartitionReadback[0] == nullptr)
+		return false;
+
+	// Every copy in flight, oldest first: a Map() that fails now is retried
+	// next frame, so a late copy never blocks the queue
+	BOOL bRead = false;
+	u32  pending[PartitionReadbackQueue::Slots];
+	u32  pendingCount = mReadbackQueue.Pending(pending);
+	for (u32 i = 0; i < pendingCount; ++i)
+	{
+		u32 slot = pending[i];
+		D3D11_MAPPED_SUBRESOURCE mapped;
+		if (FAILED(dc->Map(mPartitionReadback[slot], 0, D3D11_MAP_READ, D3D11_MAP_FLAG_DO_NOT_WAIT, &mapped)))
+			continue;
+
+		const Partition* partitions = static_cast<const Partition*>(mapped.pData);
+		for (u32 p = 0; p < PARTITIONS; ++p)
+		{
+			outPartitions[p].mScale = partitions[p].scale;
+			outPartitions[p].mBias  = partitions[p].bias;
+		}
+		dc->Unmap(mPartitionReadback[slot], 0);
+		mReadbackQueue.Landed(slot);
+		bRead = true;
+	}
+
+	// Every copy in flight: skip this frame rather than overwrite one
+	u32 slot = mReadbackQueue.FreeSlot();
+	if (slot < PartitionReadbackQueue::Slots)
+	{
+		dc->CopyResource(mPartitionReadback[slot], mPartitionBuffer->GetBuffer());
+		mReadbackQueue.Queue(slot);
+	}
+	return bRead;
+}
@@ -1,5 +1,21 @@
 #include "DX11Texture2D.h"
 
+//////////////////////////////////////////////////////////////////////////
+// Bytes of all the mips, array slices and samples of a texture
+static i64 TextureBytes(const D3D11_TEXTURE2D_DESC& desc)
+{
+	i64 texels = 0;
+	u32 width  = desc.Width;
+	u32 height = desc.Height;
+	for (u32 mip = 0; mip < desc.MipLevels; ++mip)
+	{
+		texels += (i64)width * height;
+		width  = width  > 1 ? width  / 2 : 1;
+		height = height > 1 ? height / 2 : 1;
+	}
+	return texels * desc.ArraySize * desc.SampleDesc.Count * DirectX::BitsPerPixel(desc.Format) / 8;
+}
+
 //////////////////////////////////////////////////////////////////////////
 Texture2D::Texture2D(ID3D11Device* d3dDevice, int width, int height, DXGI_FORMAT format, UINT bindFlags, int mipLevels)
 { InternalConstruct(d3dDevice, width, height, format, bindFlags, mipLevels, 1, 1, 0, D3D11_RTV_DIMENSION_TEXTURE2D, D3D11_UAV_DIMENSION_TEXTURE2D, D3D11_SRV_DIMENSION_TEXTURE2D); }
@@ -41,6 +57,10 @@ void Texture2D::InternalConstruct(ID3D11Device* d3dDevice,
 	// Update with actual mip levels, etc.
 	mTexture->GetDesc(&desc);
 
+	sprintf_s(mBudgetOwner, "Texture2D %ux%u", desc.Width, desc.Height);
+	mBudgetBytes = TextureBytes(desc);
+	MemoryBudget::Instance()->Add(Memory_RenderTargets, mBudgetOwner, mBudgetBytes);
+
 	if (bindFlags & D3D11_BIND_RENDER_TARGET)
 	{
 		for (int i = 0; i < arraySize; ++i)
@@ -97,6 +117,7 @@ Texture2D::~Texture2D()
 		mShaderResource->Release();
 	
 	mTexture->Release();
+	MemoryBudget::Instance()->Remove(Memory_RenderTargets, mBudgetOwner, mBudgetBytes);
 }
 
 
@@ -122,6 +143,10 @@ void Depth2D::InternalConstruct(ID3D11Device* d3dDevice, int width, int height,
 	CD3D11_TEXTURE2D_DESC desc( stencil ? DXGI_FORMAT_R32G8X24_TYPELESS : DXGI_FORMAT_R32_TYPELESS, width, height, arraySize, 1, bindFlags, D3D11_USAGE_DEFAULT, 0, sampleCount, sampleQuality);
 	d3dDevice->CreateTexture2D(&desc, 0, &mTexture);
 
+	sprintf_s(mBudgetOwner, "Depth2D %ux%u", desc.Width, desc.Height);
+	mBudgetBytes = TextureBytes(desc);
+	MemoryBudget::Instance()->Add(Memory_RenderTargets, mBudgetOwner, mBudgetBytes);
+
 	if (bindFlags & D3D11_BIND_DEPTH_STENCIL)
 	{
 		for (int i = 0; i < arraySize; ++i)
@@ -149,4 +174,5 @@ Depth2D::~Depth2D()
 	}
 	if (mShaderResource) mShaderResource->Release();
 	mTexture->Release();
+	MemoryBudget::Instance()->Remove(Memory_RenderTargets, mBudgetOwner, mBudgetBytes);
 }
@@ -15,6 +15,7 @@ void DX11TextureManager::ReleaseTextures()
 {
 	for ( auto it = mTextures.begin(); it != mTextures.end(); ++it )
 	{
+		MemoryBudget::Instance()->Release(Memory_Textures, it->first.c_str());
 		RJE_SAFE_RELEASE(it->second);
 	}
 }
@@ -53,6 +54,7 @@ void DX11TextureManager::LoadTexture(string texturePath, string textureName)
 	}
 	ID3D11ShaderResourceView* textureSRV = nullptr;
 	RJE_CHECK_FOR_SUCCESS(CreateShaderResourceView( mDevice, image.GetImages(), image.GetImageCount(), metadata, &textureSRV ));
+	MemoryBudget::Instance()->Add(Memory_Textures, textureName.c_str(), image.GetPixelsSize());
 	mTextures[textureName] = textureSRV;
 	++mTextureCount;
 }
@@ -60,7 +62,7 @@ void DX11TextureManager::LoadTexture(string texturePath, string textureName)
 //////////////////////////////////////////////////////////////////////////
 void DX11TextureManager::LoadTexture(string keyName, ID3D11ShaderResourceView** shaderResourceView)
 {	
-	wstring texturePath = StringToWString(System::Instance()->mDataPath) + CIniFile::GetValueW(keyName, "textures", System::Instance()->mResourcesPath);
+	wstring texturePath = StringToWString(RJE_GLOBALS::gDataPath) + CIniFile::GetValueW(keyName, "textures", RJE_GLOBALS::gResourcesPath);
 	wstring textureExtension = texturePath.substr(texturePath.find('.'));
 	// lower the case so we can compare more easily
 	std::transform(textureExtension.begin(), textureExtension.end(), textureExtension.begin(), ::tolower);
@@ -82,6 +84,9 @@ void DX11TextureManager::LoadTexture(string keyName, ID3D11ShaderResourceView**
 		RJE_CHECK_FOR_SUCCESS(LoadFromDDSFile( texturePath.c_str(), DDS_FLAGS::DDS_FLAGS_NONE, &metadata, image ));
 	}
 	RJE_CHECK_FOR_SUCCESS(CreateShaderResourceView( mDevice, image.GetImages(), image.GetImageCount(), metadata, shaderResourceView ));
+	// The caller owns the view: accounted under the key, a reload replaces it
+	MemoryBudget::Instance()->Release(Memory_Textures, keyName.c_str());
+	MemoryBudget::Instance()->Add(Memory_Textures, keyName.c_str(), image.GetPixelsSize());
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -108,6 +113,9 @@ void DX11TextureManager::LoadTextureFromPath(string texturePath, ID3D11ShaderRes
 		RJE_CHECK_FOR_SUCCESS(LoadFromDDSFile( StringToWString(texturePath).c_str(), DDS_FLAGS::DDS_FLAGS_NONE, &metadata, image ));
 	}
 	RJE_CHECK_FOR_SUCCESS(CreateShaderResourceView( mDevice, image.GetImages(), image.GetImageCount(), metadata, shaderResourceView ));
+	// The caller owns the view: accounted under the path, a reload replaces it
+	MemoryBudget::Instance()->Release(Memory_Textures, texturePath.c_str());
+	MemoryBudget::Instance()->Add(Memory_Textures, texturePath.c_str(), image.GetPixelsSize());
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -155,6 +163,7 @@ void DX11TextureManager::Create2DTextureFixedColor(i32 size, RJE_COLOR::Color co
 
 	delete[] texArray;
 
+	MemoryBudget::Instance()->Add(Memory_Textures, textureName.c_str(), textureSize * 4);
 	mTextures[textureName] = textureSRV;
 	++mTextureCount;
 }
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "Types.h"
+#include "NullStateCache.h"
+#include <vector>
+#include <cstdio>
+#include <cstring>
+
+//////////////////////////////////////////////////////////////////////////
+// What the renderer would have sent to the GPU during one frame.
+struct NullCommandStats
+{
+	u32 mDrawCalls;
+	u64 mIndicesDrawn;
+	u32 mDispatches;
+	u32 mStateChanges;		// input layout, topology, buffers, rasterizer/blend states, targets, viewports
+	u32 mConstantUpdates;	// effect variables (matrices, materials, SRVs...)
+	u32 mShaderApplies;		// pass->Apply()
+	u32 mStatesFiltered;	// calls the state cache dropped, not counted above
+	u32 mMaterialsFiltered;
+	u32 mAppliesFiltered;
+	u32 mClears;
+	u32 mBufferUploads;		// Map/Unmap of dynamic buffers
+	u64 mUploadBytes;
+	u32 mBufferCreates;
+	u64 mCreateBytes;
+	u32 mTextureLoads;
+
+	NullCommandStats() { Reset(); }
+	void Reset() { memset(this, 0, sizeof(NullCommandStats)); }
+	void Accumulate(const NullCommandStats& stats);
+};
+
+//////////////////////////////////////////////////////////////////////////
+enum NullCommandType
+{
+	NullCmd_Draw,
+	NullCmd_Dispatch,
+	NullCmd_State,
+	NullCmd_Constants,
+	NullCmd_Apply,
+	NullCmd_Clear,
+	NullCmd_Upload,
+	NullCmd_CreateBuffer,
+	NullCmd_LoadTexture,
+	//------
+	NullCmd_Count
+};
+
+struct NullCommand
+{
+	u32			mFrame;
+	u32			mType;
+	u64			mArg;		// index count, thread groups or bytes depending on mType
+	const char*	mName;		// always a string literal
+};
+
+//////////////////////////////////////////////////////////////////////////
+// Stands in for the device/context pair: every call only bumps a counter
+// and, when tracing, appends a record. No GPU, no window.
+struct NullDevice
+{
+	NullDevice();
+
+	NullCommandStats			mFrameStats;	// reset by BeginFrame
+	NullCommandStats			mTotalStats;	// everything since the device was created (or ResetTotals)
+	NullCommandStats			mLoadStats;		// commands issued outside BeginFrame/EndFrame (resource loading)
+	u32							mFrameCount;
+	BOOL						mbInFrame;
+	//------
+	BOOL						mbTrace;
+	std::vector<NullCommand>	mTrace;
+	//------
+	NullContext					mContext;
+	NullStateCache				mStateCache;	// filters the redundant calls on mContext
+
+	//------
+	void BeginFrame();
+	void EndFrame();
+	void ResetTotals();
+	//------
+	void DrawIndexed(u32 indexCount, const char* name)	{ Record(NullCmd_Draw, indexCount, name); ++Stats().mDrawCalls; Stats().mIndicesDrawn += indexCount; }
+	void Draw(u32 vertexCount, const char* name)		{ Record(NullCmd_Draw, vertexCount, name); ++Stats().mDrawCalls; }
+	void Dispatch(u32 x, u32 y, const char* name)		{ Record(NullCmd_Dispatch, (u64)x*y, name); ++Stats().mDispatches; }
+	void SetState(const char* name)						{ Record(NullCmd_State, 0, name); ++Stats().mStateChanges; }
+	void SetConstant(const char* name)					{ Record(NullCmd_Constants, 0, name); ++Stats().mConstantUpdates; }
+	void Apply(const char* name)						{ Record(NullCmd_Apply, 0, name); ++Stats().mShaderApplies; }
+	void Clear(const char* name)						{ Record(NullCmd_Clear, 0, name); ++Stats().mClears; }
+	void Upload(u64 bytes, const char* name)			{ Record(NullCmd_Upload, bytes, name); ++Stats().mBufferUploads; Stats().mUploadBytes += bytes; }
+	void CreateBuffer(u64 bytes, const char* name)		{ Record(NullCmd_CreateBuffer, bytes, name); ++Stats().mBufferCreates; Stats().mCreateBytes += bytes; }
+	void LoadTexture(u64 bytes, const char* name)		{ Record(NullCmd_LoadTexture, bytes, name); ++Stats().mTextureLoads; Stats().mUploadBytes += bytes; }
+	//------
+	void DumpTrace(FILE* file) const;
+	static void PrintStats(FILE* file, const NullCommandStats& stats, u32 frameCount);
+	static const char* CommandName(u32 type);
+
+private:
+	NullCommandStats& Stats() { return mbInFrame ? mFrameStats : mLoadStats; }
+	void Record(u32 type, u64 arg, const char* name)
+	{
+		if (mbTrace)
+		{
+			NullCommand cmd = { mFrameCount, type, arg, name };
+			mTrace.push_back(cmd);
+		}
+	}
+};
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "NullHelper.h"
+
+//////////////////////////////////////////////////////////////////////////
+struct NullDrawable
+{
+	NullDrawable();
+	~NullDrawable();
+	//-----------------
+	// This is just a pointer to the GameObject Transform
+	Transform*		mTransform;
+	//------
+	NullMesh*		mMesh;
+	NullMesh*		mGizmo;
+	//------
+	Color			mGizmoColor;
+	//-----------------
+	// Same command stream as DX11Drawable, minus the effect pointers
+	void Render(const char* shaderPass, BOOL bDrawOpaque = true);
+	void RenderGizmo(const char* shaderPass);
+};
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "Globals.h"
+#include "Types.h"
+#include "Debug.h"
+#include "Input.h"
+#include "MathHelper.h"
+#include "IniFile.h"
+#include "FileSystem.h"
+#include "../../RamJamEngine/include/MeshData.h"
+
+//////////////////////////////////////////////////////////////////////////
+
+#include "../../RamJamEngine/include/Light.h"
+#include "../../RamJamEngine/include/Mesh.h"
+#include "../../RamJamEngine/include/Transform.h"
+#include "../../RamJamEngine/include/Material.h"
+#include "../../RamJamEngine/include/ShaderDefines.h"
+
+//////////////////////////////////////////////////////////////////////////
+#include "NullDevice.h"
+#include "NullStructuredBuffer.h"
+#include "NullTextureManager.h"
+#include "NullMesh.h"
+//////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,152 @@
+#pragma once
+
+#include "NullHelper.h"
+#include "NullDrawable.h"
+#include "../../RamJamEngine/include/GraphicAPI.h"
+#include "../../RamJamEngine/include/Scene.h"
+#include "../../RamJamEngine/include/GameObject.h"
+#include "../../RamJamEngine/include/RenderQueue.h"
+#include "../../RamJamEngine/include/ShadowCasterCulling.h"
+#include "../../RamJamEngine/include/ShadowCache.h"
+#include "../../RamJamEngine/include/LightClusters.h"
+#include "../../RamJamEngine/include/PointLightSet.h"
+#include "../../RamJamEngine/include/FramePipeline.h"
+#include "Bounds.h"
+
+
+//////////////////////////////////////////////////////////////////////////
+// Headless backend: runs the same CPU side as DX11RenderingAPI (light
+// animation, culling, shadow camera, pass ordering) but every GPU call is
+// replaced by a NullDevice record. Used to profile the engine without a
+// GPU or a window.
+//
+// The update side (UpdateScene(), UpdateFrame(), WriteSnapshot()) only
+// touches the scene, the camera and the light animation; the render side
+// (DrawScene()) only its RenderSnapshot, the device, the light buffers, the
+// shadow camera and the culling state: a FramePipeline can run them on two
+// threads. The scene
+// settings and meshes are read by both and must not change meanwhile.
+struct NullRenderingAPI : GraphicAPI
+{
+	NullRenderingAPI(Scene& scene);
+	virtual ~NullRenderingAPI();
+
+	NullDevice*		mNullDevice;
+
+	//---------------
+	BOOL            mbUseFrustumCulling;
+	BOOL            mbUseAABB;	// if not, use Bounding Sphere
+	Frustum         mCameraFrustum;	// world space, rebuilt by ComputeFrustumFlags
+	u32             mRenderedSubsets;
+	u32             mTotalSubsets;
+	//---------------
+	BOOL            mbUseRenderQueue;	// if not, draw in scene order
+	RenderQueue     mRenderQueue;		// visible subsets, sorted by RenderKey
+	RenderQueue     mShadowQueue;		// every subset, grouped by mesh
+	//---------------
+	BOOL				mbCullShadowCasters;
+	ShadowCasterCuller	mShadowCasterCuller;
+	ShadowPartition		mShadowPartitions[PARTITIONS];	// CPU estimate, stands in for the GPU reduction
+	ShadowMapCache		mShadowCache;
+	//---------------
+	BOOL							mbUseLightClusters;
+	LightClusterGrid				mLightClusters;
+	StructuredBuffer<LightCluster>*	mLightClusterBuffer;
+	StructuredBuffer<u32>*			mLightIndexBuffer;
+	u32								mLightIndexCapacity;
+	//---------------
+
+	u32 mWindowWidth;
+	u32 mWindowHeight;
+	u32 MSAA_Samples;
+	u32 mShadowTextureDim;
+
+	// shortcut for System::Instance()->mScene
+	Scene& mScene;
+
+	//---------------
+	StructuredBuffer<DirectionalLight>*		mDirLights;
+	StructuredBuffer<PointLight>*			mPointLights;
+	StructuredBuffer<SpotLight>*			mSpotLights;
+	//---------------
+	PointLightSet					mPointLightSet;
+	std::vector<LightRange>			mPointLightRanges;		// scratch for UploadLights()
+	DirectionalLight				mWorkingDirLights  [MAX_LIGHTS];
+	SpotLight						mWorkingSpotLights [MAX_LIGHTS];
+	u32 mDirLightCount,   mDirLightUICount;
+	u32 mPointLightCount, mPointLightUICount;
+	u32 mSpotLightCount,  mSpotLightUICount;
+	f32 mAnimationTime, mPreviousAnimationTime;		// where the last step ended, and started
+	f32 mSunAngle,      mPreviousSunAngle;
+	//---------------
+	u32 mLightSphereIndexCount;
+	//---------------
+	RenderSnapshot			mLocalSnapshot;		// DrawScene()'s, written on the calling thread
+	const RenderSnapshot*	mSnapshot;			// the one being drawn
+
+	//////////////////////////////////////////////////////////////////////////
+
+	virtual void Initialize(int windowWidth, int windowHeight);
+	// One animation step: the sun and the lights
+	virtual void UpdateScene( float dt );
+	// The UI's point light count, the lights between the last two steps
+	virtual void UpdateFrame( float alpha );
+	// Draws a snapshot of the current state
+	virtual void DrawScene();
+	//---------------
+	// Camera, objects and lights as the update left them; the point lights changed since the last one
+	void WriteSnapshot(RenderSnapshot& snapshot);
+	void DrawScene(const RenderSnapshot& snapshot);
+	virtual void Shutdown();
+	virtual void ResizeWindow(int newSizeWidth, int newSizeHeight);
+
+	//------------
+
+	virtual void SetWireframe(BOOL state);
+	virtual void SetMSAA(u32 MSAAsamples);
+	virtual void InstantiateModel(string filename);
+	virtual void InstantiatePrimitive(string name);
+	virtual void LoadSkybox(string name);
+
+	//////////////////////////////////////////////////////////////////////////
+
+	void DrawLightSpheres(const char* pass, BOOL bSun = false);
+	void DrawGizmos();
+	//---------------
+	void UpdateShadowCamera();
+	//---------------
+	void ComputeFrustumFlags();
+	void ClearFrustumFlags();
+	//---------------
+	void BuildRenderQueues(BOOL bShadows);
+	void SubmitRenderQueue(const char* shaderPass);
+	void SubmitShadowQueue(const char* shaderPass, u32 currentPartition, u32 layers);
+	//---------------
+	void SetActiveDirLights(  int activeLights);
+	void SetActivePointLights(int activeLights);
+	void SetActiveSpotLights( int activeLights);
+	void UploadLights();
+	void UploadPointLights(const std::vector<LightRange>& ranges);
+	BOOL BuildLightClusters();
+
+	//////////////////////////////////////////////////////////////////////////
+
+	void RenderForward();
+	//-----------
+	void RenderGBuffer();
+	void ComputeLighting();
+	//-----------
+	void RenderSkybox(BOOL deferredRendering);
+
+	//////////////////////////////////////////////////////////////////////////
+
+	void ComputeSDSMPartitions();
+	void CullShadowCasters();
+	u64  ShadowPartitionKey(u32 currentPartition);
+	void RenderShadowDepth(u32 currentPartition, ShadowCacheAction action);
+	void DrawShadowCasters(u32 currentPartition, u32 layers);
+	void ConvertToEVSM(u32 partitionIndex);
+	void AccumulateLighting(u32 partitionIndex);
+	void BoxBlur(u32 partitionIndex);
+	void RenderScreenQuad(const char* pass);
+};
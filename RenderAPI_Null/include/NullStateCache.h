@@ -0,0 +1,55 @@
+#pragma once
+
+#include "Types.h"
+#include "../../RamJamEngine/include/StateCache.h"
+
+struct NullDevice;
+
+//////////////////////////////////////////////////////////////////////////
+// Same entry points as ID3D11DeviceContext, recorded as NullDevice state
+// changes. Resources are only identities here: a mesh passes the address
+// of its buffer size, pass-level bindings a string literal.
+struct NullContext
+{
+	NullDevice* mDevice;
+
+	void IASetVertexBuffers(u32 startSlot, u32 numBuffers, const void* const* buffers, const u32* strides, const u32* offsets);
+	void IASetIndexBuffer(const void* buffer, u32 format, u32 offset);
+	void IASetInputLayout(const void* layout);
+	void IASetPrimitiveTopology(u32 topology);
+	void RSSetState(const void* state);
+	void OMSetBlendState(const void* state, const float* blendFactor, u32 sampleMask);
+	void PSSetShaderResources(u32 startSlot, u32 numViews, const void* const* views);
+	void OMSetRenderTargets(u32 numViews, const void* const* renderTargets, const void* depthStencil);
+	void CSSetUnorderedAccessViews(u32 startSlot, u32 numViews, const void* const* views, const u32* initialCounts);
+};
+
+//////////////////////////////////////////////////////////////////////////
+enum NullTopology
+{
+	NullTopology_LineList      = 2,	// D3D11_PRIMITIVE_TOPOLOGY values
+	NullTopology_TriangleList  = 4,
+	NullTopology_TriangleStrip = 5,
+};
+
+//////////////////////////////////////////////////////////////////////////
+struct NullStateTraits
+{
+	typedef NullContext		Context;
+	typedef int				Result;
+	typedef const void		Buffer;
+	typedef u32				Format;
+	typedef const void		InputLayout;
+	typedef u32				Topology;
+	typedef const void		RasterizerState;
+	typedef const void		BlendState;
+	typedef const void		ShaderResource;
+	typedef const void		RenderTarget;
+	typedef const void		DepthStencil;
+	typedef const void		UnorderedAccess;
+	typedef const char		Pass;			// technique name, always a string literal
+
+	static int Apply(const char* pass, NullContext* context);
+};
+
+typedef StateCache<NullStateTraits> NullStateCache;
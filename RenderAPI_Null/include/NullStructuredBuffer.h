@@ -0,0 +1,43 @@
+#pragma once
+
+#include "NullDevice.h"
+
+// Same interface as the DX11 StructuredBuffer: the data goes into a CPU
+// array and every MapDiscard/Unmap pair counts as one full upload, every
+// UpdateRange() as an upload of its elements.
+template <typename T>
+class StructuredBuffer
+{
+public:
+	StructuredBuffer(NullDevice* device, int elements)
+		: mElements(elements), mData(elements)
+	{
+		device->CreateBuffer(sizeof(T) * elements, "StructuredBuffer");
+	}
+
+	int GetElementCount() const { return mElements; }
+
+	T* MapDiscard(NullDevice* device)
+	{
+		UNREFERENCED_PARAMETER(device);
+		return mData.empty() ? nullptr : &mData.front();
+	}
+	void Unmap(NullDevice* device)
+	{
+		device->Upload(sizeof(T) * mElements, "StructuredBuffer");
+	}
+	void UpdateRange(NullDevice* device, const T* data, u32 first, u32 count)
+	{
+		RJE_ASSERT(first + count <= (u32)mElements);
+		std::copy(data, data + count, mData.begin() + first);
+		device->Upload(sizeof(T) * count, "StructuredBuffer");
+	}
+
+private:
+	// Not implemented
+	StructuredBuffer(const StructuredBuffer&);
+	StructuredBuffer& operator=(const StructuredBuffer&);
+
+	int				mElements;
+	std::vector<T>	mData;
+};
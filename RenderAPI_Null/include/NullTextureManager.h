@@ -0,0 +1,52 @@
+#pragma once
+
+#include "NullHelper.h"
+
+//////////////////////////////////////////////////////////////////////////
+// Keeps the texture names so materials resolve the same way as with DX11.
+// Loading only reads the file size to account for the upload.
+struct NullTextureManager
+{
+	NullDevice*		mDevice;
+	u32				mTextureCount;
+	std::unordered_map<std::string, ShaderResource*>	mTextures;
+
+	//-----------------------------
+
+	NullTextureManager() : mDevice(nullptr), mTextureCount(0) {}
+
+	//-----------------------------
+
+	void Initialize( NullDevice* device );
+	void ReleaseTextures();
+	//------------
+	BOOL IsTextureLoaded(std::string textureName);
+	void LoadTexture(string texturePath, string textureName);
+	void LoadTextureFromPath(string texturePath, ShaderResource** shaderResourceView);
+	void Create2DTextureFixedColor(i32 size, RJE_COLOR::Color color, std::string textureName);
+
+	//------
+	static NullTextureManager* Instance()
+	{
+		if(!sInstance)
+			sInstance = new NullTextureManager();
+
+		return sInstance;
+	}
+	//------
+	static void DeleteInstance()
+	{
+		if(sInstance)
+		{
+			sInstance->ReleaseTextures();
+			delete sInstance;
+			sInstance = nullptr;
+		}
+	}
+
+private:
+	static NullTextureManager* sInstance;
+	//------
+	// Returns the file size
+	u64 UploadFile(const string& texturePath);
+};
@@ -0,0 +1,109 @@
+#include "NullDevice.h"
+
+//////////////////////////////////////////////////////////////////////////
+void NullCommandStats::Accumulate(const NullCommandStats& stats)
+{
+	mDrawCalls         += stats.mDrawCalls;
+	mIndicesDrawn      += stats.mIndicesDrawn;
+	mDispatches        += stats.mDispatches;
+	mStateChanges      += stats.mStateChanges;
+	mConstantUpdates   += stats.mConstantUpdates;
+	mShaderApplies     += stats.mShaderApplies;
+	mStatesFiltered    += stats.mStatesFiltered;
+	mMaterialsFiltered += stats.mMaterialsFiltered;
+	mAppliesFiltered   += stats.mAppliesFiltered;
+	mClears            += stats.mClears;
+	mBufferUploads     += stats.mBufferUploads;
+	mUploadBytes       += stats.mUploadBytes;
+	mBufferCreates     += stats.mBufferCreates;
+	mCreateBytes       += stats.mCreateBytes;
+	mTextureLoads      += stats.mTextureLoads;
+}
+
+//////////////////////////////////////////////////////////////////////////
+NullDevice::NullDevice()
+{
+	mFrameCount = 0;
+	mbInFrame   = false;
+	mbTrace     = false;
+	//------
+	mContext.mDevice = this;
+	mStateCache.SetContext(&mContext);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void NullDevice::BeginFrame()
+{
+	mFrameStats.Reset();
+	mStateCache.mStats.Reset();
+	mbInFrame = true;
+}
+//-------------
+void NullDevice::EndFrame()
+{
+	const StateCacheStats& cacheStats = mStateCache.mStats;
+	mFrameStats.mStatesFiltered    = cacheStats.StateFiltered();
+	mFrameStats.mMaterialsFiltered = cacheStats.mFiltered[StateCache_Material];
+	mFrameStats.mAppliesFiltered   = cacheStats.mFiltered[StateCache_Apply];
+
+	mTotalStats.Accumulate(mFrameStats);
+	mbInFrame = false;
+	++mFrameCount;
+}
+//-------------
+void NullDevice::ResetTotals()
+{
+	mFrameStats.Reset();
+	mTotalStats.Reset();
+	mLoadStats.Reset();
+	mFrameCount = 0;
+	mTrace.clear();
+}
+
+//////////////////////////////////////////////////////////////////////////
+void NullContext::IASetVertexBuffers(u32, u32, const void* const*, const u32*, const u32*)	{ mDevice->SetState("IASetVertexBuffers"); }
+void NullContext::IASetIndexBuffer(const void*, u32, u32)									{ mDevice->SetState("IASetIndexBuffer"); }
+void NullContext::IASetInputLayout(const void*)												{ mDevice->SetState("IASetInputLayout"); }
+void NullContext::IASetPrimitiveTopology(u32)												{ mDevice->SetState("IASetPrimitiveTopology"); }
+void NullContext::RSSetState(const void*)													{ mDevice->SetState("RSSetState"); }
+void NullContext::OMSetBlendState(const void*, const float*, u32)							{ mDevice->SetState("OMSetBlendState"); }
+void NullContext::PSSetShaderResources(u32, u32, const void* const*)						{ mDevice->SetState("PSSetShaderResources"); }
+void NullContext::OMSetRenderTargets(u32, const void* const*, const void*)					{ mDevice->SetState("OMSetRenderTargets"); }
+void NullContext::CSSetUnorderedAccessViews(u32, u32, const void* const*, const u32*)		{ mDevice->SetState("CSSetUnorderedAccessViews"); }
+//-------------
+int NullStateTraits::Apply(const char* pass, NullContext* context)
+{
+	context->mDevice->Apply(pass);
+	return 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+const char* NullDevice::CommandName(u32 type)
+{
+	static const char* names[NullCmd_Count] = { "Draw", "Dispatch", "State", "Constants", "Apply", "Clear", "Upload", "CreateBuffer", "LoadTexture" };
+	return type < NullCmd_Count ? names[type] : "Unknown";
+}
+
+//////////////////////////////////////////////////////////////////////////
+void NullDevice::DumpTrace(FILE* file) const
+{
+	for (const NullCommand& cmd : mTrace)
+	{
+		if (cmd.mArg)
+			fprintf(file, "%6u  %-12s %-28s %llu\n", cmd.mFrame, CommandName(cmd.mType), cmd.mName, (unsigned long long)cmd.mArg);
+		else
+			fprintf(file, "%6u  %-12s %s\n", cmd.mFrame, CommandName(cmd.mType), cmd.mName);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+void NullDevice::PrintStats(FILE* file, const NullCommandStats& stats, u32 frameCount)
+{
+	// Per frame averages when frameCount > 1, raw values otherwise
+	double n = frameCount > 1 ? (double)frameCount : 1.0;
+	fprintf(file, "  draws %9.1f   indices %11.0f   dispatches %6.1f\n", stats.mDrawCalls/n, stats.mIndicesDrawn/n, stats.mDispatches/n);
+	fprintf(file, "  states %8.1f   constants %9.1f   applies %9.1f   clears %5.1f\n", stats.mStateChanges/n, stats.mConstantUpdates/n, stats.mShaderApplies/n, stats.mClears/n);
+	fprintf(file, "  filtered: states %8.1f   materials %9.1f   applies %9.1f\n", stats.mStatesFiltered/n, stats.mMaterialsFiltered/n, stats.mAppliesFiltered/n);
+	fprintf(file, "  uploads %7.1f   upload KB %9.1f   buffers created %u (%.1f KB)   textures %u\n",
+			stats.mBufferUploads/n, stats.mUploadBytes/n/1024.0, stats.mBufferCreates, stats.mCreateBytes/1024.0, stats.mTextureLoads);
+}
@@ -0,0 +1,60 @@
+#include "NullDrawable.h"
+
+//////////////////////////////////////////////////////////////////////////
+NullDrawable::NullDrawable()
+{
+	mTransform = nullptr;
+	//------
+	mMesh  = nullptr;
+	mGizmo = nullptr;
+	//------
+	mGizmoColor = Color::White;
+}
+//-----------
+NullDrawable::~NullDrawable()
+{
+	if (mMesh)
+	{
+		mMesh->Destroy();
+		delete mMesh;
+		mMesh = nullptr;
+	}
+	if (mGizmo)
+	{
+		mGizmo->Destroy();
+		delete mGizmo;
+		mGizmo = nullptr;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+void NullDrawable::Render(const char* shaderPass, BOOL bDrawOpaque /*= true*/)
+{
+	NullStateCache& stateCache = NullMesh::sDevice->mStateCache;
+
+	NullMesh::sDevice->SetConstant("SetWorld");
+	stateCache.MarkEffectDirty();
+	for (u32 iSubset=0 ; iSubset<mMesh->mSubsetCount; ++iSubset)
+	{
+		if (mMesh->mSubsets[iSubset].mbIsInFrustum)
+		{
+			if (mMesh->mMaterial[iSubset]->mIsOpaque == bDrawOpaque)
+			{
+				if (stateCache.NeedsMaterial(mMesh->mMaterial[iSubset]->mSortId))
+					NullMesh::sDevice->SetConstant("SetMaterial");
+				stateCache.ApplyIfDirty(shaderPass);
+				mMesh->Render(iSubset);
+			}
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+void NullDrawable::RenderGizmo(const char* shaderPass)
+{
+	NullMesh::sDevice->SetConstant("SetColor");
+	NullMesh::sDevice->SetConstant("SetWorld");
+
+	NullMesh::sDevice->mStateCache.Apply(shaderPass);
+	mGizmo->Render(-1);
+}
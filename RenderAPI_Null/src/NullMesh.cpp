@@ -0,0 +1,466 @@
+#include "NullMesh.h"
+#include "../../RamJamEngine/include/GeometryGenerator.h"
+#include "../../RamJamEngine/include/stdafx.h"
+
+//////////////////////////////////////////////////////////////////////////
+NullMesh*				NullMesh::sInstance      = nullptr;
+NullDevice*				NullMesh::sDevice        = nullptr;
+u32		NullMesh::sTotalVertexCount    = 0;
+u32		NullMesh::sTotalPrimitiveCount = 0;
+
+//////////////////////////////////////////////////////////////////////////
+NullMesh::NullMesh()
+{
+	mVertexBuffer = 0;
+	mIndexBuffer  = 0;
+	mVertexData   = nullptr;
+	mIndexData    = nullptr;
+	//--------
+	mSubsets = nullptr;
+	mSubsetCount = 1;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void NullMesh::SetDevice(NullDevice* device)
+{
+	sDevice = device;
+	//--------
+	sTotalVertexCount    = 0;
+	sTotalPrimitiveCount = 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void NullMesh::Destroy()
+{
+	RJE_SAFE_DELETE_PTR((char*&)mVertexData);
+	RJE_SAFE_DELETE_PTR(mIndexData);
+	//-------
+	RJE_SAFE_DELETE_PTR(mSubsets);
+	//-------
+	if (mVertexBuffer)	MemoryBudget::Instance()->Remove(Memory_Meshes, BudgetOwner(), mVertexBuffer);
+	if (mIndexBuffer)	MemoryBudget::Instance()->Remove(Memory_Meshes, BudgetOwner(), mIndexBuffer);
+	mVertexBuffer = 0;
+	mIndexBuffer  = 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void NullMesh::CreateVertexBuffer(void* vertexData)
+{
+	UNREFERENCED_PARAMETER(vertexData);
+	mVertexBuffer = mByteWidth;
+	sDevice->CreateBuffer(mVertexBuffer, "VertexBuffer");
+	if (mVertexBuffer)
+		MemoryBudget::Instance()->Add(Memory_Meshes, BudgetOwner(), mVertexBuffer);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void NullMesh::CreateIndexBuffer(u32* indexData)
+{
+	UNREFERENCED_PARAMETER(indexData);
+	mIndexBuffer = sizeof(u32) * mIndexTotalCount;
+	sDevice->CreateBuffer(mIndexBuffer, "IndexBuffer");
+	if (mIndexBuffer)
+		MemoryBudget::Instance()->Add(Memory_Meshes, BudgetOwner(), mIndexBuffer);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void NullMesh::Render(u32 subset)
+{
+	Bind();
+	Draw(subset);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void NullMesh::Bind()
+{
+	const void* vertexBuffer = &mVertexBuffer;
+	u32 stride = mDataSize;
+	u32 offset = 0;
+	sDevice->mStateCache.IASetVertexBuffers(0, 1, &vertexBuffer, &stride, &offset);
+	sDevice->mStateCache.IASetIndexBuffer(&mIndexBuffer, 0, 0);
+}
+//-----------
+void NullMesh::Draw(u32 subset)
+{
+	if(subset==UINT_MAX)
+		sDevice->DrawIndexed(mIndexTotalCount, "DrawIndexed");
+	else
+		sDevice->DrawIndexed(mSubsets[subset].mIndexCount, "DrawIndexed");
+}
+
+//////////////////////////////////////////////////////////////////////////
+void NullMesh::LoadMaterialFromFile(std::string materialFile )
+{
+	unique_ptr<Material> material (new Material);
+
+	// first we set all the properties from the material file
+	CIniFile::OpenFile(FileSystem::NativePath(RJE_GLOBALS::gDataPath + "materials\\" + materialFile));
+	material->LoadPropertiesFromFile(materialFile);
+
+	CIniFile::CloseFile();
+	mMaterial.push_back(std::move(material));
+}
+
+//////////////////////////////////////////////////////////////////////////
+void NullMesh::LoadMaterialLibraryFromFile(std::string materialLibraryFile)
+{
+	string material;
+	int tokenPos     = (int)materialLibraryFile.rfind("\\");
+	string matFolder = materialLibraryFile.substr(0, tokenPos);
+	ifstream matLibFile (FileSystem::NativePath(RJE_GLOBALS::gDataPath + "materials\\" + materialLibraryFile));
+	if (matLibFile.is_open())
+	{
+		while ( getline (matLibFile,material) )
+		{
+			CheckMaterialFile(matFolder + "\\" + material);
+			LoadMaterialFromFile(matFolder + "\\" + material);
+		}
+		matLibFile.close();
+	}
+	else
+	{
+		RJE_PRINT("material library file not found: %s\n", materialLibraryFile.c_str());
+		return;
+	}
+	matLibFile.close();
+}
+
+//////////////////////////////////////////////////////////////////////////
+void NullMesh::CheckMaterialFile(string materialFile)
+{
+	ifstream matFile (FileSystem::NativePath(RJE_GLOBALS::gDataPath + "materials\\" + materialFile));
+	if (!matFile.is_open())
+	{
+		std::ofstream out (FileSystem::NativePath(RJE_GLOBALS::gDataPath + "materials\\" + materialFile));
+		out << "[shader]\n";
+		out << "Name=basic\n";
+		out << "# ----------------------\n";
+		out << "[properties]\n";
+		out << "Transparency=false\n";
+		out << "Albedo=1.0|1.0|1.0|1.0\n";
+		out << "SpecularAmount=0.0\n";
+		out << "SpecularPower=0.0\n";
+		out << "# ----------------------\n";
+		out << "[textures]\n";
+		out << "Texture_Diffuse=NONE\n";
+		out << "Tiling=1.0|1.0\n";
+		out << "Offset=0.0|0.0\n";
+		out << "Rotation=0.0\n";
+		out << "# ----------------------";
+		out.close();
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+void NullMesh::LoadModelFromFile(std::string filePath)
+{
+	FILE* fIn = fopen(FileSystem::NativePath(filePath).c_str(), "rb");
+
+	if(!fIn)
+	{
+		RJE_PRINT("model file not found: %s\n", filePath.c_str());
+		mSubsetCount = 0;		// drawn as nothing
+		return;
+	}
+	mName = filePath;
+	u32 modelTriangleCount = 0;
+	fread(&mSubsetCount, sizeof(u32), 1, fIn);
+	mSubsets = rje_new Subset[mSubsetCount];
+	for (u32 iMesh=0 ; iMesh<mSubsetCount ; ++iMesh)
+	{
+		fread(&mSubsets[iMesh].mVertexStart, sizeof(u32), 1, fIn);
+		fread(&mSubsets[iMesh].mIndexStart,  sizeof(u32), 1, fIn);
+		fread(&mSubsets[iMesh].mVertexCount, sizeof(u32), 1, fIn);
+		fread(&mSubsets[iMesh].mIndexCount,  sizeof(u32), 1, fIn);
+		// multiply by 3 because a triangle has 3 indexes
+		mSubsets[iMesh].mIndexStart *= 3;
+		mSubsets[iMesh].mIndexCount *= 3;
+	}
+	fread(&mVertexTotalCount,  sizeof(u32), 1, fIn);
+	fread(&modelTriangleCount, sizeof(u32), 1, fIn);
+	//---------
+	sTotalVertexCount    += mVertexTotalCount;
+	sTotalPrimitiveCount += modelTriangleCount;
+	//---------
+	mIndexTotalCount  = 3*modelTriangleCount;
+	mInputLayout = MeshData::RJE_InputLayout::RJE_IL_PosNormTanTex;
+
+	// 	switch (mInputLayout)
+	// 	{
+	// 	case MeshData::RJE_IL_PosNormalTex:		mDataSize = (u32) sizeof(MeshData::PosNormalTex);		mByteWidth = mDataSize * mVertexTotalCount;	break;
+	// 	case MeshData::RJE_IL_PosNormTanTex:	mDataSize = (u32) sizeof(MeshData::PosNormTanTex);		mByteWidth = mDataSize * mVertexTotalCount;	break;
+	// 	case MeshData::RJE_IL_PosColor:			mDataSize = (u32) sizeof(MeshData::ColorVertex);		mByteWidth = mDataSize * mVertexTotalCount;	break;
+	// 	default:	break;
+	// 	}
+
+	mDataSize   = (u32) sizeof(MeshData::PosNormTanTex);
+	mByteWidth  = mDataSize * mVertexTotalCount;
+	mVertexData = rje_new char[mByteWidth];
+	mIndexData  = rje_new u32[mIndexTotalCount];
+
+	//---------------
+	// Data Layout (in that order)
+	// Position (xyz)
+	// Normal   (xyz)
+	// Tangent  (xyz)
+	// TexCoord (uv)
+	// Total : 11 floats
+	//---------------
+	const u32 layoutElementCount = 11;
+	float data = 0;
+	u32 currentVertex = 0;
+	u32 currentSubset = 0;
+	// AABB Min Max points
+	Vector3 vMin = Vector3(RJE::Math::Infinity_f, RJE::Math::Infinity_f, RJE::Math::Infinity_f);
+	Vector3 vMax = -vMin;
+	Vector3 vTemp;
+	for(u32 i = 0; i < mVertexTotalCount*layoutElementCount; ++i)
+	{
+		// Store geometric data
+		fread(&data, 4, 1, fIn);
+		memcpy((float*)mVertexData+i, &data, 4);
+
+		// Compute AABB
+		if (i % layoutElementCount == 0)	// Position x
+			vTemp.x = data;
+		if (i % layoutElementCount == 1)	// Position y
+			vTemp.y = data;
+		if (i % layoutElementCount == 2)	// Position z
+		{
+			vTemp.z = data;
+			vMin = Vector3::Min(vMin, vTemp);
+			vMax = Vector3::Max(vMax, vTemp);
+		}
+
+		// The subset ends on the last element of its last vertex
+		currentVertex = i / layoutElementCount;
+		if (i % layoutElementCount == layoutElementCount-1 && currentSubset < mSubsetCount &&
+			currentVertex+1 == mSubsets[currentSubset].mVertexStart + mSubsets[currentSubset].mVertexCount)
+		{
+			mSubsets[currentSubset].mCenter  = 0.5f*(vMin+vMax);
+			mSubsets[currentSubset].mExtents = 0.5f*(vMax-vMin);
+			mSubsets[currentSubset].mRadius = mSubsets[currentSubset].mExtents.Magnitude();
+			vMin = Vector3(RJE::Math::Infinity_f, RJE::Math::Infinity_f, RJE::Math::Infinity_f);
+			vMax = -vMin;
+			++currentSubset;
+		}
+	}
+	for(u32 i = 0; i < modelTriangleCount; ++i)
+	{
+		fread(&mIndexData[i*3+0], sizeof(u32), 1, fIn);
+		fread(&mIndexData[i*3+1], sizeof(u32), 1, fIn);
+		fread(&mIndexData[i*3+2], sizeof(u32), 1, fIn);
+	}
+
+	fclose(fIn);
+
+	//-----------------
+
+	CreateVertexBuffer(mVertexData);
+	CreateIndexBuffer(mIndexData);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void NullMesh::LoadBox(float width, float height, float depth)
+{
+	MeshData::Data<PosNormTanTex> box;
+	GeometryGenerator geoGen;
+
+	geoGen.CreateBox(width, height, depth, box);
+	LoadPrimitive(box);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void NullMesh::LoadSphere(float radius, u32 sliceCount, u32 stackCount)
+{
+	MeshData::Data<PosNormTanTex> sphere;
+	GeometryGenerator geoGen;
+
+	geoGen.CreateSphere(radius, sliceCount, stackCount, sphere);
+	LoadPrimitive(sphere);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void NullMesh::LoadGeoSphere(float radius, u32 numSubdivisions)
+{
+	MeshData::Data<PosNormTanTex> sphere;
+	GeometryGenerator geoGen;
+
+	geoGen.CreateGeosphere(radius, numSubdivisions, sphere);
+	LoadPrimitive(sphere);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void NullMesh::LoadCylinder(float bottomRadius, float topRadius, float height, u32 sliceCount, u32 stackCount)
+{
+	MeshData::Data<PosNormTanTex> cylinder;
+	GeometryGenerator geoGen;
+
+	geoGen.CreateCylinder(bottomRadius, topRadius, height, sliceCount, stackCount, cylinder);
+	LoadPrimitive(cylinder);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void NullMesh::LoadGrid(float width, float depth, u32 rows, u32 columns)
+{
+	MeshData::Data<PosNormTanTex> grid;
+	GeometryGenerator geoGen;
+
+	geoGen.CreateGrid(width, depth, rows, columns, grid);
+	LoadPrimitive(grid);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void NullMesh::LoadWireBox( float width, float height, float depth, Color color )
+{
+	MeshData::Data<ColorVertex> box;
+	GeometryGenerator geoGen;
+
+	geoGen.CreateWireBox(width, height, depth, box, color);
+	LoadPrimitive(box);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void NullMesh::LoadWireSphere( float radius, Color color )
+{
+	MeshData::Data<ColorVertex> sphere;
+	GeometryGenerator geoGen;
+
+	geoGen.CreateWireSphere(radius, sphere, color);
+	LoadPrimitive(sphere);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void NullMesh::LoadWireCone( float length, float angle, Color color )
+{
+	MeshData::Data<ColorVertex> cone;
+	GeometryGenerator geoGen;
+
+	geoGen.CreateWireCone(length, angle, cone, color);
+	LoadPrimitive(cone);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void NullMesh::LoadWireFrustum( Vector3 right, Vector3 up, Vector3 forward, float fovX, float ratio, float nearPlaneDepth, float farPlaneDepth, Color color )
+{
+	MeshData::Data<ColorVertex> frustum;
+	GeometryGenerator geoGen;
+
+	geoGen.CreateWireFrustum(right, up, forward, fovX, ratio, nearPlaneDepth, farPlaneDepth, frustum, color);
+	LoadPrimitive(frustum);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void NullMesh::LoadAxisArrows( Vector3 right, Vector3 up, Vector3 forward)
+{
+	MeshData::Data<ColorVertex> axis;
+	GeometryGenerator geoGen;
+
+	geoGen.CreateAxisArrows(right, up, forward, axis);
+	LoadPrimitive(axis);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void NullMesh::LoadLine( Vector3 start, Vector3 end, Color color )
+{
+	MeshData::Data<ColorVertex> line;
+	GeometryGenerator geoGen;
+
+	geoGen.CreateLine(start, end, line, color);
+	LoadPrimitive(line);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void NullMesh::LoadRay( Vector3 start, Vector3 orientation, Color color )
+{
+	MeshData::Data<ColorVertex> ray;
+	GeometryGenerator geoGen;
+
+	geoGen.CreateRay(start, orientation, ray, color);
+	LoadPrimitive(ray);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void NullMesh::LoadPrimitive(MeshData::Data<ColorVertex>& meshData)
+{
+	mInputLayout = MeshData::RJE_InputLayout::RJE_IL_PosColor;
+	mVertexTotalCount = (u32) meshData.Vertices.size();
+	mIndexTotalCount  = (u32) meshData.Indices.size();
+	mDataSize    = (u32) sizeof(MeshData::ColorVertex);
+	mByteWidth   = mDataSize * mVertexTotalCount;
+
+	mVertexData = rje_new char[mByteWidth];
+	mIndexData  = rje_new u32[mIndexTotalCount];
+
+	for (u32 i=0; i<mVertexTotalCount; ++i)
+	{
+		memcpy((float*)mVertexData+4*i+0, &meshData.Vertices[i].pos.x, 4);
+		memcpy((float*)mVertexData+4*i+1, &meshData.Vertices[i].pos.y, 4);
+		memcpy((float*)mVertexData+4*i+2, &meshData.Vertices[i].pos.z, 4);
+		memcpy((float*)mVertexData+4*i+3, &meshData.Vertices[i].color, 4);
+	}
+	for (u32 j=0; j<mIndexTotalCount; ++j)
+	{
+		memcpy(&mIndexData[j], &meshData.Indices[j], 4);
+	}
+	CreateVertexBuffer(mVertexData);
+	CreateIndexBuffer(mIndexData);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void NullMesh::LoadPrimitive(MeshData::Data<PosNormTanTex>& meshData)
+{
+	mInputLayout = MeshData::RJE_InputLayout::RJE_IL_PosNormTanTex;
+	mVertexTotalCount = (u32) meshData.Vertices.size();
+	mIndexTotalCount  = (u32) meshData.Indices.size();
+	mDataSize    = (u32) sizeof(MeshData::PosNormTanTex);
+	mByteWidth   = mDataSize * mVertexTotalCount;
+
+	//---------
+	mSubsetCount = 1;
+	mSubsets = rje_new Subset[mSubsetCount];
+	mSubsets[0].mVertexStart = 0;
+	mSubsets[0].mIndexStart  = 0;
+	mSubsets[0].mVertexCount = mVertexTotalCount;
+	mSubsets[0].mIndexCount  = mIndexTotalCount;
+	//---------
+
+	//---------
+	sTotalVertexCount    += mVertexTotalCount;
+	sTotalPrimitiveCount += mIndexTotalCount/3;
+	//---------
+
+	mVertexData = rje_new char[mByteWidth];
+	mIndexData  = rje_new u32[mIndexTotalCount];
+
+	// AABB Min Max points
+	Vector3 vMin = Vector3(RJE::Math::Infinity_f, RJE::Math::Infinity_f, RJE::Math::Infinity_f);
+	Vector3 vMax = -vMin;
+	for (u32 i=0; i<mVertexTotalCount; ++i)
+	{
+		memcpy((float*)mVertexData+11*i+0,  &meshData.Vertices[i].Position.x, 4);
+		memcpy((float*)mVertexData+11*i+1,  &meshData.Vertices[i].Position.y, 4);
+		memcpy((float*)mVertexData+11*i+2,  &meshData.Vertices[i].Position.z, 4);
+		memcpy((float*)mVertexData+11*i+3,  &meshData.Vertices[i].Normal.x,   4);
+		memcpy((float*)mVertexData+11*i+4,  &meshData.Vertices[i].Normal.y,   4);
+		memcpy((float*)mVertexData+11*i+5,  &meshData.Vertices[i].Normal.z,   4);
+		memcpy((float*)mVertexData+11*i+6,  &meshData.Vertices[i].TangentU.x, 4);
+		memcpy((float*)mVertexData+11*i+7,  &meshData.Vertices[i].TangentU.y, 4);
+		memcpy((float*)mVertexData+11*i+8,  &meshData.Vertices[i].TangentU.z, 4);
+		memcpy((float*)mVertexData+11*i+9,  &meshData.Vertices[i].TexC.x,     4);
+		memcpy((float*)mVertexData+11*i+10, &meshData.Vertices[i].TexC.y,     4);
+
+		// Compute AABB
+		vMin = Vector3::Min(vMin, meshData.Vertices[i].Position);
+		vMax = Vector3::Max(vMax, meshData.Vertices[i].Position);
+	}
+	mSubsets[0].mCenter  = 0.5f*(vMin+vMax);
+	mSubsets[0].mExtents = 0.5f*(vMax-vMin);
+	mSubsets[0].mRadius = mSubsets[0].mExtents.Magnitude();
+	for (u32 j=0; j<mIndexTotalCount; ++j)
+	{
+		memcpy(&mIndexData[j], &meshData.Indices[j], 4);
+	}
+	CreateVertexBuffer(mVertexData);
+	CreateIndexBuffer(mIndexData);
+}
@@ -0,0 +1,1110 @@
+#include "NullRenderingAPI.h"
+#include "../../RamJamEngine/include/GeometryGenerator.h"
+#include "../../RamJamEngine/include/stdafx.h"
+
+
+NullRenderingAPI::~NullRenderingAPI() {}
+
+//////////////////////////////////////////////////////////////////////////
+NullRenderingAPI::NullRenderingAPI(Scene& scene) : mScene(scene)
+{
+	mNullDevice = nullptr;
+	//-----------
+	VSyncEnabled        = false;
+	mbUseFrustumCulling = true;
+	mbUseAABB           = true;
+	mbUseRenderQueue    = true;
+	mbCullShadowCasters = true;
+	mbUseLightClusters  = true;
+	mRenderedSubsets    = 0;
+	mTotalSubsets       = 0;
+	//-----------
+	mWindowWidth      = 0;
+	mWindowHeight     = 0;
+	MSAA_Samples      = MSAA_SAMPLES;
+	mShadowTextureDim = 1024;
+	//-----------
+	mLightClusterBuffer = nullptr;
+	mLightIndexBuffer   = nullptr;
+	mLightIndexCapacity = 0;
+	mSnapshot           = nullptr;
+	//-----------
+	mAnimationTime         = 0.0f;
+	mPreviousAnimationTime = 0.0f;
+	mSunAngle              = 0.0f;
+	mPreviousSunAngle      = 0.0f;
+
+	// Light Specs (same random setup as DX11RenderingAPI so both backends animate the same scene)
+	mDirLights   = nullptr;
+	mPointLights = nullptr;
+	mSpotLights  = nullptr;
+	for (int i = 0; i < MAX_LIGHTS; i++)
+	{
+		float radius = RJE::Math::Rand(0.0f, 1.0f);
+		float height = RJE::Math::Rand(0.0f, 1.0f);
+		mPointLightSet.mOrbitRadius[i] = sqrt(radius);
+		mPointLightSet.mOrbitHeight[i] = sqrt(height);
+		mPointLightSet.mOrbitAngle[i]  = RJE::Math::Rand(0.0f,RJE::Math::Pi_Two_f);
+		mPointLightSet.mOrbitSpeed[i]  = RJE::Math::Rand(0.1f,2.0f);
+		//--------
+		mWorkingDirLights[i].Color     = Vector4(0.5f, 0.5f, 0.5f, 0.0f);
+		mWorkingDirLights[i].Direction = Vector4(0.57735f, -0.57735f, 0.57735f, 0.0f);
+		//--------
+		float range = RJE::Math::Rand(1.0f,2.5f);
+		mPointLightSet.SetLight(i, Color::GetRandomVector3RGBNorm(), range, range * 0.4f);
+		//--------
+		mWorkingSpotLights[i].Color     = Vector3(0.5f, 0.5f, 0.5f);
+		mWorkingSpotLights[i].Spot      = RJE::Math::Deg2Rad_f * 45.0f;
+		mWorkingSpotLights[i].Range     = 10.0f;
+		mWorkingSpotLights[i].Intensity = 2.0f;
+		mWorkingSpotLights[i].Position  = RJE::Math::Rand(0,1000) * Vector3::RandUnitSphere();
+		mWorkingSpotLights[i].Direction = RJE::Math::Rand(0,1000) * Vector3::RandUnitSphere();
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+void NullRenderingAPI::Initialize(int windowWidth, int windowHeight)
+{
+	mNullDevice = rje_new NullDevice;
+
+	mWindowWidth  = windowWidth;
+	mWindowHeight = windowHeight;
+
+	NullTextureManager::Instance()->Initialize(mNullDevice);
+	NullTextureManager::Instance()->Create2DTextureFixedColor(1, RJE_COLOR::Color::TransDarkGray, "_transparentGray");
+	NullTextureManager::Instance()->Create2DTextureFixedColor(1, RJE_COLOR::Color::White,         "_default");
+	//----------
+	NullMesh::SetDevice(mNullDevice);
+	//-----------
+	SetActivePointLights(0);
+	SetActiveDirLights(0);
+	SetActiveSpotLights(0);
+	//-----------
+	mDirLightUICount   = 1;
+	mPointLightUICount = 0;
+	mSpotLightUICount  = 0;
+	//-----------
+	// Light spheres, screen quad and skybox cube
+	MeshData::Data<PosNormTanTex> sphere;
+	GeometryGenerator geoGen;
+	geoGen.CreateGeosphere(0.1f, 3, sphere);
+	mLightSphereIndexCount = (u32)sphere.Indices.size();
+	mNullDevice->CreateBuffer(sizeof(PosNormTanTex) * sphere.Vertices.size(), "LightSpheresVB");
+	mNullDevice->CreateBuffer(sizeof(u32)           * sphere.Indices.size(),  "LightSpheresIB");
+	mNullDevice->CreateBuffer(sizeof(PosNormTanTex) * 4,  "ScreenQuadVB");
+	mNullDevice->CreateBuffer(sizeof(u32)           * 6,  "ScreenQuadIB");
+	mNullDevice->CreateBuffer(sizeof(PosNormTanTex) * 24, "SkyboxVB");
+	mNullDevice->CreateBuffer(sizeof(u32)           * 36, "SkyboxIB");
+}
+
+//////////////////////////////////////////////////////////////////////////
+void NullRenderingAPI::UpdateScene( float dt )
+{
+	// The step starts where the last one ended
+	mPreviousAnimationTime = mAnimationTime;
+	mPreviousSunAngle      = mSunAngle;
+
+	mAnimationTime += 0.5f*dt;
+	if (mScene.mbAnimateSun)
+		mSunAngle += 0.1f*dt;
+	mPointLightSet.Update(0.5f*dt, mScene.mbAnimateLights, mScene.mPointLightRadius, mScene.mPointLightHeight);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void NullRenderingAPI::UpdateFrame( float alpha )
+{
+	// A new point light count places its lights right away, steps or not
+	u32 pointLightCount = RJE::Math::Min(mPointLightUICount, (u32)MAX_LIGHTS);
+	if (mPointLightSet.mCount != pointLightCount)
+	{
+		mPointLightSet.SetCount(pointLightCount);
+		mPointLightSet.Update(0.0f, false, mScene.mPointLightRadius, mScene.mPointLightHeight);
+	}
+
+	// Alpha 1 is the step itself, to the bit
+	f32 timer    = alpha < 1.0f ? FrameScheduler::Interpolate(mPreviousAnimationTime, mAnimationTime, alpha) : mAnimationTime;
+	f32 sunAngle = alpha < 1.0f ? FrameScheduler::Interpolate(mPreviousSunAngle,      mSunAngle,      alpha) : mSunAngle;
+
+	// The first directional light is the sun used for shadows (i.e. the sun)
+	Vector4 sunDir = Vector4(-1.0f * cosf(sunAngle), -mScene.mSunHeight, -1.0f * sinf(sunAngle), 0.0f);
+	sunDir.Normalize();
+	mWorkingDirLights[0].Direction = sunDir;
+
+	mPointLightSet.Interpolate(alpha);
+
+	u32 spotLightCount = RJE::Math::Min(mSpotLightUICount, (u32)MAX_LIGHTS);
+	for (u32 i = 0; i < spotLightCount; ++i)
+	{
+		mWorkingSpotLights[i].Position.x = (i+1)*cosf(2*i + RJE::Math::Pi_f + timer );
+		mWorkingSpotLights[i].Position.y = 2.0f + cosf( timer );
+		mWorkingSpotLights[i].Position.z =(i+1)*sinf(2*i + RJE::Math::Pi_f + timer );
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+void NullRenderingAPI::WriteSnapshot(RenderSnapshot& snapshot)
+{
+	PROFILE_CPU("Write Snapshot");
+
+	snapshot.mRenderOrigin   = Transform::sRenderOrigin;
+	snapshot.mView           = mCamera->mView;
+	snapshot.mProj           = *mCamera->mCurrentProjectionMatrix;
+	snapshot.mEyePosition    = Transform::ToRenderSpace(mCamera->mTrf.Position);
+	snapshot.mCameraRight    = mCamera->mTrf.Right();
+	snapshot.mCameraSettings = mCamera->mSettings;
+	snapshot.mbOrtho         = mCamera->IsOrtho();
+	snapshot.mSunDirection   = mWorkingDirLights[0].Direction;
+
+	u32 objectCount = (u32)mScene.mGameObjects.size();
+	snapshot.mWorlds       .resize(objectCount);
+	snapshot.mWorldsNoScale.resize(objectCount);
+	snapshot.mScales       .resize(objectCount);
+	snapshot.mVisible      .clear();
+	for (u32 iObject = 0; iObject < objectCount; ++iObject)
+	{
+		const Transform& transform = mScene.mGameObjects[iObject]->mTransform;
+		snapshot.mWorlds[iObject]        = transform.WorldMat;
+		snapshot.mWorldsNoScale[iObject] = transform.WorldMatNoScale;
+		snapshot.mScales[iObject]        = transform.Scale;
+	}
+
+	// The UI's light counts, the point lights' as UpdateFrame() left it
+	snapshot.mDirLights  .assign(mWorkingDirLights,  mWorkingDirLights  + RJE::Math::Min(mDirLightUICount,  (u32)MAX_LIGHTS));
+	snapshot.mSpotLights .assign(mWorkingSpotLights, mWorkingSpotLights + RJE::Math::Min(mSpotLightUICount, (u32)MAX_LIGHTS));
+	snapshot.mPointLights.assign(mPointLightSet.mLights, mPointLightSet.mLights + mPointLightSet.mCount);
+	mPointLightSet.DirtyRanges(snapshot.mPointLightRanges);
+	mPointLightSet.ClearDirty();
+}
+
+//////////////////////////////////////////////////////////////////////////
+void NullRenderingAPI::DrawScene()
+{
+	WriteSnapshot(mLocalSnapshot);
+	DrawScene(mLocalSnapshot);
+}
+
+//------------------------------------------------------------------------
+void NullRenderingAPI::DrawScene(const RenderSnapshot& snapshot)
+{
+	mNullDevice->BeginFrame();
+	mSnapshot = &snapshot;
+
+	UploadLights();
+	UpdateShadowCamera();
+
+	mNullDevice->mStateCache.Invalidate();
+
+	if (mScene.mbViewLightSpace)
+		ClearFrustumFlags();
+	else if (mbUseFrustumCulling)
+		ComputeFrustumFlags();
+
+	if (mbUseRenderQueue)
+		BuildRenderQueues(mScene.mbDeferredRendering && mScene.mbDisplayShadows && mDirLightCount > 0);
+
+	if (mScene.mbDeferredRendering)
+	{
+		RenderGBuffer();
+		ComputeLighting();
+		RenderSkybox(true);
+		DrawGizmos();
+
+		//----------------------------------
+
+		if (mScene.mbDisplayShadows && mDirLightCount > 0)
+		{
+			PROFILE_CPU("Render Shadows");
+
+			ComputeSDSMPartitions();
+			mNullDevice->mStateCache.Invalidate();	// the SDSM reductions use the context directly
+			CullShadowCasters();
+			for (u32 partitionIndex = 0; partitionIndex < PARTITIONS; ++partitionIndex)
+			{
+				ShadowCacheAction action = mShadowCache.Update(partitionIndex, ShadowPartitionKey(partitionIndex));
+				if (action != ShadowCache_Reuse)
+				{
+					RenderShadowDepth(partitionIndex, action);
+					ConvertToEVSM(partitionIndex);
+					if (mScene.mbEdgeSoftening)
+						BoxBlur(partitionIndex);
+					mNullDevice->SetState("GenerateMips");
+				}
+				AccumulateLighting(partitionIndex);
+			}
+			Profiler::Instance()->mProfilerInfos->ShadowPartitionsReused   = mShadowCache.mReused;
+			Profiler::Instance()->mProfilerInfos->ShadowStaticLayersReused = mShadowCache.mStaticReused;
+		}
+	}
+	else
+	{
+		RenderForward();
+		RenderSkybox(false);
+	}
+
+	mNullDevice->SetState("RSSetState");
+	mNullDevice->SetState("OMSetBlendState");
+
+	mNullDevice->mStateCache.mStats.FillProfilerInfos(Profiler::Instance()->mProfilerInfos);
+
+	// No 2d elements, AntTweak GUI or Present: nothing to show them on
+	mNullDevice->EndFrame();
+	mSnapshot = nullptr;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void NullRenderingAPI::RenderForward()
+{
+	PROFILE_CPU("Render Forward");
+
+	// New per pass constants: the first draw must apply
+	mNullDevice->mStateCache.Invalidate();
+
+	mNullDevice->SetState("OMSetRenderTargets");
+	mNullDevice->Clear("ClearRenderTargetView");
+	mNullDevice->Clear("ClearDepthStencilView");
+	mNullDevice->mStateCache.IASetInputLayout("PosNormalTanTex");
+	mNullDevice->mStateCache.IASetPrimitiveTopology(NullTopology_TriangleList);
+	mNullDevice->SetState("RSSetState");
+
+	// Per frame constants: ViewProj, View, Proj, EyePosW, face normals, ambient, sampler,
+	// fog (4), alpha clip, texture state and the 3 light buffers
+	for (u32 i = 0; i < 17; ++i)
+		mNullDevice->SetConstant("BasicFX per frame");
+
+	// Cluster switch, then the 2 cluster buffers and the grid (3)
+	mNullDevice->SetConstant("UseLightClusters");
+	if (BuildLightClusters())
+	{
+		for (u32 i = 0; i < 5; ++i)
+			mNullDevice->SetConstant("BasicFX light clusters");
+	}
+
+	if (mbUseRenderQueue)
+		SubmitRenderQueue("BasicTech");
+	else
+	{
+		// Draw the opaque geometry
+		for(const unique_ptr<GameObject>& gameobject : mScene.mGameObjects)
+		{
+			if (gameobject->mDrawable.mMesh)
+				gameobject->mDrawable.Render("BasicTech");
+		}
+		// Draw the transparent geometry
+		for(const unique_ptr<GameObject>& gameobject_transparent : mScene.mGameObjects)
+		{
+			if (mScene.mbUseBlending)
+				mNullDevice->SetState("RSSetState");
+
+			if (gameobject_transparent->mDrawable.mMesh)
+				gameobject_transparent->mDrawable.Render("BasicTech", false);
+		}
+	}
+
+	// Render the light sphere if requested
+	if (mScene.mbDrawLightSphere)	DrawLightSpheres("BasicTech");
+	if (mScene.mbDrawSun)			DrawLightSpheres("BasicTech", true);
+
+	// Restore default render states
+	mNullDevice->SetState("RSSetState");
+	mNullDevice->SetState("OMSetBlendState");
+}
+
+//////////////////////////////////////////////////////////////////////////
+void NullRenderingAPI::RenderGBuffer()
+{
+	PROFILE_CPU("Render G Buffer");
+
+	// New per pass constants: the first draw must apply
+	mNullDevice->mStateCache.Invalidate();
+
+	mNullDevice->SetState("OMSetRenderTargets");
+	for (u32 i = 0; i < 4; ++i)
+		mNullDevice->Clear("ClearRenderTargetView");
+	mNullDevice->Clear("ClearDepthStencilView");
+	mNullDevice->mStateCache.IASetInputLayout("PosNormalTanTex");
+	mNullDevice->mStateCache.IASetPrimitiveTopology(NullTopology_TriangleList);
+	mNullDevice->SetState("RSSetState");
+
+	// Per frame constants: ViewProj, View, Proj, sampler, EyePosW, fog (4), face normals, normal maps, texture state
+	for (u32 i = 0; i < 12; ++i)
+		mNullDevice->SetConstant("BasicFX per frame");
+
+	if (mbUseRenderQueue)
+		SubmitRenderQueue("DeferredTech");
+	else
+	{
+		// Draw the opaque geometry
+		for(const unique_ptr<GameObject>& gameobject : mScene.mGameObjects)
+		{
+			if (gameobject->mDrawable.mMesh)
+				gameobject->mDrawable.Render("DeferredTech");
+		}
+		// Draw the transparent geometry
+		for(const unique_ptr<GameObject>& gameobject_transparent : mScene.mGameObjects)
+		{
+			if (mScene.mbUseBlending)
+				mNullDevice->SetState("RSSetState");
+
+			if (gameobject_transparent->mDrawable.mMesh)
+				gameobject_transparent->mDrawable.Render("DeferredTech", false);
+		}
+	}
+
+	// Render the light spheres if requested
+	if (mScene.mbDrawLightSphere)	DrawLightSpheres("DeferredTech");
+	if (mScene.mbDrawSun)			DrawLightSpheres("DeferredTech", true);
+
+	// Restore default render states
+	mNullDevice->SetState("RSSetState");
+	mNullDevice->SetState("OMSetBlendState");
+
+	mNullDevice->SetState("OMSetRenderTargets");
+	mNullDevice->Clear("ClearRenderTargetView");
+	mNullDevice->SetState("RSSetState");
+}
+
+//////////////////////////////////////////////////////////////////////////
+void NullRenderingAPI::ComputeLighting()
+{
+	PROFILE_CPU("Compute Lighting");
+
+	// EyePosW, NearFar, View, Proj, per sample shading, light count, ambient, 2 light buffers, frame size, GBuffer
+	for (u32 i = 0; i < 11; ++i)
+		mNullDevice->SetConstant("TiledDeferredFX");
+
+	mNullDevice->mStateCache.Apply("TiledDeferredTech");
+	mNullDevice->SetState("CSSetUnorderedAccessViews");
+
+	u32 dispatchWidth  = (mWindowWidth  + COMPUTE_SHADER_TILE_GROUP_DIM - 1) / COMPUTE_SHADER_TILE_GROUP_DIM;
+	u32 dispatchHeight = (mWindowHeight + COMPUTE_SHADER_TILE_GROUP_DIM - 1) / COMPUTE_SHADER_TILE_GROUP_DIM;
+	mNullDevice->Dispatch(dispatchWidth, dispatchHeight, "TiledDeferred");
+
+	mNullDevice->SetState("CSSetShaderResources");
+	mNullDevice->SetState("CSSetUnorderedAccessViews");
+}
+
+//////////////////////////////////////////////////////////////////////////
+void NullRenderingAPI::RenderSkybox(BOOL deferredRendering)
+{
+	PROFILE_CPU("Render Skybox");
+
+	const void* vertexBuffer = "SkyboxVB";
+	u32 stride = sizeof(MeshData::PosNormTanTex);
+	u32 offset = 0;
+	mNullDevice->mStateCache.IASetVertexBuffers(0, 1, &vertexBuffer, &stride, &offset);
+	mNullDevice->mStateCache.IASetIndexBuffer("SkyboxIB", 0, 0);
+	mNullDevice->mStateCache.IASetInputLayout("PosNormalTanTex");
+	mNullDevice->mStateCache.IASetPrimitiveTopology(NullTopology_TriangleList);
+
+	// Only/Visualize flags (6), GBuffer, frame size, lit buffer
+	if (deferredRendering)
+		for (u32 i = 0; i < 9; ++i)
+			mNullDevice->SetConstant("SkyboxFX deferred");
+
+	mNullDevice->SetConstant("SetWorldViewProj");
+	mNullDevice->SetConstant("SetCubeMap");
+
+	mNullDevice->mStateCache.Apply(deferredRendering ? "SkyboxDeferredTech" : "SkyboxForwardTech");
+	mNullDevice->DrawIndexed(36, "Skybox");
+
+	mNullDevice->SetState("PSSetShaderResources");
+}
+
+//////////////////////////////////////////////////////////////////////////
+void NullRenderingAPI::ComputeSDSMPartitions()
+{
+	// NearFar, View, ViewToLightProj, then the 4 partition constants
+	for (u32 i = 0; i < 7; ++i)
+		mNullDevice->SetConstant("SDSMFX");
+
+	u32 dispatchWidth  = (mWindowWidth  + REDUCE_ZBOUNDS_BLOCK_DIM - 1) / REDUCE_ZBOUNDS_BLOCK_DIM;
+	u32 dispatchHeight = (mWindowHeight + REDUCE_ZBOUNDS_BLOCK_DIM - 1) / REDUCE_ZBOUNDS_BLOCK_DIM;
+
+	// Clear Z bounds, reduce Z bounds, compute partitions, clear bounds, reduce bounds, custom partitions
+	const char* passes[6] = { "ClearZBounds", "ReduceZBounds", "ComputePartitions", "ClearPartitionBounds", "ReduceBounds", "ComputeCustomPartitions" };
+	for (u32 i = 0; i < 6; ++i)
+	{
+		BOOL bFullScreen = (i == 1 || i == 4);
+		mNullDevice->Apply(passes[i]);
+		mNullDevice->SetState("CSSetUnorderedAccessViews");
+		if (bFullScreen)
+			mNullDevice->SetState("CSSetShaderResources");
+		mNullDevice->Dispatch(bFullScreen ? dispatchWidth : 1, bFullScreen ? dispatchHeight : 1, passes[i]);
+	}
+
+	mNullDevice->SetState("CSSetShaderResources");
+	mNullDevice->SetState("CSSetUnorderedAccessViews");
+
+	//----------------------------------
+	// No depth buffer to reduce: the partitions are estimated from the view
+	// depth range of the visible subsets, with the DX11 border and max scale
+	const float maxFloat = RJE::Math::Infinity_f;
+	Vector2 blurSizeLightSpace(0.0f, 0.0f);
+	Vector3 maxPartitionScale(maxFloat, maxFloat, maxFloat);
+	if (mScene.mbEdgeSoftening)
+	{
+		blurSizeLightSpace.x = mScene.mEdgeSofteningAmount * 0.5f * mShadowCamera->mOrthoProj.m11;
+		blurSizeLightSpace.y = mScene.mEdgeSofteningAmount * 0.5f * mShadowCamera->mOrthoProj.m22;
+
+		float maxBlurLightSpace = mScene.mMaxEdgeSofteningFilter / static_cast<float>(mShadowTextureDim);
+		maxPartitionScale.x = maxBlurLightSpace / blurSizeLightSpace.x;
+		maxPartitionScale.y = maxBlurLightSpace / blurSizeLightSpace.y;
+	}
+	Vector3 partitionBorderLightSpace(blurSizeLightSpace.x, blurSizeLightSpace.y, mShadowCamera->mOrthoProj.m33);
+
+	const CameraSettings& settings = mSnapshot->mCameraSettings;
+	float minZ = settings.FarZ;
+	float maxZ = settings.NearZ;
+	for (u32 iObject = 0; iObject < (u32)mScene.mGameObjects.size(); ++iObject)
+	{
+		NullMesh* mesh = mScene.mGameObjects[iObject]->mDrawable.mMesh;
+		if (mesh == nullptr)
+			continue;
+
+		Matrix44 worldView = mSnapshot->mWorlds[iObject] * mSnapshot->mView;
+		for (u32 iSubset=0 ; iSubset<mesh->mSubsetCount; ++iSubset)
+		{
+			const Mesh::Subset& subset = mesh->mSubsets[iSubset];
+			if (!subset.mbIsInFrustum)
+				continue;
+
+			Sphere bs = Sphere(subset.mCenter, subset.mRadius).Transform(worldView);
+			minZ = RJE::Math::Min(minZ, bs.center.z - bs.radius);
+			maxZ = RJE::Math::Max(maxZ, bs.center.z + bs.radius);
+		}
+	}
+	minZ = RJE::Math::Max(minZ, settings.NearZ);
+	maxZ = RJE::Math::Min(maxZ, settings.FarZ);
+
+	ShadowCasterCuller::EstimatePartitions(	mSnapshot->mView, RJE::Math::Deg2Rad_f*settings.FOV, settings.AspectRatio, minZ, maxZ,
+											mShadowCamera->mView*mShadowCamera->mOrthoProj, partitionBorderLightSpace, maxPartitionScale,
+											0.01f, mShadowPartitions);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Same as DX11RenderingAPI::CullShadowCasters, against the estimated
+// partitions: they are this frame's, no margin needed
+void NullRenderingAPI::CullShadowCasters()
+{
+	PROFILE_CPU("Cull Shadow Casters");
+
+	if (mbCullShadowCasters)
+		mShadowCasterCuller.SetPartitions(mShadowPartitions, 0.0f);
+	else
+		mShadowCasterCuller.Invalidate();
+
+	mShadowCasterCuller.ResetStats();
+	mShadowCache.BeginFrame((u32)mScene.mGameObjects.size());
+	Matrix44 lightViewProj = mShadowCamera->mView*mShadowCamera->mOrthoProj;
+
+	for (u32 iObject = 0; iObject < (u32)mScene.mGameObjects.size(); ++iObject)
+	{
+		const unique_ptr<GameObject>& gameobject = mScene.mGameObjects[iObject];
+		NullMesh* mesh = gameobject->mDrawable.mMesh;
+		if (mesh == nullptr)
+			continue;
+
+		mShadowCache.UpdateCaster(iObject, mSnapshot->mWorlds[iObject]);
+
+		Matrix44 worldLightViewProj = mSnapshot->mWorlds[iObject]*lightViewProj;
+		for (u32 iSubset=0 ; iSubset<mesh->mSubsetCount; ++iSubset)
+		{
+			Mesh::Subset& subset = mesh->mSubsets[iSubset];
+			subset.mShadowPartitions = mShadowCasterCuller.AddCaster(ShadowCasterCuller::CasterBounds(subset.mCenter, subset.mExtents, worldLightViewProj));
+			mShadowCache.AddCaster(iObject, iSubset, subset.mShadowPartitions);
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// The partitions are CPU estimates here, so each one is keyed by its own
+// bounds instead of everything the GPU reduction reads
+u64 NullRenderingAPI::ShadowPartitionKey(u32 currentPartition)
+{
+	StateHash key;
+	key.Add(mShadowCamera->mView);
+	key.Add(mShadowCamera->mOrthoProj);
+	key.Add(mShadowPartitions[currentPartition]);
+	key.Add(mScene.mbUsePositiveExponent);
+	key.Add(mScene.mbUseNegativeExponent);
+	key.Add(mScene.mPositiveExponent);
+	key.Add(mScene.mNegativeExponent);
+	key.Add(mScene.mbEdgeSoftening);
+	key.Add(mScene.mEdgeSofteningAmount);
+	key.Add(mScene.mMaxEdgeSofteningFilter);
+	return key.mValue;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void NullRenderingAPI::RenderShadowDepth(u32 currentPartition, ShadowCacheAction action)
+{
+	// New per partition constants: the first draw must apply
+	mNullDevice->mStateCache.Invalidate();
+
+	if (action == ShadowCache_DynamicOnly)
+		mNullDevice->SetState("CopyResource");
+	else
+		mNullDevice->Clear("ClearDepthStencilView");
+	mNullDevice->mStateCache.IASetInputLayout("PosNormalTanTex");
+	mNullDevice->SetState("RSSetViewports");
+	mNullDevice->SetState("OMSetRenderTargets");
+	mNullDevice->SetState("OMSetBlendState");
+	mNullDevice->mStateCache.IASetInputLayout("PosNormalTanTex");
+	mNullDevice->mStateCache.IASetPrimitiveTopology(NullTopology_TriangleList);
+	mNullDevice->SetState("RSSetState");
+
+	mNullDevice->SetConstant("SetPartitionsSRV");
+	mNullDevice->SetConstant("SetCurrentPartitions");
+
+	if (!mShadowCache.UsesLayers())
+		DrawShadowCasters(currentPartition, ShadowLayer_All);
+	else
+	{
+		if (action == ShadowCache_RenderAll)
+		{
+			DrawShadowCasters(currentPartition, ShadowLayer_Static);
+			mNullDevice->SetState("CopyResource");
+		}
+		DrawShadowCasters(currentPartition, ShadowLayer_Dynamic);
+	}
+
+	mNullDevice->SetState("OMSetBlendState");
+	mNullDevice->SetState("OMSetRenderTargets");
+	mNullDevice->SetState("RSSetState");
+	mNullDevice->SetState("RSSetViewports");
+	mNullDevice->SetState("VSSetShaderResources");
+}
+
+//////////////////////////////////////////////////////////////////////////
+void NullRenderingAPI::DrawShadowCasters(u32 currentPartition, u32 layers)
+{
+	if (mbUseRenderQueue)
+	{
+		SubmitShadowQueue("ShadowMapTech", currentPartition, layers);
+		return;
+	}
+
+	for (u32 iObject = 0; iObject < (u32)mScene.mGameObjects.size(); ++iObject)
+	{
+		const unique_ptr<GameObject>& gameobject = mScene.mGameObjects[iObject];
+		if (gameobject->mDrawable.mMesh && (mShadowCache.Layer(iObject) & layers))
+		{
+			mNullDevice->SetConstant("SetWorldViewProj");
+			for (u32 iSubset=0 ; iSubset<gameobject->mDrawable.mMesh->mSubsetCount; ++iSubset)
+			{
+				if (!(gameobject->mDrawable.mMesh->mSubsets[iSubset].mShadowPartitions & (1u << currentPartition)))
+					continue;
+				mNullDevice->mStateCache.Apply("ShadowMapTech");
+				gameobject->mDrawable.mMesh->Render(iSubset);
+			}
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+void NullRenderingAPI::ConvertToEVSM(u32 partitionIndex)
+{
+	UNREFERENCED_PARAMETER(partitionIndex);
+	mNullDevice->SetState("OMSetRenderTargets");
+	mNullDevice->SetState("RSSetState");
+	mNullDevice->SetState("RSSetViewports");
+
+	// Shadow map, partitions, current partition, exponents
+	for (u32 i = 0; i < 4; ++i)
+		mNullDevice->SetConstant("EVSMConvertFX");
+
+	RenderScreenQuad("EVSMConvertTech");
+
+	mNullDevice->SetState("OMSetRenderTargets");
+	mNullDevice->SetState("PSSetShaderResources");
+	mNullDevice->SetState("VSSetShaderResources");
+	mNullDevice->SetState("RSSetViewports");
+}
+
+//////////////////////////////////////////////////////////////////////////
+void NullRenderingAPI::AccumulateLighting(u32 partitionIndex)
+{
+	UNREFERENCED_PARAMETER(partitionIndex);
+	mNullDevice->mStateCache.IASetInputLayout("PosNormalTanTex");
+	mNullDevice->mStateCache.IASetPrimitiveTopology(NullTopology_TriangleList);
+	mNullDevice->SetState("OMSetRenderTargets");
+	mNullDevice->SetState("OMSetBlendState");
+	mNullDevice->SetState("RSSetState");
+
+	// Ambient, View, ViewToLightProj, partitions, current partition, GBuffer, dir lights,
+	// shadow array, EyePosW, strength, exponents, exponents state, visualize partitions
+	for (u32 i = 0; i < 13; ++i)
+		mNullDevice->SetConstant("ShadowMapFX accumulate");
+
+	RenderScreenQuad("AccumShadowTech");
+
+	mNullDevice->SetState("PSSetShaderResources");
+}
+
+//////////////////////////////////////////////////////////////////////////
+void NullRenderingAPI::BoxBlur(u32 partitionIndex)
+{
+	UNREFERENCED_PARAMETER(partitionIndex);
+	mNullDevice->SetConstant("SetFilterSize");
+	mNullDevice->SetConstant("SetCurrentPartitions");
+
+	// Horizontal then vertical pass, each one a full-screen triangle
+	for (u32 dimension = 0; dimension < 2; ++dimension)
+	{
+		mNullDevice->mStateCache.IASetInputLayout(nullptr);
+		mNullDevice->mStateCache.IASetPrimitiveTopology(NullTopology_TriangleStrip);
+		mNullDevice->mStateCache.IASetVertexBuffers(0, 0, nullptr, nullptr, nullptr);
+		mNullDevice->SetConstant("SetDimension");
+		mNullDevice->SetConstant("SetInputTexture");
+		mNullDevice->SetConstant("SetPartitions");
+		mNullDevice->mStateCache.Apply("EVSMBlurTech");
+		mNullDevice->SetState("RSSetState");
+		mNullDevice->SetState("RSSetViewports");
+		mNullDevice->SetState("OMSetRenderTargets");
+		mNullDevice->SetState("OMSetBlendState");
+		mNullDevice->Draw(3, "BoxBlur");
+		mNullDevice->SetState("OMSetRenderTargets");
+		mNullDevice->SetState("VSSetShaderResources");
+		mNullDevice->SetState("PSSetShaderResources");
+		mNullDevice->SetState("RSSetViewports");
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+void NullRenderingAPI::RenderScreenQuad(const char* pass)
+{
+	const void* vertexBuffer = "ScreenQuadVB";
+	u32 stride = sizeof(MeshData::PosNormTanTex);
+	u32 offset = 0;
+	mNullDevice->mStateCache.IASetVertexBuffers(0, 1, &vertexBuffer, &stride, &offset);
+	mNullDevice->mStateCache.IASetIndexBuffer("ScreenQuadIB", 0, 0);
+	mNullDevice->mStateCache.Apply(pass);
+	mNullDevice->DrawIndexed(6, pass);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void NullRenderingAPI::UpdateShadowCamera()
+{
+	Vector3 camUp = mScene.mbAlignLightToFrustum ? mSnapshot->mCameraRight : Vector3::up;
+	Vector3 lightDir = Vector3(mSnapshot->mSunDirection.w, mSnapshot->mSunDirection.x, mSnapshot->mSunDirection.y);
+	mShadowCamera->mLookAt       = mScene.mSceneCenter;
+	mShadowCamera->mTrf.Position = mScene.mSceneCenter + WorldPosition(-mScene.mSceneRadius * lightDir);
+	mShadowCamera->mUp           = camUp;
+
+	// Camera::UpdateViewMatrix(), against the snapshot's render origin
+	Vector3 eyeDir = Vector3(mShadowCamera->mLookAt - mShadowCamera->mTrf.Position);
+	mShadowCamera->mView = Matrix44::LookAt(Transform::ToRenderSpace(mShadowCamera->mTrf.Position, mSnapshot->mRenderOrigin), eyeDir, camUp);
+
+	float dimension = 2.0f*mScene.mSceneRadius;
+	mShadowCamera->mOrthoProj = Matrix44::Orthographic(dimension, dimension, 0.0f, dimension);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void NullRenderingAPI::ComputeFrustumFlags()
+{
+	PROFILE_CPU("Compute Frustum Flag");
+
+	mTotalSubsets    = 0;
+	mRenderedSubsets = 0;
+
+	mCameraFrustum = Frustum::FromViewProj(mSnapshot->mView * mSnapshot->mProj);
+
+	for (u32 iObject = 0; iObject < (u32)mScene.mGameObjects.size(); ++iObject)
+	{
+		const unique_ptr<GameObject>& gameobject = mScene.mGameObjects[iObject];
+		if (gameobject->mDrawable.mMesh == nullptr)
+			continue;
+
+		const Matrix44& world = mSnapshot->mWorldsNoScale[iObject];	// we scale the AABB
+		const Vector3&  scale = mSnapshot->mScales[iObject];
+
+		for (u32 iSubset=0 ; iSubset<gameobject->mDrawable.mMesh->mSubsetCount; ++iSubset)
+		{
+			BOOL inFrustum = false;
+			if (mbUseAABB)
+			{
+				AABB aabb(	Vector3::Scale(scale, gameobject->mDrawable.mMesh->mSubsets[iSubset].mCenter),
+							Vector3::Scale(scale, gameobject->mDrawable.mMesh->mSubsets[iSubset].mExtents));
+				inFrustum = mCameraFrustum.Intersects(OBB::FromAABB(aabb, world));
+			}
+			else
+			{
+				Sphere bs(	Vector3::Scale(scale, gameobject->mDrawable.mMesh->mSubsets[iSubset].mCenter),
+							scale.Max() * gameobject->mDrawable.mMesh->mSubsets[iSubset].mRadius);
+				inFrustum = mCameraFrustum.Intersects(bs.Transform(world));
+			}
+
+			gameobject->mDrawable.mMesh->mSubsets[iSubset].mbIsInFrustum = inFrustum;
+			if (inFrustum)
+				++mRenderedSubsets;
+			++mTotalSubsets;
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Same queues as DX11RenderingAPI::BuildRenderQueues
+void NullRenderingAPI::BuildRenderQueues(BOOL bShadows)
+{
+	PROFILE_CPU("Build Render Queues");
+
+	mRenderQueue.Clear();
+	mShadowQueue.Clear();
+
+	const Matrix44& view    = mScene.mbViewLightSpace ? mShadowCamera->mView : mSnapshot->mView;
+	float           invFarZ = 1.0f / mSnapshot->mCameraSettings.FarZ;
+
+	for (u32 iObject = 0; iObject < (u32)mScene.mGameObjects.size(); ++iObject)
+	{
+		NullMesh* mesh = mScene.mGameObjects[iObject]->mDrawable.mMesh;
+		if (mesh == nullptr)
+			continue;
+
+		Matrix44 worldView = mSnapshot->mWorlds[iObject] * view;
+		for (u32 iSubset=0 ; iSubset<mesh->mSubsetCount; ++iSubset)
+		{
+			if (bShadows)
+				mShadowQueue.Push(RenderKey::Make(RenderKey::Pass_Shadow, false, 0, 0, iObject, 0.0f), iObject, iSubset);
+
+			const Mesh::Subset& subset = mesh->mSubsets[iSubset];
+			if (!subset.mbIsInFrustum)
+				continue;
+
+			const Material* material = mesh->mMaterial[iSubset].get();
+			float depth = subset.mCenter.x*worldView.m13 + subset.mCenter.y*worldView.m23 + subset.mCenter.z*worldView.m33 + worldView.m43;
+			u64   key   = RenderKey::Make(RenderKey::Pass_Scene, !material->mIsOpaque, material->mShaderSortId, material->mSortId, iObject, depth * invFarZ);
+			mRenderQueue.Push(key, iObject, iSubset);
+		}
+	}
+
+	// The shadow queue is left in push order: grouped by object already, and
+	// the world matrix is the only thing SubmitShadowQueue() rebinds
+	mRenderQueue.Sort();
+}
+
+//////////////////////////////////////////////////////////////////////////
+void NullRenderingAPI::SubmitRenderQueue(const char* shaderPass)
+{
+	NullStateCache& stateCache = mNullDevice->mStateCache;
+
+	u32  lastObject   = UINT_MAX;
+	BOOL bTranslucent = false;
+
+	for (const RenderPacket& packet : mRenderQueue.mPackets)
+	{
+		if (!bTranslucent && RenderKey::IsTranslucent(packet.mKey))
+		{
+			bTranslucent = true;
+			if (mScene.mbUseBlending)
+				mNullDevice->SetState("RSSetState");
+		}
+
+		NullDrawable& drawable = mScene.mGameObjects[packet.mObject]->mDrawable;
+		Material*     material = drawable.mMesh->mMaterial[packet.mSubset].get();
+
+		if (packet.mObject != lastObject)
+		{
+			mNullDevice->SetConstant("SetWorld");
+			stateCache.MarkEffectDirty();
+			drawable.mMesh->Bind();
+			lastObject = packet.mObject;
+		}
+		if (stateCache.NeedsMaterial(material->mSortId))
+			mNullDevice->SetConstant("SetMaterial");
+		stateCache.ApplyIfDirty(shaderPass);
+
+		drawable.mMesh->Draw(packet.mSubset);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+void NullRenderingAPI::SubmitShadowQueue(const char* shaderPass, u32 currentPartition, u32 layers)
+{
+	u32 lastObject = UINT_MAX;
+
+	for (const RenderPacket& packet : mShadowQueue.mPackets)
+	{
+		NullMesh* mesh = mScene.mGameObjects[packet.mObject]->mDrawable.mMesh;
+		if (!(mesh->mSubsets[packet.mSubset].mShadowPartitions & (1u << currentPartition)))
+			continue;
+		if (!(mShadowCache.Layer(packet.mObject) & layers))
+			continue;
+		if (packet.mObject != lastObject)
+		{
+			mNullDevice->SetConstant("SetWorldViewProj");
+			mNullDevice->mStateCache.Apply(shaderPass);
+			mesh->Bind();
+			lastObject = packet.mObject;
+		}
+		mesh->Draw(packet.mSubset);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+void NullRenderingAPI::ClearFrustumFlags()
+{
+	for(const unique_ptr<GameObject>& gameobject : mScene.mGameObjects)
+	{
+		if (gameobject->mDrawable.mMesh)
+		{
+			for (u32 iSubset=0 ; iSubset<gameobject->mDrawable.mMesh->mSubsetCount; ++iSubset)
+			{
+				gameobject->mDrawable.mMesh->mSubsets[iSubset].mbIsInFrustum = true;
+				++mRenderedSubsets;
+				++mTotalSubsets;
+			}
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+void NullRenderingAPI::DrawLightSpheres(const char* pass, BOOL bSun/*=false*/)
+{
+	const void* vertexBuffer = "LightSpheresVB";
+	u32 stride = sizeof(MeshData::PosNormTanTex);
+	u32 offset = 0;
+	mNullDevice->mStateCache.IASetVertexBuffers(0, 1, &vertexBuffer, &stride, &offset);
+	mNullDevice->mStateCache.IASetIndexBuffer("LightSpheresIB", 0, 0);
+	// Not a file material (id 0): always set, and the cache forgets the bound one
+	if (mNullDevice->mStateCache.NeedsMaterial(0))
+		mNullDevice->SetConstant("SetMaterial");
+
+	if (bSun)
+	{
+		mNullDevice->SetConstant("SetWorld");
+		mNullDevice->mStateCache.Apply(pass);
+		mNullDevice->DrawIndexed(mLightSphereIndexCount, "LightSphere");
+	}
+	else
+	{
+		for(u32 i = 0; i < mPointLightCount; ++i)
+		{
+			mNullDevice->SetConstant("SetWorld");
+			mNullDevice->mStateCache.Apply(pass);
+			mNullDevice->DrawIndexed(mLightSphereIndexCount, "LightSphere");
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+void NullRenderingAPI::DrawGizmos()
+{
+	PROFILE_CPU("Draw Gizmos");
+
+	mNullDevice->mStateCache.IASetInputLayout("PosColor");
+	mNullDevice->mStateCache.IASetPrimitiveTopology(NullTopology_LineList);
+	mNullDevice->SetConstant("SetViewProj");
+
+	// Draw the gizmo geometry
+	for(const unique_ptr<GameObject>& gizmo : mScene.mGameObjects)
+	{
+		if (gizmo->mDrawable.mGizmo)
+			gizmo->mDrawable.RenderGizmo("ColorTech");
+	}
+
+	// DX11 copies the edited object's transform to the gizmo first: the
+	// null device never reads it, and the update side owns it
+	if (mScene.mbEnableGizmo)
+		mScene.mEditorGameobject->mDrawable.RenderGizmo("ColorTech");
+}
+
+//////////////////////////////////////////////////////////////////////////
+void NullRenderingAPI::SetActiveDirLights(int activeLights)
+{
+	mDirLightCount = (u32) RJE::Math::Clamp(activeLights, 0, MAX_LIGHTS);
+	RJE_SAFE_DELETE(mDirLights);
+	mDirLights = rje_new StructuredBuffer<DirectionalLight>(mNullDevice, mDirLightCount);
+}
+//-------------------------
+void NullRenderingAPI::SetActivePointLights(int activeLights)
+{
+	mPointLightCount = (u32) RJE::Math::Clamp(activeLights, 0, MAX_LIGHTS);
+	RJE_SAFE_DELETE(mPointLights);
+	mPointLights = rje_new StructuredBuffer<PointLight>(mNullDevice, mPointLightCount);
+}
+//-------------------------
+// The snapshot's lights into the shader buffers, positions in render space
+void NullRenderingAPI::UploadLights()
+{
+	if (mSnapshot->mDirLights.size()   != mDirLightCount)		SetActiveDirLights  ((int)mSnapshot->mDirLights.size());
+	if (mSnapshot->mPointLights.size() != mPointLightCount)		SetActivePointLights((int)mSnapshot->mPointLights.size());
+	if (mSnapshot->mSpotLights.size()  != mSpotLightCount)		SetActiveSpotLights ((int)mSnapshot->mSpotLights.size());
+
+	if (mDirLightCount > 0)
+	{
+		std::copy(mSnapshot->mDirLights.begin(), mSnapshot->mDirLights.begin() + mDirLightCount, mDirLights->MapDiscard(mNullDevice));
+		mDirLights->Unmap(mNullDevice);
+	}
+	if (mPointLightCount > 0)
+	{
+		// A new count comes with every light marked
+#if RJE_DOUBLE_PRECISION
+		// The buffer is in render space, which follows the camera
+		LightRange all = { 0, mPointLightCount };
+		mPointLightRanges.assign(1, all);
+		UploadPointLights(mPointLightRanges);
+#else
+		UploadPointLights(mSnapshot->mPointLightRanges);
+#endif
+	}
+	if (mSpotLightCount > 0)
+	{
+		SpotLight* light = mSpotLights->MapDiscard(mNullDevice);
+		for (u32 i = 0; i < mSpotLightCount; ++i)
+		{
+			light[i] = mSnapshot->mSpotLights[i];
+			light[i].Position = Transform::ToRenderSpace(WorldPosition(light[i].Position), mSnapshot->mRenderOrigin);
+		}
+		mSpotLights->Unmap(mNullDevice);
+	}
+}
+//-------------------------
+void NullRenderingAPI::UploadPointLights(const std::vector<LightRange>& ranges)
+{
+	for (u32 i = 0; i < ranges.size(); ++i)
+	{
+		const LightRange& range = ranges[i];
+		const PointLight* lights = &mSnapshot->mPointLights[range.mFirst];
+#if RJE_DOUBLE_PRECISION
+		FrameVector<PointLight>::Type renderSpaceLights(lights, lights + range.mCount);
+		for (u32 light = 0; light < range.mCount; ++light)
+			renderSpaceLights[light].Position = Transform::ToRenderSpace(WorldPosition(lights[light].Position), mSnapshot->mRenderOrigin);
+		lights = &renderSpaceLights[0];
+#endif
+		mPointLights->UpdateRange(mNullDevice, lights, range.mFirst, range.mCount);
+	}
+}
+//-------------------------
+void NullRenderingAPI::SetActiveSpotLights(int activeLights)
+{
+	mSpotLightCount = (u32) RJE::Math::Clamp(activeLights, 0, MAX_LIGHTS);
+	RJE_SAFE_DELETE(mSpotLights);
+	mSpotLights = rje_new StructuredBuffer<SpotLight>(mNullDevice, mSpotLightCount);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Same as DX11RenderingAPI::BuildLightClusters
+BOOL NullRenderingAPI::BuildLightClusters()
+{
+	if (!mbUseLightClusters || mPointLightCount == 0 || mScene.mbViewLightSpace || mSnapshot->mbOrtho)
+		return false;
+
+	PROFILE_CPU("Build Light Clusters");
+
+	const Matrix44&       proj     = mSnapshot->mProj;		// perspective here
+	const CameraSettings& settings = mSnapshot->mCameraSettings;
+	if (!mLightClusters.IsSetup(mWindowWidth, mWindowHeight, proj, settings.NearZ, settings.FarZ))
+	{
+		mLightClusters.Setup(mWindowWidth, mWindowHeight, proj, settings.NearZ, settings.FarZ);
+		RJE_SAFE_DELETE(mLightClusterBuffer);
+		mLightClusterBuffer = rje_new StructuredBuffer<LightCluster>(mNullDevice, mLightClusters.ClusterCount());
+	}
+
+	Matrix44 view = mSnapshot->mView;
+#if RJE_DOUBLE_PRECISION
+	view = Matrix44::Translation(Transform::ToRenderSpace(WorldPosition(), mSnapshot->mRenderOrigin)) * view;
+#endif
+	mLightClusters.Build(&mSnapshot->mPointLights[0], mPointLightCount, view);
+
+	u32 indexCount = (u32)mLightClusters.mLightIndices.size();
+	if (mLightIndexBuffer == nullptr || indexCount > mLightIndexCapacity)
+	{
+		mLightIndexCapacity = RJE::Math::Max(mLightIndexCapacity, 1024u);
+		while (mLightIndexCapacity < indexCount)
+			mLightIndexCapacity *= 2;
+		RJE_SAFE_DELETE(mLightIndexBuffer);
+		mLightIndexBuffer = rje_new StructuredBuffer<u32>(mNullDevice, mLightIndexCapacity);
+	}
+
+	memcpy(mLightClusterBuffer->MapDiscard(mNullDevice), &mLightClusters.mClusters[0], mLightClusters.mClusters.size() * sizeof(LightCluster));
+	mLightClusterBuffer->Unmap(mNullDevice);
+	if (indexCount > 0)
+	{
+		memcpy(mLightIndexBuffer->MapDiscard(mNullDevice), &mLightClusters.mLightIndices[0], indexCount * sizeof(u32));
+		mLightIndexBuffer->Unmap(mNullDevice);
+	}
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void NullRenderingAPI::Shutdown()
+{
+	RJE_SAFE_DELETE(mDirLights);
+	RJE_SAFE_DELETE(mPointLights);
+	RJE_SAFE_DELETE(mSpotLights);
+	RJE_SAFE_DELETE(mLightClusterBuffer);
+	RJE_SAFE_DELETE(mLightIndexBuffer);
+	//-----------
+	NullTextureManager::DeleteInstance();
+	NullMesh::SetDevice(nullptr);
+	RJE_SAFE_DELETE(mNullDevice);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void NullRenderingAPI::ResizeWindow(int newSizeWidth, int newSizeHeight)
+{
+	mWindowWidth  = newSizeWidth;
+	mWindowHeight = newSizeHeight;
+
+	// The window resized, so update the aspect ratio and recompute the projection matrix.
+	mCamera->mSettings.AspectRatio = (float)newSizeWidth / (float)newSizeHeight;
+	mCamera->UpdateProjMatrix((float)newSizeWidth, (float)newSizeHeight);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void NullRenderingAPI::SetWireframe(BOOL state)
+{
+	if (state)
+	{
+		mScene.mbUseBlending = false;
+		mScene.mbWireframe   = true;
+	}
+	else
+	{
+		mScene.mbWireframe = false;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+void NullRenderingAPI::SetMSAA(u32 MSAASamples)
+{
+	MSAA_Samples = MSAASamples;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void NullRenderingAPI::InstantiateModel(string filename)
+{
+	unique_ptr<GameObject> gameobject (new GameObject);
+	string meshPath     = RJE_GLOBALS::gDataPath + "models\\" + filename + ".mesh";
+	string materialPath = filename + "\\" + filename + ".matlib";
+	//-----
+	gameobject->mName = filename;
+	gameobject->mDrawable.mMesh = rje_new NullMesh;
+	gameobject->mDrawable.mMesh->LoadModelFromFile(meshPath);
+	gameobject->mDrawable.mMesh->LoadMaterialLibraryFromFile(materialPath);
+	mScene.mGameObjects.push_back(std::move(gameobject));
+}
+
+//////////////////////////////////////////////////////////////////////////
+void NullRenderingAPI::InstantiatePrimitive(string name)
+{
+	unique_ptr<GameObject> gameobject (new GameObject);
+	gameobject->mName = name;
+	gameobject->mDrawable.mMesh = rje_new NullMesh;
+
+	if (name == "cube")			gameobject->mDrawable.mMesh->LoadBox(1, 1, 1);
+	if (name == "sphere")		gameobject->mDrawable.mMesh->LoadGeoSphere(1, 3);
+	if (name == "cylinder")		gameobject->mDrawable.mMesh->LoadCylinder(0.5, 0.5, 2, 20, 1);
+	if (name == "grid")			gameobject->mDrawable.mMesh->LoadGrid(10, 10, 2, 2);
+
+	gameobject->mDrawable.mMesh->LoadMaterialFromFile("_Default\\default.mat");
+	mScene.mGameObjects.push_back(std::move(gameobject));
+}
+
+//////////////////////////////////////////////////////////////////////////
+void NullRenderingAPI::LoadSkybox(string name)
+{
+	ShaderResource* skybox = nullptr;
+	string path = RJE_GLOBALS::gDataPath + "textures\\skyboxes\\" + name;
+	NullTextureManager::Instance()->LoadTextureFromPath(path, &skybox);
+}
@@ -0,0 +1,68 @@
+#include "NullTextureManager.h"
+
+NullTextureManager* NullTextureManager::sInstance = nullptr;
+
+//////////////////////////////////////////////////////////////////////////
+void NullTextureManager::Initialize(NullDevice* device)
+{
+	mDevice       = device;
+	mTextureCount = 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void NullTextureManager::ReleaseTextures()
+{
+	for (auto it = mTextures.begin(); it != mTextures.end(); ++it)
+	{
+		MemoryBudget::Instance()->Release(Memory_Textures, it->first.c_str());
+	}
+	mTextures.clear();
+}
+
+//////////////////////////////////////////////////////////////////////////
+BOOL NullTextureManager::IsTextureLoaded( std::string textureName )
+{
+	return mTextures.find(textureName) != mTextures.end();
+}
+
+//////////////////////////////////////////////////////////////////////////
+u64 NullTextureManager::UploadFile(const string& texturePath)
+{
+	u64 size = 0;
+	FILE* file = fopen(FileSystem::NativePath(texturePath).c_str(), "rb");
+	if (file)
+	{
+		fseek(file, 0, SEEK_END);
+		size = (u64) ftell(file);
+		fclose(file);
+	}
+	mDevice->LoadTexture(size, "Texture");
+	return size;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void NullTextureManager::LoadTexture(string texturePath, string textureName)
+{
+	MemoryBudget::Instance()->Add(Memory_Textures, textureName.c_str(), UploadFile(texturePath));
+	mTextures[textureName] = nullptr;
+	++mTextureCount;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void NullTextureManager::LoadTextureFromPath(string texturePath, ShaderResource** shaderResourceView)
+{
+	// The caller owns the view: accounted under the path, a reload replaces it
+	MemoryBudget::Instance()->Release(Memory_Textures, texturePath.c_str());
+	MemoryBudget::Instance()->Add(Memory_Textures, texturePath.c_str(), UploadFile(texturePath));
+	*shaderResourceView = nullptr;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void NullTextureManager::Create2DTextureFixedColor(i32 size, RJE_COLOR::Color color, std::string textureName)
+{
+	UNREFERENCED_PARAMETER(color);
+	mDevice->LoadTexture(4 * size * size, "Texture2DFixedColor");
+	MemoryBudget::Instance()->Add(Memory_Textures, textureName.c_str(), 4 * size * size);
+	mTextures[textureName] = nullptr;
+	++mTextureCount;
+}